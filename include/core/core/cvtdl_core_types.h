@@ -119,6 +119,67 @@ typedef struct _MDROI_t {
   Point_t pnt[4];
 } MDROI_t;
 
+/** @enum cvtdl_motion_gate_action_e
+ * @ingroup core_cvitdlcore
+ * @brief What the motion gate decided to run on a frame.
+ */
+typedef enum {
+  CVTDL_MOTION_GATE_SKIP = 0, /**< no motion, skip detection and coast the trackers */
+  CVTDL_MOTION_GATE_ROI,      /**< run detection on the motion ROI only */
+  CVTDL_MOTION_GATE_FULL,     /**< run detection on the whole frame */
+} cvtdl_motion_gate_action_e;
+
+/** @struct cvtdl_motion_gate_config_t
+ * @ingroup core_cvitdlcore
+ * @brief Motion gate config.
+ *
+ * @var cvtdl_motion_gate_config_t::keyframe_interval
+ * A full frame detection is forced at least every keyframe_interval frames, 0 disables it.
+ * Keep it below the max_unmatched_num of the tracker, so tracks outside the ROIs survive.
+ * @var cvtdl_motion_gate_config_t::hold_frames
+ * Frames the last ROI is kept after the motion stops, so objects that just stopped are still
+ * detected.
+ * @var cvtdl_motion_gate_config_t::min_motion_area
+ * Motion boxes with a smaller area in pixels are ignored.
+ * @var cvtdl_motion_gate_config_t::roi_padding
+ * Margin added around the motion boxes, relative to the size of their union.
+ * @var cvtdl_motion_gate_config_t::min_roi_size
+ * The ROI is grown to at least min_roi_size pixels in both directions.
+ * @var cvtdl_motion_gate_config_t::max_roi_ratio
+ * A ROI covering more than this fraction of the frame falls back to a full frame detection.
+ */
+typedef struct {
+  uint32_t keyframe_interval;
+  uint32_t hold_frames;
+  float min_motion_area;
+  float roi_padding;
+  uint32_t min_roi_size;
+  float max_roi_ratio;
+} cvtdl_motion_gate_config_t;
+
+/** @struct cvtdl_motion_gate_t
+ * @ingroup core_cvitdlcore
+ * @brief Motion gate decision of a frame.
+ *
+ * @var cvtdl_motion_gate_t::action
+ * Detection to run on this frame.
+ * @var cvtdl_motion_gate_t::roi
+ * Region to detect on for CVTDL_MOTION_GATE_ROI, the whole frame for CVTDL_MOTION_GATE_FULL.
+ * @var cvtdl_motion_gate_t::width
+ * Width of the frame.
+ * @var cvtdl_motion_gate_t::height
+ * Height of the frame.
+ * @var cvtdl_motion_gate_t::frames_since_full
+ * Frames since the last full frame detection, 0 on a full frame.
+ */
+typedef struct {
+  cvtdl_motion_gate_action_e action;
+  cvtdl_bbox_t roi;
+  uint32_t width;
+  uint32_t height;
+  uint32_t frames_since_full;
+} cvtdl_motion_gate_t;
+
 /** @enum cvtdl_trk_state_type_t
  * @ingroup core_cvitdlcore
  * @brief Enum describing the tracking state.
@@ -211,6 +272,118 @@ typedef struct {
   VPSS_SCALE_COEF_E resize_method;
 } InputPreParam;
 
+/** @enum cvtdl_mem_type_e
+ * @ingroup core_cvitdlcore
+ * @brief Kinds of memory attributed to a handle and its models.
+ */
+typedef enum {
+  CVI_TDL_MEM_HEAP = 0, /**< malloc and new. */
+  CVI_TDL_MEM_ION,      /**< ION buffers of the runtime, models and galleries. */
+  CVI_TDL_MEM_VB,       /**< VB blocks held by the VPSS preprocessing. */
+  CVI_TDL_MEM_TYPE_NUM
+} cvtdl_mem_type_e;
+
+/** @struct cvtdl_mem_counter_t
+ * @ingroup core_cvitdlcore
+ * @brief Counters of one kind of memory.
+ *
+ * @var cvtdl_mem_counter_t::live_bytes
+ * Bytes currently allocated.
+ * @var cvtdl_mem_counter_t::peak_bytes
+ * Largest live_bytes so far.
+ * @var cvtdl_mem_counter_t::total_bytes
+ * Bytes allocated since the account was created.
+ * @var cvtdl_mem_counter_t::alloc_rate
+ * Bytes allocated per second since the previous query of the same account.
+ */
+typedef struct {
+  uint64_t live_bytes;
+  uint64_t peak_bytes;
+  uint64_t total_bytes;
+  uint64_t alloc_count;
+  uint64_t free_count;
+  float alloc_rate;
+} cvtdl_mem_counter_t;
+
+/** @struct cvtdl_mem_usage_t
+ * @ingroup core_cvitdlcore
+ * @brief Memory usage of a handle or a model, indexed by cvtdl_mem_type_e.
+ */
+typedef struct {
+  cvtdl_mem_counter_t counter[CVI_TDL_MEM_TYPE_NUM];
+} cvtdl_mem_usage_t;
+
+/** @struct cvtdl_model_load_info_t
+ * @ingroup core_cvitdlcore
+ * @brief Loading of a model. Instances opening the same cvimodel file share one mapping of the file
+ * and one copy of the weights, each instance has its own I/O tensors.
+ *
+ * @var cvtdl_model_load_info_t::open_ms
+ * Time spent to open the model, in milliseconds.
+ * @var cvtdl_model_load_info_t::shared
+ * The weights were loaded by an instance opened before.
+ * @var cvtdl_model_load_info_t::instances
+ * Number of instances sharing the weights.
+ * @var cvtdl_model_load_info_t::file_bytes
+ * Size of the cvimodel file.
+ * @var cvtdl_model_load_info_t::resident_bytes
+ * Bytes of the file in the page cache.
+ */
+typedef struct {
+  float open_ms;
+  bool shared;
+  uint32_t instances;
+  uint64_t file_bytes;
+  uint64_t resident_bytes;
+} cvtdl_model_load_info_t;
+
+/** @struct cvtdl_stream_sched_config_t
+ * @ingroup core_cvitdlcore
+ * @brief Config of a scheduler running one model for many video streams.
+ *
+ * @var cvtdl_stream_sched_config_t::num_workers
+ * Model instances running in parallel, they share the weights. With two or more, the
+ * preprocessing and output parsing of one stream overlap the forward of another.
+ * @var cvtdl_stream_sched_config_t::max_streams
+ * Stream ids go from 0 to max_streams - 1.
+ * @var cvtdl_stream_sched_config_t::queue_depth
+ * Frames queued per stream. Submitting to a full queue drops its oldest frame.
+ * @var cvtdl_stream_sched_config_t::deadline_ms
+ * Frames waiting longer than this are dropped instead of run, 0 never drops on time.
+ */
+typedef struct {
+  uint32_t num_workers;
+  uint32_t max_streams;
+  uint32_t queue_depth;
+  uint32_t deadline_ms;
+} cvtdl_stream_sched_config_t;
+
+/** @struct cvtdl_stream_stats_t
+ * @ingroup core_cvitdlcore
+ * @brief Counters of one stream of a scheduler.
+ *
+ * @var cvtdl_stream_stats_t::submitted
+ * Frames submitted.
+ * @var cvtdl_stream_stats_t::processed
+ * Frames run by the model, including the failed ones.
+ * @var cvtdl_stream_stats_t::dropped
+ * Frames dropped by a full queue, a missed deadline or the destruction of the scheduler.
+ * @var cvtdl_stream_stats_t::failed
+ * Frames whose inference returned an error.
+ * @var cvtdl_stream_stats_t::avg_latency_ms
+ * Mean time from submit to result of the processed frames.
+ * @var cvtdl_stream_stats_t::max_latency_ms
+ * Longest time from submit to result.
+ */
+typedef struct {
+  uint64_t submitted;
+  uint64_t processed;
+  uint64_t dropped;
+  uint64_t failed;
+  float avg_latency_ms;
+  float max_latency_ms;
+} cvtdl_stream_stats_t;
+
 /**
  * @brief A helper function to get the unit size of feature_type_e.
  * @ingroup core_cvitdlcore
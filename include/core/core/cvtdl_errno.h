@@ -67,6 +67,7 @@ typedef enum _CVI_TDL_CORE_ERROR_ID {
   EN_CVI_TDL_NOT_YET_INITIALIZED        = 11,
   EN_CVI_TDL_NOT_YET_IMPLEMENTED        = 12,
   EN_CVI_TDL_ERR_ALLOC_ION_FAIL         = 13,
+  EN_CVI_TDL_FRAME_DROPPED              = 14,
 } CVI_TDL_CORE_ERROR_ID;
 
 typedef enum _CVI_TDL_MD_ERROR_ID {
@@ -109,6 +110,8 @@ typedef enum _CVI_TDL_RC_CODE {
   CVI_TDL_ERR_NOT_YET_IMPLEMENTED     = CVI_TDL_DEF_ERR(CVI_TDL_MODULE_ID_CORE, CVI_TDL_FUNC_ID_CORE, EN_CVI_TDL_NOT_YET_IMPLEMENTED),
   // Failed to allocate ION
   CVI_TDL_ERR_ALLOC_ION_FAIL          = CVI_TDL_DEF_ERR(CVI_TDL_MODULE_ID_CORE, CVI_TDL_FUNC_ID_CORE, EN_CVI_TDL_ERR_ALLOC_ION_FAIL),
+  // Frame dropped by the stream scheduler
+  CVI_TDL_ERR_FRAME_DROPPED           = CVI_TDL_DEF_ERR(CVI_TDL_MODULE_ID_CORE, CVI_TDL_FUNC_ID_CORE, EN_CVI_TDL_FRAME_DROPPED),
   /* Algorithm specific return code */
 
   // Operation failed of Motion Detection
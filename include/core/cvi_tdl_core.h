@@ -308,6 +308,47 @@ DLL_EXPORT CVI_S32 CVI_TDL_SetSkipVpssPreprocess(cvitdl_handle_t handle,
 DLL_EXPORT CVI_S32 CVI_TDL_SetPerfEvalInterval(cvitdl_handle_t handle,
                                                CVI_TDL_SUPPORTED_MODEL_E config, int interval);
 
+/**
+ * @brief Capture the input frames, output tensors and result metas of every inference call of a
+ * model into an indexed file, to reproduce field issues with CVI_TDL_StartReplay. Object and face
+ * results are captured as boxes and classes.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model_index Supported model id, the model must be opened.
+ * @param filepath Capture file, overwritten.
+ * @param with_frame Also capture the pixels of the input frames, otherwise only their size and
+ * format.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_StartCapture(cvitdl_handle_t handle,
+                                        CVI_TDL_SUPPORTED_MODEL_E model_index,
+                                        const char *filepath, bool with_frame);
+
+/**
+ * @brief Replay a capture of CVI_TDL_StartCapture. The inference calls of the model skip VPSS and
+ * the TPU and take their output tensors from the capture in order, so the postprocess runs on
+ * the captured data. The calls must be made in the captured order.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model_index Supported model id, opened with the model used for the capture.
+ * @param filepath Capture file.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_StartReplay(cvitdl_handle_t handle,
+                                       CVI_TDL_SUPPORTED_MODEL_E model_index,
+                                       const char *filepath);
+
+/**
+ * @brief Stop capturing or replaying. The capture file is only complete after this call or
+ * after the model is closed.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model_index Supported model id.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_StopCapture(cvitdl_handle_t handle,
+                                       CVI_TDL_SUPPORTED_MODEL_E model_index);
+
 /**
  * @brief Set list depth for VPSS.
  *
@@ -500,6 +541,194 @@ DLL_EXPORT CVI_S32 CVI_TDL_CloseAllModel(cvitdl_handle_t handle);
  */
 DLL_EXPORT CVI_S32 CVI_TDL_CloseModel(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E model);
 
+/**
+ * @brief Get the memory accounted to a handle: its models, trackers and the feature galleries of
+ * the services created on it. ION of a model is estimated from the cvimodel and its I/O tensors,
+ * VB is the preprocessed frames held during an inference. Result buffers owned by the caller are
+ * not included.
+ *
+ * @param handle An TDL SDK handle.
+ * @param usage Output counters per memory type, alloc_rate covers the time since the previous
+ * query of the handle.
+ * @return int Return CVI_TDL_SUCCESS.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_GetMemUsage(const cvitdl_handle_t handle, cvtdl_mem_usage_t *usage);
+
+/**
+ * @brief Get the memory accounted to one model of a handle.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model_index Supported model id.
+ * @param usage Output counters per memory type.
+ * @return int Return CVI_TDL_SUCCESS, CVI_TDL_ERR_NOT_YET_INITIALIZED if the model is not created.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_GetModelMemUsage(const cvitdl_handle_t handle,
+                                            CVI_TDL_SUPPORTED_MODEL_E model_index,
+                                            cvtdl_mem_usage_t *usage);
+
+/**
+ * @brief Print the memory accounts of a handle and of each of its models to stdout, to spot the
+ * owner of a growing live byte count.
+ *
+ * @param handle An TDL SDK handle.
+ * @return int Return CVI_TDL_SUCCESS.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_DumpMemUsage(const cvitdl_handle_t handle);
+
+/**
+ * @brief Get how a model of a handle was loaded. Models opened from the same cvimodel file, by
+ * this handle or another one, are registered once and share their weights.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model_index Supported model id.
+ * @param info Output load information.
+ * @return int Return CVI_TDL_SUCCESS, CVI_TDL_ERR_NOT_YET_INITIALIZED if the model is not opened.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_GetModelLoadInfo(const cvitdl_handle_t handle,
+                                            CVI_TDL_SUPPORTED_MODEL_E model_index,
+                                            cvtdl_model_load_info_t *info);
+
+/**
+ * @brief Start or stop recording the timeline of the SDK: VPSS preprocessing, forward and output
+ * parsing of each model, NMS, trackers, feature matching and the update of the apps. Recording
+ * applies to all handles and threads. Starting drops the spans recorded before.
+ *
+ * @param enable True to record.
+ * @return int Return CVI_TDL_SUCCESS.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Trace_Enable(bool enable);
+
+/**
+ * @brief Write the recorded spans as Chrome trace events JSON, to be opened in chrome://tracing
+ * or ui.perfetto.dev. Each thread keeps its latest 2048 spans.
+ *
+ * @param filepath Output json file.
+ * @return int Return CVI_TDL_SUCCESS if the file is written.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Trace_Export(const char *filepath);
+
+/**
+ * @brief Begin a span of the caller, to show its own stages on the timeline.
+ *
+ * @return uint64_t Start time to give to CVI_TDL_Trace_End, 0 when not recording.
+ */
+DLL_EXPORT uint64_t CVI_TDL_Trace_Begin(void);
+
+/**
+ * @brief End a span begun by CVI_TDL_Trace_Begin.
+ *
+ * @param name Span name, must be a string literal or outlive the export.
+ * @param category Span category, same lifetime as name.
+ * @param begin Return value of CVI_TDL_Trace_Begin.
+ */
+DLL_EXPORT void CVI_TDL_Trace_End(const char *name, const char *category, uint64_t begin);
+
+/** @typedef cvitdl_stream_sched_t
+ * @ingroup core_cvitdlcore
+ * @brief A scheduler running one detection model for many video streams.
+ */
+typedef void *cvitdl_stream_sched_t;
+
+/**
+ * @brief Result of a frame submitted to a stream scheduler, called from a worker thread. A frame
+ * dropped because its queue is full is reported from CVI_TDL_StreamSched_Submit, and the queued
+ * frames from CVI_TDL_StreamSched_Destroy, on the calling thread.
+ *
+ * The results of a stream come one at a time and in submit order. Results of different streams
+ * may come at the same time from different workers. A dropped frame is reported as soon as it is
+ * dropped, possibly before the result of an older frame of its stream.
+ *
+ * @param stream_id Stream of the frame.
+ * @param status CVI_TDL_SUCCESS, CVI_TDL_ERR_FRAME_DROPPED if the frame was not run, or the error
+ * of the inference.
+ * @param frame The submitted frame, the scheduler does not use it anymore.
+ * @param obj Detections of the frame, NULL if dropped. Valid during the call only, copy it or
+ * publish it with CVI_TDL_ResultChannel_PublishObject.
+ * @param user_data User data given to CVI_TDL_StreamSched_Create.
+ */
+typedef void (*cvtdl_stream_result_cb)(uint32_t stream_id, CVI_S32 status,
+                                       VIDEO_FRAME_INFO_S *frame, cvtdl_object_t *obj,
+                                       void *user_data);
+
+/**
+ * @brief Get the default stream scheduler config: 2 workers, 16 streams, 2 frames queued per
+ * stream and a 200 ms deadline.
+ *
+ * @param config Output config.
+ * @return int Return CVI_TDL_SUCCESS.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_StreamSched_GetDefaultConfig(cvtdl_stream_sched_config_t *config);
+
+/**
+ * @brief Create a scheduler serving one detection model (see CVI_TDL_Detection) to many streams.
+ * Each worker opens the model on a handle of its own, the instances share the weights.
+ *
+ * @param sched Output scheduler.
+ * @param model_index Detection model id.
+ * @param filepath cvimodel file path.
+ * @param config Scheduler config, NULL for the default one.
+ * @param callback Result callback.
+ * @param user_data Passed to the callback.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_StreamSched_Create(cvitdl_stream_sched_t *sched,
+                                              CVI_TDL_SUPPORTED_MODEL_E model_index,
+                                              const char *filepath,
+                                              const cvtdl_stream_sched_config_t *config,
+                                              cvtdl_stream_result_cb callback, void *user_data);
+
+/**
+ * @brief Get the handle of a worker, to set the model threshold or other model options. Set
+ * them on every worker before the first submit.
+ *
+ * @param sched Scheduler.
+ * @param worker Worker index, below config.num_workers.
+ * @param handle Output handle, owned by the scheduler.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_StreamSched_GetHandle(cvitdl_stream_sched_t sched, uint32_t worker,
+                                                 cvitdl_handle_t *handle);
+
+/**
+ * @brief Queue a frame of a stream and return. The frame must stay valid until the callback
+ * reports it.
+ *
+ * @param sched Scheduler.
+ * @param stream_id Stream of the frame, below config.max_streams.
+ * @param frame Input frame.
+ * @return int Return CVI_TDL_SUCCESS if the frame is queued.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_StreamSched_Submit(cvitdl_stream_sched_t sched, uint32_t stream_id,
+                                              VIDEO_FRAME_INFO_S *frame);
+
+/**
+ * @brief Wait until every submitted frame is reported.
+ *
+ * @param sched Scheduler.
+ * @return int Return CVI_TDL_SUCCESS.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_StreamSched_Flush(cvitdl_stream_sched_t sched);
+
+/**
+ * @brief Get the counters of a stream.
+ *
+ * @param sched Scheduler.
+ * @param stream_id Stream id.
+ * @param stats Output counters.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_StreamSched_GetStats(cvitdl_stream_sched_t sched, uint32_t stream_id,
+                                                cvtdl_stream_stats_t *stats);
+
+/**
+ * @brief Destroy a scheduler. The queued frames are reported as dropped, the frames in flight
+ * are finished first.
+ *
+ * @param sched Scheduler.
+ * @return int Return CVI_TDL_SUCCESS.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_StreamSched_Destroy(cvitdl_stream_sched_t sched);
+
 /**
  * @brief Export vpss channel attribute.
  *
@@ -933,6 +1162,17 @@ DLL_EXPORT CVI_S32 CVI_TDL_DeepSORT_CleanCounter(const cvitdl_handle_t handle);
 DLL_EXPORT CVI_S32 CVI_TDL_DeepSORT_Obj(const cvitdl_handle_t handle, cvtdl_object_t *obj,
                                         cvtdl_tracker_t *tracker, bool use_reid);
 
+/**
+ * @brief Advance the DeepSORT tracks by their Kalman prediction on a frame that skipped detection,
+ * e.g. when CVI_TDL_MotionGate returns CVTDL_MOTION_GATE_SKIP. The tracks are not counted as
+ * unmatched.
+ *
+ * @param handle An TDL SDK handle.
+ * @param tracker Output predicted boxes of the stable tracks.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_DeepSORT_Coast(const cvitdl_handle_t handle, cvtdl_tracker_t *tracker);
+
 /**
  * @brief Run DeepSORT/SORT track for object, add function to judge cross the border.
  *
@@ -1139,8 +1379,6 @@ DLL_EXPORT CVI_S32 CVI_TDL_LicensePlateRecognition(const cvitdl_handle_t handle,
                                                    CVI_TDL_SUPPORTED_MODEL_E model_id,
                                                    cvtdl_object_t *vehicle);
 
-DLL_EXPORT CVI_S32 CVI_TDL_OCR_Detection(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
-                                         cvtdl_object_t *obj_meta);
 /**
  * \addtogroup core_fall Fall Detection
  * \ingroup core_tdl
@@ -1235,6 +1473,50 @@ DLL_EXPORT CVI_S32 CVI_TDL_MotionDetection(const cvitdl_handle_t handle, VIDEO_F
                                            cvtdl_object_t *objects, uint8_t threshold,
                                            double min_area);
 
+/**
+ * @brief Get the default motion gate config.
+ *
+ * @param config Output config.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_MotionGate_GetDefaultConfig(cvtdl_motion_gate_config_t *config);
+
+/**
+ * @brief Set the motion gate config.
+ *
+ * @param handle An TDL SDK handle.
+ * @param config Motion gate config.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Set_MotionGate_Config(const cvitdl_handle_t handle,
+                                                 const cvtdl_motion_gate_config_t *config);
+
+/**
+ * @brief Decide from the output of CVI_TDL_MotionDetection whether the detectors run on the
+ * whole frame, on the motion ROI or not at all. For CVTDL_MOTION_GATE_ROI crop gate->roi (e.g.
+ * with CVI_TDL_CropResizeImage), detect on the crop and map the objects back with
+ * CVI_TDL_MotionGate_RestoreObjects. For CVTDL_MOTION_GATE_SKIP coast the tracks with
+ * CVI_TDL_DeepSORT_Coast.
+ *
+ * @param handle An TDL SDK handle.
+ * @param frame Input video frame.
+ * @param motion Motion boxes of the frame.
+ * @param gate Output decision.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_MotionGate(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
+                                      const cvtdl_object_t *motion, cvtdl_motion_gate_t *gate);
+
+/**
+ * @brief Map the boxes of objects detected on the crop of a motion gate ROI back to the frame.
+ *
+ * @param gate Decision the crop was made for.
+ * @param obj Objects detected on the crop, updated in place.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_MotionGate_RestoreObjects(const cvtdl_motion_gate_t *gate,
+                                                     cvtdl_object_t *obj);
+
 /**@}*/
 
 /**
@@ -1386,6 +1668,21 @@ DLL_EXPORT CVI_S32 CVI_TDL_PoseDetection(const cvitdl_handle_t handle, VIDEO_FRA
                                          CVI_TDL_SUPPORTED_MODEL_E model_index,
                                          cvtdl_object_t *obj_meta);
 
+/**
+ * @brief Set the sub-pixel refinement of a heatmap (HRNet) or SimCC pose model.
+ *
+ * HRNet defaults to CVTDL_KEYPOINT_REFINE_DARK, SimCC to CVTDL_KEYPOINT_REFINE_NONE. For SimCC
+ * any refinement fits a parabola around the maximum of each coordinate.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model_index CVI_TDL_SUPPORTED_MODEL_HRNET_POSE or CVI_TDL_SUPPORTED_MODEL_SIMCC_POSE.
+ * @param refine Refinement method.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Set_Pose_KeypointRefine(const cvitdl_handle_t handle,
+                                                   CVI_TDL_SUPPORTED_MODEL_E model_index,
+                                                   cvtdl_keypoint_refine_e refine);
+
 /**
  * @brief human keypoints detection
  *
@@ -1398,9 +1695,58 @@ DLL_EXPORT CVI_S32 CVI_TDL_PoseDetection(const cvitdl_handle_t handle, VIDEO_FRA
 DLL_EXPORT CVI_S32 CVI_TDL_Super_Resolution(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
                                             cvtdl_sr_feature *srfeature);
 
+/**
+ * @brief Detect text boxes with a DB text detection model.
+ *
+ * @param handle An TDL SDK handle.
+ * @param frame Input video frame.
+ * @param obj_meta Output text boxes, bbox::score is the mean text probability of the box.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_OCR_Detection(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
+                                         cvtdl_object_t *obj_meta);
+
+/**
+ * @brief Recognize the text in the boxes of CVI_TDL_OCR_Detection.
+ *
+ * @param handle An TDL SDK handle.
+ * @param frame Input video frame.
+ * @param obj_meta Text boxes, the text of every box is stored in its text_properity.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
 DLL_EXPORT CVI_S32 CVI_TDL_OCR_Recognition(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
                                            cvtdl_object_t *obj_meta);
 
+/**
+ * @brief Set the CTC beam width of a text or license plate recognition model.
+ *
+ * A width of 1 decodes greedily. Wider beams run a prefix beam search, which for license plates
+ * only keeps character sequences that fit the plate layout of the region. All models default to
+ * 1, a width of 8 is a good start for plates.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model_index CVI_TDL_SUPPORTED_MODEL_OCR_RECOGNITION or a license plate recognition model.
+ * @param beam_width Beam width, at least 1.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Set_CTC_BeamWidth(const cvitdl_handle_t handle,
+                                             CVI_TDL_SUPPORTED_MODEL_E model_index,
+                                             int beam_width);
+
+/**
+ * @brief Fill the character confidences of a license plate recognition model when it decodes
+ * greedily. They need a softmax over the classes of every character, which costs more than the
+ * greedy decoding itself, so they are off by default and license_char_num is 0. The beam search
+ * and the text recognition always fill them.
+ *
+ * @param handle An TDL SDK handle.
+ * @param model_index A license plate recognition model.
+ * @param enable Compute the confidences.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Set_CTC_Confidence(const cvitdl_handle_t handle,
+                                              CVI_TDL_SUPPORTED_MODEL_E model_index, bool enable);
+
 /**
  * @brief image classification
  *
@@ -1528,6 +1874,20 @@ DLL_EXPORT CVI_S32 CVI_TDL_Clip_Text_Feature(const cvitdl_handle_t handle,
 DLL_EXPORT CVI_S32 CVI_TDL_YoloV8_Seg(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
                                       cvtdl_object_t *obj_meta);
 
+/**
+ * @brief Set the layout of the masks produced by CVI_TDL_YoloV8_Seg.
+ *
+ * CVTDL_MASK_FORMAT_FULL (default) fills a mask_height x mask_width map per object,
+ * CVTDL_MASK_FORMAT_BBOX only stores the box crop at (mask_x, mask_y) and
+ * CVTDL_MASK_FORMAT_RLE stores the box crop as runs in mask_rle.
+ *
+ * @param handle An TDL SDK handle.
+ * @param format Mask layout.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Set_YoloV8_Seg_MaskFormat(const cvitdl_handle_t handle,
+                                                     cvtdl_mask_format_e format);
+
 /**
  * @brief get audio algorithm param
  *
@@ -1579,6 +1939,20 @@ DLL_EXPORT CVI_S32 CVI_TDL_Set_Polylanenet_Lower(const cvitdl_handle_t handle,
 DLL_EXPORT CVI_S32 CVI_TDL_LSTR_Det(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
                                     cvtdl_lane_t *lane_meta);
 
+/**
+ * @brief Track the lanes of CVI_TDL_Lane_Det, CVI_TDL_LSTR_Det or CVI_TDL_PolyLane_Det across
+ * frames. The tracked lanes are smoothed and carry a unique_id and a departure_rate, in pixels
+ * per frame towards the frame center. Call it on every frame, with NULL lane_meta on the frames
+ * the lane model is skipped so the lanes are predicted.
+ *
+ * @param handle An TDL SDK handle.
+ * @param lane_meta Detected lanes of the frame, or NULL.
+ * @param tracked_lanes Output tracked lanes, left to right, may be lane_meta.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Lane_Track(const cvitdl_handle_t handle, const cvtdl_lane_t *lane_meta,
+                                      cvtdl_lane_t *tracked_lanes);
+
 DLL_EXPORT CVI_S32 CVI_TDL_Set_TextPreprocess(const char *encoderFile, const char *bpeFile,
                                               const char *textFile, int32_t **tokens,
                                               int numSentences);
@@ -1593,6 +1967,31 @@ DLL_EXPORT CVI_S32 CVI_TDL_Set_MaskOutlinePoint(VIDEO_FRAME_INFO_S *frame,
 DLL_EXPORT CVI_S32 CVI_TDL_Depth_Stereo(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame1,
                                         VIDEO_FRAME_INFO_S *frame2,
                                         cvtdl_depth_logits_t *depth_logist);
+
+/**
+ * @brief Set how CVI_TDL_Depth_Stereo writes its output. The int8 logits can go to a caller
+ * buffer, be skipped in favour of the raw tensor and its scale, and be converted to metric depth
+ * through a table. The config is copied, the buffers must stay valid while it is set.
+ *
+ * @param handle An TDL SDK handle.
+ * @param output Output options, NULL restores the default malloc-ed int_logits.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Depth_Stereo_SetOutput(const cvitdl_handle_t handle,
+                                                  const cvtdl_depth_output_t *output);
+
+/**
+ * @brief Fill the disparity to metric depth table of cvtdl_depth_output_t,
+ * baseline * focal / (disparity * disparity_scale), 0 for the disparities <= 0.
+ *
+ * @param baseline Distance between the cameras, in the unit of the depth.
+ * @param focal Focal length in pixels of the disparity map.
+ * @param disparity_scale Pixels of disparity per int_logits step.
+ * @param lut Output table of 256 entries.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Depth_Stereo_MakeDepthLUT(float baseline, float focal,
+                                                     float disparity_scale, float *lut);
 #ifdef __cplusplus
 }
 #endif
@@ -22,7 +22,17 @@ DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_lane_t *lane_meta);
 DLL_EXPORT void CVI_TDL_FreeCpp(cvtdl_clip_feature *clip_meta);
 DLL_EXPORT void CVI_TDL_CopyInfoCpp(const cvtdl_face_info_t *info, cvtdl_face_info_t *infoNew);
 DLL_EXPORT void CVI_TDL_CopyInfoCpp(const cvtdl_dms_od_info_t *info, cvtdl_dms_od_info_t *infoNew);
+// A CVTDL_MASK_FORMAT_FULL mask is sized by the object meta, only CVI_TDL_CopyObjectMeta copies it.
 DLL_EXPORT void CVI_TDL_CopyInfoCpp(const cvtdl_object_info_t *info, cvtdl_object_info_t *infoNew);
+
+// Result meta storage behind CVI_TDL_MemAlloc. Metas set up with CVI_TDL_Reserve{Face,Object}Meta
+// keep info[] and serve the per-object payloads from an arena, the others use the heap.
+DLL_EXPORT void CVI_TDL_MetaReserve(const uint32_t size, cvtdl_face_t *face, bool init);
+DLL_EXPORT void CVI_TDL_MetaReserve(const uint32_t size, cvtdl_object_t *obj, bool init);
+DLL_EXPORT void *CVI_TDL_MetaArenaAlloc(cvtdl_face_t *face, size_t bytes);
+DLL_EXPORT void *CVI_TDL_MetaArenaAlloc(cvtdl_object_t *obj, size_t bytes);
+DLL_EXPORT void CVI_TDL_MetaFree(cvtdl_face_t *face, void *ptr);
+DLL_EXPORT void CVI_TDL_MetaFree(cvtdl_object_t *obj, void *ptr);
 #endif
 
 #ifdef __cplusplus
@@ -44,6 +54,16 @@ DLL_EXPORT void CVI_TDL_FreeSegLogits(cvtdl_seg_logits_t *seg_logits);
 DLL_EXPORT void CVI_TDL_FreeLane(cvtdl_lane_t *lane_meta);
 DLL_EXPORT void CVI_TDL_FreeClip(cvtdl_clip_feature *clip_meta);
 
+/*
+ * Keep info[] (capacity slots to start with) and the per-object payloads of a result meta across
+ * frames, for a meta passed to the same inference again and again. The previous content is freed.
+ * Every result then overwrites the previous one in place, so do not free single infos of such a
+ * meta and copy it with CVI_TDL_CopyFaceMeta/CVI_TDL_CopyObjectMeta only. CVI_TDL_Free releases
+ * everything and ends the reuse.
+ */
+DLL_EXPORT void CVI_TDL_ReserveFaceMeta(cvtdl_face_t *face, uint32_t capacity);
+DLL_EXPORT void CVI_TDL_ReserveObjectMeta(cvtdl_object_t *obj, uint32_t capacity);
+
 DLL_EXPORT void CVI_TDL_CopyFaceInfo(const cvtdl_face_info_t *src, cvtdl_face_info_t *dst);
 DLL_EXPORT void CVI_TDL_CopyObjectInfo(const cvtdl_object_info_t *src, cvtdl_object_info_t *dst);
 DLL_EXPORT void CVI_TDL_CopyFaceMeta(const cvtdl_face_t *src, cvtdl_face_t *dst);
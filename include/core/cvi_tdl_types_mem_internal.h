@@ -16,6 +16,18 @@ inline void CVI_TDL_MemAlloc(const uint32_t unit_len, const uint32_t size,
   }
 }
 
+// Same as above, for a feature of meta: kept metas serve the buffer from their arena.
+template <typename MetaT>
+inline void CVI_TDL_MemAlloc(const uint32_t unit_len, const uint32_t size,
+                             const feature_type_e type, cvtdl_feature_t *feature, MetaT *meta) {
+  if (feature->size != size || feature->type != type) {
+    CVI_TDL_MetaFree(meta, feature->ptr);
+    feature->ptr = (int8_t *)CVI_TDL_MetaArenaAlloc(meta, unit_len * size);
+    feature->size = size;
+    feature->type = type;
+  }
+}
+
 inline void CVI_TDL_MemAlloc(const uint32_t size, cvtdl_pts_t *pts) {
   if (pts->size != size) {
     free(pts->x);
@@ -35,30 +47,15 @@ inline void CVI_TDL_MemAlloc(const uint32_t size, cvtdl_tracker_t *tracker) {
 }
 
 inline void CVI_TDL_MemAlloc(const uint32_t size, cvtdl_face_t *meta) {
-  if (meta->size != size) {
-    for (uint32_t i = 0; i < meta->size; i++) {
-      CVI_TDL_FreeCpp(&meta->info[i]);
-      free(meta->info);
-    }
-    meta->size = size;
-    meta->info = (cvtdl_face_info_t *)malloc(sizeof(cvtdl_face_info_t) * meta->size);
-    meta->dms = NULL;
-  }
+  CVI_TDL_MetaReserve(size, meta, false);
 }
 
 inline void CVI_TDL_MemAlloc(const uint32_t size, cvtdl_object_t *meta) {
-  if (meta->size != size) {
-    for (uint32_t i = 0; i < meta->size; i++) {
-      CVI_TDL_FreeCpp(&meta->info[i]);
-      free(meta->info);
-    }
-    meta->size = size;
-    meta->info = (cvtdl_object_info_t *)malloc(sizeof(cvtdl_object_info_t) * meta->size);
-  }
+  CVI_TDL_MetaReserve(size, meta, false);
 }
 
 inline void CVI_TDL_MemAllocInit(const uint32_t size, cvtdl_object_t *meta) {
-  CVI_TDL_MemAlloc(size, meta);
+  CVI_TDL_MetaReserve(size, meta, true);
   for (uint32_t i = 0; i < meta->size; ++i) {
     memset(&meta->info[i], 0, sizeof(cvtdl_object_info_t));
     meta->info[i].bbox.x1 = -1;
@@ -72,7 +69,7 @@ inline void CVI_TDL_MemAllocInit(const uint32_t size, cvtdl_object_t *meta) {
 }
 
 inline void CVI_TDL_MemAllocInit(const uint32_t size, const uint32_t pts_num, cvtdl_face_t *meta) {
-  CVI_TDL_MemAlloc(size, meta);
+  CVI_TDL_MetaReserve(size, meta, true);
   for (uint32_t i = 0; i < meta->size; ++i) {
     meta->info[i].bbox.x1 = -1;
     meta->info[i].bbox.x2 = -1;
@@ -95,8 +92,8 @@ inline void CVI_TDL_MemAllocInit(const uint32_t size, const uint32_t pts_num, cv
 
     memset(&meta->info[i].feature, 0, sizeof(cvtdl_feature_t));
     if (pts_num > 0) {
-      meta->info[i].pts.x = (float *)malloc(sizeof(float) * pts_num);
-      meta->info[i].pts.y = (float *)malloc(sizeof(float) * pts_num);
+      meta->info[i].pts.x = (float *)CVI_TDL_MetaArenaAlloc(meta, sizeof(float) * pts_num);
+      meta->info[i].pts.y = (float *)CVI_TDL_MetaArenaAlloc(meta, sizeof(float) * pts_num);
       meta->info[i].pts.size = pts_num;
       for (uint32_t j = 0; j < meta->info[i].pts.size; ++j) {
         meta->info[i].pts.x[j] = -1;
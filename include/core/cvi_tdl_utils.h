@@ -114,6 +114,71 @@ DLL_EXPORT CVI_S32 CVI_TDL_CreateImageFromVideoFrame(const VIDEO_FRAME_INFO_S *p
                                                      cvtdl_image_t *image);
 DLL_EXPORT CVI_S32 CVI_TDL_CreateImageFromVideoFrameSize(const VIDEO_FRAME_INFO_S *p_crop_frame,
                                                          cvtdl_image_t *image, uint32_t img_size);
+
+/** @typedef cvitdl_result_channel_t
+ *  @ingroup core_utils
+ *  @brief Lock-free channel publishing result metas from one inference thread to readers.
+ */
+typedef void *cvitdl_result_channel_t;
+
+/**
+ * @brief Create a result channel for cvtdl_object_t or cvtdl_face_t results.
+ *
+ * The inference thread publishes its meta instead of copying it under a mutex, readers such as
+ * OSD or encoder threads acquire the latest result as a read-only snapshot. Neither side blocks
+ * and nothing is copied. Only one thread may publish to a channel.
+ *
+ * @param channel Output channel handle.
+ * @param is_face Carry cvtdl_face_t results if true, cvtdl_object_t results otherwise.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_ResultChannel_Create(cvitdl_result_channel_t *channel, bool is_face);
+
+/**
+ * @brief Destroy a result channel and free the metas it holds. All snapshots must be released.
+ *
+ * @param channel Channel handle.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_ResultChannel_Destroy(cvitdl_result_channel_t channel);
+
+/**
+ * @brief Publish a result. The content of meta is moved into the channel and meta receives a
+ * recycled meta of an older snapshot, which can be passed to the next inference as is.
+ *
+ * @param channel Channel handle.
+ * @param meta The cvtdl_object_t or cvtdl_face_t result, matching the channel type.
+ * @return int Return CVI_TDL_SUCCESS on success, CVI_TDL_FAILURE if readers hold every snapshot
+ * slot. meta is left untouched in that case.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_ResultChannel_PublishObject(cvitdl_result_channel_t channel,
+                                                       cvtdl_object_t *meta);
+DLL_EXPORT CVI_S32 CVI_TDL_ResultChannel_PublishFace(cvitdl_result_channel_t channel,
+                                                     cvtdl_face_t *meta);
+
+/**
+ * @brief Acquire the latest published result. The snapshot stays valid and unchanged until it is
+ * released with CVI_TDL_ResultChannel_Release.
+ *
+ * @param channel Channel handle.
+ * @param meta Output snapshot, NULL if nothing was published yet.
+ * @param seq Optional output sequence number of the snapshot, increases with every publish.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_ResultChannel_AcquireObject(cvitdl_result_channel_t channel,
+                                                       const cvtdl_object_t **meta, uint64_t *seq);
+DLL_EXPORT CVI_S32 CVI_TDL_ResultChannel_AcquireFace(cvitdl_result_channel_t channel,
+                                                     const cvtdl_face_t **meta, uint64_t *seq);
+
+/**
+ * @brief Release a snapshot returned by CVI_TDL_ResultChannel_AcquireObject/AcquireFace.
+ *
+ * @param channel Channel handle.
+ * @param meta The acquired snapshot. NULL is ignored.
+ * @return int Return CVI_TDL_SUCCESS on success.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_ResultChannel_Release(cvitdl_result_channel_t channel,
+                                                 const void *meta);
 #ifdef __cplusplus
 }
 #endif
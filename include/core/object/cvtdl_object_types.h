@@ -252,6 +252,23 @@ typedef struct {
   float score[17];
 } cvtdl_pose17_meta_t;
 
+/** @enum cvtdl_keypoint_refine_e
+ *  @ingroup core_cvitdlcore
+ *  @brief Sub-pixel refinement of keypoints decoded from heatmaps.
+ *
+ * @var cvtdl_keypoint_refine_e::CVTDL_KEYPOINT_REFINE_NONE
+ * The integer position of the heatmap maximum.
+ * @var cvtdl_keypoint_refine_e::CVTDL_KEYPOINT_REFINE_QUARTER
+ * A quarter pixel shift towards the higher neighbour of the maximum.
+ * @var cvtdl_keypoint_refine_e::CVTDL_KEYPOINT_REFINE_DARK
+ * DARK: a Taylor expansion of the log of the smoothed heatmap around the maximum.
+ */
+typedef enum {
+  CVTDL_KEYPOINT_REFINE_NONE = 0,
+  CVTDL_KEYPOINT_REFINE_QUARTER,
+  CVTDL_KEYPOINT_REFINE_DARK,
+} cvtdl_keypoint_refine_e;
+
 /** @struct cvtdl_vehicle_meta
  * @ingroup core_cvitdlcore
  * @brief A structure to describe a vehicle properity.
@@ -261,6 +278,14 @@ typedef struct {
  * The license bounding box.
  * @var cvtdl_vehicle_meta::license_char
  * The license characters
+ * @var cvtdl_vehicle_meta::license_char_conf
+ * The probability of every decoded plate character.
+ * @var cvtdl_vehicle_meta::license_char_num
+ * The number of decoded plate characters in license_char_conf, 0 when the greedy decoding runs
+ * without confidences (see CVI_TDL_Set_CTC_Confidence).
+ *
+ * license_char_conf and license_char_num are appended, so code using sizeof(cvtdl_vehicle_meta)
+ * must be rebuilt against this header.
  * @see cvtdl_4_pts_t
  * @see cvtdl_bbox_t
  * @see cvtdl_object_info_t
@@ -269,6 +294,8 @@ typedef struct {
   cvtdl_4_pts_t license_pts;
   cvtdl_bbox_t license_bbox;
   char license_char[125];
+  float license_char_conf[32];
+  uint32_t license_char_num;
 } cvtdl_vehicle_meta;
 
 /** @struct cvtdl_pedestrian_meta
@@ -292,10 +319,86 @@ typedef struct {
   adas_state_e state;
 } cvtdl_adas_meta;
 
+/** @struct cvtdl_text_meta
+ * @ingroup core_cvitdlcore
+ * @brief A structure to describe recognized text.
+ * @var cvtdl_text_meta::text
+ * The recognized text in UTF-8.
+ * @var cvtdl_text_meta::char_conf
+ * The probability of every recognized character, only the first 64 are kept.
+ * @var cvtdl_text_meta::char_num
+ * The number of recognized characters.
+ * @var cvtdl_text_meta::score
+ * The mean probability of the characters.
+ * @see cvtdl_object_info_t
+ */
+typedef struct {
+  char text[256];
+  float char_conf[64];
+  uint32_t char_num;
+  float score;
+} cvtdl_text_meta;
+
+/** @enum cvtdl_mask_format_e
+ *  @ingroup core_cvitdlcore
+ *  @brief Storage format of cvtdl_mask_meta::mask.
+ *
+ * @var cvtdl_mask_format_e::CVTDL_MASK_FORMAT_FULL
+ * mask is mask_width x mask_height bytes of the whole prototype map, 255 for foreground.
+ * @var cvtdl_mask_format_e::CVTDL_MASK_FORMAT_BBOX
+ * mask only covers the box (mask_x, mask_y, mask_w, mask_h) in prototype map coordinate.
+ * @var cvtdl_mask_format_e::CVTDL_MASK_FORMAT_RLE
+ * mask is NULL, mask_rle holds row-major run lengths inside the box, starting with a
+ * background run (which may be 0) and alternating background/foreground.
+ */
+typedef enum {
+  CVTDL_MASK_FORMAT_FULL = 0,
+  CVTDL_MASK_FORMAT_BBOX,
+  CVTDL_MASK_FORMAT_RLE,
+} cvtdl_mask_format_e;
+
+/** @struct cvtdl_mask_meta
+ * @ingroup core_cvitdlcore
+ * @brief A structure to describe the segmentation mask of an object.
+ * @var cvtdl_mask_meta::mask
+ * The mask bytes, laid out as mask_format says. NULL in CVTDL_MASK_FORMAT_RLE, so check
+ * mask_format before reading it.
+ * @var cvtdl_mask_meta::mask_point
+ * The outline points of the mask, x and y interleaved.
+ * @var cvtdl_mask_meta::mask_point_size
+ * The number of outline points.
+ * @var cvtdl_mask_meta::mask_format
+ * The storage format of mask and mask_rle.
+ * @var cvtdl_mask_meta::mask_x
+ * The left of the mask box in prototype map coordinate.
+ * @var cvtdl_mask_meta::mask_y
+ * The top of the mask box in prototype map coordinate.
+ * @var cvtdl_mask_meta::mask_w
+ * The width of the mask box.
+ * @var cvtdl_mask_meta::mask_h
+ * The height of the mask box.
+ * @var cvtdl_mask_meta::mask_rle
+ * The run lengths in CVTDL_MASK_FORMAT_RLE, NULL otherwise.
+ * @var cvtdl_mask_meta::mask_rle_size
+ * The number of runs in mask_rle.
+ *
+ * The fields from mask_format on are appended, cvtdl_mask_meta is only allocated by the SDK but
+ * code using sizeof(cvtdl_mask_meta) must be rebuilt against this header.
+ * @see cvtdl_mask_format_e
+ * @see cvtdl_object_info_t
+ */
 typedef struct {
   uint8_t *mask;
   float *mask_point;
   uint32_t mask_point_size;
+
+  cvtdl_mask_format_e mask_format;
+  uint32_t mask_x;
+  uint32_t mask_y;
+  uint32_t mask_w;
+  uint32_t mask_h;
+  uint32_t *mask_rle;
+  uint32_t mask_rle_size;
 } cvtdl_mask_meta;
 
 /** @struct cvtdl_object_info_t
@@ -318,9 +421,19 @@ typedef struct {
  * The vehicle properity
  * @var cvtdl_object_info_t::pedestrian_properity
  * The pedestrian properity
+ * @var cvtdl_object_info_t::text_properity
+ * The recognized text of a text box
+ * @var cvtdl_object_info_t::ttc
+ * The ADAS time to collision in seconds, -1 when the object does not close in
+ * @var cvtdl_object_info_t::ttc_confidence
+ * The confidence of ttc, 0 to 1
+ *
+ * text_properity, ttc and ttc_confidence are appended and grow sizeof(cvtdl_object_info_t), so
+ * code indexing info arrays must be rebuilt against this header.
  * @see cvtdl_object_t
  * @see cvtdl_pedestrian_meta
  * @see cvtdl_vehicle_meta
+ * @see cvtdl_text_meta
  * @see cvtdl_bbox_t
  * @see cvtdl_pts_t
  * @see cvtdl_feature_t
@@ -338,6 +451,9 @@ typedef struct {
   cvtdl_pedestrian_meta *pedestrian_properity;
   cvtdl_adas_meta adas_properity;
   int track_state;
+  cvtdl_text_meta *text_properity;
+  float ttc;
+  float ttc_confidence;
   // float human_angle;
   // float aspect_ratio;
   // float speed;
@@ -375,10 +491,20 @@ typedef struct {
   cvtdl_object_info_t *info;
 } cvtdl_object_t;
 
+/** @struct cvtdl_lane_point_t
+ * @ingroup core_cvitdlcore
+ * @brief A detected lane, two points of the lane line.
+ *
+ * unique_id and departure_rate are appended and grow sizeof(cvtdl_lane_point_t), so code indexing
+ * lane arrays must be rebuilt against this header.
+ * @see cvtdl_lane_t
+ */
 typedef struct {
   float x[2];
   float y[2];
   float score;
+  uint64_t unique_id;    // set by CVI_TDL_Lane_Track, 0 otherwise
+  float departure_rate;  // pixels per frame towards the frame center, set by CVI_TDL_Lane_Track
 } cvtdl_lane_point_t;
 
 typedef struct {
@@ -586,6 +712,14 @@ typedef struct {
   float bgain;
 } cvtdl_isp_meta_t;
 
+/** @struct cvtdl_seg_logits_t
+ * @ingroup core_cvitdlcore
+ * @brief Output of CVI_TDL_MotionSegmentation.
+ *
+ * label_map and conf_map are appended, so code using sizeof(cvtdl_seg_logits_t) must be rebuilt
+ * against this header. They are reused while the map size stays the same and released by
+ * CVI_TDL_FreeSegLogits.
+ */
 typedef struct {
   int w;
   int h;
@@ -595,12 +729,46 @@ typedef struct {
   float *float_logits;
   int8_t *int_logits;
   float qscale;
+  uint8_t *label_map;  // b x h x w per pixel argmax over c, NULL unless 1 < c <= 256
+  float *conf_map;     // b x h x w dequantized score of label_map
 } cvtdl_seg_logits_t;
 
+/** @struct cvtdl_depth_logits_t
+ * @ingroup core_cvitdlcore
+ * @brief Output of CVI_TDL_Depth_Stereo.
+ *
+ * raw, raw_qscale and raw_is_int8 are appended, so code using sizeof(cvtdl_depth_logits_t) must
+ * be rebuilt against this header.
+ * @see cvtdl_depth_output_t
+ */
 typedef struct {
   int w;
   int h;
-  int8_t *int_logits;
+  int8_t *int_logits;  // h x w depth, malloc-ed and reused by the SDK unless an output buffer is set
+  const void *raw;     // output tensor of the model, valid until the next inference of the model
+  float raw_qscale;    // raw * raw_qscale is the int_logits value
+  bool raw_is_int8;    // raw is int8, float otherwise
 } cvtdl_depth_logits_t;
 
+/** @struct cvtdl_depth_output_t
+ * @ingroup core_cvitdlcore
+ * @brief Output options of CVI_TDL_Depth_Stereo.
+ * @var cvtdl_depth_output_t::buffer
+ * Caller owned int_logits of buffer_size bytes, NULL to let the SDK allocate them.
+ * @var cvtdl_depth_output_t::raw_only
+ * Only expose the raw tensor, int_logits is left untouched.
+ * @var cvtdl_depth_output_t::depth_lut
+ * 256 metric depths indexed by the int_logits value + 128, see CVI_TDL_Depth_Stereo_MakeDepthLUT.
+ * @var cvtdl_depth_output_t::metric_depth
+ * Caller owned h x w metric depth of metric_depth_size floats, filled when depth_lut is set.
+ */
+typedef struct {
+  int8_t *buffer;
+  uint32_t buffer_size;
+  bool raw_only;
+  const float *depth_lut;
+  float *metric_depth;
+  uint32_t metric_depth_size;
+} cvtdl_depth_output_t;
+
 #endif
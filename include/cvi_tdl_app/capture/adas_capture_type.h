@@ -14,9 +14,14 @@
 typedef struct {
   cvtdl_object_info_t info;
   tracker_state_e t_state;
-  float speed;
-  float dis;
-  float dis_tmp;
+  float speed;  // filtered d(dis)/dt, negative when closing in
+  float dis;    // filtered distance
+
+  float kf_p[3];      // covariance of [dis, speed]: p00, p01, p11
+  float last_height;  // bbox height of the last update
+  uint32_t kf_updates;
+  float ttc;
+  float ttc_confidence;
 
   float start_score;
   float warning_score;
@@ -24,6 +29,7 @@ typedef struct {
   uint32_t miss_counter;
 
   uint32_t counter;
+  uint32_t seen_frame;
 
 } adas_data_t;
 
@@ -47,6 +53,9 @@ typedef struct {
   int location_type;
 
   adas_data_t *data;
+  int32_t *data_index;  // data slots by unique_id, open addressing
+  uint32_t data_index_mask;
+  uint32_t frame_counter;
   cvtdl_lane_t lane_meta;
 
   cvtdl_object_t last_objects;
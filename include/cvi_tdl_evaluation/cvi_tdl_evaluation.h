@@ -66,6 +66,8 @@ DLL_EXPORT CVI_S32 CVI_TDL_Eval_LfwInsertLabelScore(cvitdl_eval_handle_t handle,
 
 DLL_EXPORT CVI_S32 CVI_TDL_Eval_LfwSave2File(cvitdl_eval_handle_t handle, const char *filepath);
 
+DLL_EXPORT CVI_S32 CVI_TDL_Eval_LfwSaveFeatures(cvitdl_eval_handle_t handle, const char *filepath);
+
 DLL_EXPORT CVI_S32 CVI_TDL_Eval_LfwClearInput(cvitdl_eval_handle_t handle);
 
 DLL_EXPORT CVI_S32 CVI_TDL_Eval_LfwClearEvalData(cvitdl_eval_handle_t handle);
@@ -99,6 +101,9 @@ DLL_EXPORT CVI_S32 CVI_TDL_Eval_Market1501InsertFeature(cvitdl_eval_handle_t han
                                                         const int index, bool is_query,
                                                         const cvtdl_feature_t *feature);
 DLL_EXPORT CVI_S32 CVI_TDL_Eval_Market1501EvalCMC(cvitdl_eval_handle_t handle);
+DLL_EXPORT CVI_S32 CVI_TDL_Eval_Market1501SaveFeatures(cvitdl_eval_handle_t handle,
+                                                        const char *query_path,
+                                                        const char *gallery_path);
 
 /****************************************************************
  * WLFW evaluation functions
@@ -137,7 +137,8 @@ DLL_EXPORT CVI_S32 CVI_TDL_Service_RawMatching(cvitdl_service_handle_t handle, c
  * Default is 0.05.
  * @param trans_ratio Change to zoom in ratio. Default is 0.1.
  * @param padding_ratio Bounding box padding ratio. Default is 0.3. (0 ~ 1)
- * @param outFrame Output result image, will keep aspect ratio.
+ * @param outFrame Output result image, will keep aspect ratio. Release it with
+ * CVI_TDL_Service_DigitalZoom_ReleaseFrame, which is required when the config is async.
  * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
  */
 DLL_EXPORT CVI_S32 CVI_TDL_Service_FaceDigitalZoom(
@@ -156,7 +157,8 @@ DLL_EXPORT CVI_S32 CVI_TDL_Service_FaceDigitalZoom(
  * Default is 0.05.
  * @param trans_ratio Change to zoom in ratio. Default is 0.1.
  * @param padding_ratio Bounding box padding ratio. Default is 0.3. (0 ~ 1)
- * @param outFrame Output result image, will keep aspect ratio.
+ * @param outFrame Output result image, will keep aspect ratio. Release it with
+ * CVI_TDL_Service_DigitalZoom_ReleaseFrame, which is required when the config is async.
  * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
  */
 DLL_EXPORT CVI_S32 CVI_TDL_Service_ObjectDigitalZoom(
@@ -178,7 +180,8 @@ DLL_EXPORT CVI_S32 CVI_TDL_Service_ObjectDigitalZoom(
  * @param pad_ratio_right Right bounding box padding ratio. Default is 0.3. (-1 ~ 1)
  * @param pad_ratio_top Top bounding box padding ratio. Default is 0.3. (-1 ~ 1)
  * @param pad_ratio_bottom Bottom bounding box padding ratio. Default is 0.3. (-1 ~ 1)
- * @param outFrame Output result image, will keep aspect ratio.
+ * @param outFrame Output result image, will keep aspect ratio. Release it with
+ * CVI_TDL_Service_DigitalZoom_ReleaseFrame, which is required when the config is async.
  * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
  */
 DLL_EXPORT CVI_S32 CVI_TDL_Service_ObjectDigitalZoomExt(
@@ -187,6 +190,39 @@ DLL_EXPORT CVI_S32 CVI_TDL_Service_ObjectDigitalZoomExt(
     const float pad_ratio_right, const float pad_ratio_top, const float pad_ratio_bottom,
     VIDEO_FRAME_INFO_S *outFrame);
 
+/**
+ * @brief Get the default virtual camera config of the digital zoom, the lerp of trans_ratio.
+ * @ingroup core_cvitdlservice
+ *
+ * @param config Output config.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_DigitalZoom_GetDefaultConfig(cvtdl_service_dt_config_t *config);
+
+/**
+ * @brief Set the virtual camera config used by the digital zoom functions.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @param config The config, trans_ratio of the zoom functions is unused when predictive is set.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_DigitalZoom_SetConfig(cvitdl_service_handle_t handle,
+                                                         const cvtdl_service_dt_config_t *config);
+
+/**
+ * @brief Release the output frame of a digital zoom function to the VPSS group it came from. A
+ * sync output frame may also be released to the VPSS group of the handle directly, an async one
+ * must be released here.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @param frame The outFrame of the zoom function.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_DigitalZoom_ReleaseFrame(cvitdl_service_handle_t handle,
+                                                            VIDEO_FRAME_INFO_S *frame);
+
 /**
  * @brief Draw rect to frame with given face meta with a global brush.
  * @ingroup core_cvitdlservice
@@ -299,6 +335,132 @@ DLL_EXPORT CVI_S32 CVI_TDL_Service_ObjectWriteText(char *name, int x, int y,
                                                    VIDEO_FRAME_INFO_S *frame, float r, float g,
                                                    float b);
 
+/**
+ * @brief Drop all primitives queued in the overlay command list.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Overlay_Clear(cvitdl_service_handle_t handle);
+
+/**
+ * @brief Queue a rectangle in frame coordinate to the overlay command list.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @param bbox Rectangle to draw.
+ * @param brush A brush for drawing, brush.size is the line thickness, at least 2 and rounded up to
+ * even as in CVI_TDL_Service_ObjectDrawRect.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed, CVI_TDL_ERR_INVALID_ARGS if bbox is NULL.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Overlay_AddRect(cvitdl_service_handle_t handle,
+                                                   const cvtdl_bbox_t *bbox,
+                                                   cvtdl_service_brush_t brush);
+
+/**
+ * @brief Queue the bounding boxes (and names) of a face meta to the overlay command list.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @param meta meta structure. Boxes are rescaled to the frame size at render time.
+ * @param drawText Choose to draw name of the face.
+ * @param brush A brush for drawing, brush.size is the box thickness as in
+ * CVI_TDL_Service_Overlay_AddRect.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed, CVI_TDL_ERR_INVALID_ARGS if meta is NULL.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Overlay_AddFaceMeta(cvitdl_service_handle_t handle,
+                                                       const cvtdl_face_t *meta,
+                                                       const bool drawText,
+                                                       cvtdl_service_brush_t brush);
+
+/**
+ * @brief Queue the bounding boxes (and names) of an object meta to the overlay command list.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @param meta meta structure. Boxes are rescaled to the frame size at render time.
+ * @param drawText Choose to draw name of the object.
+ * @param brush A brush for drawing, brush.size is the box thickness as in
+ * CVI_TDL_Service_Overlay_AddRect.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed, CVI_TDL_ERR_INVALID_ARGS if meta is NULL.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Overlay_AddObjectMeta(cvitdl_service_handle_t handle,
+                                                         const cvtdl_object_t *meta,
+                                                         const bool drawText,
+                                                         cvtdl_service_brush_t brush);
+
+/**
+ * @brief Queue a polyline to the overlay command list.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @param pts Vertices of the polyline.
+ * @param closed Connect the last vertex to the first one.
+ * @param brush A brush for drawing, brush.size is the line thickness.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed, CVI_TDL_ERR_INVALID_ARGS if pts is NULL.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Overlay_AddPolyline(cvitdl_service_handle_t handle,
+                                                       const cvtdl_pts_t *pts, const bool closed,
+                                                       cvtdl_service_brush_t brush);
+
+/**
+ * @brief Queue filled points to the overlay command list.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @param pts Points to draw.
+ * @param radius Radius of each point in pixels.
+ * @param brush A brush for drawing.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed, CVI_TDL_ERR_INVALID_ARGS if pts is NULL.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Overlay_AddPoints(cvitdl_service_handle_t handle,
+                                                     const cvtdl_pts_t *pts, const uint32_t radius,
+                                                     cvtdl_service_brush_t brush);
+
+/**
+ * @brief Queue a text to the overlay command list. Text is drawn with a built-in ASCII bitmap
+ * font, so it is also available in NO_OPENCV builds.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @param text text content.
+ * @param x the x coordinate of content.
+ * @param y the y coordinate of the text baseline.
+ * @param brush A brush for drawing, brush.size is the glyph scale (6x8 pixels per glyph).
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed, CVI_TDL_ERR_INVALID_ARGS if text is NULL.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Overlay_AddText(cvitdl_service_handle_t handle,
+                                                   const char *text, int x, int y,
+                                                   cvtdl_service_brush_t brush);
+
+/**
+ * @brief Queue the 17 keypoints skeletons of an object meta to the overlay command list.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @param meta meta structure with pedestrian_properity.
+ * @param score_threshold Keypoints with lower score are skipped. Default is 0.35.
+ * @param brush A brush for drawing.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed, CVI_TDL_ERR_INVALID_ARGS if meta is NULL.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Overlay_AddPose17(cvitdl_service_handle_t handle,
+                                                     const cvtdl_object_t *meta,
+                                                     const float score_threshold,
+                                                     cvtdl_service_brush_t brush);
+
+/**
+ * @brief Draw all queued primitives to frame. The frame is mapped and flushed only once. The
+ * command list is kept, call CVI_TDL_Service_Overlay_Clear before queuing the next frame.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @param frame In/out YUV frame. (NV21, NV12 or YUV420 planar)
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed, CVI_TDL_ERR_INVALID_ARGS if frame is NULL.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Overlay_Render(cvitdl_service_handle_t handle,
+                                                  VIDEO_FRAME_INFO_S *frame);
+
 /**
  * @brief Set target convex polygon for detection.
  * @ingroup core_cvitdlservice
@@ -343,6 +505,103 @@ DLL_EXPORT CVI_S32 CVI_TDL_Service_Polygon_CleanAll(cvitdl_service_handle_t hand
 DLL_EXPORT CVI_S32 CVI_TDL_Service_Polygon_Intersect(cvitdl_service_handle_t handle,
                                                      const cvtdl_bbox_t *bbox, bool *has_intersect);
 
+/**
+ * @brief Check all objects against all target polygons at once.
+ * @ingroup core_cvitdlservice
+ *
+ * Bit k of region_masks[i] is set if obj->info[i].bbox intersects the polygon set by the k-th
+ * call of CVI_TDL_Service_Polygon_SetTarget. With more than 64 polygons this returns
+ * CVI_TDL_ERR_INVALID_ARGS, test the boxes with CVI_TDL_Service_Polygon_Intersect instead.
+ *
+ * @param handle A service handle.
+ * @param obj Object meta structure.
+ * @param region_masks Output array with obj->size elements.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Polygon_IntersectObjects(cvitdl_service_handle_t handle,
+                                                            const cvtdl_object_t *obj,
+                                                            uint64_t *region_masks);
+
+/**
+ * @brief Set the capacity of the trajectory store. Drops the registered trajectories.
+ * @ingroup core_cvitdlservice
+ *
+ * Without this call the store keeps 256 ids with 64 positions each.
+ *
+ * @param handle A service handle.
+ * @param max_ids Max number of ids, the id registered least recently makes room for a new one.
+ * @param history_len Number of positions kept per id.
+ * @param delete_duration_ms An id not registered for this long is dropped.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Trajectory_Init(cvitdl_service_handle_t handle,
+                                                   uint32_t max_ids, uint32_t history_len,
+                                                   uint64_t delete_duration_ms);
+
+/**
+ * @brief Add the bbox center of every object to the trajectory of its unique_id.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @param timestamp_ms Time of the frame in milliseconds.
+ * @param obj Tracked objects.
+ * @return CVI_S32 Return CVI_TDL_SUCCESS if succeed.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Trajectory_Register(cvitdl_service_handle_t handle,
+                                                       uint64_t timestamp_ms,
+                                                       const cvtdl_object_t *obj);
+
+/**
+ * @brief Get the positions of an id over the last duration_ms before the latest registration.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @param id The unique_id of the object.
+ * @param duration_ms Length of the window.
+ * @param x Output x of at most max_num positions, oldest first.
+ * @param y Output y of the positions.
+ * @param timestamps_ms Output timestamps of the positions, can be NULL.
+ * @param max_num Size of the output arrays.
+ * @param num Number of positions written.
+ * @return CVI_S32 Return CVI_TDL_FAILURE if the id is not registered.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Trajectory_GetPositions(cvitdl_service_handle_t handle,
+                                                           uint64_t id, uint64_t duration_ms,
+                                                           float *x, float *y,
+                                                           uint64_t *timestamps_ms,
+                                                           uint32_t max_num, uint32_t *num);
+
+/**
+ * @brief Get the velocity of an id, the displacement per second between the oldest and the
+ * latest position of the last duration_ms.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @param id The unique_id of the object.
+ * @param duration_ms Length of the window.
+ * @param vx Output velocity along x.
+ * @param vy Output velocity along y.
+ * @return CVI_S32 Return CVI_TDL_FAILURE if the window has no two positions at different times.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Trajectory_GetVelocity(cvitdl_service_handle_t handle,
+                                                          uint64_t id, uint64_t duration_ms,
+                                                          float *vx, float *vy);
+
+/**
+ * @brief Get the heading of an id, atan2(dy, dx) in radians of the displacement over the last
+ * duration_ms.
+ * @ingroup core_cvitdlservice
+ *
+ * @param handle A service handle.
+ * @param id The unique_id of the object.
+ * @param duration_ms Length of the window.
+ * @param heading Output heading.
+ * @return CVI_S32 Return CVI_TDL_FAILURE if the window has no two positions at different times.
+ */
+DLL_EXPORT CVI_S32 CVI_TDL_Service_Trajectory_GetHeading(cvitdl_service_handle_t handle,
+                                                         uint64_t id, uint64_t duration_ms,
+                                                         float *heading);
+
 /**
  * @brief Calculate the head pose angle.
  * @ingroup core_cvitdlservice
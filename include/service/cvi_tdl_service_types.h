@@ -66,4 +66,36 @@ typedef struct {
   uint32_t size;
 } cvtdl_service_brush_t;
 
+/** @struct cvtdl_service_dt_config_t
+ *  @ingroup core_cvitdlservice
+ *  @brief Virtual camera of the digital zoom.
+ *
+ * @var cvtdl_service_dt_config_t::predictive
+ * Drive the crop with a critically damped spring towards the predicted group box. When false the
+ * crop follows the group box with the trans_ratio lerp of the zoom functions.
+ * @var cvtdl_service_dt_config_t::smooth_time
+ * Seconds the spring takes to cover about 90% of the way to the target.
+ * @var cvtdl_service_dt_config_t::predict_time
+ * Seconds the group box is extrapolated along its estimated velocity.
+ * @var cvtdl_service_dt_config_t::dead_zone
+ * The camera starts following when the target moves or resizes by this ratio of the crop.
+ * @var cvtdl_service_dt_config_t::settle_zone
+ * The camera stops following once it is within this ratio of the target, below dead_zone.
+ * @var cvtdl_service_dt_config_t::frame_interval
+ * Seconds between two calls, used when the frames carry no increasing PTS.
+ * @var cvtdl_service_dt_config_t::async
+ * Return the crop of the previous call and let VPSS crop the current frame in the background,
+ * on a VPSS group of its own. The first call returns the crop of its own frame. The output
+ * frames must be released with CVI_TDL_Service_DigitalZoom_ReleaseFrame.
+ */
+typedef struct {
+  bool predictive;
+  float smooth_time;
+  float predict_time;
+  float dead_zone;
+  float settle_zone;
+  float frame_interval;
+  bool async;
+} cvtdl_service_dt_config_t;
+
 #endif  // End of _CVI_TDL_SERVICE_TYPES_H_
\ No newline at end of file
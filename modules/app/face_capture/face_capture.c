@@ -253,8 +253,10 @@ CVI_S32 _FaceCapture_Run(face_capture_t *face_cpt_info, const cvitdl_handle_t td
     return CVI_TDL_FAILURE;
   }
 
+  uint64_t trace_begin = CVI_TDL_Trace_Begin();
   ret = update_data(tdl_handle, face_cpt_info, frame, &face_cpt_info->last_faces,
                     &face_cpt_info->last_trackers, true);
+  CVI_TDL_Trace_End("update_data", "face_capture", trace_begin);
   if (ret != CVI_TDL_SUCCESS) {
     LOGE("[APP::FaceCapture] update face failed.\n");
     return CVI_TDL_FAILURE;
@@ -275,8 +275,10 @@ CVI_S32 _FacePetCapture_Run(face_capture_t *face_cpt_info, const cvitdl_handle_t
     return CVI_TDL_FAILURE;
   }
 
+  uint64_t trace_begin = CVI_TDL_Trace_Begin();
   ret = update_data(tdl_handle, face_cpt_info, frame, &face_cpt_info->last_faces,
                     &face_cpt_info->last_trackers, false);
+  CVI_TDL_Trace_End("update_data", "face_pet_capture", trace_begin);
   if (ret != CVI_TDL_SUCCESS) {
     LOGE("[APP::FacePetCapture] update face failed.\n");
     return CVI_TDL_FAILURE;
@@ -312,8 +312,10 @@ CVI_S32 _PersonCapture_Run(person_capture_t *person_cpt_info, const cvitdl_handl
   }
 #endif
 
+  uint64_t trace_begin = CVI_TDL_Trace_Begin();
   ret = update_data(person_cpt_info, &person_cpt_info->last_objects,
                     &person_cpt_info->last_trackers, person_cpt_info->last_quality);
+  CVI_TDL_Trace_End("update_data", "person_capture", trace_begin);
   if (ret != CVI_TDL_SUCCESS) {
     printf("[APP::PersonCapture] update data failed.\n");
     return CVI_TDL_FAILURE;
@@ -0,0 +1,112 @@
+#include "adas_track.h"
+
+#include <math.h>
+
+// longitudinal filter of [dis, speed] per track
+#define KF_ACCEL_NOISE 2.0f     // m/s^2, relative acceleration
+#define KF_BOX_NOISE 2.0f       // pixels, noise of the bbox height
+#define KF_INIT_SPEED_STD 3.0f  // m/s
+#define TTC_MIN_UPDATES 3
+
+static uint32_t index_home(const adas_info_t *adas_info, uint64_t uid) {
+  return (uint32_t)((uid * 0x9E3779B97F4A7C15ull) >> 32) & adas_info->data_index_mask;
+}
+
+int adas_index_find(const adas_info_t *adas_info, uint64_t uid) {
+  for (uint32_t s = index_home(adas_info, uid); adas_info->data_index[s] >= 0;
+       s = (s + 1) & adas_info->data_index_mask) {
+    if (adas_info->data[adas_info->data_index[s]].info.unique_id == uid) {
+      return adas_info->data_index[s];
+    }
+  }
+  return -1;
+}
+
+void adas_index_insert(adas_info_t *adas_info, int data_index) {
+  uint32_t s = index_home(adas_info, adas_info->data[data_index].info.unique_id);
+  while (adas_info->data_index[s] >= 0) s = (s + 1) & adas_info->data_index_mask;
+  adas_info->data_index[s] = data_index;
+}
+
+void adas_index_erase(adas_info_t *adas_info, int data_index) {
+  uint32_t mask = adas_info->data_index_mask;
+  uint32_t s = index_home(adas_info, adas_info->data[data_index].info.unique_id);
+  while (adas_info->data_index[s] != data_index) {
+    if (adas_info->data_index[s] < 0) return;
+    s = (s + 1) & mask;
+  }
+  adas_info->data_index[s] = -1;
+  // move back the following entries that can no longer be reached
+  for (uint32_t next = (s + 1) & mask; adas_info->data_index[next] >= 0; next = (next + 1) & mask) {
+    uint32_t h = index_home(adas_info, adas_info->data[adas_info->data_index[next]].info.unique_id);
+    bool keep = s <= next ? (s < h && h <= next) : (s < h || h <= next);
+    if (keep) continue;
+    adas_info->data_index[s] = adas_info->data_index[next];
+    adas_info->data_index[next] = -1;
+    s = next;
+  }
+}
+
+// the monocular distance gets worse with the distance
+static float dis_variance(float dis) {
+  float std = 0.1f * dis + 0.3f;
+  return std * std;
+}
+
+/* measurement update of the state selected by h, 0 for dis and 1 for speed */
+static void kf_update(adas_data_t *data, int h, float z, float r) {
+  float *p = data->kf_p;
+  float ph0 = h == 0 ? p[0] : p[1];
+  float ph1 = h == 0 ? p[1] : p[2];
+  float s = (h == 0 ? p[0] : p[2]) + r;
+  float k0 = ph0 / s;
+  float k1 = ph1 / s;
+  float y = z - (h == 0 ? data->dis : data->speed);
+  data->dis += k0 * y;
+  data->speed += k1 * y;
+  p[0] -= k0 * ph0;
+  p[1] -= k0 * ph1;
+  p[2] -= k1 * ph1;
+}
+
+void adas_kf_init(adas_data_t *data, float dis, float box_height) {
+  data->dis = dis;
+  data->speed = 0;
+  data->kf_p[0] = dis_variance(dis);
+  data->kf_p[1] = 0;
+  data->kf_p[2] = KF_INIT_SPEED_STD * KF_INIT_SPEED_STD;
+  data->kf_updates = 1;
+  data->last_height = box_height;
+}
+
+void adas_kf_update(adas_data_t *data, float dis, float box_height, float dt) {
+  // constant speed over the frames since the last update
+  float q = KF_ACCEL_NOISE * KF_ACCEL_NOISE;
+  float *p = data->kf_p;
+  data->dis += data->speed * dt;
+  p[0] += 2 * dt * p[1] + dt * dt * p[2] + q * dt * dt * dt * dt / 4;
+  p[1] += dt * p[2] + q * dt * dt * dt / 2;
+  p[2] += q * dt * dt;
+
+  kf_update(data, 0, dis, dis_variance(dis));
+  // dis is proportional to 1 / box_height, so the scale change gives the speed
+  float mean_height = 0.5f * (box_height + data->last_height);
+  if (data->last_height > 0 && mean_height > 0) {
+    float speed = -data->dis * (box_height - data->last_height) / (mean_height * dt);
+    float speed_std = data->dis * 1.4142f * KF_BOX_NOISE / (mean_height * dt);
+    kf_update(data, 1, speed, speed_std * speed_std);
+  }
+  if (data->dis < 0) data->dis = 0;
+  data->kf_updates++;
+  data->last_height = box_height;
+}
+
+void adas_update_ttc(adas_data_t *data) {
+  data->ttc = -1;
+  data->ttc_confidence = 0;
+  if (data->kf_updates >= TTC_MIN_UPDATES && data->speed < -0.05f) {
+    data->ttc = data->dis / -data->speed;
+    float confidence = 1.0f - sqrtf(data->kf_p[2]) / -data->speed;
+    data->ttc_confidence = confidence > 0 ? confidence : 0;
+  }
+}
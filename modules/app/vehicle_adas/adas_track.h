@@ -0,0 +1,28 @@
+#ifndef _CVI_TDL_APP_ADAS_TRACK_H_
+#define _CVI_TDL_APP_ADAS_TRACK_H_
+
+#include "cvi_tdl_app/capture/adas_capture_type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* slot of unique_id in adas_info->data, -1 when the id has none */
+int adas_index_find(const adas_info_t *adas_info, uint64_t uid);
+/* index adas_info->data[data_index] by its unique_id */
+void adas_index_insert(adas_info_t *adas_info, int data_index);
+/* remove adas_info->data[data_index] from the index, before its unique_id changes */
+void adas_index_erase(adas_info_t *adas_info, int data_index);
+
+/* start the [dis, speed] filter of a new track, box_height in pixels */
+void adas_kf_init(adas_data_t *data, float dis, float box_height);
+/* predict over dt seconds and update with the distance and the bbox height of this frame */
+void adas_kf_update(adas_data_t *data, float dis, float box_height, float dt);
+/* ttc and ttc_confidence of the filter, ttc is -1 while the object does not close in */
+void adas_update_ttc(adas_data_t *data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // End of _CVI_TDL_APP_ADAS_TRACK_H_
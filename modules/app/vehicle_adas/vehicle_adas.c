@@ -1,4 +1,5 @@
 #include "vehicle_adas.h"
+#include "adas_track.h"
 
 #include <math.h>
 #include <sys/time.h>
@@ -51,6 +52,12 @@ CVI_S32 _ADAS_Init(adas_info_t **adas_info, uint32_t buffer_size, int det_type)
   new_adas_info->data = (adas_data_t *)malloc(sizeof(adas_data_t) * buffer_size);
   memset(new_adas_info->data, 0, sizeof(adas_data_t) * buffer_size);
 
+  uint32_t index_size = 1;
+  while (index_size < 2 * buffer_size) index_size <<= 1;
+  new_adas_info->data_index = (int32_t *)malloc(sizeof(int32_t) * index_size);
+  memset(new_adas_info->data_index, 0xff, sizeof(int32_t) * index_size);
+  new_adas_info->data_index_mask = index_size - 1;
+
   *adas_info = new_adas_info;
 
   return CVI_SUCCESS;
@@ -69,6 +76,7 @@ CVI_S32 _ADAS_Free(adas_info_t *adas_info) {
     }
 
     free(adas_info->data);
+    free(adas_info->data_index);
     CVI_TDL_Free(&adas_info->last_objects);
     CVI_TDL_Free(&adas_info->last_trackers);
     CVI_TDL_Free(&adas_info->lane_meta);
@@ -207,31 +215,21 @@ void update_dis(cvtdl_object_info_t *info, adas_info_t *adas_info, int obj_index
     cur_dis = 0.5;
   }
 
-  if (!first_time) {
-    cur_dis = 0.9 * data->dis + 0.1 * cur_dis;
+  float box_height = info->bbox.y2 - info->bbox.y1;
+  if (first_time) {
+    adas_kf_init(data, cur_dis, box_height);
   } else {
-    data->dis_tmp = cur_dis;
+    adas_kf_update(data, cur_dis, box_height, (float)(data->miss_counter + 1) / adas_info->FPS);
   }
 
-  data->dis = cur_dis;
-  info->adas_properity.dis = cur_dis;
+  info->adas_properity.dis = data->dis;
 }
 
-void update_apeed(cvtdl_object_info_t *info, adas_data_t *data, float fps) {
+void update_ttc(cvtdl_object_info_t *info, adas_data_t *data) {
+  adas_update_ttc(data);
   info->adas_properity.speed = data->speed;
-
-  if (data->counter >= 3) {
-    float cur_speed = (data->dis - data->dis_tmp) / ((float)(data->counter - 1) / fps);
-
-    data->speed = cur_speed;
-
-    // printf(" data->dis  %.2f   data->dis_tmp   %.2f  cur_speed: %.2f\n", data->dis,
-    // data->dis_tmp, cur_speed); data->speed = cur_speed;
-    info->adas_properity.speed = cur_speed;
-
-    data->dis_tmp = data->dis;
-    data->counter = 0;
-  }
+  info->ttc = data->ttc;
+  info->ttc_confidence = data->ttc_confidence;
 }
 
 void update_object_state(cvtdl_object_info_t *info, adas_data_t *data, adas_info_t *adas_info,
@@ -257,8 +255,8 @@ void update_object_state(cvtdl_object_info_t *info, adas_data_t *data, adas_info
 
   bool center = center_info[0] == obj_index;
 
-  if (center && info->adas_properity.dis < 8.0 &&
-      -(data->speed) * (float)adas_info->collison_time > info->adas_properity.dis) {
+  if (center && info->adas_properity.dis < 8.0 && data->ttc >= 0 &&
+      data->ttc < adas_info->collison_time) {
     cur_warning_score = 1.0f;
   }
   data->warning_score = 0.9 * data->warning_score + 0.1 * cur_warning_score;
@@ -329,6 +327,7 @@ static CVI_S32 clean_data(adas_info_t *adas_info) {
   for (uint32_t j = 0; j < adas_info->size; j++) {
     if (adas_info->data[j].t_state == MISS) {
       LOGI("[APP::VehicleAdas] Clean Vehicle Info[%u]\n", j);
+      adas_index_erase(adas_info, (int)j);
       CVI_TDL_Free(&adas_info->data[j].info);
       adas_info->data[j].info.unique_id = 0;
 
@@ -336,7 +335,9 @@ static CVI_S32 clean_data(adas_info_t *adas_info) {
       adas_info->data[j].counter = 0;
       adas_info->data[j].miss_counter = 0;
       adas_info->data[j].dis = 0;
-      adas_info->data[j].dis_tmp = 0;
+      adas_info->data[j].speed = 0;
+      adas_info->data[j].last_height = 0;
+      adas_info->data[j].kf_updates = 0;
       adas_info->data[j].start_score = 0;
       adas_info->data[j].warning_score = 0;
     }
@@ -458,6 +459,7 @@ static CVI_S32 update_data(adas_info_t *adas_info, VIDEO_FRAME_INFO_S *frame,
   update_unique_id_with_classes(obj_meta);
   front_obj_index(obj_meta, &adas_info->lane_meta, adas_info, frame->stVFrame.u32Width);
 
+  adas_info->frame_counter++;
   for (uint32_t i = 0; i < obj_meta->size; i++) {
     uint64_t trk_id = obj_meta->info[i].unique_id;
     int match_idx = -1;
@@ -465,17 +467,12 @@ static CVI_S32 update_data(adas_info_t *adas_info, VIDEO_FRAME_INFO_S *frame,
     int update_idx = -1;
     //  printf("obj_meta->size: %d\n", adas_info->size);
 
-    for (uint32_t j = 0; j < adas_info->size; j++) {
-      if (adas_info->data[j].t_state == ALIVE && adas_info->data[j].info.unique_id == trk_id) {
-        match_idx = (int)j;
-        break;
-      }
-    }
+    match_idx = adas_index_find(adas_info, trk_id);
 
     if (match_idx != -1) {
-      adas_info->data[match_idx].miss_counter = 0;
       update_dis(&obj_meta->info[i], adas_info, i, match_idx, frame->stVFrame.u32Height,
                  frame->stVFrame.u32Width, false);
+      adas_info->data[match_idx].miss_counter = 0;
 
       update_idx = match_idx;
     } else {
@@ -495,26 +492,24 @@ static CVI_S32 update_data(adas_info_t *adas_info, VIDEO_FRAME_INFO_S *frame,
       continue;
     }
 
-    memcpy(&adas_info->data[update_idx].info, &obj_meta->info[i], sizeof(cvtdl_object_info_t));
-    adas_info->data[update_idx].t_state = ALIVE;
-
-    adas_info->data[update_idx].counter += 1;
-
+    update_ttc(&obj_meta->info[i], &adas_info->data[update_idx]);
     if (match_idx != -1) {
-      update_apeed(&obj_meta->info[i], &adas_info->data[match_idx], adas_info->FPS);
       update_object_state(&obj_meta->info[i], &adas_info->data[match_idx], adas_info,
                           obj_meta->width, i, adas_info->is_static);
     }
+
+    memcpy(&adas_info->data[update_idx].info, &obj_meta->info[i], sizeof(cvtdl_object_info_t));
+    if (match_idx == -1) {
+      adas_index_insert(adas_info, update_idx);
+    }
+    adas_info->data[update_idx].t_state = ALIVE;
+    adas_info->data[update_idx].seen_frame = adas_info->frame_counter;
+
+    adas_info->data[update_idx].counter += 1;
   }
 
   for (uint32_t j = 0; j < adas_info->size; j++) {
-    bool found = false;
-    for (uint32_t k = 0; k < obj_meta->size; k++) {
-      if (adas_info->data[j].info.unique_id == obj_meta->info[k].unique_id) {
-        found = true;
-        break;
-      }
-    }
+    bool found = adas_info->data[j].seen_frame == adas_info->frame_counter;
 
     if (!found && adas_info->data[j].info.unique_id != 0) {
       adas_info->data[j].miss_counter += 1;
@@ -586,7 +581,9 @@ CVI_S32 _ADAS_Run(adas_info_t *adas_info, const cvitdl_handle_t tdl_handle,
     update_frame_state(adas_info);
   }
 
+  uint64_t trace_begin = CVI_TDL_Trace_Begin();
   ret = update_data(adas_info, frame, &adas_info->last_objects, &adas_info->last_trackers);
+  CVI_TDL_Trace_End("update_data", "adas", trace_begin);
   if (ret != CVI_TDL_SUCCESS) {
     LOGE("[APP::ADAS] update data failed.\n");
     return CVI_TDL_FAILURE;
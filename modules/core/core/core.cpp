@@ -6,6 +6,13 @@
 
 namespace cvitdl {
 
+namespace {
+// end of the last forward of this thread, the output parser runs right after it on the same
+// thread while other threads may run the same instance
+thread_local const Core *t_forward_model = nullptr;
+thread_local uint64_t t_forward_end = 0;
+}  // namespace
+
 Core::Core(CVI_MEM_TYPE_E input_mem_type) {
 #ifndef CONFIG_ALIOS
   mp_mi = std::make_unique<CvimodelInfo>();
@@ -29,6 +36,11 @@ Core::Core(CVI_MEM_TYPE_E input_mem_type) {
 
 Core::Core() : Core(CVI_MEM_SYSTEM) {}
 
+Core::~Core() {
+  // other instances may keep the shared weights, which must not keep this account
+  if (mp_shared_model) mp_shared_model->weights().removeHolder(&m_mem_account);
+}
+
 #define CLOSE_MODEL_IF_FAILED(x, errmsg) \
   do {                                   \
     if ((x) != CVI_TDL_SUCCESS) {        \
@@ -64,8 +76,10 @@ int Core::modelOpen(const char *filepath) {
     return CVI_TDL_FAILURE;
   }
   m_model_file = filepath;
-  CLOSE_MODEL_IF_TPU_FAILED(CVI_NN_RegisterModel(filepath, &mp_mi->handle),
-                            "CVI_NN_RegisterModel failed");
+  double t0 = trace::now_us() / 1000.;
+  bool loaded = false;
+  CLOSE_MODEL_IF_FAILED(ModelRegistry::open(filepath, &mp_shared_model, &mp_mi->handle, &loaded),
+                        "failed to register the model");
 
   CVI_NN_SetConfig(mp_mi->handle, OPTION_OUTPUT_ALL_TENSORS,
                    static_cast<int>(mp_mi->conf.debug_mode));
@@ -77,6 +91,8 @@ int Core::modelOpen(const char *filepath) {
 
   setupTensorInfo(mp_mi->in.tensors, mp_mi->in.num, &m_input_tensor_info);
   setupTensorInfo(mp_mi->out.tensors, mp_mi->out.num, &m_output_tensor_info);
+  chargeModelMemory(0);
+  mp_shared_model->weights().addHolder(&m_mem_account);
 
   CVI_TENSOR *input =
       CVI_NN_GetTensorByName(CVI_NN_DEFAULT_TENSOR, mp_mi->in.tensors, mp_mi->in.num);
@@ -104,6 +120,8 @@ int Core::modelOpen(const char *filepath) {
   }
 
   CLOSE_MODEL_IF_FAILED(onModelOpened(), "return failed in onModelOpened");
+  m_open_ms = trace::now_us() / 1000. - t0;
+  m_shared_open = !loaded;
 
   m_vpss_config.clear();
   for (uint32_t i = 0; i < (uint32_t)mp_mi->in.num; i++) {
@@ -161,6 +179,7 @@ int Core::modelOpen(const int8_t *buf, uint32_t size) {
     return CVI_TDL_FAILURE;
   }
 
+  double t0 = trace::now_us() / 1000.;
   CLOSE_MODEL_IF_TPU_FAILED(CVI_NN_RegisterModelFromBuffer(buf, size, &mp_mi->handle),
                             "CVI_NN_RegisterModelFromBuffer failed");
 
@@ -174,6 +193,7 @@ int Core::modelOpen(const int8_t *buf, uint32_t size) {
 
   setupTensorInfo(mp_mi->in.tensors, mp_mi->in.num, &m_input_tensor_info);
   setupTensorInfo(mp_mi->out.tensors, mp_mi->out.num, &m_output_tensor_info);
+  chargeModelMemory(size);
 
   CVI_TENSOR *input =
       CVI_NN_GetTensorByName(CVI_NN_DEFAULT_TENSOR, mp_mi->in.tensors, mp_mi->in.num);
@@ -201,6 +221,8 @@ int Core::modelOpen(const int8_t *buf, uint32_t size) {
   }
 
   CLOSE_MODEL_IF_FAILED(onModelOpened(), "return failed in onModelOpened");
+  m_open_ms = trace::now_us() / 1000. - t0;
+  m_shared_open = false;
 
   m_vpss_config.clear();
   for (uint32_t i = 0; i < (uint32_t)mp_mi->in.num; i++) {
@@ -264,19 +286,38 @@ void Core::setupTensorInfo(CVI_TENSOR *tensor, int32_t num_tensors,
   }
 }
 
+// The runtime does not report its ION usage, the weights and the I/O tensors are the estimate
+void Core::chargeModelMemory(uint64_t model_bytes) {
+  uint64_t bytes = model_bytes;
+  for (int32_t i = 0; i < mp_mi->in.num; i++) {
+    bytes += CVI_NN_TensorSize(mp_mi->in.tensors + i);
+  }
+  for (int32_t i = 0; i < mp_mi->out.num; i++) {
+    bytes += CVI_NN_TensorSize(mp_mi->out.tensors + i);
+  }
+  m_mem_account.alloc(CVI_TDL_MEM_ION, bytes);
+  m_model_ion_bytes = bytes;
+}
+
 int Core::modelClose() {
   int ret = CVI_TDL_SUCCESS;
+  stopCapture();
+  m_mem_account.release(CVI_TDL_MEM_ION, m_model_ion_bytes);
+  m_model_ion_bytes = 0;
+  if (mp_shared_model) mp_shared_model->weights().removeHolder(&m_mem_account);
 
   if (mp_mi->handle != nullptr) {
     ret = CVI_NN_CleanupModel(mp_mi->handle);
     if (ret != CVI_RC_SUCCESS) {  // NOLINT
       LOGE("CVI_NN_CleanupModel failed: %s\n", get_tpu_error_msg(ret));
       mp_mi->handle = nullptr;
+      mp_shared_model.reset();
       onModelClosed();
       return CVI_TDL_ERR_CLOSE_MODEL;
     }
     mp_mi->handle = nullptr;
   }
+  mp_shared_model.reset();
   onModelClosed();
   return ret;
 }
@@ -498,6 +539,13 @@ int Core::run(std::vector<VIDEO_FRAME_INFO_S *> &frames) {
     return CVI_TDL_ERR_INVALID_ARGS;
   }
   model_timer_.TicToc("runstart");
+  uint64_t trace_begin = trace::enabled() ? trace::now_us() : 0;
+  if (mp_replay) {
+    ret = replayOutputs();
+    model_timer_.TicToc("vpss");
+    model_timer_.TicToc("tpu");
+    return ret;
+  }
   std::vector<std::shared_ptr<VIDEO_FRAME_INFO_S>> dstFrames;
 
   if (aligned_input && frames.size() != 1) {
@@ -528,17 +576,26 @@ int Core::run(std::vector<VIDEO_FRAME_INFO_S *> &frames) {
           delete f;
           return vpssret;
         } else {
-          dstFrames.push_back(
-              std::shared_ptr<VIDEO_FRAME_INFO_S>({f, [this](VIDEO_FRAME_INFO_S *f) {
-                                                     this->mp_vpss_inst->releaseFrame(f, 0);
-                                                     delete f;
-                                                   }}));
+          uint64_t vb_bytes = 0;
+          for (int k = 0; k < 3; k++) {
+            vb_bytes += f->stVFrame.u32Length[k];
+          }
+          m_mem_account.alloc(CVI_TDL_MEM_VB, vb_bytes);
+          m_mem_account.alloc(CVI_TDL_MEM_HEAP, sizeof(VIDEO_FRAME_INFO_S));
+          dstFrames.push_back(std::shared_ptr<VIDEO_FRAME_INFO_S>(
+              {f, [this, vb_bytes](VIDEO_FRAME_INFO_S *f) {
+                 this->mp_vpss_inst->releaseFrame(f, 0);
+                 delete f;
+                 m_mem_account.release(CVI_TDL_MEM_VB, vb_bytes);
+                 m_mem_account.release(CVI_TDL_MEM_HEAP, sizeof(VIDEO_FRAME_INFO_S));
+               }}));
         }
       }
       ret = registerFrame2Tensor(dstFrames);
     }
   }
   model_timer_.TicToc("vpss");
+  traceStage("vpss", &trace_begin);
   if (ret == CVI_TDL_SUCCESS) {
     int rcret = CVI_NN_Forward(mp_mi->handle, mp_mi->in.tensors, mp_mi->in.num, mp_mi->out.tensors,
                                mp_mi->out.num);
@@ -550,15 +607,113 @@ int Core::run(std::vector<VIDEO_FRAME_INFO_S *> &frames) {
         if (!m_skip_vpss_preprocess && mp_mi->conf.input_mem_type == CVI_MEM_DEVICE) {
         }
       }
+      for (int32_t i = 0; mp_capture && i < mp_mi->out.num; i++) {
+        CVI_TENSOR *tensor = mp_mi->out.tensors + i;
+        mp_capture->writeTensor(CVI_NN_TensorName(tensor), CVI_NN_TensorPtr(tensor),
+                                CVI_NN_TensorSize(tensor));
+      }
     } else {
       LOGE("NN forward failed: %s\n", get_tpu_error_msg(rcret));
       ret = CVI_TDL_ERR_INFERENCE;
     }
   }
   model_timer_.TicToc("tpu");
+  traceStage("forward", &trace_begin);
+  t_forward_model = this;
+  t_forward_end = trace_begin;
+  return ret;
+}
+
+void Core::traceStage(const char *stage, uint64_t *begin) {
+  if (*begin == 0) return;
+  uint64_t end = trace::now_us();
+  trace::record(stage, mp_model_name, *begin, end);
+  *begin = end;
+}
+
+void Core::traceOutputParser() {
+  if (t_forward_model != this) return;
+  t_forward_model = nullptr;
+  traceStage("output_parser", &t_forward_end);
+}
+
+int Core::getLoadInfo(cvtdl_model_load_info_t *info) const {
+  if (mp_mi->handle == nullptr) {
+    return CVI_TDL_ERR_NOT_YET_INITIALIZED;
+  }
+  info->open_ms = m_open_ms;
+  info->shared = m_shared_open;
+  info->instances = mp_shared_model ? mp_shared_model.use_count() : 1;
+  info->file_bytes = mp_shared_model ? mp_shared_model->fileBytes() : 0;
+  info->resident_bytes = mp_shared_model ? mp_shared_model->residentBytes() : 0;
+  return CVI_TDL_SUCCESS;
+}
+
+void Core::setModelName(const char *name) {
+  mp_model_name = name;
+  m_mem_account.setName(name);
+}
+
+int Core::replayOutputs() {
+  CaptureRecord record;
+  for (int32_t i = 0; i < mp_mi->out.num; i++) {
+    if (mp_replay->readNext(CAPTURE_RECORD_TENSOR, &record) != CVI_TDL_SUCCESS) {
+      LOGE("no more output tensors in the capture\n");
+      return CVI_TDL_ERR_INFERENCE;
+    }
+    auto iter = m_output_tensor_info.find(record.name);
+    if (iter == m_output_tensor_info.end() || iter->second.tensor_size != record.data.size()) {
+      LOGE("captured tensor %s does not match the model\n", record.name.c_str());
+      return CVI_TDL_ERR_INFERENCE;
+    }
+    memcpy(iter->second.raw_pointer, record.data.data(), record.data.size());
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+int Core::startCapture(const char *filepath, bool with_frame) {
+  if (!isInitialized()) {
+    LOGE("Model is not yet opened, cannot capture.\n");
+    return CVI_TDL_ERR_NOT_YET_INITIALIZED;
+  }
+  stopCapture();
+  std::unique_ptr<CaptureWriter> writer(new CaptureWriter);
+  int ret = writer->open(filepath, with_frame);
+  if (ret == CVI_TDL_SUCCESS) mp_capture = std::move(writer);
   return ret;
 }
 
+int Core::startReplay(const char *filepath) {
+  if (!isInitialized()) {
+    LOGE("Model is not yet opened, cannot replay.\n");
+    return CVI_TDL_ERR_NOT_YET_INITIALIZED;
+  }
+  stopCapture();
+  std::unique_ptr<CaptureReader> reader(new CaptureReader);
+  int ret = reader->open(filepath);
+  if (ret == CVI_TDL_SUCCESS) mp_replay = std::move(reader);
+  return ret;
+}
+
+int Core::stopCapture() {
+  int ret = mp_capture ? mp_capture->close() : CVI_TDL_SUCCESS;
+  mp_capture.reset();
+  mp_replay.reset();
+  return ret;
+}
+
+void Core::captureInput(VIDEO_FRAME_INFO_S *frame) {
+  if (mp_capture) mp_capture->beginCall(frame);
+}
+
+void Core::captureResult(cvtdl_object_t *obj) {
+  if (mp_capture) mp_capture->writeObjects(obj);
+}
+
+void Core::captureResult(cvtdl_face_t *face) {
+  if (mp_capture) mp_capture->writeFaces(face);
+}
+
 template <typename T>
 int Core::registerFrame2Tensor(std::vector<T> &frames) {
   int ret = 0;
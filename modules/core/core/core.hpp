@@ -8,9 +8,13 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include "capture_file.hpp"
 #include "cvi_comm.h"
 #include "cvi_tdl_log.hpp"
+#include "mem_account.hpp"
+#include "model_registry.hpp"
 #include "profiler.hpp"
+#include "trace.hpp"
 #include "vpss_engine.hpp"
 #define DEFAULT_MODEL_THRESHOLD 0.5
 #define DEFAULT_MODEL_NMS_THRESHOLD 0.5
@@ -68,7 +72,7 @@ class Core {
   Core(const Core &) = delete;
   Core &operator=(const Core &) = delete;
 
-  virtual ~Core() = default;
+  virtual ~Core();
   int modelOpen(const char *filepath);
   int modelOpen(const int8_t *buf, uint32_t size);
   int getInputMemType();
@@ -106,10 +110,30 @@ class Core {
   int vpssChangeImage(VIDEO_FRAME_INFO_S *srcFrame, VIDEO_FRAME_INFO_S *dstFrame, uint32_t rw,
                       uint32_t rh, PIXEL_FORMAT_E enDstFormat);
   VpssEngine *get_vpss_instance() { return mp_vpss_inst; }
+  MemAccount &getMemAccount() { return m_mem_account; }
+  int getLoadInfo(cvtdl_model_load_info_t *info) const;
+  /* name must be static, it labels the trace spans and the memory account of the model */
+  void setModelName(const char *name);
+  /* closes the trace span from the end of the forward of this thread to now, after outputParser */
+  void traceOutputParser();
 #ifndef CONFIG_ALIOS
   void setraw(bool raw);
 #endif
 
+  /*
+   * Capture writes the input frame, output tensors and result meta of every inference call to
+   * filepath. Replay takes the output tensors from a capture instead of running VPSS and the
+   * TPU, so outputParser sees the captured data.
+   */
+  int startCapture(const char *filepath, bool with_frame);
+  int startReplay(const char *filepath);
+  int stopCapture();
+  void captureInput(VIDEO_FRAME_INFO_S *frame);
+  void captureResult(cvtdl_object_t *obj);
+  void captureResult(cvtdl_face_t *face);
+  template <typename T>
+  void captureResult(T) {}
+
  protected:
   virtual int vpssPreprocess(VIDEO_FRAME_INFO_S *srcFrame, VIDEO_FRAME_INFO_S *dstFrame,
                              VPSSConfig &config);
@@ -188,6 +212,7 @@ class Core {
   // vpss related control
   int32_t m_vpss_timeout = 100;
   std::string m_model_file;
+  MemAccount m_mem_account;
 
  private:
   template <typename T>
@@ -195,6 +220,9 @@ class Core {
 
   void setupTensorInfo(CVI_TENSOR *tensor, int32_t num_tensors,
                        std::map<std::string, TensorInfo> *tensor_info);
+  int replayOutputs();
+  void chargeModelMemory(uint64_t model_bytes);
+  void traceStage(const char *stage, uint64_t *begin);
 
   std::map<std::string, TensorInfo> m_input_tensor_info;
   std::map<std::string, TensorInfo> m_output_tensor_info;
@@ -205,6 +233,13 @@ class Core {
 
   // Cvimodel related
   std::unique_ptr<CvimodelInfo> mp_mi;
+  std::unique_ptr<CaptureWriter> mp_capture;
+  std::unique_ptr<CaptureReader> mp_replay;
+  uint64_t m_model_ion_bytes = 0;
+  std::shared_ptr<SharedModel> mp_shared_model;
+  float m_open_ms = 0;
+  bool m_shared_open = false;
+  const char *mp_model_name = "model";
 #ifndef CONFIG_ALIOS
   bool raw = false;
 #endif
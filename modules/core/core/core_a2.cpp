@@ -5,6 +5,13 @@
 
 namespace cvitdl {
 
+namespace {
+// end of the last forward of this thread, the output parser runs right after it on the same
+// thread while other threads may run the same instance
+thread_local const Core *t_forward_model = nullptr;
+thread_local uint64_t t_forward_end = 0;
+}  // namespace
+
 Core::Core(CVI_MEM_TYPE_E input_mem_type) {
   mp_mi = std::make_unique<CvimodelInfo>();
   mp_mi->conf = {.debug_mode = false, .input_mem_type = input_mem_type};
@@ -57,6 +64,7 @@ int Core::modelOpen(const char *filepath) {
     return CVI_TDL_ERR_OPEN_MODEL;
   }
 
+  uint64_t t0 = trace::now_us();
   bm_status_t status = bm_dev_request(&bm_handle, 0);
   if (CVI_TDL_SUCCESS != status) {
     LOGE("bm_dev_request failed\n");
@@ -151,6 +159,7 @@ int Core::modelOpen(const char *filepath) {
     LOGE("return failed in onModelOpened\n");
     onModelClosed();
   }
+  m_open_ms = (trace::now_us() - t0) / 1000.f;
 
   return 0;
 }
@@ -436,6 +445,16 @@ int Core::getChnConfig(const uint32_t width, const uint32_t height, const uint32
 
 bool Core::isInitialized() { return mp_mi->handle == nullptr ? false : true; }
 
+int Core::startCapture(const char *filepath, bool with_frame) {
+  LOGE("capture is not supported on this platform.\n");
+  return CVI_TDL_ERR_NOT_YET_IMPLEMENTED;
+}
+
+int Core::startReplay(const char *filepath) {
+  LOGE("replay is not supported on this platform.\n");
+  return CVI_TDL_ERR_NOT_YET_IMPLEMENTED;
+}
+
 CVI_SHAPE Core::getInputShape(size_t index) { return getInputTensorInfo(index).shape; }
 
 CVI_SHAPE Core::getOutputShape(size_t index) { return getOutputTensorInfo(index).shape; }
@@ -506,6 +525,7 @@ int Core::run(std::vector<VIDEO_FRAME_INFO_S *> &frames) {
     LOGE("can only process one frame for aligninput,got frame_num:%d\n", int(frames.size()));
   }
   model_timer_.TicToc("runstart");
+  uint64_t trace_begin = trace::enabled() ? trace::now_us() : 0;
   if (mp_mi->conf.input_mem_type == CVI_MEM_DEVICE) {
     if (m_skip_vpss_preprocess) {
       // skip vpss preprocess is true, just register frame directly.
@@ -550,6 +570,7 @@ int Core::run(std::vector<VIDEO_FRAME_INFO_S *> &frames) {
     }
   }
   model_timer_.TicToc("vpss");
+  traceStage("vpss", &trace_begin);
   if (ret != CVI_TDL_SUCCESS) {
     LOGE("registerFrame2Tensor failed: Unsupport operation.\n");
     return ret;
@@ -575,8 +596,41 @@ int Core::run(std::vector<VIDEO_FRAME_INFO_S *> &frames) {
     return ret;
   }
   model_timer_.TicToc("tpu");
+  traceStage("forward", &trace_begin);
+  t_forward_model = this;
+  t_forward_end = trace_begin;
+  return CVI_TDL_SUCCESS;
+}
+
+void Core::traceStage(const char *stage, uint64_t *begin) {
+  if (*begin == 0) return;
+  uint64_t end = trace::now_us();
+  trace::record(stage, mp_model_name, *begin, end);
+  *begin = end;
+}
+
+void Core::traceOutputParser() {
+  if (t_forward_model != this) return;
+  t_forward_model = nullptr;
+  traceStage("output_parser", &t_forward_end);
+}
+
+int Core::getLoadInfo(cvtdl_model_load_info_t *info) const {
+  if (mp_mi->handle == nullptr) {
+    return CVI_TDL_ERR_NOT_YET_INITIALIZED;
+  }
+  info->open_ms = m_open_ms;
+  info->shared = false;
+  info->instances = 1;
+  info->file_bytes = 0;
+  info->resident_bytes = 0;
   return CVI_TDL_SUCCESS;
 }
+
+void Core::setModelName(const char *name) {
+  mp_model_name = name;
+  m_mem_account.setName(name);
+}
 template <typename T>
 int Core::registerFrame2Tensor(std::vector<T> &frames) {
   CVI_SHAPE input_shape = getInputShape(0);
@@ -4,6 +4,7 @@
 #include "core/core/cvtdl_vpss_types.h"
 
 #include "cvi_tdl_log.hpp"
+#include "mem_account.hpp"
 #include "vpss_engine.hpp"
 
 #include "bmlib_runtime.h"
@@ -17,6 +18,7 @@
 #include <string>
 #include <vector>
 #include "profiler.hpp"
+#include "trace.hpp"
 
 #define DEFAULT_MODEL_THRESHOLD 0.5
 #define DEFAULT_MODEL_NMS_THRESHOLD 0.5
@@ -136,6 +138,22 @@ class Core {
   int vpssChangeImage(VIDEO_FRAME_INFO_S *srcFrame, VIDEO_FRAME_INFO_S *dstFrame, uint32_t rw,
                       uint32_t rh, PIXEL_FORMAT_E enDstFormat);
   VpssEngine *get_vpss_instance() { return mp_vpss_inst; }
+  // only the accounts of the children are filled, bmruntime memory is not estimated yet
+  MemAccount &getMemAccount() { return m_mem_account; }
+  /* name must be static, it labels the trace spans and the memory account of the model */
+  void setModelName(const char *name);
+  /* closes the trace span from the end of the forward of this thread to now, after outputParser */
+  void traceOutputParser();
+  // bmruntime loads every instance on its own, only the open time is reported
+  int getLoadInfo(cvtdl_model_load_info_t *info) const;
+
+  // capture/replay is not supported with bmruntime yet
+  int startCapture(const char *filepath, bool with_frame);
+  int startReplay(const char *filepath);
+  int stopCapture() { return CVI_TDL_SUCCESS; }
+  void captureInput(VIDEO_FRAME_INFO_S *frame) {}
+  template <typename T>
+  void captureResult(T) {}
 
  protected:
   virtual int vpssPreprocess(VIDEO_FRAME_INFO_S *srcFrame, VIDEO_FRAME_INFO_S *dstFrame,
@@ -220,10 +238,12 @@ class Core {
   // vpss related control
   int32_t m_vpss_timeout = 100;
   std::string m_model_file;
+  MemAccount m_mem_account;
 
  private:
   template <typename T>
   inline int __attribute__((always_inline)) registerFrame2Tensor(std::vector<T> &frames);
+  void traceStage(const char *stage, uint64_t *begin);
 
   std::map<std::string, TensorInfo> m_input_tensor_info;
   std::map<std::string, TensorInfo> m_output_tensor_info;
@@ -238,5 +258,7 @@ class Core {
   bool use_mmap;
   bool raw = false;
   uint8_t *register_temp_buffer = nullptr;
+  const char *mp_model_name = "model";
+  float m_open_ms = 0;
 };
 }  // namespace cvitdl
@@ -0,0 +1,125 @@
+#include "model_registry.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <tuple>
+#include <vector>
+#include "core/core/cvtdl_errno.h"
+#include "cvi_tdl_log.hpp"
+#include "error_msg.hpp"
+
+namespace cvitdl {
+
+std::mutex ModelRegistry::s_mutex;
+std::map<ModelRegistry::FileKey, std::weak_ptr<SharedModel>> ModelRegistry::s_models;
+
+static double now_ms() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000. + ts.tv_nsec / 1e6;
+}
+
+SharedModel::~SharedModel() {
+  if (m_handle != nullptr) {
+    int ret = CVI_NN_CleanupModel(m_handle);
+    if (ret != CVI_RC_SUCCESS) {
+      LOGE("CVI_NN_CleanupModel failed: %s\n", get_tpu_error_msg(ret));
+    }
+  }
+  if (mp_map != nullptr) {
+    munmap(mp_map, m_size);
+  }
+}
+
+uint64_t SharedModel::residentBytes() const {
+  if (mp_map == nullptr) return 0;
+  size_t page = sysconf(_SC_PAGESIZE);
+  std::vector<unsigned char> pages((m_size + page - 1) / page);
+  if (mincore(mp_map, m_size, pages.data()) != 0) return 0;
+  uint64_t bytes = 0;
+  for (size_t i = 0; i < pages.size(); i++) {
+    if (pages[i] & 1) bytes += i + 1 < pages.size() ? page : m_size - i * page;
+  }
+  return bytes;
+}
+
+bool ModelRegistry::FileKey::operator<(const FileKey &o) const {
+  return std::tie(dev, ino, size, mtime_ns) < std::tie(o.dev, o.ino, o.size, o.mtime_ns);
+}
+
+std::shared_ptr<SharedModel> ModelRegistry::load(const char *filepath, int fd, size_t size) {
+  double t0 = now_ms();
+  std::shared_ptr<SharedModel> model = std::make_shared<SharedModel>();
+  model->m_size = size;
+  model->m_weights.setBytes(CVI_TDL_MEM_ION, size);
+  int ret;
+  void *map = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (map == MAP_FAILED) {
+    // some file systems cannot be mapped, the runtime reads the file instead
+    LOGW("failed to map %s, registering it from the file\n", filepath);
+    ret = CVI_NN_RegisterModel(filepath, &model->m_handle);
+  } else {
+    model->mp_map = map;
+    madvise(map, size, MADV_SEQUENTIAL);
+    madvise(map, size, MADV_WILLNEED);
+    ret = CVI_NN_RegisterModelFromBuffer(static_cast<const int8_t *>(map), size,
+                                         &model->m_handle);
+  }
+  if (ret != CVI_RC_SUCCESS) {
+    LOGE("failed to register %s: %s\n", filepath, get_tpu_error_msg(ret));
+    model->m_handle = nullptr;
+    return nullptr;
+  }
+  // the weights are in ION now, the file pages may go back to the page cache
+  if (model->mp_map != nullptr) madvise(model->mp_map, size, MADV_DONTNEED);
+  model->m_load_ms = now_ms() - t0;
+  return model;
+}
+
+int ModelRegistry::open(const char *filepath, std::shared_ptr<SharedModel> *model,
+                        CVI_MODEL_HANDLE *handle, bool *loaded) {
+  int fd = ::open(filepath, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    LOGE("failed to open %s\n", filepath);
+    return CVI_TDL_ERR_INVALID_MODEL_PATH;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0 || (uint64_t)st.st_size > UINT32_MAX) {
+    LOGE("%s is not a valid model file\n", filepath);
+    close(fd);
+    return CVI_TDL_ERR_INVALID_MODEL_PATH;
+  }
+  FileKey key = {st.st_dev, st.st_ino, st.st_size,
+                 (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec};
+
+  // held while loading, so concurrent opens of a file load it once
+  std::lock_guard<std::mutex> lock(s_mutex);
+  std::shared_ptr<SharedModel> shared = s_models[key].lock();
+  *loaded = shared == nullptr;
+  if (shared == nullptr) {
+    shared = load(filepath, fd, st.st_size);
+  }
+  close(fd);
+  if (shared == nullptr) {
+    s_models.erase(key);
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+  s_models[key] = shared;
+
+  int ret = CVI_NN_CloneModel(shared->m_handle, handle);
+  if (ret != CVI_RC_SUCCESS) {
+    LOGE("CVI_NN_CloneModel failed: %s\n", get_tpu_error_msg(ret));
+    *handle = nullptr;
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+  *model = shared;
+
+  // drop the entries of the released models
+  for (auto it = s_models.begin(); it != s_models.end();) {
+    it = it->second.expired() ? s_models.erase(it) : std::next(it);
+  }
+  return CVI_TDL_SUCCESS;
+}
+}  // namespace cvitdl
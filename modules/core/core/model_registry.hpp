@@ -0,0 +1,65 @@
+#pragma once
+#include <cviruntime.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "mem_account.hpp"
+
+namespace cvitdl {
+
+/*
+ * A cvimodel registered once from a read-only mapping of its file, or from the file itself when
+ * it cannot be mapped.
+ */
+class SharedModel {
+ public:
+  SharedModel() = default;
+  SharedModel(const SharedModel &) = delete;
+  SharedModel &operator=(const SharedModel &) = delete;
+  ~SharedModel();
+
+  uint64_t fileBytes() const { return m_size; }
+  /* pages of the mapped file in the page cache, they are shared with the other processes */
+  uint64_t residentBytes() const;
+  float loadMs() const { return m_load_ms; }
+  /* the weights, charged to the first instance still open */
+  SharedCharge &weights() { return m_weights; }
+
+ private:
+  friend class ModelRegistry;
+  CVI_MODEL_HANDLE m_handle = nullptr;
+  void *mp_map = nullptr;
+  size_t m_size = 0;
+  float m_load_ms = 0;
+  SharedCharge m_weights;
+};
+
+/*
+ * Opens every cvimodel file once per process. The instances get clones of the registered model,
+ * which share its weights and have their own I/O tensors. A file is identified by its device,
+ * inode, size and modification time, so a replaced file is loaded again. The model is released
+ * with its last instance.
+ */
+class ModelRegistry {
+ public:
+  /* *loaded is false when the weights come from an instance opened before */
+  static int open(const char *filepath, std::shared_ptr<SharedModel> *model,
+                  CVI_MODEL_HANDLE *handle, bool *loaded);
+
+ private:
+  struct FileKey {
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    int64_t mtime_ns;
+    bool operator<(const FileKey &o) const;
+  };
+
+  static std::shared_ptr<SharedModel> load(const char *filepath, int fd, size_t size);
+
+  static std::mutex s_mutex;
+  static std::map<FileKey, std::weak_ptr<SharedModel>> s_models;
+};
+}  // namespace cvitdl
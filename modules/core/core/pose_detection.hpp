@@ -14,5 +14,10 @@ class PoseDetectionBase : public Core {
     return 0;
   }
   virtual bool allowExportChannelAttribute() const override { return true; }
+  /* sub-pixel refinement of heatmap and SimCC keypoints, ignored by regression heads */
+  void setKeypointRefine(cvtdl_keypoint_refine_e refine) { m_keypoint_refine = refine; }
+
+ protected:
+  cvtdl_keypoint_refine_e m_keypoint_refine = CVTDL_KEYPOINT_REFINE_NONE;
 };
 }  // namespace cvitdl
\ No newline at end of file
@@ -52,6 +52,7 @@
 #include "face_detection/retina_face/scrfd_face.hpp"
 #include "face_detection/thermal_face_detection/thermal_face.hpp"
 #include "mask_classification/mask_classification.hpp"
+#include "ocr/ocr_detection/ocr_detection.hpp"
 #include "ocr/ocr_recognition/ocr_recognition.hpp"
 #include "osnet/osnet.hpp"
 #include "raw_image_classification/raw_image_classification.hpp"
@@ -70,7 +71,6 @@
 #include "license_plate_recognition/license_plate_recognition.hpp"
 #include "liveness/liveness.hpp"
 #include "mask_face_recognition/mask_face_recognition.hpp"
-#include "ocr/ocr_detection/ocr_detection.hpp"
 #include "opencv2/opencv.hpp"
 #include "smoke_classification/smoke_classification.hpp"
 #include "utils/image_utils.hpp"
@@ -88,6 +88,8 @@
 #include <vector>
 #include "utils/clip_postprocess.hpp"
 #include "utils/core_utils.hpp"
+#include "utils/requant_utils.hpp"
+#include "utils/stream_scheduler.hpp"
 #include "utils/token.hpp"
 #include "version.hpp"
 
@@ -184,7 +186,6 @@ unordered_map<int, CreatorFunc> MODEL_CREATORS = {
     {CVI_TDL_SUPPORTED_MODEL_SMOKECLASSIFICATION, CREATOR(SmokeClassification)},
     {CVI_TDL_SUPPORTED_MODEL_LPRNET_TW, CREATOR_P1(LicensePlateRecognition, LP_FORMAT, TAIWAN)},
     {CVI_TDL_SUPPORTED_MODEL_LPRNET_CN, CREATOR_P1(LicensePlateRecognition, LP_FORMAT, CHINA)},
-    {CVI_TDL_SUPPORTED_MODEL_OCR_DETECTION, CREATOR(OCRDetection)},
     {CVI_TDL_SUPPORTED_MODEL_MASKFACERECOGNITION, CREATOR(MaskFaceRecognition)},
     {CVI_TDL_SUPPORTED_MODEL_YOLOV8_SEG, CREATOR(YoloV8Seg)},
 #endif
@@ -275,6 +276,7 @@ unordered_map<int, CreatorFunc> MODEL_CREATORS = {
     {CVI_TDL_SUPPORTED_MODEL_POLYLANE, CREATOR(Polylanenet)},
     {CVI_TDL_SUPPORTED_MODEL_SUPER_RESOLUTION, CREATOR(SuperResolution)},
 
+    {CVI_TDL_SUPPORTED_MODEL_OCR_DETECTION, CREATOR(OCRDetection)},
     {CVI_TDL_SUPPORTED_MODEL_OCR_RECOGNITION, CREATOR(OCRRecognition)},
     {CVI_TDL_SUPPORTED_MODEL_STEREO, CREATOR(Stereo)},
 #endif
@@ -292,8 +294,10 @@ void CVI_TDL_EnableGDC(cvitdl_handle_t handle, bool use_gdc) {
 #ifndef NO_OPENCV
 inline void __attribute__((always_inline)) removeCtx(cvitdl_context_t *ctx) {
   delete ctx->ds_tracker;
+  delete ctx->lane_tracker;
   delete ctx->td_model;
   delete ctx->md_model;
+  delete ctx->md_gate;
 
   if (ctx->ive_handle) {
     ctx->ive_handle->destroy();
@@ -302,6 +306,7 @@ inline void __attribute__((always_inline)) removeCtx(cvitdl_context_t *ctx) {
   for (auto it : ctx->vec_vpss_engine) {
     delete it;
   }
+  ctx->ds_mem_account.set(CVI_TDL_MEM_HEAP, 0);
   delete ctx;
 }
 #else
@@ -310,12 +315,20 @@ inline void __attribute__((always_inline)) removeCtx(cvitdl_context_t *ctx) {
     delete ctx->ds_tracker;
     ctx->ds_tracker = nullptr;
   }
+  if (ctx->lane_tracker) {
+    delete ctx->lane_tracker;
+    ctx->lane_tracker = nullptr;
+  }
 
   // delete ctx->td_model;
   if (ctx->md_model) {
     delete ctx->md_model;
     ctx->md_model = nullptr;
   }
+  if (ctx->md_gate) {
+    delete ctx->md_gate;
+    ctx->md_gate = nullptr;
+  }
 
   if (ctx->ive_handle) {
     ctx->ive_handle->destroy();
@@ -325,6 +338,7 @@ inline void __attribute__((always_inline)) removeCtx(cvitdl_context_t *ctx) {
   for (auto it : ctx->vec_vpss_engine) {
     delete it;
   }
+  ctx->ds_mem_account.set(CVI_TDL_MEM_HEAP, 0);
   delete ctx;
 }
 #endif
@@ -357,6 +371,10 @@ getInferenceInstance(const CVI_TDL_SUPPORTED_MODEL_E index, cvitdl_context_t *ct
       m_t.instance->setVpssEngine(ctx->vec_vpss_engine[m_t.vpss_thread]);
       m_t.instance->setVpssTimeout(ctx->vpss_timeout_value);
     }
+    if (m_t.instance != nullptr) {
+      m_t.instance->setModelName(CVI_TDL_GetModelName(index));
+      m_t.instance->getMemAccount().setParent(ctx->mem_account);
+    }
   }
   return m_t.instance;
 }
@@ -374,6 +392,7 @@ CVI_S32 CVI_TDL_CreateHandle2(cvitdl_handle_t *handle, const VPSS_GRP vpssGroupI
 
   cvitdl_context_t *ctx = new cvitdl_context_t;
   ctx->ive_handle = NULL;
+  ctx->ds_mem_account.setParent(ctx->mem_account);
   ctx->vec_vpss_engine.push_back(new VpssEngine(vpssGroupId, vpssDev));
   const char timestamp[] = __DATE__ " " __TIME__;
   LOGI("cvitdl_handle_t is created, version %s-%s\n", CVI_TDL_TAG, timestamp);
@@ -384,6 +403,7 @@ CVI_S32 CVI_TDL_CreateHandle2(cvitdl_handle_t *handle, const VPSS_GRP vpssGroupI
 CVI_S32 CVI_TDL_CreateHandle3(cvitdl_handle_t *handle) {
   cvitdl_context_t *ctx = new cvitdl_context_t;
   ctx->ive_handle = NULL;
+  ctx->ds_mem_account.setParent(ctx->mem_account);
   const char timestamp[] = __DATE__ " " __TIME__;
   LOGI("cvitdl_handle_t is created, version %s-%s\n", CVI_TDL_TAG, timestamp);
   *handle = ctx;
@@ -518,6 +538,38 @@ CVI_S32 CVI_TDL_SetPerfEvalInterval(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MO
   return CVI_TDL_SUCCESS;
 }
 
+CVI_S32 CVI_TDL_StartCapture(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E model_index,
+                             const char *filepath, bool with_frame) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  Core *instance = getInferenceInstance(model_index, ctx);
+  if (instance == nullptr) {
+    LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(model_index));
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+  return instance->startCapture(filepath, with_frame);
+}
+
+CVI_S32 CVI_TDL_StartReplay(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E model_index,
+                            const char *filepath) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  Core *instance = getInferenceInstance(model_index, ctx);
+  if (instance == nullptr) {
+    LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(model_index));
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+  return instance->startReplay(filepath);
+}
+
+CVI_S32 CVI_TDL_StopCapture(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E model_index) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  Core *instance = getInferenceInstance(model_index, ctx);
+  if (instance == nullptr) {
+    LOGE("Cannot create model: %s\n", CVI_TDL_GetModelName(model_index));
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+  return instance->stopCapture();
+}
+
 CVI_S32 CVI_TDL_GetSkipVpssPreprocess(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E config,
                                       bool *skip) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
@@ -723,6 +775,219 @@ CVI_S32 CVI_TDL_CloseModel(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E con
   return CVI_TDL_SUCCESS;
 }
 
+// DeepSORT only knows its current size, sampled whenever the accounts are read
+static void sampleTrackerMemory(cvitdl_context_t *ctx) {
+  ctx->ds_mem_account.set(CVI_TDL_MEM_HEAP,
+                          ctx->ds_tracker != nullptr ? ctx->ds_tracker->memoryUsage() : 0);
+}
+
+CVI_S32 CVI_TDL_GetMemUsage(const cvitdl_handle_t handle, cvtdl_mem_usage_t *usage) {
+  if (usage == nullptr) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  sampleTrackerMemory(ctx);
+  ctx->mem_account->query(usage);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_GetModelMemUsage(const cvitdl_handle_t handle,
+                                 CVI_TDL_SUPPORTED_MODEL_E model_index, cvtdl_mem_usage_t *usage) {
+  if (usage == nullptr) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  auto it = ctx->model_cont.find(model_index);
+  if (it == ctx->model_cont.end() || it->second.instance == nullptr) {
+    LOGE("%s has not been inited\n", CVI_TDL_GetModelName(model_index));
+    return CVI_TDL_ERR_NOT_YET_INITIALIZED;
+  }
+  it->second.instance->getMemAccount().query(usage);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_GetModelLoadInfo(const cvitdl_handle_t handle,
+                                 CVI_TDL_SUPPORTED_MODEL_E model_index,
+                                 cvtdl_model_load_info_t *info) {
+  if (info == nullptr) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  auto it = ctx->model_cont.find(model_index);
+  if (it == ctx->model_cont.end() || it->second.instance == nullptr) {
+    LOGE("%s has not been inited\n", CVI_TDL_GetModelName(model_index));
+    return CVI_TDL_ERR_NOT_YET_INITIALIZED;
+  }
+  return it->second.instance->getLoadInfo(info);
+}
+
+CVI_S32 CVI_TDL_DumpMemUsage(const cvitdl_handle_t handle) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  sampleTrackerMemory(ctx);
+  ctx->mem_account->dump();
+  for (auto &m_inst : ctx->model_cont) {
+    if (m_inst.second.instance != nullptr) {
+      m_inst.second.instance->getMemAccount().dump("  ");
+    }
+  }
+  for (auto &m_inst : ctx->custom_cont) {
+    if (m_inst.instance != nullptr) {
+      m_inst.instance->getMemAccount().dump("  ");
+    }
+  }
+  ctx->ds_mem_account.dump("  ");
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Trace_Enable(bool enable) {
+  trace::enable(enable);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Trace_Export(const char *filepath) {
+  if (filepath == nullptr) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  return trace::exportJson(filepath);
+}
+
+uint64_t CVI_TDL_Trace_Begin(void) { return trace::enabled() ? trace::now_us() : 0; }
+
+void CVI_TDL_Trace_End(const char *name, const char *category, uint64_t begin) {
+  if (begin != 0) trace::record(name, category, begin, trace::now_us());
+}
+
+// first capacity of the result of a worker, it grows with the detections
+#define STREAM_SCHED_OBJECTS 64
+
+typedef struct {
+  CVI_TDL_SUPPORTED_MODEL_E model_index;
+  cvtdl_stream_result_cb callback;
+  void *user_data;
+  std::vector<cvitdl_handle_t> handles;
+  // one result per worker, keeps its capacity across frames
+  std::vector<cvtdl_object_t> objs;
+  std::unique_ptr<StreamScheduler> scheduler;
+} cvitdl_stream_sched_context_t;
+
+static void destroyStreamSched(cvitdl_stream_sched_context_t *ctx) {
+  // joins the workers before their handles go
+  ctx->scheduler.reset();
+  for (cvtdl_object_t &obj : ctx->objs) {
+    CVI_TDL_Free(&obj);
+  }
+  for (cvitdl_handle_t handle : ctx->handles) {
+    CVI_TDL_DestroyHandle(handle);
+  }
+  delete ctx;
+}
+
+CVI_S32 CVI_TDL_StreamSched_GetDefaultConfig(cvtdl_stream_sched_config_t *config) {
+  if (config == nullptr) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  config->num_workers = 2;
+  config->max_streams = 16;
+  config->queue_depth = 2;
+  config->deadline_ms = 200;
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_StreamSched_Create(cvitdl_stream_sched_t *sched,
+                                   CVI_TDL_SUPPORTED_MODEL_E model_index, const char *filepath,
+                                   const cvtdl_stream_sched_config_t *config,
+                                   cvtdl_stream_result_cb callback, void *user_data) {
+  cvtdl_stream_sched_config_t conf;
+  CVI_TDL_StreamSched_GetDefaultConfig(&conf);
+  if (config != nullptr) {
+    conf = *config;
+  }
+  if (sched == nullptr || filepath == nullptr || callback == nullptr || conf.num_workers == 0 ||
+      conf.max_streams == 0 || conf.queue_depth == 0) {
+    LOGE("invalid stream scheduler arguments\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  cvitdl_stream_sched_context_t *ctx = new cvitdl_stream_sched_context_t;
+  ctx->model_index = model_index;
+  ctx->callback = callback;
+  ctx->user_data = user_data;
+  ctx->objs.resize(conf.num_workers);
+  memset(ctx->objs.data(), 0, sizeof(cvtdl_object_t) * conf.num_workers);
+  for (cvtdl_object_t &obj : ctx->objs) {
+    CVI_TDL_ReserveObjectMeta(&obj, STREAM_SCHED_OBJECTS);
+  }
+  for (uint32_t i = 0; i < conf.num_workers; i++) {
+    cvitdl_handle_t handle = nullptr;
+    CVI_S32 ret = CVI_TDL_CreateHandle(&handle);
+    if (ret == CVI_TDL_SUCCESS) {
+      ctx->handles.push_back(handle);
+      ret = CVI_TDL_OpenModel(handle, model_index, filepath);
+    }
+    if (ret != CVI_TDL_SUCCESS) {
+      LOGE("failed to create stream scheduler worker %u\n", i);
+      destroyStreamSched(ctx);
+      return ret;
+    }
+  }
+
+  auto run = [ctx](uint32_t worker, uint32_t stream, VIDEO_FRAME_INFO_S *frame) {
+    cvtdl_object_t *obj = &ctx->objs[worker];
+    CVI_S32 ret = CVI_TDL_Detection(ctx->handles[worker], frame, ctx->model_index, obj);
+    ctx->callback(stream, ret, frame, ret == CVI_TDL_SUCCESS ? obj : nullptr, ctx->user_data);
+    return ret;
+  };
+  auto drop = [ctx](uint32_t stream, VIDEO_FRAME_INFO_S *frame) {
+    ctx->callback(stream, CVI_TDL_ERR_FRAME_DROPPED, frame, nullptr, ctx->user_data);
+  };
+  ctx->scheduler.reset(new StreamScheduler(conf, run, drop));
+  *sched = ctx;
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_StreamSched_GetHandle(cvitdl_stream_sched_t sched, uint32_t worker,
+                                      cvitdl_handle_t *handle) {
+  cvitdl_stream_sched_context_t *ctx = static_cast<cvitdl_stream_sched_context_t *>(sched);
+  if (ctx == nullptr || handle == nullptr || worker >= ctx->handles.size()) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  *handle = ctx->handles[worker];
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_StreamSched_Submit(cvitdl_stream_sched_t sched, uint32_t stream_id,
+                                   VIDEO_FRAME_INFO_S *frame) {
+  cvitdl_stream_sched_context_t *ctx = static_cast<cvitdl_stream_sched_context_t *>(sched);
+  if (ctx == nullptr) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  return ctx->scheduler->submit(stream_id, frame);
+}
+
+CVI_S32 CVI_TDL_StreamSched_Flush(cvitdl_stream_sched_t sched) {
+  cvitdl_stream_sched_context_t *ctx = static_cast<cvitdl_stream_sched_context_t *>(sched);
+  if (ctx == nullptr) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  ctx->scheduler->flush();
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_StreamSched_GetStats(cvitdl_stream_sched_t sched, uint32_t stream_id,
+                                     cvtdl_stream_stats_t *stats) {
+  cvitdl_stream_sched_context_t *ctx = static_cast<cvitdl_stream_sched_context_t *>(sched);
+  if (ctx == nullptr) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  return ctx->scheduler->getStats(stream_id, stats);
+}
+
+CVI_S32 CVI_TDL_StreamSched_Destroy(cvitdl_stream_sched_t sched) {
+  if (sched != nullptr) {
+    destroyStreamSched(static_cast<cvitdl_stream_sched_context_t *>(sched));
+  }
+  return CVI_TDL_SUCCESS;
+}
+
 // TODO: remove this func
 CVI_S32 CVI_TDL_SelectDetectClass(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL_E config,
                                   uint32_t num_selection, ...) {
@@ -795,11 +1060,12 @@ CVI_S32 CVI_TDL_GetVpssChnConfig(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL
       if (initVPSSIfNeeded(ctx, model_index) != CVI_SUCCESS) {                                 \
         return CVI_TDL_ERR_INIT_VPSS;                                                          \
       } else {                                                                                 \
+        obj->captureInput(frame);                                                              \
         CVI_S32 ret = obj->inference(frame, arg1);                                             \
-        if (ret != CVI_TDL_SUCCESS)                                                            \
-          return ret;                                                                          \
-        else                                                                                   \
-          return obj->after_inference();                                                       \
+        obj->traceOutputParser();                                                              \
+        if (ret != CVI_TDL_SUCCESS) return ret;                                                \
+        obj->captureResult(arg1);                                                              \
+        return obj->after_inference();                                                         \
       }                                                                                        \
     } else {                                                                                   \
       LOGE("Model (%s)is not yet opened! Please call CVI_TDL_OpenModel to initialize model\n", \
@@ -821,11 +1087,12 @@ CVI_S32 CVI_TDL_GetVpssChnConfig(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL
       if (initVPSSIfNeeded(ctx, model_index) != CVI_SUCCESS) {                                 \
         return CVI_TDL_ERR_INIT_VPSS;                                                          \
       } else {                                                                                 \
+        obj->captureInput(frame);                                                              \
         CVI_S32 ret = obj->inference(frame, arg1, arg2);                                       \
-        if (ret != CVI_TDL_SUCCESS)                                                            \
-          return ret;                                                                          \
-        else                                                                                   \
-          return obj->after_inference();                                                       \
+        obj->traceOutputParser();                                                              \
+        if (ret != CVI_TDL_SUCCESS) return ret;                                                \
+        obj->captureResult(arg1);                                                              \
+        return obj->after_inference();                                                         \
       }                                                                                        \
     } else {                                                                                   \
       LOGE("Model (%s)is not yet opened! Please call CVI_TDL_OpenModel to initialize model\n", \
@@ -848,6 +1115,7 @@ CVI_S32 CVI_TDL_GetVpssChnConfig(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL
         return CVI_TDL_ERR_INIT_VPSS;                                                          \
       } else {                                                                                 \
         CVI_S32 ret = obj->inference(frame1, frame2, arg1);                                    \
+        obj->traceOutputParser();                                                              \
         if (ret != CVI_TDL_SUCCESS)                                                            \
           return ret;                                                                          \
         else                                                                                   \
@@ -874,6 +1142,7 @@ CVI_S32 CVI_TDL_GetVpssChnConfig(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL
         return CVI_TDL_ERR_INIT_VPSS;                                                          \
       } else {                                                                                 \
         CVI_S32 ret = obj->inference(frame1, frame2, arg1, arg2);                              \
+        obj->traceOutputParser();                                                              \
         if (ret != CVI_TDL_SUCCESS)                                                            \
           return ret;                                                                          \
         else                                                                                   \
@@ -897,8 +1166,6 @@ CVI_S32 CVI_TDL_GetVpssChnConfig(cvitdl_handle_t handle, CVI_TDL_SUPPORTED_MODEL
 #ifndef NO_OPENCV
 DEFINE_INF_FUNC_F2_P2(CVI_TDL_Liveness, Liveness, CVI_TDL_SUPPORTED_MODEL_LIVENESS, cvtdl_face_t *,
                       cvtdl_face_t *)
-DEFINE_INF_FUNC_F1_P1(CVI_TDL_OCR_Detection, OCRDetection, CVI_TDL_SUPPORTED_MODEL_OCR_DETECTION,
-                      cvtdl_object_t *)
 DEFINE_INF_FUNC_F1_P1(CVI_TDL_EyeClassification, EyeClassification,
                       CVI_TDL_SUPPORTED_MODEL_EYECLASSIFICATION, cvtdl_face_t *)
 DEFINE_INF_FUNC_F1_P1(CVI_TDL_YawnClassification, YawnClassification,
@@ -962,13 +1229,31 @@ CVI_S32 CVI_TDL_Set_MaskOutlinePoint(VIDEO_FRAME_INFO_S *frame, cvtdl_object_t *
   int proto_h = obj_meta->mask_height;
   int proto_w = obj_meta->mask_width;
   for (uint32_t i = 0; i < obj_meta->size; i++) {
-    cv::Mat src(proto_h, proto_w, CV_8UC1, obj_meta->info[i].mask_properity->mask,
-                proto_w * sizeof(uint8_t));
+    cvtdl_mask_meta *mask_meta = obj_meta->info[i].mask_properity;
+    cv::Mat src;
+    cv::Point offset(0, 0);
+    if (mask_meta->mask_format == CVTDL_MASK_FORMAT_FULL) {
+      src = cv::Mat(proto_h, proto_w, CV_8UC1, mask_meta->mask, proto_w * sizeof(uint8_t));
+    } else if (mask_meta->mask_format == CVTDL_MASK_FORMAT_BBOX) {
+      src = cv::Mat(mask_meta->mask_h, mask_meta->mask_w, CV_8UC1, mask_meta->mask,
+                    mask_meta->mask_w * sizeof(uint8_t));
+      offset = cv::Point(mask_meta->mask_x, mask_meta->mask_y);
+    } else {
+      // expand runs (background first) into the box crop
+      src = cv::Mat::zeros(mask_meta->mask_h, mask_meta->mask_w, CV_8UC1);
+      uint32_t pos = 0;
+      for (uint32_t r = 0; r < mask_meta->mask_rle_size; r++) {
+        if (r % 2 == 1) memset(src.data + pos, 255, mask_meta->mask_rle[r]);
+        pos += mask_meta->mask_rle[r];
+      }
+      offset = cv::Point(mask_meta->mask_x, mask_meta->mask_y);
+    }
+    if (src.empty()) continue;
 
     std::vector<std::vector<cv::Point>> contours;
     std::vector<cv::Vec4i> hierarchy;
     // search for contours
-    cv::findContours(src, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
+    cv::findContours(src, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE, offset);
     // find the longest contour
     int longest_index = -1;
     size_t max_length = 0;
@@ -1078,6 +1363,28 @@ DEFINE_INF_FUNC_F2_P1(CVI_TDL_MotionSegmentation, MotionSegmentation,
 DEFINE_INF_FUNC_F2_P1(CVI_TDL_Depth_Stereo, Stereo, CVI_TDL_SUPPORTED_MODEL_STEREO,
                       cvtdl_depth_logits_t *)
 
+CVI_S32 CVI_TDL_Depth_Stereo_SetOutput(const cvitdl_handle_t handle,
+                                       const cvtdl_depth_output_t *output) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  Stereo *stereo_model =
+      dynamic_cast<Stereo *>(getInferenceInstance(CVI_TDL_SUPPORTED_MODEL_STEREO, ctx));
+  if (stereo_model == nullptr) {
+    LOGE("stereo_model has not been inited\n");
+    return CVI_TDL_FAILURE;
+  }
+  return stereo_model->setOutput(output);
+}
+
+CVI_S32 CVI_TDL_Depth_Stereo_MakeDepthLUT(float baseline, float focal, float disparity_scale,
+                                          float *lut) {
+  if (lut == nullptr) {
+    LOGE("depth lut is NULL\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  BuildDepthLUT(baseline, focal, disparity_scale, lut);
+  return CVI_TDL_SUCCESS;
+}
+
 DEFINE_INF_FUNC_F1_P1(CVI_TDL_LicensePlateDetection, LicensePlateDetection,
                       CVI_TDL_SUPPORTED_MODEL_WPODNET, cvtdl_object_t *)
 DEFINE_INF_FUNC_F1_P1(CVI_TDL_FaceLandmarker, FaceLandmarker,
@@ -1102,6 +1409,8 @@ DEFINE_INF_FUNC_F1_P1(CVI_TDL_PolyLane_Det, Polylanenet, CVI_TDL_SUPPORTED_MODEL
                       cvtdl_lane_t *)
 DEFINE_INF_FUNC_F1_P1(CVI_TDL_Super_Resolution, SuperResolution,
                       CVI_TDL_SUPPORTED_MODEL_SUPER_RESOLUTION, cvtdl_sr_feature *)
+DEFINE_INF_FUNC_F1_P1(CVI_TDL_OCR_Detection, OCRDetection, CVI_TDL_SUPPORTED_MODEL_OCR_DETECTION,
+                      cvtdl_object_t *)
 DEFINE_INF_FUNC_F1_P1(CVI_TDL_OCR_Recognition, OCRRecognition,
                       CVI_TDL_SUPPORTED_MODEL_OCR_RECOGNITION, cvtdl_object_t *)
 DEFINE_INF_FUNC_F1_P1(CVI_TDL_LSTR_Det, LSTR, CVI_TDL_SUPPORTED_MODEL_LSTR, cvtdl_lane_t *)
@@ -1113,6 +1422,17 @@ DEFINE_INF_FUNC_F1_P2(CVI_TDL_Isp_Image_Classification, IspImageClassification,
                       cvtdl_isp_meta_t *)
 #endif
 
+// Lane Tracking
+CVI_S32 CVI_TDL_Lane_Track(const cvitdl_handle_t handle, const cvtdl_lane_t *lane_meta,
+                           cvtdl_lane_t *tracked_lanes) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  if (ctx->lane_tracker == nullptr) {
+    LOGD("Init Lane Tracker.\n");
+    ctx->lane_tracker = new LaneTracker();
+  }
+  return ctx->lane_tracker->track(lane_meta, tracked_lanes);
+}
+
 CVI_S32 CVI_TDL_Detection(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
                           CVI_TDL_SUPPORTED_MODEL_E model_index, cvtdl_object_t *obj) {
   std::set<CVI_TDL_SUPPORTED_MODEL_E> detect_set = {
@@ -1153,11 +1473,12 @@ CVI_S32 CVI_TDL_Detection(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *fram
     if (initVPSSIfNeeded(ctx, model_index) != CVI_SUCCESS) {
       return CVI_TDL_ERR_INIT_VPSS;
     } else {
+      model->captureInput(frame);
       CVI_S32 ret = model->inference(frame, obj);
-      if (ret != CVI_TDL_SUCCESS)
-        return ret;
-      else
-        return model->after_inference();
+      model->traceOutputParser();
+      if (ret != CVI_TDL_SUCCESS) return ret;
+      model->captureResult(obj);
+      return model->after_inference();
     }
   } else {
     LOGE("Model (%s)is not yet opened! Please call CVI_TDL_OpenModel to initialize model\n",
@@ -1206,11 +1527,12 @@ CVI_S32 CVI_TDL_FaceDetection(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *
     if (initVPSSIfNeeded(ctx, model_index) != CVI_SUCCESS) {
       return CVI_TDL_ERR_INIT_VPSS;
     } else {
+      model->captureInput(frame);
       CVI_S32 ret = model->inference(frame, face_meta);
-      if (ret != CVI_TDL_SUCCESS)
-        return ret;
-      else
-        return model->after_inference();
+      model->traceOutputParser();
+      if (ret != CVI_TDL_SUCCESS) return ret;
+      model->captureResult(face_meta);
+      return model->after_inference();
     }
   } else {
     LOGE("Model (%s)is not yet opened! Please call CVI_TDL_OpenModel to initialize model\n",
@@ -1240,6 +1562,7 @@ CVI_S32 CVI_TDL_PoseDetection(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *
       return CVI_TDL_ERR_INIT_VPSS;
     } else {
       CVI_S32 ret = model->inference(frame, obj_meta);
+      model->traceOutputParser();
       if (ret != CVI_TDL_SUCCESS)
         return ret;
       else
@@ -1252,6 +1575,25 @@ CVI_S32 CVI_TDL_PoseDetection(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *
   }
 }
 
+CVI_S32 CVI_TDL_Set_Pose_KeypointRefine(const cvitdl_handle_t handle,
+                                        CVI_TDL_SUPPORTED_MODEL_E model_index,
+                                        cvtdl_keypoint_refine_e refine) {
+  if (model_index != CVI_TDL_SUPPORTED_MODEL_HRNET_POSE &&
+      model_index != CVI_TDL_SUPPORTED_MODEL_SIMCC_POSE) {
+    LOGE("model %s does not decode heatmaps.\n", CVI_TDL_GetModelName(model_index));
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  PoseDetectionBase *model =
+      dynamic_cast<PoseDetectionBase *>(getInferenceInstance(model_index, ctx));
+  if (model == nullptr) {
+    LOGE("No instance found\n");
+    return CVI_TDL_ERR_OPEN_MODEL;
+  }
+  model->setKeypointRefine(refine);
+  return CVI_TDL_SUCCESS;
+}
+
 CVI_S32 CVI_TDL_LicensePlateRecognition(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
                                         CVI_TDL_SUPPORTED_MODEL_E model_id, cvtdl_object_t *obj) {
   std::set<CVI_TDL_SUPPORTED_MODEL_E> detect_set = {CVI_TDL_SUPPORTED_MODEL_LPRNET_TW,
@@ -1277,6 +1619,32 @@ CVI_S32 CVI_TDL_LicensePlateRecognition(const cvitdl_handle_t handle, VIDEO_FRAM
   }
 }
 
+CVI_S32 CVI_TDL_Set_CTC_BeamWidth(const cvitdl_handle_t handle,
+                                  CVI_TDL_SUPPORTED_MODEL_E model_index, int beam_width) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  Core *instance = getInferenceInstance(model_index, ctx);
+  if (OCRRecognition *ocr_model = dynamic_cast<OCRRecognition *>(instance)) {
+    return ocr_model->setBeamWidth(beam_width);
+  }
+  if (LicensePlateRecognitionBase *lp_model = dynamic_cast<LicensePlateRecognitionBase *>(instance)) {
+    return lp_model->setBeamWidth(beam_width);
+  }
+  LOGE("model %s has no CTC decoder.\n", CVI_TDL_GetModelName(model_index));
+  return CVI_TDL_ERR_INVALID_ARGS;
+}
+
+CVI_S32 CVI_TDL_Set_CTC_Confidence(const cvitdl_handle_t handle,
+                                   CVI_TDL_SUPPORTED_MODEL_E model_index, bool enable) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  Core *instance = getInferenceInstance(model_index, ctx);
+  if (LicensePlateRecognitionBase *lp_model = dynamic_cast<LicensePlateRecognitionBase *>(instance)) {
+    lp_model->setConfidences(enable);
+    return CVI_TDL_SUCCESS;
+  }
+  LOGE("model %s is not a license plate recognition model.\n", CVI_TDL_GetModelName(model_index));
+  return CVI_TDL_ERR_INVALID_ARGS;
+}
+
 // Tracker
 
 CVI_S32 CVI_TDL_DeepSORT_Init(const cvitdl_handle_t handle, bool use_specific_counter) {
@@ -1361,6 +1729,16 @@ CVI_S32 CVI_TDL_DeepSORT_Obj(const cvitdl_handle_t handle, cvtdl_object_t *obj,
   return ctx->ds_tracker->track(obj, tracker, use_reid);
 }
 
+CVI_S32 CVI_TDL_DeepSORT_Coast(const cvitdl_handle_t handle, cvtdl_tracker_t *tracker) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  DeepSORT *ds_tracker = ctx->ds_tracker;
+  if (ds_tracker == nullptr) {
+    LOGE("Please initialize DeepSORT first.\n");
+    return CVI_TDL_FAILURE;
+  }
+  return ctx->ds_tracker->coast(tracker);
+}
+
 CVI_S32 CVI_TDL_DeepSORT_Byte(const cvitdl_handle_t handle, cvtdl_object_t *obj,
                               cvtdl_tracker_t *tracker, bool use_reid) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
@@ -1540,6 +1918,35 @@ CVI_S32 CVI_TDL_MotionDetection(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S
   return ret;
 }
 
+CVI_S32 CVI_TDL_MotionGate_GetDefaultConfig(cvtdl_motion_gate_config_t *config) {
+  *config = MotionGate::defaultConfig();
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Set_MotionGate_Config(const cvitdl_handle_t handle,
+                                      const cvtdl_motion_gate_config_t *config) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  if (ctx->md_gate == nullptr) {
+    ctx->md_gate = new MotionGate();
+  }
+  ctx->md_gate->setConfig(*config);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_MotionGate(const cvitdl_handle_t handle, VIDEO_FRAME_INFO_S *frame,
+                           const cvtdl_object_t *motion, cvtdl_motion_gate_t *gate) {
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  if (ctx->md_gate == nullptr) {
+    ctx->md_gate = new MotionGate();
+  }
+  ctx->md_gate->decide(motion, frame->stVFrame.u32Width, frame->stVFrame.u32Height, gate);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_MotionGate_RestoreObjects(const cvtdl_motion_gate_t *gate, cvtdl_object_t *obj) {
+  return MotionGate::restore(gate, obj);
+}
+
 CVI_S32 CVI_TDL_FaceFeatureExtract(const cvitdl_handle_t handle, const uint8_t *p_rgb_pack,
                                    int width, int height, int stride,
                                    cvtdl_face_info_t *p_face_info) {
@@ -1828,6 +2235,22 @@ CVI_S32 CVI_TDL_PersonVehicle_Detection(const cvitdl_handle_t handle, VIDEO_FRAM
   }
 }
 
+CVI_S32 CVI_TDL_Set_YoloV8_Seg_MaskFormat(const cvitdl_handle_t handle,
+                                          cvtdl_mask_format_e format) {
+#ifndef NO_OPENCV
+  cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
+  YoloV8Seg *yolov8_seg_model =
+      dynamic_cast<YoloV8Seg *>(getInferenceInstance(CVI_TDL_SUPPORTED_MODEL_YOLOV8_SEG, ctx));
+  if (yolov8_seg_model == nullptr) {
+    LOGE("yolov8_seg_model has not been inited\n");
+    return CVI_TDL_FAILURE;
+  }
+  return yolov8_seg_model->setMaskFormat(format);
+#else
+  return CVI_TDL_ERR_NOT_YET_INITIALIZED;
+#endif
+}
+
 CVI_S32 CVI_TDL_Set_Yolov5_ROI(const cvitdl_handle_t handle, Point_t roi_s) {
   printf("enter CVI_TDL_Set_Yolov5_ROI...\n");
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
@@ -10,7 +10,9 @@
 #include "fall_detection/fall_det_monitor.hpp"
 #include "fall_detection/fall_detection.hpp"
 #include "ive/ive.hpp"
+#include "lane_detection/lane_tracker.hpp"
 #include "motion_detection/md.hpp"
+#include "motion_detection/motion_gate.hpp"
 #include "tamper_detection/tamper_detection.hpp"
 typedef struct {
   cvitdl::Core *instance = nullptr;
@@ -34,11 +36,16 @@ typedef struct {
   uint32_t vpss_timeout_value = 100;  // default value.
   ive::IVE *ive_handle = NULL;
   MotionDetection *md_model = nullptr;
+  MotionGate *md_gate = nullptr;
   DeepSORT *ds_tracker = nullptr;
   TamperDetectorMD *td_model = nullptr;
   FallMD *fall_model = nullptr;
   FallDetMonitor *fall_monitor_model = nullptr;
+  cvitdl::LaneTracker *lane_tracker = nullptr;
   bool use_gdc_wrap = false;
+  // sum of the models and trackers below, shared so that leaked children never outlive it
+  std::shared_ptr<cvitdl::MemAccount> mem_account = std::make_shared<cvitdl::MemAccount>("handle");
+  cvitdl::MemAccount ds_mem_account{"DeepSORT"};
 } cvitdl_context_t;
 
 inline const char *__attribute__((always_inline)) GetModelName(cvitdl_model_t &model) {
@@ -12,6 +12,8 @@ CVI_S32 CVI_TDL_Custom_AddInference(cvitdl_handle_t handle, uint32_t *id) {
   cvitdl_context_t *ctx = static_cast<cvitdl_context_t *>(handle);
   cvitdl_model_t model;
   model.instance = new cvitdl::Custom();
+  model.instance->setModelName("custom");
+  model.instance->getMemAccount().setParent(ctx->mem_account);
   ctx->custom_cont.push_back(model);
   *id = ctx->custom_cont.size() - 1;
   LOGI("Custom AI instance added.");
@@ -1,7 +1,197 @@
 #include "core/cvi_tdl_types_mem.h"
 #include <string.h>
+#include <atomic>
 #include <cvi_tdl_log.hpp>
+#include <mutex>
+#include <unordered_map>
 #include "core/cvi_tdl_types_mem_internal.h"
+#include "meta_arena.hpp"
+
+// Meta storage
+
+namespace {
+// Storage of a meta set up with CVI_TDL_Reserve{Face,Object}Meta, keyed by its info[].
+struct MetaStorage {
+  cvitdl::MetaArena arena;
+  uint32_t capacity = 0;
+};
+
+std::mutex g_storage_mutex;
+std::unordered_map<const void *, MetaStorage *> g_storages;
+// metas that never opted in skip the lookup
+std::atomic<size_t> g_num_storages(0);
+
+MetaStorage *findStorage(const void *info) {
+  if (info == NULL || g_num_storages.load(std::memory_order_acquire) == 0) {
+    return NULL;
+  }
+  std::lock_guard<std::mutex> lock(g_storage_mutex);
+  auto it = g_storages.find(info);
+  return it != g_storages.end() ? it->second : NULL;
+}
+
+MetaStorage *takeStorage(const void *info) {
+  if (info == NULL || g_num_storages.load(std::memory_order_acquire) == 0) {
+    return NULL;
+  }
+  std::lock_guard<std::mutex> lock(g_storage_mutex);
+  auto it = g_storages.find(info);
+  if (it == g_storages.end()) {
+    return NULL;
+  }
+  MetaStorage *storage = it->second;
+  g_storages.erase(it);
+  g_num_storages--;
+  return storage;
+}
+
+void putStorage(const void *info, MetaStorage *storage) {
+  std::lock_guard<std::mutex> lock(g_storage_mutex);
+  g_storages[info] = storage;
+  g_num_storages++;
+}
+
+// arena is NULL for heap payloads
+void freePayload(void *ptr, const cvitdl::MetaArena *arena) {
+  if (ptr != NULL && (arena == NULL || !arena->owns(ptr))) {
+    free(ptr);
+  }
+}
+
+void freeInfo(cvtdl_face_info_t *face_info, const cvitdl::MetaArena *arena) {
+  freePayload(face_info->pts.x, arena);
+  freePayload(face_info->pts.y, arena);
+  face_info->pts.x = NULL;
+  face_info->pts.y = NULL;
+  face_info->pts.size = 0;
+  freePayload(face_info->feature.ptr, arena);
+  face_info->feature.ptr = NULL;
+  face_info->feature.size = 0;
+  face_info->feature.type = TYPE_INT8;
+}
+
+void freeInfo(cvtdl_object_info_t *obj_info, const cvitdl::MetaArena *arena) {
+  freePayload(obj_info->feature.ptr, arena);
+  obj_info->feature.ptr = NULL;
+  obj_info->feature.size = 0;
+  obj_info->feature.type = TYPE_INT8;
+  freePayload(obj_info->vehicle_properity, arena);
+  obj_info->vehicle_properity = NULL;
+  freePayload(obj_info->pedestrian_properity, arena);
+  obj_info->pedestrian_properity = NULL;
+  freePayload(obj_info->text_properity, arena);
+  obj_info->text_properity = NULL;
+
+  if (obj_info->mask_properity) {
+    freePayload(obj_info->mask_properity->mask, arena);
+    freePayload(obj_info->mask_properity->mask_point, arena);
+    freePayload(obj_info->mask_properity->mask_rle, arena);
+    freePayload(obj_info->mask_properity, arena);
+    obj_info->mask_properity = NULL;
+  }
+}
+
+// returns true if the size changed
+template <typename MetaT, typename InfoT>
+bool reserveMeta(const uint32_t size, MetaT *meta, bool init) {
+  MetaStorage *storage = findStorage(meta->info);
+  if (storage == NULL) {
+    // info[] is reallocated when the size changes
+    if (meta->size == size) {
+      return false;
+    }
+    for (uint32_t i = 0; meta->info != NULL && i < meta->size; i++) {
+      freeInfo(&meta->info[i], NULL);
+    }
+    free(meta->info);
+    meta->size = size;
+    meta->info = size > 0 ? (InfoT *)malloc(sizeof(InfoT) * size) : NULL;
+    return true;
+  }
+
+  // a kept meta starts a new result in place
+  bool resized = meta->size != size;
+  if (!resized && !init) {
+    return false;
+  }
+  for (uint32_t i = 0; i < meta->size; i++) {
+    freeInfo(&meta->info[i], &storage->arena);
+  }
+  storage->arena.reset();
+  if (size > storage->capacity) {
+    takeStorage(meta->info);
+    free(meta->info);
+    meta->info = (InfoT *)calloc(size, sizeof(InfoT));
+    storage->capacity = size;
+    putStorage(meta->info, storage);
+  }
+  meta->size = size;
+  return resized;
+}
+
+template <typename MetaT, typename InfoT>
+void keepMeta(MetaT *meta, uint32_t capacity) {
+  CVI_TDL_FreeCpp(meta);
+  MetaStorage *storage = new MetaStorage();
+  storage->capacity = capacity > 0 ? capacity : 1;
+  meta->info = (InfoT *)calloc(storage->capacity, sizeof(InfoT));
+  putStorage(meta->info, storage);
+}
+
+template <typename MetaT>
+void *arenaAlloc(MetaT *meta, size_t bytes) {
+  MetaStorage *storage = findStorage(meta->info);
+  void *ptr = storage != NULL ? storage->arena.alloc(bytes) : NULL;
+  return ptr != NULL ? ptr : calloc(1, bytes);
+}
+
+template <typename MetaT>
+void metaFree(MetaT *meta, void *ptr) {
+  MetaStorage *storage = findStorage(meta->info);
+  freePayload(ptr, storage != NULL ? &storage->arena : NULL);
+}
+
+template <typename MetaT>
+void releaseMeta(MetaT *meta) {
+  if (meta->info == NULL) {
+    return;
+  }
+  MetaStorage *storage = takeStorage(meta->info);
+  for (uint32_t i = 0; i < meta->size; i++) {
+    freeInfo(&meta->info[i], storage != NULL ? &storage->arena : NULL);
+  }
+  delete storage;
+  free(meta->info);
+  meta->info = NULL;
+}
+}  // namespace
+
+void CVI_TDL_MetaReserve(const uint32_t size, cvtdl_face_t *face, bool init) {
+  if (reserveMeta<cvtdl_face_t, cvtdl_face_info_t>(size, face, init)) {
+    face->dms = NULL;
+  }
+}
+
+void CVI_TDL_MetaReserve(const uint32_t size, cvtdl_object_t *obj, bool init) {
+  reserveMeta<cvtdl_object_t, cvtdl_object_info_t>(size, obj, init);
+}
+
+void *CVI_TDL_MetaArenaAlloc(cvtdl_face_t *face, size_t bytes) { return arenaAlloc(face, bytes); }
+
+void *CVI_TDL_MetaArenaAlloc(cvtdl_object_t *obj, size_t bytes) { return arenaAlloc(obj, bytes); }
+
+void CVI_TDL_MetaFree(cvtdl_face_t *face, void *ptr) { metaFree(face, ptr); }
+
+void CVI_TDL_MetaFree(cvtdl_object_t *obj, void *ptr) { metaFree(obj, ptr); }
+
+void CVI_TDL_ReserveFaceMeta(cvtdl_face_t *face, uint32_t capacity) {
+  keepMeta<cvtdl_face_t, cvtdl_face_info_t>(face, capacity);
+}
+
+void CVI_TDL_ReserveObjectMeta(cvtdl_object_t *obj, uint32_t capacity) {
+  keepMeta<cvtdl_object_t, cvtdl_object_info_t>(obj, capacity);
+}
+
 // Free
 
 void CVI_TDL_FreeCpp(cvtdl_feature_t *feature) {
@@ -49,19 +239,10 @@ void CVI_TDL_FreeCpp(cvtdl_dms_t *dms) {
   CVI_TDL_FreeCpp(&dms->dms_od);
 }
 
-void CVI_TDL_FreeCpp(cvtdl_face_info_t *face_info) {
-  CVI_TDL_FreeCpp(&face_info->pts);
-  CVI_TDL_FreeCpp(&face_info->feature);
-}
+void CVI_TDL_FreeCpp(cvtdl_face_info_t *face_info) { freeInfo(face_info, NULL); }
 
 void CVI_TDL_FreeCpp(cvtdl_face_t *face) {
-  if (face->info) {
-    for (uint32_t i = 0; i < face->size; i++) {
-      CVI_TDL_FreeCpp(&face->info[i]);
-    }
-    free(face->info);
-    face->info = NULL;
-  }
+  releaseMeta(face);
   face->size = 0;
   face->width = 0;
   face->height = 0;
@@ -72,40 +253,10 @@ void CVI_TDL_FreeCpp(cvtdl_face_t *face) {
   }
 }
 
-void CVI_TDL_FreeCpp(cvtdl_object_info_t *obj_info) {
-  CVI_TDL_FreeCpp(&obj_info->feature);
-  if (obj_info->vehicle_properity) {
-    free(obj_info->vehicle_properity);
-    obj_info->vehicle_properity = NULL;
-  }
-
-  if (obj_info->pedestrian_properity) {
-    free(obj_info->pedestrian_properity);
-    obj_info->pedestrian_properity = NULL;
-  }
-
-  if (obj_info->mask_properity) {
-    if (obj_info->mask_properity->mask) {
-      free(obj_info->mask_properity->mask);
-      obj_info->mask_properity->mask = NULL;
-    }
-    if (obj_info->mask_properity->mask_point) {
-      free(obj_info->mask_properity->mask_point);
-      obj_info->mask_properity->mask_point = NULL;
-    }
-    free(obj_info->mask_properity);
-    obj_info->mask_properity = NULL;
-  }
-}
+void CVI_TDL_FreeCpp(cvtdl_object_info_t *obj_info) { freeInfo(obj_info, NULL); }
 
 void CVI_TDL_FreeCpp(cvtdl_object_t *obj) {
-  if (obj->info != NULL) {
-    for (uint32_t i = 0; i < obj->size; i++) {
-      CVI_TDL_FreeCpp(&obj->info[i]);
-    }
-    free(obj->info);
-    obj->info = NULL;
-  }
+  releaseMeta(obj);
   obj->size = 0;
   obj->width = 0;
   obj->height = 0;
@@ -143,13 +294,21 @@ void CVI_TDL_FreeCpp(cvtdl_class_meta_t *cls_meta) {
 
 void CVI_TDL_FreeCpp(cvtdl_seg_logits_t *seg_logits) {
   if (seg_logits->float_logits != NULL) {
-    delete seg_logits->float_logits;
+    delete[] seg_logits->float_logits;
     seg_logits->float_logits = NULL;
   }
   if (seg_logits->int_logits != NULL) {
     delete[] seg_logits->int_logits;
     seg_logits->int_logits = NULL;
   }
+  if (seg_logits->label_map != NULL) {
+    delete[] seg_logits->label_map;
+    seg_logits->label_map = NULL;
+  }
+  if (seg_logits->conf_map != NULL) {
+    delete[] seg_logits->conf_map;
+    seg_logits->conf_map = NULL;
+  }
   seg_logits->w = 0;
   seg_logits->h = 0;
   seg_logits->c = 0;
@@ -196,6 +355,8 @@ void CVI_TDL_FreeHandPoses(cvtdl_handpose21_meta_ts *handposes) { CVI_TDL_FreeCp
 
 void CVI_TDL_FreeClassMeta(cvtdl_class_meta_t *cls_meta) { CVI_TDL_FreeCpp(cls_meta); }
 
+void CVI_TDL_FreeSegLogits(cvtdl_seg_logits_t *seg_logits) { CVI_TDL_FreeCpp(seg_logits); }
+
 void CVI_TDL_FreeLane(cvtdl_lane_t *lane_meta) { CVI_TDL_FreeCpp(lane_meta); }
 
 void CVI_TDL_FreeClip(cvtdl_clip_feature *clip_meta) { CVI_TDL_FreeCpp(clip_meta); }
@@ -239,7 +400,44 @@ void CVI_TDL_CopyInfoCpp(const cvtdl_face_info_t *info, cvtdl_face_info_t *infoN
   infoNew->blurness = info->blurness;
 }
 
-void CVI_TDL_CopyInfoCpp(const cvtdl_object_info_t *info, cvtdl_object_info_t *infoNew) {
+// The size of a CVTDL_MASK_FORMAT_FULL mask is only known from the object meta, full_size is 0
+// when copying a single info and the full map is left out.
+static cvtdl_mask_meta *copyMaskMeta(const cvtdl_mask_meta *src, uint32_t full_size) {
+  cvtdl_mask_meta *dst = (cvtdl_mask_meta *)malloc(sizeof(cvtdl_mask_meta));
+  if (dst == nullptr) {
+    syslog(LOG_ERR, "malloc failed for mask_properity\n");
+    return nullptr;
+  }
+  *dst = *src;
+  dst->mask = NULL;
+  dst->mask_point = NULL;
+  dst->mask_rle = NULL;
+  uint32_t mask_size = src->mask_format == CVTDL_MASK_FORMAT_BBOX ? src->mask_w * src->mask_h
+                       : src->mask_format == CVTDL_MASK_FORMAT_FULL ? full_size
+                                                                     : 0;
+  if (src->mask != NULL && mask_size > 0) {
+    dst->mask = (uint8_t *)malloc(mask_size);
+    if (dst->mask) memcpy(dst->mask, src->mask, mask_size);
+  }
+  if (src->mask_point != NULL && src->mask_point_size > 0) {
+    dst->mask_point = (float *)malloc(sizeof(float) * 2 * src->mask_point_size);
+    if (dst->mask_point) {
+      memcpy(dst->mask_point, src->mask_point, sizeof(float) * 2 * src->mask_point_size);
+    }
+  }
+  if (src->mask_rle != NULL && src->mask_rle_size > 0) {
+    dst->mask_rle = (uint32_t *)malloc(sizeof(uint32_t) * src->mask_rle_size);
+    if (dst->mask_rle) {
+      memcpy(dst->mask_rle, src->mask_rle, sizeof(uint32_t) * src->mask_rle_size);
+    }
+  }
+  if (dst->mask_point == NULL) dst->mask_point_size = 0;
+  if (dst->mask_rle == NULL) dst->mask_rle_size = 0;
+  return dst;
+}
+
+static void copyObjectInfo(const cvtdl_object_info_t *info, cvtdl_object_info_t *infoNew,
+                           uint32_t mask_full_size) {
   memcpy(infoNew->name, info->name, sizeof(info->name));
   infoNew->unique_id = info->unique_id;
   infoNew->bbox = info->bbox;
@@ -249,6 +447,8 @@ void CVI_TDL_CopyInfoCpp(const cvtdl_object_info_t *info, cvtdl_object_info_t *i
   infoNew->adas_properity.dis = info->adas_properity.dis;
   infoNew->adas_properity.speed = info->adas_properity.speed;
   infoNew->adas_properity.state = info->adas_properity.state;
+  infoNew->ttc = info->ttc;
+  infoNew->ttc_confidence = info->ttc_confidence;
 
   // infoNew->human_angle = info->human_angle;
   // infoNew->aspect_ratio = info->aspect_ratio;
@@ -270,11 +470,12 @@ void CVI_TDL_CopyInfoCpp(const cvtdl_object_info_t *info, cvtdl_object_info_t *i
 
   if (info->vehicle_properity) {
     infoNew->vehicle_properity = (cvtdl_vehicle_meta *)malloc(sizeof(cvtdl_vehicle_meta));
-    infoNew->vehicle_properity->license_bbox = info->vehicle_properity->license_bbox;
-    memcpy(infoNew->vehicle_properity->license_char, info->vehicle_properity->license_char,
-           sizeof(info->vehicle_properity->license_char));
-    memcpy(infoNew->vehicle_properity->license_pts.x, info->vehicle_properity->license_pts.x,
-           4 * sizeof(float));
+    *infoNew->vehicle_properity = *info->vehicle_properity;
+  }
+
+  if (info->text_properity) {
+    infoNew->text_properity = (cvtdl_text_meta *)malloc(sizeof(cvtdl_text_meta));
+    *infoNew->text_properity = *info->text_properity;
   }
 
   if (info->pedestrian_properity) {
@@ -288,9 +489,17 @@ void CVI_TDL_CopyInfoCpp(const cvtdl_object_info_t *info, cvtdl_object_info_t *i
            sizeof(float) * 17);
   }
 
+  if (info->mask_properity) {
+    infoNew->mask_properity = copyMaskMeta(info->mask_properity, mask_full_size);
+  }
+
   infoNew->classes = info->classes;
 }
 
+void CVI_TDL_CopyInfoCpp(const cvtdl_object_info_t *info, cvtdl_object_info_t *infoNew) {
+  copyObjectInfo(info, infoNew, 0);
+}
+
 void CVI_TDL_CopyInfoCpp(const cvtdl_dms_od_info_t *info, cvtdl_dms_od_info_t *infoNew) {
   memcpy(infoNew->name, info->name, sizeof(info->name));
   infoNew->bbox = info->bbox;
@@ -340,11 +549,13 @@ void CVI_TDL_CopyObjectMeta(const cvtdl_object_t *src, cvtdl_object_t *dest) {
     dest->width = src->width;
     dest->height = src->height;
     dest->rescale_type = src->rescale_type;
+    dest->mask_width = src->mask_width;
+    dest->mask_height = src->mask_height;
     if (src->info) {
       dest->info = (cvtdl_object_info_t *)malloc(sizeof(cvtdl_object_info_t) * src->size);
       memset(dest->info, 0, sizeof(cvtdl_object_info_t) * src->size);
       for (uint32_t fid = 0; fid < src->size; fid++) {
-        CVI_TDL_CopyObjectInfo(&src->info[fid], &dest->info[fid]);
+        copyObjectInfo(&src->info[fid], &dest->info[fid], src->mask_width * src->mask_height);
       }
     }
   }
@@ -6,6 +6,7 @@
 #include "core/error_msg.hpp"
 #include "core/utils/vpss_helper.h"
 #include "utils/core_utils.hpp"
+#include "utils/result_channel.hpp"
 
 #ifndef NO_OPENCV
 #include "utils/face_utils.hpp"
@@ -532,4 +533,73 @@ CVI_S32 CVI_TDL_StbReadImage(const char *filepath, VIDEO_FRAME_INFO_S *frame,
   // stbi_image_free(stbi_data);
   // return img;
   return 0;
-}
\ No newline at end of file
+}
+
+CVI_S32 CVI_TDL_ResultChannel_Create(cvitdl_result_channel_t *channel, bool is_face) {
+  if (channel == nullptr) {
+    LOGE("channel is null\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  *channel = new cvitdl::ResultChannel(is_face);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_ResultChannel_Destroy(cvitdl_result_channel_t channel) {
+  delete static_cast<cvitdl::ResultChannel *>(channel);
+  return CVI_TDL_SUCCESS;
+}
+
+static CVI_S32 ResultChannelPublish(cvitdl_result_channel_t channel, void *meta, bool is_face) {
+  cvitdl::ResultChannel *ch = static_cast<cvitdl::ResultChannel *>(channel);
+  if (ch == nullptr || meta == nullptr || ch->isFace() != is_face) {
+    LOGE("invalid result channel or meta type\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  if (!ch->publish(meta)) {
+    LOGW("all result snapshots are held by readers, result dropped\n");
+    return CVI_TDL_FAILURE;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+static CVI_S32 ResultChannelAcquire(cvitdl_result_channel_t channel, const void **meta,
+                                    uint64_t *seq, bool is_face) {
+  cvitdl::ResultChannel *ch = static_cast<cvitdl::ResultChannel *>(channel);
+  if (ch == nullptr || meta == nullptr || ch->isFace() != is_face) {
+    LOGE("invalid result channel or meta type\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  *meta = ch->acquire(seq);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_ResultChannel_PublishObject(cvitdl_result_channel_t channel,
+                                            cvtdl_object_t *meta) {
+  return ResultChannelPublish(channel, meta, false);
+}
+
+CVI_S32 CVI_TDL_ResultChannel_PublishFace(cvitdl_result_channel_t channel, cvtdl_face_t *meta) {
+  return ResultChannelPublish(channel, meta, true);
+}
+
+CVI_S32 CVI_TDL_ResultChannel_AcquireObject(cvitdl_result_channel_t channel,
+                                            const cvtdl_object_t **meta, uint64_t *seq) {
+  return ResultChannelAcquire(channel, (const void **)meta, seq, false);
+}
+
+CVI_S32 CVI_TDL_ResultChannel_AcquireFace(cvitdl_result_channel_t channel,
+                                          const cvtdl_face_t **meta, uint64_t *seq) {
+  return ResultChannelAcquire(channel, (const void **)meta, seq, true);
+}
+
+CVI_S32 CVI_TDL_ResultChannel_Release(cvitdl_result_channel_t channel, const void *meta) {
+  cvitdl::ResultChannel *ch = static_cast<cvitdl::ResultChannel *>(channel);
+  if (ch == nullptr) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  if (meta != nullptr && !ch->release(meta)) {
+    LOGE("meta does not belong to this result channel\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  return CVI_TDL_SUCCESS;
+}
@@ -3,6 +3,7 @@
 #include "core/cvi_tdl_types_mem_internal.h"
 #include "cvi_deepsort_utils.hpp"
 #include "cvi_tdl_log.hpp"
+#include "trace.hpp"
 
 #include <algorithm>
 #include <cassert>
@@ -61,6 +62,7 @@ DeepSORT::DeepSORT(bool use_specific_counter) {
 DeepSORT::~DeepSORT() {}
 CVI_S32 DeepSORT::track_cross(cvtdl_object_t *obj, cvtdl_tracker_t *tracker, bool use_reid,
                               const cvtdl_counting_line_t *cross_line_t, const randomRect *rect) {
+  cvitdl::TraceScope trace("deepsort", "tracker");
   /** statistic what classes ID in bbox and tracker,
    *  and counting bbox number for each class */
 
@@ -500,6 +502,7 @@ CVI_S32 DeepSORT::track_impl(Tracking_Result &high_result, Tracking_Result &low_
 }
 CVI_S32 DeepSORT::byte_track(cvtdl_object_t *obj, cvtdl_tracker_t *tracker, bool use_reid,
                              float low_score, float high_score) {
+  cvitdl::TraceScope trace("deepsort", "tracker");
   /** statistic what classes ID in bbox and tracker,
    *  and counting bbox number for each class */
 
@@ -659,6 +662,7 @@ CVI_S32 DeepSORT::byte_track(cvtdl_object_t *obj, cvtdl_tracker_t *tracker, bool
   return CVI_TDL_SUCCESS;
 }
 CVI_S32 DeepSORT::track(cvtdl_object_t *obj, cvtdl_tracker_t *tracker, bool use_reid) {
+  cvitdl::TraceScope trace("deepsort", "tracker");
   /** statistic what classes ID in bbox and tracker,
    *  and counting bbox number for each class */
 
@@ -769,7 +773,50 @@ CVI_S32 DeepSORT::track(cvtdl_object_t *obj, cvtdl_tracker_t *tracker, bool use_
   return CVI_TDL_SUCCESS;
 }
 
+CVI_S32 DeepSORT::coast(cvtdl_tracker_t *tracker) {
+  cvitdl::TraceScope trace("deepsort", "tracker");
+  // check every tracker first, so a failure leaves all of them unchanged
+  for (const KalmanTracker &tracker_ : k_trackers) {
+    if (tracker_.tracker_state != k_tracker_state_e::MISS &&
+        tracker_.kalman_state != kalman_state_e::UPDATED) {
+      LOGE("tracker %lu is not updated, cannot coast\n", (unsigned long)tracker_.id);
+      return CVI_TDL_FAILURE;
+    }
+  }
+  std::vector<int> stable_idxes;
+  for (size_t i = 0; i < k_trackers.size(); i++) {
+    KalmanTracker &tracker_ = k_trackers[i];
+    if (tracker_.tracker_state == k_tracker_state_e::MISS) {
+      continue;
+    }
+    auto it_conf = specific_conf.find(tracker_.class_id);
+    cvtdl_deepsort_config_t *conf =
+        (it_conf != specific_conf.end()) ? &it_conf->second : &default_conf;
+    kf_.predict(tracker_.kalman_state, tracker_.x, tracker_.P, conf->kfilter_conf);
+    tracker_.kalman_state = kalman_state_e::UPDATED;
+    tracker_.ages_ += 1;
+    if (tracker_.tracker_state == k_tracker_state_e::ACCREDITATION) {
+      stable_idxes.push_back(static_cast<int>(i));
+    }
+  }
+
+  CVI_TDL_MemAlloc(static_cast<uint32_t>(stable_idxes.size()), tracker);
+  for (uint32_t i = 0; i < static_cast<uint32_t>(stable_idxes.size()); i++) {
+    const KalmanTracker &tracker_ = k_trackers[stable_idxes[i]];
+    BBOX t_bbox = tracker_.getBBox_TLWH();
+    tracker->info[i].id = tracker_.id;
+    tracker->info[i].state = cvtdl_trk_state_type_t::CVI_TRACKER_STABLE;
+    tracker->info[i].bbox.x1 = t_bbox(0);
+    tracker->info[i].bbox.y1 = t_bbox(1);
+    tracker->info[i].bbox.x2 = t_bbox(0) + t_bbox(2);
+    tracker->info[i].bbox.y2 = t_bbox(1) + t_bbox(3);
+    tracker->info[i].out_num = tracker_.out_nums;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
 CVI_S32 DeepSORT::track(cvtdl_face_t *face, cvtdl_tracker_t *tracker) {
+  cvitdl::TraceScope trace("deepsort", "tracker");
 #ifdef DEBUG_TRACK
   std::cout << "start to track,face num:" << face->size << std::endl;
   show_INFO_KalmanTrackers();
@@ -1823,6 +1870,17 @@ std::string DeepSORT::get_TrackersInfo_UnmatchedLastTime(std::string &str_info)
   return str_info;
 }
 
+uint64_t DeepSORT::memoryUsage() const {
+  uint64_t bytes = k_trackers.capacity() * sizeof(KalmanTracker);
+  for (const KalmanTracker &t : k_trackers) {
+    bytes += t.features.capacity() * sizeof(FEATURE);
+    for (const FEATURE &f : t.features) {
+      bytes += f.size() * sizeof(float);
+    }
+  }
+  return bytes;
+}
+
 CVI_S32 DeepSORT::get_trackers_inactive(cvtdl_tracker_t *tracker) const {
   std::vector<KalmanTracker> unmatched_trackers = get_Trackers_UnmatchedLastTime();
   if (unmatched_trackers.size() == 0) return CVI_TDL_SUCCESS;
@@ -39,6 +39,9 @@ class DeepSORT {
   CVI_S32 track_cross(cvtdl_object_t *obj, cvtdl_tracker_t *tracker, bool use_reid,
                       const cvtdl_counting_line_t *cross_line_t, const randomRect *rect);
   CVI_S32 track(cvtdl_face_t *face, cvtdl_tracker_t *tracker);
+  /* advance all tracks by their Kalman prediction on a frame without detections, the tracks are
+   * not counted as unmatched */
+  CVI_S32 coast(cvtdl_tracker_t *tracker);
   // byte track
 
   CVI_S32 byte_track(cvtdl_object_t *obj, cvtdl_tracker_t *tracker, bool use_reid,
@@ -72,6 +75,8 @@ class DeepSORT {
 
   CVI_S32 get_trackers_inactive(cvtdl_tracker_t *tracker) const;
   void set_timestamp(uint32_t ts) { current_timestamp_ = ts; }
+  /* heap bytes held by the trackers and their feature galleries */
+  uint64_t memoryUsage() const;
 
   /* DEBUG CODE */
   // TODO: refactor these functions.
@@ -17,6 +17,8 @@
 #include "core/utils/vpss_helper.h"
 #include "core_utils.hpp"
 #include "cvi_sys.h"
+#include "cvi_tdl_log.hpp"
+#include "requant_utils.hpp"
 
 namespace cvitdl {
 
@@ -48,26 +50,106 @@ int Stereo::inference(VIDEO_FRAME_INFO_S *frame1, VIDEO_FRAME_INFO_S *frame2,
   const TensorInfo &oinfo = getOutputTensorInfo(0);
   int byte_per_pixel = oinfo.tensor_size / oinfo.tensor_elem;
   float qscale_output = byte_per_pixel == 1 ? oinfo.qscale : 1;
+  int prev_pix_size = depth_logist->w * depth_logist->h;
   depth_logist->w = oinfo.shape.dim[2];
   depth_logist->h = oinfo.shape.dim[1];
   int pix_size = depth_logist->w * depth_logist->h;
-  if (depth_logist->int_logits != NULL) {
-    free(depth_logist->int_logits);
-    depth_logist->int_logits = NULL;
+  depth_logist->raw_is_int8 = byte_per_pixel == 1;
+  depth_logist->raw_qscale = qscale_output;
+  if (depth_logist->raw_is_int8) {
+    depth_logist->raw = getOutputRawPtr<int8_t>(0);
+  } else {
+    depth_logist->raw = getOutputRawPtr<float>(0);
   }
-  depth_logist->int_logits = (int8_t *)malloc(pix_size * sizeof(int8_t));
-  if (byte_per_pixel == 1) {
-    int8_t *int8_out_data = getOutputRawPtr<int8_t>(0);
-    for (int i = 0; i < pix_size; i++) {
-      depth_logist->int_logits[i] = static_cast<int8_t>(int8_out_data[i] * qscale_output);
+
+  if (!m_output.raw_only) {
+    ret = prepareLogits(depth_logist, prev_pix_size == pix_size ? pix_size : -1);
+    if (ret != CVI_TDL_SUCCESS) return ret;
+    if (depth_logist->raw_is_int8) {
+      RequantizeInt8(getOutputRawPtr<int8_t>(0), pix_size, qscale_output,
+                     depth_logist->int_logits);
+    } else {
+      RequantizeInt8(getOutputRawPtr<float>(0), pix_size, qscale_output,
+                     depth_logist->int_logits);
     }
-  } else {
-    float *float_out_data = getOutputRawPtr<float>(0);
-    for (int i = 0; i < pix_size; i++) {
-      depth_logist->int_logits[i] = static_cast<int8_t>(float_out_data[i] * qscale_output);
+  }
+  if (m_output.depth_lut != nullptr && m_output.metric_depth != nullptr) {
+    if (m_output.metric_depth_size < (uint32_t)pix_size) {
+      LOGE("metric depth buffer of %u floats is smaller than %d\n", m_output.metric_depth_size,
+           pix_size);
+      return CVI_TDL_ERR_INVALID_ARGS;
     }
+    outputMetricDepth(depth_logist, pix_size);
   }
   model_timer_.TicToc("post");
   return CVI_TDL_SUCCESS;
 }
+
+int Stereo::setOutput(const cvtdl_depth_output_t *output) {
+  if (output == nullptr) {
+    m_output = {};
+    return CVI_TDL_SUCCESS;
+  }
+  if ((output->buffer != nullptr && output->buffer_size == 0) ||
+      (output->metric_depth != nullptr && output->metric_depth_size == 0)) {
+    LOGE("depth output buffer without size\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  m_output = *output;
+  return CVI_TDL_SUCCESS;
+}
+
+// point int_logits at the caller buffer, or at an SDK buffer of pix_size bytes, reused when
+// reuse_size matches
+int Stereo::prepareLogits(cvtdl_depth_logits_t *depth_logist, int reuse_size) {
+  int pix_size = depth_logist->w * depth_logist->h;
+  if (depth_logist->int_logits != nullptr && depth_logist->int_logits == mp_user_logits) {
+    depth_logist->int_logits = nullptr;
+    reuse_size = -1;
+  }
+  if (m_output.buffer != nullptr) {
+    if (m_output.buffer_size < (uint32_t)pix_size) {
+      LOGE("depth buffer of %u bytes is smaller than %d\n", m_output.buffer_size, pix_size);
+      return CVI_TDL_ERR_INVALID_ARGS;
+    }
+    free(depth_logist->int_logits);
+    depth_logist->int_logits = m_output.buffer;
+    mp_user_logits = m_output.buffer;
+    return CVI_TDL_SUCCESS;
+  }
+  if (depth_logist->int_logits != nullptr && reuse_size == pix_size) {
+    return CVI_TDL_SUCCESS;
+  }
+  free(depth_logist->int_logits);
+  depth_logist->int_logits = (int8_t *)malloc(pix_size * sizeof(int8_t));
+  if (depth_logist->int_logits == nullptr) {
+    LOGE("failed to allocate depth logits\n");
+    return CVI_TDL_ERR_ALLOC_ION_FAIL;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+void Stereo::outputMetricDepth(const cvtdl_depth_logits_t *depth_logist, int pix_size) {
+  if (!m_output.raw_only) {
+    LookupDepth(depth_logist->int_logits, pix_size, m_output.depth_lut, m_output.metric_depth);
+    return;
+  }
+  if (depth_logist->raw_is_int8) {
+    // fold the requantization into the table
+    float lut[256];
+    int8_t levels[256], quant[256];
+    for (int v = 0; v < 256; v++) levels[v] = (int8_t)(v - 128);
+    RequantizeInt8(levels, 256, depth_logist->raw_qscale, quant);
+    for (int v = 0; v < 256; v++) lut[v] = m_output.depth_lut[quant[v] + 128];
+    LookupDepth((const int8_t *)depth_logist->raw, pix_size, lut, m_output.metric_depth);
+    return;
+  }
+  const float *raw = (const float *)depth_logist->raw;
+  int8_t chunk[1024];
+  for (int i = 0; i < pix_size; i += sizeof(chunk)) {
+    int n = std::min<int>(sizeof(chunk), pix_size - i);
+    RequantizeInt8(raw + i, n, depth_logist->raw_qscale, chunk);
+    LookupDepth(chunk, n, m_output.depth_lut, m_output.metric_depth + i);
+  }
+}
 }  // namespace cvitdl
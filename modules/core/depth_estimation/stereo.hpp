@@ -10,6 +10,15 @@ class Stereo final : public Core {
   virtual ~Stereo();
   int inference(VIDEO_FRAME_INFO_S *frame1, VIDEO_FRAME_INFO_S *frame2,
                 cvtdl_depth_logits_t *depth_logist);
+  int setOutput(const cvtdl_depth_output_t *output);
+
+ private:
+  int prepareLogits(cvtdl_depth_logits_t *depth_logist, int reuse_size);
+  void outputMetricDepth(const cvtdl_depth_logits_t *depth_logist, int pix_size);
+
+  cvtdl_depth_output_t m_output = {};
+  // the last caller buffer handed out as int_logits, never to be freed
+  int8_t *mp_user_logits = nullptr;
 
   //  private:
   //   virtual int setupInputPreprocess(std::vector<InputPreprecessSetup> *data) override;
@@ -0,0 +1,188 @@
+#include "face_anchor_table.hpp"
+
+#include <algorithm>
+
+#include "core/cvi_tdl_types_mem_internal.h"
+#include "core_utils.hpp"
+#include "rescale_utils.hpp"
+
+#define FACE_POINTS_SIZE 5
+
+namespace cvitdl {
+
+void SetRetinaFaceAnchors(const std::vector<anchor_box> &anchors, FaceAnchorLevel *level) {
+  level->cx.resize(anchors.size());
+  level->cy.resize(anchors.size());
+  level->w.resize(anchors.size());
+  level->h.resize(anchors.size());
+  for (size_t k = 0; k < anchors.size(); k++) {
+    level->w[k] = anchors[k].x2 - anchors[k].x1 + 1;
+    level->h[k] = anchors[k].y2 - anchors[k].y1 + 1;
+    level->cx[k] = anchors[k].x1 + 0.5f * (level->w[k] - 1.0f);
+    level->cy[k] = anchors[k].y1 + 0.5f * (level->h[k] - 1.0f);
+  }
+}
+
+void SetScrFDFaceAnchors(const std::vector<std::vector<float>> &grids, FaceAnchorLevel *level) {
+  level->cx.resize(grids.size());
+  level->cy.resize(grids.size());
+  level->w.assign(grids.size(), float(level->stride));
+  level->h.assign(grids.size(), float(level->stride));
+  for (size_t k = 0; k < grids.size(); k++) {
+    level->cx[k] = (grids[k][0] + grids[k][2]) / 2;
+    level->cy[k] = (grids[k][1] + grids[k][3]) / 2;
+  }
+}
+
+void DecodeRetinaFaceLevel(const FaceAnchorLevel &level, uint32_t level_idx, uint32_t batch,
+                           PROCESS process, bool hardhat, float threshold,
+                           std::vector<FaceCandidate> &candidates) {
+  const size_t count = level.count;
+  const float *score_blob = level.score + batch * level.score_step;
+  const float *bbox_blob = level.bbox + batch * level.bbox_step;
+
+  for (int num = 0; num < level.num_anchor; num++) {
+    const float *conf_plane = score_blob + count * num;
+    const float *hardhat_plane = conf_plane + level.score_step / 3;
+    // bbox_blob:b x (num_anchors*4) x h x w
+    const float *dx = bbox_blob + count * (num * 4);
+    const float *dy = dx + count;
+    const float *dw = dy + count;
+    const float *dh = dw + count;
+    for (size_t j = 0; j < count; j++) {
+      float conf = conf_plane[j];
+      float hardhat_score = -1;
+      if (hardhat) {
+        hardhat_score = hardhat_plane[j];
+        conf = std::min(conf + hardhat_score, 1.0f);
+      }
+      if (conf <= threshold) {
+        continue;
+      }
+      size_t k = j + count * num;
+      float width = level.w[k];
+      float height = level.h[k];
+      float pred_ctr_x, pred_ctr_y, half_w, half_h;
+      if (process == CAFFE) {
+        pred_ctr_x = dx[j] * width + level.cx[k];
+        pred_ctr_y = dy[j] * height + level.cy[k];
+        half_w = 0.5f * (FastExp(dw[j]) * width - 1.0f);
+        half_h = 0.5f * (FastExp(dh[j]) * height - 1.0f);
+      } else {
+        pred_ctr_x = dx[j] * 0.1f * width + level.cx[k] + 0.5f;
+        pred_ctr_y = dy[j] * 0.1f * height + level.cy[k] + 0.5f;
+        half_w = 0.5f * FastExp(dw[j] * 0.2f) * width;
+        half_h = 0.5f * FastExp(dh[j] * 0.2f) * height;
+      }
+
+      FaceCandidate cand;
+      cand.bbox.x1 = pred_ctr_x - half_w;
+      cand.bbox.y1 = pred_ctr_y - half_h;
+      cand.bbox.x2 = pred_ctr_x + half_w;
+      cand.bbox.y2 = pred_ctr_y + half_h;
+      cand.bbox.score = conf;
+      cand.hardhat_score = hardhat_score;
+      cand.level = level_idx;
+      cand.index = k;
+      candidates.push_back(cand);
+    }
+  }
+}
+
+void DecodeScrFDFaceLevel(const FaceAnchorLevel &level, uint32_t level_idx, uint32_t batch,
+                          float threshold, std::vector<FaceCandidate> &candidates) {
+  const size_t count = level.count;
+  const float stride = level.stride;
+  const float *score_blob = level.score + batch * level.score_step;
+  const float *bbox_blob = level.bbox + batch * level.bbox_step;
+
+  for (int num = 0; num < level.num_anchor; num++) {  // anchor index
+    const float *conf_plane = score_blob + count * num;
+    // bbox_blob:b x (num_anchors*4) x h x w
+    const float *left = bbox_blob + count * (num * 4);
+    const float *top = left + count;
+    const float *right = top + count;
+    const float *bottom = right + count;
+    for (size_t j = 0; j < count; j++) {  // j:grid index
+      float conf = conf_plane[j];
+      if (conf <= threshold) {
+        continue;
+      }
+      size_t k = j + count * num;
+      float grid_cx = level.cx[k];
+      float grid_cy = level.cy[k];
+
+      FaceCandidate cand;
+      cand.bbox.x1 = grid_cx - left[j] * stride;
+      cand.bbox.y1 = grid_cy - top[j] * stride;
+      cand.bbox.x2 = grid_cx + right[j] * stride;
+      cand.bbox.y2 = grid_cy + bottom[j] * stride;
+      cand.bbox.score = conf;
+      cand.hardhat_score = 0;
+      cand.level = level_idx;
+      cand.index = k;
+      candidates.push_back(cand);
+    }
+  }
+}
+
+void FaceCandidatesToMeta(std::vector<FaceCandidate> &candidates,
+                          std::vector<FaceCandidate> &candidates_nms,
+                          const std::vector<FaceAnchorLevel> &levels, uint32_t batch,
+                          float nms_threshold, bool rescale, int image_width, int image_height,
+                          int frame_width, int frame_height, cvtdl_face_t *facemeta) {
+  candidates_nms.clear();
+  NonMaximumSuppression(candidates, candidates_nms, nms_threshold, 'u');
+
+  facemeta->width = image_width;
+  facemeta->height = image_height;
+  if (candidates_nms.size() == 0) {
+    CVI_TDL_MemAlloc(0, facemeta);
+    return;
+  }
+  CVI_TDL_MemAllocInit(candidates_nms.size(), FACE_POINTS_SIZE, facemeta);
+  if (rescale) {
+    // Recover coordinate if internal vpss engine is used.
+    facemeta->width = frame_width;
+    facemeta->height = frame_height;
+  }
+
+  float ratio = 1;
+  float pad_width = 0;
+  float pad_height = 0;
+  for (uint32_t i = 0; i < facemeta->size; ++i) {
+    FaceCandidate &cand = candidates_nms[i];
+    cvtdl_face_info_t &info = facemeta->info[i];
+    clip_boxes(image_width, image_height, cand.bbox);
+    if (rescale) {
+      info.bbox = box_rescale_c(frame_width, frame_height, image_width, image_height, cand.bbox,
+                                &ratio, &pad_width, &pad_height);
+    } else {
+      info.bbox = cand.bbox;
+    }
+    info.hardhat_score = cand.hardhat_score;
+    info.pts.score = cand.bbox.score;
+
+    const FaceAnchorLevel &level = levels[cand.level];
+    if (level.landmark == nullptr) {
+      continue;
+    }
+    // landmark blob: b x (num_anchor * 10) x h x w
+    const size_t count = level.count;
+    const size_t num = cand.index / count;
+    const float *src = level.landmark + batch * level.landmark_step + num * 10 * count +
+                       cand.index % count;
+    const float cx = level.cx[cand.index];
+    const float cy = level.cy[cand.index];
+    const float w = level.w[cand.index];
+    const float h = level.h[cand.index];
+    for (int k = 0; k < FACE_POINTS_SIZE; ++k) {
+      float x = src[count * (k * 2)] * w + cx;
+      float y = src[count * (k * 2 + 1)] * h + cy;
+      info.pts.x[k] = rescale ? (x - pad_width) * ratio : x;
+      info.pts.y[k] = rescale ? (y - pad_height) * ratio : y;
+    }
+  }
+}
+
+}  // namespace cvitdl
@@ -0,0 +1,71 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "anchor_generator.h"
+#include "core/face/cvtdl_face_types.h"
+
+namespace cvitdl {
+
+/**
+ * Anchors of one FPN level, flattened once when the model is opened.
+ *
+ * Entries are stored in output tensor order (anchor-major, then feature map position), so entry k
+ * of the table belongs to element k of every score / regression channel. cx, cy is the landmark
+ * reference point and w, h the scale applied to the landmark offsets. The output tensors are
+ * resolved to raw pointers of batch 0 at the same time, batch b is at ptr + b * step.
+ */
+struct FaceAnchorLevel {
+  int stride = 0;
+  int num_anchor = 0;
+  int count = 0;
+  std::vector<float> cx;
+  std::vector<float> cy;
+  std::vector<float> w;
+  std::vector<float> h;
+
+  const float *score = nullptr;
+  const float *bbox = nullptr;
+  const float *landmark = nullptr;
+  size_t score_step = 0;
+  size_t bbox_step = 0;
+  size_t landmark_step = 0;
+};
+
+/* a decoded box before nms, landmarks are only decoded for the survivors */
+struct FaceCandidate {
+  cvtdl_bbox_t bbox;
+  float hardhat_score;
+  uint32_t level;
+  uint32_t index;
+};
+
+/* fill the table from the anchors_plane boxes of a retinaface level */
+void SetRetinaFaceAnchors(const std::vector<anchor_box> &anchors, FaceAnchorLevel *level);
+
+/* fill the table from the mmdet grid anchors of a scrfd level, offsets are in stride units */
+void SetScrFDFaceAnchors(const std::vector<std::vector<float>> &grids, FaceAnchorLevel *level);
+
+/**
+ * Append the boxes of one level and batch image whose score is above threshold to candidates.
+ * hardhat models keep the no hardhat and hardhat planes after the background plane, the face
+ * score is their sum.
+ */
+void DecodeRetinaFaceLevel(const FaceAnchorLevel &level, uint32_t level_idx, uint32_t batch,
+                           PROCESS process, bool hardhat, float threshold,
+                           std::vector<FaceCandidate> &candidates);
+void DecodeScrFDFaceLevel(const FaceAnchorLevel &level, uint32_t level_idx, uint32_t batch,
+                          float threshold, std::vector<FaceCandidate> &candidates);
+
+/**
+ * Run nms on candidates and write the survivors of one batch image into facemeta. Landmarks are
+ * decoded from the level tables straight into the output. Both vectors are only cleared, so they
+ * can be kept as members to avoid reallocating every frame.
+ */
+void FaceCandidatesToMeta(std::vector<FaceCandidate> &candidates,
+                          std::vector<FaceCandidate> &candidates_nms,
+                          const std::vector<FaceAnchorLevel> &levels, uint32_t batch,
+                          float nms_threshold, bool rescale, int image_width, int image_height,
+                          int frame_width, int frame_height, cvtdl_face_t *facemeta);
+
+}  // namespace cvitdl
@@ -1,14 +1,12 @@
 #include "retina_face.hpp"
-#include "retina_face_utils.hpp"
 
 #include "core/core/cvtdl_errno.h"
 #include "core/cvi_tdl_types_mem.h"
-#include "core/cvi_tdl_types_mem_internal.h"
+#include "core_utils.hpp"
 
 #define NAME_BBOX "face_rpn_bbox_pred_"
 #define NAME_SCORE "face_rpn_cls_prob_reshape_"
 #define NAME_LANDMARK "face_rpn_landmark_pred_"
-#define FACE_POINTS_SIZE 5
 
 #define MEAN_R 123
 #define MEAN_G 117
@@ -91,22 +89,42 @@ int RetinaFace::onModelOpened() {
 
   std::vector<std::vector<anchor_box>> anchors_fpn =
       generate_anchors_fpn(false, cfg, this->process_);
-  std::map<std::string, std::vector<anchor_box>> anchors_fpn_map;
-  for (size_t i = 0; i < anchors_fpn.size(); i++) {
-    std::string key = "stride" + std::to_string(m_feat_stride_fpn[i]) + suffix_info;
-    anchors_fpn_map[key] = anchors_fpn[i];
-    m_num_anchors[key] = anchors_fpn[i].size();
-  }
 
+  // flatten anchors and resolve the output tensors once, outputParser only walks raw arrays
+  bool add_landmark_process = (getNumOutputTensor() == 9);
+  m_levels.clear();
+  m_levels.resize(m_feat_stride_fpn.size());
   for (size_t i = 0; i < m_feat_stride_fpn.size(); i++) {
-    int stride = m_feat_stride_fpn[i];
-
-    std::string key = "stride" + std::to_string(m_feat_stride_fpn[i]) + suffix_info;
-    std::string bbox_str = NAME_BBOX + key;
-    CVI_SHAPE bbox_shape = getOutputShape(bbox_str.c_str());
-
-    m_anchors[bbox_str] =
-        anchors_plane(bbox_shape.dim[2], bbox_shape.dim[3], stride, anchors_fpn_map[key]);
+    FaceAnchorLevel &level = m_levels[i];
+    level.stride = m_feat_stride_fpn[i];
+    std::string key = "stride" + std::to_string(level.stride) + suffix_info;
+
+    const TensorInfo &bbox_info = getOutputTensorInfo(NAME_BBOX + key);
+    const TensorInfo &score_info = getOutputTensorInfo(NAME_SCORE + key);
+    int height = bbox_info.shape.dim[2];
+    int width = bbox_info.shape.dim[3];
+    level.count = width * height;
+    level.num_anchor = anchors_fpn[i].size();
+
+    std::vector<anchor_box> anchors = anchors_plane(height, width, level.stride, anchors_fpn[i]);
+    SetRetinaFaceAnchors(anchors, &level);
+
+    level.bbox_step = bbox_info.shape.dim[1] * bbox_info.shape.dim[2] * bbox_info.shape.dim[3];
+    level.bbox = bbox_info.get<float>();
+    level.score_step = score_info.shape.dim[1] * score_info.shape.dim[2] * score_info.shape.dim[3];
+    m_hardhat = (score_info.shape.dim[1] == 6);
+    if (m_hardhat) {
+      // let score as non face, face conf would be nohardhat + hardhat
+      level.score = score_info.get<float>() + level.score_step / 3;
+    } else {
+      level.score = score_info.get<float>() + level.score_step / 2;
+    }
+    if (add_landmark_process) {
+      const TensorInfo &landmark_info = getOutputTensorInfo(NAME_LANDMARK + key);
+      level.landmark_step =
+          landmark_info.shape.dim[1] * landmark_info.shape.dim[2] * landmark_info.shape.dim[3];
+      level.landmark = landmark_info.get<float>();
+    }
   }
   return CVI_TDL_SUCCESS;
 }
@@ -133,145 +151,18 @@ int RetinaFace::inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_face_t *meta) {
 void RetinaFace::outputParser(int image_width, int image_height, int frame_width, int frame_height,
                               cvtdl_face_t *meta) {
   CVI_SHAPE input_shape = getInputShape(0);
+  bool rescale = !hasSkippedVpssPreprocess();
   for (uint32_t b = 0; b < (uint32_t)input_shape.dim[0]; b++) {
-    std::vector<cvtdl_face_info_t> vec_bbox;
-    std::vector<cvtdl_face_info_t> vec_bbox_nms;
-    for (size_t i = 0; i < m_feat_stride_fpn.size(); i++) {
-      std::string key = "stride" + std::to_string(m_feat_stride_fpn[i]) + suffix_info;
-
-      std::string score_str = NAME_SCORE + key;
-      CVI_SHAPE score_shape = getOutputShape(score_str.c_str());
-      size_t score_size = score_shape.dim[1] * score_shape.dim[2] * score_shape.dim[3];
-      float *score_blob = getOutputRawPtr<float>(score_str.c_str()) + (b * score_size);
-
-      bool add_hardhat_score = (score_shape.dim[1] == 6);
-      float *hardhat_score_blob = 0;
-      float *nohardhat_score_blob = 0;
-
-      if (add_hardhat_score) {
-        // let score as non face, face conf would be 1 - score
-        // score_blob = score_blob;
-        hardhat_score_blob = score_blob + score_size / 3 * 2;
-        nohardhat_score_blob = score_blob + score_size / 3;
-      } else {
-        score_blob += score_size / 2;
-      }
-
-      std::string bbox_str = NAME_BBOX + key;
-      CVI_SHAPE blob_shape = getOutputShape(bbox_str.c_str());
-      size_t blob_size = blob_shape.dim[1] * blob_shape.dim[2] * blob_shape.dim[3];
-      float *bbox_blob = getOutputRawPtr<float>(bbox_str.c_str()) + (b * blob_size);
-
-      size_t output_number = getNumOutputTensor();
-      bool add_landmark_process = (output_number == 9);
-
-      float *landmark_blob = 0;
-      if (add_landmark_process) {
-        std::string landmark_str = NAME_LANDMARK + key;
-        CVI_SHAPE landmark_shape = getOutputShape(landmark_str.c_str());
-        size_t landmark_size =
-            landmark_shape.dim[1] * landmark_shape.dim[2] * landmark_shape.dim[3];
-        landmark_blob = getOutputRawPtr<float>(landmark_str.c_str()) + (b * landmark_size);
-      };
-      int width = blob_shape.dim[3];
-      int height = blob_shape.dim[2];
-      size_t count = width * height;
-      size_t num_anchor = m_num_anchors[key];
-
-      std::vector<anchor_box> anchors = m_anchors[bbox_str];
-      for (size_t num = 0; num < num_anchor; num++) {
-        for (size_t j = 0; j < count; j++) {
-          float conf = -1;
-          float hardhat_score = -1;
-          if (add_hardhat_score) {
-            hardhat_score = hardhat_score_blob[j + count * num];
-            conf = hardhat_score + nohardhat_score_blob[j + count * num];
-            conf = std::min(float(conf), float(1));
-          } else {
-            conf = score_blob[j + count * num];
-          }
-          if (conf <= m_model_threshold) {
-            continue;
-          }
-          cvtdl_face_info_t box;
-          memset(&box, 0, sizeof(box));
-          box.pts.size = 5;
-          box.pts.x = (float *)malloc(sizeof(float) * box.pts.size);
-          box.pts.y = (float *)malloc(sizeof(float) * box.pts.size);
-          box.bbox.score = conf;
-          box.hardhat_score = hardhat_score;
-
-          float dx = bbox_blob[j + count * (0 + num * 4)];
-          float dy = bbox_blob[j + count * (1 + num * 4)];
-          float dw = bbox_blob[j + count * (2 + num * 4)];
-          float dh = bbox_blob[j + count * (3 + num * 4)];
-          float regress[4] = {dx, dy, dw, dh};
-          bbox_pred(anchors[j + count * num], regress, box.bbox, this->process_);
-
-          if (add_landmark_process) {
-            for (size_t k = 0; k < box.pts.size; k++) {
-              box.pts.x[k] = landmark_blob[j + count * (num * 10 + k * 2)];
-              box.pts.y[k] = landmark_blob[j + count * (num * 10 + k * 2 + 1)];
-            }
-            landmark_pred(anchors[j + count * num], box.pts);
-          }
-          vec_bbox.push_back(box);
-        }
-      }
+    m_candidates.clear();
+    for (size_t i = 0; i < m_levels.size(); i++) {
+      DecodeRetinaFaceLevel(m_levels[i], i, b, process_, m_hardhat, m_model_threshold,
+                            m_candidates);
     }
-    // DO nms on output result
-    vec_bbox_nms.clear();
-    NonMaximumSuppression(vec_bbox, vec_bbox_nms, 0.4, 'u');
-    // Init face meta
     cvtdl_face_t *facemeta = &meta[b];
-    facemeta->width = image_width;
-    facemeta->height = image_height;
-    if (vec_bbox_nms.size() == 0) {
-      facemeta->size = vec_bbox_nms.size();
-      facemeta->info = NULL;
-      return;
-    }
-    CVI_TDL_MemAllocInit(vec_bbox_nms.size(), FACE_POINTS_SIZE, facemeta);
-    if (hasSkippedVpssPreprocess()) {
-      for (uint32_t i = 0; i < facemeta->size; ++i) {
-        clip_boxes(image_width, image_height, vec_bbox_nms[i].bbox);
-        facemeta->info[i].bbox.x1 = vec_bbox_nms[i].bbox.x1;
-        facemeta->info[i].bbox.x2 = vec_bbox_nms[i].bbox.x2;
-        facemeta->info[i].bbox.y1 = vec_bbox_nms[i].bbox.y1;
-        facemeta->info[i].bbox.y2 = vec_bbox_nms[i].bbox.y2;
-        facemeta->info[i].bbox.score = vec_bbox_nms[i].bbox.score;
-        facemeta->info[i].hardhat_score = vec_bbox_nms[i].hardhat_score;
-
-        for (int j = 0; j < FACE_POINTS_SIZE; ++j) {
-          facemeta->info[i].pts.x[j] = vec_bbox_nms[i].pts.x[j];
-          facemeta->info[i].pts.y[j] = vec_bbox_nms[i].pts.y[j];
-        }
-      }
-    } else {
-      // Recover coordinate if internal vpss engine is used.
-      facemeta->width = frame_width;
-      facemeta->height = frame_height;
+    FaceCandidatesToMeta(m_candidates, m_candidates_nms, m_levels, b, 0.4, rescale, image_width,
+                         image_height, frame_width, frame_height, facemeta);
+    if (rescale) {
       facemeta->rescale_type = m_vpss_config[0].rescale_type;
-      for (uint32_t i = 0; i < facemeta->size; ++i) {
-        clip_boxes(image_width, image_height, vec_bbox_nms[i].bbox);
-        cvtdl_face_info_t info =
-            info_rescale_c(image_width, image_height, frame_width, frame_height, vec_bbox_nms[i]);
-        facemeta->info[i].bbox.x1 = info.bbox.x1;
-        facemeta->info[i].bbox.x2 = info.bbox.x2;
-        facemeta->info[i].bbox.y1 = info.bbox.y1;
-        facemeta->info[i].bbox.y2 = info.bbox.y2;
-        facemeta->info[i].bbox.score = info.bbox.score;
-        facemeta->info[i].hardhat_score = info.hardhat_score;
-        for (int j = 0; j < FACE_POINTS_SIZE; ++j) {
-          facemeta->info[i].pts.x[j] = info.pts.x[j];
-          facemeta->info[i].pts.y[j] = info.pts.y[j];
-        }
-        CVI_TDL_FreeCpp(&info);
-      }
-    }
-    // Clear original bbox. bbox_nms does not need to free since it points to bbox.
-    for (size_t i = 0; i < vec_bbox.size(); ++i) {
-      CVI_TDL_FreeCpp(&vec_bbox[i].pts);
     }
   }
 }
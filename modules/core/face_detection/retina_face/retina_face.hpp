@@ -3,6 +3,7 @@
 #include "face_detection.hpp"
 
 #include "anchor_generator.h"
+#include "face_anchor_table.hpp"
 
 namespace cvitdl {
 
@@ -18,8 +19,11 @@ class RetinaFace final : public FaceDetectionBase {
   void outputParser(int image_width, int image_height, int frame_width, int frame_height,
                     cvtdl_face_t *meta);
   std::vector<int> m_feat_stride_fpn;
-  std::map<std::string, std::vector<anchor_box>> m_anchors;
-  std::map<std::string, int> m_num_anchors;
+  std::vector<FaceAnchorLevel> m_levels;
+  // score tensor has 6 channels per anchor pair when the model also predicts hardhat
+  bool m_hardhat = false;
+  std::vector<FaceCandidate> m_candidates;
+  std::vector<FaceCandidate> m_candidates_nms;
   PROCESS process_;
 };
 }  // namespace cvitdl
\ No newline at end of file
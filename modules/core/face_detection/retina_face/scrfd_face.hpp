@@ -3,6 +3,7 @@
 #include "face_detection.hpp"
 
 #include "anchor_generator.h"
+#include "face_anchor_table.hpp"
 
 namespace cvitdl {
 
@@ -18,12 +19,9 @@ class ScrFDFace : public FaceDetectionBase {
   void outputParser(int image_width, int image_height, int frame_width, int frame_height,
                     cvtdl_face_t *meta);
   std::vector<int> m_feat_stride_fpn;
-  // std::map<std::string, std::vector<anchor_box>> m_anchors;
-  // std::map<std::string, int> m_num_anchors;
-  std::map<int, std::vector<std::vector<float>>> fpn_anchors_;
-  std::map<int, std::map<std::string, std::string>>
-      fpn_out_nodes_;  //{stride:{"box":"xxxx","score":"xxx","landmark":"xxxx"}}
-  std::map<int, int> fpn_grid_anchor_num_;
+  std::vector<FaceAnchorLevel> m_levels;
+  std::vector<FaceCandidate> m_candidates;
+  std::vector<FaceCandidate> m_candidates_nms;
 
   PROCESS process_;
 };
@@ -206,12 +206,10 @@ void ThermalFace::outputParser(const int image_width, const int image_height, co
   meta->width = image_width;
   meta->height = image_height;
   meta->rescale_type = m_vpss_config[0].rescale_type;
+  CVI_TDL_MemAllocInit(vec_bbox_nms.size(), 0, meta);
   if (vec_bbox_nms.size() == 0) {
-    meta->size = vec_bbox_nms.size();
-    meta->info = NULL;
     return;
   }
-  CVI_TDL_MemAllocInit(vec_bbox_nms.size(), 0, meta);
   if (hasSkippedVpssPreprocess()) {
     for (uint32_t i = 0; i < meta->size; ++i) {
       clip_boxes(image_width, image_height, vec_bbox_nms[i].bbox);
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <stdio.h>
 #include "core/core/cvtdl_errno.h"
 #include "core/cvi_tdl_types_mem.h"
 #include "core_utils.hpp"
@@ -12,50 +13,16 @@
 #define FRAME_GAP 1.0
 // #define FPS 30
 
-void print_kps(std::vector<std::pair<float, float>> &kps, int index) {
-  for (uint32_t i = 0; i < kps.size(); i++) {
+void print_kps(const RingHistory<std::pair<float, float>, FALL_KPS_HISTORY> &kps, int index) {
+  for (int i = 0; i < kps.size(); i++) {
     printf("[%d] %d: %.2f, %.2f\n", index, i, kps[i].first, kps[i].second);
   }
 }
 
-FallDet::FallDet(int id) {
-  uid = id;
-  for (int i = 0; i < 4; i++) {
-    valid_list.push(0);
-  }
-
-  for (int i = 0; i < 3; i++) {
-    speed_caches.push(0);
-  }
-
-  for (int i = 0; i < 6; i++) {
-    statuses_cache.push(0);
-  }
-}
-
-int FallDet::elem_count(std::queue<int> &q) {
-  int num = 0;
-  int q_size = q.size();
-
-  for (int i = 0; i < q_size; i++) {
-    int val = q.front();
-    // printf("i: %d, val: %d\n", i, val);
-    q.pop();
-
-    num += val;
-    q.push(val);
-  }
-
-  // printf("elem_count: %d\n", num);
-
-  return num;
-}
+// the histories start zeroed, valid_list keeps detect() away from them until they are filled
+FallDet::FallDet(uint64_t id) : uid(id) {}
 
 bool FallDet::keypoints_useful(cvtdl_pose17_meta_t *kps_meta) {
-  if (history_neck.size() == FRAME_GAP + 3) {
-    history_neck.erase(history_neck.begin());
-    history_hip.erase(history_hip.begin());
-  }
   // printf("kps_meta->score[5]%f [6]%f [7]%f [8]%f\n", kps_meta->score[5], kps_meta->score[6],
   // kps_meta->score[11], kps_meta->score[12]);
   if (kps_meta->score[5] > SCORE_THRESHOLD && kps_meta->score[6] > SCORE_THRESHOLD &&
@@ -68,24 +35,24 @@ bool FallDet::keypoints_useful(cvtdl_pose17_meta_t *kps_meta) {
     std::pair<float, float> neck = std::make_pair(neck_x, neck_y);
     std::pair<float, float> hip = std::make_pair(hip_x, hip_y);
 
-    history_neck.push_back(neck);
-    history_hip.push_back(hip);
+    history_neck.push(neck);
+    history_hip.push(hip);
 
     // print_kps(history_neck, 0);
     // print_kps(history_hip, 1);
     return true;
 
   } else {
-    history_neck.push_back(std::make_pair(0, 0));
-    history_hip.push_back(std::make_pair(0, 0));
+    history_neck.push(std::make_pair(0.0f, 0.0f));
+    history_hip.push(std::make_pair(0.0f, 0.0f));
     // print_kps(history_neck, 0);
     // print_kps(history_hip, 1);
     return false;
   }
 }
 
-void FallDet::get_kps(std::vector<std::pair<float, float>> &val_list, int index, float *x,
-                      float *y) {
+void FallDet::get_kps(const RingHistory<std::pair<float, float>, FALL_KPS_HISTORY> &val_list,
+                      int index, float *x, float *y) {
   float tmp_x = 0;
   float tmp_y = 0;
 
@@ -113,11 +80,6 @@ float FallDet::body_box_calculation(cvtdl_bbox_t *bbox) {
   return (bbox->x2 - bbox->x1) / (bbox->y2 - bbox->y1);
 }
 
-void FallDet::update_queue(std::queue<int> &q, int val) {
-  q.pop();
-  q.push(val);
-}
-
 float FallDet::speed_detection(cvtdl_bbox_t *bbox, cvtdl_pose17_meta_t *kps_meta, float fps) {
   // printf("speed_detection fps: %.2f\n", fps);
   float neck_x_before, neck_y_before, neck_x_cur, neck_y_cur;
@@ -137,7 +99,8 @@ float FallDet::speed_detection(cvtdl_bbox_t *bbox, cvtdl_pose17_meta_t *kps_meta
 
   //   printf("delta_position: %.2f\n", delta_position);
 
-  std::vector<float> delta_val;
+  float delta_val[5];
+  int num_delta = 0;
 
   float box_w = bbox->x2 - bbox->x1;
   float box_h = bbox->y2 - bbox->y1;
@@ -151,7 +114,7 @@ float FallDet::speed_detection(cvtdl_bbox_t *bbox, cvtdl_pose17_meta_t *kps_meta
 
   float delta_body = sqrt(pow(box_w, 2) + pow(box_h, 2));
 
-  delta_val.push_back(delta_body);
+  delta_val[num_delta++] = delta_body;
 #ifdef DEBUG_FALL
   printf("delta_position: %.2f, delta_body: %.2f\n", delta_position, delta_body);
 #endif
@@ -165,7 +128,7 @@ float FallDet::speed_detection(cvtdl_bbox_t *bbox, cvtdl_pose17_meta_t *kps_meta
 #ifdef DEBUG_FALL
     printf("left_leg: %.2f\n", left_leg);
 #endif
-    delta_val.push_back(left_leg);
+    delta_val[num_delta++] = left_leg;
   }
 
   if (kps_meta->score[11] > SCORE_THRESHOLD && kps_meta->score[13] > SCORE_THRESHOLD &&
@@ -178,7 +141,7 @@ float FallDet::speed_detection(cvtdl_bbox_t *bbox, cvtdl_pose17_meta_t *kps_meta
 #ifdef DEBUG_FALL
     printf("right_leg: %.2f\n", right_leg);
 #endif
-    delta_val.push_back(right_leg);
+    delta_val[num_delta++] = right_leg;
   }
 
   if (kps_meta->score[6] > SCORE_THRESHOLD && kps_meta->score[8] > SCORE_THRESHOLD &&
@@ -191,7 +154,7 @@ float FallDet::speed_detection(cvtdl_bbox_t *bbox, cvtdl_pose17_meta_t *kps_meta
 #ifdef DEBUG_FALL
     printf("left_arm: %.2f\n", left_arm);
 #endif
-    delta_val.push_back(left_arm);
+    delta_val[num_delta++] = left_arm;
   }
 
   if (kps_meta->score[5] > SCORE_THRESHOLD && kps_meta->score[7] > SCORE_THRESHOLD &&
@@ -204,15 +167,15 @@ float FallDet::speed_detection(cvtdl_bbox_t *bbox, cvtdl_pose17_meta_t *kps_meta
 #ifdef DEBUG_FALL
     printf("right_arm: %.2f\n", right_arm);
 #endif
-    delta_val.push_back(right_arm);
+    delta_val[num_delta++] = right_arm;
   }
 
   double delta_sum = 0.0;
 
-  for (uint32_t i = 0; i < delta_val.size(); i++) {
+  for (int i = 0; i < num_delta; i++) {
     delta_sum += delta_val[i];
   }
-  double delta_mean = delta_sum / (float)delta_val.size();
+  double delta_mean = delta_sum / (float)num_delta;
 
 #ifdef DEBUG_FALL
   printf("delta_mean: %.2f\n", delta_mean);
@@ -225,12 +188,12 @@ float FallDet::speed_detection(cvtdl_bbox_t *bbox, cvtdl_pose17_meta_t *kps_meta
   float speed = 100.0 * delta_position / (delta_mean * (FRAME_GAP / fps));
 
   if (speed > SPEED_THRESHOLD) {
-    update_queue(speed_caches, 1);
+    speed_caches.push(1);
   } else {
-    update_queue(speed_caches, 0);
+    speed_caches.push(0);
   }
 
-  if (elem_count(speed_caches) >= 2) {
+  if (speed_caches.sum() >= 2) {
     is_moving = true;
   } else {
     is_moving = false;
@@ -293,9 +256,9 @@ int FallDet::action_analysis(float human_angle, float aspect_ratio, float moving
 }
 
 bool FallDet::alert_decision(int status) {
-  update_queue(statuses_cache, status);
+  statuses_cache.push(status);
 
-  if (elem_count(statuses_cache) >= 3) {
+  if (statuses_cache.sum() >= 3) {
     return true;
   } else {
     return false;
@@ -308,9 +271,9 @@ void FallDet::detect(cvtdl_object_info_t *meta, float fps) {
 #ifdef DEBUG_FALL
     printf("---------keypoints_useful----------\n");
 #endif
-    update_queue(valid_list, 1);
+    valid_list.push(1);
 
-    if (elem_count(valid_list) == 4) {
+    if (valid_list.sum() == valid_list.size()) {
       //   printf("into cal\n");
 
       float human_angle = human_orientation();
@@ -335,6 +298,6 @@ void FallDet::detect(cvtdl_object_info_t *meta, float fps) {
       }
     }
   } else {
-    update_queue(valid_list, 0);
+    valid_list.push(0);
   }
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "fall_det.hpp"
+#include "fall_history.hpp"
 
 // obj->info[i].track_state = cvtdl_trk_state_type_t::CVI_TRACKER_NEW;
 
@@ -10,6 +11,6 @@ class FallDetMonitor {
   int set_fps(float fps);
 
  private:
-  std::vector<FallDet> muti_person;
+  PersonTable<FallDet> muti_person;
   float FPS = 21.0;
-};
\ No newline at end of file
+};
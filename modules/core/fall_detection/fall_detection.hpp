@@ -1,34 +1,29 @@
 #pragma once
 #include "core/object/cvtdl_object_types.h"
-
-#include <deque>
-#include <iostream>
-#include <queue>
+#include "fall_history.hpp"
 
 #define HISTORY_UPDATE 30
 
-template <typename T, int MaxLen, typename Container = std::deque<T>>
-class FixedQueue : public std::queue<T, Container> {
- public:
-  void push(const T& value) {
-    if (this->size() == MaxLen) {
-      this->c.pop_front();
-    }
-    std::queue<T, Container>::push(value);
-  }
+struct FallMDPerson {
+  RingHistory<float, HISTORY_UPDATE> history_q_extra_pred_x;
+  RingHistory<float, HISTORY_UPDATE> history_q_extra_pred_y;
+  RingHistory<float, HISTORY_UPDATE> history_bbox_x1;
+  RingHistory<float, HISTORY_UPDATE> history_bbox_x2;
+  RingHistory<float, HISTORY_UPDATE> history_bbox_y1;
+  RingHistory<float, HISTORY_UPDATE> history_bbox_y2;
+  bool isFall = false;
+  int unmatched_times = 0;
 };
 
+// persons are told apart by unique_id, objects without a tracker all share the history of id 0
 class FallMD {
  public:
   FallMD();
   int detect(cvtdl_object_t* meta);
 
  private:
-  FixedQueue<float, HISTORY_UPDATE> history_q_extra_pred_x;
-  FixedQueue<float, HISTORY_UPDATE> history_q_extra_pred_y;
-  FixedQueue<float, HISTORY_UPDATE> history_bbox_x1;
-  FixedQueue<float, HISTORY_UPDATE> history_bbox_x2;
-  FixedQueue<float, HISTORY_UPDATE> history_bbox_y1;
-  FixedQueue<float, HISTORY_UPDATE> history_bbox_y2;
-  bool isFall;
+  void detect(cvtdl_object_info_t* info, FallMDPerson* person);
+
+  PersonTable<FallMDPerson> persons;
+  int MAX_UNMATCHED_TIME = HISTORY_UPDATE;
 };
@@ -0,0 +1,132 @@
+#pragma once
+#include <stdint.h>
+#include <type_traits>
+
+#define MAX_FALL_PERSONS 64
+
+/**
+ * Fixed-size history, always full. push() drops the oldest value, [0] is the oldest one.
+ * A running sum is kept for arithmetic types, it is exact for integer types only.
+ */
+template <typename T, int N>
+class RingHistory {
+ public:
+  explicit RingHistory(T init = T()) { fill(init); }
+
+  void fill(T val) {
+    for (int i = 0; i < N; i++) m_data[i] = val;
+    m_head = 0;
+    if constexpr (std::is_arithmetic<T>::value) m_sum = val * N;
+  }
+  void push(T val) {
+    if constexpr (std::is_arithmetic<T>::value) m_sum += val - m_data[m_head];
+    m_data[m_head] = val;
+    m_head = m_head + 1 == N ? 0 : m_head + 1;
+  }
+  T operator[](int i) const { return m_data[(m_head + i) % N]; }
+  T front() const { return m_data[m_head]; }
+  T back() const { return m_data[m_head == 0 ? N - 1 : m_head - 1]; }
+  T sum() const {
+    static_assert(std::is_arithmetic<T>::value, "no running sum for this type");
+    return m_sum;
+  }
+  static constexpr int size() { return N; }
+
+ private:
+  T m_data[N];
+  int m_head;
+  T m_sum = T();
+};
+
+/**
+ * Per-person state keyed by unique_id, at most MaxPersons at a time. Linear probing on a table
+ * of twice that size, removal shifts the following entries back so no tombstone is left.
+ * The states live in a fixed pool and never move, pointers stay valid until erase().
+ */
+template <typename State, int MaxPersons = MAX_FALL_PERSONS>
+class PersonTable {
+ public:
+  PersonTable() { clear(); }
+
+  void clear() {
+    for (int i = 0; i < SLOTS; i++) m_slots[i].pool_index = -1;
+    for (int i = 0; i < MaxPersons; i++) {
+      m_used[i] = false;
+      m_free[i] = MaxPersons - 1 - i;
+    }
+    m_num_free = MaxPersons;
+  }
+
+  State *find(uint64_t uid) {
+    int s = slot(uid);
+    return s < 0 ? nullptr : &m_pool[m_slots[s].pool_index];
+  }
+
+  /* returns the existing state of uid, or a new one set to init, nullptr when full */
+  State *insert(uint64_t uid, const State &init) {
+    int s = home(uid);
+    for (; m_slots[s].pool_index >= 0; s = (s + 1) & (SLOTS - 1)) {
+      if (m_slots[s].uid == uid) return &m_pool[m_slots[s].pool_index];
+    }
+    if (m_num_free == 0) return nullptr;
+    int index = m_free[--m_num_free];
+    m_slots[s].uid = uid;
+    m_slots[s].pool_index = index;
+    m_used[index] = true;
+    m_uids[index] = uid;
+    m_pool[index] = init;
+    return &m_pool[index];
+  }
+
+  void erase(uint64_t uid) {
+    int s = slot(uid);
+    if (s < 0) return;
+    m_used[m_slots[s].pool_index] = false;
+    m_free[m_num_free++] = m_slots[s].pool_index;
+    m_slots[s].pool_index = -1;
+    // move back every following entry whose home slot is not between the hole and itself
+    for (int next = (s + 1) & (SLOTS - 1); m_slots[next].pool_index >= 0;
+         next = (next + 1) & (SLOTS - 1)) {
+      int h = home(m_slots[next].uid);
+      bool keep = s <= next ? (s < h && h <= next) : (s < h || h <= next);
+      if (keep) continue;
+      m_slots[s] = m_slots[next];
+      m_slots[next].pool_index = -1;
+      s = next;
+    }
+  }
+
+  /* pool access for iterating the persons, erase() during the iteration is allowed */
+  static constexpr int capacity() { return MaxPersons; }
+  bool used(int i) const { return m_used[i]; }
+  State &at(int i) { return m_pool[i]; }
+  uint64_t uid(int i) const { return m_uids[i]; }
+  int index(const State *state) const { return (int)(state - m_pool); }
+  int size() const { return MaxPersons - m_num_free; }
+
+ private:
+  static constexpr int SLOTS = 2 * MaxPersons;
+  static_assert((SLOTS & (SLOTS - 1)) == 0, "MaxPersons must be a power of two");
+
+  static int home(uint64_t uid) {
+    return (int)((uid * 0x9E3779B97F4A7C15ull) >> 32) & (SLOTS - 1);
+  }
+
+  int slot(uint64_t uid) const {
+    for (int s = home(uid); m_slots[s].pool_index >= 0; s = (s + 1) & (SLOTS - 1)) {
+      if (m_slots[s].uid == uid) return s;
+    }
+    return -1;
+  }
+
+  struct Slot {
+    uint64_t uid;
+    int pool_index;
+  };
+  Slot m_slots[SLOTS];
+  State m_pool[MaxPersons];
+  bool m_used[MaxPersons];
+  uint64_t m_uids[MaxPersons];
+  int m_free[MaxPersons];
+  int m_num_free;
+};
@@ -3,7 +3,6 @@
 #include <cmath>
 #include <iterator>
 
-#include <iostream>
 #include "coco_utils.hpp"
 #include "core/core/cvtdl_errno.h"
 #include "core/cvi_tdl_types_mem.h"
@@ -11,6 +10,7 @@
 #include "core_utils.hpp"
 #include "cvi_sys.h"
 #include "hrnet.hpp"
+#include "keypoint_utils.hpp"
 #include "object_utils.hpp"
 
 // #define R_SCALE (float)(1.0 / 58.395)
@@ -23,6 +23,8 @@
 #define NUM_KEYPOINTS 17
 #define EXPAND_RATIO 2.0f
 #define MAX_NUM 20
+// Gaussian kernel of the DARK refinement for heatmaps of sigma 2
+#define DARK_BLUR_KERNEL 11
 
 namespace cvitdl {
 
@@ -37,16 +39,7 @@ Hrnet::Hrnet() {
   m_preprocess_param[0].format = PIXEL_FORMAT_RGB_888_PLANAR;
   m_preprocess_param[0].rescale_type = RESCALE_NOASPECT;
   m_model_threshold = 0.3f;
-}
-
-float getSignedValue(float value) {
-  if (value < 0) {
-    return -1.0;
-  } else if (value == 0.0) {
-    return 0.0;
-  } else {
-    return 1.0;
-  }
+  m_keypoint_refine = CVTDL_KEYPOINT_REFINE_DARK;
 }
 
 int Hrnet::inference(VIDEO_FRAME_INFO_S *stOutFrame, cvtdl_object_t *obj_meta) {
@@ -106,64 +99,31 @@ void Hrnet::outputParser(const float nn_width, const float nn_height, const int
   CVI_SHAPE output_shape = oinfo.shape;
 
   int num_per_pixel = oinfo.tensor_size / oinfo.tensor_elem;
-  float qscale = num_per_pixel == 1 ? oinfo.qscale : 1;
 
-  obj->info[index].pedestrian_properity =
-      (cvtdl_pedestrian_meta *)malloc(sizeof(cvtdl_pedestrian_meta));
-  int batch_size = output_shape.dim[0];
-  int num_joints = output_shape.dim[1];
+  if (obj->info[index].pedestrian_properity == NULL) {
+    obj->info[index].pedestrian_properity =
+        (cvtdl_pedestrian_meta *)CVI_TDL_MetaArenaAlloc(obj, sizeof(cvtdl_pedestrian_meta));
+  }
+  // a single crop per run, heatmaps are num_joints x height x width
+  int num_joints = std::min((int)output_shape.dim[1], NUM_KEYPOINTS);
   int height = output_shape.dim[2];
   int width = output_shape.dim[3];
 
-  if (qscale == 1) {
-    float *ptr_float = static_cast<float *>(oinfo.raw_pointer);
-    getMaxPreds(batch_size, num_joints, height, width, ptr_float, preds, maxvals, qscale);
-    for (int i = 0; i < num_joints; i++) {
-      int row = static_cast<int>(std::floor(preds[2 * i] + 0.5));
-      int col = static_cast<int>(std::floor(preds[2 * i + 1] + 0.5));
-      if (1 < col && col < width - 1 && 1 < row && row < height - 1) {
-        float diff_x = ptr_float[i * height * width + row * width + col + 1] * qscale -
-                       ptr_float[i * height * width + row * width + col - 1] * qscale;
-        float diff_y = ptr_float[i * height * width + (row + 1) * width + col] * qscale -
-                       ptr_float[i * height * width + (row - 1) * width + col] * qscale;
-        std::cout << "before" << preds[2 * i] << "," << preds[2 * i + 1] << std::endl;
-
-        diff_x = getSignedValue(diff_x);
-        diff_y = getSignedValue(diff_y);
-        preds[2 * i] += diff_x * 0.25;
-        preds[2 * i + 1] += diff_y * 0.25;
-
-        std::cout << "after" << preds[2 * i] << "," << preds[2 * i + 1] << std::endl;
-        std::cout << preds[2 * i] << "," << preds[2 * i + 1] << std::endl;
-        std::cout << "float ptr: diff_x=" << diff_x * 0.25 << ", diff_y=" << diff_y << std::endl;
-      }
-      obj->info[index].pedestrian_properity->pose_17.x[i] = preds[2 * i + 1] * 4;
-      obj->info[index].pedestrian_properity->pose_17.y[i] = preds[2 * i] * 4;
-      obj->info[index].pedestrian_properity->pose_17.score[i] = maxvals[i];
-    }
+  KeypointPeak peaks[NUM_KEYPOINTS];
+  if (num_per_pixel == 1) {
+    DecodeHeatmaps(static_cast<int8_t *>(oinfo.raw_pointer), oinfo.qscale, num_joints, height,
+                   width, m_keypoint_refine, DARK_BLUR_KERNEL, peaks);
   } else {
-    int8_t *ptr_int8 = static_cast<int8_t *>(oinfo.raw_pointer);
-    getMaxPreds(batch_size, num_joints, height, width, ptr_int8, preds, maxvals, qscale);
-    for (int i = 0; i < num_joints; i++) {
-      int row = static_cast<int>(std::floor(preds[2 * i] + 0.5));
-      int col = static_cast<int>(std::floor(preds[2 * i + 1] + 0.5));
-      if (1 < col && col < width - 1 && 1 < row && row < height - 1) {
-        float diff_x = ptr_int8[i * height * width + row * width + col + 1] * qscale -
-                       ptr_int8[i * height * width + row * width + col - 1] * qscale;
-        float diff_y = ptr_int8[i * height * width + (row + 1) * width + col] * qscale -
-                       ptr_int8[i * height * width + (row - 1) * width + col] * qscale;
-        diff_x = getSignedValue(diff_x);
-        diff_y = getSignedValue(diff_y);
-        std::cout << "before" << preds[2 * i] << "," << preds[2 * i + 1] << std::endl;
-        preds[2 * i] += diff_x * 0.25;
-        preds[2 * i + 1] += diff_y * 0.25;
-        std::cout << "after" << preds[2 * i] << "," << preds[2 * i + 1] << std::endl;
-        std::cout << "int ptr: diff_x=" << diff_x * 0.25 << ", diff_y=" << diff_y << std::endl;
-      }
-      obj->info[index].pedestrian_properity->pose_17.x[i] = preds[2 * i + 1] * 4;
-      obj->info[index].pedestrian_properity->pose_17.y[i] = preds[2 * i] * 4;
-      obj->info[index].pedestrian_properity->pose_17.score[i] = maxvals[i];
-    }
+    DecodeHeatmaps(static_cast<float *>(oinfo.raw_pointer), num_joints, height, width,
+                   m_keypoint_refine, DARK_BLUR_KERNEL, peaks);
+  }
+  // heatmap to network input coordinates
+  const float stride_x = nn_width / width;
+  const float stride_y = nn_height / height;
+  for (int i = 0; i < num_joints; i++) {
+    obj->info[index].pedestrian_properity->pose_17.x[i] = peaks[i].x * stride_x;
+    obj->info[index].pedestrian_properity->pose_17.y[i] = peaks[i].y * stride_y;
+    obj->info[index].pedestrian_properity->pose_17.score[i] = peaks[i].score;
   }
 
   float scale_ratio, pad_w, pad_h;
@@ -187,34 +147,4 @@ void Hrnet::outputParser(const float nn_width, const float nn_height, const int
   }
 }
 
-template <typename T>
-void Hrnet::getMaxPreds(int batch_size, int num_joints, int height, int width, T *ptr_data,
-                        std::vector<float> &preds, std::vector<float> &maxvals, float qscale) {
-  preds.clear();
-  maxvals.clear();
-  for (int i = 0; i < batch_size; i++) {
-    for (int j = 0; j < num_joints; j++) {
-      float maxval = 0.0;
-      float maxrow = 0;
-      float maxcol = 0;
-      for (int h = 0; h < height; h++) {
-        for (int w = 0; w < width; w++) {
-          float val =
-              ptr_data[i * num_joints * height * width + j * height * width + h * width + w] *
-              qscale;
-          if (val > maxval) {
-            maxval = val;
-            maxrow = h * 1.0;
-            maxcol = w * 1.0;
-          }
-        }
-      }
-      maxvals.push_back(maxval);
-      preds.push_back(maxrow);
-      preds.push_back(maxcol);
-      // std::cout<<"row: "<<maxrow<<", col: "<<maxcol<<std::endl;
-    }
-  }
-}
-
 }  // namespace cvitdl
\ No newline at end of file
@@ -14,11 +14,5 @@ class Hrnet final : public PoseDetectionBase {
   void outputParser(const float nn_width, const float nn_height, const int frame_width,
                     const int frame_height, cvtdl_object_t *obj, std::vector<float> &box,
                     int index);
-  template <typename T>
-  void getMaxPreds(int batch_size, int num_joints, int height, int width, T *ptr_data,
-                   std::vector<float> &preds, std::vector<float> &maxvals, float qscale);
-
-  std::vector<float> preds;
-  std::vector<float> maxvals;
 };
 }  // namespace cvitdl
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include "core/cvi_tdl_types_mem_internal.h"
 #include "core_utils.hpp"
 #include "cvi_sys.h"
+#include "keypoint_utils.hpp"
 #include "object_utils.hpp"
 #include "simcc.hpp"
 
@@ -93,25 +94,18 @@ void Simcc::outputParser(const float nn_width, const float nn_height, const int
   CVI_SHAPE output0_shape = getOutputShape(0);
   CVI_SHAPE output1_shape = getOutputShape(1);
 
-  obj->info[index].pedestrian_properity =
-      (cvtdl_pedestrian_meta *)malloc(sizeof(cvtdl_pedestrian_meta));
+  if (obj->info[index].pedestrian_properity == NULL) {
+    obj->info[index].pedestrian_properity =
+        (cvtdl_pedestrian_meta *)CVI_TDL_MetaArenaAlloc(obj, sizeof(cvtdl_pedestrian_meta));
+  }
 
+  KeypointPeak peaks[NUM_KEYPOINTS];
+  DecodeSimCC(data_x, output0_shape.dim[2], data_y, output1_shape.dim[2], NUM_KEYPOINTS,
+              EXPAND_RATIO, m_keypoint_refine, peaks);
   for (int i = 0; i < NUM_KEYPOINTS; i++) {
-    float *score_start_x = data_x + i * output0_shape.dim[2];
-    float *score_end_x = data_x + (i + 1) * output0_shape.dim[2];
-    auto iter_x = std::max_element(score_start_x, score_end_x);
-    uint32_t pos_x = iter_x - score_start_x;
-    float score_x = *iter_x;
-
-    float *score_start_y = data_y + i * output1_shape.dim[2];
-    float *score_end_y = data_y + (i + 1) * output1_shape.dim[2];
-    auto iter_y = std::max_element(score_start_y, score_end_y);
-    uint32_t pos_y = iter_y - score_start_y;
-    float score_y = *iter_y;
-
-    obj->info[index].pedestrian_properity->pose_17.x[i] = (float)pos_x / EXPAND_RATIO;
-    obj->info[index].pedestrian_properity->pose_17.y[i] = (float)pos_y / EXPAND_RATIO;
-    obj->info[index].pedestrian_properity->pose_17.score[i] = std::min(score_x, score_y);
+    obj->info[index].pedestrian_properity->pose_17.x[i] = peaks[i].x;
+    obj->info[index].pedestrian_properity->pose_17.y[i] = peaks[i].y;
+    obj->info[index].pedestrian_properity->pose_17.score[i] = peaks[i].score;
   }
 
   float scale_ratio, pad_w, pad_h;
@@ -288,7 +288,7 @@ void YoloV8Pose::postProcess(Detections &dets, int frame_width, int frame_height
     obj->info[i].classes = final_dets[i]->label;
 
     obj->info[i].pedestrian_properity =
-        (cvtdl_pedestrian_meta *)malloc(sizeof(cvtdl_pedestrian_meta));
+        (cvtdl_pedestrian_meta *)CVI_TDL_MetaArenaAlloc(obj, sizeof(cvtdl_pedestrian_meta));
 
     std::pair<int, int> final_ids = valild_pairs[keep[i]];
 
@@ -0,0 +1,121 @@
+#include "seg_mask_engine.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include "cvi_tdl_log.hpp"
+
+namespace cvitdl {
+
+void SegMaskEngine::setProto(const int8_t *proto_int8, const float *proto_float, int c, int h,
+                             int w) {
+  m_proto_int8 = proto_int8;
+  m_proto_float = proto_float;
+  m_c = c;
+  m_h = h;
+  m_w = w;
+}
+
+template <typename CoeffT, typename ProtoT, typename AccT>
+void SegMaskEngine::accumulate(const CoeffT *coeff, const ProtoT *proto, int x1, int y1,
+                               int box_w, int box_h, AccT *acc) {
+  std::fill(acc, acc + box_w * box_h, AccT(0));
+  const int proto_hw = m_h * m_w;
+  /* channel outer loop keeps the inner loop a contiguous multiply-add the compiler vectorizes */
+  for (int c = 0; c < m_c; c++) {
+    const AccT k = static_cast<AccT>(coeff[c]);
+    if (k == 0) continue;
+    const ProtoT *plane = proto + c * proto_hw + y1 * m_w + x1;
+    for (int y = 0; y < box_h; y++) {
+      const ProtoT *src = plane + y * m_w;
+      AccT *dst = acc + y * box_w;
+      for (int x = 0; x < box_w; x++) {
+        dst[x] += k * static_cast<AccT>(src[x]);
+      }
+    }
+  }
+}
+
+template <typename AccT>
+void SegMaskEngine::writeMask(const AccT *acc, int x1, int y1, int box_w, int box_h,
+                              cvtdl_mask_format_e format, cvtdl_mask_meta *mask_meta) {
+  free(mask_meta->mask);
+  mask_meta->mask = NULL;
+  free(mask_meta->mask_rle);
+  mask_meta->mask_rle = NULL;
+  mask_meta->mask_rle_size = 0;
+  mask_meta->mask_format = format;
+  mask_meta->mask_x = x1;
+  mask_meta->mask_y = y1;
+  mask_meta->mask_w = box_w;
+  mask_meta->mask_h = box_h;
+
+  if (format == CVTDL_MASK_FORMAT_FULL) {
+    mask_meta->mask = (uint8_t *)calloc(m_h * m_w, sizeof(uint8_t));
+    for (int y = 0; y < box_h; y++) {
+      const AccT *src = acc + y * box_w;
+      uint8_t *dst = mask_meta->mask + (y1 + y) * m_w + x1;
+      for (int x = 0; x < box_w; x++) {
+        dst[x] = src[x] >= 0 ? 255 : 0;
+      }
+    }
+  } else if (format == CVTDL_MASK_FORMAT_BBOX) {
+    mask_meta->mask = (uint8_t *)malloc(std::max(box_w * box_h, 1));
+    for (int i = 0; i < box_w * box_h; i++) {
+      mask_meta->mask[i] = acc[i] >= 0 ? 255 : 0;
+    }
+  } else {
+    m_runs.clear();
+    bool fg = false;
+    uint32_t run = 0;
+    for (int i = 0; i < box_w * box_h; i++) {
+      bool v = acc[i] >= 0;
+      if (v != fg) {
+        m_runs.push_back(run);
+        run = 0;
+        fg = v;
+      }
+      run++;
+    }
+    m_runs.push_back(run);
+    mask_meta->mask_rle_size = m_runs.size();
+    mask_meta->mask_rle = (uint32_t *)malloc(m_runs.size() * sizeof(uint32_t));
+    memcpy(mask_meta->mask_rle, m_runs.data(), m_runs.size() * sizeof(uint32_t));
+  }
+}
+
+void SegMaskEngine::decode(const int8_t *coeff_int8, const float *coeff_float, int coeff_step,
+                           int x1, int y1, int x2, int y2, cvtdl_mask_format_e format,
+                           cvtdl_mask_meta *mask_meta) {
+  x1 = std::max(std::min(x1, m_w), 0);
+  x2 = std::max(std::min(x2, m_w), x1);
+  y1 = std::max(std::min(y1, m_h), 0);
+  y2 = std::max(std::min(y2, m_h), y1);
+  int box_w = x2 - x1;
+  int box_h = y2 - y1;
+
+  if (coeff_int8 != nullptr && m_proto_int8 != nullptr) {
+    m_coeff_int8.resize(m_c);
+    for (int c = 0; c < m_c; c++) m_coeff_int8[c] = coeff_int8[c * coeff_step];
+    m_acc_int.resize(box_w * box_h);
+    accumulate(m_coeff_int8.data(), m_proto_int8, x1, y1, box_w, box_h, m_acc_int.data());
+    writeMask(m_acc_int.data(), x1, y1, box_w, box_h, format, mask_meta);
+    return;
+  }
+
+  /* mixed or float tensors: scales do not matter for the sign, only the raw values are used */
+  m_coeff_float.resize(m_c);
+  for (int c = 0; c < m_c; c++) {
+    m_coeff_float[c] =
+        coeff_int8 != nullptr ? coeff_int8[c * coeff_step] : coeff_float[c * coeff_step];
+  }
+  m_acc_float.resize(box_w * box_h);
+  if (m_proto_int8 != nullptr) {
+    accumulate(m_coeff_float.data(), m_proto_int8, x1, y1, box_w, box_h, m_acc_float.data());
+  } else {
+    accumulate(m_coeff_float.data(), m_proto_float, x1, y1, box_w, box_h, m_acc_float.data());
+  }
+  writeMask(m_acc_float.data(), x1, y1, box_w, box_h, format, mask_meta);
+}
+
+}  // namespace cvitdl
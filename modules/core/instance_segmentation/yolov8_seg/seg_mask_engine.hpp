@@ -0,0 +1,47 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "core/object/cvtdl_object_types.h"
+
+namespace cvitdl {
+
+/**
+ * Assemble instance masks from YOLO-style prototype maps.
+ *
+ * mask = sigmoid(coeff x proto) >= 0.5 is evaluated as coeff x proto >= 0 (logit domain), so no
+ * exp is needed and the quantization scales of both tensors cancel out. The product is only
+ * computed inside the (proto stride scaled) box of each instance. When both tensors are int8 the
+ * dot products are accumulated in int32 directly on the raw tensors.
+ */
+class SegMaskEngine {
+ public:
+  /* proto is c x h x w, exactly one of proto_int8 / proto_float is valid */
+  void setProto(const int8_t *proto_int8, const float *proto_float, int c, int h, int w);
+
+  /* coefficients of one instance, exactly one of coeff_int8 / coeff_float is valid, elements of
+   * channel i are at coeff[i * coeff_step] */
+  void decode(const int8_t *coeff_int8, const float *coeff_float, int coeff_step, int x1, int y1,
+              int x2, int y2, cvtdl_mask_format_e format, cvtdl_mask_meta *mask_meta);
+
+ private:
+  template <typename CoeffT, typename ProtoT, typename AccT>
+  void accumulate(const CoeffT *coeff, const ProtoT *proto, int x1, int y1, int box_w, int box_h,
+                  AccT *acc);
+  template <typename AccT>
+  void writeMask(const AccT *acc, int x1, int y1, int box_w, int box_h,
+                 cvtdl_mask_format_e format, cvtdl_mask_meta *mask_meta);
+
+  const int8_t *m_proto_int8 = nullptr;
+  const float *m_proto_float = nullptr;
+  int m_c = 0;
+  int m_h = 0;
+  int m_w = 0;
+
+  std::vector<int8_t> m_coeff_int8;
+  std::vector<float> m_coeff_float;
+  std::vector<int32_t> m_acc_int;
+  std::vector<float> m_acc_float;
+  std::vector<uint32_t> m_runs;
+};
+
+}  // namespace cvitdl
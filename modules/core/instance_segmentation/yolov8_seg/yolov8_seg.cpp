@@ -8,7 +8,6 @@
 #include <error_msg.hpp>
 #include <fstream>
 #include <iostream>
-#include "Eigen/Core"
 #include "coco_utils.hpp"
 #include "core/core/cvtdl_errno.h"
 #include "core/cvi_tdl_types_mem.h"
@@ -239,33 +238,6 @@ void YoloV8Seg::outputParser(const int image_width, const int image_height, cons
   std::vector<std::pair<int, int>> final_dets_id;
   detPostProcess(vec_obj, obj_meta, final_dets_id);
 
-  int num_dets_to_crop = final_dets_id.size();
-
-  Eigen::MatrixXf mask_map(num_dets_to_crop, m_mask_channel_);
-
-  int row = 0;
-
-  // extract the corresponding mask_map based on the ID of the final detection box
-  for (const auto &pair : final_dets_id) {
-    std::string mask_name;
-    mask_name = mask_out_names[pair.first];
-    TensorInfo maskinfo = getOutputTensorInfo(mask_name);
-    int num_map = maskinfo.shape.dim[2] * maskinfo.shape.dim[3];
-    int num_per_pixel = maskinfo.tensor_size / maskinfo.tensor_elem;
-    int8_t *p_mask_int8 = static_cast<int8_t *>(maskinfo.raw_pointer);
-    float *p_mask_float = static_cast<float *>(maskinfo.raw_pointer);
-    if (num_per_pixel == 1) {
-      for (int c = 0; c < m_mask_channel_; c++) {
-        mask_map(row, c) = p_mask_int8[c * num_map + pair.second] * maskinfo.qscale;
-      }
-    } else {
-      for (int c = 0; c < m_mask_channel_; c++) {
-        mask_map(row, c) = p_mask_float[c * num_map + pair.second];
-      }
-    }
-    row++;
-  }
-
   // obtain prototype branch data
   auto firstElement = proto_out_names.begin();
   int proto_stride = firstElement->first;
@@ -276,50 +248,40 @@ void YoloV8Seg::outputParser(const int image_width, const int image_height, cons
   int proto_c = protoinfo.shape.dim[1];
   int proto_h = protoinfo.shape.dim[2];
   int proto_w = protoinfo.shape.dim[3];
-  int proto_hw = proto_h * proto_w;
 
-  Eigen::MatrixXf proto_output(proto_c, proto_hw);  // (32,96*160)
-
-  int num_per_pixel = protoinfo.tensor_size / protoinfo.tensor_elem;
-  int8_t *p_proto_int8 = static_cast<int8_t *>(protoinfo.raw_pointer);
-  float *p_proto_float = static_cast<float *>(protoinfo.raw_pointer);
-  if (num_per_pixel == 1) {
-    for (int i = 0; i < proto_c; i++) {
-      for (int j = 0; j < proto_hw; j++) {
-        proto_output(i, j) = p_proto_int8[i * proto_hw + j] * protoinfo.qscale;
-      }
-    }
-  } else {
-    for (int i = 0; i < proto_c; i++) {
-      for (int j = 0; j < proto_hw; j++) {
-        proto_output(i, j) = p_proto_float[i * proto_hw + j];
-      }
-    }
-  }
-
-  Eigen::MatrixXf masks_output = mask_map * proto_output;
+  bool proto_int8 = protoinfo.tensor_size / protoinfo.tensor_elem == 1;
+  m_mask_engine.setProto(proto_int8 ? static_cast<int8_t *>(protoinfo.raw_pointer) : nullptr,
+                         proto_int8 ? nullptr : static_cast<float *>(protoinfo.raw_pointer),
+                         proto_c, proto_h, proto_w);
 
   obj_meta->mask_height = proto_h;
   obj_meta->mask_width = proto_w;
   // 96*160
   for (uint32_t i = 0; i < obj_meta->size; i++) {
+    // mask coefficients of the final detection box, stored channel-major in the mask branch
+    const std::pair<int, int> &det_id = final_dets_id[i];
+    TensorInfo maskinfo = getOutputTensorInfo(mask_out_names[det_id.first]);
+    int num_map = maskinfo.shape.dim[2] * maskinfo.shape.dim[3];
+    bool mask_int8 = maskinfo.tensor_size / maskinfo.tensor_elem == 1;
+    const int8_t *p_coeff_int8 =
+        mask_int8 ? static_cast<int8_t *>(maskinfo.raw_pointer) + det_id.second : nullptr;
+    const float *p_coeff_float =
+        mask_int8 ? nullptr : static_cast<float *>(maskinfo.raw_pointer) + det_id.second;
+
     int x1 = static_cast<int>(round(obj_meta->info[i].bbox.x1 / proto_stride));
     int x2 = static_cast<int>(round(obj_meta->info[i].bbox.x2 / proto_stride));
     int y1 = static_cast<int>(round(obj_meta->info[i].bbox.y1 / proto_stride));
     int y2 = static_cast<int>(round(obj_meta->info[i].bbox.y2 / proto_stride));
     if (obj_meta->info[i].mask_properity == NULL) {
-      obj_meta->info[i].mask_properity = (cvtdl_mask_meta *)malloc(sizeof(cvtdl_mask_meta));
+      obj_meta->info[i].mask_properity =
+          (cvtdl_mask_meta *)CVI_TDL_MetaArenaAlloc(obj_meta, sizeof(cvtdl_mask_meta));
       if (obj_meta->info[i].mask_properity == NULL) {
         LOGE("Failed to allocate memory for mask_properity\n");
       }
     }
-    obj_meta->info[i].mask_properity->mask = (uint8_t *)calloc(proto_hw, sizeof(uint8_t));
-    for (int j = y1; j < y2; ++j) {
-      for (int k = x1; k < x2; ++k) {
-        if (1 / (1 + exp(-masks_output(i, j * proto_w + k))) >= 0.5) {
-          obj_meta->info[i].mask_properity->mask[j * proto_w + k] = 255;
-        }
-      }
+    if (obj_meta->info[i].mask_properity != NULL) {
+      m_mask_engine.decode(p_coeff_int8, p_coeff_float, num_map, x1, y1, x2, y2, m_mask_format,
+                           obj_meta->info[i].mask_properity);
     }
     if (!hasSkippedVpssPreprocess()) {
       obj_meta->info[i].bbox =
@@ -328,6 +290,17 @@ void YoloV8Seg::outputParser(const int image_width, const int image_height, cons
     }
   }
 }
+
+int YoloV8Seg::setMaskFormat(cvtdl_mask_format_e format) {
+  if (format != CVTDL_MASK_FORMAT_FULL && format != CVTDL_MASK_FORMAT_BBOX &&
+      format != CVTDL_MASK_FORMAT_RLE) {
+    LOGE("unsupported mask format:%d\n", format);
+    return CVI_TDL_FAILURE;
+  }
+  m_mask_format = format;
+  return CVI_TDL_SUCCESS;
+}
+
 void YoloV8Seg::detPostProcess(Detections &dets, cvtdl_object_t *obj_meta,
                                std::vector<std::pair<int, int>> &final_dets_id) {
   CVI_SHAPE shape = getInputShape(0);
@@ -3,6 +3,7 @@
 #include <bitset>
 #include "core/object/cvtdl_object_types.h"
 #include "obj_detection.hpp"
+#include "seg_mask_engine.hpp"
 namespace cvitdl {
 
 typedef std::pair<int, int> PAIR_INT;
@@ -13,6 +14,7 @@ class YoloV8Seg final : public DetectionBase {
   YoloV8Seg(PAIR_INT yolov8_pair);
   ~YoloV8Seg();
   int inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_object_t *obj_meta);
+  int setMaskFormat(cvtdl_mask_format_e format);
 
  private:
   int onModelOpened() override;
@@ -30,5 +32,7 @@ class YoloV8Seg final : public DetectionBase {
   std::map<int, std::string> bbox_class_out_names;
   int m_box_channel_ = 64;
   int m_mask_channel_ = 32;
+  cvtdl_mask_format_e m_mask_format = CVTDL_MASK_FORMAT_FULL;
+  SegMaskEngine m_mask_engine;
 };
 }  // namespace cvitdl
\ No newline at end of file
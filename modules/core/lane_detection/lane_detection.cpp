@@ -3,7 +3,6 @@
 #include <stdlib.h>
 #include <string.h>
 #include <algorithm>
-#include <map>
 #include <memory>
 #include <numeric>
 #include <string>
@@ -18,6 +17,7 @@
 #include "core_utils.hpp"
 #include "cvi_comm.h"
 #include "lane_detection.hpp"
+#include "lane_peaks.hpp"
 #include "misc.hpp"
 #include "object_utils.hpp"
 
@@ -53,10 +53,6 @@ float sample_comb(int x) {  // C(3, x)
   return 3;
 }
 
-float gen_x_by_y(float y, std::vector<float> &pts) {
-  return (y - pts[2]) / (pts[4] - pts[2]) * (pts[3] - pts[1]) + pts[1];
-}
-
 BezierLaneNet::BezierLaneNet() : Core(CVI_MEM_DEVICE) {
   for (int i = 0; i < NUM_POINTS; i++) {
     // float t = H_GAP + i*(1 - H_GAP)/NUM_POINTS;
@@ -94,6 +90,21 @@ int BezierLaneNet::inference(VIDEO_FRAME_INFO_S *srcFrame, cvtdl_lane_t *lane_me
   return CVI_TDL_SUCCESS;
 }
 
+// the queries kept by the max_pool1d(9, stride 1, padding 4) of the model, above 0.9
+void BezierLaneNet::findPeaks(const float *logits, int n) {
+  m_candidates.clear();
+  FindPoolPeaks(logits, n, POOL_RADIUS, &m_window, &m_peaks);
+  for (int c : m_peaks) {
+    float score = ld_sigmoid(logits[c]);
+    if (score > 0.9) {
+      m_candidates.push_back({score, c});
+    }
+  }
+  // best first, equal scores keep the query order
+  std::stable_sort(m_candidates.begin(), m_candidates.end(),
+                   [](const LaneCandidate &a, const LaneCandidate &b) { return a.score > b.score; });
+}
+
 void BezierLaneNet::outputParser(const int nn_width, const int nn_height, const int frame_width,
                                  const int frame_height, cvtdl_lane_t *lane_meta) {
   float *curves = getOutputRawPtr<float>(0);
@@ -102,105 +113,63 @@ void BezierLaneNet::outputParser(const int nn_width, const int nn_height, const
   CVI_SHAPE output0_shape = getOutputShape(0);
   CVI_SHAPE output1_shape = getOutputShape(1);
 
-  map<float, int> valid_scores;
-
-  int counter = 0;
-  for (int i = -4; i < -4 + output1_shape.dim[1];
-       i++) {  // max_pool1d, window_size=9, stride=1, padding=4
-
-    float *score_start = logits + std::max(i, 0);
-    float *score_end = logits + std::min(i + 8, output1_shape.dim[1] - 1);
-
-    auto iter = std::max_element(score_start, score_end);
-    int pos = iter - logits;
-
-    if (pos == counter) {
-      float score = ld_sigmoid(logits[counter]);
-      if (score > 0.9) {
-        // printf(" score: %.4f ", score);
-        valid_scores.insert(make_pair(score, counter));
-      }
-    }
-
-    counter++;
-  }
-
-  // printf("valid_scores.size(): %d\n", valid_scores.size());
-
-  counter = 0;
-  std::vector<std::vector<float>> lane_info;  // score,x1,y1,x2,y2
-  std::vector<float> lane_dis;
-
-  map<float, int>::reverse_iterator map_iter;
-  for (map_iter = valid_scores.rbegin(); map_iter != valid_scores.rend(); map_iter++) {
-    int valid_index = map_iter->second;
-    int start_index = valid_index * output0_shape.dim[2] * output0_shape.dim[3];
-
-    std::vector<float> tmp_info;
-
-    tmp_info.push_back(map_iter->first);
+  findPeaks(logits, output1_shape.dim[1]);
 
+  static const int SAMPLE_INDEX[2] = {13, 41};
+  int num_lanes = 0;
+  for (size_t k = 0; k < m_candidates.size(); k++) {
+    const float *ctrl =
+        curves + m_candidates[k].index * output0_shape.dim[2] * output0_shape.dim[3];
+    LaneCandidate &lane = m_candidates[num_lanes];
+    lane.score = m_candidates[k].score;
     bool valid_lane = true;
-    for (int i = 0; i < NUM_POINTS; i++) {
-      if (i == 13 || i == 41) {
-        float x = c_matrix[i][0] * curves[start_index] + c_matrix[i][1] * curves[start_index + 2] +
-                  c_matrix[i][2] * curves[start_index + 4] +
-                  c_matrix[i][3] * curves[start_index + 6];
-
-        float y =
-            c_matrix[i][0] * curves[start_index + 1] + c_matrix[i][1] * curves[start_index + 3] +
-            c_matrix[i][2] * curves[start_index + 5] + c_matrix[i][3] * curves[start_index + 7];
-
-        if (x < 0 || x > 1 || y < 0 || y > 1) {
-          valid_lane = false;
-          break;
-        } else {
-          tmp_info.push_back(x);
-          tmp_info.push_back(y);
-        }
+    for (int j = 0; j < 2; j++) {
+      const float *c = c_matrix[SAMPLE_INDEX[j]];
+      float x = c[0] * ctrl[0] + c[1] * ctrl[2] + c[2] * ctrl[4] + c[3] * ctrl[6];
+      float y = c[0] * ctrl[1] + c[1] * ctrl[3] + c[2] * ctrl[5] + c[3] * ctrl[7];
+      if (x < 0 || x > 1 || y < 0 || y > 1) {
+        valid_lane = false;
+        break;
       }
+      lane.pts[2 * j] = x;
+      lane.pts[2 * j + 1] = y;
     }
-
     if (valid_lane) {
-      lane_info.push_back(tmp_info);
-      float cur_dis = gen_x_by_y(1.0, lane_info[counter]);
-      cur_dis = (cur_dis - 0.5) * frame_width;
-
-      lane_dis.push_back(cur_dis);
-      counter++;
+      lane.dis = (lane.x_at(1.0) - 0.5) * frame_width;
+      num_lanes++;
     }
   }
-
-  vector<int> sort_index(lane_info.size(), 0);
-  for (int i = 0; i != sort_index.size(); i++) {
-    sort_index[i] = i;
-  }
-
-  sort(sort_index.begin(), sort_index.end(),
-       [&](const int &a, const int &b) { return (lane_dis[a] < lane_dis[b]); });
-
-  std::vector<int> final_index;
-  for (int i = 0; i != sort_index.size(); i++) {
-    if (lane_dis[sort_index[i]] < 0) {
-      if (i == sort_index.size() - 1 || lane_dis[sort_index[i + 1]] > 0) {
-        final_index.push_back(sort_index[i]);
+  m_candidates.resize(num_lanes);
+
+  std::sort(m_candidates.begin(), m_candidates.end(),
+            [](const LaneCandidate &a, const LaneCandidate &b) { return a.dis < b.dis; });
+
+  // the closest lane on each side of the center
+  int final_index[2];
+  int num_final = 0;
+  for (int i = 0; i < num_lanes; i++) {
+    if (m_candidates[i].dis < 0) {
+      if (i == num_lanes - 1 || m_candidates[i + 1].dis > 0) {
+        final_index[num_final++] = i;
       }
-
     } else {
-      final_index.push_back(sort_index[i]);
+      final_index[num_final++] = i;
       break;
     }
   }
 
-  CVI_TDL_MemAllocInit(final_index.size(), lane_meta);
-  for (int i = 0; i < final_index.size(); i++) {
-    lane_meta->lane[i].x[0] =
-        std::max(gen_x_by_y(0.6, lane_info[final_index[i]]) * frame_width, 0.0f);
+  CVI_TDL_MemAllocInit(num_final, lane_meta);
+  lane_meta->width = frame_width;
+  lane_meta->height = frame_height;
+  for (int i = 0; i < num_final; i++) {
+    const LaneCandidate &lane = m_candidates[final_index[i]];
+    lane_meta->lane[i].x[0] = std::max(lane.x_at(0.6) * frame_width, 0.0f);
     lane_meta->lane[i].y[0] = 0.6 * frame_height;
-    lane_meta->lane[i].x[1] =
-        std::max(gen_x_by_y(0.8, lane_info[final_index[i]]) * frame_width, 0.0f);
+    lane_meta->lane[i].x[1] = std::max(lane.x_at(0.8) * frame_width, 0.0f);
     lane_meta->lane[i].y[1] = 0.8 * frame_height;
-    lane_meta->lane[i].score = lane_info[final_index[i]][0];
+    lane_meta->lane[i].score = lane.score;
+    lane_meta->lane[i].unique_id = 0;
+    lane_meta->lane[i].departure_rate = 0;
   }
 }
 
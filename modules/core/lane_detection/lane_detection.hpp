@@ -1,5 +1,6 @@
 #pragma once
 #include <bitset>
+#include <vector>
 #include "core/object/cvtdl_object_types.h"
 #include "core_internel.hpp"
 
@@ -16,9 +17,25 @@ class BezierLaneNet final : public Core {
  private:
   // virtual int onModelOpened() override;
 
+  struct LaneCandidate {
+    float score;
+    int index;
+    float pts[4];  // x1, y1, x2, y2 normalized
+    float dis;     // signed distance from the center at the bottom, in pixels
+    float x_at(float y) const {
+      return (y - pts[1]) / (pts[3] - pts[1]) * (pts[2] - pts[0]) + pts[0];
+    }
+  };
+  static constexpr int POOL_RADIUS = 4;
+
+  void findPeaks(const float *logits, int n);
   void outputParser(const int image_width, const int image_height, const int frame_width,
                     const int frame_height, cvtdl_lane_t *lane);
 
   float c_matrix[56][4];
+  // reused across frames
+  std::vector<LaneCandidate> m_candidates;
+  std::vector<int> m_window;
+  std::vector<int> m_peaks;
 };
 }  // namespace cvitdl
\ No newline at end of file
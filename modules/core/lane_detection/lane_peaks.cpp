@@ -0,0 +1,27 @@
+#include "lane_peaks.hpp"
+
+namespace cvitdl {
+
+// the deque keeps the window indices with decreasing logits, so its front is the window maximum
+// and every index is pushed and popped once
+void FindPoolPeaks(const float *logits, int n, int radius, std::vector<int> *window,
+                   std::vector<int> *peaks) {
+  peaks->clear();
+  window->resize(n);
+  int *dq = window->data();
+  int head = 0, tail = 0;
+  for (int r = 0; r < n + radius; r++) {
+    if (r < n) {
+      while (tail > head && logits[dq[tail - 1]] < logits[r]) tail--;
+      dq[tail++] = r;
+    }
+    int c = r - radius;
+    if (c < 0) continue;
+    while (dq[head] < c - radius) head++;
+    if (logits[dq[head]] == logits[c]) {
+      peaks->push_back(c);
+    }
+  }
+}
+
+}  // namespace cvitdl
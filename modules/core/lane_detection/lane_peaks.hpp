@@ -0,0 +1,14 @@
+#pragma once
+#include <vector>
+
+namespace cvitdl {
+
+/*
+ * Sets peaks to the indices c, in increasing order, where logits[c] is the maximum of
+ * [c - radius, c + radius] clipped to [0, n), the peaks kept by max_pool1d(2 * radius + 1,
+ * stride 1, padding radius). window is scratch space reused across calls.
+ */
+void FindPoolPeaks(const float *logits, int n, int radius, std::vector<int> *window,
+                   std::vector<int> *peaks);
+
+}  // namespace cvitdl
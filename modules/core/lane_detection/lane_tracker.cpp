@@ -0,0 +1,171 @@
+#include "lane_tracker.hpp"
+#include <math.h>
+#include <algorithm>
+#include "core/core/cvtdl_errno.h"
+#include "core/cvi_tdl_types_mem_internal.h"
+#include "cvi_tdl_log.hpp"
+#include "trace.hpp"
+
+#define MAX_LANE_DETECTIONS 16
+
+namespace cvitdl {
+
+static const float ALPHA = 0.5f;
+static const float BETA = 0.1f;
+static const float SLOPE_WEIGHT = 0.5f;
+static const float GATE = 0.08f;  // in frame widths
+static const int MIN_HITS = 2;
+static const int MAX_MISSES = 3;
+static const int MAX_COASTS = 30;
+
+void LaneTracker::reset() {
+  m_num_tracks = 0;
+  m_next_id = 0;
+  m_width = 0;
+  m_height = 0;
+}
+
+void LaneTracker::update(Track *t, const Lane &z) {
+  float dt = (float)(t->coasts + 1);
+  for (int k = 0; k < 2; k++) {
+    float r = z.c[k] - t->c[k];
+    t->c[k] += ALPHA * r;
+    t->v[k] += BETA * r / dt;
+    t->rows[k] = z.rows[k];
+  }
+  t->score = 0.7f * t->score + 0.3f * z.score;
+  t->hits++;
+  t->misses = 0;
+  t->coasts = 0;
+}
+
+int LaneTracker::track(const cvtdl_lane_t *detections, cvtdl_lane_t *tracks) {
+  TraceScope trace("lane_tracker", "tracker");
+  if (tracks == nullptr) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  if (detections != nullptr && detections->size > 0 &&
+      (detections->width == 0 || detections->height == 0)) {
+    LOGE("lane detections without frame size\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+
+  for (int i = 0; i < m_num_tracks; i++) {
+    Track &t = m_tracks[i];
+    t.c[0] += t.v[0];
+    t.c[1] += t.v[1];
+  }
+
+  if (detections == nullptr) {
+    int n = 0;
+    for (int i = 0; i < m_num_tracks; i++) {
+      if (++m_tracks[i].coasts <= MAX_COASTS) m_tracks[n++] = m_tracks[i];
+    }
+    m_num_tracks = n;
+    writeTracks(tracks);
+    return CVI_TDL_SUCCESS;
+  }
+
+  if (detections->size > 0) {
+    m_width = detections->width;
+    m_height = detections->height;
+  }
+  Lane lanes[MAX_LANE_DETECTIONS];
+  int num_lanes = 0;
+  for (uint32_t i = 0; i < detections->size && num_lanes < MAX_LANE_DETECTIONS; i++) {
+    const cvtdl_lane_point_t &p = detections->lane[i];
+    float v0 = p.y[0] / m_height, v1 = p.y[1] / m_height;
+    if (fabsf(v1 - v0) < 1e-3f) continue;
+    Lane &l = lanes[num_lanes++];
+    l.c[1] = (p.x[1] - p.x[0]) / m_width / (v1 - v0);
+    l.c[0] = p.x[0] / m_width + l.c[1] * (1.f - v0);
+    l.rows[0] = v0;
+    l.rows[1] = v1;
+    l.score = p.score;
+  }
+
+  // greedy assignment of the gated pairs, cheapest first
+  struct Pair {
+    float cost;
+    int track;
+    int lane;
+  };
+  Pair pairs[MAX_LANE_TRACKS * MAX_LANE_DETECTIONS];
+  int num_pairs = 0;
+  for (int i = 0; i < m_num_tracks; i++) {
+    for (int j = 0; j < num_lanes; j++) {
+      float cost = fabsf(lanes[j].c[0] - m_tracks[i].c[0]) +
+                   SLOPE_WEIGHT * fabsf(lanes[j].c[1] - m_tracks[i].c[1]);
+      if (cost < GATE) pairs[num_pairs++] = {cost, i, j};
+    }
+  }
+  std::sort(pairs, pairs + num_pairs, [](const Pair &a, const Pair &b) {
+    return a.cost < b.cost || (a.cost == b.cost && a.track < b.track);
+  });
+  bool track_matched[MAX_LANE_TRACKS] = {false};
+  bool lane_matched[MAX_LANE_DETECTIONS] = {false};
+  for (int k = 0; k < num_pairs; k++) {
+    const Pair &p = pairs[k];
+    if (track_matched[p.track] || lane_matched[p.lane]) continue;
+    track_matched[p.track] = true;
+    lane_matched[p.lane] = true;
+    update(&m_tracks[p.track], lanes[p.lane]);
+  }
+
+  int n = 0;
+  for (int i = 0; i < m_num_tracks; i++) {
+    Track &t = m_tracks[i];
+    if (!track_matched[i]) {
+      t.misses++;
+      t.coasts++;
+      if (t.misses > MAX_MISSES || t.coasts > MAX_COASTS) continue;
+    }
+    m_tracks[n++] = t;
+  }
+  m_num_tracks = n;
+
+  for (int j = 0; j < num_lanes && m_num_tracks < MAX_LANE_TRACKS; j++) {
+    if (lane_matched[j]) continue;
+    Track &t = m_tracks[m_num_tracks++];
+    t.id = ++m_next_id;
+    t.c[0] = lanes[j].c[0];
+    t.c[1] = lanes[j].c[1];
+    t.v[0] = t.v[1] = 0;
+    t.rows[0] = lanes[j].rows[0];
+    t.rows[1] = lanes[j].rows[1];
+    t.score = lanes[j].score;
+    t.hits = 1;
+    t.misses = 0;
+    t.coasts = 0;
+  }
+
+  writeTracks(tracks);
+  return CVI_TDL_SUCCESS;
+}
+
+// confirmed tracks, left to right
+void LaneTracker::writeTracks(cvtdl_lane_t *tracks) {
+  int order[MAX_LANE_TRACKS];
+  uint32_t size = 0;
+  for (int i = 0; i < m_num_tracks; i++) {
+    if (m_tracks[i].hits >= MIN_HITS) order[size++] = i;
+  }
+  std::sort(order, order + size,
+            [this](int a, int b) { return m_tracks[a].c[0] < m_tracks[b].c[0]; });
+
+  CVI_TDL_MemAllocInit(size, tracks);
+  tracks->width = m_width;
+  tracks->height = m_height;
+  for (uint32_t i = 0; i < size; i++) {
+    const Track &t = m_tracks[order[i]];
+    cvtdl_lane_point_t &p = tracks->lane[i];
+    for (int k = 0; k < 2; k++) {
+      p.x[k] = (t.c[0] + t.c[1] * (t.rows[k] - 1.f)) * m_width;
+      p.y[k] = t.rows[k] * m_height;
+    }
+    p.score = t.score;
+    p.unique_id = t.id;
+    p.departure_rate = (t.c[0] < 0.5f ? t.v[0] : -t.v[0]) * m_width;
+  }
+}
+}  // namespace cvitdl
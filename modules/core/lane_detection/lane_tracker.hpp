@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+#include "core/object/cvtdl_object_types.h"
+
+#define MAX_LANE_TRACKS 8
+
+namespace cvitdl {
+
+/**
+ * Associates the lanes of consecutive frames and smooths them. A lane is the line
+ * u = c0 + c1 * (v - 1) in coordinates normalized by the frame size, c0 being where it meets the
+ * bottom of the frame. Both coefficients go through an alpha-beta filter and the velocity of c0
+ * gives the departure rate. Frames without detections only predict, so the lane model can run
+ * at a lower rate than the tracker.
+ */
+class LaneTracker {
+ public:
+  LaneTracker() { reset(); }
+
+  /* detections is NULL for the frames the lane model did not run on, tracks may be detections */
+  int track(const cvtdl_lane_t *detections, cvtdl_lane_t *tracks);
+  void reset();
+
+ private:
+  struct Track {
+    uint64_t id;
+    float c[2];     // c0, c1
+    float v[2];     // per frame
+    float rows[2];  // normalized rows of the output points
+    float score;
+    int hits;
+    int misses;  // detection frames without a match
+    int coasts;  // frames since the last match
+  };
+  struct Lane {
+    float c[2];
+    float rows[2];
+    float score;
+  };
+
+  void update(Track *t, const Lane &z);
+  void writeTracks(cvtdl_lane_t *tracks);
+
+  Track m_tracks[MAX_LANE_TRACKS];
+  int m_num_tracks;
+  uint64_t m_next_id;
+  uint32_t m_width;
+  uint32_t m_height;
+};
+}  // namespace cvitdl
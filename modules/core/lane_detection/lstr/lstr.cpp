@@ -95,7 +95,7 @@ int LSTR::outputParser(cvtdl_lane_t *lane_meta) {
   }
   lane_meta->size = final_index.size();
   if (lane_meta->size > 0) {
-    lane_meta->lane = (cvtdl_lane_point_t *)malloc(sizeof(cvtdl_lane_point_t) * lane_meta->size);
+    lane_meta->lane = (cvtdl_lane_point_t *)calloc(lane_meta->size, sizeof(cvtdl_lane_point_t));
   } else {
     return CVI_TDL_SUCCESS;
   }
@@ -126,8 +126,10 @@ int LicensePlateDetection::inference(VIDEO_FRAME_INFO_S *frame, cvtdl_object_t *
     // TODO:
     //   add more points to bpts for false positive
     if (detection_result) {
-      vehicle_meta->info[n].vehicle_properity =
-          (cvtdl_vehicle_meta *)malloc(sizeof(cvtdl_vehicle_meta));
+      if (vehicle_meta->info[n].vehicle_properity == NULL) {
+        vehicle_meta->info[n].vehicle_properity = (cvtdl_vehicle_meta *)CVI_TDL_MetaArenaAlloc(
+            vehicle_meta, sizeof(cvtdl_vehicle_meta));
+      }
       for (int m = 0; m < 4; m++) {
         vehicle_meta->info[n].vehicle_properity->license_pts.x[m] =
             corner_pts(0, m) / rs_scale[n] + vehicle_meta->info[n].bbox.x1;
@@ -1,17 +1,19 @@
 #include "decode_tool.hpp"
 
-#include <iostream>
-#include <vector>
+#include <string.h>
+#include <algorithm>
 
-#define CODE_LENGTH_TW 18
-#define CODE_LENGTH_CN 24
 #define CHARS_NUM_TW 36
 #define CHARS_NUM_CN 72
 
-char const *CHAR_LIST_TW = "0123456789ABCDEFGHJKLMNPQRSTUVWXYZ-_";
-
 // clang-format off
-char const *CHAR_LIST_CN[CHARS_NUM_CN] = {
+static const char *CHAR_LIST_TW[CHARS_NUM_TW] = {
+  "0","1","2","3","4","5","6","7","8","9",
+  "A","B","C","D","E","F","G","H","J","K",
+  "L","M","N","P","Q","R","S","T","U","V",
+  "W","X","Y","Z","-","_"};
+
+static const char *CHAR_LIST_CN[CHARS_NUM_CN] = {
   "_",
   "<Anhui>","<Shanghai>","<Tianjin>","<Chongqing>","<Hebei>",
   "<Shanxi>","<InnerMongolia>","<Liaoning>","<Jilin>","<Heilongjiang>",
@@ -27,84 +29,64 @@ char const *CHAR_LIST_CN[CHARS_NUM_CN] = {
   "W","X","Y","Z"};
 // clang-format on
 
+static std::vector<int> labelRange(int first, int last) {
+  std::vector<int> labels;
+  for (int l = first; l <= last; l++) labels.push_back(l);
+  return labels;
+}
+
 namespace LPR {
 
-bool greedy_decode(float *y, std::string &id_number, LP_FORMAT format) {
-  int chars_num;
-  switch (format) {
-    case TAIWAN:
-      chars_num = CHARS_NUM_TW;
-      break;
-    case CHINA:
-      chars_num = CHARS_NUM_CN;
-      break;
-    default:
-      return false;
-  }
-  int code_length = (format == TAIWAN) ? CODE_LENGTH_TW : CODE_LENGTH_CN;
-  int *code = new int[code_length];
-  for (int i = 0; i < code_length; i++) {
-    float max_value = y[i];
-    code[i] = 0;
-    for (int j = 1; j < chars_num; j++) {
-      if (y[j * code_length + i] > max_value) {
-        max_value = y[j * code_length + i];
-        code[i] = j;
-      }
-    }
-  }
+PlateDecoder::PlateDecoder(std::vector<std::string> chars, int blank)
+    : m_chars(std::move(chars)), m_decoder(blank) {
+  m_decoder.setLogitConfidences(false);
+}
 
-  switch (format) {
-    case TAIWAN:
-      id_number = decode_tw(code);
-      break;
-    case CHINA:
-      id_number = decode_cn(code);
-      break;
-    default:
-      return false;
+PlateDecoder PlateDecoder::create(LP_FORMAT format) {
+  if (format == TAIWAN) {
+    // blank is the last class, "ABC-1234" style: 2 to 4 characters on both sides of the dash
+    PlateDecoder decoder(std::vector<std::string>(CHAR_LIST_TW, CHAR_LIST_TW + CHARS_NUM_TW),
+                         CHARS_NUM_TW - 1);
+    std::vector<int> alnum = labelRange(0, 33);
+    decoder.layout().addSlot(alnum, 2, 4);
+    decoder.layout().addSlot({34});
+    decoder.layout().addSlot(alnum, 2, 4);
+    return decoder;
   }
-
-  delete[] code;
-  return true;
+  // blank is class 0, province, letter, 4 to 6 digits or letters and an optional special suffix
+  PlateDecoder decoder(std::vector<std::string>(CHAR_LIST_CN, CHAR_LIST_CN + CHARS_NUM_CN), 0);
+  decoder.layout().addSlot(labelRange(1, 31));
+  decoder.layout().addSlot(labelRange(48, 71));
+  decoder.layout().addSlot(labelRange(38, 71), 4, 6);
+  decoder.layout().addSlot(labelRange(32, 37), 0, 1);
+  return decoder;
 }
 
-std::string decode_tw(int *code) {
-  std::vector<int> de_code;
-  int previous = -1;
-  for (int i = 0; i < CODE_LENGTH_TW; i++) {
-    if (code[i] != previous) {
-      de_code.push_back(code[i]);
-      previous = code[i];
-    }
+void PlateDecoder::decode(const float *scores, int steps, cvtdl_vehicle_meta *meta) {
+  // the models end with the class scores before softmax
+  cvitdl::CTCInput input = {scores, steps, (int)m_chars.size(), 1, steps, true};
+  bool found = false;
+  if (m_beam_width > 1) {
+    found = m_decoder.beamSearch(input, m_beam_width, &m_layout, &m_result);
   }
-  std::string id_number("");
-  for (size_t i = 0; i < de_code.size(); i++) {
-    if (de_code[i] != CHARS_NUM_TW - 1) {
-      id_number.append(1, CHAR_LIST_TW[de_code[i]]);
-    }
+  if (!found) {
+    m_decoder.greedy(input, &m_result);
   }
 
-  return id_number;
-}
-
-std::string decode_cn(int *code) {
-  std::vector<int> de_code;
-  int previous = -1;
-  for (int i = 0; i < CODE_LENGTH_CN; i++) {
-    if (code[i] != previous) {
-      de_code.push_back(code[i]);
-      previous = code[i];
-    }
-  }
-  std::string id_number("");
-  for (size_t i = 0; i < de_code.size(); i++) {
-    if (de_code[i] != 0) {
-      id_number += CHAR_LIST_CN[de_code[i]];
-    }
+  size_t len = 0;
+  const size_t max_len = sizeof(meta->license_char) - 1;
+  for (int label : m_result.labels) {
+    const std::string &c = m_chars[label];
+    if (len + c.size() > max_len) break;
+    memcpy(meta->license_char + len, c.data(), c.size());
+    len += c.size();
   }
+  meta->license_char[len] = '\0';
 
-  return id_number;
+  const size_t max_num = sizeof(meta->license_char_conf) / sizeof(meta->license_char_conf[0]);
+  meta->license_char_num = std::min(m_result.confidences.size(), max_num);
+  std::copy(m_result.confidences.begin(),
+            m_result.confidences.begin() + meta->license_char_num, meta->license_char_conf);
 }
 
-}  // namespace LPR
\ No newline at end of file
+}  // namespace LPR
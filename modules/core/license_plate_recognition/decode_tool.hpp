@@ -1,11 +1,48 @@
 #pragma once
 #include <string>
+#include <vector>
+#include "core/object/cvtdl_object_types.h"
+#include "ctc_decoder.hpp"
 
 enum LP_FORMAT { TAIWAN = 0, CHINA };
 
 namespace LPR {
-bool greedy_decode(float *y, std::string &id_number, LP_FORMAT format = TAIWAN);
 
-std::string decode_tw(int *code);
-std::string decode_cn(int *code);
+/**
+ * CTC decoding of plate recognition outputs.
+ *
+ * Decodes greedily by default. With a beam width above 1 the prefix beam search only keeps
+ * character sequences that fit the plate layout, and falls back to greedy decoding when no
+ * sequence fits the layout. The character confidences of greedy decoding are off by default,
+ * they cost more than the decoding.
+ */
+class PlateDecoder {
+ public:
+  /* chars[c] is the text of class c, class blank is the CTC blank */
+  PlateDecoder(std::vector<std::string> chars, int blank);
+
+  /* decoder of the LPRNet character set and plate layout of a region */
+  static PlateDecoder create(LP_FORMAT format);
+
+  cvitdl::CTCLabelConstraint &layout() { return m_layout; }
+  void setBeamWidth(int beam_width) { m_beam_width = beam_width; }
+  int beamWidth() const { return m_beam_width; }
+  void setConfidences(bool on) { m_decoder.setLogitConfidences(on); }
+  int numClasses() const { return m_chars.size(); }
+
+  /**
+   * scores holds numClasses() x steps class-major scores, scores[c * steps + t].
+   * Writes license_char, license_char_conf and license_char_num of meta, license_char_num is 0
+   * when the greedy decoding runs without confidences.
+   */
+  void decode(const float *scores, int steps, cvtdl_vehicle_meta *meta);
+
+ private:
+  std::vector<std::string> m_chars;
+  int m_beam_width = 1;
+  cvitdl::CTCLabelConstraint m_layout;
+  cvitdl::CTCDecoder m_decoder;
+  cvitdl::CTCResult m_result;
+};
+
 }  // namespace LPR
@@ -13,6 +13,8 @@
 #define LICENSE_PLATE_TW_WIDTH 94
 #define LICENSE_PLATE_CN_HEIGHT 30
 #define LICENSE_PLATE_CN_WIDTH 122
+#define CODE_LENGTH_TW 18
+#define CODE_LENGTH_CN 24
 
 #define OUTPUT_NAME "id_code_ReduceMean_dequant"
 
@@ -21,15 +23,17 @@
 namespace cvitdl {
 
 LicensePlateRecognition::LicensePlateRecognition(LP_FORMAT region)
-    : LicensePlateRecognitionBase(CVI_MEM_SYSTEM) {
+    : LicensePlateRecognitionBase(CVI_MEM_SYSTEM, LPR::PlateDecoder::create(region)) {
   if (region == TAIWAN) {
     this->format = region;
     this->lp_height = LICENSE_PLATE_TW_HEIGHT;
     this->lp_width = LICENSE_PLATE_TW_WIDTH;
+    this->code_length = CODE_LENGTH_TW;
   } else if (region == CHINA) {
     this->format = region;
     this->lp_height = LICENSE_PLATE_CN_HEIGHT;
     this->lp_width = LICENSE_PLATE_CN_WIDTH;
+    this->code_length = CODE_LENGTH_CN;
   } else {
     LOGE("unknown region: %d\n", region);
   }
@@ -87,14 +91,7 @@ int LicensePlateRecognition::inference(VIDEO_FRAME_INFO_S *frame,
     }
 
     float *out_code = getOutputRawPtr<float>(OUTPUT_NAME);
-
-    std::string id_number;
-    if (!LPR::greedy_decode(out_code, id_number, format)) {
-      LOGE("LPR::decode error!!\n");
-      return CVI_TDL_ERR_INFERENCE;
-    }
-
-    strncpy(v_meta->license_char, id_number.c_str(), sizeof(v_meta->license_char));
+    m_decoder.decode(out_code, code_length, v_meta);
   }
   if (do_unmap) {
     CVI_SYS_Munmap((void *)frame->stVFrame.pu8VirAddr[0], frame->stVFrame.u32Length[0]);
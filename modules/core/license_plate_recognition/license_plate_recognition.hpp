@@ -19,5 +19,6 @@ class LicensePlateRecognition final : public LicensePlateRecognitionBase {
   void prepareInputTensor(cv::Mat &input_mat);
   LP_FORMAT format;
   int lp_height, lp_width;
+  int code_length = 0;
 };
 }  // namespace cvitdl
\ No newline at end of file
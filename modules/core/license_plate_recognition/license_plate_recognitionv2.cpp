@@ -1,6 +1,6 @@
 
 #include "license_plate_recognitionv2.hpp"
-#include <iostream>
+#include <string.h>
 #include "core/core/cvtdl_errno.h"
 #include "core/cvi_tdl_types_mem.h"
 #include "core/face/cvtdl_face_types.h"
@@ -13,7 +13,8 @@
 
 namespace cvitdl {
 
-std::vector<std::string> CHARS = {
+// clang-format off
+static const char *CHARS_V2[] = {
     "jing", "hu",    "jin",    "yu",   "ji",  "jin",  "meng", "liao", "ji",    "hei",
     "su",   "zhe",   "wan",    "min",  "gan", "lu",   "yu",   "e",    "xiang", "yue",
     "gui",  "qiong", "chuang", "gui",  "yun", "zang", "shan", "gan",  "qing",  "ning",
@@ -22,9 +23,28 @@ std::vector<std::string> CHARS = {
     "7",    "8",     "9",      "A",    "B",   "C",    "D",    "E",    "F",     "G",
     "H",    "J",     "K",      "L",    "M",   "N",    "P",    "Q",    "R",     "S",
     "T",    "U",     "V",      "W",    "X",   "Y",    "Z",    "I",    "O",     "-"};
+// clang-format on
+
+static LPR::PlateDecoder createDecoderV2() {
+  const int num_chars = sizeof(CHARS_V2) / sizeof(CHARS_V2[0]);
+  // blank is the last class
+  LPR::PlateDecoder decoder(std::vector<std::string>(CHARS_V2, CHARS_V2 + num_chars),
+                            num_chars - 1);
+  std::vector<int> provinces, letters, alnum, specials;
+  for (int c = 0; c <= 30; c++) provinces.push_back(c);
+  for (int c = 31; c <= 42; c++) specials.push_back(c);
+  for (int c = 53; c <= 78; c++) letters.push_back(c);
+  for (int c = 43; c <= 78; c++) alnum.push_back(c);
+  // province, letter, 4 to 6 digits or letters and an optional special suffix
+  decoder.layout().addSlot(provinces);
+  decoder.layout().addSlot(letters);
+  decoder.layout().addSlot(alnum, 4, 6);
+  decoder.layout().addSlot(specials, 0, 1);
+  return decoder;
+}
 
 LicensePlateRecognitionV2::LicensePlateRecognitionV2()
-    : LicensePlateRecognitionBase(CVI_MEM_SYSTEM) {
+    : LicensePlateRecognitionBase(CVI_MEM_SYSTEM, createDecoderV2()) {
   for (int i = 0; i < 3; i++) {
     m_preprocess_param[0].factor[i] = SCALE;
     m_preprocess_param[0].mean[i] = MEAN;
@@ -33,51 +53,6 @@ LicensePlateRecognitionV2::LicensePlateRecognitionV2()
   m_preprocess_param[0].keep_aspect_ratio = false;
 }
 
-void LicensePlateRecognitionV2::greedy_decode(float *prebs) {
-  CVI_SHAPE shape = getOutputShape(0);
-  // 80，18
-  int rows = shape.dim[1];
-  int cols = shape.dim[2];
-
-  int index[cols];
-  // argmax index
-  for (int i = 0; i < cols; i++) {
-    float max = prebs[cols];
-    int maxIndex = 0;
-    for (int j = 1; j < rows; j++) {
-      if (prebs[i + j * cols] > max) {
-        max = prebs[i + j * cols];
-        maxIndex = j;
-      }
-    }
-    index[i] = maxIndex;
-  }
-
-  std::vector<int> no_repeat_blank_label;
-  uint32_t pre_c = index[0];
-  if (pre_c != CHARS.size() - 1) {
-    no_repeat_blank_label.push_back(pre_c);
-  }
-  for (int i = 0; i < cols; i++) {
-    uint32_t c = index[i];
-    if ((pre_c == c) || (c == CHARS.size() - 1)) {
-      if (c == CHARS.size() - 1) {
-        pre_c = c;
-      }
-      continue;
-    }
-    no_repeat_blank_label.push_back(c);
-    pre_c = c;
-  }
-
-  std::string lb = "";
-  for (int k : no_repeat_blank_label) {
-    lb += CHARS[k];
-    lb += " ";
-  }
-  std::cout << "Prediction: " << lb << std::endl;
-}
-
 int LicensePlateRecognitionV2::inference(VIDEO_FRAME_INFO_S *frame, cvtdl_object_t *vehicle_meta) {
   if (frame->stVFrame.enPixelFormat != PIXEL_FORMAT_RGB_888_PLANAR &&
       frame->stVFrame.enPixelFormat != PIXEL_FORMAT_BGR_888_PLANAR) {
@@ -104,8 +79,22 @@ int LicensePlateRecognitionV2::inference(VIDEO_FRAME_INFO_S *frame, cvtdl_object
       return ret;
     }
 
+    // classes x steps
+    CVI_SHAPE out_shape = getOutputShape(OUTPUT_NAME_PROBABILITY);
+    if (out_shape.dim[1] != m_decoder.numClasses()) {
+      LOGE("unexpected class number: %d\n", out_shape.dim[1]);
+      mp_vpss_inst->releaseFrame(f, 0);
+      delete f;
+      CVI_TDL_FreeCpp(&obj_info);
+      return CVI_TDL_ERR_INFERENCE;
+    }
+    cvtdl_object_info_t &info = vehicle_meta->info[i];
+    if (info.vehicle_properity == NULL) {
+      info.vehicle_properity =
+          (cvtdl_vehicle_meta *)CVI_TDL_MetaArenaAlloc(vehicle_meta, sizeof(cvtdl_vehicle_meta));
+    }
     float *out = getOutputRawPtr<float>(OUTPUT_NAME_PROBABILITY);
-    greedy_decode(out);
+    m_decoder.decode(out, out_shape.dim[2], info.vehicle_properity);
     mp_vpss_inst->releaseFrame(f, 0);
     delete f;
 
@@ -1,3 +1,15 @@
 #include "lp_recognition_base.hpp"
+#include "core/core/cvtdl_errno.h"
 
-namespace cvitdl {}
\ No newline at end of file
+namespace cvitdl {
+
+int LicensePlateRecognitionBase::setBeamWidth(int beam_width) {
+  if (beam_width < 1) {
+    LOGE("invalid beam width: %d\n", beam_width);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  m_decoder.setBeamWidth(beam_width);
+  return CVI_TDL_SUCCESS;
+}
+
+}  // namespace cvitdl
@@ -8,12 +8,19 @@ namespace cvitdl {
 
 class LicensePlateRecognitionBase : public Core {
  public:
-  LicensePlateRecognitionBase(CVI_MEM_TYPE_E CVI_MEM_SYSTEM) : Core(CVI_MEM_SYSTEM){};
-  LicensePlateRecognitionBase(){};
+  LicensePlateRecognitionBase(CVI_MEM_TYPE_E CVI_MEM_SYSTEM, LPR::PlateDecoder decoder)
+      : Core(CVI_MEM_SYSTEM), m_decoder(std::move(decoder)){};
   virtual ~LicensePlateRecognitionBase(){};
   virtual int inference(VIDEO_FRAME_INFO_S *frame, cvtdl_object_t *object_meta) = 0;
+  /* 1 decodes greedily, wider beams search plates that fit the layout of the region */
+  int setBeamWidth(int beam_width);
+  /* character confidences of the greedy decoding, off by default */
+  void setConfidences(bool on) { m_decoder.setConfidences(on); }
   virtual bool allowExportChannelAttribute() const override { return false; }
   int after_inference() { return 0; }
+
+ protected:
+  LPR::PlateDecoder m_decoder;
 };
 
 }  // namespace cvitdl
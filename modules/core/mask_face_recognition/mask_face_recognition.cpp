@@ -97,7 +97,8 @@ void MaskFaceRecognition::outputParser(cvtdl_face_t *meta, int meta_i) {
   int8_t *face_blob = getOutputRawPtr<int8_t>(FACE_OUT_NAME);
   size_t face_feature_size = getOutputTensorElem(FACE_OUT_NAME);
 
-  CVI_TDL_MemAlloc(sizeof(int8_t), face_feature_size, TYPE_INT8, &meta->info[meta_i].feature);
+  CVI_TDL_MemAlloc(sizeof(int8_t), face_feature_size, TYPE_INT8, &meta->info[meta_i].feature,
+                   meta);
   memcpy(meta->info[meta_i].feature.ptr, face_blob, face_feature_size);
 }
 
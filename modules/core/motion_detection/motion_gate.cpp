@@ -0,0 +1,144 @@
+#include "motion_gate.hpp"
+
+#include <math.h>
+#include <algorithm>
+#include "core/core/cvtdl_errno.h"
+#include "cvi_tdl_log.hpp"
+
+MotionGate::MotionGate() : m_config(defaultConfig()) { reset(); }
+
+cvtdl_motion_gate_config_t MotionGate::defaultConfig() {
+  cvtdl_motion_gate_config_t config;
+  config.keyframe_interval = 25;
+  config.hold_frames = 5;
+  config.min_motion_area = 64;
+  config.roi_padding = 0.2f;
+  config.min_roi_size = 128;
+  config.max_roi_ratio = 0.6f;
+  return config;
+}
+
+void MotionGate::setConfig(const cvtdl_motion_gate_config_t &config) {
+  m_config = config;
+  m_config.roi_padding = std::max(m_config.roi_padding, 0.f);
+  m_config.max_roi_ratio = std::min(std::max(m_config.max_roi_ratio, 0.f), 1.f);
+}
+
+void MotionGate::reset() {
+  m_started = false;
+  m_frames_since_full = 0;
+  m_hold = 0;
+  m_last_roi = {0, 0, 0, 0, 0};
+}
+
+/* place a segment of at least min_len inside [0, len], even aligned for the VPSS crop */
+static void fit_segment(float *lo, float *hi, float min_len, uint32_t len) {
+  float size = std::min(std::max(*hi - *lo, min_len), (float)len);
+  float center = (*lo + *hi) * 0.5f;
+  float a = std::min(std::max(center - size * 0.5f, 0.f), len - size);
+  float b = a + size;
+  *lo = (float)((int)floorf(a) & ~1);
+  *hi = std::min((float)(((int)ceilf(b) + 1) & ~1), (float)len);
+}
+
+bool MotionGate::motionROI(const cvtdl_object_t *motion, uint32_t width, uint32_t height,
+                           cvtdl_bbox_t *roi) const {
+  if (motion == nullptr || motion->info == nullptr) {
+    return false;
+  }
+  bool found = false;
+  for (uint32_t i = 0; i < motion->size; i++) {
+    const cvtdl_bbox_t &b = motion->info[i].bbox;
+    if ((b.x2 - b.x1) * (b.y2 - b.y1) < m_config.min_motion_area) {
+      continue;
+    }
+    if (!found) {
+      *roi = b;
+      found = true;
+    } else {
+      roi->x1 = std::min(roi->x1, b.x1);
+      roi->y1 = std::min(roi->y1, b.y1);
+      roi->x2 = std::max(roi->x2, b.x2);
+      roi->y2 = std::max(roi->y2, b.y2);
+    }
+  }
+  if (!found) {
+    return false;
+  }
+  const float pad_x = (roi->x2 - roi->x1) * m_config.roi_padding;
+  const float pad_y = (roi->y2 - roi->y1) * m_config.roi_padding;
+  roi->x1 -= pad_x;
+  roi->x2 += pad_x;
+  roi->y1 -= pad_y;
+  roi->y2 += pad_y;
+  fit_segment(&roi->x1, &roi->x2, m_config.min_roi_size, width);
+  fit_segment(&roi->y1, &roi->y2, m_config.min_roi_size, height);
+  roi->score = 0;
+  return true;
+}
+
+void MotionGate::decide(const cvtdl_object_t *motion, uint32_t width, uint32_t height,
+                        cvtdl_motion_gate_t *gate) {
+  bool force_full = !m_started || width != m_width || height != m_height ||
+                    (m_config.keyframe_interval > 0 &&
+                     m_frames_since_full + 1 >= m_config.keyframe_interval);
+  m_started = true;
+  m_width = width;
+  m_height = height;
+
+  cvtdl_bbox_t roi;
+  if (motionROI(motion, width, height, &roi)) {
+    m_last_roi = roi;
+    m_hold = m_config.hold_frames;
+    gate->action = CVTDL_MOTION_GATE_ROI;
+  } else if (m_hold > 0) {
+    m_hold--;
+    roi = m_last_roi;
+    gate->action = CVTDL_MOTION_GATE_ROI;
+  } else {
+    gate->action = CVTDL_MOTION_GATE_SKIP;
+  }
+  if (gate->action == CVTDL_MOTION_GATE_ROI) {
+    const float area = (roi.x2 - roi.x1) * (roi.y2 - roi.y1);
+    if (area > m_config.max_roi_ratio * width * height) {
+      force_full = true;
+    }
+  }
+
+  if (force_full) {
+    gate->action = CVTDL_MOTION_GATE_FULL;
+    roi = {0, 0, (float)width, (float)height, 0};
+    m_frames_since_full = 0;
+  } else {
+    m_frames_since_full++;
+  }
+  if (gate->action == CVTDL_MOTION_GATE_SKIP) {
+    roi = {0, 0, 0, 0, 0};
+  }
+  gate->roi = roi;
+  gate->width = width;
+  gate->height = height;
+  gate->frames_since_full = m_frames_since_full;
+}
+
+CVI_S32 MotionGate::restore(const cvtdl_motion_gate_t *gate, cvtdl_object_t *obj) {
+  if (gate->action != CVTDL_MOTION_GATE_ROI) {
+    return CVI_TDL_SUCCESS;
+  }
+  if (obj->size > 0 && (obj->width == 0 || obj->height == 0)) {
+    LOGE("Objects have no image size, cannot map them out of the ROI.\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  const float sx = obj->width > 0 ? (gate->roi.x2 - gate->roi.x1) / obj->width : 1.f;
+  const float sy = obj->height > 0 ? (gate->roi.y2 - gate->roi.y1) / obj->height : 1.f;
+  for (uint32_t i = 0; i < obj->size; i++) {
+    cvtdl_bbox_t &b = obj->info[i].bbox;
+    b.x1 = b.x1 * sx + gate->roi.x1;
+    b.y1 = b.y1 * sy + gate->roi.y1;
+    b.x2 = b.x2 * sx + gate->roi.x1;
+    b.y2 = b.y2 * sy + gate->roi.y1;
+  }
+  obj->width = gate->width;
+  obj->height = gate->height;
+  return CVI_TDL_SUCCESS;
+}
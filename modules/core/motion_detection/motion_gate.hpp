@@ -0,0 +1,37 @@
+#pragma once
+#include "core/core/cvtdl_core_types.h"
+#include "core/object/cvtdl_object_types.h"
+
+/**
+ * Decides per frame whether the detectors run on the whole frame, on the region that moved or not
+ * at all, from the boxes of MotionDetection. The motion boxes are merged into one padded ROI, so a
+ * frame costs at most one crop. A full frame detection is forced on the first frame, on a
+ * resolution change and every keyframe_interval frames, so objects that stopped moving are found
+ * again.
+ */
+class MotionGate {
+ public:
+  MotionGate();
+
+  static cvtdl_motion_gate_config_t defaultConfig();
+  void setConfig(const cvtdl_motion_gate_config_t &config);
+  const cvtdl_motion_gate_config_t &getConfig() const { return m_config; }
+  void reset();
+
+  void decide(const cvtdl_object_t *motion, uint32_t width, uint32_t height,
+              cvtdl_motion_gate_t *gate);
+  /* map the boxes of objects detected on the crop of gate->roi back to the frame */
+  static CVI_S32 restore(const cvtdl_motion_gate_t *gate, cvtdl_object_t *obj);
+
+ private:
+  bool motionROI(const cvtdl_object_t *motion, uint32_t width, uint32_t height,
+                 cvtdl_bbox_t *roi) const;
+
+  cvtdl_motion_gate_config_t m_config;
+  bool m_started = false;
+  uint32_t m_width = 0;
+  uint32_t m_height = 0;
+  uint32_t m_frames_since_full = 0;
+  uint32_t m_hold = 0;
+  cvtdl_bbox_t m_last_roi;
+};
@@ -5,6 +5,7 @@
 #include <iostream>
 #include "core/core/cvtdl_errno.h"
 #include "cvi_tdl_log.hpp"
+#include "seg_utils.hpp"
 using namespace cvitdl;
 
 void dump_frame(VIDEO_FRAME_INFO_S *frame, std::string name) {
@@ -94,6 +95,8 @@ int MotionSegmentation::inference(VIDEO_FRAME_INFO_S *input0, VIDEO_FRAME_INFO_S
   int byte_per_pixel = oinfo.tensor_size / oinfo.tensor_elem;
   float qscale_output = byte_per_pixel == 1 ? oinfo.qscale : 1;
   std::cout << "byte_per_pixel: " << byte_per_pixel << std::endl;
+  // label_map and conf_map keep the size of the previous frame, reuse them while it matches
+  int prev_map_size = seg_logits->w * seg_logits->h * seg_logits->b;
   seg_logits->w = oinfo.shape.dim[3];
   seg_logits->h = oinfo.shape.dim[2];
   seg_logits->c = oinfo.shape.dim[1];
@@ -123,5 +126,33 @@ int MotionSegmentation::inference(VIDEO_FRAME_INFO_S *input0, VIDEO_FRAME_INFO_S
            seg_logits->w * seg_logits->h * seg_logits->c * seg_logits->b * sizeof(float));
   }
 
+  int map_size = seg_logits->w * seg_logits->h * seg_logits->b;
+  bool has_maps = seg_logits->c > 1 && seg_logits->c <= 256;
+  if (!has_maps || map_size != prev_map_size) {
+    delete[] seg_logits->label_map;
+    delete[] seg_logits->conf_map;
+    seg_logits->label_map = NULL;
+    seg_logits->conf_map = NULL;
+  }
+  if (has_maps) {
+    if (seg_logits->label_map == NULL) {
+      seg_logits->label_map = new uint8_t[map_size];
+      seg_logits->conf_map = new float[map_size];
+    }
+    int plane = seg_logits->w * seg_logits->h;
+    for (int b = 0; b < seg_logits->b; b++) {
+      int offset = b * seg_logits->c * plane;
+      if (byte_per_pixel == 1) {
+        ChannelArgmax(int8_out_data + offset, seg_logits->c, seg_logits->h, seg_logits->w,
+                      qscale_output, NULL, seg_logits->label_map + b * plane, seg_logits->w,
+                      seg_logits->conf_map + b * plane);
+      } else {
+        ChannelArgmax(float_out_data + offset, seg_logits->c, seg_logits->h, seg_logits->w, NULL,
+                      seg_logits->label_map + b * plane, seg_logits->w,
+                      seg_logits->conf_map + b * plane);
+      }
+    }
+  }
+
   return CVI_TDL_SUCCESS;
-}
\ No newline at end of file
+}
@@ -8,9 +8,7 @@
 #include "core/utils/vpss_helper.h"
 
 #include <iostream>
-#include <opencv2/opencv.hpp>
 #include <sstream>
-#include "opencv2/imgproc.hpp"
 
 #define R_SCALE (0.003922)
 #define G_SCALE (0.003922)
@@ -18,6 +16,8 @@
 #define R_MEAN (0)
 #define G_MEAN (0)
 #define B_MEAN (0)
+#define UNCLIP_RATIO (1.5)
+#define MIN_TEXT_AREA (10)
 
 namespace cvitdl {
 
@@ -28,6 +28,12 @@ OCRDetection::OCRDetection() : Core(CVI_MEM_DEVICE) {
   m_preprocess_param[0].mean[0] = R_MEAN;
   m_preprocess_param[0].mean[1] = G_MEAN;
   m_preprocess_param[0].mean[2] = B_MEAN;
+
+  // only the area filter of the previous contour path, box_thresh and min_size stay off
+  DBPostprocessConfig config;
+  config.unclip_ratio = UNCLIP_RATIO;
+  config.min_area = MIN_TEXT_AREA;
+  m_db_postprocess.setConfig(config);
 }
 OCRDetection::~OCRDetection() {}
 
@@ -40,10 +46,10 @@ int OCRDetection::inference(VIDEO_FRAME_INFO_S *frame, cvtdl_object_t *obj_meta)
     return ret;
   }
   float thresh = 0.95;
-  float boxThresh = 0.7;
+  float nmsThresh = 0.7;
   obj_meta->height = frame->stVFrame.u32Height;
   obj_meta->width = frame->stVFrame.u32Width;
-  outputParser(thresh, boxThresh, obj_meta);
+  outputParser(thresh, nmsThresh, obj_meta);
   return CVI_TDL_SUCCESS;
 }
 
@@ -100,40 +106,34 @@ void NMS(std::vector<cvtdl_object_info_t> &bboxes, std::vector<cvtdl_object_info
   }
 }
 
-void OCRDetection::outputParser(float thresh, float boxThresh, cvtdl_object_t *obj_meta) {
+void OCRDetection::outputParser(float thresh, float nmsThresh, cvtdl_object_t *obj_meta) {
   float *out = getOutputRawPtr<float>(0);
   CVI_SHAPE output_shape = getOutputShape(0);
   int outHeight = output_shape.dim[2];
   int outWidth = output_shape.dim[3];
-  cv::Mat probMap(outHeight, outWidth, CV_32FC1, out);
-  cv::Mat binaryMap;
-  probMap.convertTo(binaryMap, CV_8UC1, 255.0);
-  cv::threshold(binaryMap, binaryMap, thresh * 255, 255, cv::THRESH_BINARY);
 
-  std::vector<std::vector<cv::Point>> contours;
-  cv::findContours(binaryMap, contours, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+  DBPostprocessConfig config = m_db_postprocess.config();
+  config.thresh = thresh;
+  m_db_postprocess.setConfig(config);
+  const std::vector<DBTextBox> &text_boxes =
+      m_db_postprocess.run(out, outWidth, outHeight, outWidth);
 
   std::vector<cvtdl_object_info_t> bboxes;
   CVI_SHAPE shape = getInputShape(0);
-  for (auto &contour : contours) {
-    double area = cv::contourArea(contour);
-    if (area < 10) continue;
-
-    cv::Rect boundingBox = cv::boundingRect(contour);
-
-    cvtdl_bbox_t bbox = {boundingBox.x, boundingBox.y, boundingBox.x + boundingBox.width,
-                         boundingBox.y + boundingBox.height};
+  for (const DBTextBox &text_box : text_boxes) {
+    cvtdl_bbox_t bbox = {text_box.x1, text_box.y1, text_box.x2, text_box.y2, text_box.score};
     cvtdl_bbox_t rescaled_bbox =
         box_rescale(obj_meta->width, obj_meta->height, shape.dim[3], shape.dim[2], bbox,
                     meta_rescale_type_e::RESCALE_CENTER);
 
     cvtdl_object_info_t objInfo;
+    memset(&objInfo, 0, sizeof(objInfo));
     objInfo.bbox = rescaled_bbox;
     bboxes.push_back(objInfo);
   }
 
   std::vector<cvtdl_object_info_t> bboxes_nms;
-  NMS(bboxes, bboxes_nms, boxThresh, 'u');
+  NMS(bboxes, bboxes_nms, nmsThresh, 'u');
 
   CVI_TDL_MemAllocInit(bboxes_nms.size(), obj_meta);
 
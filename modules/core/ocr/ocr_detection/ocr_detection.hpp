@@ -2,6 +2,7 @@
 #include "core/object/cvtdl_object_types.h"
 #include "core_internel.hpp"
 #include "cvi_comm.h"
+#include "db_postprocess.hpp"
 
 namespace cvitdl {
 
@@ -12,6 +13,8 @@ class OCRDetection final : public Core {
   int inference(VIDEO_FRAME_INFO_S *frame, cvtdl_object_t *obj_meta);
 
  private:
-  void outputParser(float thresh, float boxThresh, cvtdl_object_t *obj_meta);
+  void outputParser(float thresh, float nmsThresh, cvtdl_object_t *obj_meta);
+
+  DBPostprocess m_db_postprocess;
 };
 }  // namespace cvitdl
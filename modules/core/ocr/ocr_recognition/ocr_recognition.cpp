@@ -7,6 +7,7 @@
 
 #include "core/utils/vpss_helper.h"
 
+#include <string.h>
 #include <codecvt>
 #include <fstream>
 #include <iostream>
@@ -65,76 +66,59 @@ OCRRecognition::OCRRecognition() : Core(CVI_MEM_DEVICE) {
 }
 OCRRecognition::~OCRRecognition() {}
 
-int argmax(float* start, float* end) {
-  float* max_iter = std::max_element(start, end);
-  int max_idx = max_iter - start;
-  return max_idx;
-}
-
-template <typename InputIt, typename T>
-T my_accumulate(InputIt first, InputIt last, T init) {
-  for (; first != last; ++first) {
-    init = init + *first;
-  }
-  return init;
-}
-
-std::vector<std::string> ReadDict(const std::string& path) {
+static bool ReadDict(const std::string& path, std::vector<std::string>& chars) {
   std::ifstream in(path);
+  if (!in) {
+    return false;
+  }
+  chars.clear();
   std::string line;
-  std::vector<std::string> m_vec;
-  if (in) {
-    while (getline(in, line)) {
-      m_vec.push_back(line);
-    }
-  } else {
-    std::cout << "no such label file: " << path << ", exit the program..." << std::endl;
-    exit(1);
+  while (getline(in, line)) {
+    chars.push_back(line);
   }
-  return m_vec;
+  return true;
 }
 
-std::pair<std::string, float> OCRRecognition::decode(const std::vector<int>& text_index,
-                                                     const std::vector<float>& text_prob,
-                                                     std::vector<std::string>& chars,
-                                                     bool is_remove_duplicate) {
-  std::string text;
-  std::vector<float> conf_list;
-
-  for (size_t idx = 0; idx < text_index.size(); ++idx) {
-    if (is_remove_duplicate && idx > 0 && text_index[idx - 1] == text_index[idx]) {
-      continue;
-    }
-    text += chars[text_index[idx]];
-    conf_list.push_back(text_prob[idx]);
+int OCRRecognition::setBeamWidth(int beam_width) {
+  if (beam_width < 1) {
+    LOGE("invalid beam width: %d\n", beam_width);
+    return CVI_TDL_ERR_INVALID_ARGS;
   }
-
-  float average_conf = conf_list.empty() ? 0.0f
-                                         : my_accumulate(conf_list.begin(), conf_list.end(), 0.0f) /
-                                               conf_list.size();
-  return {text, average_conf};
+  m_beam_width = beam_width;
+  return CVI_TDL_SUCCESS;
 }
 
-void OCRRecognition::greedy_decode(float* prebs, std::vector<std::string>& chars) {
+void OCRRecognition::decode(const float* prebs, cvtdl_text_meta* text_meta) {
+  // steps x classes probabilities, class 0 is blank and class i > 0 is dictionary line i - 1
   CVI_SHAPE output_shape = getOutputShape(0);
-  int outShapeC = output_shape.dim[1];
-  int outHeight = output_shape.dim[2];
-  int outWidth = output_shape.dim[3];
-
-  std::vector<int> argmax_results(outShapeC, 0);
-  std::vector<float> confidences(outShapeC, 0.0f);
-
-  for (int t = 0; t < outShapeC; ++t) {
-    float* start = prebs + t * outWidth * outHeight;
-    float* end = prebs + (t + 1) * outWidth * outHeight;
-    int argmax_idx = argmax(start, end);
+  const int steps = output_shape.dim[1];
+  const int classes = output_shape.dim[2] * output_shape.dim[3];
+  CTCInput input = {prebs, steps, classes, classes, 1, false};
+  if (m_beam_width <= 1 || !m_decoder.beamSearch(input, m_beam_width, nullptr, &m_result)) {
+    m_decoder.greedy(input, &m_result);
+  }
 
-    argmax_results[t] = argmax_idx - 1;
-    confidences[t] = *(start + argmax_idx);
+  size_t len = 0;
+  const size_t max_len = sizeof(text_meta->text) - 1;
+  const size_t max_num = sizeof(text_meta->char_conf) / sizeof(text_meta->char_conf[0]);
+  text_meta->char_num = 0;
+  for (size_t i = 0; i < m_result.labels.size(); i++) {
+    const size_t label = m_result.labels[i];
+    // the class after the dictionary is the space
+    const char* c = label <= m_chars.size() ? m_chars[label - 1].c_str()
+                                             : (label == m_chars.size() + 1 ? " " : nullptr);
+    if (c == nullptr) continue;
+    const size_t c_len = strlen(c);
+    if (len + c_len > max_len) break;
+    memcpy(text_meta->text + len, c, c_len);
+    len += c_len;
+    if (text_meta->char_num < max_num) {
+      text_meta->char_conf[text_meta->char_num] = m_result.confidences[i];
+    }
+    text_meta->char_num++;
   }
-  auto result = decode(argmax_results, confidences, chars, true);
-  std::cout << "Decoded Text: " << result.first << ", Average Confidence: " << result.second
-            << std::endl;
+  text_meta->text[len] = '\0';
+  text_meta->score = m_result.score;
 }
 
 // 可以不通过det，打开下方接口
@@ -186,23 +170,21 @@ int OCRRecognition::inference(VIDEO_FRAME_INFO_S* frame, cvtdl_object_t* obj_met
   if (obj_meta->size == 0) {
     return CVI_TDL_SUCCESS;
   }
-  std::vector<std::string> myCharacters;
-  std::string filePath = "./ppocr_keys_v1.txt";
-  myCharacters = ReadDict(filePath);
+  if (m_chars.empty() && !ReadDict(m_dict_path, m_chars)) {
+    LOGE("no such label file: %s\n", m_dict_path.c_str());
+    return CVI_TDL_FAILURE;
+  }
 
   for (uint32_t i = 0; i < obj_meta->size; ++i) {
     cvtdl_object_info_t obj_info = info_extern_crop_resize_img(
         frame->stVFrame.u32Width, frame->stVFrame.u32Height, &(obj_meta->info[i]), 0.2, 0.5);
     VIDEO_FRAME_INFO_S* cropped_frame = new VIDEO_FRAME_INFO_S;
-    if (!cropped_frame) {
-      printf("Error: Memory allocation for cropped_frame failed! \n");
-      return -1;
-    }
     memset(cropped_frame, 0, sizeof(VIDEO_FRAME_INFO_S));
     CVI_SHAPE shape = getInputShape(0);
     int height = shape.dim[2];
     int width = shape.dim[3];
     vpssCropImage(frame, cropped_frame, obj_info.bbox, width, height, PIXEL_FORMAT_RGB_888_PLANAR);
+    CVI_TDL_FreeCpp(&obj_info);
 
     // 可以保存cropped_frame,此功能必须提供opencv支持
     // std::string save_path = std::to_string(i) + ".jpg";
@@ -212,19 +194,20 @@ int OCRRecognition::inference(VIDEO_FRAME_INFO_S* frame, cvtdl_object_t* obj_met
     int ret = run(frames);
     if (ret != CVI_TDL_SUCCESS) {
       mp_vpss_inst->releaseFrame(cropped_frame, 0);
-      if (cropped_frame) {
-        delete cropped_frame;
-        cropped_frame = nullptr;
-      }
+      delete cropped_frame;
       return ret;
     }
 
-    float* out = getOutputRawPtr<float>(0);
-    greedy_decode(out, myCharacters);
+    cvtdl_object_info_t& info = obj_meta->info[i];
+    if (info.text_properity == NULL) {
+      info.text_properity =
+          (cvtdl_text_meta*)CVI_TDL_MetaArenaAlloc(obj_meta, sizeof(cvtdl_text_meta));
+    }
+    decode(getOutputRawPtr<float>(0), info.text_properity);
     mp_vpss_inst->releaseFrame(cropped_frame, 0);
     delete cropped_frame;
   }
   return CVI_TDL_SUCCESS;
 }
 
-}  // namespace cvitdl
\ No newline at end of file
+}  // namespace cvitdl
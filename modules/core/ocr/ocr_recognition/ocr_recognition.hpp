@@ -1,6 +1,7 @@
 #pragma once
 #include "core/object/cvtdl_object_types.h"
 #include "core_internel.hpp"
+#include "ctc_decoder.hpp"
 #include "cvi_comm.h"
 
 namespace cvitdl {
@@ -10,11 +11,16 @@ class OCRRecognition final : public Core {
   OCRRecognition();
   virtual ~OCRRecognition();
   int inference(VIDEO_FRAME_INFO_S* frame, cvtdl_object_t* obj_meta);
+  /* 1 (default) decodes greedily, wider beams use the prefix beam search */
+  int setBeamWidth(int beam_width);
 
  private:
-  void greedy_decode(float* prebs, std::vector<std::string>& chars);
-  std::pair<std::string, float> decode(const std::vector<int>& text_index,
-                                       const std::vector<float>& text_prob,
-                                       std::vector<std::string>& chars, bool is_remove_duplicate);
+  void decode(const float* prebs, cvtdl_text_meta* text_meta);
+
+  std::string m_dict_path = "./ppocr_keys_v1.txt";
+  std::vector<std::string> m_chars;
+  int m_beam_width = 1;
+  CTCDecoder m_decoder;
+  CTCResult m_result;
 };
 }  // namespace cvitdl
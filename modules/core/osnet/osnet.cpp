@@ -44,7 +44,7 @@ int OSNet::inference(VIDEO_FRAME_INFO_S *stOutFrame, cvtdl_object_t *meta, int o
     int8_t *feature_blob = getOutputRawPtr<int8_t>(0);
     size_t feature_size = getOutputTensorElem(0);
     // Create feature
-    CVI_TDL_MemAlloc(sizeof(int8_t), feature_size, TYPE_INT8, &meta->info[i].feature);
+    CVI_TDL_MemAlloc(sizeof(int8_t), feature_size, TYPE_INT8, &meta->info[i].feature, meta);
     memcpy(meta->info[i].feature.ptr, feature_blob, feature_size);
   }
   return CVI_TDL_SUCCESS;
@@ -6,6 +6,7 @@
 #include "core_utils.hpp"
 #include "cvi_sys.h"
 #include "error_msg.hpp"
+#include "seg_utils.hpp"
 
 #define SCALE (1 / 127.5)
 #define MEAN 1.f
@@ -96,53 +97,30 @@ int Deeplabv3::inference(VIDEO_FRAME_INFO_S *frame, VIDEO_FRAME_INFO_S *out_fram
   return CVI_TDL_SUCCESS;
 }
 
-inline bool is_preserved_class(cvtdl_class_filter_t *filter, int32_t c) {
-  if (c == 0) return true;  // "unlabled class" should be preserved
-
-  if (filter->num_preserved_classes > 0) {
-    for (uint32_t j = 0; j < filter->num_preserved_classes; j++) {
-      if (filter->preserved_class_ids[j] == (uint32_t)c) {
-        return true;
-      }
-    }
-  }
-
-  return false;
-}
-
 int Deeplabv3::outputParser(cvtdl_class_filter_t *filter) {
-  float *out = getOutputRawPtr<float>(NAME_SCORE);
-
-  CVI_SHAPE output_shape = getOutputShape(NAME_SCORE);
-
-  int size = output_shape.dim[2] * output_shape.dim[3];
-  std::vector<float> max_prob(size, 0);
-
-  for (int32_t c = 0; c < output_shape.dim[1]; ++c) {
-    int size_offset = c * size;
-    for (int32_t h = 0; h < output_shape.dim[2]; ++h) {
-      int width_offset = h * output_shape.dim[3];
-      int frame_offset = h * m_label_frame.stVFrame.u32Stride[0];
-
-      for (int32_t w = 0; w < output_shape.dim[3]; ++w) {
-        if (out[size_offset + width_offset + w] > max_prob[width_offset + w]) {
-          m_label_frame.stVFrame.pu8VirAddr[0][frame_offset + w] = (int8_t)c;
-          max_prob[width_offset + w] = out[size_offset + width_offset + w];
-        }
-      }
-    }
+  const TensorInfo &oinfo = getOutputTensorInfo(NAME_SCORE);
+  CVI_SHAPE output_shape = oinfo.shape;
+  int channels = output_shape.dim[1];
+  int height = output_shape.dim[2];
+  int width = output_shape.dim[3];
+  if (channels > 256) {
+    LOGE("Deeplabv3 supports at most 256 classes, got %d\n", channels);
+    return CVI_TDL_FAILURE;
   }
 
+  // argmax and class filter in a single pass, "unlabeled class" 0 is always preserved
+  uint8_t class_lut[256];
   if (filter) {
-    for (int32_t h = 0; h < output_shape.dim[2]; ++h) {
-      int frame_offset = h * m_label_frame.stVFrame.u32Stride[0];
-
-      for (int32_t w = 0; w < output_shape.dim[3]; ++w) {
-        if (!is_preserved_class(filter, m_label_frame.stVFrame.pu8VirAddr[0][frame_offset + w])) {
-          m_label_frame.stVFrame.pu8VirAddr[0][frame_offset + w] = 0;
-        }
-      }
-    }
+    BuildClassFilterLUT(filter, class_lut);
+  }
+  uint8_t *labels = m_label_frame.stVFrame.pu8VirAddr[0];
+  int label_stride = m_label_frame.stVFrame.u32Stride[0];
+  if (oinfo.tensor_size / oinfo.tensor_elem == 1) {
+    ChannelArgmax(static_cast<int8_t *>(oinfo.raw_pointer), channels, height, width, oinfo.qscale,
+                  filter ? class_lut : NULL, labels, label_stride, NULL);
+  } else {
+    ChannelArgmax(static_cast<float *>(oinfo.raw_pointer), channels, height, width,
+                  filter ? class_lut : NULL, labels, label_stride, NULL);
   }
 
   CVI_SYS_IonFlushCache(m_label_frame.stVFrame.u64PhyAddr[0], m_label_frame.stVFrame.pu8VirAddr[0],
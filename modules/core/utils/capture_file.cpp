@@ -0,0 +1,223 @@
+#include "capture_file.hpp"
+#include <string.h>
+#include <chrono>
+#include "core/core/cvtdl_errno.h"
+#include "core/utils/vpss_helper.h"
+#include "cvi_tdl_log.hpp"
+
+namespace cvitdl {
+
+static const char CAPTURE_MAGIC[8] = {'T', 'D', 'L', 'C', 'A', 'P', '0', '1'};
+static const char CAPTURE_INDEX_MAGIC[4] = {'T', 'D', 'L', 'I'};
+
+int CaptureWriter::open(const char *filepath, bool with_pixels) {
+  close();
+  mp_file = fopen(filepath, "wb");
+  if (mp_file == nullptr) {
+    LOGE("cannot create capture file %s\n", filepath);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  if (fwrite(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC), 1, mp_file) != 1) {
+    LOGE("cannot write capture file %s\n", filepath);
+    fclose(mp_file);
+    mp_file = nullptr;
+    return CVI_TDL_FAILURE;
+  }
+  m_with_pixels = with_pixels;
+  m_index.clear();
+  return CVI_TDL_SUCCESS;
+}
+
+int CaptureWriter::close() {
+  if (mp_file == nullptr) return CVI_TDL_SUCCESS;
+  CaptureFooter footer;
+  footer.index_offset = ftello(mp_file);
+  footer.num_calls = m_index.size();
+  memcpy(footer.magic, CAPTURE_INDEX_MAGIC, sizeof(footer.magic));
+  bool ok = m_index.empty() ||
+            fwrite(m_index.data(), sizeof(CaptureIndexEntry), m_index.size(), mp_file) ==
+                m_index.size();
+  ok = ok && fwrite(&footer, sizeof(footer), 1, mp_file) == 1;
+  ok = (fclose(mp_file) == 0) && ok;
+  mp_file = nullptr;
+  m_index.clear();
+  if (!ok) {
+    LOGE("failed to write the capture index\n");
+    return CVI_TDL_FAILURE;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+int CaptureWriter::writeRecord(uint32_t type, const std::string &name, const void *data,
+                               size_t size, const void *data2, size_t size2) {
+  if (mp_file == nullptr) return CVI_TDL_FAILURE;
+  if (type != CAPTURE_RECORD_FRAME && m_index.empty()) {
+    LOGE("capture record written before the first frame\n");
+    return CVI_TDL_FAILURE;
+  }
+  CaptureRecordHeader header = {type, (uint32_t)name.size(), size + size2};
+  bool ok = fwrite(&header, sizeof(header), 1, mp_file) == 1;
+  ok = ok && (name.empty() || fwrite(name.data(), name.size(), 1, mp_file) == 1);
+  ok = ok && (size == 0 || fwrite(data, size, 1, mp_file) == 1);
+  ok = ok && (size2 == 0 || fwrite(data2, size2, 1, mp_file) == 1);
+  if (!ok) {
+    LOGE("failed to write capture record, capture stopped\n");
+    close();
+    return CVI_TDL_FAILURE;
+  }
+  m_index.back().num_records++;
+  return CVI_TDL_SUCCESS;
+}
+
+int CaptureWriter::beginCall(VIDEO_FRAME_INFO_S *frame) {
+  if (mp_file == nullptr) return CVI_TDL_FAILURE;
+  const VIDEO_FRAME_S &v = frame->stVFrame;
+  CaptureIndexEntry entry = {};
+  entry.offset = ftello(mp_file);
+  entry.timestamp_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                           .count();
+  m_index.push_back(entry);
+
+  CaptureFrameInfo info = {};
+  info.width = v.u32Width;
+  info.height = v.u32Height;
+  info.pixel_format = v.enPixelFormat;
+  for (int i = 0; i < 3; i++) {
+    info.stride[i] = v.u32Stride[i];
+    info.length[i] = v.u32Length[i];
+  }
+  if (!m_with_pixels) {
+    return writeRecord(CAPTURE_RECORD_FRAME, "", &info, sizeof(info));
+  }
+
+  // the planes are contiguous for the frames of the SDK helpers, copy them one by one anyway
+  size_t total = v.u32Length[0] + v.u32Length[1] + v.u32Length[2];
+  bool do_unmap = false;
+  uint8_t *planes[3] = {v.pu8VirAddr[0], v.pu8VirAddr[1], v.pu8VirAddr[2]};
+  if (planes[0] == nullptr) {
+    planes[0] = (uint8_t *)CVI_SYS_Mmap(v.u64PhyAddr[0], total);
+    if (planes[0] == nullptr) {
+      LOGE("failed to map the frame, captured without pixels\n");
+      return writeRecord(CAPTURE_RECORD_FRAME, "", &info, sizeof(info));
+    }
+    planes[1] = planes[0] + (v.u64PhyAddr[1] - v.u64PhyAddr[0]);
+    planes[2] = planes[0] + (v.u64PhyAddr[2] - v.u64PhyAddr[0]);
+    do_unmap = true;
+  }
+  info.has_pixels = 1;
+  m_buffer.resize(total);
+  size_t offset = 0;
+  for (int i = 0; i < 3; i++) {
+    if (v.u32Length[i] == 0) continue;
+    memcpy(m_buffer.data() + offset, planes[i], v.u32Length[i]);
+    offset += v.u32Length[i];
+  }
+  if (do_unmap) CVI_SYS_Munmap(planes[0], total);
+  return writeRecord(CAPTURE_RECORD_FRAME, "", &info, sizeof(info), m_buffer.data(), total);
+}
+
+int CaptureWriter::writeTensor(const std::string &name, const void *data, size_t size) {
+  return writeRecord(CAPTURE_RECORD_TENSOR, name, data, size);
+}
+
+int CaptureWriter::writeObjects(const cvtdl_object_t *obj) {
+  m_buffer.resize(obj->size * sizeof(CaptureBox));
+  CaptureBox *boxes = reinterpret_cast<CaptureBox *>(m_buffer.data());
+  for (uint32_t i = 0; i < obj->size; i++) {
+    boxes[i].bbox = obj->info[i].bbox;
+    boxes[i].classes = obj->info[i].classes;
+  }
+  return writeRecord(CAPTURE_RECORD_OBJECT, "", m_buffer.data(), m_buffer.size());
+}
+
+int CaptureWriter::writeFaces(const cvtdl_face_t *face) {
+  m_buffer.resize(face->size * sizeof(CaptureBox));
+  CaptureBox *boxes = reinterpret_cast<CaptureBox *>(m_buffer.data());
+  for (uint32_t i = 0; i < face->size; i++) {
+    boxes[i].bbox = face->info[i].bbox;
+    boxes[i].classes = 0;
+  }
+  return writeRecord(CAPTURE_RECORD_FACE, "", m_buffer.data(), m_buffer.size());
+}
+
+int CaptureReader::open(const char *filepath) {
+  close();
+  mp_file = fopen(filepath, "rb");
+  if (mp_file == nullptr) {
+    LOGE("cannot open capture file %s\n", filepath);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  char magic[sizeof(CAPTURE_MAGIC)];
+  CaptureFooter footer;
+  bool ok = fread(magic, sizeof(magic), 1, mp_file) == 1 &&
+            memcmp(magic, CAPTURE_MAGIC, sizeof(magic)) == 0;
+  ok = ok && fseeko(mp_file, -(off_t)sizeof(footer), SEEK_END) == 0 &&
+       fread(&footer, sizeof(footer), 1, mp_file) == 1 &&
+       memcmp(footer.magic, CAPTURE_INDEX_MAGIC, sizeof(footer.magic)) == 0;
+  if (ok) {
+    m_index.resize(footer.num_calls);
+    ok = fseeko(mp_file, footer.index_offset, SEEK_SET) == 0 &&
+         (m_index.empty() ||
+          fread(m_index.data(), sizeof(CaptureIndexEntry), m_index.size(), mp_file) ==
+              m_index.size());
+  }
+  if (!ok) {
+    LOGE("%s is not a complete capture file\n", filepath);
+    close();
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  m_index_offset = footer.index_offset;
+  m_cursor = sizeof(CAPTURE_MAGIC);
+  return CVI_TDL_SUCCESS;
+}
+
+void CaptureReader::close() {
+  if (mp_file != nullptr) fclose(mp_file);
+  mp_file = nullptr;
+  m_index.clear();
+  m_index_offset = 0;
+  m_cursor = 0;
+}
+
+int CaptureReader::readRecord(CaptureRecord *record) {
+  CaptureRecordHeader header;
+  if (fread(&header, sizeof(header), 1, mp_file) != 1 ||
+      (uint64_t)ftello(mp_file) + header.name_len + header.size > m_index_offset) {
+    LOGE("truncated capture record\n");
+    return CVI_TDL_FAILURE;
+  }
+  record->type = header.type;
+  record->name.resize(header.name_len);
+  record->data.resize(header.size);
+  if ((header.name_len != 0 && fread(&record->name[0], header.name_len, 1, mp_file) != 1) ||
+      (header.size != 0 && fread(record->data.data(), header.size, 1, mp_file) != 1)) {
+    LOGE("truncated capture record\n");
+    return CVI_TDL_FAILURE;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+int CaptureReader::readCall(size_t i, std::vector<CaptureRecord> *records) {
+  if (mp_file == nullptr || i >= m_index.size()) return CVI_TDL_ERR_INVALID_ARGS;
+  if (fseeko(mp_file, m_index[i].offset, SEEK_SET) != 0) return CVI_TDL_FAILURE;
+  records->resize(m_index[i].num_records);
+  for (CaptureRecord &record : *records) {
+    int ret = readRecord(&record);
+    if (ret != CVI_TDL_SUCCESS) return ret;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+int CaptureReader::readNext(uint32_t type, CaptureRecord *record) {
+  if (mp_file == nullptr || fseeko(mp_file, m_cursor, SEEK_SET) != 0) return CVI_TDL_FAILURE;
+  while (m_cursor < m_index_offset) {
+    int ret = readRecord(record);
+    if (ret != CVI_TDL_SUCCESS) return ret;
+    m_cursor = ftello(mp_file);
+    if (record->type == type) return CVI_TDL_SUCCESS;
+  }
+  return CVI_TDL_FAILURE;
+}
+
+}  // namespace cvitdl
@@ -0,0 +1,115 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "core/face/cvtdl_face_types.h"
+#include "core/object/cvtdl_object_types.h"
+#include "cvi_comm.h"
+
+namespace cvitdl {
+
+/**
+ * Capture file of one model, written while capturing and read back for replay.
+ *
+ *   "TDLCAP01"
+ *   records            CaptureRecordHeader, name, payload
+ *   index              CaptureIndexEntry per inference call
+ *   CaptureFooter
+ *
+ * An inference call starts with a CAPTURE_RECORD_FRAME record of its input frame, followed by
+ * the output tensors of every Core::run of the call, in output order, and the result meta.
+ * Values are stored in host byte order.
+ */
+enum CaptureRecordType : uint32_t {
+  CAPTURE_RECORD_FRAME = 1,
+  CAPTURE_RECORD_TENSOR,
+  CAPTURE_RECORD_OBJECT,
+  CAPTURE_RECORD_FACE,
+};
+
+struct CaptureRecordHeader {
+  uint32_t type;
+  uint32_t name_len;
+  uint64_t size;
+};
+
+struct CaptureIndexEntry {
+  uint64_t offset;
+  uint64_t timestamp_us;
+  uint32_t num_records;
+  uint32_t reserved;
+};
+
+struct CaptureFooter {
+  uint64_t index_offset;
+  uint32_t num_calls;
+  char magic[4];
+};
+
+/* payload of CAPTURE_RECORD_FRAME, followed by the planes if has_pixels */
+struct CaptureFrameInfo {
+  uint32_t width;
+  uint32_t height;
+  uint32_t pixel_format;
+  uint32_t has_pixels;
+  uint32_t stride[3];
+  uint32_t length[3];
+};
+
+/* element of CAPTURE_RECORD_OBJECT and CAPTURE_RECORD_FACE, classes is 0 for faces */
+struct CaptureBox {
+  cvtdl_bbox_t bbox;
+  int32_t classes;
+};
+
+struct CaptureRecord {
+  uint32_t type;
+  std::string name;
+  std::vector<uint8_t> data;
+};
+
+class CaptureWriter {
+ public:
+  ~CaptureWriter() { close(); }
+
+  int open(const char *filepath, bool with_pixels);
+  /* writes the index, the file is unreadable if the process dies before */
+  int close();
+  int beginCall(VIDEO_FRAME_INFO_S *frame);
+  int writeTensor(const std::string &name, const void *data, size_t size);
+  int writeObjects(const cvtdl_object_t *obj);
+  int writeFaces(const cvtdl_face_t *face);
+
+ private:
+  int writeRecord(uint32_t type, const std::string &name, const void *data, size_t size,
+                  const void *data2 = nullptr, size_t size2 = 0);
+
+  FILE *mp_file = nullptr;
+  bool m_with_pixels = false;
+  std::vector<CaptureIndexEntry> m_index;
+  std::vector<uint8_t> m_buffer;
+};
+
+class CaptureReader {
+ public:
+  ~CaptureReader() { close(); }
+
+  int open(const char *filepath);
+  void close();
+  size_t numCalls() const { return m_index.size(); }
+  const CaptureIndexEntry &call(size_t i) const { return m_index[i]; }
+  int readCall(size_t i, std::vector<CaptureRecord> *records);
+  /* sequential reading from the first record, for Core::run while replaying */
+  int readNext(uint32_t type, CaptureRecord *record);
+
+ private:
+  int readRecord(CaptureRecord *record);
+
+  FILE *mp_file = nullptr;
+  std::vector<CaptureIndexEntry> m_index;
+  uint64_t m_index_offset = 0;
+  uint64_t m_cursor = 0;
+};
+
+}  // namespace cvitdl
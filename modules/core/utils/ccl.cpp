@@ -1,4 +1,3 @@
-
 #include "ccl.hpp"
 #include <stdint.h>
 #include <algorithm>
@@ -7,79 +6,31 @@
 #include <iostream>
 #include <vector>
 #include "cvi_tdl_log.hpp"
-#define CC_MAX_NUM_LABELS 200
-#define MAX_CC_OBJECTS 200
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
 
 #define CC_SUPER_PIXEL_H 2
 #define CC_SUPER_PIXEL_W 2
-#define CC_SCAN_WINDOW_H 2
-#define CC_SCAN_WINDOW_W 2
 #define CC_FG_SUPER_PIX_THD 3
 #define BLOCK_SIZE 2
 
 typedef struct CCTag {
-  int maskWidth;
-  int maskHeight;
-  int ccSuperPixelSize;
-  int superPixMapW;
-  int superPixMapH;
-
-  int numTotalObj;
-
-  int maxID;
-
-  unsigned char *dataSuperPixMap;
-  unsigned char *dataSuperPixFG;
-  unsigned char *eqCCLabelArray;
-
-  int numObjects;
-  int *boundingBoxesTmp;
-  int *boundingBoxes;
-
+  int maskWidth = 0;
+  int maskHeight = 0;
+  int superPixMapW = 0;
+  int superPixMapH = 0;
+
+  // foreground count of every super pixel
+  std::vector<uint8_t> superPixFG;
+  // super pixels marked by the scanning window
+  std::vector<uint8_t> superPixMap;
+  cvitdl::ConnectedComponents labeler;
+  // [size, R0, C0, R1, C1] of every object
+  std::vector<int> boundingBoxes;
 } CCLType;
 
-void *create_connect_instance() {
-  CCLType *p_inst = new CCLType();
-  memset(p_inst, 0, sizeof(CCLType));
-  return p_inst;
-}
-
-void init_connected_component(CCLType *ccGst, int width, int height) {
-  int superPixMapW, superPixMapH;
-
-  ccGst->maskWidth = width;
-  ccGst->maskHeight = height;
-
-  ccGst->superPixMapW = width / CC_SUPER_PIXEL_W;
-  ccGst->superPixMapH = height / CC_SUPER_PIXEL_H;
-
-  superPixMapW = ccGst->superPixMapW;
-  superPixMapH = ccGst->superPixMapH;
-
-  ccGst->dataSuperPixMap = new unsigned char[superPixMapW * superPixMapH];
-
-  memset(ccGst->dataSuperPixMap, 0, superPixMapH * superPixMapW);
-
-  ccGst->dataSuperPixFG = new unsigned char[superPixMapH * superPixMapW];
-  memset(ccGst->dataSuperPixFG, 0, superPixMapH * superPixMapW);
-
-  ccGst->eqCCLabelArray = new unsigned char[CC_MAX_NUM_LABELS + 1];
-
-  ccGst->boundingBoxesTmp = new int[MAX_CC_OBJECTS * 5];
-  ccGst->boundingBoxes = new int[MAX_CC_OBJECTS * 5];
-}
-
-void release_connected_component(CCLType *ccGst) {
-  if (ccGst->maskWidth > 0 && ccGst->maskHeight > 0) {
-    delete[] ccGst->dataSuperPixMap;
-    delete[] ccGst->dataSuperPixFG;
-    delete[] ccGst->eqCCLabelArray;
-    delete[] ccGst->boundingBoxesTmp;
-    delete[] ccGst->boundingBoxes;
-  }
-
-  memset(ccGst, 0, sizeof(CCLType));
-}
+void *create_connect_instance() { return new CCLType(); }
 
 bool cluster_box(int *p_boxes, int ci, int i) {
   // check if intersect
@@ -173,296 +124,307 @@ int dump_ive_image_frame(const std::string &filepath, uint8_t *ptr_img, int w, i
 }
 int *extract_connected_component(unsigned char *p_fg_mask, int width, int height, int wstride,
                                  int area_thresh, void *p_cc_inst, int *p_num_boxes) {
-  int r, c, i, j, rBlk, cBlk;
-  int xA, xB, xC, xD;
-  int cumulatedBlkSum, superPixMapW, superPixMapH;
-  int ctFGPixels, imgDataWStep;
-  int lbVal, currLabel, R0, C0, R1, C1, objectSize;
-  int tmpMaxLabel;
-
-  unsigned char *ptrImgData;
-  unsigned char *ptrImgData0;
-  unsigned char *ptrSuperPixMap;
-  unsigned char *ptrSuperPixMap0;
-  unsigned char *ptrSuperPixFG;
-  unsigned char *ptrSuperPixFG0;
-  unsigned char *ptrLabelMap;
-  unsigned char *ptrLabelMap0;
-  unsigned char *eqLabelArray;
-  unsigned char *ptrUCHAR;
-
-  int *boundingBoxes;
-  int *boundingBoxesFinal;
-  int ctFinal;
-
   CCLType *ccGst = (CCLType *)p_cc_inst;
   if (ccGst->maskWidth != width || ccGst->maskHeight != height) {
     LOGI("allocate ccl,w:%d,h:%d\n", width, height);
-
-    release_connected_component(ccGst);
-    init_connected_component(ccGst, width, height);
-    // std::cout<<"to allocate
-    // ccl,w:"<<width<<",height:"<<height<<",maskw:"<<ccGst->maskWidth<<std::endl;
+    ccGst->maskWidth = width;
+    ccGst->maskHeight = height;
+    ccGst->superPixMapW = width / CC_SUPER_PIXEL_W;
+    ccGst->superPixMapH = height / CC_SUPER_PIXEL_H;
+    ccGst->superPixFG.assign(ccGst->superPixMapW * ccGst->superPixMapH, 0);
+    ccGst->superPixMap.assign(ccGst->superPixMapW * ccGst->superPixMapH, 0);
+  }
+  const int superPixMapW = ccGst->superPixMapW;
+  const int superPixMapH = ccGst->superPixMapH;
+  uint8_t *superPixFG = ccGst->superPixFG.data();
+  uint8_t *superPixMap = ccGst->superPixMap.data();
+
+  /* Sum up foreground count within super pixels. */
+  for (int rBlk = 0; rBlk < superPixMapH; rBlk++) {
+    const uint8_t *row0 = p_fg_mask + rBlk * CC_SUPER_PIXEL_H * wstride;
+    const uint8_t *row1 = row0 + wstride;
+    uint8_t *fg = superPixFG + rBlk * superPixMapW;
+    for (int cBlk = 0; cBlk < superPixMapW; cBlk++) {
+      const int c = cBlk * CC_SUPER_PIXEL_W;
+      fg[cBlk] = (row0[c] != 0) + (row0[c + 1] != 0) + (row1[c] != 0) + (row1[c + 1] != 0);
+    }
   }
 
-  // imgW = ccGst->maskWidth;
-  superPixMapW = ccGst->superPixMapW;
-  superPixMapH = ccGst->superPixMapH;
-
-  ptrSuperPixMap0 = ccGst->dataSuperPixMap;
-  ptrSuperPixFG0 = ccGst->dataSuperPixFG;
-  eqLabelArray = ccGst->eqCCLabelArray;
-
-  ptrImgData0 = p_fg_mask;
-
-  tmpMaxLabel = 0;
-
-  /* reset foreground super pixels.*/
-  memset(ccGst->dataSuperPixMap, 0, superPixMapH * superPixMapW * sizeof(unsigned char));
-  memset(ccGst->dataSuperPixFG, 0, superPixMapH * superPixMapW * sizeof(unsigned char));
-
-  ptrUCHAR = ccGst->eqCCLabelArray;
-
-  for (i = 0; i < (CC_MAX_NUM_LABELS + 1); i += 1) {
-    *ptrUCHAR = i;
-    ptrUCHAR += 1;
+  /* Mark the 2x2 super pixels of every scanning window holding enough foreground. */
+  memset(superPixMap, 0, superPixMapW * superPixMapH);
+  for (int r = 0; r < superPixMapH - 2; r++) {
+    const uint8_t *fg0 = superPixFG + r * superPixMapW;
+    const uint8_t *fg1 = fg0 + superPixMapW;
+    uint8_t *map0 = superPixMap + r * superPixMapW;
+    uint8_t *map1 = map0 + superPixMapW;
+    for (int c = 0; c < superPixMapW - 2; c++) {
+      if (fg0[c] + fg0[c + 1] + fg1[c] + fg1[c + 1] > CC_FG_SUPER_PIX_THD) {
+        map0[c] = map0[c + 1] = map1[c] = map1[c + 1] = 255;
+      }
+    }
   }
 
-  ccGst->numTotalObj = 0;
+  /* Connected component labeling, the first row and column are left out as before. */
+  uint32_t numLabels = 0;
+  if (superPixMapW > 1 && superPixMapH > 1) {
+    numLabels = ccGst->labeler.label(superPixMap + superPixMapW + 1, superPixMapW - 1,
+                                     superPixMapH - 1, superPixMapW);
+  }
+  const std::vector<cvitdl::CCLStats> &stats = ccGst->labeler.stats();
 
-  /***********************************************/
-  /*	Sum up foreground count within suer pixels.*/
-  imgDataWStep = (CC_SUPER_PIXEL_H * wstride);
+  // clean up: remove small ones and remove overlap
+  std::vector<int> &boundingBoxes = ccGst->boundingBoxes;
+  boundingBoxes.resize(5 * std::max(numLabels, 1u));
+  int ctFinal = 0;
+  int area_super_thresh = area_thresh / BLOCK_SIZE / BLOCK_SIZE;
+  for (uint32_t i = 0; i < numLabels; i++) {
+    int objectSize = (int)stats[i].area;
+    if (objectSize > area_super_thresh) {
+      int R0 = (stats[i].y0 + 1) * BLOCK_SIZE;
+      int C0 = (stats[i].x0 + 1) * BLOCK_SIZE;
+      int R1 = (stats[i].y1 + 1) * BLOCK_SIZE;
+      int C1 = (stats[i].x1 + 1) * BLOCK_SIZE;
+      int area = (C1 - C0) * (R1 - R0);
+      if (area < area_thresh) continue;
+      int *box = boundingBoxes.data() + 5 * ctFinal;
+      box[0] = objectSize;
+      box[1] = R0;
+      box[2] = C0;
+      box[3] = R1;
+      box[4] = C1;
+      ctFinal++;
+    }
+  }
 
-  for (rBlk = 0; rBlk < superPixMapH; rBlk += 1) {
-    for (cBlk = 0; cBlk < superPixMapW; cBlk += 1) {
-      ptrImgData = ptrImgData0 + (rBlk * imgDataWStep) + (cBlk * CC_SUPER_PIXEL_W);
+  ctFinal = filter_inside_boxes(boundingBoxes.data(), ctFinal);
+  ctFinal = filter_inside_boxes(boundingBoxes.data(), ctFinal);
+  *p_num_boxes = ctFinal;
+  return boundingBoxes.data();
+} /*end of: void extract_connected_component() | connected component labeling.*/
 
-      cumulatedBlkSum = 0;
+void destroy_connected_component(void *ccGst) {
+  if (ccGst == NULL) return;
+  delete (CCLType *)ccGst;
+}
 
-      for (r = 0; r < CC_SUPER_PIXEL_H; r += 1) {
-        for (c = 0; c < CC_SUPER_PIXEL_W; c += 1) {
-          if ((*ptrImgData) > 0) cumulatedBlkSum += 1;
-
-          ptrImgData += 1;
-        } /* c */
-
-        ptrImgData += (wstride - CC_SUPER_PIXEL_W);
-      } /* r */
-
-      *(ptrSuperPixFG0 + (rBlk * superPixMapW) + cBlk) = cumulatedBlkSum;
-    } /*end of: for ( cBlk )*/
-  }   /*end of: for ( rBlk )*/
+namespace cvitdl {
 
-  /**************************/
-  /* Scan image for objects */
-  /**************************/
+namespace {
 
-  for (r = 0; r < (superPixMapH - CC_SCAN_WINDOW_H); r += 1) {
-    for (c = 0; c < (superPixMapW - CC_SCAN_WINDOW_W); c += 1) {
-      /* sum up pixel in scanning window.*/
+inline bool hasZeroByte(uint64_t v) {
+  return ((v - 0x0101010101010101ULL) & ~v & 0x8080808080808080ULL) != 0;
+}
 
-      ctFGPixels = 0;
-
-      ptrSuperPixFG = ptrSuperPixFG0 + (r * superPixMapW) + c;
+/* first foreground pixel at or after x, width if none */
+inline int skipBackground(const uint8_t *row, int x, int width) {
+#if defined(__aarch64__)
+  while (x + 16 <= width && vmaxvq_u8(vld1q_u8(row + x)) == 0) x += 16;
+#endif
+  uint64_t v;
+  while (x + 8 <= width) {
+    memcpy(&v, row + x, sizeof(v));
+    if (v != 0) break;
+    x += 8;
+  }
+  while (x < width && row[x] == 0) x++;
+  return x;
+}
 
-      for (i = 0; i < CC_SCAN_WINDOW_H; i += 1) {
-        for (j = 0; j < CC_SCAN_WINDOW_W; j += 1) {
-          ctFGPixels += (*ptrSuperPixFG);
-          ptrSuperPixFG += 1;
-
-        } /* col: j */
-
-        ptrSuperPixFG += (superPixMapW - CC_SCAN_WINDOW_W);
-      } /* row: i */
-
-      /* mark foreground.*/
+/* first background pixel at or after x, width if none */
+inline int skipForeground(const uint8_t *row, int x, int width) {
+#if defined(__aarch64__)
+  while (x + 16 <= width && vminvq_u8(vld1q_u8(row + x)) != 0) x += 16;
+#endif
+  uint64_t v;
+  while (x + 8 <= width) {
+    memcpy(&v, row + x, sizeof(v));
+    if (hasZeroByte(v)) break;
+    x += 8;
+  }
+  while (x < width && row[x] != 0) x++;
+  return x;
+}
 
-      if (ctFGPixels > CC_FG_SUPER_PIX_THD) {
-        ptrSuperPixMap = ptrSuperPixMap0 + (r * superPixMapW) + c;
+}  // namespace
 
-        for (i = 0; i < CC_SCAN_WINDOW_H; i += 1) {
-          for (j = 0; j < CC_SCAN_WINDOW_W; j += 1) {
-            *(ptrSuperPixMap) = 255;
-            ptrSuperPixMap += 1;
-          }
-
-          ptrSuperPixMap += (superPixMapW - CC_SCAN_WINDOW_W);
-        }
-
-      } /*end of: mark foreground.*/
-
-    } /*end of: for ( c )*/
-  }   /*end of: for ( r )*/
-
-  // now the map is saved in ptrSuperPixMap
-  /*	Connected component labeling.*/
-
-  currLabel = 1;
-  // dump_ive_image_frame("/mnt/data/admin1_data/alios_test/md/fg.bin",ptrSuperPixMap0,ccGst->superPixMapW,ccGst->superPixMapH,ccGst->superPixMapW);
-  /* put label in [*ptrSuperPixFG].*/
-  memset(ccGst->dataSuperPixFG, 0, superPixMapH * superPixMapW * sizeof(unsigned char));
-  ptrLabelMap0 = ccGst->dataSuperPixFG;
-
-  /* the 1st pass for setting label and flooding label.*/
-  for (r = 1; r < superPixMapH; r += 1) {
-    ptrSuperPixMap = ptrSuperPixMap0 + (r * superPixMapW) + 1;
-    ptrLabelMap = ptrLabelMap0 + (r * superPixMapW) + 1;
-
-    for (c = 1; c < superPixMapW; c += 1) {
-      if ((*ptrSuperPixMap) > 0) {
-        /*	xB	xC	xD	*/
-        /*	xA	x		*/
-        xA = *(ptrLabelMap - 1);
-        xB = *(ptrLabelMap - 1 - superPixMapW);
-        xC = *(ptrLabelMap - superPixMapW);
-        xD = *(ptrLabelMap - superPixMapW + 1);
-
-        lbVal = CC_MAX_NUM_LABELS;
-
-        if (xA > 0) lbVal = xA;
-        if ((xB > 0) && (xB < lbVal)) lbVal = xB;
-        if ((xC > 0) && (xC < lbVal)) lbVal = xC;
-        if ((xD > 0) && (xD < lbVal)) lbVal = xD;
-
-        if (lbVal < CC_MAX_NUM_LABELS) {
-          /* make connection and flood label.*/
-          if (xA > lbVal) {
-            *(eqLabelArray + xA) = *(eqLabelArray + lbVal);
-          }
-          if (xB > lbVal) {
-            *(eqLabelArray + xB) = *(eqLabelArray + lbVal);
-          }
-          if (xC > lbVal) {
-            *(eqLabelArray + xC) = *(eqLabelArray + lbVal);
-          }
-          if (xD > lbVal) {
-            *(eqLabelArray + xD) = *(eqLabelArray + lbVal);
-          }
-        } else {
-          /* new label.*/
-          lbVal = currLabel;
-          if (currLabel <
-              (CC_MAX_NUM_LABELS - 1)) {  // the maximum label would be CC_MAX_NUM_LABELS-1
-            currLabel += 1;
-          }
-        }
-
-        /* save label for this pixel.*/
-        *(ptrLabelMap) = lbVal;
-
-      } /*end of: if foreground.*/
-
-      ptrSuperPixMap += 1;
-      ptrLabelMap += 1;
-    } /* col */
-  }   /* row */
-
-  /* the 2nd pass to flush with equivalent labels.*/
-  for (r = 1; r < superPixMapH; r += 1) {
-    ptrLabelMap = ptrLabelMap0 + (r * superPixMapW) + 1;
-
-    for (c = 1; c < superPixMapW; c += 1) {
-      lbVal = (*ptrLabelMap);
-
-      if (lbVal > 0) {
-        /* equivalent label.*/
-        lbVal = *(eqLabelArray + lbVal);
-        *ptrLabelMap = lbVal;
-
-        // find the maximal label.
-        if (lbVal > tmpMaxLabel) {
-          tmpMaxLabel = lbVal;
-        }
-
-        // display only:
-        *(ccGst->dataSuperPixMap + (r * superPixMapW) + c) = lbVal;
-
-      } /*end of: if foreground.*/
-
-      ptrLabelMap += 1;
-    } /* col */
-  }   /* row */
-
-  // this would not happen
-  if (tmpMaxLabel > CC_MAX_NUM_LABELS) {
-    printf("ccl error maxlable:%d\n", tmpMaxLabel);
-    *p_num_boxes = 0;
-    return ccGst->boundingBoxes;
+ConnectedComponents::ConnectedComponents(const CCLConfig &config) : m_config(config) {
+  if (m_config.connectivity != 4 && m_config.connectivity != 8) {
+    LOGW("unsupported ccl connectivity %d, use 8\n", m_config.connectivity);
+    m_config.connectivity = 8;
   }
-  ccGst->maxID = tmpMaxLabel;
+  m_config.downsample = std::max(m_config.downsample, 1);
+  m_config.block_threshold = std::max(m_config.block_threshold, 1);
+}
 
-  if (tmpMaxLabel > 0) {
-    tmpMaxLabel = tmpMaxLabel;
+uint32_t ConnectedComponents::find(uint32_t label) {
+  while (m_parent[label] != label) {
+    m_parent[label] = m_parent[m_parent[label]];
+    label = m_parent[label];
   }
+  return label;
+}
 
-  // determine the bounding boxes of each object
-  boundingBoxes = ccGst->boundingBoxesTmp;
-  for (i = 0; i <= ccGst->maxID; i++) {
-    boundingBoxes[5 * i + 0] = 0;
-    boundingBoxes[5 * i + 1] = 10000;
-    boundingBoxes[5 * i + 2] = 10000;
-    boundingBoxes[5 * i + 3] = -10000;
-    boundingBoxes[5 * i + 4] = -10000;
+uint32_t ConnectedComponents::merge(uint32_t a, uint32_t b) {
+  a = find(a);
+  b = find(b);
+  // the smaller label stays root, so parents always precede their children
+  if (a < b) {
+    m_parent[b] = a;
+    return a;
   }
+  m_parent[a] = b;
+  return b;
+}
 
-  for (r = 1; r < superPixMapH; r += 1) {
-    ptrLabelMap = ccGst->dataSuperPixMap + (r * superPixMapW) + 1;
+uint32_t ConnectedComponents::label(const uint8_t *mask, int width, int height, int stride) {
+  const int ds = m_config.downsample;
+  if (ds == 1) {
+    return labelMapRuns(mask, width, height, stride);
+  }
 
-    for (c = 1; c < superPixMapW; c += 1) {
-      lbVal = *ptrLabelMap;
-      ptrLabelMap++;
+  const int map_w = (width + ds - 1) / ds;
+  const int map_h = (height + ds - 1) / ds;
+  m_blocks.resize((size_t)map_w * map_h);
+  m_block_counts.resize(map_w);
+  for (int by = 0; by < map_h; by++) {
+    std::fill(m_block_counts.begin(), m_block_counts.end(), 0);
+    const int y_end = std::min((by + 1) * ds, height);
+    for (int y = by * ds; y < y_end; y++) {
+      const uint8_t *row = mask + (size_t)y * stride;
+      int x = skipBackground(row, 0, width);
+      while (x < width) {
+        int end = skipForeground(row, x, width);
+        for (; x < end; x++) m_block_counts[x / ds]++;
+        x = skipBackground(row, end, width);
+      }
+    }
+    uint8_t *blocks = m_blocks.data() + (size_t)by * map_w;
+    // block_threshold is at least 1, see the constructor
+    const uint32_t threshold = static_cast<uint32_t>(m_config.block_threshold);
+    for (int bx = 0; bx < map_w; bx++) {
+      blocks[bx] = m_block_counts[bx] >= threshold;
+    }
+  }
 
-      if (lbVal >= 1) {
-        if (lbVal > (CC_MAX_NUM_LABELS - 1)) lbVal = CC_MAX_NUM_LABELS - 1;
+  uint32_t num = labelMapRuns(m_blocks.data(), map_w, map_h, map_w);
+  const int cells = ds * ds;
+  const float offset = 0.5f * (ds - 1);
+  for (auto &st : m_stats) {
+    st.area *= cells;
+    st.x0 *= ds;
+    st.y0 *= ds;
+    st.x1 = std::min(st.x1 * ds + ds, width) - 1;
+    st.y1 = std::min(st.y1 * ds + ds, height) - 1;
+    st.cx = st.cx * ds + offset;
+    st.cy = st.cy * ds + offset;
+  }
+  return num;
+}
 
-        lbVal = lbVal - 1;
-        boundingBoxes[5 * lbVal] = boundingBoxes[5 * lbVal] + 1;
+uint32_t ConnectedComponents::labelMapRuns(const uint8_t *map, int width, int height,
+                                           int stride) {
+  m_map_width = width;
+  m_map_height = height;
+  m_runs.clear();
+  m_row_begin.resize(height + 1);
+  // label 0 is background
+  m_parent.resize(1);
+  m_sums.resize(1);
+
+  // runs of the previous row overlap the current run if they reach into [start - k, end + k)
+  const int k = m_config.connectivity == 8 ? 1 : 0;
+  uint32_t prev_begin = 0, prev_end = 0;
+  for (int y = 0; y < height; y++) {
+    const uint8_t *row = map + (size_t)y * stride;
+    const uint32_t cur_begin = m_runs.size();
+    m_row_begin[y] = cur_begin;
+    uint32_t j = prev_begin;
+
+    int x = skipBackground(row, 0, width);
+    while (x < width) {
+      const int start = x;
+      const int end = skipForeground(row, x, width);
+      x = skipBackground(row, end, width);
+
+      while (j < prev_end && m_runs[j].end + k <= start) j++;
+      uint32_t label = 0;
+      uint32_t jj = j;
+      for (; jj < prev_end && m_runs[jj].start < end + k; jj++) {
+        label = label == 0 ? find(m_runs[jj].label) : merge(label, m_runs[jj].label);
+      }
+      // the last overlapping run can also touch the next run of this row
+      if (jj > j) j = jj - 1;
 
-        if (r < boundingBoxes[5 * lbVal + 1]) boundingBoxes[5 * lbVal + 1] = r;
-        if (c < boundingBoxes[5 * lbVal + 2]) boundingBoxes[5 * lbVal + 2] = c;
-        if (r > boundingBoxes[5 * lbVal + 3]) boundingBoxes[5 * lbVal + 3] = r;
-        if (c > boundingBoxes[5 * lbVal + 4]) boundingBoxes[5 * lbVal + 4] = c;
+      if (label == 0) {
+        label = m_parent.size();
+        m_parent.push_back(label);
+        m_sums.push_back({0, 0, 0, start, y, end - 1, y});
       }
+      Sums &sums = m_sums[label];
+      const uint64_t len = end - start;
+      sums.area += len;
+      sums.sum_x += len * (start + end - 1) / 2;
+      sums.sum_y += len * y;
+      sums.x0 = std::min(sums.x0, start);
+      sums.x1 = std::max(sums.x1, end - 1);
+      sums.y1 = y;
+      m_runs.push_back({start, end, label});
     }
+    prev_begin = cur_begin;
+    prev_end = m_runs.size();
   }
-
-  // clean up: remove small ones and remove overlap
-  boundingBoxes = ccGst->boundingBoxesTmp;
-  boundingBoxesFinal = ccGst->boundingBoxes;
-  ctFinal = 0;
-
-  // remove overlapped boxes
-  int area_super_thresh = area_thresh / BLOCK_SIZE / BLOCK_SIZE;
-  for (i = 0; i < tmpMaxLabel; i++) {
-    objectSize = boundingBoxes[5 * i + 0];
-    if (objectSize > area_super_thresh) {
-      R0 = boundingBoxes[5 * i + 1] * BLOCK_SIZE;
-      C0 = boundingBoxes[5 * i + 2] * BLOCK_SIZE;
-      R1 = boundingBoxes[5 * i + 3] * BLOCK_SIZE;
-      C1 = boundingBoxes[5 * i + 4] * BLOCK_SIZE;
-      int area = (C1 - C0) * (R1 - R0);
-      if (area < area_thresh) continue;
-      boundingBoxesFinal[5 * ctFinal + 0] = objectSize;
-      boundingBoxesFinal[5 * ctFinal + 1] = R0;
-      boundingBoxesFinal[5 * ctFinal + 2] = C0;
-      boundingBoxesFinal[5 * ctFinal + 3] = R1;
-      boundingBoxesFinal[5 * ctFinal + 4] = C1;
-      ctFinal++;
+  m_row_begin[height] = m_runs.size();
+
+  // resolve provisional labels to consecutive final labels and fold the sums into the roots
+  const uint32_t num_provisional = m_parent.size();
+  m_final.resize(num_provisional);
+  m_final[0] = 0;
+  uint32_t num = 0;
+  for (uint32_t l = 1; l < num_provisional; l++) {
+    uint32_t parent = m_parent[l];
+    if (parent == l) {
+      m_final[l] = ++num;
+      continue;
     }
+    // parent < l, so it is resolved already
+    m_final[l] = m_final[parent];
+    m_parent[l] = m_parent[parent];
+    Sums &root = m_sums[m_parent[l]];
+    const Sums &sums = m_sums[l];
+    root.area += sums.area;
+    root.sum_x += sums.sum_x;
+    root.sum_y += sums.sum_y;
+    root.x0 = std::min(root.x0, sums.x0);
+    root.y0 = std::min(root.y0, sums.y0);
+    root.x1 = std::max(root.x1, sums.x1);
+    root.y1 = std::max(root.y1, sums.y1);
   }
 
-  ctFinal = filter_inside_boxes(boundingBoxesFinal, ctFinal);
-  ctFinal = filter_inside_boxes(boundingBoxesFinal, ctFinal);
-  ccGst->maxID = ctFinal;
-  ccGst->numObjects = ctFinal;
-  *p_num_boxes = ccGst->numObjects;
-  return ccGst->boundingBoxes;
-} /*end of: void extract_connected_component() | connected component labeling.*/
+  m_stats.resize(num);
+  for (uint32_t l = 1; l < num_provisional; l++) {
+    if (m_parent[l] != l) continue;
+    const Sums &sums = m_sums[l];
+    CCLStats &st = m_stats[m_final[l] - 1];
+    st.area = sums.area;
+    st.x0 = sums.x0;
+    st.y0 = sums.y0;
+    st.x1 = sums.x1;
+    st.y1 = sums.y1;
+    st.cx = (float)((double)sums.sum_x / sums.area);
+    st.cy = (float)((double)sums.sum_y / sums.area);
+  }
+  return num;
+}
 
-void destroy_connected_component(void *ccGst) {
-  if (ccGst == NULL) return;
-  CCLType *p_inst = (CCLType *)ccGst;
-  release_connected_component(p_inst);
-  delete p_inst;
+void ConnectedComponents::labelMap(uint32_t *labels, int stride) const {
+  for (int y = 0; y < m_map_height; y++) {
+    uint32_t *row = labels + (size_t)y * stride;
+    std::fill(row, row + m_map_width, 0);
+    for (uint32_t r = m_row_begin[y]; r < m_row_begin[y + 1]; r++) {
+      const Run &run = m_runs[r];
+      std::fill(row + run.start, row + run.end, m_final[run.label]);
+    }
+  }
 }
+
+}  // namespace cvitdl
@@ -1,10 +1,103 @@
 #ifndef FILE_CCL_HPP
 #define FILE_CCL_HPP
 
+#include <stdint.h>
+#include <vector>
+
 void* create_connect_instance();
 
 int* extract_connected_component(unsigned char* p_fg_mask, int width, int height, int wstride,
                                  int area_thresh, void* p_cc_inst, int* p_num_boxes);
 void destroy_connected_component(void* p_cc_inst);
 
+namespace cvitdl {
+
+struct CCLConfig {
+  int connectivity = 8;  // 4 or 8
+  // label a map of downsample x downsample blocks instead of single pixels
+  int downsample = 1;
+  // foreground pixels a block needs to be foreground, only used if downsample > 1
+  int block_threshold = 1;
+};
+
+// stats of a component in input mask coordinates, bbox bounds are inclusive
+struct CCLStats {
+  uint32_t area;  // foreground cells of the labelled map, times downsample^2
+  int x0;
+  int y0;
+  int x1;
+  int y1;
+  float cx;
+  float cy;
+};
+
+/**
+ * Run based two pass connected component labelling with 32-bit labels.
+ *
+ * Each row is split into foreground runs with a word-at-a-time (NEON on aarch64) scan, runs are
+ * merged with the overlapping runs of the previous row through a union-find over provisional
+ * labels, and area, bbox and centroid sums are accumulated per run while scanning. The second
+ * pass only touches the label table, so components are never capped or merged by label overflow
+ * and the stats come out of a single pass over the mask. All buffers are kept between calls.
+ */
+class ConnectedComponents {
+ public:
+  explicit ConnectedComponents(const CCLConfig& config = CCLConfig());
+
+  /* returns the number of components, nonzero mask pixels are foreground */
+  uint32_t label(const uint8_t* mask, int width, int height, int stride);
+  const std::vector<CCLStats>& stats() const { return m_stats; }
+
+  /* labels 1..N of the last call at map resolution (ceil(w / downsample) x ceil(h / downsample)),
+   * 0 is background */
+  void labelMap(uint32_t* labels, int stride) const;
+  int mapWidth() const { return m_map_width; }
+  int mapHeight() const { return m_map_height; }
+
+  /* calls f(y, start, end, label) for every foreground run of the last call at map resolution,
+   * end is exclusive */
+  template <typename F>
+  void forEachRun(F f) const {
+    for (int y = 0; y < m_map_height; y++) {
+      for (uint32_t r = m_row_begin[y]; r < m_row_begin[y + 1]; r++) {
+        f(y, m_runs[r].start, m_runs[r].end, m_final[m_runs[r].label]);
+      }
+    }
+  }
+
+ private:
+  struct Run {
+    int start;
+    int end;  // exclusive
+    uint32_t label;
+  };
+  struct Sums {
+    uint64_t area;
+    uint64_t sum_x;
+    uint64_t sum_y;
+    int x0;
+    int y0;
+    int x1;
+    int y1;
+  };
+
+  uint32_t labelMapRuns(const uint8_t* map, int width, int height, int stride);
+  uint32_t find(uint32_t label);
+  uint32_t merge(uint32_t a, uint32_t b);
+
+  CCLConfig m_config;
+  int m_map_width = 0;
+  int m_map_height = 0;
+  std::vector<uint8_t> m_blocks;
+  std::vector<uint32_t> m_block_counts;
+  std::vector<Run> m_runs;
+  std::vector<uint32_t> m_row_begin;
+  std::vector<uint32_t> m_parent;
+  std::vector<uint32_t> m_final;
+  std::vector<Sums> m_sums;
+  std::vector<CCLStats> m_stats;
+};
+
+}  // namespace cvitdl
+
 #endif
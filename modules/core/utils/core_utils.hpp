@@ -1,6 +1,7 @@
 #pragma once
 #include "core/core/cvtdl_core_types.h"
 #include "rescale_utils.hpp"
+#include "trace.hpp"
 
 #ifndef CV186X
 #include <cviruntime.h>
@@ -33,6 +34,7 @@ inline float FastExp(float x) {
 template <typename T>
 void NonMaximumSuppression(std::vector<T> &bboxes, std::vector<T> &bboxes_nms,
                            const float threshold, const char method) {
+  TraceScope trace("nms", "postprocess");
   std::sort(bboxes.begin(), bboxes.end(), [](T &a, T &b) { return a.bbox.score > b.bbox.score; });
 
   int select_idx = 0;
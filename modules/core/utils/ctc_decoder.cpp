@@ -0,0 +1,317 @@
+#include "ctc_decoder.hpp"
+
+#include <math.h>
+#include <algorithm>
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace cvitdl {
+
+namespace {
+
+inline float maxOf(const float *s, int n) {
+  float best = s[0];
+  int i = 0;
+  if (n >= 4) {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    float32x4_t m = vld1q_f32(s);
+    for (i = 4; i + 4 <= n; i += 4) {
+      m = vmaxq_f32(m, vld1q_f32(s + i));
+    }
+    float32x2_t m2 = vpmax_f32(vget_low_f32(m), vget_high_f32(m));
+    m2 = vpmax_f32(m2, m2);
+    best = vget_lane_f32(m2, 0);
+#else
+    float m0 = s[0], m1 = s[1], m2 = s[2], m3 = s[3];
+    for (i = 4; i + 4 <= n; i += 4) {
+      m0 = std::max(m0, s[i]);
+      m1 = std::max(m1, s[i + 1]);
+      m2 = std::max(m2, s[i + 2]);
+      m3 = std::max(m3, s[i + 3]);
+    }
+    best = std::max(std::max(m0, m1), std::max(m2, m3));
+#endif
+  }
+  for (; i < n; i++) {
+    best = std::max(best, s[i]);
+  }
+  return best;
+}
+
+}  // namespace
+
+void CTCLabelConstraint::addSlot(const std::vector<int> &labels, int min_count, int max_count) {
+  Slot slot;
+  slot.min_count = std::max(min_count, 0);
+  slot.max_count = std::max(std::max(max_count, slot.min_count), 1);
+  for (int label : labels) {
+    if (label < 0) continue;
+    if ((size_t)label >= slot.member.size()) slot.member.resize(label + 1, 0);
+    slot.member[label] = 1;
+  }
+  slot.base_state = m_state_slot.size();
+  for (int k = 0; k <= slot.max_count; k++) {
+    m_state_slot.push_back(m_slots.size());
+    m_state_count.push_back(k);
+  }
+  m_slots.push_back(slot);
+
+  // a state accepts if its slot is satisfied and all following slots are optional
+  m_accept.resize(m_state_slot.size());
+  bool rest_optional = true;
+  for (int i = (int)m_slots.size() - 1; i >= 0; i--) {
+    const Slot &s = m_slots[i];
+    for (int k = 0; k <= s.max_count; k++) {
+      m_accept[s.base_state + k] = rest_optional && k >= s.min_count;
+    }
+    rest_optional = rest_optional && s.min_count == 0;
+  }
+}
+
+void CTCLabelConstraint::clear() {
+  m_slots.clear();
+  m_state_slot.clear();
+  m_state_count.clear();
+  m_accept.clear();
+}
+
+int CTCLabelConstraint::next(int state, int label) const {
+  int i = m_state_slot[state];
+  int k = m_state_count[state];
+  for (; i < (int)m_slots.size(); i++, k = 0) {
+    const Slot &s = m_slots[i];
+    if (k < s.max_count && label >= 0 && (size_t)label < s.member.size() && s.member[label]) {
+      return s.base_state + k + 1;
+    }
+    if (k < s.min_count) {
+      return -1;
+    }
+  }
+  return -1;
+}
+
+void CTCDecoder::greedy(const CTCInput &input, CTCResult *result) {
+  const int steps = input.steps;
+  const int classes = input.classes;
+  result->labels.clear();
+  result->confidences.clear();
+  result->score = 0;
+  if (steps <= 0 || classes <= 0) {
+    return;
+  }
+  const bool confidences = !input.logits || m_logit_confidences;
+  int prev = -1;
+  for (int t = 0; t < steps; t++) {
+    const float *s = input.data + (size_t)t * input.step_stride;
+    float best;
+    int label = 0;
+    if (input.class_stride == 1) {
+      // classes of a step are contiguous: vector max, then the first class holding it
+      best = maxOf(s, classes);
+      while (label < classes - 1 && s[label] != best) label++;
+    } else {
+      // strided classes: running maximum two classes at a time, new maxima are rare so the
+      // branches predict well
+      const size_t cs = input.class_stride;
+      const float *p = s + cs;
+      best = s[0];
+      int c = 1;
+      for (; c + 1 < classes; c += 2, p += 2 * cs) {
+        const float v0 = p[0], v1 = p[cs];
+        if (v0 > best || v1 > best) {
+          const bool second = v1 > v0;
+          best = second ? v1 : v0;
+          label = second ? c + 1 : c;
+        }
+      }
+      if (c < classes && *p > best) {
+        best = *p;
+        label = c;
+      }
+    }
+    if (label != m_blank && confidences) {
+      // softmax probability of the best class, only needed for emitted steps
+      float prob = best;
+      if (input.logits) {
+        float e = 0;
+        for (int c = 0; c < classes; c++) e += expf(s[(size_t)c * input.class_stride] - best);
+        prob = 1.f / e;
+      }
+      if (label != prev) {
+        result->labels.push_back(label);
+        result->confidences.push_back(prob);
+      } else {
+        result->confidences.back() = std::max(result->confidences.back(), prob);
+      }
+    } else if (label != m_blank && label != prev) {
+      result->labels.push_back(label);
+    }
+    prev = label;
+  }
+  for (float conf : result->confidences) result->score += conf;
+  if (!result->confidences.empty()) result->score /= result->confidences.size();
+}
+
+void CTCDecoder::stepProbs(const CTCInput &input, int t) {
+  const int classes = input.classes;
+  m_probs.resize(classes);
+  const float *s = input.data + (size_t)t * input.step_stride;
+  for (int c = 0; c < classes; c++) {
+    m_probs[c] = s[(size_t)c * input.class_stride];
+  }
+  if (input.logits) {
+    float m = maxOf(m_probs.data(), classes);
+    float sum = 0;
+    for (int c = 0; c < classes; c++) {
+      m_probs[c] = expf(m_probs[c] - m);
+      sum += m_probs[c];
+    }
+    for (int c = 0; c < classes; c++) {
+      m_probs[c] /= sum;
+    }
+  }
+}
+
+int CTCDecoder::slot(int parent, int label) const {
+  // candidates are keyed by their prefix, the parent node and the last label
+  uint32_t h = (uint32_t)(parent + 1) * 2654435761u ^ (uint32_t)(label + 1) * 40503u;
+  return (int)(h & (m_table.size() - 1));
+}
+
+int CTCDecoder::findCandidate(int parent, int label) const {
+  for (int i = slot(parent, label);; i = (i + 1) & (m_table.size() - 1)) {
+    const int c = m_table[i];
+    if (c < 0) return -1;
+    if (m_candidates[c].parent == parent && m_candidates[c].label == label) return c;
+  }
+}
+
+int CTCDecoder::addCandidate(int node, int parent, int label, int state, float conf) {
+  int i = slot(parent, label);
+  while (m_table[i] >= 0) i = (i + 1) & (m_table.size() - 1);
+  m_table[i] = m_candidates.size();
+  m_candidates.push_back({node, parent, label, state, conf, 0.f, 0.f});
+  return m_table[i];
+}
+
+bool CTCDecoder::beamSearch(const CTCInput &input, int beam_width,
+                            const CTCLabelConstraint *constraint, CTCResult *result) {
+  result->labels.clear();
+  result->confidences.clear();
+  result->score = 0;
+  if (input.steps <= 0 || input.classes <= 0) {
+    return false;
+  }
+  const size_t width = std::max(beam_width, 1);
+  const bool constrained = constraint != nullptr && !constraint->empty();
+
+  // at most width * (width + 1) candidates per step, keep the table at most half full
+  size_t table_size = 16;
+  while (table_size < 2 * width * (width + 1)) table_size *= 2;
+  m_table.resize(table_size);
+  m_candidates.reserve(width * (width + 1));
+
+  m_nodes.clear();
+  m_nodes.push_back({-1, -1, constrained ? constraint->start() : 0, 0.f});
+  m_beams.assign(1, {0, 1.f, 0.f});
+
+  for (int t = 0; t < input.steps; t++) {
+    stepProbs(input, t);
+
+    // the width most probable labels of this step
+    m_top.clear();
+    for (int c = 0; c < input.classes; c++) {
+      if (c == m_blank) continue;
+      if (m_top.size() == width) {
+        if (m_probs[c] <= m_probs[m_top.back()]) continue;
+        m_top.pop_back();
+      }
+      auto pos = std::upper_bound(m_top.begin(), m_top.end(), c,
+                                  [&](int a, int b) { return m_probs[a] > m_probs[b]; });
+      m_top.insert(pos, c);
+    }
+
+    const float p_blank = m_blank < input.classes ? m_probs[m_blank] : 0.f;
+    m_candidates.clear();
+    std::fill(m_table.begin(), m_table.end(), -1);
+    // every beam keeps its prefix through a blank or a repeat of its last label
+    for (const Beam &beam : m_beams) {
+      const Node &node = m_nodes[beam.node];
+      const int c = addCandidate(beam.node, node.parent, node.label, node.state, node.conf);
+      Candidate &same = m_candidates[c];
+      same.pb = (beam.pb + beam.pnb) * p_blank;
+      if (node.label >= 0) {
+        same.pnb = beam.pnb * m_probs[node.label];
+        same.conf = std::max(same.conf, m_probs[node.label]);
+      }
+    }
+    // and is extended by the top labels, merging into beams that already hold the longer prefix
+    for (const Beam &beam : m_beams) {
+      const Node &node = m_nodes[beam.node];
+      for (int label : m_top) {
+        int state = node.state;
+        if (constrained) {
+          state = constraint->next(node.state, label);
+          if (state < 0) continue;
+        }
+        const float p = m_probs[label];
+        // a repeated label only extends the prefix after a blank
+        const float add = (label == node.label ? beam.pb : beam.pb + beam.pnb) * p;
+        if (add <= 0) continue;
+        int c = findCandidate(beam.node, label);
+        if (c < 0) c = addCandidate(-1, beam.node, label, state, 0.f);
+        Candidate &ext = m_candidates[c];
+        ext.pnb += add;
+        ext.conf = std::max(ext.conf, p);
+      }
+    }
+
+    const size_t keep = std::min(width, m_candidates.size());
+    std::partial_sort(m_candidates.begin(), m_candidates.begin() + keep, m_candidates.end(),
+                      [](const Candidate &a, const Candidate &b) {
+                        return a.pb + a.pnb > b.pb + b.pnb;
+                      });
+    // rescale every step, only the ranking of the beams matters
+    float norm = 0;
+    for (size_t i = 0; i < keep; i++) norm += m_candidates[i].pb + m_candidates[i].pnb;
+    if (norm <= 0) norm = 1;
+
+    m_beams.clear();
+    for (size_t i = 0; i < keep; i++) {
+      const Candidate &cand = m_candidates[i];
+      int node = cand.node;
+      if (node < 0) {
+        node = m_nodes.size();
+        m_nodes.push_back({cand.parent, cand.label, cand.state, cand.conf});
+      } else {
+        m_nodes[node].conf = cand.conf;
+      }
+      m_beams.push_back({node, cand.pb / norm, cand.pnb / norm});
+    }
+  }
+
+  int best = -1;
+  float best_prob = -1;
+  for (const Beam &beam : m_beams) {
+    if (constrained && !constraint->accepts(m_nodes[beam.node].state)) continue;
+    if (beam.pb + beam.pnb > best_prob) {
+      best_prob = beam.pb + beam.pnb;
+      best = beam.node;
+    }
+  }
+  if (best < 0) {
+    return false;
+  }
+  for (int n = best; m_nodes[n].parent >= 0; n = m_nodes[n].parent) {
+    result->labels.push_back(m_nodes[n].label);
+    result->confidences.push_back(m_nodes[n].conf);
+    result->score += m_nodes[n].conf;
+  }
+  std::reverse(result->labels.begin(), result->labels.end());
+  std::reverse(result->confidences.begin(), result->confidences.end());
+  if (!result->confidences.empty()) result->score /= result->confidences.size();
+  return true;
+}
+
+}  // namespace cvitdl
@@ -0,0 +1,126 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+namespace cvitdl {
+
+/* score of class c at step t is data[t * step_stride + c * class_stride] */
+struct CTCInput {
+  const float *data;
+  int steps;
+  int classes;
+  int step_stride;
+  int class_stride;
+  // scores are logits, a softmax over the classes of every step gives the probabilities
+  bool logits;
+};
+
+struct CTCResult {
+  // collapsed labels without blanks
+  std::vector<int> labels;
+  // probability of every label at the step it was emitted
+  std::vector<float> confidences;
+  // mean of confidences, 0 for an empty result
+  float score = 0;
+};
+
+/**
+ * Automaton over label sequences, made of consecutive slots that each take min_count to
+ * max_count labels of a label set, e.g. province{1} letter{1} alnum{4,6} for a plate.
+ * Labels are matched to the current slot as long as it takes them, so two adjacent slots should
+ * only share labels if the first one has a fixed count.
+ */
+class CTCLabelConstraint {
+ public:
+  void addSlot(const std::vector<int> &labels, int min_count = 1, int max_count = 1);
+  void clear();
+  bool empty() const { return m_slots.empty(); }
+
+  int start() const { return 0; }
+  /* state after appending label, -1 if the sequence cannot match any more */
+  int next(int state, int label) const;
+  bool accepts(int state) const { return m_accept[state]; }
+
+ private:
+  struct Slot {
+    std::vector<uint8_t> member;
+    int min_count;
+    int max_count;
+    int base_state;
+  };
+  std::vector<Slot> m_slots;
+  // slot and number of labels taken in it for every state
+  std::vector<int> m_state_slot;
+  std::vector<int> m_state_count;
+  std::vector<uint8_t> m_accept;
+};
+
+/**
+ * CTC decoding shared by text and plate recognition.
+ *
+ * greedy() takes the best class of every step with a loop over the contiguous dimension of the
+ * scores, so both class-major and step-major outputs vectorize. beamSearch() is a prefix beam
+ * search over a prefix tree with an optional label constraint, expanding every beam with the
+ * beam_width most probable labels of a step and merging equal prefixes through a hash table.
+ * All buffers are kept between calls.
+ */
+class CTCDecoder {
+ public:
+  explicit CTCDecoder(int blank = 0) : m_blank(blank) {}
+
+  void setBlank(int blank) { m_blank = blank; }
+  int blank() const { return m_blank; }
+  /*
+   * The confidences of greedy() on logits need a softmax sum over the classes of every emitted
+   * step, which costs more than the decoding itself. When off, greedy() on logits leaves the
+   * confidences empty and the score 0. Probabilities and beamSearch() always give them.
+   */
+  void setLogitConfidences(bool on) { m_logit_confidences = on; }
+  bool logitConfidences() const { return m_logit_confidences; }
+
+  void greedy(const CTCInput &input, CTCResult *result);
+  /* returns false and an empty result if no path satisfies the constraint */
+  bool beamSearch(const CTCInput &input, int beam_width, const CTCLabelConstraint *constraint,
+                  CTCResult *result);
+
+ private:
+  struct Node {
+    int parent;
+    int label;
+    int state;
+    float conf;
+  };
+  struct Beam {
+    int node;
+    // probabilities of the prefix ending in a blank and in its last label
+    float pb;
+    float pnb;
+  };
+  struct Candidate {
+    // an existing prefix, or -1 for a new child of parent with label
+    int node;
+    int parent;
+    int label;
+    int state;
+    float conf;
+    float pb;
+    float pnb;
+  };
+
+  void stepProbs(const CTCInput &input, int t);
+  int slot(int parent, int label) const;
+  int findCandidate(int parent, int label) const;
+  int addCandidate(int node, int parent, int label, int state, float conf);
+
+  int m_blank;
+  bool m_logit_confidences = true;
+  std::vector<float> m_probs;
+  std::vector<int> m_top;
+  std::vector<Node> m_nodes;
+  std::vector<Beam> m_beams;
+  std::vector<Candidate> m_candidates;
+  // open addressing from the prefix of a candidate to its index
+  std::vector<int> m_table;
+};
+
+}  // namespace cvitdl
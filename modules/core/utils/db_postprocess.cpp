@@ -0,0 +1,179 @@
+#include "db_postprocess.hpp"
+
+#include <math.h>
+#include <algorithm>
+
+namespace cvitdl {
+
+namespace {
+CCLConfig eightConnected() {
+  CCLConfig config;
+  config.connectivity = 8;
+  return config;
+}
+}  // namespace
+
+DBPostprocess::DBPostprocess(const DBPostprocessConfig &config)
+    : m_config(config), m_labeler(eightConnected()) {}
+
+const std::vector<DBTextBox> &DBPostprocess::run(const float *prob, int width, int height,
+                                                 int stride) {
+  m_boxes.clear();
+  m_binary.resize((size_t)width * height);
+  const float thresh = m_config.thresh;
+  for (int y = 0; y < height; y++) {
+    const float *src = prob + (size_t)y * stride;
+    uint8_t *dst = m_binary.data() + (size_t)y * width;
+    for (int x = 0; x < width; x++) {
+      dst[x] = src[x] > thresh;
+    }
+  }
+
+  const uint32_t num = m_labeler.label(m_binary.data(), width, height, width);
+  if (num == 0) {
+    return m_boxes;
+  }
+  const std::vector<CCLStats> &stats = m_labeler.stats();
+
+  // bucket the end points of every run by component and sum the probabilities under the runs
+  m_score_sums.assign(num + 1, 0);
+  m_point_offsets.assign(num + 2, 0);
+  m_labeler.forEachRun([&](int y, int start, int end, uint32_t label) {
+    m_point_offsets[label + 1] += 2;
+    const float *src = prob + (size_t)y * stride;
+    double sum = 0;
+    for (int x = start; x < end; x++) sum += src[x];
+    m_score_sums[label] += sum;
+  });
+  for (uint32_t l = 1; l <= num + 1; l++) {
+    m_point_offsets[l] += m_point_offsets[l - 1];
+  }
+  m_points.resize(m_point_offsets[num + 1]);
+  m_labeler.forEachRun([&](int y, int start, int end, uint32_t label) {
+    uint32_t &pos = m_point_offsets[label];
+    m_points[pos++] = {(float)start, (float)y};
+    m_points[pos++] = {(float)(end - 1), (float)y};
+  });
+  // the fill pass advanced every offset to the start of the next component
+
+  std::vector<Point> points;
+  const uint32_t num_candidates = std::min(num, m_config.max_candidates);
+  for (uint32_t l = 1; l <= num_candidates; l++) {
+    const CCLStats &st = stats[l - 1];
+    if (st.area < m_config.min_area) continue;
+    float score = (float)(m_score_sums[l] / st.area);
+    if (score < m_config.box_thresh) continue;
+
+    points.assign(m_points.begin() + m_point_offsets[l - 1], m_points.begin() + m_point_offsets[l]);
+    DBTextBox box;
+    if (!boxFromHull(points, &box)) continue;
+    box.score = score;
+    box.x1 = std::max(0.f, std::min({box.pts[0][0], box.pts[1][0], box.pts[2][0], box.pts[3][0]}));
+    box.y1 = std::max(0.f, std::min({box.pts[0][1], box.pts[1][1], box.pts[2][1], box.pts[3][1]}));
+    box.x2 = std::min((float)width,
+                      std::max({box.pts[0][0], box.pts[1][0], box.pts[2][0], box.pts[3][0]}));
+    box.y2 = std::min((float)height,
+                      std::max({box.pts[0][1], box.pts[1][1], box.pts[2][1], box.pts[3][1]}));
+    m_boxes.push_back(box);
+  }
+  return m_boxes;
+}
+
+bool DBPostprocess::boxFromHull(std::vector<Point> &points, DBTextBox *box) {
+  // Andrew's monotone chain
+  std::sort(points.begin(), points.end(),
+            [](const Point &a, const Point &b) { return a.x < b.x || (a.x == b.x && a.y < b.y); });
+  auto cross = [](const Point &o, const Point &a, const Point &b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+  };
+  const size_t n = points.size();
+  m_hull.resize(2 * n);
+  size_t k = 0;
+  for (size_t i = 0; i < n; i++) {
+    while (k >= 2 && cross(m_hull[k - 2], m_hull[k - 1], points[i]) <= 0) k--;
+    m_hull[k++] = points[i];
+  }
+  for (size_t i = n - 1, lower = k + 1; i-- > 0;) {
+    while (k >= lower && cross(m_hull[k - 2], m_hull[k - 1], points[i]) <= 0) k--;
+    m_hull[k++] = points[i];
+  }
+  const size_t hull_size = k - 1;
+  if (hull_size < 3) {
+    // a line or a point, its min-area rect has no short side
+    return false;
+  }
+
+  // rotating calipers: the min-area rect has one side on a hull edge
+  float best_area = -1;
+  float best_u[2] = {0, 0}, best_v[2] = {0, 0};
+  float best_ux = 1, best_uy = 0;
+  for (size_t i = 0; i < hull_size; i++) {
+    const Point &p0 = m_hull[i];
+    const Point &p1 = m_hull[i + 1];
+    float dx = p1.x - p0.x, dy = p1.y - p0.y;
+    float len = sqrtf(dx * dx + dy * dy);
+    if (len <= 0) continue;
+    float ux = dx / len, uy = dy / len;
+    float min_u = 0, max_u = 0, min_v = 0, max_v = 0;
+    for (size_t j = 0; j < hull_size; j++) {
+      float px = m_hull[j].x - p0.x, py = m_hull[j].y - p0.y;
+      float u = px * ux + py * uy;
+      float v = -px * uy + py * ux;
+      min_u = std::min(min_u, u);
+      max_u = std::max(max_u, u);
+      min_v = std::min(min_v, v);
+      max_v = std::max(max_v, v);
+    }
+    float area = (max_u - min_u) * (max_v - min_v);
+    if (best_area < 0 || area < best_area) {
+      best_area = area;
+      best_u[0] = min_u + p0.x * ux + p0.y * uy;
+      best_u[1] = max_u + p0.x * ux + p0.y * uy;
+      best_v[0] = min_v - p0.x * uy + p0.y * ux;
+      best_v[1] = max_v - p0.x * uy + p0.y * ux;
+      best_ux = ux;
+      best_uy = uy;
+    }
+  }
+
+  const float w = best_u[1] - best_u[0];
+  const float h = best_v[1] - best_v[0];
+  if (m_config.min_size > 0 && std::min(w, h) < m_config.min_size) {
+    return false;
+  }
+  const float d = w * h * m_config.unclip_ratio / (2 * (w + h));
+  if (m_config.min_size > 0 && std::min(w, h) + 2 * d < m_config.min_size + 2) {
+    return false;
+  }
+  best_u[0] -= d;
+  best_u[1] += d;
+  best_v[0] -= d;
+  best_v[1] += d;
+
+  // back from (u, v) to map coordinates, u along the edge and v along its normal
+  const float corners[4][2] = {{best_u[0], best_v[0]},
+                               {best_u[1], best_v[0]},
+                               {best_u[1], best_v[1]},
+                               {best_u[0], best_v[1]}};
+  float pts[4][2];
+  for (int i = 0; i < 4; i++) {
+    pts[i][0] = corners[i][0] * best_ux - corners[i][1] * best_uy;
+    pts[i][1] = corners[i][0] * best_uy + corners[i][1] * best_ux;
+  }
+  // clockwise on screen (y down) starting from the corner closest to the top left
+  float signed_area = 0;
+  int first = 0;
+  for (int i = 0; i < 4; i++) {
+    signed_area += pts[i][0] * pts[(i + 1) % 4][1] - pts[(i + 1) % 4][0] * pts[i][1];
+    if (pts[i][0] + pts[i][1] < pts[first][0] + pts[first][1]) first = i;
+  }
+  const int step = signed_area > 0 ? 1 : 3;
+  for (int i = 0; i < 4; i++) {
+    int src = (first + i * step) % 4;
+    box->pts[i][0] = pts[src][0];
+    box->pts[i][1] = pts[src][1];
+  }
+  return true;
+}
+
+}  // namespace cvitdl
@@ -0,0 +1,70 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "ccl.hpp"
+
+namespace cvitdl {
+
+struct DBPostprocessConfig {
+  // binarization threshold of the probability map
+  float thresh = 0.3f;
+  // min mean probability of a component to keep its box, 0 keeps all (DB uses 0.6)
+  float box_thresh = 0.f;
+  // the min-area rect is grown by area * unclip_ratio / perimeter on every side
+  float unclip_ratio = 1.5f;
+  // min short side of the rect before unclip, min_size + 2 after it, 0 is off (DB uses 3)
+  float min_size = 0;
+  // min pixel count of a component
+  uint32_t min_area = 10;
+  uint32_t max_candidates = 1000;
+};
+
+struct DBTextBox {
+  // corners of the unclipped min-area rect, clockwise in map coordinates
+  float pts[4][2];
+  // bounds of pts clipped to the map
+  float x1;
+  float y1;
+  float x2;
+  float y2;
+  float score;
+};
+
+/**
+ * Postprocess of DB (differentiable binarization) text detection without OpenCV.
+ *
+ * The probability map is binarized and split into 8-connected components by the run based
+ * labeller, so there is no contour tracing. The mean probability of every component is summed
+ * from its runs, the convex hull is built from the run end points and the rotated min-area rect
+ * is found by rotating calipers over the hull edges. Unclipping offsets that rect by the DB
+ * distance, which is what offsetting the rect polygon and taking its min-area rect again gives.
+ */
+class DBPostprocess {
+ public:
+  explicit DBPostprocess(const DBPostprocessConfig &config = DBPostprocessConfig());
+
+  void setConfig(const DBPostprocessConfig &config) { m_config = config; }
+  const DBPostprocessConfig &config() const { return m_config; }
+
+  /* prob is a height x width map with a row stride of stride floats */
+  const std::vector<DBTextBox> &run(const float *prob, int width, int height, int stride);
+
+ private:
+  struct Point {
+    float x;
+    float y;
+  };
+
+  bool boxFromHull(std::vector<Point> &points, DBTextBox *box);
+
+  DBPostprocessConfig m_config;
+  ConnectedComponents m_labeler;
+  std::vector<uint8_t> m_binary;
+  std::vector<double> m_score_sums;
+  std::vector<uint32_t> m_point_offsets;
+  std::vector<Point> m_points;
+  std::vector<Point> m_hull;
+  std::vector<DBTextBox> m_boxes;
+};
+
+}  // namespace cvitdl
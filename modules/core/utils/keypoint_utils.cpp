@@ -0,0 +1,238 @@
+#include "keypoint_utils.hpp"
+
+#include <math.h>
+#include <algorithm>
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace cvitdl {
+
+/* largest Gaussian kernel of the DARK blur */
+#define DARK_MAX_KERNEL 31
+/* values per block of the scalar float argmax */
+#define ARGMAX_BLOCK 64
+
+int VectorArgmax(const float *values, int n, float *max_value) {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  float best = values[0];
+  int i = 0;
+  if (n >= 8) {
+    float32x4_t m0 = vld1q_f32(values);
+    float32x4_t m1 = vld1q_f32(values + 4);
+    for (i = 8; i + 8 <= n; i += 8) {
+      m0 = vmaxq_f32(m0, vld1q_f32(values + i));
+      m1 = vmaxq_f32(m1, vld1q_f32(values + i + 4));
+    }
+    m0 = vmaxq_f32(m0, m1);
+    float32x2_t m2 = vpmax_f32(vget_low_f32(m0), vget_high_f32(m0));
+    m2 = vpmax_f32(m2, m2);
+    best = vget_lane_f32(m2, 0);
+  }
+  for (; i < n; i++) {
+    best = std::max(best, values[i]);
+  }
+  int idx = 0;
+  while (idx < n - 1 && values[idx] != best) idx++;
+#else
+  // maxima of blocks kept in independent accumulators, a single running maximum with its index
+  // is bound by the compare latency, then the index is looked for in the best block only
+  float best = values[0];
+  int best_block = 0;
+  for (int b = 0; b < n; b += ARGMAX_BLOCK) {
+    const int end = std::min(b + ARGMAX_BLOCK, n);
+    float m0 = values[b], m1 = values[b], m2 = values[b], m3 = values[b];
+    int i = b;
+    for (; i + 4 <= end; i += 4) {
+      m0 = values[i] > m0 ? values[i] : m0;
+      m1 = values[i + 1] > m1 ? values[i + 1] : m1;
+      m2 = values[i + 2] > m2 ? values[i + 2] : m2;
+      m3 = values[i + 3] > m3 ? values[i + 3] : m3;
+    }
+    for (; i < end; i++) {
+      m0 = values[i] > m0 ? values[i] : m0;
+    }
+    const float m = std::max(std::max(m0, m1), std::max(m2, m3));
+    if (m > best) {
+      best = m;
+      best_block = b;
+    }
+  }
+  int idx = best_block;
+  while (idx < n - 1 && values[idx] != best) idx++;
+#endif
+  *max_value = best;
+  return idx;
+}
+
+int VectorArgmax(const int8_t *values, int n, int8_t *max_value) {
+  int8_t best = values[0];
+  int i = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  if (n >= 16) {
+    int8x16_t m = vld1q_s8(values);
+    for (i = 16; i + 16 <= n; i += 16) {
+      m = vmaxq_s8(m, vld1q_s8(values + i));
+    }
+    int8x8_t m8 = vpmax_s8(vget_low_s8(m), vget_high_s8(m));
+    m8 = vpmax_s8(m8, m8);
+    m8 = vpmax_s8(m8, m8);
+    m8 = vpmax_s8(m8, m8);
+    best = vget_lane_s8(m8, 0);
+  }
+#endif
+  for (; i < n; i++) {
+    best = std::max(best, values[i]);
+  }
+  int idx = 0;
+  while (idx < n - 1 && values[idx] != best) idx++;
+  *max_value = best;
+  return idx;
+}
+
+/* cv::BORDER_REFLECT_101, the border of cv::GaussianBlur */
+static inline int reflect101(int i, int n) {
+  if (n == 1) return 0;
+  while (i < 0 || i >= n) {
+    i = i < 0 ? -i : 2 * n - 2 - i;
+  }
+  return i;
+}
+
+template <typename T>
+static void refine_dark(const T *hm, float qscale, int height, int width, int kernel,
+                        KeypointPeak *peak) {
+  const int px = (int)peak->x;
+  const int py = (int)peak->y;
+  float win[5][5];
+  if (kernel <= 1) {
+    for (int i = 0; i < 5; i++) {
+      for (int j = 0; j < 5; j++) win[i][j] = hm[(py + i - 2) * width + px + j - 2] * qscale;
+    }
+  } else {
+    // separable blur of the 5 x 5 window, the sigma OpenCV derives from the kernel size
+    kernel = std::min(kernel | 1, DARK_MAX_KERNEL);
+    const int r = kernel / 2;
+    const float sigma = 0.3f * ((kernel - 1) * 0.5f - 1) + 0.8f;
+    float g[DARK_MAX_KERNEL];
+    float g_sum = 0;
+    for (int k = 0; k < kernel; k++) {
+      g[k] = expf(-(k - r) * (k - r) / (2 * sigma * sigma));
+      g_sum += g[k];
+    }
+    for (int k = 0; k < kernel; k++) g[k] /= g_sum;
+
+    // reflected coordinates of the rows and columns the window blur reads
+    int ys[DARK_MAX_KERNEL + 4], xs[DARK_MAX_KERNEL + 4];
+    for (int i = 0; i < 4 + kernel; i++) {
+      ys[i] = reflect101(py - 2 - r + i, height);
+      xs[i] = reflect101(px - 2 - r + i, width);
+    }
+    float rows[DARK_MAX_KERNEL + 4][5];
+    for (int i = 0; i < 4 + kernel; i++) {
+      const T *row = hm + ys[i] * width;
+      for (int j = 0; j < 5; j++) {
+        float acc = 0;
+        for (int k = 0; k < kernel; k++) acc += g[k] * row[xs[j + k]];
+        rows[i][j] = acc * qscale;
+      }
+    }
+    for (int i = 0; i < 5; i++) {
+      for (int j = 0; j < 5; j++) {
+        float acc = 0;
+        for (int k = 0; k < kernel; k++) acc += g[k] * rows[i + k][j];
+        win[i][j] = acc;
+      }
+    }
+  }
+
+  float l[5][5];
+  for (int i = 0; i < 5; i++) {
+    for (int j = 0; j < 5; j++) l[i][j] = logf(std::max(win[i][j], 1e-10f));
+  }
+  const float dx = 0.5f * (l[2][3] - l[2][1]);
+  const float dy = 0.5f * (l[3][2] - l[1][2]);
+  const float dxx = 0.25f * (l[2][4] - 2 * l[2][2] + l[2][0]);
+  const float dyy = 0.25f * (l[4][2] - 2 * l[2][2] + l[0][2]);
+  const float dxy = 0.25f * (l[3][3] - l[1][3] - l[3][1] + l[1][1]);
+  const float det = dxx * dyy - dxy * dxy;
+  // the offset is only meaningful at a maximum, where the Hessian is negative definite
+  if (dxx >= 0 || det <= 1e-12f) {
+    return;
+  }
+  const float ox = -(dyy * dx - dxy * dy) / det;
+  const float oy = -(dxx * dy - dxy * dx) / det;
+  peak->x += std::min(std::max(ox, -1.f), 1.f);
+  peak->y += std::min(std::max(oy, -1.f), 1.f);
+}
+
+template <typename T>
+static void decode_heatmaps(const T *heatmaps, float qscale, int num_joints, int height,
+                            int width, cvtdl_keypoint_refine_e refine, int blur_kernel,
+                            KeypointPeak *peaks) {
+  const int plane = height * width;
+  for (int j = 0; j < num_joints; j++) {
+    const T *hm = heatmaps + (size_t)j * plane;
+    T max_value;
+    const int idx = VectorArgmax(hm, plane, &max_value);
+    const int px = idx % width;
+    const int py = idx / width;
+    KeypointPeak &peak = peaks[j];
+    peak.x = px;
+    peak.y = py;
+    peak.score = max_value * qscale;
+
+    if (refine == CVTDL_KEYPOINT_REFINE_QUARTER) {
+      if (1 < px && px < width - 1 && 1 < py && py < height - 1) {
+        const float diff_x = (float)hm[py * width + px + 1] - hm[py * width + px - 1];
+        const float diff_y = (float)hm[(py + 1) * width + px] - hm[(py - 1) * width + px];
+        peak.x += diff_x > 0 ? 0.25f : (diff_x < 0 ? -0.25f : 0.f);
+        peak.y += diff_y > 0 ? 0.25f : (diff_y < 0 ? -0.25f : 0.f);
+      }
+    } else if (refine == CVTDL_KEYPOINT_REFINE_DARK) {
+      if (1 < px && px < width - 2 && 1 < py && py < height - 2) {
+        refine_dark(hm, qscale, height, width, blur_kernel, &peak);
+      }
+    }
+  }
+}
+
+void DecodeHeatmaps(const float *heatmaps, int num_joints, int height, int width,
+                    cvtdl_keypoint_refine_e refine, int blur_kernel, KeypointPeak *peaks) {
+  decode_heatmaps(heatmaps, 1.f, num_joints, height, width, refine, blur_kernel, peaks);
+}
+
+void DecodeHeatmaps(const int8_t *heatmaps, float qscale, int num_joints, int height, int width,
+                    cvtdl_keypoint_refine_e refine, int blur_kernel, KeypointPeak *peaks) {
+  decode_heatmaps(heatmaps, qscale, num_joints, height, width, refine, blur_kernel, peaks);
+}
+
+/* vertex of the parabola through the maximum and its neighbours, within half a bin */
+static inline float parabola_offset(const float *v, int i, int n) {
+  if (i <= 0 || i >= n - 1) return 0;
+  const float denom = v[i - 1] - 2 * v[i] + v[i + 1];
+  if (denom >= 0) return 0;
+  return std::min(std::max(0.5f * (v[i - 1] - v[i + 1]) / denom, -0.5f), 0.5f);
+}
+
+void DecodeSimCC(const float *simcc_x, int x_len, const float *simcc_y, int y_len,
+                 int num_joints, float split_ratio, cvtdl_keypoint_refine_e refine,
+                 KeypointPeak *peaks) {
+  for (int j = 0; j < num_joints; j++) {
+    const float *vx = simcc_x + (size_t)j * x_len;
+    const float *vy = simcc_y + (size_t)j * y_len;
+    float max_x, max_y;
+    const int ix = VectorArgmax(vx, x_len, &max_x);
+    const int iy = VectorArgmax(vy, y_len, &max_y);
+    float fx = ix, fy = iy;
+    if (refine != CVTDL_KEYPOINT_REFINE_NONE) {
+      fx += parabola_offset(vx, ix, x_len);
+      fy += parabola_offset(vy, iy, y_len);
+    }
+    peaks[j].x = fx / split_ratio;
+    peaks[j].y = fy / split_ratio;
+    peaks[j].score = std::min(max_x, max_y);
+  }
+}
+
+}  // namespace cvitdl
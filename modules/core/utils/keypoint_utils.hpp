@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+#include "core/object/cvtdl_object_types.h"
+
+namespace cvitdl {
+
+typedef struct {
+  // position in heatmap pixels (SimCC: in bins divided by the split ratio)
+  float x;
+  float y;
+  float score;
+} KeypointPeak;
+
+/*
+ * Index of the first maximum of n > 0 values, the maximum is written to max_value.
+ * With NEON the maximum is a vector reduction and the index is found by a second pass over the
+ * values, otherwise a single scalar pass.
+ */
+int VectorArgmax(const float *values, int n, float *max_value);
+int VectorArgmax(const int8_t *values, int n, int8_t *max_value);
+
+/*
+ * Peaks of num_joints joint-major height x width heatmaps, score is the heatmap maximum
+ * (multiplied by qscale for int8 heatmaps). CVTDL_KEYPOINT_REFINE_DARK fits a second order
+ * Taylor expansion to the log of the heatmap blurred by a blur_kernel x blur_kernel Gaussian
+ * (odd size, 1 skips the blur). The blur is only evaluated on the 5 x 5 window around the peak.
+ */
+void DecodeHeatmaps(const float *heatmaps, int num_joints, int height, int width,
+                    cvtdl_keypoint_refine_e refine, int blur_kernel, KeypointPeak *peaks);
+void DecodeHeatmaps(const int8_t *heatmaps, float qscale, int num_joints, int height, int width,
+                    cvtdl_keypoint_refine_e refine, int blur_kernel, KeypointPeak *peaks);
+
+/*
+ * SimCC peaks from num_joints x x_len and num_joints x y_len classification vectors, score is the
+ * smaller of the two maxima. Any refinement other than NONE fits a parabola through the
+ * neighbours of each maximum.
+ */
+void DecodeSimCC(const float *simcc_x, int x_len, const float *simcc_y, int y_len,
+                 int num_joints, float split_ratio, cvtdl_keypoint_refine_e refine,
+                 KeypointPeak *peaks);
+
+}  // namespace cvitdl
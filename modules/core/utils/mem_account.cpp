@@ -0,0 +1,137 @@
+#include "mem_account.hpp"
+#include <inttypes.h>
+#include <time.h>
+#include <algorithm>
+#include "cvi_tdl_log.hpp"
+
+namespace cvitdl {
+
+static const char *mem_type_name(int type) {
+  switch (type) {
+    case CVI_TDL_MEM_HEAP:
+      return "heap";
+    case CVI_TDL_MEM_ION:
+      return "ion";
+    case CVI_TDL_MEM_VB:
+      return "vb";
+    default:
+      return "unknown";
+  }
+}
+
+MemAccount::~MemAccount() {
+  // leaked bytes stay on the parent, so the handle keeps reporting them
+  for (int i = 0; i < CVI_TDL_MEM_TYPE_NUM; i++) {
+    uint64_t live = m_counter[i].live.load();
+    if (live != 0) {
+      LOGW("%s leaks %" PRIu64 " %s bytes\n", m_name.c_str(), live, mem_type_name(i));
+    }
+  }
+}
+
+void MemAccount::alloc(cvtdl_mem_type_e type, uint64_t bytes) {
+  if (type < 0 || type >= CVI_TDL_MEM_TYPE_NUM || bytes == 0) return;
+  Counter &c = m_counter[type];
+  uint64_t live = c.live.fetch_add(bytes) + bytes;
+  uint64_t peak = c.peak.load();
+  while (live > peak && !c.peak.compare_exchange_weak(peak, live)) {
+  }
+  c.total.fetch_add(bytes);
+  c.allocs.fetch_add(1);
+  if (mp_parent) mp_parent->alloc(type, bytes);
+}
+
+void MemAccount::release(cvtdl_mem_type_e type, uint64_t bytes) {
+  if (type < 0 || type >= CVI_TDL_MEM_TYPE_NUM || bytes == 0) return;
+  Counter &c = m_counter[type];
+  uint64_t live = c.live.load();
+  uint64_t freed;
+  do {
+    freed = bytes < live ? bytes : live;
+  } while (!c.live.compare_exchange_weak(live, live - freed));
+  if (freed != bytes) {
+    LOGW("%s releases %" PRIu64 " %s bytes more than it holds\n", m_name.c_str(), bytes - freed,
+         mem_type_name(type));
+  }
+  c.frees.fetch_add(1);
+  if (mp_parent) mp_parent->release(type, freed);
+}
+
+void MemAccount::set(cvtdl_mem_type_e type, uint64_t bytes) {
+  if (type < 0 || type >= CVI_TDL_MEM_TYPE_NUM) return;
+  uint64_t live = m_counter[type].live.load();
+  if (bytes > live) {
+    alloc(type, bytes - live);
+  } else if (bytes < live) {
+    release(type, live - bytes);
+  }
+}
+
+void MemAccount::setParent(const std::shared_ptr<MemAccount> &parent) {
+  if (parent.get() == this) return;
+  for (int i = 0; i < CVI_TDL_MEM_TYPE_NUM; i++) {
+    uint64_t live = m_counter[i].live.load();
+    if (live == 0) continue;
+    if (mp_parent) mp_parent->release((cvtdl_mem_type_e)i, live);
+    if (parent) parent->alloc((cvtdl_mem_type_e)i, live);
+  }
+  mp_parent = parent;
+}
+
+void MemAccount::query(cvtdl_mem_usage_t *usage) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  double now = ts.tv_sec * 1000. + ts.tv_nsec / 1e6;
+  double elapsed = m_last_query_ms > 0 ? (now - m_last_query_ms) / 1000. : 0;
+  m_last_query_ms = now;
+  for (int i = 0; i < CVI_TDL_MEM_TYPE_NUM; i++) {
+    Counter &c = m_counter[i];
+    cvtdl_mem_counter_t &out = usage->counter[i];
+    out.live_bytes = c.live.load();
+    out.peak_bytes = c.peak.load();
+    out.total_bytes = c.total.load();
+    out.alloc_count = c.allocs.load();
+    out.free_count = c.frees.load();
+    out.alloc_rate = elapsed > 0 ? (float)((out.total_bytes - c.last_total) / elapsed) : 0.f;
+    c.last_total = out.total_bytes;
+  }
+}
+
+void MemAccount::dump(const char *indent) {
+  cvtdl_mem_usage_t usage;
+  query(&usage);
+  for (int i = 0; i < CVI_TDL_MEM_TYPE_NUM; i++) {
+    const cvtdl_mem_counter_t &c = usage.counter[i];
+    if (c.alloc_count == 0) continue;
+    printf("%s%s %s: live %" PRIu64 ", peak %" PRIu64 ", total %" PRIu64 ", allocs %" PRIu64
+           ", frees %" PRIu64 ", %.1f B/s\n",
+           indent, m_name.c_str(), mem_type_name(i), c.live_bytes, c.peak_bytes, c.total_bytes,
+           c.alloc_count, c.free_count, c.alloc_rate);
+  }
+}
+
+void SharedCharge::setBytes(cvtdl_mem_type_e type, uint64_t bytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_type = type;
+  m_bytes = bytes;
+}
+
+void SharedCharge::addHolder(MemAccount *account) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (std::find(m_holders.begin(), m_holders.end(), account) != m_holders.end()) return;
+  m_holders.push_back(account);
+  if (m_holders.size() == 1) account->alloc(m_type, m_bytes);
+}
+
+void SharedCharge::removeHolder(MemAccount *account) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = std::find(m_holders.begin(), m_holders.end(), account);
+  if (it == m_holders.end()) return;
+  bool charged = it == m_holders.begin();
+  m_holders.erase(it);
+  if (!charged) return;
+  account->release(m_type, m_bytes);
+  if (!m_holders.empty()) m_holders.front()->alloc(m_type, m_bytes);
+}
+}  // namespace cvitdl
@@ -0,0 +1,78 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "core/core/cvtdl_core_types.h"
+
+namespace cvitdl {
+
+/*
+ * Byte counters of one owner (a model, a tracker, a handle) per memory type. Every change is
+ * forwarded to the parent, so the account of a handle sums the accounts of what it owns. The
+ * counters are atomics and may be updated from any thread.
+ */
+class MemAccount {
+ public:
+  explicit MemAccount(const char *name = "") : m_name(name) {}
+  MemAccount(const MemAccount &) = delete;
+  MemAccount &operator=(const MemAccount &) = delete;
+  ~MemAccount();
+
+  void alloc(cvtdl_mem_type_e type, uint64_t bytes);
+  void release(cvtdl_mem_type_e type, uint64_t bytes);
+  /* for the owners that only know their current size, charges or releases the difference */
+  void set(cvtdl_mem_type_e type, uint64_t bytes);
+
+  /* moves the live bytes from the current parent to the new one, call it before the owner runs */
+  void setParent(const std::shared_ptr<MemAccount> &parent);
+  void setName(const char *name) { m_name = name; }
+  const std::string &getName() const { return m_name; }
+
+  /* alloc_rate covers the time since the previous query of this account */
+  void query(cvtdl_mem_usage_t *usage);
+  void dump(const char *indent = "");
+
+ private:
+  struct Counter {
+    std::atomic<uint64_t> live{0};
+    std::atomic<uint64_t> peak{0};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> allocs{0};
+    std::atomic<uint64_t> frees{0};
+    uint64_t last_total = 0;
+  };
+
+  std::string m_name;
+  Counter m_counter[CVI_TDL_MEM_TYPE_NUM];
+  std::shared_ptr<MemAccount> mp_parent;
+  std::mutex m_mutex;
+  double m_last_query_ms = 0;
+};
+
+/*
+ * Bytes shared by several owners, like the weights of a model opened by several instances. They
+ * are charged to the oldest holder only and move to the next one when it leaves, so they are
+ * counted once and stay counted while anyone holds them.
+ */
+class SharedCharge {
+ public:
+  SharedCharge() = default;
+  SharedCharge(const SharedCharge &) = delete;
+  SharedCharge &operator=(const SharedCharge &) = delete;
+
+  /* call it before the first holder is added */
+  void setBytes(cvtdl_mem_type_e type, uint64_t bytes);
+  void addHolder(MemAccount *account);
+  /* a holder must leave before its account is destroyed */
+  void removeHolder(MemAccount *account);
+
+ private:
+  cvtdl_mem_type_e m_type = CVI_TDL_MEM_HEAP;
+  uint64_t m_bytes = 0;
+  std::mutex m_mutex;
+  std::vector<MemAccount *> m_holders;
+};
+}  // namespace cvitdl
@@ -0,0 +1,79 @@
+#include "meta_arena.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+namespace cvitdl {
+
+#define META_ARENA_ALIGN 16
+#define META_ARENA_MIN_BLOCK 4096
+
+MetaArena::~MetaArena() {
+  for (auto &block : m_blocks) {
+    free(block.data);
+  }
+}
+
+void *MetaArena::alloc(size_t bytes) {
+  bytes = (bytes + META_ARENA_ALIGN - 1) & ~size_t(META_ARENA_ALIGN - 1);
+  while (m_cur < m_blocks.size()) {
+    if (m_offset + bytes <= m_blocks[m_cur].size) {
+      void *ptr = m_blocks[m_cur].data + m_offset;
+      m_offset += bytes;
+      memset(ptr, 0, bytes);
+      return ptr;
+    }
+    m_cur++;
+    m_offset = 0;
+  }
+
+  size_t size = m_blocks.empty() ? META_ARENA_MIN_BLOCK : m_blocks.back().size * 2;
+  size = std::max(size, bytes);
+  uint8_t *data = (uint8_t *)malloc(size);
+  if (data == nullptr) {
+    return nullptr;
+  }
+  m_blocks.push_back({data, size});
+  m_cur = m_blocks.size() - 1;
+  m_offset = bytes;
+  memset(data, 0, bytes);
+  return data;
+}
+
+void MetaArena::reset() {
+  // merge the blocks a grown frame needed into one, so later frames are served by a single block
+  if (m_blocks.size() > 1) {
+    size_t total = capacity();
+    for (auto &block : m_blocks) {
+      free(block.data);
+    }
+    m_blocks.clear();
+    uint8_t *data = (uint8_t *)malloc(total);
+    if (data != nullptr) {
+      m_blocks.push_back({data, total});
+    }
+  }
+  m_cur = 0;
+  m_offset = 0;
+}
+
+size_t MetaArena::capacity() const {
+  size_t total = 0;
+  for (auto &block : m_blocks) {
+    total += block.size;
+  }
+  return total;
+}
+
+bool MetaArena::owns(const void *ptr) const {
+  const uint8_t *p = (const uint8_t *)ptr;
+  for (auto &block : m_blocks) {
+    if (p >= block.data && p < block.data + block.size) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace cvitdl
@@ -0,0 +1,38 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace cvitdl {
+
+/**
+ * Bump allocator backing the per-object payloads (pts, properity structs) of a result meta.
+ *
+ * reset() rewinds all blocks instead of freeing them, so a meta reused frame after frame stops
+ * hitting malloc once the arena has grown to the largest result seen. owns() tells arena memory
+ * from heap memory when the payloads of the meta are released.
+ */
+class MetaArena {
+ public:
+  MetaArena() = default;
+  ~MetaArena();
+  MetaArena(const MetaArena &) = delete;
+  MetaArena &operator=(const MetaArena &) = delete;
+
+  /* zero-initialized, 16 byte aligned, nullptr if a new block cannot be allocated */
+  void *alloc(size_t bytes);
+  void reset();
+  size_t capacity() const;
+  bool owns(const void *ptr) const;
+
+ private:
+  struct Block {
+    uint8_t *data;
+    size_t size;
+  };
+  std::vector<Block> m_blocks;
+  size_t m_cur = 0;
+  size_t m_offset = 0;
+};
+
+}  // namespace cvitdl
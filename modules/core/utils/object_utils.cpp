@@ -1,6 +1,7 @@
 
 #include "object_utils.hpp"
 #include "core/object/cvtdl_object_types.h"
+#include "trace.hpp"
 
 #include <math.h>
 #include <algorithm>
@@ -45,6 +46,7 @@ Detections topk_dets(const Detections &dets, uint32_t max_det) {
 }
 
 Detections nms_multi_class(const Detections &dets, float iou_threshold) {
+  TraceScope trace("nms", "postprocess");
   vector<int> keep(dets.size(), 0);
   vector<int> suppressed(dets.size(), 0);
 
@@ -89,6 +91,7 @@ Detections nms_multi_class(const Detections &dets, float iou_threshold) {
 
 Detections nms_multi_class_with_ids(const Detections &dets, float iou_threshold,
                                     vector<int> &keep) {
+  TraceScope trace("nms", "postprocess");
   vector<int> suppressed(dets.size(), 0);
 
   size_t ndets = dets.size();
@@ -0,0 +1,85 @@
+#include "requant_utils.hpp"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace cvitdl {
+
+static inline int8_t saturate_int8(float v) {
+  if (!(v == v)) return 0;
+  if (v <= -128.f) return -128;
+  if (v >= 127.f) return 127;
+  return static_cast<int8_t>(v);
+}
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+// four float vectors to 16 saturated int8, vcvtq_s32_f32 truncates towards zero like the cast
+static inline int8x16_t narrow_f32x16(float32x4_t f0, float32x4_t f1, float32x4_t f2,
+                                      float32x4_t f3) {
+  int16x8_t lo = vcombine_s16(vqmovn_s32(vcvtq_s32_f32(f0)), vqmovn_s32(vcvtq_s32_f32(f1)));
+  int16x8_t hi = vcombine_s16(vqmovn_s32(vcvtq_s32_f32(f2)), vqmovn_s32(vcvtq_s32_f32(f3)));
+  return vcombine_s8(vqmovn_s16(lo), vqmovn_s16(hi));
+}
+#endif
+
+void RequantizeInt8(const int8_t *src, int n, float scale, int8_t *dst) {
+  int i = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  float32x4_t vscale = vdupq_n_f32(scale);
+  for (; i + 16 <= n; i += 16) {
+    int8x16_t v = vld1q_s8(src + i);
+    int16x8_t lo = vmovl_s8(vget_low_s8(v));
+    int16x8_t hi = vmovl_s8(vget_high_s8(v));
+    float32x4_t f0 = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(lo))), vscale);
+    float32x4_t f1 = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(lo))), vscale);
+    float32x4_t f2 = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(hi))), vscale);
+    float32x4_t f3 = vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(hi))), vscale);
+    vst1q_s8(dst + i, narrow_f32x16(f0, f1, f2, f3));
+  }
+  for (; i < n; i++) {
+    dst[i] = saturate_int8(src[i] * scale);
+  }
+#else
+  // 256 possible inputs, a table beats the per element multiply
+  int8_t lut[256];
+  for (int v = -128; v < 128; v++) {
+    lut[v + 128] = saturate_int8(v * scale);
+  }
+  for (; i < n; i++) {
+    dst[i] = lut[src[i] + 128];
+  }
+#endif
+}
+
+void RequantizeInt8(const float *src, int n, float scale, int8_t *dst) {
+  int i = 0;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  float32x4_t vscale = vdupq_n_f32(scale);
+  for (; i + 16 <= n; i += 16) {
+    float32x4_t f0 = vmulq_f32(vld1q_f32(src + i), vscale);
+    float32x4_t f1 = vmulq_f32(vld1q_f32(src + i + 4), vscale);
+    float32x4_t f2 = vmulq_f32(vld1q_f32(src + i + 8), vscale);
+    float32x4_t f3 = vmulq_f32(vld1q_f32(src + i + 12), vscale);
+    vst1q_s8(dst + i, narrow_f32x16(f0, f1, f2, f3));
+  }
+#endif
+  for (; i < n; i++) {
+    dst[i] = saturate_int8(src[i] * scale);
+  }
+}
+
+void BuildDepthLUT(float baseline, float focal, float disparity_scale, float lut[256]) {
+  for (int d = -128; d < 128; d++) {
+    float disparity = d * disparity_scale;
+    lut[d + 128] = d > 0 && disparity > 0 ? baseline * focal / disparity : 0.f;
+  }
+}
+
+void LookupDepth(const int8_t *src, int n, const float lut[256], float *dst) {
+  for (int i = 0; i < n; i++) {
+    dst[i] = lut[src[i] + 128];
+  }
+}
+
+}  // namespace cvitdl
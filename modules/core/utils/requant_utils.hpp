@@ -0,0 +1,22 @@
+#pragma once
+#include <stdint.h>
+
+namespace cvitdl {
+
+/*
+ * dst[i] = saturate_int8(trunc(src[i] * scale)), NaN gives 0. The int8 version is exact against
+ * the float multiply of the scalar loop it replaces, both use NEON when available.
+ */
+void RequantizeInt8(const int8_t *src, int n, float scale, int8_t *dst);
+void RequantizeInt8(const float *src, int n, float scale, int8_t *dst);
+
+/*
+ * Disparity to metric depth table indexed by the int8 disparity + 128:
+ * baseline * focal / (disparity * disparity_scale), 0 for the disparities <= 0.
+ */
+void BuildDepthLUT(float baseline, float focal, float disparity_scale, float lut[256]);
+
+/* dst[i] = lut[src[i] + 128] */
+void LookupDepth(const int8_t *src, int n, const float lut[256], float *dst);
+
+}  // namespace cvitdl
@@ -0,0 +1,93 @@
+#include "result_channel.hpp"
+
+#include <string.h>
+#include <utility>
+#include "core/cvi_tdl_types_mem.h"
+
+#define SLOT_MASK 0xffULL
+#define COUNT_ONE 0x100ULL
+// keeps the refcount of the current slot away from zero until the producer retires it
+#define REFS_BIAS (1LL << 40)
+
+namespace cvitdl {
+
+ResultChannel::ResultChannel(bool is_face) : m_is_face(is_face), m_current(0) {
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    memset(&m_slots[i].obj, 0, sizeof(m_slots[i].obj));
+    memset(&m_slots[i].face, 0, sizeof(m_slots[i].face));
+    m_slots[i].seq = 0;
+    m_slots[i].refs.store(0);
+    m_slots[i].in_use.store(false);
+  }
+}
+
+ResultChannel::~ResultChannel() {
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    CVI_TDL_FreeCpp(&m_slots[i].obj);
+    CVI_TDL_FreeCpp(&m_slots[i].face);
+  }
+}
+
+void ResultChannel::retire(Slot &slot, int64_t readers) {
+  int64_t delta = readers - REFS_BIAS;
+  if (slot.refs.fetch_add(delta, std::memory_order_acq_rel) + delta == 0) {
+    slot.in_use.store(false, std::memory_order_release);
+  }
+}
+
+bool ResultChannel::publish(void *meta) {
+  int free_idx = -1;
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    if (!m_slots[i].in_use.load(std::memory_order_acquire)) {
+      free_idx = i;
+      break;
+    }
+  }
+  if (free_idx < 0) {
+    return false;
+  }
+
+  Slot &slot = m_slots[free_idx];
+  if (m_is_face) {
+    std::swap(slot.face, *static_cast<cvtdl_face_t *>(meta));
+  } else {
+    std::swap(slot.obj, *static_cast<cvtdl_object_t *>(meta));
+  }
+  slot.seq = ++m_seq;
+  slot.refs.store(REFS_BIAS, std::memory_order_relaxed);
+  slot.in_use.store(true, std::memory_order_relaxed);
+
+  uint64_t old = m_current.exchange(uint64_t(free_idx + 1), std::memory_order_acq_rel);
+  if ((old & SLOT_MASK) != 0) {
+    retire(m_slots[(old & SLOT_MASK) - 1], int64_t(old / COUNT_ONE));
+  }
+  return true;
+}
+
+const void *ResultChannel::acquire(uint64_t *seq) {
+  uint64_t cur = m_current.fetch_add(COUNT_ONE, std::memory_order_acq_rel);
+  if ((cur & SLOT_MASK) == 0) {
+    return nullptr;
+  }
+  Slot &slot = m_slots[(cur & SLOT_MASK) - 1];
+  if (seq != nullptr) {
+    *seq = slot.seq;
+  }
+  return metaOf(slot);
+}
+
+bool ResultChannel::release(const void *meta) {
+  for (int i = 0; i < MAX_SLOTS; i++) {
+    Slot &slot = m_slots[i];
+    if (meta != metaOf(slot)) {
+      continue;
+    }
+    if (slot.refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      slot.in_use.store(false, std::memory_order_release);
+    }
+    return true;
+  }
+  return false;
+}
+
+}  // namespace cvitdl
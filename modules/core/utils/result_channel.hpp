@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include "core/face/cvtdl_face_types.h"
+#include "core/object/cvtdl_object_types.h"
+
+namespace cvitdl {
+
+/**
+ * Single producer, multi reader publication slot for result metas.
+ *
+ * publish() moves the producer's meta into a free snapshot slot and hands back the meta of a
+ * recycled slot, so nothing is copied and the producer keeps reusing allocated metas. Readers
+ * acquire the latest snapshot without blocking: the current slot index and an acquire counter
+ * share one atomic word, so a reader takes its reference with a single fetch_add and the
+ * producer folds the counter into the slot refcount when it retires the slot. A slot becomes
+ * free again when its last reader releases it.
+ */
+class ResultChannel {
+ public:
+  static const int MAX_SLOTS = 8;
+
+  explicit ResultChannel(bool is_face);
+  ~ResultChannel();
+
+  bool isFace() const { return m_is_face; }
+  /* meta is swapped with a recycled one, returns false if readers hold every slot */
+  bool publish(void *meta);
+  /* returns nullptr if nothing was published yet */
+  const void *acquire(uint64_t *seq);
+  bool release(const void *meta);
+
+ private:
+  struct Slot {
+    cvtdl_object_t obj;
+    cvtdl_face_t face;
+    uint64_t seq;
+    std::atomic<int64_t> refs;
+    std::atomic<bool> in_use;
+  };
+
+  void *metaOf(Slot &slot) { return m_is_face ? (void *)&slot.face : (void *)&slot.obj; }
+  void retire(Slot &slot, int64_t readers);
+
+  bool m_is_face;
+  Slot m_slots[MAX_SLOTS];
+  // (acquire count << 8) | (slot index + 1), slot 0 means nothing published
+  std::atomic<uint64_t> m_current;
+  uint64_t m_seq = 0;
+};
+
+}  // namespace cvitdl
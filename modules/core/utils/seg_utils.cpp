@@ -0,0 +1,185 @@
+#include "seg_utils.hpp"
+
+#include <string.h>
+#include <type_traits>
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+namespace cvitdl {
+
+/* pixels per block, keeps the running maximum and labels of a block in L1 */
+#define ARGMAX_BLOCK 256
+
+void BuildClassFilterLUT(const cvtdl_class_filter_t *filter, uint8_t lut[256]) {
+  if (filter == NULL) {
+    for (int i = 0; i < 256; i++) lut[i] = (uint8_t)i;
+    return;
+  }
+  memset(lut, 0, 256);
+  for (uint32_t j = 0; j < filter->num_preserved_classes; j++) {
+    uint32_t c = filter->preserved_class_ids[j];
+    if (c < 256) lut[c] = (uint8_t)c;
+  }
+}
+
+/* branchless select on lanes of the score width so the compiler can vectorize it where no
+ * intrinsics are written, labels are narrowed to uint8 afterwards */
+template <typename T, typename LabelT>
+static inline void argmax_block_scalar(const T *src, int channels, int plane, int n, T *best,
+                                       uint8_t *labels) {
+  LabelT lab[ARGMAX_BLOCK];
+  for (int x = 0; x < n; x++) {
+    best[x] = src[x];
+    lab[x] = 0;
+  }
+  for (int c = 1; c < channels; c++) {
+    const T *p = src + c * plane;
+    const LabelT lc = (LabelT)c;
+    for (int x = 0; x < n; x++) {
+      const bool gt = p[x] > best[x];
+      best[x] = gt ? p[x] : best[x];
+      lab[x] = gt ? lc : lab[x];
+    }
+  }
+  for (int x = 0; x < n; x++) labels[x] = (uint8_t)lab[x];
+}
+
+/* float compares are not if-converted under strict IEEE semantics, compare order preserving
+ * integer keys instead (-0 orders below +0, which does not matter for argmax) */
+static inline int32_t float_key(float v) {
+  int32_t i;
+  memcpy(&i, &v, sizeof(i));
+  return i ^ ((i >> 31) & 0x7fffffff);
+}
+
+template <>
+inline void argmax_block_scalar<float, uint32_t>(const float *src, int channels, int plane, int n,
+                                                 float *best, uint8_t *labels) {
+  int32_t key[ARGMAX_BLOCK];
+  int32_t lab[ARGMAX_BLOCK];
+  for (int x = 0; x < n; x++) {
+    key[x] = float_key(src[x]);
+    lab[x] = 0;
+  }
+  for (int c = 1; c < channels; c++) {
+    const float *p = src + c * plane;
+    for (int x = 0; x < n; x++) {
+      const int32_t k = float_key(p[x]);
+      const bool gt = k > key[x];
+      key[x] = gt ? k : key[x];
+      lab[x] = gt ? c : lab[x];
+    }
+  }
+  for (int x = 0; x < n; x++) {
+    labels[x] = (uint8_t)lab[x];
+    best[x] = src[lab[x] * plane + x];
+  }
+}
+
+static int argmax_block_simd(const int8_t *src, int channels, int plane, int n, int8_t *best,
+                             uint8_t *labels) {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  int x = 0;
+  for (; x + 16 <= n; x += 16) {
+    int8x16_t vbest = vld1q_s8(src + x);
+    uint8x16_t vlabel = vdupq_n_u8(0);
+    for (int c = 1; c < channels; c++) {
+      int8x16_t v = vld1q_s8(src + c * plane + x);
+      uint8x16_t gt = vcgtq_s8(v, vbest);
+      vbest = vmaxq_s8(vbest, v);
+      vlabel = vbslq_u8(gt, vdupq_n_u8((uint8_t)c), vlabel);
+    }
+    vst1q_s8(best + x, vbest);
+    vst1q_u8(labels + x, vlabel);
+  }
+  return x;
+#else
+  (void)src;
+  (void)channels;
+  (void)plane;
+  (void)n;
+  (void)best;
+  (void)labels;
+  return 0;
+#endif
+}
+
+static int argmax_block_simd(const float *src, int channels, int plane, int n, float *best,
+                             uint8_t *labels) {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+  int x = 0;
+  for (; x + 8 <= n; x += 8) {
+    float32x4_t vbest0 = vld1q_f32(src + x);
+    float32x4_t vbest1 = vld1q_f32(src + x + 4);
+    uint32x4_t vlabel0 = vdupq_n_u32(0);
+    uint32x4_t vlabel1 = vdupq_n_u32(0);
+    for (int c = 1; c < channels; c++) {
+      const float *p = src + c * plane + x;
+      float32x4_t v0 = vld1q_f32(p);
+      float32x4_t v1 = vld1q_f32(p + 4);
+      uint32x4_t gt0 = vcgtq_f32(v0, vbest0);
+      uint32x4_t gt1 = vcgtq_f32(v1, vbest1);
+      vbest0 = vbslq_f32(gt0, v0, vbest0);
+      vbest1 = vbslq_f32(gt1, v1, vbest1);
+      uint32x4_t vc = vdupq_n_u32((uint32_t)c);
+      vlabel0 = vbslq_u32(gt0, vc, vlabel0);
+      vlabel1 = vbslq_u32(gt1, vc, vlabel1);
+    }
+    vst1q_f32(best + x, vbest0);
+    vst1q_f32(best + x + 4, vbest1);
+    uint16x8_t l16 = vcombine_u16(vmovn_u32(vlabel0), vmovn_u32(vlabel1));
+    vst1_u8(labels + x, vmovn_u16(l16));
+  }
+  return x;
+#else
+  (void)src;
+  (void)channels;
+  (void)plane;
+  (void)n;
+  (void)best;
+  (void)labels;
+  return 0;
+#endif
+}
+
+template <typename T>
+static void channel_argmax(const T *scores, int channels, int height, int width, float qscale,
+                           const uint8_t *class_lut, uint8_t *labels, int label_stride,
+                           float *confidence) {
+  const int plane = height * width;
+  T best[ARGMAX_BLOCK];
+  for (int y = 0; y < height; y++) {
+    uint8_t *label_row = labels + y * label_stride;
+    for (int x0 = 0; x0 < width; x0 += ARGMAX_BLOCK) {
+      const int n = width - x0 < ARGMAX_BLOCK ? width - x0 : ARGMAX_BLOCK;
+      const T *src = scores + y * width + x0;
+      uint8_t *dst = label_row + x0;
+      int done = argmax_block_simd(src, channels, plane, n, best, dst);
+      if (done < n) {
+        argmax_block_scalar<T, typename std::conditional<sizeof(T) == 1, uint8_t, uint32_t>::type>(
+            src + done, channels, plane, n - done, best + done, dst + done);
+      }
+      if (class_lut != NULL) {
+        for (int x = 0; x < n; x++) dst[x] = class_lut[dst[x]];
+      }
+      if (confidence != NULL) {
+        float *conf = confidence + y * width + x0;
+        for (int x = 0; x < n; x++) conf[x] = best[x] * qscale;
+      }
+    }
+  }
+}
+
+void ChannelArgmax(const int8_t *scores, int channels, int height, int width, float qscale,
+                   const uint8_t *class_lut, uint8_t *labels, int label_stride, float *confidence) {
+  channel_argmax(scores, channels, height, width, qscale, class_lut, labels, label_stride,
+                 confidence);
+}
+
+void ChannelArgmax(const float *scores, int channels, int height, int width,
+                   const uint8_t *class_lut, uint8_t *labels, int label_stride, float *confidence) {
+  channel_argmax(scores, channels, height, width, 1.f, class_lut, labels, label_stride, confidence);
+}
+
+}  // namespace cvitdl
@@ -0,0 +1,24 @@
+#pragma once
+#include <stdint.h>
+#include "core/object/cvtdl_object_types.h"
+
+namespace cvitdl {
+
+/*
+ * Build a 256 entry label lookup table from a class filter: preserved classes map to themselves,
+ * the others to 0 ("unlabeled", always preserved). A NULL filter keeps every class.
+ */
+void BuildClassFilterLUT(const cvtdl_class_filter_t *filter, uint8_t lut[256]);
+
+/*
+ * Per pixel argmax over a channel-major C x H x W score tensor (at most 256 channels).
+ * Ties resolve to the lowest channel. The result is written to labels (row stride label_stride),
+ * remapped through class_lut if it is not NULL. If confidence is not NULL, the winning score
+ * (multiplied by qscale for int8 scores) is written to it in the same pass, row stride width.
+ */
+void ChannelArgmax(const int8_t *scores, int channels, int height, int width, float qscale,
+                   const uint8_t *class_lut, uint8_t *labels, int label_stride, float *confidence);
+void ChannelArgmax(const float *scores, int channels, int height, int width,
+                   const uint8_t *class_lut, uint8_t *labels, int label_stride, float *confidence);
+
+}  // namespace cvitdl
@@ -0,0 +1,168 @@
+#include "stream_scheduler.hpp"
+#include <pthread.h>
+#include <stdio.h>
+#include "core/core/cvtdl_errno.h"
+#include "cvi_tdl_log.hpp"
+#include "trace.hpp"
+
+namespace cvitdl {
+
+StreamScheduler::StreamScheduler(const cvtdl_stream_sched_config_t &config, RunFunc run,
+                                 DropFunc drop)
+    : m_config(config), m_run(run), m_drop(drop), m_streams(config.max_streams) {
+  for (Stream &s : m_streams) {
+    s.ring.resize(m_config.queue_depth);
+  }
+  for (uint32_t i = 0; i < m_config.num_workers; i++) {
+    m_workers.emplace_back(&StreamScheduler::workerLoop, this, i);
+    char name[16];
+    snprintf(name, sizeof(name), "tdl_sched%u", i);
+    pthread_setname_np(m_workers.back().native_handle(), name);
+  }
+}
+
+StreamScheduler::~StreamScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_work_cond.notify_all();
+  for (std::thread &t : m_workers) {
+    t.join();
+  }
+  std::vector<Dropped> dropped;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (uint32_t i = 0; i < m_streams.size(); i++) {
+      Stream &s = m_streams[i];
+      while (s.count > 0) {
+        dropped.push_back({i, popFront(s).frame});
+        s.stats.dropped++;
+      }
+    }
+    m_dropping += dropped.size();
+  }
+  dropAll(dropped);
+}
+
+StreamScheduler::Pending StreamScheduler::popFront(Stream &s) {
+  Pending p = s.ring[s.head];
+  s.head = (s.head + 1) % s.ring.size();
+  s.count--;
+  m_queued--;
+  return p;
+}
+
+void StreamScheduler::dropAll(const std::vector<Dropped> &dropped) {
+  if (dropped.empty()) return;
+  for (const Dropped &d : dropped) {
+    m_drop(d.stream, d.frame);
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_dropping -= dropped.size();
+  if (m_queued == 0 && m_in_flight == 0 && m_dropping == 0) {
+    m_idle_cond.notify_all();
+  }
+}
+
+int StreamScheduler::submit(uint32_t stream, VIDEO_FRAME_INFO_S *frame) {
+  if (stream >= m_streams.size() || frame == nullptr) {
+    LOGE("invalid stream %u or frame\n", stream);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  std::vector<Dropped> dropped;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stop) {
+      return CVI_TDL_FAILURE;
+    }
+    Stream &s = m_streams[stream];
+    s.stats.submitted++;
+    if (s.count == s.ring.size()) {
+      dropped.push_back({stream, popFront(s).frame});
+      s.stats.dropped++;
+      m_dropping++;
+    }
+    s.ring[(s.head + s.count) % s.ring.size()] = {frame, trace::now_us()};
+    s.count++;
+    m_queued++;
+  }
+  m_work_cond.notify_one();
+  dropAll(dropped);
+  return CVI_TDL_SUCCESS;
+}
+
+int StreamScheduler::pickStream(uint64_t now_us, std::vector<Dropped> *expired) {
+  const uint64_t deadline_us = (uint64_t)m_config.deadline_ms * 1000;
+  int next = -1;
+  uint64_t oldest = UINT64_MAX;
+  for (uint32_t i = 0; i < m_streams.size(); i++) {
+    Stream &s = m_streams[i];
+    while (deadline_us > 0 && s.count > 0 && now_us - s.ring[s.head].submit_us > deadline_us) {
+      expired->push_back({i, popFront(s).frame});
+      s.stats.dropped++;
+    }
+    if (!s.busy && s.count > 0 && s.ring[s.head].submit_us < oldest) {
+      oldest = s.ring[s.head].submit_us;
+      next = i;
+    }
+  }
+  return next;
+}
+
+void StreamScheduler::workerLoop(uint32_t worker) {
+  std::vector<Dropped> expired;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_stop) {
+    expired.clear();
+    int next = pickStream(trace::now_us(), &expired);
+    if (!expired.empty()) {
+      m_dropping += expired.size();
+      lock.unlock();
+      dropAll(expired);
+      lock.lock();
+      continue;
+    }
+    if (next < 0) {
+      m_work_cond.wait(lock);
+      continue;
+    }
+
+    Stream &s = m_streams[next];
+    Pending p = popFront(s);
+    s.busy = true;
+    m_in_flight++;
+    lock.unlock();
+    int ret = m_run(worker, next, p.frame);
+    float latency_ms = (trace::now_us() - p.submit_us) / 1000.f;
+    lock.lock();
+
+    s.busy = false;
+    m_in_flight--;
+    s.stats.processed++;
+    if (ret != CVI_TDL_SUCCESS) s.stats.failed++;
+    s.latency_sum_ms += latency_ms;
+    if (latency_ms > s.stats.max_latency_ms) s.stats.max_latency_ms = latency_ms;
+    if (m_queued == 0 && m_in_flight == 0 && m_dropping == 0) {
+      m_idle_cond.notify_all();
+    }
+  }
+}
+
+void StreamScheduler::flush() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_idle_cond.wait(lock,
+                   [this] { return m_queued == 0 && m_in_flight == 0 && m_dropping == 0; });
+}
+
+int StreamScheduler::getStats(uint32_t stream, cvtdl_stream_stats_t *stats) {
+  if (stream >= m_streams.size() || stats == nullptr) {
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const Stream &s = m_streams[stream];
+  *stats = s.stats;
+  stats->avg_latency_ms = s.stats.processed > 0 ? s.latency_sum_ms / s.stats.processed : 0.f;
+  return CVI_TDL_SUCCESS;
+}
+}  // namespace cvitdl
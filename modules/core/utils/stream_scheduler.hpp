@@ -0,0 +1,77 @@
+#pragma once
+#include <stdint.h>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "core/core/cvtdl_core_types.h"
+
+namespace cvitdl {
+
+/*
+ * Runs the frames of many streams on a pool of workers, each owning a model instance. A stream
+ * has at most one frame in flight, so its results come in submit order, and the workers take
+ * the frames of different streams: while one worker waits for the TPU, another one preprocesses
+ * or parses. The next frame is the oldest queued head of the idle streams, which is the earliest
+ * deadline since every stream has the same one. Frames past the deadline are dropped when a
+ * worker looks for work, the oldest frame of a full queue is dropped on submit.
+ */
+class StreamScheduler {
+ public:
+  /* runs the model and delivers the result, returns the inference status */
+  typedef std::function<int(uint32_t worker, uint32_t stream, VIDEO_FRAME_INFO_S *frame)> RunFunc;
+  /* gives back a frame that will not be run */
+  typedef std::function<void(uint32_t stream, VIDEO_FRAME_INFO_S *frame)> DropFunc;
+
+  StreamScheduler(const cvtdl_stream_sched_config_t &config, RunFunc run, DropFunc drop);
+  StreamScheduler(const StreamScheduler &) = delete;
+  StreamScheduler &operator=(const StreamScheduler &) = delete;
+  /* drops the queued frames and waits for the ones in flight */
+  ~StreamScheduler();
+
+  int submit(uint32_t stream, VIDEO_FRAME_INFO_S *frame);
+  /* waits until every submitted frame is run or dropped */
+  void flush();
+  int getStats(uint32_t stream, cvtdl_stream_stats_t *stats);
+
+ private:
+  struct Pending {
+    VIDEO_FRAME_INFO_S *frame;
+    uint64_t submit_us;
+  };
+  struct Dropped {
+    uint32_t stream;
+    VIDEO_FRAME_INFO_S *frame;
+  };
+  // ring of queue_depth frames, allocated once
+  struct Stream {
+    std::vector<Pending> ring;
+    uint32_t head = 0;
+    uint32_t count = 0;
+    bool busy = false;
+    cvtdl_stream_stats_t stats = {};
+    double latency_sum_ms = 0;
+  };
+
+  void workerLoop(uint32_t worker);
+  /* returns the stream to run next or -1, moves the expired frames to *expired */
+  int pickStream(uint64_t now_us, std::vector<Dropped> *expired);
+  Pending popFront(Stream &s);
+  void dropAll(const std::vector<Dropped> &dropped);
+
+  const cvtdl_stream_sched_config_t m_config;
+  RunFunc m_run;
+  DropFunc m_drop;
+  std::vector<Stream> m_streams;
+  std::vector<std::thread> m_workers;
+  std::mutex m_mutex;
+  std::condition_variable m_work_cond;
+  std::condition_variable m_idle_cond;
+  uint32_t m_queued = 0;
+  uint32_t m_in_flight = 0;
+  // drop callbacks running outside the lock, flush waits for them too
+  uint32_t m_dropping = 0;
+  bool m_stop = false;
+};
+}  // namespace cvitdl
@@ -0,0 +1,153 @@
+#include "trace.hpp"
+#include <pthread.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include <mutex>
+#include <vector>
+#include "core/core/cvtdl_errno.h"
+#include "cvi_tdl_log.hpp"
+
+#define TRACE_BUFFER_SIZE 2048  // spans per thread, power of two
+
+namespace cvitdl {
+namespace trace {
+
+std::atomic<bool> g_enabled{false};
+
+namespace {
+// seq is 2 * index + 1 while the span of that index is written and 2 * index + 2 once it is
+// complete, an export racing the writer keeps only the spans whose seq did not move while read
+struct Event {
+  std::atomic<uint64_t> seq{0};
+  std::atomic<const char *> name{nullptr};
+  std::atomic<const char *> category{nullptr};
+  std::atomic<uint64_t> begin{0};
+  std::atomic<uint64_t> end{0};
+};
+
+struct Span {
+  const char *name;
+  const char *category;
+  uint64_t begin;
+  uint64_t end;
+};
+
+struct Buffer {
+  Event events[TRACE_BUFFER_SIZE];
+  std::atomic<uint64_t> head{0};
+  long tid = 0;
+  char thread_name[16] = {0};
+};
+
+// buffers of exited threads are kept, their spans are still part of the timeline
+std::mutex g_mutex;
+std::vector<Buffer *> g_buffers;
+std::atomic<uint64_t> g_enable_us{0};
+thread_local Buffer *t_buffer = nullptr;
+
+Buffer *threadBuffer() {
+  if (t_buffer == nullptr) {
+    Buffer *buf = new Buffer;
+    buf->tid = syscall(SYS_gettid);
+    pthread_getname_np(pthread_self(), buf->thread_name, sizeof(buf->thread_name));
+    std::lock_guard<std::mutex> lock(g_mutex);
+    g_buffers.push_back(buf);
+    t_buffer = buf;
+  }
+  return t_buffer;
+}
+
+void writeString(FILE *fp, const char *s) {
+  fputc('"', fp);
+  for (; s != nullptr && *s != '\0'; s++) {
+    if (*s == '"' || *s == '\\') fputc('\\', fp);
+    if ((unsigned char)*s >= 0x20) fputc(*s, fp);
+  }
+  fputc('"', fp);
+}
+}  // namespace
+
+uint64_t now_us() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void enable(bool on) {
+  if (on) g_enable_us.store(now_us());
+  g_enabled.store(on);
+}
+
+void record(const char *name, const char *category, uint64_t begin_us, uint64_t end_us) {
+  Buffer *buf = threadBuffer();
+  uint64_t i = buf->head.load(std::memory_order_relaxed);
+  Event &e = buf->events[i & (TRACE_BUFFER_SIZE - 1)];
+  e.seq.store(2 * i + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  e.name.store(name, std::memory_order_relaxed);
+  e.category.store(category, std::memory_order_relaxed);
+  e.begin.store(begin_us, std::memory_order_relaxed);
+  e.end.store(end_us, std::memory_order_relaxed);
+  e.seq.store(2 * i + 2, std::memory_order_release);
+  buf->head.store(i + 1, std::memory_order_release);
+}
+
+int exportJson(const char *filepath) {
+  FILE *fp = fopen(filepath, "w");
+  if (fp == nullptr) {
+    LOGE("failed to open trace file %s\n", filepath);
+    return CVI_TDL_FAILURE;
+  }
+  std::vector<Buffer *> buffers;
+  {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    buffers = g_buffers;
+  }
+  const uint64_t since = g_enable_us.load();
+  const int pid = getpid();
+  std::vector<Span> copy(TRACE_BUFFER_SIZE);
+  bool first = true;
+  fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  for (Buffer *buf : buffers) {
+    fprintf(fp, "%s\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%ld,",
+            first ? "" : ",", pid, buf->tid);
+    fprintf(fp, "\"args\":{\"name\":");
+    writeString(fp, buf->thread_name[0] != '\0' ? buf->thread_name : "thread");
+    fprintf(fp, "}}");
+    first = false;
+
+    uint64_t head = buf->head.load(std::memory_order_acquire);
+    uint64_t start = head > TRACE_BUFFER_SIZE ? head - TRACE_BUFFER_SIZE : 0;
+    size_t num = 0;
+    for (uint64_t i = start; i < head; i++) {
+      const Event &e = buf->events[i & (TRACE_BUFFER_SIZE - 1)];
+      uint64_t seq = e.seq.load(std::memory_order_acquire);
+      Span span = {e.name.load(std::memory_order_relaxed),
+                   e.category.load(std::memory_order_relaxed),
+                   e.begin.load(std::memory_order_relaxed), e.end.load(std::memory_order_relaxed)};
+      // skip the slots the writer reused or is rewriting while they were copied
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (seq != 2 * i + 2 || e.seq.load(std::memory_order_relaxed) != seq) continue;
+      copy[num++] = span;
+    }
+    for (size_t k = 0; k < num; k++) {
+      const Span &c = copy[k];
+      if (c.begin < since) continue;
+      fprintf(fp, ",\n{\"ph\":\"X\",\"name\":");
+      writeString(fp, c.name);
+      fprintf(fp, ",\"cat\":");
+      writeString(fp, c.category);
+      fprintf(fp, ",\"ts\":%llu,\"dur\":%llu,\"pid\":%d,\"tid\":%ld}",
+              (unsigned long long)c.begin, (unsigned long long)(c.end - c.begin), pid, buf->tid);
+    }
+  }
+  fprintf(fp, "\n]}\n");
+  int ret = ferror(fp) ? CVI_TDL_FAILURE : CVI_TDL_SUCCESS;
+  fclose(fp);
+  return ret;
+}
+
+}  // namespace trace
+}  // namespace cvitdl
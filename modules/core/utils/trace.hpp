@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+namespace cvitdl {
+
+/*
+ * Timeline of the spans of every thread, exported as Chrome trace events (chrome://tracing,
+ * ui.perfetto.dev). Each thread writes to its own ring buffer without locks, the oldest spans are
+ * overwritten once TRACE_BUFFER_SIZE is reached. Names and categories are not copied, they must
+ * be string literals or outlive the export. A disabled tracer costs one relaxed load per span.
+ */
+namespace trace {
+
+extern std::atomic<bool> g_enabled;
+
+inline bool enabled() { return g_enabled.load(std::memory_order_relaxed); }
+
+uint64_t now_us();
+void enable(bool on);
+void record(const char *name, const char *category, uint64_t begin_us, uint64_t end_us);
+int exportJson(const char *filepath);
+
+}  // namespace trace
+
+class TraceScope {
+ public:
+  TraceScope(const char *name, const char *category)
+      : m_name(name), m_category(category), m_begin(trace::enabled() ? trace::now_us() : 0) {}
+  ~TraceScope() {
+    if (m_begin != 0) trace::record(m_name, m_category, m_begin, trace::now_us());
+  }
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+ private:
+  const char *m_name;
+  const char *m_category;
+  uint64_t m_begin;
+};
+}  // namespace cvitdl
@@ -180,8 +180,7 @@ CVI_S32 CVI_TDL_Eval_LfwInsertFace(cvitdl_eval_handle_t handle, const int index,
   if (ctx->lfw_eval == nullptr) {
     return CVI_TDL_FAILURE;
   }
-  ctx->lfw_eval->insertFaceData(index, label, face1, face2);
-  return CVI_TDL_SUCCESS;
+  return ctx->lfw_eval->insertFaceData(index, label, face1, face2);
 }
 
 CVI_S32 CVI_TDL_Eval_LfwInsertLabelScore(cvitdl_eval_handle_t handle, const int index,
@@ -203,6 +202,14 @@ CVI_S32 CVI_TDL_Eval_LfwSave2File(cvitdl_eval_handle_t handle, const char *filep
   return CVI_TDL_SUCCESS;
 }
 
+CVI_S32 CVI_TDL_Eval_LfwSaveFeatures(cvitdl_eval_handle_t handle, const char *filepath) {
+  cvitdl_eval_context_t *ctx = static_cast<cvitdl_eval_context_t *>(handle);
+  if (ctx->lfw_eval == nullptr) {
+    return CVI_TDL_FAILURE;
+  }
+  return ctx->lfw_eval->saveFeatures(filepath);
+}
+
 CVI_S32 CVI_TDL_Eval_LfwClearInput(cvitdl_eval_handle_t handle) {
   cvitdl_eval_context_t *ctx = static_cast<cvitdl_eval_context_t *>(handle);
   if (ctx->lfw_eval == nullptr) {
@@ -324,6 +331,15 @@ CVI_S32 CVI_TDL_Eval_Market1501InsertFeature(cvitdl_eval_handle_t handle, const
   return CVI_TDL_SUCCESS;
 }
 
+CVI_S32 CVI_TDL_Eval_Market1501SaveFeatures(cvitdl_eval_handle_t handle, const char *query_path,
+                                             const char *gallery_path) {
+  cvitdl_eval_context_t *ctx = static_cast<cvitdl_eval_context_t *>(handle);
+  if (ctx->market1501_eval == nullptr) {
+    return CVI_TDL_FAILURE;
+  }
+  return ctx->market1501_eval->saveFeatures(query_path, gallery_path);
+}
+
 CVI_S32 CVI_TDL_Eval_Market1501EvalCMC(cvitdl_eval_handle_t handle) {
   cvitdl_eval_context_t *ctx = static_cast<cvitdl_eval_context_t *>(handle);
   if (ctx->market1501_eval == nullptr) {
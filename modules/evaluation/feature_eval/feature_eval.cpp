@@ -0,0 +1,306 @@
+#include "feature_eval.hpp"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include "core/core/cvtdl_errno.h"
+#include "cvi_tdl_log.hpp"
+
+#define FEATURE_FILE_MAGIC "CVFT"
+#define FEATURE_FILE_VERSION 1
+/* rows of a distance block, one query tile shares every gallery row load */
+#define QUERY_TILE 4
+#define QUERY_BLOCK 16
+#define GALLERY_BLOCK 128
+
+namespace cvitdl {
+namespace evaluation {
+
+int LoadFeatureFile(const char *filepath, FeatureSet *set) {
+  FILE *fp = fopen(filepath, "rb");
+  if (fp == NULL) {
+    LOGE("file open error: %s!\n", filepath);
+    return CVI_TDL_FAILURE;
+  }
+  char magic[4];
+  uint32_t header[3];
+  if (fread(magic, 1, 4, fp) != 4 || memcmp(magic, FEATURE_FILE_MAGIC, 4) != 0 ||
+      fread(header, sizeof(uint32_t), 3, fp) != 3 || header[0] != FEATURE_FILE_VERSION) {
+    LOGE("not a feature file: %s\n", filepath);
+    fclose(fp);
+    return CVI_TDL_FAILURE;
+  }
+  uint32_t num = header[1];
+  set->dim = header[2];
+  set->ids.resize(num);
+  set->cams.resize(num);
+  set->features.resize((size_t)num * set->dim);
+  for (uint32_t i = 0; i < num; i++) {
+    int32_t id_cam[2];
+    if (fread(id_cam, sizeof(int32_t), 2, fp) != 2 ||
+        fread(&set->features[(size_t)i * set->dim], 1, set->dim, fp) != set->dim) {
+      LOGE("truncated feature file: %s\n", filepath);
+      fclose(fp);
+      return CVI_TDL_FAILURE;
+    }
+    set->ids[i] = id_cam[0];
+    set->cams[i] = id_cam[1];
+  }
+  fclose(fp);
+  return CVI_TDL_SUCCESS;
+}
+
+int SaveFeatureFile(const char *filepath, const FeatureSet &set) {
+  FILE *fp = fopen(filepath, "wb");
+  if (fp == NULL) {
+    LOGE("file open error: %s!\n", filepath);
+    return CVI_TDL_FAILURE;
+  }
+  uint32_t header[3] = {FEATURE_FILE_VERSION, (uint32_t)set.ids.size(), set.dim};
+  fwrite(FEATURE_FILE_MAGIC, 1, 4, fp);
+  fwrite(header, sizeof(uint32_t), 3, fp);
+  for (size_t i = 0; i < set.ids.size(); i++) {
+    int32_t id_cam[2] = {set.ids[i], set.cams[i]};
+    fwrite(id_cam, sizeof(int32_t), 2, fp);
+    fwrite(&set.features[i * set.dim], 1, set.dim, fp);
+  }
+  fclose(fp);
+  return CVI_TDL_SUCCESS;
+}
+
+static int resolve_threads(int num_threads) {
+  if (num_threads > 0) return num_threads;
+  int n = (int)std::thread::hardware_concurrency();
+  return n > 0 ? n : 1;
+}
+
+/* run func(begin, end) over [0, size) in chunks of block on num_threads threads */
+template <typename Func>
+static void parallel_blocks(uint32_t size, uint32_t block, int num_threads, Func func) {
+  std::atomic<uint32_t> next(0);
+  auto worker = [&]() {
+    for (;;) {
+      uint32_t begin = next.fetch_add(block);
+      if (begin >= size) break;
+      func(begin, std::min(begin + block, size));
+    }
+  };
+  int n = std::min<int>(num_threads, (size + block - 1) / block);
+  std::vector<std::thread> threads;
+  for (int t = 1; t < n; t++) threads.emplace_back(worker);
+  worker();
+  for (auto &t : threads) t.join();
+}
+
+float CosineDistance(const int8_t *feature1, const int8_t *feature2, uint32_t dim) {
+  int32_t value1 = 0, value2 = 0, value3 = 0;
+  for (uint32_t i = 0; i < dim; i++) {
+    value1 += (int16_t)feature1[i] * feature1[i];
+    value2 += (int16_t)feature2[i] * feature2[i];
+    value3 += (int16_t)feature1[i] * feature2[i];
+  }
+  return 1 - ((float)value3 / (sqrt((double)value1) * sqrt((double)value2)));
+}
+
+/* widen the features once so the distance loops multiply 16 bit lanes directly. Norms are kept
+ * in double as in CosineDistance, so equal distances stay equal and ties rank the same. */
+static void prepare_rows(const int8_t *feat, uint32_t num, uint32_t dim, std::vector<int16_t> *rows,
+                         std::vector<double> *norm) {
+  rows->assign(feat, feat + (size_t)num * dim);
+  norm->resize(num);
+  for (uint32_t i = 0; i < num; i++) {
+    const int16_t *f = rows->data() + (size_t)i * dim;
+    int32_t sum = 0;
+    for (uint32_t k = 0; k < dim; k++) sum += f[k] * f[k];
+    (*norm)[i] = sqrt((double)sum);
+  }
+}
+
+/* distances of query rows [q0, q1) against all gallery rows, dist rows are relative to q0 */
+static void distance_block(const int16_t *query, uint32_t q0, uint32_t q1, const int16_t *gallery,
+                           uint32_t ng, uint32_t dim, const double *q_norm, const double *g_norm,
+                           float *dist) {
+  for (uint32_t g0 = 0; g0 < ng; g0 += GALLERY_BLOCK) {
+    const uint32_t g1 = std::min(g0 + GALLERY_BLOCK, ng);
+    for (uint32_t q = q0; q < q1; q += QUERY_TILE) {
+      const uint32_t nt = std::min<uint32_t>(QUERY_TILE, q1 - q);
+      const int16_t *qf[QUERY_TILE];
+      for (uint32_t t = 0; t < QUERY_TILE; t++) {
+        qf[t] = query + (size_t)(q + std::min(t, nt - 1)) * dim;
+      }
+      for (uint32_t g = g0; g < g1; g++) {
+        const int16_t *gf = gallery + (size_t)g * dim;
+        int32_t acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+        /* 16 bit multiply-add into 32 bit, vectorized by the compiler */
+        for (uint32_t k = 0; k < dim; k++) {
+          const int16_t v = gf[k];
+          acc0 += v * qf[0][k];
+          acc1 += v * qf[1][k];
+          acc2 += v * qf[2][k];
+          acc3 += v * qf[3][k];
+        }
+        const int32_t acc[QUERY_TILE] = {acc0, acc1, acc2, acc3};
+        for (uint32_t t = 0; t < nt; t++) {
+          /* the CosineDistance expression, only the per pair division is left */
+          double denom = q_norm[q + t] * g_norm[g];
+          dist[(size_t)(q + t - q0) * ng + g] = 1 - (denom > 0 ? (float)acc[t] / denom : 0);
+        }
+      }
+    }
+  }
+}
+
+void CosineDistanceMatrix(const int8_t *query, uint32_t nq, const int8_t *gallery, uint32_t ng,
+                          uint32_t dim, float *dist, int num_threads) {
+  std::vector<int16_t> q_rows, g_rows;
+  std::vector<double> q_norm, g_norm;
+  prepare_rows(query, nq, dim, &q_rows, &q_norm);
+  prepare_rows(gallery, ng, dim, &g_rows, &g_norm);
+  parallel_blocks(nq, QUERY_BLOCK, resolve_threads(num_threads), [&](uint32_t q0, uint32_t q1) {
+    distance_block(q_rows.data(), q0, q1, g_rows.data(), ng, dim, q_norm.data(), g_norm.data(),
+                   dist + (size_t)q0 * ng);
+  });
+}
+
+typedef struct {
+  bool valid;
+  uint32_t first_match;  // 1-based rank of the first match
+  double ap;
+} query_stat_t;
+
+/*
+ * Rank of every match without sorting the gallery: the rank of the k-th match (in (dist, index)
+ * order) is k + 1 plus the number of valid non-matching images ordered before it, which only
+ * needs a binary search among the few matches per gallery image.
+ */
+static void rank_query(const float *dist, const FeatureSet &query, uint32_t qi,
+                       const FeatureSet &gallery, std::vector<std::pair<float, uint32_t>> &matches,
+                       std::vector<uint32_t> &hist, query_stat_t *stat) {
+  const int32_t pid = query.ids[qi];
+  const int32_t cam = query.cams[qi];
+  const uint32_t ng = gallery.ids.size();
+  matches.clear();
+  bool has_cross_cam = false;
+  for (uint32_t j = 0; j < ng; j++) {
+    if (gallery.ids[j] != pid) continue;
+    if (gallery.cams[j] == cam) continue;
+    has_cross_cam = true;
+    matches.emplace_back(dist[j], j);
+  }
+  stat->valid = has_cross_cam;
+  if (!has_cross_cam) return;
+
+  std::sort(matches.begin(), matches.end());
+  hist.assign(matches.size() + 1, 0);
+  for (uint32_t j = 0; j < ng; j++) {
+    if (gallery.ids[j] == pid) continue;
+    auto it = std::lower_bound(matches.begin(), matches.end(), std::make_pair(dist[j], j));
+    hist[it - matches.begin()]++;
+  }
+  uint32_t before = 0;
+  double ap = 0;
+  for (size_t k = 0; k < matches.size(); k++) {
+    before += hist[k];
+    uint32_t rank = k + 1 + before;
+    if (k == 0) stat->first_match = rank;
+    ap += (double)(k + 1) / rank;
+  }
+  stat->ap = ap / matches.size();
+}
+
+void EvalRanking(const FeatureSet &query, const FeatureSet &gallery, uint32_t max_rank,
+                 RankingResult *result, int num_threads) {
+  const uint32_t nq = query.ids.size();
+  const uint32_t ng = gallery.ids.size();
+  const uint32_t dim = query.dim;
+  result->cmc.assign(max_rank, 0);
+  result->mAP = 0;
+  result->num_valid_query = 0;
+  if (nq == 0 || ng == 0 || dim != gallery.dim) {
+    LOGE("invalid feature sets, query:%u, gallery:%u, dim:%u vs %u\n", nq, ng, dim, gallery.dim);
+    return;
+  }
+
+  std::vector<int16_t> q_rows, g_rows;
+  std::vector<double> q_norm, g_norm;
+  prepare_rows(query.features.data(), nq, dim, &q_rows, &q_norm);
+  prepare_rows(gallery.features.data(), ng, dim, &g_rows, &g_norm);
+
+  std::vector<query_stat_t> stats(nq);
+  parallel_blocks(nq, QUERY_BLOCK, resolve_threads(num_threads), [&](uint32_t q0, uint32_t q1) {
+    std::vector<float> dist((size_t)(q1 - q0) * ng);
+    std::vector<std::pair<float, uint32_t>> matches;
+    std::vector<uint32_t> hist;
+    distance_block(q_rows.data(), q0, q1, g_rows.data(), ng, dim, q_norm.data(), g_norm.data(),
+                   dist.data());
+    for (uint32_t q = q0; q < q1; q++) {
+      rank_query(&dist[(size_t)(q - q0) * ng], query, q, gallery, matches, hist, &stats[q]);
+    }
+  });
+
+  double all_ap = 0;
+  for (uint32_t q = 0; q < nq; q++) {
+    if (!stats[q].valid) continue;
+    result->num_valid_query++;
+    all_ap += stats[q].ap;
+    for (uint32_t r = stats[q].first_match - 1; r < max_rank; r++) result->cmc[r]++;
+  }
+  if (result->num_valid_query == 0) return;
+  for (uint32_t r = 0; r < max_rank; r++) result->cmc[r] /= result->num_valid_query;
+  result->mAP = all_ap / result->num_valid_query;
+}
+
+void EvalROC(const int *labels, const float *scores, uint32_t size, std::vector<RocPoint> *curve,
+             RocResult *result) {
+  std::vector<uint32_t> order(size);
+  uint32_t pos = 0, neg = 0;
+  for (uint32_t i = 0; i < size; i++) {
+    order[i] = i;
+    if (labels[i] == 1) pos++;
+    if (labels[i] == 0) neg++;
+  }
+  std::sort(order.begin(), order.end(),
+            [&](uint32_t a, uint32_t b) { return scores[a] > scores[b]; });
+
+  if (curve) curve->clear();
+  *result = RocResult();
+  /* threshold above every score: everything predicted negative */
+  result->best_accuracy = size > 0 ? (float)(size - pos) / size : 0;
+  result->best_thr = size > 0 ? nextafterf(scores[order[0]], INFINITY) : 0;
+  uint32_t tp = 0, fp = 0;
+  float prev_tpr = 0, prev_fpr = 0;
+  double auc = 0;
+  for (uint32_t i = 0; i < size;) {
+    /* all equal scores pass the same threshold */
+    const float thr = scores[order[i]];
+    uint32_t end = i;
+    for (; end < size && scores[order[end]] == thr; end++) {
+      if (labels[order[end]] == 1) {
+        tp++;
+      } else {
+        fp++;
+      }
+    }
+    float tpr = pos > 0 ? (float)tp / pos : 0;
+    float fpr = neg > 0 ? (float)fp / neg : 0;
+    if (curve) {
+      for (uint32_t k = i; k < end; k++) curve->push_back({thr, tpr, fpr});
+    }
+    auc += (fpr - prev_fpr) * (tpr + prev_tpr) / 2;
+    prev_tpr = tpr;
+    prev_fpr = fpr;
+    float accuracy = (float)(tp + (size - pos) - fp) / size;
+    if (accuracy > result->best_accuracy) {
+      result->best_accuracy = accuracy;
+      result->best_thr = thr;
+    }
+    i = end;
+  }
+  result->auc = auc;
+}
+
+}  // namespace evaluation
+}  // namespace cvitdl
@@ -0,0 +1,60 @@
+#pragma once
+#include <stdint.h>
+
+#include <vector>
+
+/* Evaluation core shared by the dataset evaluators. It only works on plain feature arrays so it
+ * can also run on a host with feature files dumped on the board. */
+
+namespace cvitdl {
+namespace evaluation {
+
+/* feature file layout: "CVFT", uint32 version, uint32 num, uint32 dim, then num records of
+ * {int32 id, int32 cam, int8 feature[dim]} */
+typedef struct {
+  uint32_t dim = 0;
+  std::vector<int32_t> ids;
+  std::vector<int32_t> cams;
+  std::vector<int8_t> features;  // num x dim
+} FeatureSet;
+
+int LoadFeatureFile(const char *filepath, FeatureSet *set);
+int SaveFeatureFile(const char *filepath, const FeatureSet &set);
+
+float CosineDistance(const int8_t *feature1, const int8_t *feature2, uint32_t dim);
+
+/* cosine distance matrix between all rows of query (nq x dim) and gallery (ng x dim), nq x ng */
+void CosineDistanceMatrix(const int8_t *query, uint32_t nq, const int8_t *gallery, uint32_t ng,
+                          uint32_t dim, float *dist, int num_threads = 0);
+
+typedef struct {
+  std::vector<float> cmc;  // cmc[r]: ratio of valid queries with a match within rank r + 1
+  float mAP = 0;
+  uint32_t num_valid_query = 0;
+} RankingResult;
+
+/* Market1501 protocol: gallery images of the query id taken by the query camera are ignored,
+ * queries without a match from another camera are skipped. Ties are ranked by gallery index. */
+void EvalRanking(const FeatureSet &query, const FeatureSet &gallery, uint32_t max_rank,
+                 RankingResult *result, int num_threads = 0);
+
+typedef struct {
+  float thr;
+  float tpr;
+  float fpr;
+} RocPoint;
+
+typedef struct {
+  float auc = 0;
+  float best_accuracy = 0;
+  float best_thr = 0;
+} RocResult;
+
+/* score >= thr is predicted positive (label 1), every score is used as a threshold once. The
+ * curve is sorted by descending threshold. As in the previous LFW loop, any label other than 1
+ * passing the threshold is a false positive while the FPR is taken over the label 0 pairs. */
+void EvalROC(const int *labels, const float *scores, uint32_t size, std::vector<RocPoint> *curve,
+             RocResult *result);
+
+}  // namespace evaluation
+}  // namespace cvitdl
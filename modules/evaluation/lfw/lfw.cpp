@@ -8,10 +8,6 @@
 #include <string.h>
 #include "cvi_comm.h"
 
-static int compare(const void *arg1, const void *arg2) {
-  return static_cast<int>(*(float *)arg1 < *(float *)arg2);
-}
-
 namespace cvitdl {
 namespace evaluation {
 
@@ -26,6 +22,7 @@ int lfwEval::getEvalData(const char *fiilepath, bool label_pos_first) {
   m_data.clear();
   m_eval_label.clear();
   m_eval_score.clear();
+  m_features = FeatureSet();
   char line[1024];
   while (fscanf(fp, "%[^\n]", line) != EOF) {
     fgetc(fp);
@@ -55,17 +52,43 @@ void lfwEval::getImageLabelPair(const int index, std::string *path1, std::string
   *label = m_data[index].label;
 }
 
-void lfwEval::insertFaceData(const int index, const int label, const cvtdl_face_t *face1,
-                             const cvtdl_face_t *face2) {
+int lfwEval::insertFaceData(const int index, const int label, const cvtdl_face_t *face1,
+                            const cvtdl_face_t *face2) {
+  if (index < 0 || (size_t)index >= m_eval_label.size()) {
+    LOGE("pair index %d out of range [0, %zu)\n", index, m_eval_label.size());
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  if (face1->size == 0 || face2->size == 0) {
+    LOGE("pair %d has no face\n", index);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
   int face_idx1 = getMaxFace(face1);
   int face_idx2 = getMaxFace(face2);
 
-  float feature_diff =
-      evalDifference(&face1->info[face_idx1].feature, &face2->info[face_idx2].feature);
+  const cvtdl_feature_t &feature1 = face1->info[face_idx1].feature;
+  const cvtdl_feature_t &feature2 = face2->info[face_idx2].feature;
+  float feature_diff = evalDifference(&feature1, &feature2);
   float score = 1.0 - (0.5 * feature_diff);
 
+  /* keep the pair for offline evaluation, records 2 * index and 2 * index + 1 */
+  if (m_features.dim == 0) {
+    m_features.dim = feature1.size;
+    m_features.ids.assign(m_data.size() * 2, -1);
+    m_features.cams.assign(m_data.size() * 2, 0);
+    m_features.features.assign(m_data.size() * 2 * m_features.dim, 0);
+  }
+  if (feature1.size == m_features.dim && feature2.size == m_features.dim) {
+    for (int k = 0; k < 2; k++) {
+      const cvtdl_feature_t &feature = k == 0 ? feature1 : feature2;
+      m_features.ids[2 * index + k] = label;
+      m_features.cams[2 * index + k] = k;
+      memcpy(&m_features.features[(2 * index + k) * m_features.dim], feature.ptr, feature.size);
+    }
+  }
+
   m_eval_label[index] = label;
   m_eval_score[index] = score;
+  return CVI_TDL_SUCCESS;
 }
 
 void lfwEval::insertLabelScore(const int &index, const int &label, const float &score) {
@@ -76,6 +99,7 @@ void lfwEval::insertLabelScore(const int &index, const int &label, const float &
 void lfwEval::resetData() { m_data.clear(); }
 
 void lfwEval::resetEvalData() {
+  m_features = FeatureSet();
   m_eval_label.clear();
   m_eval_score.clear();
   m_eval_label.resize(m_data.size());
@@ -112,55 +136,35 @@ int lfwEval::getMaxFace(const cvtdl_face_t *face) {
 }
 
 float lfwEval::evalDifference(const cvtdl_feature_t *features1, const cvtdl_feature_t *features2) {
-  int32_t value1 = 0, value2 = 0, value3 = 0;
-  for (uint32_t i = 0; i < features1->size; i++) {
-    value1 += (short)features1->ptr[i] * features1->ptr[i];
-    value2 += (short)features2->ptr[i] * features2->ptr[i];
-    value3 += (short)features1->ptr[i] * features2->ptr[i];
-  }
+  return CosineDistance(features1->ptr, features2->ptr, features1->size);
+}
 
-  return 1 - ((float)value3 / (sqrt((double)value1) * sqrt((double)value2)));
+int lfwEval::saveFeatures(const char *filepath) {
+  if (m_features.dim == 0) {
+    LOGE("no face feature inserted\n");
+    return CVI_TDL_FAILURE;
+  }
+  return SaveFeatureFile(filepath, m_features);
 }
 
 void lfwEval::evalAUC(const std::vector<int> &y, std::vector<float> &pred, const uint32_t data_size,
                       const char *filepath) {
-  int pos = 0;
-  int neg = 0;
-  float pred_sort[data_size];
-  for (uint32_t i = 0; i < data_size; i++) {
-    if (y[i] == 1) pos++;
-    if (y[i] == 0) neg++;
-    pred_sort[i] = pred[i];
-  }
-
-  qsort((void *)pred_sort, data_size, sizeof(float), compare);
+  std::vector<RocPoint> curve;
+  RocResult result;
+  EvalROC(y.data(), pred.data(), data_size, &curve, &result);
 
   FILE *fp;
   if ((fp = fopen(filepath, "w")) == NULL) {
     LOGE("LFW result file open error!");
     return;
   }
-
-  for (uint32_t i = 0; i < data_size; i++) {
-    float thr = pred_sort[i];
-
-    uint32_t tpn = 0, fpn = 0;
-    for (uint32_t j = 0; j < data_size; j++) {
-      if (pred[j] >= thr) {
-        if (y[j] == 1) {
-          tpn++;
-        } else {
-          fpn++;
-        }
-      }
-    }
-
-    float tpr = (float)tpn / pos;
-    float fpr = (float)fpn / neg;
-    fprintf(fp, "thr: %f, tpr: %f, fpr: %f\n", thr, tpr, fpr);
+  for (const RocPoint &p : curve) {
+    fprintf(fp, "thr: %f, tpr: %f, fpr: %f\n", p.thr, p.tpr, p.fpr);
   }
-
   fclose(fp);
+
+  printf("AUC: %f, best accuracy: %f (thr: %f)\n", result.auc, result.best_accuracy,
+         result.best_thr);
 }
 }  // namespace evaluation
 }  // namespace cvitdl
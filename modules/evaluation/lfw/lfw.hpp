@@ -1,4 +1,5 @@
 #pragma once
+#include "../feature_eval/feature_eval.hpp"
 #include "core/face/cvtdl_face_types.h"
 
 #include <string>
@@ -18,12 +19,13 @@ class lfwEval {
   int getEvalData(const char *fiilepath, bool label_pos_first);
   uint32_t getTotalImage();
   void getImageLabelPair(const int index, std::string *path1, std::string *path2, int *label);
-  void insertFaceData(const int index, const int label, const cvtdl_face_t *face1,
-                      const cvtdl_face_t *face2);
+  int insertFaceData(const int index, const int label, const cvtdl_face_t *face1,
+                     const cvtdl_face_t *face2);
   void insertLabelScore(const int &index, const int &label, const float &score);
   void resetData();
   void resetEvalData();
   void saveEval2File(const char *filepath);
+  int saveFeatures(const char *filepath);
 
  private:
   int getMaxFace(const cvtdl_face_t *face);
@@ -33,6 +35,7 @@ class lfwEval {
   std::vector<lfwpair> m_data;
   std::vector<int> m_eval_label;
   std::vector<float> m_eval_score;
+  FeatureSet m_features;
 };
 }  // namespace evaluation
 }  // namespace cvitdl
\ No newline at end of file
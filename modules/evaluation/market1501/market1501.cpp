@@ -13,22 +13,12 @@
 #include "core/cvi_tdl_core.h"
 #include "core/cvi_tdl_types_mem_internal.h"
 #include "cvi_comm.h"
+#include "cvi_tdl_log.hpp"
 
 #define GALLERY_DIR "/bounding_box_test/"
 #define QUERY_DIR "/query/"
 #define MAX_RANK 50
 
-static float cosine_distance(const cvtdl_feature_t *features1, const cvtdl_feature_t *features2) {
-  int32_t value1 = 0, value2 = 0, value3 = 0;
-  for (uint32_t i = 0; i < features1->size; i++) {
-    value1 += (short)features1->ptr[i] * features1->ptr[i];
-    value2 += (short)features2->ptr[i] * features2->ptr[i];
-    value3 += (short)features1->ptr[i] * features2->ptr[i];
-  }
-
-  return 1 - ((float)value3 / (sqrt((double)value1) * sqrt((double)value2)));
-}
-
 namespace cvitdl {
 namespace evaluation {
 
@@ -123,67 +113,51 @@ void market1501Eval::resetData() {
   m_gallerys.clear();
 }
 
-void market1501Eval::evalCMC() {
-  std::vector<float> all_cmc(MAX_RANK, 0);
-  float all_ap = 0;
-  int num_valid_q = 0;
-
-  for (uint32_t i = 0; i < m_querys.size(); i++) {
-    market_info q_info = m_querys[i];
-    std::vector<std::pair<float, int>> dist_mat;
-
-    int sum_of_elems = 0;
-    for (uint32_t j = 0; j < m_gallerys.size(); j++) {
-      if ((q_info.pid == m_gallerys[j].pid) && (q_info.cam_id != m_gallerys[j].cam_id)) {
-        sum_of_elems = 1;
-        break;
-      }
-    }
-    if (sum_of_elems == 0) continue;
-
-    for (uint32_t j = 0; j < m_gallerys.size(); j++) {
-      if ((q_info.pid == m_gallerys[j].pid) && (q_info.cam_id == m_gallerys[j].cam_id)) {
-        continue;
-      }
-      dist_mat.push_back(
-          std::make_pair(cosine_distance(&q_info.feature, &m_gallerys[j].feature), j));
-    }
-
-    std::sort(dist_mat.begin(), dist_mat.end());
-
-    std::vector<int> raw_cmc(dist_mat.size(), 0);
-    for (uint32_t j = 0; j < raw_cmc.size(); j++) {
-      if (q_info.pid == m_gallerys[dist_mat[j].second].pid) {
-        raw_cmc[j] = 1;
-      }
-    }
-
-    num_valid_q++;
-
-    int cum_sum = 0;
-    for (uint32_t j = 0; j < MAX_RANK; j++) {
-      cum_sum += raw_cmc[j];
-      if (cum_sum >= 1) all_cmc[j]++;
-    }
-
-    int num_rel = 0;
-    float ap = 0;
-    for (uint32_t j = 0; j < raw_cmc.size(); j++) {
-      num_rel += raw_cmc[j];
-      ap += ((float)num_rel / (j + 1)) * raw_cmc[j];
+void market1501Eval::toFeatureSet(const std::vector<market_info> &infos, FeatureSet *set) {
+  set->dim = 0;
+  for (const auto &info : infos) {
+    set->dim = std::max(set->dim, info.feature.size);
+  }
+  set->ids.resize(infos.size());
+  set->cams.resize(infos.size());
+  set->features.assign(infos.size() * set->dim, 0);
+  for (size_t i = 0; i < infos.size(); i++) {
+    set->ids[i] = infos[i].pid;
+    set->cams[i] = infos[i].cam_id;
+    if (infos[i].feature.ptr == NULL) {
+      LOGW("feature of %s is not inserted\n", infos[i].img_path.c_str());
+      continue;
     }
+    memcpy(&set->features[i * set->dim], infos[i].feature.ptr, infos[i].feature.size);
+  }
+}
 
-    ap = ap / num_rel;
-    all_ap += ap;
+int market1501Eval::saveFeatures(const char *query_path, const char *gallery_path) {
+  FeatureSet query, gallery;
+  toFeatureSet(m_querys, &query);
+  toFeatureSet(m_gallerys, &gallery);
+  if (SaveFeatureFile(query_path, query) != CVI_TDL_SUCCESS ||
+      SaveFeatureFile(gallery_path, gallery) != CVI_TDL_SUCCESS) {
+    return CVI_TDL_FAILURE;
   }
+  return CVI_TDL_SUCCESS;
+}
 
-  for (uint32_t i = 0; i < MAX_RANK; i++) {
-    all_cmc[i] = all_cmc[i] / num_valid_q;
+void market1501Eval::evalCMC() {
+  FeatureSet query, gallery;
+  toFeatureSet(m_querys, &query);
+  toFeatureSet(m_gallerys, &gallery);
+
+  RankingResult result;
+  EvalRanking(query, gallery, MAX_RANK, &result);
+  if (result.num_valid_query == 0) {
+    LOGE("no valid query\n");
+    return;
   }
 
-  printf("Rank [1]:%f, [5]:%f, [10]:%f, [20]:%f\n", all_cmc[0], all_cmc[4], all_cmc[9],
-         all_cmc[19]);
-  printf("mAP: %f\n", all_ap / num_valid_q);
+  printf("Rank [1]:%f, [5]:%f, [10]:%f, [20]:%f\n", result.cmc[0], result.cmc[4], result.cmc[9],
+         result.cmc[19]);
+  printf("mAP: %f\n", result.mAP);
 }
 }  // namespace evaluation
 }  // namespace cvitdl
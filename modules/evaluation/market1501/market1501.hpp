@@ -1,5 +1,6 @@
 #pragma once
 #include "core/face/cvtdl_face_types.h"
+#include "../feature_eval/feature_eval.hpp"
 
 #include <string>
 #include <vector>
@@ -22,9 +23,11 @@ class market1501Eval {
   void getPathIdPair(const int index, bool is_query, std::string *path, int *cam_id, int *pid);
   void insertFeature(const int index, bool is_query, const cvtdl_feature_t *feature);
   void evalCMC();
+  int saveFeatures(const char *query_path, const char *gallery_path);
   void resetData();
 
  private:
+  void toFeatureSet(const std::vector<market_info> &infos, FeatureSet *set);
   std::vector<market_info> m_querys;
   std::vector<market_info> m_gallerys;
 };
@@ -13,6 +13,7 @@
 
 #define MIN(a, b) ((a) <= (b) ? (a) : (b))
 #define MAX(a, b) ((a) >= (b) ? (a) : (b))
+#define GRID_SIZE 16
 
 namespace cvitdl {
 namespace service {
@@ -76,17 +77,9 @@ bool ConvexPolygon::set_vertices(const cvtdl_pts_t &pts) {
   return true;
 }
 
-IntrusionDetect::IntrusionDetect() {
-  base.size = 2;
-  base.x = (float *)malloc(sizeof(float) * 2);
-  base.y = (float *)malloc(sizeof(float) * 2);
-  base.x[0] = 1.;
-  base.x[1] = 0.;
-  base.y[0] = 0.;
-  base.y[1] = 1.;
-}
+IntrusionDetect::IntrusionDetect() {}
 
-IntrusionDetect::~IntrusionDetect() { CVI_TDL_FreeCpp(&base); }
+IntrusionDetect::~IntrusionDetect() {}
 
 int IntrusionDetect::setRegion(const cvtdl_pts_t &pts) {
   cvtdl_pts_t new_pts;
@@ -110,9 +103,12 @@ int IntrusionDetect::setRegion(const cvtdl_pts_t &pts) {
     return CVI_TDL_SUCCESS;
   }
 
+  index_dirty = true;
   auto new_region = std::make_shared<ConvexPolygon>();
   if (new_region->set_vertices(new_pts)) {
     regions.push_back(new_region);
+    region_zones.push_back(num_zones++);
+    CVI_TDL_FreeCpp(&new_pts);
     // this->show();
     return CVI_TDL_SUCCESS;
   }
@@ -120,6 +116,7 @@ int IntrusionDetect::setRegion(const cvtdl_pts_t &pts) {
   std::vector<std::vector<int>> convex_idxes;
   if (!ConvexPartition_HM(new_pts, convex_idxes)) {
     LOGE("ConvexPartition_HM Bug (1).\n");
+    CVI_TDL_FreeCpp(&new_pts);
     return CVI_TDL_FAILURE;
   }
 
@@ -135,11 +132,16 @@ int IntrusionDetect::setRegion(const cvtdl_pts_t &pts) {
     auto new_region = std::make_shared<ConvexPolygon>();
     if (!new_region->set_vertices(new_sub_pts)) {
       LOGE("ConvexPartition_HM Bug (2).\n");
+      /* drop the parts of this region that were already added */
+      regions.resize(region_zones.size());
+      CVI_TDL_FreeCpp(&new_sub_pts);
+      CVI_TDL_FreeCpp(&new_pts);
       return CVI_TDL_FAILURE;
     }
     regions.push_back(new_region);
     CVI_TDL_FreeCpp(&new_sub_pts);
   }
+  region_zones.resize(regions.size(), num_zones++);
   CVI_TDL_FreeCpp(&new_pts);
 
   this->show();
@@ -163,76 +165,174 @@ void IntrusionDetect::getRegion(cvtdl_pts_t ***region_info, uint32_t *size) {
   }
 }
 
-void IntrusionDetect::clean() { this->regions.clear(); }
+void IntrusionDetect::clean() {
+  this->regions.clear();
+  this->region_zones.clear();
+  this->num_zones = 0;
+  this->index_dirty = true;
+}
 
 bool IntrusionDetect::run(const cvtdl_bbox_t &bbox) {
   // printf("[RUN] BBox: (%.1f,%.1f,%.1f,%.1f)\n", bbox.x1, bbox.y1, bbox.x2, bbox.y2);
-  /* transfer coordinate system from Image to Euclidean */
-  cvtdl_bbox_t t_bbox = bbox;
-  t_bbox.y1 *= -1;
-  t_bbox.y2 *= -1;
+  if (index_dirty) build_index();
+  return query(bbox, NULL);
+}
+
+int IntrusionDetect::run(const cvtdl_object_t &obj, uint64_t *region_masks) {
+  if (obj.size > 0 && (obj.info == NULL || region_masks == NULL)) {
+    LOGE("invalid object meta or region masks\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  if (num_zones > MAX_MASK_ZONES) {
+    LOGE("region masks hold %u regions, %u are set\n", MAX_MASK_ZONES, num_zones);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  if (index_dirty) build_index();
+  for (uint32_t i = 0; i < obj.size; i++) {
+    region_masks[i] = 0;
+    query(obj.info[i].bbox, &region_masks[i]);
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+void IntrusionDetect::build_index() {
+  convex_index.clear();
+  axis_x.clear();
+  axis_y.clear();
+  axis_min.clear();
+  axis_max.clear();
+  cell_begin.clear();
+  cell_items.clear();
+  index_dirty = false;
+  if (regions.empty()) return;
+
+  float gx0 = std::numeric_limits<float>::max();
+  float gy0 = std::numeric_limits<float>::max();
+  float gx1 = -std::numeric_limits<float>::max();
+  float gy1 = -std::numeric_limits<float>::max();
   for (size_t i = 0; i < regions.size(); i++) {
-    bool separating = false;
-    for (size_t j = 0; j < regions[i]->orthogonals.size; j++) {
-      vertex_t o;
-      o.x = regions[i]->orthogonals.x[j];
-      o.y = regions[i]->orthogonals.y[j];
-      if (is_separating_axis(o, regions[i]->vertices, t_bbox)) {
-        separating = true;
-        break;
-      }
+    const cvtdl_pts_t &v = regions[i]->vertices;
+    const cvtdl_pts_t &o = regions[i]->orthogonals;
+    convex_index_t ci;
+    ci.min_x = ci.min_y = std::numeric_limits<float>::max();
+    ci.max_x = ci.max_y = -std::numeric_limits<float>::max();
+    for (uint32_t k = 0; k < v.size; k++) {
+      ci.min_x = MIN(ci.min_x, v.x[k]);
+      ci.max_x = MAX(ci.max_x, v.x[k]);
+      ci.min_y = MIN(ci.min_y, v.y[k]);
+      ci.max_y = MAX(ci.max_y, v.y[k]);
     }
-    if (separating) {
-      continue;
+    ci.zone = region_zones[i];
+    ci.axis_begin = axis_x.size();
+    for (uint32_t j = 0; j < o.size; j++) {
+      float pmin = std::numeric_limits<float>::max();
+      float pmax = -std::numeric_limits<float>::max();
+      for (uint32_t k = 0; k < v.size; k++) {
+        float proj = o.x[j] * v.x[k] + o.y[j] * v.y[k];
+        pmin = MIN(pmin, proj);
+        pmax = MAX(pmax, proj);
+      }
+      axis_x.push_back(o.x[j]);
+      axis_y.push_back(o.y[j]);
+      axis_min.push_back(pmin);
+      axis_max.push_back(pmax);
     }
-    for (size_t j = 0; j < base.size; j++) {
-      vertex_t o;
-      o.x = base.x[j];
-      o.y = base.y[j];
-      if (is_separating_axis(o, regions[i]->vertices, t_bbox)) {
-        separating = true;
-        break;
+    ci.axis_end = axis_x.size();
+    convex_index.push_back(ci);
+    gx0 = MIN(gx0, ci.min_x);
+    gx1 = MAX(gx1, ci.max_x);
+    gy0 = MIN(gy0, ci.min_y);
+    gy1 = MAX(gy1, ci.max_y);
+  }
+
+  grid_x0 = gx0;
+  grid_y0 = gy0;
+  grid_x1 = gx1;
+  grid_y1 = gy1;
+  grid_inv_w = GRID_SIZE / MAX(gx1 - gx0, 1e-3f);
+  grid_inv_h = GRID_SIZE / MAX(gy1 - gy0, 1e-3f);
+  auto cell_x = [&](float x) {
+    return MIN(MAX((int)((x - grid_x0) * grid_inv_w), 0), GRID_SIZE - 1);
+  };
+  auto cell_y = [&](float y) {
+    return MIN(MAX((int)((y - grid_y0) * grid_inv_h), 0), GRID_SIZE - 1);
+  };
+
+  /* counting pass, then fill */
+  cell_begin.assign(GRID_SIZE * GRID_SIZE + 1, 0);
+  for (const convex_index_t &ci : convex_index) {
+    for (int cy = cell_y(ci.min_y); cy <= cell_y(ci.max_y); cy++) {
+      for (int cx = cell_x(ci.min_x); cx <= cell_x(ci.max_x); cx++) {
+        cell_begin[cy * GRID_SIZE + cx + 1]++;
       }
     }
-    if (separating) {
-      continue;
-    } else {
-      return true;
+  }
+  for (int c = 0; c < GRID_SIZE * GRID_SIZE; c++) {
+    cell_begin[c + 1] += cell_begin[c];
+  }
+  cell_items.resize(cell_begin.back());
+  std::vector<uint32_t> fill(cell_begin.begin(), cell_begin.end() - 1);
+  for (uint32_t i = 0; i < convex_index.size(); i++) {
+    const convex_index_t &ci = convex_index[i];
+    for (int cy = cell_y(ci.min_y); cy <= cell_y(ci.max_y); cy++) {
+      for (int cx = cell_x(ci.min_x); cx <= cell_x(ci.max_x); cx++) {
+        cell_items[fill[cy * GRID_SIZE + cx]++] = i;
+      }
     }
   }
-  return false;
+  visit_stamp.assign(convex_index.size(), 0);
+  stamp = 0;
 }
 
-bool IntrusionDetect::is_separating_axis(const vertex_t &axis, const cvtdl_pts_t &region_pts,
-                                         const cvtdl_bbox_t &bbox) {
-  float min_1 = std::numeric_limits<float>::max();
-  float max_1 = -std::numeric_limits<float>::max();
-  float min_2 = std::numeric_limits<float>::max();
-  float max_2 = -std::numeric_limits<float>::max();
-  float proj;
-  for (uint32_t i = 0; i < region_pts.size; i++) {
-    proj = axis.x * region_pts.x[i] + axis.y * region_pts.y[i];
-    min_1 = MIN(min_1, proj);
-    max_1 = MAX(max_1, proj);
+bool IntrusionDetect::query(const cvtdl_bbox_t &bbox, uint64_t *zone_mask) {
+  if (convex_index.empty()) return false;
+  /* transfer coordinate system from Image to Euclidean */
+  float bx0 = MIN(bbox.x1, bbox.x2);
+  float bx1 = MAX(bbox.x1, bbox.x2);
+  float by0 = -MAX(bbox.y1, bbox.y2);
+  float by1 = -MIN(bbox.y1, bbox.y2);
+
+  /* the exact bounds, boxes touching the outermost edges intersect */
+  if (bx1 < grid_x0 || bx0 > grid_x1 || by1 < grid_y0 || by0 > grid_y1) return false;
+  int cx0 = MIN(MAX((int)((bx0 - grid_x0) * grid_inv_w), 0), GRID_SIZE - 1);
+  int cx1 = MIN(MAX((int)((bx1 - grid_x0) * grid_inv_w), 0), GRID_SIZE - 1);
+  int cy0 = MIN(MAX((int)((by0 - grid_y0) * grid_inv_h), 0), GRID_SIZE - 1);
+  int cy1 = MIN(MAX((int)((by1 - grid_y0) * grid_inv_h), 0), GRID_SIZE - 1);
+
+  if (++stamp == 0) {
+    std::fill(visit_stamp.begin(), visit_stamp.end(), 0);
+    stamp = 1;
   }
-  proj = axis.x * bbox.x1 + axis.y * bbox.y1;
-  min_2 = MIN(min_2, proj);
-  max_2 = MAX(max_2, proj);
-  proj = axis.x * bbox.x2 + axis.y * bbox.y1;
-  min_2 = MIN(min_2, proj);
-  max_2 = MAX(max_2, proj);
-  proj = axis.x * bbox.x2 + axis.y * bbox.y2;
-  min_2 = MIN(min_2, proj);
-  max_2 = MAX(max_2, proj);
-  proj = axis.x * bbox.x1 + axis.y * bbox.y2;
-  min_2 = MIN(min_2, proj);
-  max_2 = MAX(max_2, proj);
-
-  if ((max_1 >= min_2) && (max_2 >= min_1)) {
-    return false;
-  } else {
-    return true;
+  bool hit = false;
+  for (int cy = cy0; cy <= cy1; cy++) {
+    for (int cx = cx0; cx <= cx1; cx++) {
+      int c = cy * GRID_SIZE + cx;
+      for (uint32_t k = cell_begin[c]; k < cell_begin[c + 1]; k++) {
+        uint32_t i = cell_items[k];
+        if (visit_stamp[i] == stamp) continue;
+        visit_stamp[i] = stamp;
+        const convex_index_t &ci = convex_index[i];
+        if (zone_mask != NULL && (*zone_mask >> ci.zone) & 1) continue;
+        /* the base axes of the SAT test */
+        if (bx1 < ci.min_x || ci.max_x < bx0 || by1 < ci.min_y || ci.max_y < by0) continue;
+        bool separating = false;
+        for (uint32_t j = ci.axis_begin; j < ci.axis_end; j++) {
+          float ax = axis_x[j], ay = axis_y[j];
+          float pmin = ax * (ax >= 0 ? bx0 : bx1) + ay * (ay >= 0 ? by0 : by1);
+          float pmax = ax * (ax >= 0 ? bx1 : bx0) + ay * (ay >= 0 ? by1 : by0);
+          if (axis_max[j] < pmin || pmax < axis_min[j]) {
+            separating = true;
+            break;
+          }
+        }
+        if (separating) continue;
+        if (zone_mask == NULL) return true;
+        *zone_mask |= (uint64_t)1 << ci.zone;
+        hit = true;
+      }
+    }
   }
+  return hit;
 }
 
 bool IntrusionDetect::is_point_in_triangle(const vertex_t &o, const vertex_t &v1,
@@ -396,6 +496,7 @@ bool IntrusionDetect::ConvexPartition_HM(const cvtdl_pts_t &pts,
     }
     convex_idxes.push_back(triangle_idxes[i]);
   }
+  delete[] valid_triangle;
 
   return true;
 }
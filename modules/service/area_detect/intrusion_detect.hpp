@@ -5,6 +5,7 @@
 #include <memory>
 #include <vector>
 #include "core/core/cvtdl_core_types.h"
+#include "core/object/cvtdl_object_types.h"
 
 namespace cvitdl {
 namespace service {
@@ -37,20 +38,46 @@ class IntrusionDetect {
   void getRegion(cvtdl_pts_t ***region_info, uint32_t *size);
   void clean();
   bool run(const cvtdl_bbox_t &bbox);
+  static constexpr uint32_t MAX_MASK_ZONES = 64;
+  /* region_masks[i] gets bit k set if obj->info[i].bbox intersects the k-th region passed to
+   * setRegion, fails with more than MAX_MASK_ZONES regions */
+  int run(const cvtdl_object_t &obj, uint64_t *region_masks);
   void show();
 
  private:
-  bool is_separating_axis(const vertex_t &axis, const cvtdl_pts_t &region_pts,
-                          const cvtdl_bbox_t &bbox);
   bool is_point_in_triangle(const vertex_t &o, const vertex_t &v1, const vertex_t &v2,
                             const vertex_t &v3);
   float get_SignedGaussArea(const cvtdl_pts_t &pts);
   bool Triangulate_EC(const cvtdl_pts_t &pts, std::vector<std::vector<int>> &triangle_idxes);
   bool ConvexPartition_HM(const cvtdl_pts_t &pts, std::vector<std::vector<int>> &convex_idxes);
 
+  /* precomputed search structure over the convex parts, rebuilt after the regions change */
+  typedef struct {
+    float min_x, max_x, min_y, max_y;
+    uint32_t zone;
+    uint32_t axis_begin;
+    uint32_t axis_end;
+  } convex_index_t;
+  void build_index();
+  /* with zone_mask NULL, return at the first intersecting part */
+  bool query(const cvtdl_bbox_t &bbox, uint64_t *zone_mask);
+
   /* member data */
   std::vector<std::shared_ptr<ConvexPolygon>> regions;
-  cvtdl_pts_t base;
+  std::vector<uint32_t> region_zones;  // user region index of every convex part
+  uint32_t num_zones = 0;
+
+  bool index_dirty = true;
+  std::vector<convex_index_t> convex_index;
+  /* edge normals of all convex parts with the polygon projection range on them */
+  std::vector<float> axis_x, axis_y, axis_min, axis_max;
+  /* uniform grid over the bounding box of all parts, cell_items[cell_begin[c]..cell_begin[c+1]]
+   * are the parts whose AABB overlaps cell c */
+  float grid_x0 = 0, grid_y0 = 0, grid_x1 = 0, grid_y1 = 0, grid_inv_w = 0, grid_inv_h = 0;
+  std::vector<uint32_t> cell_begin;
+  std::vector<uint32_t> cell_items;
+  std::vector<uint32_t> visit_stamp;
+  uint32_t stamp = 0;
 };
 
 }  // namespace service
@@ -8,6 +8,8 @@
 #include "cvi_tdl_core_internal.hpp"
 #include "digital_tracking/digital_tracking.hpp"
 #include "draw_rect/draw_rect.hpp"
+#include "draw_rect/overlay.hpp"
+#include "tracker/tracker.hpp"
 #ifndef NO_OPENCV
 #include "face_angle/face_angle.hpp"
 #endif
@@ -19,6 +21,8 @@ typedef struct {
 #endif
   cvitdl::service::DigitalTracking *m_dt = nullptr;
   cvitdl::service::IntrusionDetect *m_intrusion_det = nullptr;
+  cvitdl::service::Overlay *m_overlay = nullptr;
+  cvitdl::service::Tracker *m_tracker = nullptr;
 } cvitdl_service_context_t;
 
 CVI_S32 CVI_TDL_Service_CreateHandle(cvitdl_service_handle_t *handle, cvitdl_handle_t tdl_handle) {
@@ -38,6 +42,8 @@ CVI_S32 CVI_TDL_Service_DestroyHandle(cvitdl_service_handle_t handle) {
   delete ctx->m_fm;
 #endif
   delete ctx->m_dt;
+  delete ctx->m_overlay;
+  delete ctx->m_tracker;
   delete ctx;
   return CVI_TDL_SUCCESS;
 }
@@ -58,6 +64,8 @@ CVI_S32 CVI_TDL_Service_RegisterFeatureArray(cvitdl_service_handle_t handle,
       ctx->m_fm = nullptr;
       return ret;
     }
+    cvitdl_context_t *tdl_ctx = static_cast<cvitdl_context_t *>(ctx->tdl_handle);
+    ctx->m_fm->getMemAccount().setParent(tdl_ctx->mem_account);
   }
   return ctx->m_fm->registerData(featureArray, method);
 #endif
@@ -196,6 +204,38 @@ CVI_S32 CVI_TDL_Service_ObjectDigitalZoomExt(cvitdl_service_handle_t handle,
                         pad_ratio_bottom, obj_skip_ratio, trans_ratio);
 }
 
+CVI_S32 CVI_TDL_Service_DigitalZoom_GetDefaultConfig(cvtdl_service_dt_config_t *config) {
+  if (config == nullptr) {
+    LOGE("config is NULL\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  cvitdl::service::DigitalTracking::getDefaultConfig(config);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Service_DigitalZoom_SetConfig(cvitdl_service_handle_t handle,
+                                              const cvtdl_service_dt_config_t *config) {
+  cvitdl_service_context_t *ctx = static_cast<cvitdl_service_context_t *>(handle);
+  if (config == nullptr) {
+    LOGE("config is NULL\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  if (ctx->m_dt == nullptr) {
+    ctx->m_dt = new cvitdl::service::DigitalTracking();
+  }
+  return ctx->m_dt->setConfig(config);
+}
+
+CVI_S32 CVI_TDL_Service_DigitalZoom_ReleaseFrame(cvitdl_service_handle_t handle,
+                                                 VIDEO_FRAME_INFO_S *frame) {
+  cvitdl_service_context_t *ctx = static_cast<cvitdl_service_context_t *>(handle);
+  if (ctx->m_dt == nullptr) {
+    LOGE("digital zoom is not running\n");
+    return CVI_TDL_ERR_NOT_YET_INITIALIZED;
+  }
+  return ctx->m_dt->releaseFrame(frame);
+}
+
 template <typename T>
 inline CVI_S32 DrawRect(cvitdl_service_handle_t handle, const T *meta, VIDEO_FRAME_INFO_S *frame,
                         const bool drawText, cvtdl_service_brush_t brush) {
@@ -270,6 +310,123 @@ CVI_S32 CVI_TDL_Service_DrawPolygon(cvitdl_service_handle_t handle, VIDEO_FRAME_
   return cvitdl::service::DrawPolygon(frame, pts, brush);
 }
 
+static cvitdl::service::Overlay *GetOverlay(cvitdl_service_handle_t handle) {
+  if (handle == NULL) {
+    LOGE("service handle is NULL\n");
+    return nullptr;
+  }
+  cvitdl_service_context_t *ctx = static_cast<cvitdl_service_context_t *>(handle);
+  if (ctx->m_overlay == nullptr) {
+    ctx->m_overlay = new cvitdl::service::Overlay();
+  }
+  return ctx->m_overlay;
+}
+
+CVI_S32 CVI_TDL_Service_Overlay_Clear(cvitdl_service_handle_t handle) {
+  cvitdl::service::Overlay *overlay = GetOverlay(handle);
+  if (overlay == nullptr) return CVI_TDL_FAILURE;
+  overlay->clear();
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Service_Overlay_AddRect(cvitdl_service_handle_t handle, const cvtdl_bbox_t *bbox,
+                                        cvtdl_service_brush_t brush) {
+  cvitdl::service::Overlay *overlay = GetOverlay(handle);
+  if (overlay == nullptr) return CVI_TDL_FAILURE;
+  if (bbox == nullptr) {
+    LOGE("bbox is NULL\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  overlay->addRect(*bbox, brush);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Service_Overlay_AddFaceMeta(cvitdl_service_handle_t handle,
+                                            const cvtdl_face_t *meta, const bool drawText,
+                                            cvtdl_service_brush_t brush) {
+  cvitdl::service::Overlay *overlay = GetOverlay(handle);
+  if (overlay == nullptr) return CVI_TDL_FAILURE;
+  if (meta == nullptr) {
+    LOGE("meta is NULL\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  overlay->addMeta(meta, drawText, brush);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Service_Overlay_AddObjectMeta(cvitdl_service_handle_t handle,
+                                              const cvtdl_object_t *meta, const bool drawText,
+                                              cvtdl_service_brush_t brush) {
+  cvitdl::service::Overlay *overlay = GetOverlay(handle);
+  if (overlay == nullptr) return CVI_TDL_FAILURE;
+  if (meta == nullptr) {
+    LOGE("meta is NULL\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  overlay->addMeta(meta, drawText, brush);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Service_Overlay_AddPolyline(cvitdl_service_handle_t handle,
+                                            const cvtdl_pts_t *pts, const bool closed,
+                                            cvtdl_service_brush_t brush) {
+  cvitdl::service::Overlay *overlay = GetOverlay(handle);
+  if (overlay == nullptr) return CVI_TDL_FAILURE;
+  if (pts == nullptr || (pts->size != 0 && (pts->x == nullptr || pts->y == nullptr))) {
+    LOGE("pts is NULL\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  overlay->addPolyline(*pts, closed, brush);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Service_Overlay_AddPoints(cvitdl_service_handle_t handle, const cvtdl_pts_t *pts,
+                                          const uint32_t radius, cvtdl_service_brush_t brush) {
+  cvitdl::service::Overlay *overlay = GetOverlay(handle);
+  if (overlay == nullptr) return CVI_TDL_FAILURE;
+  if (pts == nullptr || (pts->size != 0 && (pts->x == nullptr || pts->y == nullptr))) {
+    LOGE("pts is NULL\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  overlay->addPoints(*pts, radius, brush);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Service_Overlay_AddText(cvitdl_service_handle_t handle, const char *text, int x,
+                                        int y, cvtdl_service_brush_t brush) {
+  cvitdl::service::Overlay *overlay = GetOverlay(handle);
+  if (overlay == nullptr) return CVI_TDL_FAILURE;
+  if (text == nullptr) {
+    LOGE("text is NULL\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  overlay->addText(text, x, y, brush);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Service_Overlay_AddPose17(cvitdl_service_handle_t handle,
+                                          const cvtdl_object_t *meta, const float score_threshold,
+                                          cvtdl_service_brush_t brush) {
+  cvitdl::service::Overlay *overlay = GetOverlay(handle);
+  if (overlay == nullptr) return CVI_TDL_FAILURE;
+  if (meta == nullptr) {
+    LOGE("meta is NULL\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  overlay->addPose17(meta, score_threshold, brush);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Service_Overlay_Render(cvitdl_service_handle_t handle, VIDEO_FRAME_INFO_S *frame) {
+  cvitdl::service::Overlay *overlay = GetOverlay(handle);
+  if (overlay == nullptr) return CVI_TDL_FAILURE;
+  if (frame == nullptr) {
+    LOGE("frame is NULL\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  return overlay->render(frame);
+}
+
 CVI_S32 CVI_TDL_Service_Polygon_SetTarget(cvitdl_service_handle_t handle, const cvtdl_pts_t *pts) {
   cvitdl_service_context_t *ctx = static_cast<cvitdl_service_context_t *>(handle);
   if (ctx->m_intrusion_det == nullptr) {
@@ -310,6 +467,94 @@ CVI_S32 CVI_TDL_Service_Polygon_Intersect(cvitdl_service_handle_t handle, const
   return CVI_TDL_SUCCESS;
 }
 
+CVI_S32 CVI_TDL_Service_Polygon_IntersectObjects(cvitdl_service_handle_t handle,
+                                                 const cvtdl_object_t *obj,
+                                                 uint64_t *region_masks) {
+  if (obj == nullptr || (obj->size > 0 && region_masks == nullptr)) {
+    LOGE("obj or region_masks is NULL.\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  cvitdl_service_context_t *ctx = static_cast<cvitdl_service_context_t *>(handle);
+  if (ctx->m_intrusion_det == nullptr) {
+    LOGE("Please set intersect area first.\n");
+    return CVI_TDL_FAILURE;
+  }
+  return ctx->m_intrusion_det->run(*obj, region_masks);
+}
+
+CVI_S32 CVI_TDL_Service_Trajectory_Init(cvitdl_service_handle_t handle, uint32_t max_ids,
+                                        uint32_t history_len, uint64_t delete_duration_ms) {
+  if (max_ids == 0 || history_len == 0) {
+    LOGE("invalid trajectory capacity %u x %u\n", max_ids, history_len);
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  cvitdl_service_context_t *ctx = static_cast<cvitdl_service_context_t *>(handle);
+  delete ctx->m_tracker;
+  ctx->m_tracker = new cvitdl::service::Tracker(max_ids, history_len);
+  ctx->m_tracker->setDeleteDuration(delete_duration_ms);
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Service_Trajectory_Register(cvitdl_service_handle_t handle, uint64_t timestamp_ms,
+                                            const cvtdl_object_t *obj) {
+  if (obj == nullptr) {
+    LOGE("obj is NULL.\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  cvitdl_service_context_t *ctx = static_cast<cvitdl_service_context_t *>(handle);
+  if (ctx->m_tracker == nullptr) {
+    ctx->m_tracker = new cvitdl::service::Tracker();
+  }
+  for (uint32_t i = 0; i < obj->size; i++) {
+    const cvtdl_bbox_t &bbox = obj->info[i].bbox;
+    ctx->m_tracker->registerId(timestamp_ms, (int64_t)obj->info[i].unique_id,
+                               (bbox.x1 + bbox.x2) / 2, (bbox.y1 + bbox.y2) / 2);
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+CVI_S32 CVI_TDL_Service_Trajectory_GetPositions(cvitdl_service_handle_t handle, uint64_t id,
+                                                uint64_t duration_ms, float *x, float *y,
+                                                uint64_t *timestamps_ms, uint32_t max_num,
+                                                uint32_t *num) {
+  if (num == nullptr || (max_num > 0 && (x == nullptr || y == nullptr))) {
+    LOGE("output is NULL.\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  cvitdl_service_context_t *ctx = static_cast<cvitdl_service_context_t *>(handle);
+  if (ctx->m_tracker == nullptr) {
+    *num = 0;
+    return CVI_TDL_FAILURE;
+  }
+  return ctx->m_tracker->getPositions((int64_t)id, duration_ms, x, y, timestamps_ms, max_num, num);
+}
+
+CVI_S32 CVI_TDL_Service_Trajectory_GetVelocity(cvitdl_service_handle_t handle, uint64_t id,
+                                               uint64_t duration_ms, float *vx, float *vy) {
+  if (vx == nullptr || vy == nullptr) {
+    LOGE("output is NULL.\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  cvitdl_service_context_t *ctx = static_cast<cvitdl_service_context_t *>(handle);
+  if (ctx->m_tracker == nullptr) {
+    return CVI_TDL_FAILURE;
+  }
+  return ctx->m_tracker->getVelocity((int64_t)id, duration_ms, vx, vy);
+}
+
+CVI_S32 CVI_TDL_Service_Trajectory_GetHeading(cvitdl_service_handle_t handle, uint64_t id,
+                                              uint64_t duration_ms, float *heading) {
+  if (heading == nullptr) {
+    LOGE("output is NULL.\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  cvitdl_service_context_t *ctx = static_cast<cvitdl_service_context_t *>(handle);
+  if (ctx->m_tracker == nullptr) {
+    return CVI_TDL_FAILURE;
+  }
+  return ctx->m_tracker->getHeading((int64_t)id, duration_ms, heading);
+}
+
 CVI_S32 CVI_TDL_Service_FaceAngle(const cvtdl_pts_t *pts, cvtdl_head_pose_t *hp) {
 #ifdef NO_OPENCV
   return CVI_TDL_FAILURE;
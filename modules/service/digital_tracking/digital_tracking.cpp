@@ -6,12 +6,44 @@
 #include "rescale_utils.hpp"
 
 #include <algorithm>
+#include <cmath>
 
 #define DEFAULT_DT_ZOOM_TRANS_RATIO 0.1f
+// async crops handed out and not released yet, more than the output pool of the group
+#define DT_MAX_OUT_FRAMES 8
 
 namespace cvitdl {
 namespace service {
 
+DigitalTracking::DigitalTracking() { getDefaultConfig(&m_config); }
+
+DigitalTracking::~DigitalTracking() {
+  dropPending();
+  delete mp_async_vpss;
+}
+
+void DigitalTracking::getDefaultConfig(cvtdl_service_dt_config_t *config) {
+  config->predictive = false;
+  config->smooth_time = 0.5f;
+  config->predict_time = 0.2f;
+  config->dead_zone = 0.1f;
+  config->settle_zone = 0.02f;
+  config->frame_interval = 1.0f / 30;
+  config->async = false;
+}
+
+int DigitalTracking::setConfig(const cvtdl_service_dt_config_t *config) {
+  if (config->smooth_time <= 0 || config->predict_time < 0 || config->frame_interval <= 0 ||
+      config->settle_zone < 0 || config->dead_zone < config->settle_zone) {
+    LOGE("invalid digital tracking config.\n");
+    return CVI_TDL_ERR_INVALID_ARGS;
+  }
+  if (!config->async) dropPending();
+  if (config->predictive && !m_config.predictive) m_predictor.reset();
+  m_config = *config;
+  return CVI_TDL_SUCCESS;
+}
+
 int DigitalTracking::setVpssTimeout(uint32_t timeout) {
   m_vpss_timeout = timeout;
   return CVI_TDL_SUCCESS;
@@ -77,9 +109,57 @@ int DigitalTracking::run(const VIDEO_FRAME_INFO_S *srcFrame, const T *meta,
   if (!m_prev_rect.is_valid()) {
     m_prev_rect = Rect(0, width - 1, 0, height - 1);
   }
-  transformRect(trans_ratio, m_prev_rect, &rect);
+  if (m_config.predictive) {
+    m_predictor.predict(m_config, width, height, frameInterval(srcFrame), m_prev_rect, &rect);
+  } else {
+    transformRect(trans_ratio, m_prev_rect, &rect);
+  }
   fitFrame(width, height, &rect);
 
+  int ret = crop(srcFrame, rect, dstFrame);
+  if (ret != CVI_TDL_SUCCESS) return ret;
+#ifdef DT_DEBUG
+  color_rgb rgb_color;
+  rgb_color.r = DEFAULT_RECT_COLOR_R;
+  rgb_color.g = DEFAULT_RECT_COLOR_G;
+  rgb_color.b = DEFAULT_RECT_COLOR_B;
+  cvitdl::service::DrawRect(dstFrame, rect.l, rect.r, rect.t, rect.b, "", rgb_color,
+                            DEFAULT_RECT_THICKNESS, false);
+#endif
+  m_prev_rect = rect;
+  return CVI_TDL_SUCCESS;
+}
+
+// seconds since the previous call from the PTS (us) of the frames, the configured interval
+// when they do not increase
+float DigitalTracking::frameInterval(const VIDEO_FRAME_INFO_S *srcFrame) {
+  CVI_U64 pts = srcFrame->stVFrame.u64PTS;
+  float dt = m_config.frame_interval;
+  if (m_last_pts != 0 && pts > m_last_pts && pts - m_last_pts < 1000000) {
+    dt = (pts - m_last_pts) / 1000000.0f;
+  }
+  m_last_pts = pts;
+  return dt;
+}
+
+int DigitalTracking::crop(const VIDEO_FRAME_INFO_S *srcFrame, const Rect &rect,
+                          VIDEO_FRAME_INFO_S *dstFrame) {
+  uint32_t width = srcFrame->stVFrame.u32Width;
+  uint32_t height = srcFrame->stVFrame.u32Height;
+  VpssEngine *engine = mp_vpss_inst;
+  if (m_config.async) {
+    if (mp_async_vpss == nullptr) {
+      mp_async_vpss = new VpssEngine();
+      if (mp_async_vpss->init() != CVI_SUCCESS) {
+        LOGE("cannot create the vpss group of the async digital tracking.\n");
+        delete mp_async_vpss;
+        mp_async_vpss = nullptr;
+        return CVI_TDL_ERR_INIT_VPSS;
+      }
+    }
+    engine = mp_async_vpss;
+  }
+
   VPSS_CHN_ATTR_S chnAttr;
   VPSS_CHN_DEFAULT_HELPER(&chnAttr, width, height, srcFrame->stVFrame.enPixelFormat, true);
   VPSS_CROP_INFO_S cropAttr;
@@ -91,20 +171,59 @@ int DigitalTracking::run(const VIDEO_FRAME_INFO_S *srcFrame, const T *meta,
   cropAttr.enCropCoordinate = VPSS_CROP_RATIO_COOR;
   cropAttr.stCropRect = {(int)rect.l, (int)rect.t, (uint32_t)(rect.r - rect.l),
                          (uint32_t)(rect.b - rect.t)};
-  mp_vpss_inst->sendCropChnFrame(srcFrame, &cropAttr, &chnAttr, 1);
-  mp_vpss_inst->getFrame(dstFrame, 0, m_vpss_timeout);
-#ifdef DT_DEBUG
-  color_rgb rgb_color;
-  rgb_color.r = DEFAULT_RECT_COLOR_R;
-  rgb_color.g = DEFAULT_RECT_COLOR_G;
-  rgb_color.b = DEFAULT_RECT_COLOR_B;
-  cvitdl::service::DrawRect(dstFrame, rect.l, rect.r, rect.t, rect.b, "", rgb_color,
-                            DEFAULT_RECT_THICKNESS, false);
-#endif
-  m_prev_rect = rect;
+  if (!m_config.async) {
+    mp_vpss_inst->sendCropChnFrame(srcFrame, &cropAttr, &chnAttr, 1);
+    mp_vpss_inst->getFrame(dstFrame, 0, m_vpss_timeout);
+    return CVI_TDL_SUCCESS;
+  }
+
+  // hand out the crop of the previous call and leave this one running, the first call waits for
+  // its own crop and queues it once more so there is always one in flight
+  int ret = CVI_TDL_SUCCESS;
+  if (!m_pending) {
+    ret = engine->sendCropChnFrame(srcFrame, &cropAttr, &chnAttr, 1);
+    if (ret == CVI_SUCCESS) ret = engine->getFrame(dstFrame, 0, m_vpss_timeout);
+  } else {
+    m_pending = false;
+    ret = engine->getFrame(dstFrame, 0, m_vpss_timeout);
+  }
+  if (ret != CVI_SUCCESS) {
+    LOGE("async digital tracking crop failed with %#x.\n", ret);
+    return CVI_TDL_ERR_VPSS_GET_FRAME;
+  }
+  // a crop the caller released another way is forgotten once the group has reused its buffer
+  if (m_out_frames.size() == DT_MAX_OUT_FRAMES) m_out_frames.erase(m_out_frames.begin());
+  m_out_frames.push_back(dstFrame->stVFrame.u64PhyAddr[0]);
+  if (engine->sendCropChnFrame(srcFrame, &cropAttr, &chnAttr, 1) == CVI_SUCCESS) {
+    m_pending = true;
+  }
   return CVI_TDL_SUCCESS;
 }
 
+int DigitalTracking::releaseFrame(VIDEO_FRAME_INFO_S *frame) {
+  // the sync crops come from the group of the handle, only the async ones are recorded
+  VpssEngine *engine = mp_vpss_inst;
+  auto it = std::find(m_out_frames.begin(), m_out_frames.end(), frame->stVFrame.u64PhyAddr[0]);
+  if (it != m_out_frames.end()) {
+    engine = mp_async_vpss;
+    m_out_frames.erase(it);
+  }
+  if (engine == nullptr) {
+    LOGE("vpss_inst not set.\n");
+    return CVI_TDL_FAILURE;
+  }
+  return engine->releaseFrame(frame, 0) == CVI_SUCCESS ? CVI_TDL_SUCCESS : CVI_TDL_FAILURE;
+}
+
+void DigitalTracking::dropPending() {
+  if (!m_pending) return;
+  VIDEO_FRAME_INFO_S frame;
+  if (mp_async_vpss->getFrame(&frame, 0, m_vpss_timeout) == CVI_SUCCESS) {
+    mp_async_vpss->releaseFrame(&frame, 0);
+  }
+  m_pending = false;
+}
+
 void DigitalTracking::transformRect(const float trans_ratio, const Rect &prev_rect,
                                     Rect *curr_rect) {
   curr_rect->l = prev_rect.l * (1.0 - trans_ratio) + curr_rect->l * trans_ratio;
@@ -1,46 +1,24 @@
 #pragma once
 #include "core/face/cvtdl_face_types.h"
 #include "core/object/cvtdl_object_types.h"
+#include "service/cvi_tdl_service_types.h"
 #include "vpss_engine.hpp"
+#include "zoom_predictor.hpp"
 
-#include <cmath>
+#include <vector>
 
 namespace cvitdl {
 namespace service {
 
-struct Rect {
-  Rect() {}
-  Rect(float l, float r, float t, float b) : l(l), r(r), t(t), b(b) {}
-
-  void add_padding(float ratio) {
-    float w = std::abs(r - l) * ratio;
-    float h = std::abs(t - b) * ratio;
-    l -= w;
-    r += w;
-    t -= h;
-    b += h;
-  }
-  void add_padding(float ratio_l, float ratio_r, float ratio_t, float ratio_b) {
-    float w = std::abs(r - l);
-    float h = std::abs(t - b);
-    l -= w * ratio_l;
-    r += w * ratio_r;
-    t -= h * ratio_t;
-    b += h * ratio_b;
-  }
-
-  bool is_valid() { return (l != -1); }
-
-  float l = -1;
-  float r = -1;
-  float t = -1;
-  float b = -1;
-};
-
 class DigitalTracking {
  public:
+  DigitalTracking();
+  ~DigitalTracking();
+  static void getDefaultConfig(cvtdl_service_dt_config_t *config);
+  int setConfig(const cvtdl_service_dt_config_t *config);
   int setVpssTimeout(uint32_t timeout);
   int setVpssEngine(VpssEngine *engine);
+  int releaseFrame(VIDEO_FRAME_INFO_S *frame);
   template <typename T>
   int run(const VIDEO_FRAME_INFO_S *srcFrame, const T *meta, VIDEO_FRAME_INFO_S *dstFrame,
           const float pad_l = 0.3f, const float pad_r = 0.3f, const float pad_t = 0.3f,
@@ -51,10 +29,25 @@ class DigitalTracking {
   inline void transformRect(const float trans_ratio, const Rect &prev_rect, Rect *curr_rect);
   inline void fitRatio(const float width, const float height, Rect *rect);
   inline void fitFrame(const float width, const float height, Rect *rect);
+  float frameInterval(const VIDEO_FRAME_INFO_S *srcFrame);
+  int crop(const VIDEO_FRAME_INFO_S *srcFrame, const Rect &rect, VIDEO_FRAME_INFO_S *dstFrame);
+  void dropPending();
 
+  cvtdl_service_dt_config_t m_config;
   Rect m_prev_rect;
   uint32_t m_vpss_timeout = 100;
   VpssEngine *mp_vpss_inst = nullptr;
+
+  // predictive mode
+  ZoomPredictor m_predictor;
+  CVI_U64 m_last_pts = 0;
+
+  // async mode
+  VpssEngine *mp_async_vpss = nullptr;
+  bool m_pending = false;
+  // physical address of the async crops handed out and not released yet, so a frame goes back to
+  // the async group after the mode switches
+  std::vector<uint64_t> m_out_frames;
 };
 }  // namespace service
 }  // namespace cvitdl
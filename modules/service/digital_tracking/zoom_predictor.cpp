@@ -0,0 +1,83 @@
+#include "zoom_predictor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// gains of the group box filter, the detections are noisy so trust the prediction more
+#define DT_TRACK_ALPHA 0.4f
+#define DT_TRACK_BETA 0.05f
+
+namespace cvitdl {
+namespace service {
+
+void SpringAxis::step(float goal, float omega, float dt) {
+  // exact solution over dt, stable for any step
+  float offset = pos - goal;
+  float tmp = (vel + omega * offset) * dt;
+  float decay = std::exp(-omega * dt);
+  pos = goal + (offset + tmp) * decay;
+  vel = (vel - omega * tmp) * decay;
+}
+
+void TrackAxis::update(float meas, float dt) {
+  float residual = meas - (pos + vel * dt);
+  pos += vel * dt + DT_TRACK_ALPHA * residual;
+  vel += DT_TRACK_BETA * residual / dt;
+}
+
+void ZoomPredictor::predict(const cvtdl_service_dt_config_t &config, const float width,
+                            const float height, const float dt, const Rect &prev_rect,
+                            Rect *rect) {
+  const float meas[3] = {(rect->l + rect->r) / 2, (rect->t + rect->b) / 2, rect->r - rect->l};
+  if (!m_valid) {
+    const float prev[3] = {(prev_rect.l + prev_rect.r) / 2, (prev_rect.t + prev_rect.b) / 2,
+                           prev_rect.r - prev_rect.l};
+    for (int i = 0; i < 3; i++) {
+      m_target[i] = TrackAxis{meas[i], 0};
+      m_camera[i] = SpringAxis{prev[i], 0};
+      m_goal[i] = prev[i];
+    }
+    m_following = true;
+    m_valid = true;
+  } else {
+    for (int i = 0; i < 3; i++) m_target[i].update(meas[i], dt);
+  }
+
+  float predicted[3];
+  for (int i = 0; i < 3; i++) {
+    predicted[i] = m_target[i].pos + m_target[i].vel * config.predict_time;
+  }
+  predicted[2] = std::max(predicted[2], 4.0f);
+
+  // hysteresis, follow once the target is dead_zone away from the crop and hold the goal again
+  // when the crop is within settle_zone of a target that stopped moving
+  const float ratio = height / width;
+  const float scale[3] = {1.0f, 1.0f / ratio, 1.0f};
+  const float camera_w = std::max(m_camera[2].pos, 4.0f);
+  float error = 0, motion = 0;
+  for (int i = 0; i < 3; i++) {
+    error = std::max(error, std::abs(predicted[i] - m_camera[i].pos) * scale[i] / camera_w);
+    motion =
+        std::max(motion, std::abs(m_target[i].vel) * config.smooth_time * scale[i] / camera_w);
+  }
+  if (!m_following && error > config.dead_zone) {
+    m_following = true;
+  } else if (m_following && error < config.settle_zone && motion < config.settle_zone) {
+    m_following = false;
+  }
+  if (m_following) {
+    std::copy(predicted, predicted + 3, m_goal);
+  }
+
+  const float omega = 4.0f / config.smooth_time;
+  for (int i = 0; i < 3; i++) m_camera[i].step(m_goal[i], omega, dt);
+
+  const float w = std::max(m_camera[2].pos, 4.0f);
+  const float h = w * ratio;
+  rect->l = m_camera[0].pos - w / 2;
+  rect->r = rect->l + w;
+  rect->t = m_camera[1].pos - h / 2;
+  rect->b = rect->t + h;
+}
+}  // namespace service
+}  // namespace cvitdl
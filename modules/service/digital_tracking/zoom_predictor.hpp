@@ -0,0 +1,71 @@
+#pragma once
+#include "service/cvi_tdl_service_types.h"
+
+#include <cmath>
+
+namespace cvitdl {
+namespace service {
+
+struct Rect {
+  Rect() {}
+  Rect(float l, float r, float t, float b) : l(l), r(r), t(t), b(b) {}
+
+  void add_padding(float ratio) {
+    float w = std::abs(r - l) * ratio;
+    float h = std::abs(t - b) * ratio;
+    l -= w;
+    r += w;
+    t -= h;
+    b += h;
+  }
+  void add_padding(float ratio_l, float ratio_r, float ratio_t, float ratio_b) {
+    float w = std::abs(r - l);
+    float h = std::abs(t - b);
+    l -= w * ratio_l;
+    r += w * ratio_r;
+    t -= h * ratio_t;
+    b += h * ratio_b;
+  }
+
+  bool is_valid() { return (l != -1); }
+
+  float l = -1;
+  float r = -1;
+  float t = -1;
+  float b = -1;
+};
+
+// critically damped spring of one crop coordinate
+struct SpringAxis {
+  float pos = 0;
+  float vel = 0;
+  void step(float goal, float omega, float dt);
+};
+
+// constant velocity alpha-beta filter of one group box coordinate
+struct TrackAxis {
+  float pos = 0;
+  float vel = 0;
+  void update(float meas, float dt);
+};
+
+// virtual camera of the predictive digital zoom, center x, center y and width of the target
+// and of the crop
+class ZoomPredictor {
+ public:
+  void reset() { m_valid = false; }
+  // moves the crop towards the predicted group box rect, the first call after reset starts from
+  // prev_rect
+  void predict(const cvtdl_service_dt_config_t &config, const float width, const float height,
+               const float dt, const Rect &prev_rect, Rect *rect);
+  bool following() const { return m_following; }
+
+ private:
+  bool m_valid = false;
+  bool m_following = false;
+  TrackAxis m_target[3];
+  float m_goal[3];
+  SpringAxis m_camera[3];
+};
+}  // namespace service
+}  // namespace cvitdl
@@ -0,0 +1,446 @@
+#include "overlay.hpp"
+
+#include <cvi_sys.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include "core/core/cvtdl_errno.h"
+#include "cvi_tdl_log.hpp"
+#include "rescale_utils.hpp"
+
+#define GLYPH_W 5
+#define GLYPH_H 7
+#define GLYPH_CELL_W 6
+#define GLYPH_CELL_H 8
+#define GLYPH_FIRST 0x20
+#define GLYPH_LAST 0x7e
+
+namespace cvitdl {
+namespace service {
+
+// clang-format off
+/* 5x7 ASCII font (0x20 ~ 0x7e), column-major, bit 0 is the top row. */
+static const uint8_t FONT_5X7[GLYPH_LAST - GLYPH_FIRST + 1][GLYPH_W] = {
+  {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5f, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+  {0x14, 0x7f, 0x14, 0x7f, 0x14}, {0x24, 0x2a, 0x7f, 0x2a, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+  {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00}, {0x00, 0x1c, 0x22, 0x41, 0x00},
+  {0x00, 0x41, 0x22, 0x1c, 0x00}, {0x08, 0x2a, 0x1c, 0x2a, 0x08}, {0x08, 0x08, 0x3e, 0x08, 0x08},
+  {0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00},
+  {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3e, 0x51, 0x49, 0x45, 0x3e}, {0x00, 0x42, 0x7f, 0x40, 0x00},
+  {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4b, 0x31}, {0x18, 0x14, 0x12, 0x7f, 0x10},
+  {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3c, 0x4a, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+  {0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1e}, {0x00, 0x36, 0x36, 0x00, 0x00},
+  {0x00, 0x56, 0x36, 0x00, 0x00}, {0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14},
+  {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06}, {0x32, 0x49, 0x79, 0x41, 0x3e},
+  {0x7e, 0x11, 0x11, 0x11, 0x7e}, {0x7f, 0x49, 0x49, 0x49, 0x36}, {0x3e, 0x41, 0x41, 0x41, 0x22},
+  {0x7f, 0x41, 0x41, 0x22, 0x1c}, {0x7f, 0x49, 0x49, 0x49, 0x41}, {0x7f, 0x09, 0x09, 0x09, 0x01},
+  {0x3e, 0x41, 0x49, 0x49, 0x7a}, {0x7f, 0x08, 0x08, 0x08, 0x7f}, {0x00, 0x41, 0x7f, 0x41, 0x00},
+  {0x20, 0x40, 0x41, 0x3f, 0x01}, {0x7f, 0x08, 0x14, 0x22, 0x41}, {0x7f, 0x40, 0x40, 0x40, 0x40},
+  {0x7f, 0x02, 0x0c, 0x02, 0x7f}, {0x7f, 0x04, 0x08, 0x10, 0x7f}, {0x3e, 0x41, 0x41, 0x41, 0x3e},
+  {0x7f, 0x09, 0x09, 0x09, 0x06}, {0x3e, 0x41, 0x51, 0x21, 0x5e}, {0x7f, 0x09, 0x19, 0x29, 0x46},
+  {0x46, 0x49, 0x49, 0x49, 0x31}, {0x01, 0x01, 0x7f, 0x01, 0x01}, {0x3f, 0x40, 0x40, 0x40, 0x3f},
+  {0x1f, 0x20, 0x40, 0x20, 0x1f}, {0x3f, 0x40, 0x38, 0x40, 0x3f}, {0x63, 0x14, 0x08, 0x14, 0x63},
+  {0x07, 0x08, 0x70, 0x08, 0x07}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7f, 0x41, 0x41, 0x00},
+  {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7f, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04},
+  {0x40, 0x40, 0x40, 0x40, 0x40}, {0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78},
+  {0x7f, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20}, {0x38, 0x44, 0x44, 0x48, 0x7f},
+  {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7e, 0x09, 0x01, 0x02}, {0x0c, 0x52, 0x52, 0x52, 0x3e},
+  {0x7f, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7d, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3d, 0x00},
+  {0x7f, 0x10, 0x28, 0x44, 0x00}, {0x00, 0x41, 0x7f, 0x40, 0x00}, {0x7c, 0x04, 0x18, 0x04, 0x78},
+  {0x7c, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38}, {0x7c, 0x14, 0x14, 0x14, 0x08},
+  {0x08, 0x14, 0x14, 0x18, 0x7c}, {0x7c, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20},
+  {0x04, 0x3f, 0x44, 0x40, 0x20}, {0x3c, 0x40, 0x40, 0x20, 0x7c}, {0x1c, 0x20, 0x40, 0x20, 0x1c},
+  {0x3c, 0x40, 0x30, 0x40, 0x3c}, {0x44, 0x28, 0x10, 0x28, 0x44}, {0x0c, 0x50, 0x50, 0x50, 0x3c},
+  {0x44, 0x64, 0x54, 0x4c, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00}, {0x00, 0x00, 0x7f, 0x00, 0x00},
+  {0x00, 0x41, 0x36, 0x08, 0x00}, {0x08, 0x04, 0x08, 0x10, 0x08},
+};
+// clang-format on
+
+/* keypoint 17 is the middle of both shoulders, same as DrawPose17 */
+static const int POSE17_LIMBS[][2] = {{0, 1},   {0, 2},   {1, 3},   {2, 4},   {5, 6},
+                                      {5, 7},   {7, 9},   {6, 8},   {8, 10},  {17, 11},
+                                      {17, 12}, {11, 13}, {12, 14}, {13, 15}, {14, 16}};
+
+static uint8_t ToYuv(int channel, const cvtdl_service_brush_t &brush) {
+  float r = brush.color.r, g = brush.color.g, b = brush.color.b;
+  float v = 0;
+  if (channel == 0) {
+    v = (0.257 * r) + (0.504 * g) + (0.098 * b) + 16;
+  } else if (channel == 1) {
+    v = -(.148 * r) - (.291 * g) + (.439 * b) + 128;
+  } else {
+    v = (0.439 * r) - (0.368 * g) - (0.071 * b) + 128;
+  }
+  return (v < 0) ? 0 : ((v > 255.) ? 255 : static_cast<uint8_t>(v));
+}
+
+/* at least 2 and even as for the DrawRect boxes, the chroma planes get exactly half of it */
+static int RectThickness(const cvtdl_service_brush_t &brush) {
+  int thickness = std::max(static_cast<int>(brush.size), 2);
+  return thickness + (thickness & 1);
+}
+
+Overlay::Overlay() { buildGlyphAtlas(); }
+
+void Overlay::buildGlyphAtlas() {
+  int glyph_num = GLYPH_LAST - GLYPH_FIRST + 1;
+  m_glyphs.resize(glyph_num);
+  m_glyph_runs.clear();
+  for (int g = 0; g < glyph_num; g++) {
+    for (int row = 0; row < GLYPH_CELL_H; row++) {
+      m_glyphs[g].run_offset[row] = m_glyph_runs.size();
+      m_glyphs[g].run_num[row] = 0;
+      if (row >= GLYPH_H) continue;
+      int col = 0;
+      while (col < GLYPH_W) {
+        if (!(FONT_5X7[g][col] & (1 << row))) {
+          col++;
+          continue;
+        }
+        int start = col;
+        while (col < GLYPH_W && (FONT_5X7[g][col] & (1 << row))) col++;
+        m_glyph_runs.push_back({static_cast<uint8_t>(start), static_cast<uint8_t>(col - start)});
+        m_glyphs[g].run_num[row]++;
+      }
+    }
+  }
+}
+
+void Overlay::clear() {
+  m_cmds.clear();
+  m_pts_x.clear();
+  m_pts_y.clear();
+  m_text.clear();
+}
+
+Overlay::overlay_cmd_t &Overlay::pushCmd(cmd_type_e type, const cvtdl_service_brush_t &brush) {
+  overlay_cmd_t cmd;
+  memset(&cmd, 0, sizeof(cmd));
+  cmd.type = type;
+  cmd.color[0] = ToYuv(0, brush);
+  cmd.color[1] = ToYuv(1, brush);
+  cmd.color[2] = ToYuv(2, brush);
+  cmd.thickness = std::max(static_cast<int>(brush.size), 1);
+  m_cmds.push_back(cmd);
+  return m_cmds.back();
+}
+
+void Overlay::addRect(const cvtdl_bbox_t &bbox, const cvtdl_service_brush_t &brush) {
+  overlay_cmd_t &cmd = pushCmd(CMD_RECT, brush);
+  cmd.thickness = RectThickness(brush);
+  cmd.bbox = bbox;
+}
+
+template <typename T>
+void Overlay::addMeta(const T *meta, const bool draw_text, const cvtdl_service_brush_t &brush) {
+  for (uint32_t i = 0; i < meta->size; i++) {
+    overlay_cmd_t &cmd = pushCmd(CMD_RECT, brush);
+    cmd.thickness = RectThickness(brush);
+    cmd.bbox = meta->info[i].bbox;
+    cmd.src_width = meta->width;
+    cmd.src_height = meta->height;
+    cmd.rescale_type = meta->rescale_type;
+    if (draw_text && meta->info[i].name[0] != '\0') {
+      /* label is placed at rasterize time once the rescaled box is known */
+      overlay_cmd_t &text = pushCmd(CMD_TEXT, brush);
+      text.thickness = std::max(static_cast<int>(brush.size) / 2, 1);
+      text.bbox = meta->info[i].bbox;
+      text.src_width = meta->width;
+      text.src_height = meta->height;
+      text.rescale_type = meta->rescale_type;
+      text.pts_offset = m_text.size();
+      text.pts_num = strnlen(meta->info[i].name, sizeof(meta->info[i].name));
+      m_text.append(meta->info[i].name, text.pts_num);
+    }
+  }
+}
+
+template void Overlay::addMeta<cvtdl_face_t>(const cvtdl_face_t *meta, const bool draw_text,
+                                             const cvtdl_service_brush_t &brush);
+template void Overlay::addMeta<cvtdl_object_t>(const cvtdl_object_t *meta, const bool draw_text,
+                                               const cvtdl_service_brush_t &brush);
+
+void Overlay::addPolyline(const cvtdl_pts_t &pts, const bool closed,
+                          const cvtdl_service_brush_t &brush) {
+  if (pts.size == 0) return;
+  overlay_cmd_t &cmd = pushCmd(CMD_POLYLINE, brush);
+  cmd.pts_offset = m_pts_x.size();
+  cmd.pts_num = pts.size;
+  cmd.closed = closed;
+  m_pts_x.insert(m_pts_x.end(), pts.x, pts.x + pts.size);
+  m_pts_y.insert(m_pts_y.end(), pts.y, pts.y + pts.size);
+}
+
+void Overlay::addPoints(const cvtdl_pts_t &pts, const uint32_t radius,
+                        const cvtdl_service_brush_t &brush) {
+  if (pts.size == 0) return;
+  overlay_cmd_t &cmd = pushCmd(CMD_POINTS, brush);
+  cmd.thickness = std::max(static_cast<int>(radius), 1);
+  cmd.pts_offset = m_pts_x.size();
+  cmd.pts_num = pts.size;
+  m_pts_x.insert(m_pts_x.end(), pts.x, pts.x + pts.size);
+  m_pts_y.insert(m_pts_y.end(), pts.y, pts.y + pts.size);
+}
+
+void Overlay::addText(const char *text, const int x, const int y,
+                      const cvtdl_service_brush_t &brush) {
+  if (text == NULL || text[0] == '\0') return;
+  overlay_cmd_t &cmd = pushCmd(CMD_TEXT, brush);
+  cmd.bbox.x1 = x;
+  cmd.bbox.y1 = y;
+  cmd.pts_offset = m_text.size();
+  cmd.pts_num = strlen(text);
+  m_text.append(text, cmd.pts_num);
+}
+
+void Overlay::addPose17(const cvtdl_object_t *meta, const float score_threshold,
+                        const cvtdl_service_brush_t &brush) {
+  for (uint32_t i = 0; i < meta->size; i++) {
+    if (meta->info[i].pedestrian_properity == NULL) continue;
+    const cvtdl_pose17_meta_t &pose = meta->info[i].pedestrian_properity->pose_17;
+    float kx[18], ky[18], ks[18];
+    for (int k = 0; k < 17; k++) {
+      kx[k] = pose.x[k];
+      ky[k] = pose.y[k];
+      ks[k] = pose.score[k];
+    }
+    kx[17] = (kx[5] + kx[6]) / 2;
+    ky[17] = (ky[5] + ky[6]) / 2;
+    ks[17] = (ks[5] + ks[6]) / 2;
+
+    for (size_t l = 0; l < sizeof(POSE17_LIMBS) / sizeof(POSE17_LIMBS[0]); l++) {
+      int s = POSE17_LIMBS[l][0];
+      int e = POSE17_LIMBS[l][1];
+      if (ks[s] <= score_threshold || ks[e] <= score_threshold) continue;
+      float x[2] = {kx[s], kx[e]};
+      float y[2] = {ky[s], ky[e]};
+      cvtdl_pts_t limb = {x, y, 2, 0};
+      addPolyline(limb, false, brush);
+    }
+
+    float px[18], py[18];
+    uint32_t num = 0;
+    for (int k = 0; k < 18; k++) {
+      if (ks[k] <= score_threshold) continue;
+      px[num] = kx[k];
+      py[num] = ky[k];
+      num++;
+    }
+    cvtdl_pts_t points = {px, py, num, 0};
+    addPoints(points, brush.size, brush);
+  }
+}
+
+void Overlay::emitSpan(int y, int x1, int x2, uint32_t cmd_idx) {
+  if (y < 0 || y >= m_clip_h) return;
+  x1 = std::max(x1, 0);
+  x2 = std::min(x2, m_clip_w - 1);
+  if (x1 > x2) return;
+  m_spans.push_back({y, x1, x2, cmd_idx});
+}
+
+void Overlay::emitRect(int x1, int y1, int x2, int y2, int thickness, uint32_t cmd_idx) {
+  if (x2 < x1 || y2 < y1) return;
+  int t = std::min(thickness, std::min(x2 - x1 + 1, y2 - y1 + 1));
+  for (int y = y1; y < y1 + t; y++) emitSpan(y, x1, x2, cmd_idx);
+  for (int y = y1 + t; y <= y2 - t; y++) {
+    emitSpan(y, x1, x1 + t - 1, cmd_idx);
+    emitSpan(y, x2 - t + 1, x2, cmd_idx);
+  }
+  for (int y = std::max(y2 - t + 1, y1 + t); y <= y2; y++) emitSpan(y, x1, x2, cmd_idx);
+}
+
+void Overlay::emitDisc(float cx, float cy, float radius, uint32_t cmd_idx) {
+  int r = static_cast<int>(radius);
+  int icx = static_cast<int>(std::lround(cx));
+  int icy = static_cast<int>(std::lround(cy));
+  for (int dy = -r; dy <= r; dy++) {
+    int half = static_cast<int>(std::sqrt(static_cast<float>(r * r - dy * dy)));
+    emitSpan(icy + dy, icx - half, icx + half, cmd_idx);
+  }
+}
+
+void Overlay::emitSegment(float x1, float y1, float x2, float y2, float thickness,
+                          uint32_t cmd_idx) {
+  float dx = x2 - x1, dy = y2 - y1;
+  float len = std::sqrt(dx * dx + dy * dy);
+  float half = std::max(thickness, 1.f) / 2;
+  float nx = 0, ny = half;
+  if (len > 0) {
+    nx = -dy / len * half;
+    ny = dx / len * half;
+  }
+  /* thick segment as a convex quad, filled by per-row edge intersection */
+  const float qx[4] = {x1 + nx, x2 + nx, x2 - nx, x1 - nx};
+  const float qy[4] = {y1 + ny, y2 + ny, y2 - ny, y1 - ny};
+  float ymin = *std::min_element(qy, qy + 4);
+  float ymax = *std::max_element(qy, qy + 4);
+  int row_start = static_cast<int>(std::ceil(ymin));
+  int row_end = static_cast<int>(std::floor(ymax));
+  for (int y = row_start; y <= row_end; y++) {
+    float xmin = 1e9f, xmax = -1e9f;
+    for (int e = 0; e < 4; e++) {
+      float ax = qx[e], ay = qy[e];
+      float bx = qx[(e + 1) % 4], by = qy[(e + 1) % 4];
+      if ((y < ay && y < by) || (y > ay && y > by)) continue;
+      if (ay == by) {
+        xmin = std::min(xmin, std::min(ax, bx));
+        xmax = std::max(xmax, std::max(ax, bx));
+        continue;
+      }
+      float x = ax + (y - ay) * (bx - ax) / (by - ay);
+      xmin = std::min(xmin, x);
+      xmax = std::max(xmax, x);
+    }
+    if (xmin > xmax) continue;
+    int sx = static_cast<int>(std::floor(xmin + 0.5f));
+    int ex = std::max(static_cast<int>(std::floor(xmax - 0.5f)), sx);
+    emitSpan(y, sx, ex, cmd_idx);
+  }
+}
+
+void Overlay::emitText(const overlay_cmd_t &cmd, uint32_t cmd_idx) {
+  int scale = cmd.thickness;
+  int x = static_cast<int>(cmd.bbox.x1);
+  /* text baseline is at y, same as cv::putText */
+  int y = static_cast<int>(cmd.bbox.y1) - GLYPH_H * scale;
+  for (uint32_t c = 0; c < cmd.pts_num; c++, x += GLYPH_CELL_W * scale) {
+    unsigned char ch = m_text[cmd.pts_offset + c];
+    if (ch < GLYPH_FIRST || ch > GLYPH_LAST) ch = '?';
+    if (x >= m_clip_w) break;
+    const glyph_t &glyph = m_glyphs[ch - GLYPH_FIRST];
+    for (int row = 0; row < GLYPH_H; row++) {
+      const glyph_run_t *runs = &m_glyph_runs[glyph.run_offset[row]];
+      for (int s = 0; s < scale; s++) {
+        int py = y + row * scale + s;
+        for (int r = 0; r < glyph.run_num[row]; r++) {
+          int sx = x + runs[r].start * scale;
+          emitSpan(py, sx, sx + runs[r].len * scale - 1, cmd_idx);
+        }
+      }
+    }
+  }
+}
+
+void Overlay::rasterize(const overlay_cmd_t &cmd, uint32_t cmd_idx, int width, int height) {
+  switch (cmd.type) {
+    case CMD_RECT:
+    case CMD_TEXT: {
+      overlay_cmd_t local = cmd;
+      if (cmd.src_width != 0 && cmd.src_height != 0) {
+        local.bbox = box_rescale(width, height, cmd.src_width, cmd.src_height, cmd.bbox,
+                                 cmd.rescale_type);
+      }
+      if (cmd.type == CMD_TEXT) {
+        emitText(local, cmd_idx);
+      } else {
+        emitRect(static_cast<int>(local.bbox.x1), static_cast<int>(local.bbox.y1),
+                 static_cast<int>(local.bbox.x2), static_cast<int>(local.bbox.y2), cmd.thickness,
+                 cmd_idx);
+      }
+    } break;
+    case CMD_POLYLINE: {
+      const float *x = &m_pts_x[cmd.pts_offset];
+      const float *y = &m_pts_y[cmd.pts_offset];
+      uint32_t seg_num = cmd.closed ? cmd.pts_num : cmd.pts_num - 1;
+      for (uint32_t i = 0; i < seg_num; i++) {
+        uint32_t j = (i + 1) % cmd.pts_num;
+        emitSegment(x[i], y[i], x[j], y[j], cmd.thickness, cmd_idx);
+      }
+      /* round joints so thick polylines have no notches */
+      if (cmd.thickness > 2) {
+        for (uint32_t i = 0; i < cmd.pts_num; i++) {
+          emitDisc(x[i], y[i], cmd.thickness / 2.f, cmd_idx);
+        }
+      }
+    } break;
+    case CMD_POINTS: {
+      for (uint32_t i = 0; i < cmd.pts_num; i++) {
+        emitDisc(m_pts_x[cmd.pts_offset + i], m_pts_y[cmd.pts_offset + i], cmd.thickness,
+                 cmd_idx);
+      }
+    } break;
+  }
+}
+
+void Overlay::fillLuma(uint8_t *plane, uint32_t stride) {
+  for (const span_t &s : m_spans) {
+    memset(plane + s.y * stride + s.x1, m_cmds[s.cmd_idx].color[0], s.x2 - s.x1 + 1);
+  }
+}
+
+void Overlay::fillChroma(uint8_t *plane, uint32_t stride, int channel) {
+  for (const span_t &s : m_spans) {
+    int x1 = s.x1 >> 1;
+    memset(plane + (s.y >> 1) * stride + x1, m_cmds[s.cmd_idx].color[channel],
+           (s.x2 >> 1) - x1 + 1);
+  }
+}
+
+void Overlay::fillChromaInterleaved(uint8_t *plane, uint32_t stride, int first, int second) {
+  for (const span_t &s : m_spans) {
+    const uint8_t *color = m_cmds[s.cmd_idx].color;
+    uint16_t pair;
+    uint8_t *bytes = reinterpret_cast<uint8_t *>(&pair);
+    bytes[0] = color[first];
+    bytes[1] = color[second];
+    uint16_t *row = reinterpret_cast<uint16_t *>(plane + (s.y >> 1) * stride);
+    std::fill(row + (s.x1 >> 1), row + (s.x2 >> 1) + 1, pair);
+  }
+}
+
+int Overlay::render(VIDEO_FRAME_INFO_S *frame) {
+  PIXEL_FORMAT_E format = frame->stVFrame.enPixelFormat;
+  if (format != PIXEL_FORMAT_NV21 && format != PIXEL_FORMAT_NV12 &&
+      format != PIXEL_FORMAT_YUV_PLANAR_420) {
+    LOGE("Only PIXEL_FORMAT_NV21, PIXEL_FORMAT_NV12 and PIXEL_FORMAT_YUV_PLANAR_420 are supported "
+         "in Overlay\n");
+    return CVI_TDL_FAILURE;
+  }
+  if (m_cmds.empty()) {
+    return CVI_TDL_SUCCESS;
+  }
+
+  m_clip_w = frame->stVFrame.u32Width;
+  m_clip_h = frame->stVFrame.u32Height;
+  m_spans.clear();
+  for (uint32_t i = 0; i < m_cmds.size(); i++) {
+    rasterize(m_cmds[i], i, m_clip_w, m_clip_h);
+  }
+  /* row order keeps plane writes sequential, stable sort keeps command order within a row */
+  std::stable_sort(m_spans.begin(), m_spans.end(),
+                   [](const span_t &a, const span_t &b) { return a.y < b.y; });
+
+  size_t image_size =
+      frame->stVFrame.u32Length[0] + frame->stVFrame.u32Length[1] + frame->stVFrame.u32Length[2];
+  bool do_unmap = false;
+  if (frame->stVFrame.pu8VirAddr[0] == NULL) {
+    frame->stVFrame.pu8VirAddr[0] =
+        (uint8_t *)CVI_SYS_Mmap(frame->stVFrame.u64PhyAddr[0], image_size);
+    frame->stVFrame.pu8VirAddr[1] = frame->stVFrame.pu8VirAddr[0] + frame->stVFrame.u32Length[0];
+    frame->stVFrame.pu8VirAddr[2] = frame->stVFrame.pu8VirAddr[1] + frame->stVFrame.u32Length[1];
+    do_unmap = true;
+  }
+
+  fillLuma(frame->stVFrame.pu8VirAddr[0], frame->stVFrame.u32Stride[0]);
+  if (format == PIXEL_FORMAT_NV21) {
+    fillChromaInterleaved(frame->stVFrame.pu8VirAddr[1], frame->stVFrame.u32Stride[1], 2, 1);
+  } else if (format == PIXEL_FORMAT_NV12) {
+    fillChromaInterleaved(frame->stVFrame.pu8VirAddr[1], frame->stVFrame.u32Stride[1], 1, 2);
+  } else {
+    fillChroma(frame->stVFrame.pu8VirAddr[1], frame->stVFrame.u32Stride[1], 1);
+    fillChroma(frame->stVFrame.pu8VirAddr[2], frame->stVFrame.u32Stride[2], 2);
+  }
+
+  CVI_SYS_IonFlushCache(frame->stVFrame.u64PhyAddr[0], frame->stVFrame.pu8VirAddr[0], image_size);
+  if (do_unmap) {
+    CVI_SYS_Munmap((void *)frame->stVFrame.pu8VirAddr[0], image_size);
+    frame->stVFrame.pu8VirAddr[0] = NULL;
+    frame->stVFrame.pu8VirAddr[1] = NULL;
+    frame->stVFrame.pu8VirAddr[2] = NULL;
+  }
+  return CVI_TDL_SUCCESS;
+}
+
+}  // namespace service
+}  // namespace cvitdl
@@ -0,0 +1,102 @@
+/** Batched overlay renderer
+ *    Primitives are queued as commands and rasterized into horizontal spans. A single
+ *    Render() call maps the frame once and fills every plane span-by-span, so annotating
+ *    many objects costs one mmap/flush instead of one per primitive.
+ */
+#pragma once
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "core/face/cvtdl_face_types.h"
+#include "core/object/cvtdl_object_types.h"
+#include "cvi_comm.h"
+#include "service/cvi_tdl_service_types.h"
+
+namespace cvitdl {
+namespace service {
+
+class Overlay {
+ public:
+  Overlay();
+  ~Overlay() = default;
+
+  /* drop all queued commands, keep allocated capacity */
+  void clear();
+  uint32_t size() const { return m_cmds.size(); }
+
+  void addRect(const cvtdl_bbox_t &bbox, const cvtdl_service_brush_t &brush);
+  template <typename T>
+  void addMeta(const T *meta, const bool draw_text, const cvtdl_service_brush_t &brush);
+  void addPolyline(const cvtdl_pts_t &pts, const bool closed, const cvtdl_service_brush_t &brush);
+  void addPoints(const cvtdl_pts_t &pts, const uint32_t radius, const cvtdl_service_brush_t &brush);
+  /* brush.size is used as integer glyph scale (glyph cell is 6x8 pixels at scale 1) */
+  void addText(const char *text, const int x, const int y, const cvtdl_service_brush_t &brush);
+  void addPose17(const cvtdl_object_t *meta, const float score_threshold,
+                 const cvtdl_service_brush_t &brush);
+
+  int render(VIDEO_FRAME_INFO_S *frame);
+
+ private:
+  typedef enum { CMD_RECT, CMD_POLYLINE, CMD_POINTS, CMD_TEXT } cmd_type_e;
+
+  typedef struct {
+    cmd_type_e type;
+    uint8_t color[3];  // y, u, v
+    int thickness;
+    cvtdl_bbox_t bbox;
+    /* source resolution of bbox, 0 means bbox is already in frame coordinate */
+    uint32_t src_width;
+    uint32_t src_height;
+    meta_rescale_type_e rescale_type;
+    uint32_t pts_offset;
+    uint32_t pts_num;
+    bool closed;
+  } overlay_cmd_t;
+
+  typedef struct {
+    int y;
+    int x1;
+    int x2;  // inclusive
+    uint32_t cmd_idx;
+  } span_t;
+
+  /* glyph rows decomposed into runs of set pixels */
+  typedef struct {
+    uint8_t start;
+    uint8_t len;
+  } glyph_run_t;
+
+  typedef struct {
+    uint16_t run_offset[8];
+    uint8_t run_num[8];
+  } glyph_t;
+
+  overlay_cmd_t &pushCmd(cmd_type_e type, const cvtdl_service_brush_t &brush);
+  void buildGlyphAtlas();
+
+  void rasterize(const overlay_cmd_t &cmd, uint32_t cmd_idx, int width, int height);
+  void emitSpan(int y, int x1, int x2, uint32_t cmd_idx);
+  void emitRect(int x1, int y1, int x2, int y2, int thickness, uint32_t cmd_idx);
+  void emitDisc(float cx, float cy, float radius, uint32_t cmd_idx);
+  void emitSegment(float x1, float y1, float x2, float y2, float thickness, uint32_t cmd_idx);
+  void emitText(const overlay_cmd_t &cmd, uint32_t cmd_idx);
+
+  void fillLuma(uint8_t *plane, uint32_t stride);
+  void fillChroma(uint8_t *plane, uint32_t stride, int channel);
+  void fillChromaInterleaved(uint8_t *plane, uint32_t stride, int first, int second);
+
+  std::vector<overlay_cmd_t> m_cmds;
+  std::vector<float> m_pts_x;
+  std::vector<float> m_pts_y;
+  std::string m_text;
+  std::vector<span_t> m_spans;
+
+  std::vector<glyph_t> m_glyphs;
+  std::vector<glyph_run_t> m_glyph_runs;
+
+  int m_clip_w = 0;
+  int m_clip_h = 0;
+};
+
+}  // namespace service
+}  // namespace cvitdl
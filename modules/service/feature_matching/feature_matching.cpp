@@ -1,5 +1,6 @@
 #include "feature_matching.hpp"
 #include "core/core/cvtdl_errno.h"
+#include "trace.hpp"
 
 #include <cvimath/cvimath_internal.h>
 #include <cviruntime.h>
@@ -89,6 +90,8 @@ FeatureMatching::~FeatureMatching() {
   FreeFeatureArrayExt(&m_cpu_ipfeature);
   FreeFeatureArrayTpuExt(m_rt_handle, &m_tpu_ipfeature);
   destroyHandle(m_rt_handle, m_cvk_ctx);
+  m_mem_account.set(CVI_TDL_MEM_HEAP, 0);
+  m_mem_account.set(CVI_TDL_MEM_ION, 0);
 }
 
 int FeatureMatching::init() {
@@ -155,6 +158,7 @@ int FeatureMatching::registerData(const cvtdl_service_feature_array_t &feature_a
 
 int FeatureMatching::run(const void *feature, const feature_type_e &type, const uint32_t topk,
                          uint32_t *indices, float *scores, uint32_t *size, float threshold) {
+  TraceScope trace("feature_matching", "service");
   int ret = CVI_TDL_SUCCESS;
   switch (m_matching_method) {
     case COS_SIMILARITY: {
@@ -224,6 +228,18 @@ int FeatureMatching::cosSimilarityRegister(const cvtdl_service_feature_array_t &
     CVI_RT_MemFlush(m_rt_handle, info.rtmem);
   }
 
+  // the registered array itself stays owned by the caller on the CPU path
+  uint64_t heap_bytes = (uint64_t)total_length * sizeof(float);
+  uint64_t ion_bytes = 0;
+  if (m_is_cpu) {
+    heap_bytes += (uint64_t)total_length * sizeof(float);
+  } else {
+    heap_bytes += (uint64_t)feature_array.data_num * (sizeof(uint32_t) + sizeof(float));
+    ion_bytes = feature_array.feature_length + total_length +
+                (uint64_t)feature_array.data_num * sizeof(uint32_t);
+  }
+  m_mem_account.set(CVI_TDL_MEM_HEAP, heap_bytes);
+  m_mem_account.set(CVI_TDL_MEM_ION, ion_bytes);
   return CVI_TDL_SUCCESS;
 }
 
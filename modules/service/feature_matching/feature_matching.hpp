@@ -1,6 +1,7 @@
 #pragma once
 
 #include "cvi_tdl_log.hpp"
+#include "mem_account.hpp"
 #include "service/cvi_tdl_service_types.h"
 
 #include <cvikernel/cvikernel.h>
@@ -46,6 +47,7 @@ class FeatureMatching {
 
   int run(const void *feature, const feature_type_e &type, const uint32_t k, uint32_t *indices,
           float *scores, uint32_t *size, float threshold);
+  MemAccount &getMemAccount() { return m_mem_account; }
 
  private:
   int cosSimilarityRegister(const cvtdl_service_feature_array_t &feature_array);
@@ -60,6 +62,7 @@ class FeatureMatching {
   cvtdl_service_feature_array_tpu_ext_t m_tpu_ipfeature;
   cvtdl_service_feature_array_ext_t m_cpu_ipfeature;
   uint32_t m_data_num;
+  MemAccount m_mem_account{"feature matching"};
 };
 }  // namespace service
 }  // namespace cvitdl
@@ -1,38 +1,196 @@
 #include "tracker.hpp"
 #include <string.h>
+#include <cmath>
+#include <utility>
 #include "core/core/cvtdl_errno.h"
 #include "core/cvi_tdl_types_mem.h"
 #include "core/cvi_tdl_types_mem_internal.h"
 
 namespace cvitdl {
 namespace service {
+Tracker::Tracker(uint32_t max_ids, uint32_t history_len)
+    : m_history_len(history_len == 0 ? 1 : history_len) {
+  if (max_ids == 0) max_ids = 1;
+  m_trajectories.resize(max_ids);
+  m_samples.resize((size_t)max_ids * m_history_len);
+  m_free.reserve(max_ids);
+  for (uint32_t i = max_ids; i > 0; i--) {
+    m_free.push_back(i - 1);
+  }
+  m_heap.reserve(max_ids);
+  m_index.reserve(max_ids);
+}
+
 int Tracker::registerId(const CVI_U64 &timestamp, const int64_t &id, const float x, const float y) {
   m_timestamp = timestamp;
-  tracker_pts_t pts;
-  pts.x = x;
-  pts.y = y;
-  m_tracker[id].push_back({m_timestamp, pts});
-
-  auto it = m_tracker.begin();
-  while (it != m_tracker.end()) {
-    auto &vec = it->second;
-    if ((m_timestamp - vec[vec.size() - 1].first) > m_deleteduration) {
-      it = m_tracker.erase(it);
-    } else {
-      ++it;
+  uint32_t slot;
+  auto it = m_index.find(id);
+  if (it != m_index.end()) {
+    slot = it->second;
+  } else {
+    if (m_free.empty()) removeSlot(m_heap[0]);
+    slot = m_free.back();
+    m_free.pop_back();
+    Trajectory &t = m_trajectories[slot];
+    t.id = id;
+    t.last_timestamp = timestamp;
+    t.head = 0;
+    t.count = 0;
+    t.heap_index = m_heap.size();
+    m_heap.push_back(slot);
+    siftUp(t.heap_index);
+    m_index[id] = slot;
+  }
+
+  Trajectory &t = m_trajectories[slot];
+  Sample &s = m_samples[(size_t)slot * m_history_len + t.head];
+  s.timestamp = timestamp;
+  s.pts.x = x;
+  s.pts.y = y;
+  t.head = t.head + 1 == m_history_len ? 0 : t.head + 1;
+  if (t.count < m_history_len) t.count++;
+  bool older = timestamp < t.last_timestamp;
+  t.last_timestamp = timestamp;
+  if (older) {
+    siftUp(t.heap_index);
+  } else {
+    siftDown(t.heap_index);
+  }
+
+  while (!m_heap.empty()) {
+    const Trajectory &oldest = m_trajectories[m_heap[0]];
+    if (m_timestamp < oldest.last_timestamp ||
+        (m_timestamp - oldest.last_timestamp) <= m_deleteduration) {
+      break;
     }
+    removeSlot(m_heap[0]);
   }
   return CVI_TDL_SUCCESS;
 }
+
 int Tracker::getLatestPos(const int64_t &id, float *x, float *y) {
-  auto it = m_tracker.find(id);
-  if (it != m_tracker.end()) {
-    auto &vec = it->second;
-    *x = vec[vec.size() - 1].second.x;
-    *y = vec[vec.size() - 1].second.y;
+  auto it = m_index.find(id);
+  if (it != m_index.end()) {
+    const Sample &s = sample(it->second, 0);
+    *x = s.pts.x;
+    *y = s.pts.y;
     return CVI_TDL_SUCCESS;
   }
   return CVI_TDL_FAILURE;
 }
+
+int Tracker::getPositions(const int64_t &id, const CVI_U64 &duration, float *x, float *y,
+                          uint64_t *timestamps, uint32_t max_num, uint32_t *num) {
+  auto it = m_index.find(id);
+  if (it == m_index.end()) {
+    *num = 0;
+    return CVI_TDL_FAILURE;
+  }
+  uint32_t count = windowCount(it->second, duration);
+  if (count > max_num) count = max_num;
+  for (uint32_t i = 0; i < count; i++) {
+    const Sample &s = sample(it->second, count - 1 - i);
+    if (x != nullptr) x[i] = s.pts.x;
+    if (y != nullptr) y[i] = s.pts.y;
+    if (timestamps != nullptr) timestamps[i] = s.timestamp;
+  }
+  *num = count;
+  return CVI_TDL_SUCCESS;
+}
+
+int Tracker::getVelocity(const int64_t &id, const CVI_U64 &duration, float *vx, float *vy) {
+  float dx, dy, dt;
+  int ret = windowDisplacement(id, duration, &dx, &dy, &dt);
+  if (ret != CVI_TDL_SUCCESS) return ret;
+  *vx = dx * 1000.f / dt;
+  *vy = dy * 1000.f / dt;
+  return CVI_TDL_SUCCESS;
+}
+
+int Tracker::getHeading(const int64_t &id, const CVI_U64 &duration, float *heading) {
+  float dx, dy, dt;
+  int ret = windowDisplacement(id, duration, &dx, &dy, &dt);
+  if (ret != CVI_TDL_SUCCESS) return ret;
+  *heading = std::atan2(dy, dx);
+  return CVI_TDL_SUCCESS;
+}
+
+const Tracker::Sample &Tracker::sample(uint32_t slot, uint32_t i) const {
+  uint32_t head = m_trajectories[slot].head;
+  uint32_t pos = head > i ? head - 1 - i : head + m_history_len - 1 - i;
+  return m_samples[(size_t)slot * m_history_len + pos];
+}
+
+uint32_t Tracker::windowCount(uint32_t slot, const CVI_U64 &duration) const {
+  CVI_U64 since = m_timestamp > duration ? m_timestamp - duration : 0;
+  uint32_t count = 0;
+  while (count < m_trajectories[slot].count && sample(slot, count).timestamp >= since) {
+    count++;
+  }
+  return count;
+}
+
+// between the oldest and the latest position of the window, fails without two distinct times
+int Tracker::windowDisplacement(const int64_t &id, const CVI_U64 &duration, float *dx, float *dy,
+                                float *dt) {
+  auto it = m_index.find(id);
+  if (it == m_index.end()) return CVI_TDL_FAILURE;
+  uint32_t count = windowCount(it->second, duration);
+  if (count < 2) return CVI_TDL_FAILURE;
+  const Sample &last = sample(it->second, 0);
+  const Sample &first = sample(it->second, count - 1);
+  if (last.timestamp <= first.timestamp) return CVI_TDL_FAILURE;
+  *dx = last.pts.x - first.pts.x;
+  *dy = last.pts.y - first.pts.y;
+  *dt = (float)(last.timestamp - first.timestamp);
+  return CVI_TDL_SUCCESS;
+}
+
+void Tracker::removeSlot(uint32_t slot) {
+  uint32_t i = m_trajectories[slot].heap_index;
+  uint32_t last = m_heap.size() - 1;
+  if (i != last) heapSwap(i, last);
+  m_heap.pop_back();
+  if (i != last) {
+    siftUp(i);
+    siftDown(i);
+  }
+  m_index.erase(m_trajectories[slot].id);
+  m_free.push_back(slot);
+}
+
+void Tracker::heapSwap(uint32_t a, uint32_t b) {
+  std::swap(m_heap[a], m_heap[b]);
+  m_trajectories[m_heap[a]].heap_index = a;
+  m_trajectories[m_heap[b]].heap_index = b;
+}
+
+void Tracker::siftUp(uint32_t i) {
+  while (i > 0) {
+    uint32_t parent = (i - 1) / 2;
+    if (m_trajectories[m_heap[parent]].last_timestamp <=
+        m_trajectories[m_heap[i]].last_timestamp) {
+      break;
+    }
+    heapSwap(i, parent);
+    i = parent;
+  }
+}
+
+void Tracker::siftDown(uint32_t i) {
+  uint32_t n = m_heap.size();
+  while (true) {
+    uint32_t smallest = i;
+    for (uint32_t child = 2 * i + 1; child <= 2 * i + 2 && child < n; child++) {
+      if (m_trajectories[m_heap[child]].last_timestamp <
+          m_trajectories[m_heap[smallest]].last_timestamp) {
+        smallest = child;
+      }
+    }
+    if (smallest == i) break;
+    heapSwap(i, smallest);
+    i = smallest;
+  }
+}
 }  // namespace service
-}  // namespace cvitdl
\ No newline at end of file
+}  // namespace cvitdl
@@ -1,7 +1,6 @@
 #pragma once
-#include <map>
-#include <string>
-#include <utility>
+#include <stdint.h>
+#include <unordered_map>
 #include <vector>
 #include "cvi_comm.h"
 
@@ -13,15 +12,61 @@ typedef struct {
   float y;
 } tracker_pts_t;
 
+/**
+ * Trajectories of tracked ids, timestamps in milliseconds.
+ *
+ * Every id keeps its latest history_len positions in a ring buffer of a fixed pool, at most
+ * max_ids ids at a time. An id not registered for the delete duration expires, the ids are
+ * kept in a min-heap on their last timestamp so registerId only visits the expired ones. When
+ * the pool is full the id registered least recently is dropped for the new one.
+ */
 class Tracker {
  public:
+  explicit Tracker(uint32_t max_ids = 256, uint32_t history_len = 64);
+
   int registerId(const CVI_U64 &timestamp, const int64_t &id, const float x, const float y);
   int getLatestPos(const int64_t &id, float *x, float *y);
+  /* latest max_num positions of the last duration ms before the latest registration, oldest
+   * first */
+  int getPositions(const int64_t &id, const CVI_U64 &duration, float *x, float *y,
+                   uint64_t *timestamps, uint32_t max_num, uint32_t *num);
+  /* displacement per second over the last duration ms */
+  int getVelocity(const int64_t &id, const CVI_U64 &duration, float *vx, float *vy);
+  /* direction of the displacement over the last duration ms, atan2(dy, dx) in radians */
+  int getHeading(const int64_t &id, const CVI_U64 &duration, float *heading);
+  void setDeleteDuration(const CVI_U64 &duration) { m_deleteduration = duration; }
+  uint32_t size() const { return m_heap.size(); }
 
  private:
-  std::map<int64_t, std::vector<std::pair<CVI_U64, tracker_pts_t>>> m_tracker;
-  CVI_U64 m_timestamp;
-  CVI_U64 m_deleteduration = 3000;  // 3ms
+  struct Trajectory {
+    int64_t id;
+    CVI_U64 last_timestamp;
+    uint32_t heap_index;
+    uint32_t head;  // next sample to write
+    uint32_t count;
+  };
+  struct Sample {
+    CVI_U64 timestamp;
+    tracker_pts_t pts;
+  };
+
+  const Sample &sample(uint32_t slot, uint32_t i) const;  // i = 0 is the latest one
+  uint32_t windowCount(uint32_t slot, const CVI_U64 &duration) const;
+  int windowDisplacement(const int64_t &id, const CVI_U64 &duration, float *dx, float *dy,
+                         float *dt);
+  void removeSlot(uint32_t slot);
+  void heapSwap(uint32_t a, uint32_t b);
+  void siftUp(uint32_t i);
+  void siftDown(uint32_t i);
+
+  uint32_t m_history_len;
+  std::vector<Trajectory> m_trajectories;
+  std::vector<Sample> m_samples;  // m_history_len per trajectory
+  std::vector<uint32_t> m_free;
+  std::vector<uint32_t> m_heap;  // slots, the oldest last_timestamp on top
+  std::unordered_map<int64_t, uint32_t> m_index;
+  CVI_U64 m_timestamp = 0;
+  CVI_U64 m_deleteduration = 3000;  // 3s
 };
 }  // namespace service
 }  // namespace cvitdl
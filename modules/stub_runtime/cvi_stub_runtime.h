@@ -0,0 +1,49 @@
+#ifndef _CVI_STUB_RUNTIME_H_
+#define _CVI_STUB_RUNTIME_H_
+#include <stdint.h>
+
+/**
+ * CPU stub of the TPU runtime (CVI_NN_*) and of the SYS/VB/VPSS MPI used by the TDL SDK, built
+ * with -DUSE_STUB_RUNTIME=ON to run whole pipelines on a workstation.
+ *
+ * A model file is a text descriptor instead of a cvimodel, one statement per line, '#' comments:
+ *
+ *   input  <name> <fp32|bf16|int8|uint8|int16|int32> <dims...> [qscale <q>]
+ *   output <name> <fmt> <dims...> [qscale <q>] [range <lo> <hi>] [spikes <ratio> <value>]
+ *   replay <dir>       outputs are read from <dir>/<tensor>_<n>.bin, cycling over n
+ *   seed <n>           seed of the synthesized outputs
+ *   latency_us <n>     sleep in CVI_NN_Forward to emulate the TPU time, forwards of all the
+ *                      models are serialized like on the single TPU of the SoC
+ *
+ * Outputs without replay files are synthesized: uniform values in [lo, hi] (in the unit of the
+ * tensor, default [0, 1] for float and [-128, 127] for int8), a ratio of which is overwritten by
+ * value. The values only depend on the seed, the tensor name and the forward count. '/' in
+ * tensor names is replaced by '_' in replay file names.
+ *
+ * Physical addresses are host pointers. VPSS crop, aspect ratio, bilinear resize, color
+ * conversion and normalization run on the CPU when a frame is sent, IVE and GDC are not
+ * emulated.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Time spent in the emulation, to be subtracted from the measured pipeline time. */
+typedef struct {
+  uint64_t forward_count;
+  uint64_t forward_us;  // CVI_NN_Forward and CVI_NN_FeedTensorWithFrames, latency_us included
+  uint64_t vpss_count;
+  uint64_t vpss_us;  // CVI_VPSS_SendFrame
+  uint64_t ion_bytes;
+  uint64_t ion_peak_bytes;
+} cvi_stub_stats_t;
+
+void CVI_STUB_GetStats(cvi_stub_stats_t *stats);
+void CVI_STUB_ResetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+#include <stdint.h>
+#include <chrono>
+
+namespace cvistub {
+
+inline uint64_t now_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void add_forward_time(uint64_t us, bool count);
+void add_vpss_time(uint64_t us);
+
+}  // namespace cvistub
@@ -0,0 +1,731 @@
+#include <cvi_buffer.h>
+#include <cvi_gdc.h>
+#include <cvi_sys.h>
+#include <cvi_vb.h>
+#include <cvi_vpss.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "cvi_comm.h"
+#include "cvi_stub_runtime.h"
+#include "cvi_tdl_log.hpp"
+#include "stub_common.hpp"
+
+namespace {
+
+std::mutex g_mutex;
+cvi_stub_stats_t g_stats;
+VPSS_MODE_E g_vpss_mode = VPSS_MODE_SINGLE;
+// size of the ion buffers by address, physical addresses are host pointers
+std::unordered_map<uint64_t, uint32_t> g_ion;
+
+struct VbBlock {
+  uint64_t addr;
+  uint32_t size;
+  VB_POOL pool;
+};
+std::unordered_map<VB_BLK, VbBlock> g_vb;
+VB_BLK g_next_blk = 1;
+
+struct StubChn {
+  bool enabled = false;
+  VPSS_CHN_ATTR_S attr;
+  VPSS_CROP_INFO_S crop;
+  std::deque<VIDEO_FRAME_INFO_S> frames;
+};
+
+struct StubGrp {
+  bool created = false;
+  VPSS_GRP_ATTR_S attr;
+  VPSS_CROP_INFO_S crop;
+  StubChn chn[VPSS_MAX_CHN_NUM];
+};
+StubGrp g_grp[VPSS_MAX_GRP_NUM];
+
+void *ion_alloc(uint32_t size, uint64_t *addr) {
+  void *ptr = aligned_alloc(DEFAULT_ALIGN, ALIGN(size, DEFAULT_ALIGN));
+  if (ptr == nullptr) return nullptr;
+  *addr = reinterpret_cast<uint64_t>(ptr);
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_ion[*addr] = size;
+  g_stats.ion_bytes += size;
+  g_stats.ion_peak_bytes = std::max(g_stats.ion_peak_bytes, g_stats.ion_bytes);
+  return ptr;
+}
+
+CVI_S32 ion_free(uint64_t addr) {
+  {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    auto it = g_ion.find(addr);
+    if (it == g_ion.end()) {
+      LOGE("free of unknown ion address 0x%" PRIx64 "\n", addr);
+      return CVI_FAILURE;
+    }
+    g_stats.ion_bytes -= it->second;
+    g_ion.erase(it);
+  }
+  free(reinterpret_cast<void *>(addr));
+  return CVI_SUCCESS;
+}
+
+bool valid_chn(VPSS_GRP grp, VPSS_CHN chn) {
+  return grp >= 0 && grp < VPSS_MAX_GRP_NUM && chn >= 0 && chn < VPSS_MAX_CHN_NUM;
+}
+
+/* queued frames of the group, to be freed after the lock is released */
+void take_frames(StubGrp *grp, std::vector<uint64_t> *addrs) {
+  for (auto &chn : grp->chn) {
+    for (auto &frame : chn.frames) addrs->push_back(frame.stVFrame.u64PhyAddr[0]);
+    chn.frames.clear();
+  }
+}
+
+/* frame layout of CREATE_ION_HELPER, BGR planar like RGB planar */
+CVI_S32 alloc_frame(uint32_t width, uint32_t height, PIXEL_FORMAT_E format,
+                    VIDEO_FRAME_INFO_S *frame) {
+  memset(frame, 0, sizeof(*frame));
+  VIDEO_FRAME_S *f = &frame->stVFrame;
+  f->enPixelFormat = format;
+  f->enVideoFormat = VIDEO_FORMAT_LINEAR;
+  f->enCompressMode = COMPRESS_MODE_NONE;
+  f->u32Width = width;
+  f->u32Height = height;
+  const uint32_t h2 = ALIGN(height, 2);
+  switch (format) {
+    case PIXEL_FORMAT_RGB_888:
+    case PIXEL_FORMAT_BGR_888:
+      f->u32Stride[0] = ALIGN(width * 3, DEFAULT_ALIGN);
+      f->u32Length[0] = f->u32Stride[0] * height;
+      break;
+    case PIXEL_FORMAT_RGB_888_PLANAR:
+    case PIXEL_FORMAT_BGR_888_PLANAR:
+      for (int i = 0; i < 3; i++) {
+        f->u32Stride[i] = ALIGN(width, DEFAULT_ALIGN);
+        f->u32Length[i] = ALIGN(f->u32Stride[i] * height, 0x1000);
+      }
+      break;
+    case PIXEL_FORMAT_YUV_PLANAR_420:
+      f->u32Stride[0] = ALIGN(width, DEFAULT_ALIGN);
+      f->u32Stride[1] = f->u32Stride[2] = ALIGN(width >> 1, DEFAULT_ALIGN);
+      f->u32Length[0] = ALIGN(f->u32Stride[0] * h2, 0x1000);
+      f->u32Length[1] = f->u32Length[2] = ALIGN(f->u32Stride[1] * h2 / 2, 0x1000);
+      break;
+    case PIXEL_FORMAT_YUV_PLANAR_422:
+      f->u32Stride[0] = ALIGN(width, DEFAULT_ALIGN);
+      f->u32Stride[1] = f->u32Stride[2] = ALIGN(width >> 1, DEFAULT_ALIGN);
+      f->u32Length[0] = ALIGN(f->u32Stride[0] * height, 0x1000);
+      f->u32Length[1] = f->u32Length[2] = ALIGN(f->u32Stride[1] * height, 0x1000);
+      break;
+    case PIXEL_FORMAT_YUV_400:
+      f->u32Stride[0] = ALIGN(width, DEFAULT_ALIGN);
+      f->u32Length[0] = f->u32Stride[0] * height;
+      break;
+    case PIXEL_FORMAT_NV12:
+    case PIXEL_FORMAT_NV21:
+      f->u32Stride[0] = f->u32Stride[1] = ALIGN(width, DEFAULT_ALIGN);
+      f->u32Length[0] = ALIGN(f->u32Stride[0] * height, 0x1000);
+      f->u32Length[1] = ALIGN(f->u32Stride[0] * h2 / 2, 0x1000);
+      break;
+    default:
+      LOGE("stub vpss does not support output format %d\n", format);
+      return CVI_ERR_VPSS_NOT_SUPPORT;
+  }
+  uint32_t size = f->u32Length[0] + f->u32Length[1] + f->u32Length[2];
+  uint64_t addr;
+  uint8_t *ptr = static_cast<uint8_t *>(ion_alloc(size, &addr));
+  if (ptr == nullptr) return CVI_ERR_VPSS_NOMEM;
+  for (int i = 0; i < 3; i++) {
+    f->u64PhyAddr[i] = addr;
+    f->pu8VirAddr[i] = ptr;
+    addr += f->u32Length[i];
+    ptr += f->u32Length[i];
+  }
+  return CVI_SUCCESS;
+}
+
+inline uint8_t clamp_u8(int v) { return (uint8_t)std::min(std::max(v, 0), 255); }
+
+/* BT.601 full range, 10 bit fixed point */
+inline void yuv2rgb(int y, int u, int v, uint8_t *rgb) {
+  u -= 128;
+  v -= 128;
+  rgb[0] = clamp_u8(y + ((1436 * v) >> 10));
+  rgb[1] = clamp_u8(y - ((352 * u + 731 * v) >> 10));
+  rgb[2] = clamp_u8(y + ((1815 * u) >> 10));
+}
+
+/* packed RGB of the pixels x0 <= x < x1 of row y */
+bool fetch_row(const VIDEO_FRAME_S &src, int y, int x0, int x1, uint8_t *rgb) {
+  const uint8_t *p0 = src.pu8VirAddr[0] + (size_t)y * src.u32Stride[0];
+  switch (src.enPixelFormat) {
+    case PIXEL_FORMAT_RGB_888:
+      memcpy(rgb, p0 + x0 * 3, (x1 - x0) * 3);
+      break;
+    case PIXEL_FORMAT_BGR_888:
+      for (int x = x0; x < x1; x++, rgb += 3) {
+        rgb[0] = p0[x * 3 + 2];
+        rgb[1] = p0[x * 3 + 1];
+        rgb[2] = p0[x * 3];
+      }
+      break;
+    case PIXEL_FORMAT_RGB_888_PLANAR:
+    case PIXEL_FORMAT_BGR_888_PLANAR: {
+      const bool bgr = src.enPixelFormat == PIXEL_FORMAT_BGR_888_PLANAR;
+      const uint8_t *p[3];
+      for (int c = 0; c < 3; c++) p[c] = src.pu8VirAddr[c] + (size_t)y * src.u32Stride[c];
+      for (int x = x0; x < x1; x++, rgb += 3) {
+        rgb[0] = p[bgr ? 2 : 0][x];
+        rgb[1] = p[1][x];
+        rgb[2] = p[bgr ? 0 : 2][x];
+      }
+    } break;
+    case PIXEL_FORMAT_YUV_400:
+      for (int x = x0; x < x1; x++, rgb += 3) rgb[0] = rgb[1] = rgb[2] = p0[x];
+      break;
+    case PIXEL_FORMAT_YUV_PLANAR_420:
+    case PIXEL_FORMAT_YUV_PLANAR_422: {
+      const int cy = src.enPixelFormat == PIXEL_FORMAT_YUV_PLANAR_420 ? y / 2 : y;
+      const uint8_t *pu = src.pu8VirAddr[1] + (size_t)cy * src.u32Stride[1];
+      const uint8_t *pv = src.pu8VirAddr[2] + (size_t)cy * src.u32Stride[2];
+      for (int x = x0; x < x1; x++, rgb += 3) yuv2rgb(p0[x], pu[x / 2], pv[x / 2], rgb);
+    } break;
+    case PIXEL_FORMAT_NV12:
+    case PIXEL_FORMAT_NV21: {
+      const int iu = src.enPixelFormat == PIXEL_FORMAT_NV12 ? 0 : 1;
+      const uint8_t *puv = src.pu8VirAddr[1] + (size_t)(y / 2) * src.u32Stride[1];
+      for (int x = x0; x < x1; x++, rgb += 3) {
+        const uint8_t *uv = puv + (x & ~1);
+        yuv2rgb(p0[x], uv[iu], uv[1 - iu], rgb);
+      }
+    } break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+struct Rect {
+  int x, y, w, h;
+};
+
+bool intersect(Rect *r, const RECT_S &crop, int ox, int oy) {
+  int x1 = std::max(r->x, crop.s32X + ox), y1 = std::max(r->y, crop.s32Y + oy);
+  int x2 = std::min(r->x + r->w, crop.s32X + ox + (int)crop.u32Width);
+  int y2 = std::min(r->y + r->h, crop.s32Y + oy + (int)crop.u32Height);
+  *r = {x1, y1, x2 - x1, y2 - y1};
+  return r->w > 0 && r->h > 0;
+}
+
+/*
+ * Group crop, channel crop (relative to the group crop), aspect ratio and bilinear resize into a
+ * packed RGB image of the channel size.
+ */
+CVI_S32 resize_rgb(const VIDEO_FRAME_S &src, const VPSS_CROP_INFO_S &grp_crop,
+                   const VPSS_CROP_INFO_S &chn_crop, const VPSS_CHN_ATTR_S &attr,
+                   std::vector<uint8_t> *rgb) {
+  Rect s = {0, 0, (int)src.u32Width, (int)src.u32Height};
+  if (grp_crop.bEnable && !intersect(&s, grp_crop.stCropRect, 0, 0)) {
+    return CVI_ERR_VPSS_ILLEGAL_PARAM;
+  }
+  if (chn_crop.bEnable && !intersect(&s, chn_crop.stCropRect, s.x, s.y)) {
+    return CVI_ERR_VPSS_ILLEGAL_PARAM;
+  }
+
+  const int ow = attr.u32Width, oh = attr.u32Height;
+  Rect d = {0, 0, ow, oh};
+  const ASPECT_RATIO_S &aspect = attr.stAspectRatio;
+  if (aspect.enMode == ASPECT_RATIO_AUTO) {
+    float scale = std::min((float)ow / s.w, (float)oh / s.h);
+    d.w = std::min(ow, (int)(s.w * scale + 0.5f));
+    d.h = std::min(oh, (int)(s.h * scale + 0.5f));
+    d.x = (ow - d.w) / 2;
+    d.y = (oh - d.h) / 2;
+  } else if (aspect.enMode == ASPECT_RATIO_MANUAL) {
+    d = {0, 0, ow, oh};
+    if (!intersect(&d, aspect.stVideoRect, 0, 0)) return CVI_ERR_VPSS_ILLEGAL_PARAM;
+  }
+
+  rgb->resize((size_t)ow * oh * 3);
+  uint8_t bg[3] = {0, 0, 0};
+  if (aspect.enMode != ASPECT_RATIO_NONE && aspect.bEnableBgColor) {
+    bg[0] = (aspect.u32BgColor >> 16) & 0xff;
+    bg[1] = (aspect.u32BgColor >> 8) & 0xff;
+    bg[2] = aspect.u32BgColor & 0xff;
+  }
+  if (d.w != ow || d.h != oh) {
+    for (size_t i = 0; i < rgb->size(); i += 3) memcpy(rgb->data() + i, bg, 3);
+  }
+
+  // half pixel centers, 8 bit weights
+  std::vector<int> xs(d.w * 2), wx(d.w);
+  for (int x = 0; x < d.w; x++) {
+    float fx = std::min(std::max((x + 0.5f) * s.w / d.w - 0.5f, 0.f), s.w - 1.f);
+    int ix = (int)fx;
+    xs[2 * x] = ix * 3;
+    xs[2 * x + 1] = std::min(ix + 1, s.w - 1) * 3;
+    wx[x] = (int)((fx - ix) * 256 + 0.5f);
+  }
+  if (attr.bMirror) {
+    for (int x = 0; x < d.w / 2; x++) {
+      std::swap(xs[2 * x], xs[2 * (d.w - 1 - x)]);
+      std::swap(xs[2 * x + 1], xs[2 * (d.w - 1 - x) + 1]);
+      std::swap(wx[x], wx[d.w - 1 - x]);
+    }
+  }
+
+  // the two source rows of the current output row, converted once
+  std::vector<uint8_t> rows[2] = {std::vector<uint8_t>(s.w * 3), std::vector<uint8_t>(s.w * 3)};
+  int cached[2] = {-1, -1};
+  for (int y = 0; y < d.h; y++) {
+    float fy = std::min(std::max((y + 0.5f) * s.h / d.h - 0.5f, 0.f), s.h - 1.f);
+    int iy[2] = {(int)fy, std::min((int)fy + 1, s.h - 1)};
+    const int wy = (int)((fy - iy[0]) * 256 + 0.5f);
+    for (int k = 0; k < 2; k++) {
+      if (cached[k] == iy[k]) continue;
+      if (cached[1 - k] == iy[k]) {
+        rows[k].swap(rows[1 - k]);
+        std::swap(cached[k], cached[1 - k]);
+        if (cached[k] == iy[k]) continue;
+      }
+      if (!fetch_row(src, s.y + iy[k], s.x, s.x + s.w, rows[k].data())) {
+        LOGE("stub vpss does not support input format %d\n", src.enPixelFormat);
+        return CVI_ERR_VPSS_NOT_SUPPORT;
+      }
+      cached[k] = iy[k];
+    }
+    const int oy = attr.bFlip ? d.y + d.h - 1 - y : d.y + y;
+    uint8_t *out = rgb->data() + ((size_t)oy * ow + d.x) * 3;
+    const uint8_t *r0 = rows[0].data(), *r1 = rows[1].data();
+    for (int x = 0; x < d.w; x++, out += 3) {
+      const int a = xs[2 * x], b = xs[2 * x + 1], w = wx[x];
+      for (int c = 0; c < 3; c++) {
+        int top = r0[a + c] * (256 - w) + r0[b + c] * w;
+        int bottom = r1[a + c] * (256 - w) + r1[b + c] * w;
+        out[c] = (uint8_t)((top * (256 - wy) + bottom * wy + (1 << 15)) >> 16);
+      }
+    }
+  }
+  return CVI_SUCCESS;
+}
+
+/* rgb (packed, frame size) into the frame, the 256 entry tables normalize each output plane */
+void store_frame(const std::vector<uint8_t> &rgb, const uint8_t lut[3][256],
+                 VIDEO_FRAME_INFO_S *frame) {
+  VIDEO_FRAME_S &f = frame->stVFrame;
+  const int w = f.u32Width, h = f.u32Height;
+  const bool bgr =
+      f.enPixelFormat == PIXEL_FORMAT_BGR_888 || f.enPixelFormat == PIXEL_FORMAT_BGR_888_PLANAR;
+  for (int y = 0; y < h; y++) {
+    const uint8_t *in = rgb.data() + (size_t)y * w * 3;
+    uint8_t *p0 = f.pu8VirAddr[0] + (size_t)y * f.u32Stride[0];
+    switch (f.enPixelFormat) {
+      case PIXEL_FORMAT_RGB_888:
+      case PIXEL_FORMAT_BGR_888:
+        for (int x = 0; x < w; x++) {
+          for (int c = 0; c < 3; c++) p0[x * 3 + c] = lut[c][in[x * 3 + (bgr ? 2 - c : c)]];
+        }
+        break;
+      case PIXEL_FORMAT_RGB_888_PLANAR:
+      case PIXEL_FORMAT_BGR_888_PLANAR:
+        for (int c = 0; c < 3; c++) {
+          uint8_t *p = f.pu8VirAddr[c] + (size_t)y * f.u32Stride[c];
+          const int ic = bgr ? 2 - c : c;
+          for (int x = 0; x < w; x++) p[x] = lut[c][in[x * 3 + ic]];
+        }
+        break;
+      default: {
+        // YUV outputs, chroma of the even rows and columns
+        for (int x = 0; x < w; x++) {
+          const uint8_t *px = in + x * 3;
+          p0[x] = lut[0][clamp_u8((306 * px[0] + 601 * px[1] + 117 * px[2] + 512) >> 10)];
+        }
+        if (f.enPixelFormat == PIXEL_FORMAT_YUV_400) break;
+        if (f.enPixelFormat != PIXEL_FORMAT_YUV_PLANAR_422 && (y & 1)) break;
+        const int cy = f.enPixelFormat == PIXEL_FORMAT_YUV_PLANAR_422 ? y : y / 2;
+        for (int x = 0; x < w; x += 2) {
+          const uint8_t *px = in + x * 3;
+          uint8_t u = clamp_u8(128 + ((-173 * px[0] - 339 * px[1] + 512 * px[2] + 512) >> 10));
+          uint8_t v = clamp_u8(128 + ((512 * px[0] - 429 * px[1] - 83 * px[2] + 512) >> 10));
+          if (f.enPixelFormat == PIXEL_FORMAT_NV12 || f.enPixelFormat == PIXEL_FORMAT_NV21) {
+            uint8_t *uv = f.pu8VirAddr[1] + (size_t)cy * f.u32Stride[1] + x;
+            uv[0] = f.enPixelFormat == PIXEL_FORMAT_NV12 ? u : v;
+            uv[1] = f.enPixelFormat == PIXEL_FORMAT_NV12 ? v : u;
+          } else {
+            f.pu8VirAddr[1][(size_t)cy * f.u32Stride[1] + x / 2] = u;
+            f.pu8VirAddr[2][(size_t)cy * f.u32Stride[2] + x / 2] = v;
+          }
+        }
+      } break;
+    }
+  }
+}
+
+CVI_S32 process_frame(const VIDEO_FRAME_S &src, const VPSS_CROP_INFO_S &grp_crop,
+                      const StubChn &chn, VIDEO_FRAME_INFO_S *out) {
+  const VPSS_CHN_ATTR_S &attr = chn.attr;
+  std::vector<uint8_t> rgb;
+  CVI_S32 ret = resize_rgb(src, grp_crop, chn.crop, attr, &rgb);
+  if (ret != CVI_SUCCESS) return ret;
+  ret = alloc_frame(attr.u32Width, attr.u32Height, attr.enPixelFormat, out);
+  if (ret != CVI_SUCCESS) return ret;
+  out->stVFrame.u64PTS = src.u64PTS;
+  out->stVFrame.u32TimeRef = src.u32TimeRef;
+
+  // out = in * factor - mean as int8, like the hardware normalizer feeding the TPU
+  uint8_t lut[3][256];
+  for (int c = 0; c < 3; c++) {
+    for (int v = 0; v < 256; v++) {
+      if (!attr.stNormalize.bEnable) {
+        lut[c][v] = v;
+        continue;
+      }
+      float n = v * attr.stNormalize.factor[c] - attr.stNormalize.mean[c];
+      n = attr.stNormalize.rounding == VPSS_ROUNDING_TO_EVEN ? nearbyintf(n) : roundf(n);
+      lut[c][v] = (uint8_t)(int8_t)std::min(std::max(n, -128.f), 127.f);
+    }
+  }
+  store_frame(rgb, lut, out);
+  return CVI_SUCCESS;
+}
+
+}  // namespace
+
+namespace cvistub {
+
+void add_forward_time(uint64_t us, bool count) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_stats.forward_us += us;
+  if (count) g_stats.forward_count++;
+}
+
+void add_vpss_time(uint64_t us) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_stats.vpss_us += us;
+  g_stats.vpss_count++;
+}
+
+}  // namespace cvistub
+
+void CVI_STUB_GetStats(cvi_stub_stats_t *stats) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  *stats = g_stats;
+}
+
+void CVI_STUB_ResetStats(void) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  uint64_t ion_bytes = g_stats.ion_bytes;
+  memset(&g_stats, 0, sizeof(g_stats));
+  g_stats.ion_bytes = g_stats.ion_peak_bytes = ion_bytes;
+}
+
+/* SYS */
+CVI_S32 CVI_SYS_Init(void) { return CVI_SUCCESS; }
+
+CVI_S32 CVI_SYS_Exit(void) { return CVI_SUCCESS; }
+
+CVI_S32 CVI_SYS_SetVPSSMode(VPSS_MODE_E enVPSSMode) {
+  g_vpss_mode = enVPSSMode;
+  return CVI_SUCCESS;
+}
+
+VPSS_MODE_E CVI_SYS_GetVPSSMode(void) { return g_vpss_mode; }
+
+CVI_S32 CVI_SYS_IonAlloc(CVI_U64 *pu64PhyAddr, CVI_VOID **ppVirAddr, const CVI_CHAR *strName,
+                         CVI_U32 u32Len) {
+  if (pu64PhyAddr == nullptr || ppVirAddr == nullptr) return CVI_FAILURE;
+  uint64_t addr;
+  *ppVirAddr = ion_alloc(u32Len, &addr);
+  if (*ppVirAddr == nullptr) return CVI_FAILURE;
+  *pu64PhyAddr = addr;
+  return CVI_SUCCESS;
+}
+
+CVI_S32 CVI_SYS_IonAlloc_Cached(CVI_U64 *pu64PhyAddr, CVI_VOID **ppVirAddr,
+                                const CVI_CHAR *strName, CVI_U32 u32Len) {
+  return CVI_SYS_IonAlloc(pu64PhyAddr, ppVirAddr, strName, u32Len);
+}
+
+CVI_S32 CVI_SYS_IonFree(CVI_U64 u64PhyAddr, CVI_VOID *pVirAddr) { return ion_free(u64PhyAddr); }
+
+CVI_S32 CVI_SYS_IonFlushCache(CVI_U64 u64PhyAddr, CVI_VOID *pVirAddr, CVI_U32 u32Len) {
+  return CVI_SUCCESS;
+}
+
+CVI_S32 CVI_SYS_IonInvalidateCache(CVI_U64 u64PhyAddr, CVI_VOID *pVirAddr, CVI_U32 u32Len) {
+  return CVI_SUCCESS;
+}
+
+void *CVI_SYS_Mmap(CVI_U64 u64PhyAddr, CVI_U32 u32Size) {
+  return reinterpret_cast<void *>(u64PhyAddr);
+}
+
+void *CVI_SYS_MmapCache(CVI_U64 u64PhyAddr, CVI_U32 u32Size) {
+  return reinterpret_cast<void *>(u64PhyAddr);
+}
+
+CVI_S32 CVI_SYS_Munmap(void *pVirAddr, CVI_U32 u32Size) { return CVI_SUCCESS; }
+
+/* VB, blocks are ion buffers behind a handle */
+CVI_S32 CVI_VB_SetConfig(const VB_CONFIG_S *pstVbConfig) { return CVI_SUCCESS; }
+
+CVI_S32 CVI_VB_Init(void) { return CVI_SUCCESS; }
+
+CVI_S32 CVI_VB_Exit(void) { return CVI_SUCCESS; }
+
+VB_BLK CVI_VB_GetBlock(VB_POOL Pool, CVI_U32 u32BlkSize) {
+  uint64_t addr;
+  if (ion_alloc(u32BlkSize, &addr) == nullptr) return VB_INVALID_HANDLE;
+  std::lock_guard<std::mutex> lock(g_mutex);
+  VB_BLK blk = g_next_blk++;
+  g_vb[blk] = {addr, u32BlkSize, Pool == VB_INVALID_POOLID ? 0 : Pool};
+  return blk;
+}
+
+CVI_S32 CVI_VB_ReleaseBlock(VB_BLK Block) {
+  uint64_t addr;
+  {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    auto it = g_vb.find(Block);
+    if (it == g_vb.end()) return CVI_FAILURE;
+    addr = it->second.addr;
+    g_vb.erase(it);
+  }
+  return ion_free(addr);
+}
+
+CVI_U64 CVI_VB_Handle2PhysAddr(VB_BLK Block) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  auto it = g_vb.find(Block);
+  return it == g_vb.end() ? 0 : it->second.addr;
+}
+
+VB_POOL CVI_VB_Handle2PoolId(VB_BLK Block) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  auto it = g_vb.find(Block);
+  return it == g_vb.end() ? VB_INVALID_POOLID : it->second.pool;
+}
+
+VB_BLK CVI_VB_PhysAddr2Handle(CVI_U64 u64PhyAddr) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  for (auto &blk : g_vb) {
+    if (u64PhyAddr >= blk.second.addr && u64PhyAddr < blk.second.addr + blk.second.size) {
+      return blk.first;
+    }
+  }
+  return VB_INVALID_HANDLE;
+}
+
+/* VPSS, a frame is processed for every enabled channel when it is sent */
+VPSS_GRP CVI_VPSS_GetAvailableGrp(void) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  for (VPSS_GRP i = 0; i < VPSS_MAX_GRP_NUM; i++) {
+    if (!g_grp[i].created) return i;
+  }
+  return -1;
+}
+
+CVI_S32 CVI_VPSS_CreateGrp(VPSS_GRP VpssGrp, const VPSS_GRP_ATTR_S *pstGrpAttr) {
+  if (!valid_chn(VpssGrp, 0)) return CVI_ERR_VPSS_INVALID_DEVID;
+  if (pstGrpAttr == nullptr) return CVI_ERR_VPSS_NULL_PTR;
+  std::lock_guard<std::mutex> lock(g_mutex);
+  StubGrp &grp = g_grp[VpssGrp];
+  if (grp.created) return CVI_ERR_VPSS_EXIST;
+  grp.created = true;
+  grp.attr = *pstGrpAttr;
+  memset(&grp.crop, 0, sizeof(grp.crop));
+  for (auto &chn : grp.chn) {
+    chn.enabled = false;
+    memset(&chn.attr, 0, sizeof(chn.attr));
+    memset(&chn.crop, 0, sizeof(chn.crop));
+  }
+  return CVI_SUCCESS;
+}
+
+CVI_S32 CVI_VPSS_DestroyGrp(VPSS_GRP VpssGrp) {
+  if (!valid_chn(VpssGrp, 0)) return CVI_ERR_VPSS_INVALID_DEVID;
+  std::vector<uint64_t> addrs;
+  {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    StubGrp &grp = g_grp[VpssGrp];
+    if (!grp.created) return CVI_ERR_VPSS_UNEXIST;
+    grp.created = false;
+    for (auto &chn : grp.chn) chn.enabled = false;
+    take_frames(&grp, &addrs);
+  }
+  for (uint64_t addr : addrs) ion_free(addr);
+  return CVI_SUCCESS;
+}
+
+CVI_S32 CVI_VPSS_StartGrp(VPSS_GRP VpssGrp) {
+  return valid_chn(VpssGrp, 0) ? CVI_SUCCESS : CVI_ERR_VPSS_INVALID_DEVID;
+}
+
+CVI_S32 CVI_VPSS_StopGrp(VPSS_GRP VpssGrp) {
+  return valid_chn(VpssGrp, 0) ? CVI_SUCCESS : CVI_ERR_VPSS_INVALID_DEVID;
+}
+
+CVI_S32 CVI_VPSS_ResetGrp(VPSS_GRP VpssGrp) {
+  if (!valid_chn(VpssGrp, 0)) return CVI_ERR_VPSS_INVALID_DEVID;
+  std::vector<uint64_t> addrs;
+  {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    take_frames(&g_grp[VpssGrp], &addrs);
+  }
+  for (uint64_t addr : addrs) ion_free(addr);
+  return CVI_SUCCESS;
+}
+
+CVI_S32 CVI_VPSS_SetGrpAttr(VPSS_GRP VpssGrp, const VPSS_GRP_ATTR_S *pstGrpAttr) {
+  if (!valid_chn(VpssGrp, 0)) return CVI_ERR_VPSS_INVALID_DEVID;
+  if (pstGrpAttr == nullptr) return CVI_ERR_VPSS_NULL_PTR;
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_grp[VpssGrp].attr = *pstGrpAttr;
+  return CVI_SUCCESS;
+}
+
+CVI_S32 CVI_VPSS_SetGrpCrop(VPSS_GRP VpssGrp, const VPSS_CROP_INFO_S *pstCropInfo) {
+  if (!valid_chn(VpssGrp, 0)) return CVI_ERR_VPSS_INVALID_DEVID;
+  if (pstCropInfo == nullptr) return CVI_ERR_VPSS_NULL_PTR;
+  if (pstCropInfo->bEnable && pstCropInfo->enCropCoordinate != VPSS_CROP_ABS_COOR) {
+    LOGE("stub vpss only supports absolute crop coordinates\n");
+    return CVI_ERR_VPSS_NOT_SUPPORT;
+  }
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_grp[VpssGrp].crop = *pstCropInfo;
+  return CVI_SUCCESS;
+}
+
+CVI_S32 CVI_VPSS_SetChnAttr(VPSS_GRP VpssGrp, VPSS_CHN VpssChn,
+                            const VPSS_CHN_ATTR_S *pstChnAttr) {
+  if (!valid_chn(VpssGrp, VpssChn)) return CVI_ERR_VPSS_INVALID_CHNID;
+  if (pstChnAttr == nullptr) return CVI_ERR_VPSS_NULL_PTR;
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_grp[VpssGrp].chn[VpssChn].attr = *pstChnAttr;
+  return CVI_SUCCESS;
+}
+
+CVI_S32 CVI_VPSS_SetChnCrop(VPSS_GRP VpssGrp, VPSS_CHN VpssChn,
+                            const VPSS_CROP_INFO_S *pstCropInfo) {
+  if (!valid_chn(VpssGrp, VpssChn)) return CVI_ERR_VPSS_INVALID_CHNID;
+  if (pstCropInfo == nullptr) return CVI_ERR_VPSS_NULL_PTR;
+  if (pstCropInfo->bEnable && pstCropInfo->enCropCoordinate != VPSS_CROP_ABS_COOR) {
+    LOGE("stub vpss only supports absolute crop coordinates\n");
+    return CVI_ERR_VPSS_NOT_SUPPORT;
+  }
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_grp[VpssGrp].chn[VpssChn].crop = *pstCropInfo;
+  return CVI_SUCCESS;
+}
+
+CVI_S32 CVI_VPSS_SetChnScaleCoefLevel(VPSS_GRP VpssGrp, VPSS_CHN VpssChn,
+                                      VPSS_SCALE_COEF_E enCoef) {
+  // every coefficient is emulated by the bilinear resize
+  return valid_chn(VpssGrp, VpssChn) ? CVI_SUCCESS : CVI_ERR_VPSS_INVALID_CHNID;
+}
+
+CVI_S32 CVI_VPSS_EnableChn(VPSS_GRP VpssGrp, VPSS_CHN VpssChn) {
+  if (!valid_chn(VpssGrp, VpssChn)) return CVI_ERR_VPSS_INVALID_CHNID;
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_grp[VpssGrp].chn[VpssChn].enabled = true;
+  return CVI_SUCCESS;
+}
+
+CVI_S32 CVI_VPSS_DisableChn(VPSS_GRP VpssGrp, VPSS_CHN VpssChn) {
+  if (!valid_chn(VpssGrp, VpssChn)) return CVI_ERR_VPSS_INVALID_CHNID;
+  std::lock_guard<std::mutex> lock(g_mutex);
+  g_grp[VpssGrp].chn[VpssChn].enabled = false;
+  return CVI_SUCCESS;
+}
+
+CVI_S32 CVI_VPSS_AttachVbPool(VPSS_GRP VpssGrp, VPSS_CHN VpssChn, VB_POOL hVbPool) {
+  return valid_chn(VpssGrp, VpssChn) ? CVI_SUCCESS : CVI_ERR_VPSS_INVALID_CHNID;
+}
+
+CVI_S32 CVI_VPSS_DetachVbPool(VPSS_GRP VpssGrp, VPSS_CHN VpssChn) {
+  return valid_chn(VpssGrp, VpssChn) ? CVI_SUCCESS : CVI_ERR_VPSS_INVALID_CHNID;
+}
+
+CVI_S32 CVI_VPSS_SendFrame(VPSS_GRP VpssGrp, const VIDEO_FRAME_INFO_S *pstVideoFrame,
+                           CVI_S32 s32MilliSec) {
+  if (!valid_chn(VpssGrp, 0)) return CVI_ERR_VPSS_INVALID_DEVID;
+  if (pstVideoFrame == nullptr) return CVI_ERR_VPSS_NULL_PTR;
+  const uint64_t t0 = cvistub::now_us();
+  StubGrp grp;
+  {
+    std::lock_guard<std::mutex> lock(g_mutex);
+    if (!g_grp[VpssGrp].created) return CVI_ERR_VPSS_UNEXIST;
+    grp.crop = g_grp[VpssGrp].crop;
+    for (int i = 0; i < VPSS_MAX_CHN_NUM; i++) {
+      grp.chn[i].enabled = g_grp[VpssGrp].chn[i].enabled;
+      grp.chn[i].attr = g_grp[VpssGrp].chn[i].attr;
+      grp.chn[i].crop = g_grp[VpssGrp].chn[i].crop;
+    }
+  }
+
+  // callers may pass frames that are not mapped
+  VIDEO_FRAME_S src = pstVideoFrame->stVFrame;
+  for (int i = 0; i < 3; i++) {
+    if (src.pu8VirAddr[i] == nullptr) src.pu8VirAddr[i] = (CVI_U8 *)src.u64PhyAddr[i];
+  }
+
+  CVI_S32 ret = CVI_SUCCESS;
+  for (int i = 0; i < VPSS_MAX_CHN_NUM && ret == CVI_SUCCESS; i++) {
+    if (!grp.chn[i].enabled) continue;
+    VIDEO_FRAME_INFO_S out;
+    ret = process_frame(src, grp.crop, grp.chn[i], &out);
+    if (ret != CVI_SUCCESS) break;
+    std::vector<uint64_t> dropped;
+    {
+      std::lock_guard<std::mutex> lock(g_mutex);
+      StubChn &chn = g_grp[VpssGrp].chn[i];
+      chn.frames.push_back(out);
+      // frames nobody took are dropped like a full hardware queue would
+      while (chn.frames.size() > std::max(chn.attr.u32Depth, 1u)) {
+        dropped.push_back(chn.frames.front().stVFrame.u64PhyAddr[0]);
+        chn.frames.pop_front();
+      }
+    }
+    for (uint64_t addr : dropped) ion_free(addr);
+  }
+  cvistub::add_vpss_time(cvistub::now_us() - t0);
+  return ret;
+}
+
+CVI_S32 CVI_VPSS_GetChnFrame(VPSS_GRP VpssGrp, VPSS_CHN VpssChn, VIDEO_FRAME_INFO_S *pstFrameInfo,
+                             CVI_S32 s32MilliSec) {
+  if (!valid_chn(VpssGrp, VpssChn)) return CVI_ERR_VPSS_INVALID_CHNID;
+  if (pstFrameInfo == nullptr) return CVI_ERR_VPSS_NULL_PTR;
+  std::lock_guard<std::mutex> lock(g_mutex);
+  StubChn &chn = g_grp[VpssGrp].chn[VpssChn];
+  if (chn.frames.empty()) return CVI_ERR_VPSS_BUF_EMPTY;
+  *pstFrameInfo = chn.frames.front();
+  chn.frames.pop_front();
+  return CVI_SUCCESS;
+}
+
+CVI_S32 CVI_VPSS_ReleaseChnFrame(VPSS_GRP VpssGrp, VPSS_CHN VpssChn,
+                                 const VIDEO_FRAME_INFO_S *pstVideoFrame) {
+  if (!valid_chn(VpssGrp, VpssChn)) return CVI_ERR_VPSS_INVALID_CHNID;
+  if (pstVideoFrame == nullptr) return CVI_ERR_VPSS_NULL_PTR;
+  return ion_free(pstVideoFrame->stVFrame.u64PhyAddr[0]) == CVI_SUCCESS
+             ? CVI_SUCCESS
+             : CVI_ERR_VPSS_ILLEGAL_PARAM;
+}
+
+/* GDC is not emulated, callers fall back to their CPU path or fail */
+CVI_S32 CVI_GDC_BeginJob(GDC_HANDLE *phHandle) {
+  LOGE("GDC is not available in the stub runtime\n");
+  return CVI_FAILURE;
+}
+
+CVI_S32 CVI_GDC_EndJob(GDC_HANDLE hHandle) { return CVI_FAILURE; }
+
+CVI_S32 CVI_GDC_AddAffineTask(GDC_HANDLE hHandle, const GDC_TASK_ATTR_S *pstTask,
+                              const AFFINE_ATTR_S *pstAffineAttr) {
+  return CVI_FAILURE;
+}
@@ -0,0 +1,427 @@
+#include <cviruntime.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "cvi_stub_runtime.h"
+#include "cvi_tdl_log.hpp"
+#include "stub_common.hpp"
+
+namespace {
+
+// the SoC has one TPU, forwards of all the models run one after the other
+std::mutex g_tpu_mutex;
+
+struct OutputSource {
+  std::vector<std::vector<uint8_t>> replay;
+  float lo = 0;
+  float hi = 0;
+  float spike_ratio = 0;
+  float spike_value = 0;
+};
+
+struct StubModel {
+  std::vector<CVI_TENSOR> inputs;
+  std::vector<CVI_TENSOR> outputs;
+  std::vector<OutputSource> sources;
+  std::string replay_dir;
+  uint64_t seed = 0;
+  uint32_t latency_us = 0;
+  uint64_t forward_count = 0;
+};
+
+bool parse_fmt(const std::string &s, CVI_FMT *fmt, size_t *elem_size) {
+  static const struct {
+    const char *name;
+    CVI_FMT fmt;
+    size_t size;
+  } fmts[] = {{"fp32", CVI_FMT_FP32, 4},     {"int32", CVI_FMT_INT32, 4},
+              {"uint32", CVI_FMT_UINT32, 4}, {"bf16", CVI_FMT_BF16, 2},
+              {"int16", CVI_FMT_INT16, 2},   {"uint16", CVI_FMT_UINT16, 2},
+              {"int8", CVI_FMT_INT8, 1},     {"uint8", CVI_FMT_UINT8, 1}};
+  for (auto &f : fmts) {
+    if (s == f.name) {
+      *fmt = f.fmt;
+      *elem_size = f.size;
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t fmt_size(CVI_FMT fmt) {
+  switch (fmt) {
+    case CVI_FMT_FP32:
+    case CVI_FMT_INT32:
+    case CVI_FMT_UINT32:
+      return 4;
+    case CVI_FMT_BF16:
+    case CVI_FMT_INT16:
+    case CVI_FMT_UINT16:
+      return 2;
+    default:
+      return 1;
+  }
+}
+
+void free_tensors(std::vector<CVI_TENSOR> &tensors) {
+  for (auto &t : tensors) {
+    free(t.name);
+    free(t.sys_mem);
+  }
+  tensors.clear();
+}
+
+void free_model(StubModel *model) {
+  free_tensors(model->inputs);
+  free_tensors(model->outputs);
+  delete model;
+}
+
+/* <dir>/<tensor>_<n>.bin for n = 0, 1, ... until the first missing file */
+bool load_replay(const std::string &dir, const CVI_TENSOR &tensor, OutputSource *source) {
+  std::string base = tensor.name;
+  std::replace(base.begin(), base.end(), '/', '_');
+  for (int n = 0;; n++) {
+    std::string path = dir + "/" + base + "_" + std::to_string(n) + ".bin";
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) break;
+    size_t size = file.tellg();
+    if (size != tensor.mem_size) {
+      LOGE("replay file %s has %zu bytes, tensor %s needs %zu\n", path.c_str(), size, tensor.name,
+           tensor.mem_size);
+      return false;
+    }
+    std::vector<uint8_t> data(size);
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(data.data()), size);
+    source->replay.emplace_back(std::move(data));
+  }
+  return true;
+}
+
+bool parse_tensor(std::istringstream &line, const std::string &kind, int line_no,
+                  CVI_TENSOR *tensor, OutputSource *source) {
+  std::string name, fmt_name;
+  line >> name >> fmt_name;
+  size_t elem_size;
+  if (name.empty() || !parse_fmt(fmt_name, &tensor->fmt, &elem_size)) {
+    LOGE("stub model line %d: expected '%s <name> <fmt> <dims...>'\n", line_no, kind.c_str());
+    return false;
+  }
+  tensor->qscale = 1.f;
+  tensor->shape.dim_size = 0;
+  for (int i = 0; i < CVI_DIM_MAX; i++) tensor->shape.dim[i] = 1;
+  if (tensor->fmt == CVI_FMT_FP32 || tensor->fmt == CVI_FMT_BF16) {
+    source->hi = 1.f;
+  } else {
+    source->lo = tensor->fmt == CVI_FMT_INT8 ? -128.f : 0.f;
+    source->hi = tensor->fmt == CVI_FMT_INT8 ? 127.f : 255.f;
+  }
+
+  std::string token;
+  while (line >> token) {
+    if (token == "qscale") {
+      line >> tensor->qscale;
+    } else if (token == "range") {
+      line >> source->lo >> source->hi;
+    } else if (token == "spikes") {
+      line >> source->spike_ratio >> source->spike_value;
+    } else if (tensor->shape.dim_size < CVI_DIM_MAX && isdigit((unsigned char)token[0])) {
+      tensor->shape.dim[tensor->shape.dim_size++] = atoi(token.c_str());
+    } else {
+      LOGE("stub model line %d: unexpected '%s'\n", line_no, token.c_str());
+      return false;
+    }
+    if (line.fail()) {
+      LOGE("stub model line %d: missing value after '%s'\n", line_no, token.c_str());
+      return false;
+    }
+  }
+  if (tensor->shape.dim_size == 0) {
+    LOGE("stub model line %d: tensor %s has no dims\n", line_no, name.c_str());
+    return false;
+  }
+  tensor->count = 1;
+  for (size_t i = 0; i < tensor->shape.dim_size; i++) tensor->count *= tensor->shape.dim[i];
+  tensor->mem_size = tensor->count * elem_size;
+  tensor->name = strdup(name.c_str());
+  // 64 aligned like the runtime buffers, so vectorized postprocess sees the same alignment
+  tensor->sys_mem = static_cast<uint8_t *>(aligned_alloc(64, (tensor->mem_size + 63) & ~63ul));
+  memset(tensor->sys_mem, 0, tensor->mem_size);
+  tensor->mem_type = CVI_MEM_SYSTEM;
+  return true;
+}
+
+StubModel *parse_model(const std::string &text) {
+  StubModel *model = new StubModel;
+  std::istringstream input(text);
+  std::string raw;
+  int line_no = 0;
+  bool ok = true;
+  while (ok && std::getline(input, raw)) {
+    line_no++;
+    std::istringstream line(raw.substr(0, raw.find('#')));
+    std::string key;
+    if (!(line >> key)) continue;
+    if (key == "input" || key == "output") {
+      CVI_TENSOR tensor;
+      memset(&tensor, 0, sizeof(tensor));
+      OutputSource source;
+      ok = parse_tensor(line, key, line_no, &tensor, &source);
+      if (ok) {
+        if (key == "input") {
+          model->inputs.push_back(tensor);
+        } else {
+          model->outputs.push_back(tensor);
+          model->sources.push_back(source);
+        }
+      }
+    } else if (key == "replay") {
+      ok = static_cast<bool>(line >> model->replay_dir);
+    } else if (key == "seed") {
+      ok = static_cast<bool>(line >> model->seed);
+    } else if (key == "latency_us") {
+      ok = static_cast<bool>(line >> model->latency_us);
+    } else {
+      LOGE("stub model line %d: unknown statement '%s'\n", line_no, key.c_str());
+      ok = false;
+    }
+  }
+  if (ok && (model->inputs.empty() || model->outputs.empty())) {
+    LOGE("stub model needs at least one input and one output\n");
+    ok = false;
+  }
+  for (size_t i = 0; ok && !model->replay_dir.empty() && i < model->outputs.size(); i++) {
+    ok = load_replay(model->replay_dir, model->outputs[i], &model->sources[i]);
+  }
+  if (!ok) {
+    free_model(model);
+    return nullptr;
+  }
+  return model;
+}
+
+inline uint64_t splitmix64(uint64_t *state) {
+  uint64_t z = (*state += 0x9e3779b97f4a7c15ull);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+struct bf16_t {
+  uint16_t bits;
+};
+
+inline void store(float *dst, float v) { *dst = v; }
+
+inline void store(bf16_t *dst, float v) {
+  // bf16 is the upper half of the fp32 bits
+  uint32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  dst->bits = bits >> 16;
+}
+
+template <typename T>
+inline void store(T *dst, float v) {
+  *dst = (T)roundf(v);
+}
+
+/* uniform values in [source.lo, source.hi] with spikes, clamped to [lo, hi] */
+template <typename T>
+void synthesize(T *data, size_t count, const OutputSource &source, uint64_t state, float lo,
+                float hi) {
+  const float span = source.hi - source.lo;
+  // the spike test uses the low bits, the value the high bits of the same draw
+  const uint32_t spike_threshold =
+      (uint32_t)(std::min(std::max(source.spike_ratio, 0.f), 1.f) * 4294967295.0);
+  for (size_t i = 0; i < count; i++) {
+    uint64_t r = splitmix64(&state);
+    float v = (uint32_t)r < spike_threshold ? source.spike_value
+                                            : source.lo + (r >> 40) * (1.f / 16777216.f) * span;
+    store(data + i, std::min(std::max(v, lo), hi));
+  }
+}
+
+void synthesize_output(const StubModel *model, const OutputSource &source, CVI_TENSOR *tensor) {
+  uint64_t state = model->seed ^ (model->forward_count * 0x2545f4914f6cdd1dull);
+  for (const char *c = tensor->name; *c; c++) state = (state ^ (uint8_t)*c) * 0x100000001b3ull;
+  void *data = tensor->sys_mem;
+  const size_t n = tensor->count;
+  switch (tensor->fmt) {
+    case CVI_FMT_FP32:
+      synthesize((float *)data, n, source, state, -INFINITY, INFINITY);
+      break;
+    case CVI_FMT_BF16:
+      synthesize((bf16_t *)data, n, source, state, -INFINITY, INFINITY);
+      break;
+    case CVI_FMT_INT32:
+      synthesize((int32_t *)data, n, source, state, -2147483648.f, 2147483520.f);
+      break;
+    case CVI_FMT_UINT32:
+      synthesize((uint32_t *)data, n, source, state, 0.f, 4294967040.f);
+      break;
+    case CVI_FMT_INT16:
+      synthesize((int16_t *)data, n, source, state, -32768.f, 32767.f);
+      break;
+    case CVI_FMT_UINT16:
+      synthesize((uint16_t *)data, n, source, state, 0.f, 65535.f);
+      break;
+    case CVI_FMT_INT8:
+      synthesize((int8_t *)data, n, source, state, -128.f, 127.f);
+      break;
+    default:
+      synthesize((uint8_t *)data, n, source, state, 0.f, 255.f);
+      break;
+  }
+}
+
+}  // namespace
+
+CVI_RC CVI_NN_RegisterModelFromBuffer(const int8_t *buf, uint32_t size, CVI_MODEL_HANDLE *model) {
+  if (buf == nullptr || model == nullptr) return CVI_RC_INVALID_ARG;
+  StubModel *m = parse_model(std::string(reinterpret_cast<const char *>(buf), size));
+  if (m == nullptr) return CVI_RC_DATA_ERR;
+  *model = m;
+  return CVI_RC_SUCCESS;
+}
+
+CVI_RC CVI_NN_RegisterModel(const char *model_file, CVI_MODEL_HANDLE *model) {
+  if (model_file == nullptr || model == nullptr) return CVI_RC_INVALID_ARG;
+  std::ifstream file(model_file);
+  if (!file.is_open()) {
+    LOGE("cannot open stub model %s\n", model_file);
+    return CVI_RC_FAILURE;
+  }
+  std::stringstream text;
+  text << file.rdbuf();
+  StubModel *m = parse_model(text.str());
+  if (m == nullptr) {
+    LOGE("%s is not a valid stub model descriptor\n", model_file);
+    return CVI_RC_DATA_ERR;
+  }
+  *model = m;
+  return CVI_RC_SUCCESS;
+}
+
+// like the runtime, a clone keeps the model description and gets its own I/O tensors
+CVI_RC CVI_NN_CloneModel(CVI_MODEL_HANDLE model, CVI_MODEL_HANDLE *cloned) {
+  if (model == nullptr || cloned == nullptr) return CVI_RC_INVALID_ARG;
+  StubModel *m = new StubModel(*static_cast<StubModel *>(model));
+  m->forward_count = 0;
+  for (auto *tensors : {&m->inputs, &m->outputs}) {
+    for (auto &t : *tensors) {
+      t.name = strdup(t.name);
+      t.sys_mem = static_cast<uint8_t *>(aligned_alloc(64, (t.mem_size + 63) & ~63ul));
+      memset(t.sys_mem, 0, t.mem_size);
+    }
+  }
+  *cloned = m;
+  return CVI_RC_SUCCESS;
+}
+
+CVI_RC CVI_NN_SetConfig(CVI_MODEL_HANDLE model, CVI_CONFIG_OPTION option, ...) {
+  return model == nullptr ? CVI_RC_INVALID_ARG : CVI_RC_SUCCESS;
+}
+
+CVI_RC CVI_NN_GetInputOutputTensors(CVI_MODEL_HANDLE model, CVI_TENSOR **inputs,
+                                    int32_t *input_num, CVI_TENSOR **outputs,
+                                    int32_t *output_num) {
+  if (model == nullptr) return CVI_RC_INVALID_ARG;
+  StubModel *m = static_cast<StubModel *>(model);
+  if (inputs) *inputs = m->inputs.data();
+  if (input_num) *input_num = m->inputs.size();
+  if (outputs) *outputs = m->outputs.data();
+  if (output_num) *output_num = m->outputs.size();
+  return CVI_RC_SUCCESS;
+}
+
+CVI_TENSOR *CVI_NN_GetTensorByName(const char *name, CVI_TENSOR *tensors, int32_t num) {
+  if (tensors == nullptr || num <= 0) return nullptr;
+  if (name == CVI_NN_DEFAULT_TENSOR) return tensors;
+  for (int32_t i = 0; i < num; i++) {
+    if (strcmp(tensors[i].name, name) == 0) return &tensors[i];
+  }
+  return nullptr;
+}
+
+char *CVI_NN_TensorName(CVI_TENSOR *tensor) { return tensor->name; }
+
+void *CVI_NN_TensorPtr(CVI_TENSOR *tensor) { return tensor->sys_mem; }
+
+size_t CVI_NN_TensorSize(CVI_TENSOR *tensor) { return tensor->mem_size; }
+
+size_t CVI_NN_TensorCount(CVI_TENSOR *tensor) { return tensor->count; }
+
+float CVI_NN_TensorQuantScale(CVI_TENSOR *tensor) { return tensor->qscale; }
+
+CVI_SHAPE CVI_NN_TensorShape(CVI_TENSOR *tensor) { return tensor->shape; }
+
+CVI_RC CVI_NN_SetTensorPhysicalAddr(CVI_TENSOR *tensor, uint64_t paddr) {
+  if (tensor == nullptr) return CVI_RC_INVALID_ARG;
+  tensor->paddr = paddr;
+  return CVI_RC_SUCCESS;
+}
+
+CVI_RC CVI_NN_FeedTensorWithFrames(CVI_MODEL_HANDLE model, CVI_TENSOR *tensor,
+                                   CVI_FRAME_TYPE type, CVI_FMT format, int32_t channel_num,
+                                   uint64_t *channel_paddrs, int32_t height, int32_t width,
+                                   uint32_t height_stride) {
+  if (model == nullptr || tensor == nullptr || channel_paddrs == nullptr || channel_num <= 0) {
+    return CVI_RC_INVALID_ARG;
+  }
+  const uint64_t t0 = cvistub::now_us();
+  const size_t row = (size_t)width * fmt_size(format);
+  const bool planar = type == CVI_FRAME_PLANAR;
+  const size_t row_bytes = planar ? row : row * channel_num;
+  if (row_bytes * height * (planar ? channel_num : 1) > tensor->mem_size) {
+    LOGE("%d frame planes of %dx%d do not fit tensor %s\n", channel_num, width, height,
+         tensor->name);
+    return CVI_RC_INVALID_ARG;
+  }
+  // physical addresses of the stub are host pointers
+  uint8_t *dst = tensor->sys_mem;
+  for (int32_t c = 0; c < (planar ? channel_num : 1); c++) {
+    const uint8_t *src = reinterpret_cast<const uint8_t *>(channel_paddrs[c]);
+    for (int32_t y = 0; y < height; y++, dst += row_bytes) {
+      memcpy(dst, src + (size_t)y * height_stride, row_bytes);
+    }
+  }
+  cvistub::add_forward_time(cvistub::now_us() - t0, false);
+  return CVI_RC_SUCCESS;
+}
+
+CVI_RC CVI_NN_Forward(CVI_MODEL_HANDLE model, CVI_TENSOR inputs[], int32_t input_num,
+                      CVI_TENSOR outputs[], int32_t output_num) {
+  if (model == nullptr) return CVI_RC_INVALID_ARG;
+  std::lock_guard<std::mutex> lock(g_tpu_mutex);
+  const uint64_t t0 = cvistub::now_us();
+  StubModel *m = static_cast<StubModel *>(model);
+  for (size_t i = 0; i < m->outputs.size(); i++) {
+    const OutputSource &source = m->sources[i];
+    if (!source.replay.empty()) {
+      const std::vector<uint8_t> &data = source.replay[m->forward_count % source.replay.size()];
+      memcpy(m->outputs[i].sys_mem, data.data(), data.size());
+    } else {
+      synthesize_output(m, source, &m->outputs[i]);
+    }
+  }
+  if (m->latency_us > 0) usleep(m->latency_us);
+  m->forward_count++;
+  cvistub::add_forward_time(cvistub::now_us() - t0, true);
+  return CVI_RC_SUCCESS;
+}
+
+CVI_RC CVI_NN_CleanupModel(CVI_MODEL_HANDLE model) {
+  if (model == nullptr) return CVI_RC_INVALID_ARG;
+  free_model(static_cast<StubModel *>(model));
+  return CVI_RC_SUCCESS;
+}
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+#include "../evaluation/feature_eval/feature_eval.hpp"
+
+// Offline accuracy evaluation of dumped features, runs on the host.
+// reid mode: features from CVI_TDL_Eval_Market1501SaveFeatures
+// pair mode: features from CVI_TDL_Eval_LfwSaveFeatures, records 2i and 2i+1 form pair i with
+// label in the id field
+using namespace cvitdl::evaluation;
+
+static void usage(const char *name) {
+  printf("usage: %s reid <query_feature_file> <gallery_feature_file> [threads]\n", name);
+  printf("       %s pair <pair_feature_file> [roc_output_file]\n", name);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 3) {
+    usage(argv[0]);
+    return -1;
+  }
+  auto t0 = std::chrono::steady_clock::now();
+  if (strcmp(argv[1], "reid") == 0 && argc >= 4) {
+    FeatureSet query, gallery;
+    if (LoadFeatureFile(argv[2], &query) != 0 || LoadFeatureFile(argv[3], &gallery) != 0) {
+      return -1;
+    }
+    int threads = argc > 4 ? atoi(argv[4]) : 0;
+    RankingResult result;
+    EvalRanking(query, gallery, 50, &result, threads);
+    if (result.num_valid_query == 0) {
+      printf("no valid query\n");
+      return -1;
+    }
+    printf("query:%zu, gallery:%zu, valid query:%u\n", query.ids.size(), gallery.ids.size(),
+           result.num_valid_query);
+    printf("Rank [1]:%f, [5]:%f, [10]:%f, [20]:%f\n", result.cmc[0], result.cmc[4], result.cmc[9],
+           result.cmc[19]);
+    printf("mAP: %f\n", result.mAP);
+  } else if (strcmp(argv[1], "pair") == 0) {
+    FeatureSet pairs;
+    if (LoadFeatureFile(argv[2], &pairs) != 0) {
+      return -1;
+    }
+    std::vector<int> labels;
+    std::vector<float> scores;
+    for (size_t i = 0; i + 1 < pairs.ids.size(); i += 2) {
+      if (pairs.ids[i] < 0) continue;  // pair without face
+      float diff = CosineDistance(&pairs.features[i * pairs.dim],
+                                  &pairs.features[(i + 1) * pairs.dim], pairs.dim);
+      labels.push_back(pairs.ids[i]);
+      scores.push_back(1.0 - (0.5 * diff));
+    }
+    std::vector<RocPoint> curve;
+    RocResult result;
+    EvalROC(labels.data(), scores.data(), labels.size(), argc > 3 ? &curve : NULL, &result);
+    if (argc > 3) {
+      FILE *fp = fopen(argv[3], "w");
+      if (fp == NULL) {
+        printf("file open error: %s\n", argv[3]);
+        return -1;
+      }
+      for (const RocPoint &p : curve) {
+        fprintf(fp, "thr: %f, tpr: %f, fpr: %f\n", p.thr, p.tpr, p.fpr);
+      }
+      fclose(fp);
+    }
+    printf("pairs:%zu\n", labels.size());
+    printf("AUC: %f, best accuracy: %f (thr: %f)\n", result.auc, result.best_accuracy,
+           result.best_thr);
+  } else {
+    usage(argv[0]);
+    return -1;
+  }
+  printf("time: %.1f ms\n",
+         std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count());
+  return 0;
+}
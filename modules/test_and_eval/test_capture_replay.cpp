@@ -0,0 +1,215 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "capture_file.hpp"
+#include "core/cvi_tdl_core.h"
+#include "core/utils/vpss_helper.h"
+
+// replay a capture of CVI_TDL_StartCapture through the postprocess and the tracker
+// usage: test_capture_replay <model> <model_path> <capture_file> [realtime] [track]
+//   model     yolov8, yolov5, yolox, ppyoloe, retinaface or scrfd
+//   realtime  1 to pace the calls at the captured timestamps, 0 for full speed
+//   track     1 to run DeepSORT on the results
+
+using namespace cvitdl;
+
+struct ReplayModel {
+  const char *name;
+  CVI_TDL_SUPPORTED_MODEL_E index;
+  bool is_face;
+};
+
+static const ReplayModel REPLAY_MODELS[] = {
+    {"yolov8", CVI_TDL_SUPPORTED_MODEL_YOLOV8_DETECTION, false},
+    {"yolov5", CVI_TDL_SUPPORTED_MODEL_YOLOV5, false},
+    {"yolox", CVI_TDL_SUPPORTED_MODEL_YOLOX, false},
+    {"ppyoloe", CVI_TDL_SUPPORTED_MODEL_PPYOLOE, false},
+    {"retinaface", CVI_TDL_SUPPORTED_MODEL_RETINAFACE, true},
+    {"scrfd", CVI_TDL_SUPPORTED_MODEL_SCRFDFACE, true},
+};
+
+struct StageTime {
+  double total_ms = 0;
+  double max_ms = 0;
+  void add(double ms) {
+    total_ms += ms;
+    max_ms = std::max(max_ms, ms);
+  }
+};
+
+static double elapsed_ms(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static int prepare_frame(VIDEO_FRAME_INFO_S *frame, bool *allocated, const CaptureRecord &record) {
+  CaptureFrameInfo info;
+  if (record.data.size() < sizeof(info)) return -1;
+  memcpy(&info, record.data.data(), sizeof(info));
+  VIDEO_FRAME_S *v = &frame->stVFrame;
+  if (!*allocated || v->u32Width != info.width || v->u32Height != info.height ||
+      (uint32_t)v->enPixelFormat != info.pixel_format) {
+    if (*allocated) CVI_SYS_IonFree(v->u64PhyAddr[0], v->pu8VirAddr[0]);
+    *allocated = false;
+    if (CREATE_ION_HELPER(frame, info.width, info.height, (PIXEL_FORMAT_E)info.pixel_format,
+                          "replay") != CVI_SUCCESS) {
+      printf("cannot allocate a %ux%u frame of format %u\n", info.width, info.height,
+             info.pixel_format);
+      return -1;
+    }
+    *allocated = true;
+  }
+  if (!info.has_pixels) return 0;
+
+  const uint8_t *src = record.data.data() + sizeof(info);
+  size_t remain = record.data.size() - sizeof(info);
+  for (int i = 0; i < 3; i++) {
+    size_t len = std::min<size_t>(std::min(info.length[i], v->u32Length[i]), remain);
+    if (len != 0) memcpy(v->pu8VirAddr[i], src, len);
+    src += info.length[i];
+    remain -= std::min<size_t>(info.length[i], remain);
+  }
+  CVI_SYS_IonFlushCache(v->u64PhyAddr[0], v->pu8VirAddr[0],
+                        v->u32Length[0] + v->u32Length[1] + v->u32Length[2]);
+  return 0;
+}
+
+static bool same_boxes(const std::vector<CaptureBox> &a, const std::vector<CaptureBox> &b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].classes != b[i].classes || fabsf(a[i].bbox.x1 - b[i].bbox.x1) > 1e-3f ||
+        fabsf(a[i].bbox.y1 - b[i].bbox.y1) > 1e-3f || fabsf(a[i].bbox.x2 - b[i].bbox.x2) > 1e-3f ||
+        fabsf(a[i].bbox.y2 - b[i].bbox.y2) > 1e-3f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+    printf("usage: %s <model> <model_path> <capture_file> [realtime] [track]\n", argv[0]);
+    return -1;
+  }
+  const ReplayModel *model = nullptr;
+  for (const ReplayModel &m : REPLAY_MODELS) {
+    if (strcmp(argv[1], m.name) == 0) model = &m;
+  }
+  if (model == nullptr) {
+    printf("unsupported model %s\n", argv[1]);
+    return -1;
+  }
+  bool realtime = argc > 4 && atoi(argv[4]) != 0;
+  bool track = argc > 5 && atoi(argv[5]) != 0;
+
+  CaptureReader reader;
+  if (reader.open(argv[3]) != CVI_TDL_SUCCESS || reader.numCalls() == 0) {
+    printf("cannot read capture %s\n", argv[3]);
+    return -1;
+  }
+
+  cvitdl_handle_t handle = NULL;
+  int ret = CVI_TDL_CreateHandle(&handle);
+  if (ret != CVI_SUCCESS) {
+    printf("create handle failed with %#x!\n", ret);
+    return ret;
+  }
+  ret = CVI_TDL_OpenModel(handle, model->index, argv[2]);
+  if (ret == CVI_SUCCESS) ret = CVI_TDL_StartReplay(handle, model->index, argv[3]);
+  if (ret != CVI_SUCCESS) {
+    printf("open model or capture failed with %#x!\n", ret);
+    CVI_TDL_DestroyHandle(handle);
+    return ret;
+  }
+  if (track) {
+    CVI_TDL_DeepSORT_Init(handle, false);
+    cvtdl_deepsort_config_t ds_conf;
+    CVI_TDL_DeepSORT_GetDefaultConfig(&ds_conf);
+    CVI_TDL_DeepSORT_SetConfig(handle, &ds_conf, -1, false);
+  }
+
+  VIDEO_FRAME_INFO_S frame;
+  memset(&frame, 0, sizeof(frame));
+  bool allocated = false;
+  std::vector<CaptureRecord> records;
+  std::vector<CaptureBox> captured, replayed;
+  StageTime infer_time, track_time;
+  size_t mismatches = 0, num_results = 0;
+  auto start = std::chrono::steady_clock::now();
+  uint64_t ts0 = reader.call(0).timestamp_us;
+  size_t i = 0;
+  for (; i < reader.numCalls(); i++) {
+    if (reader.readCall(i, &records) != CVI_TDL_SUCCESS || records.empty() ||
+        records[0].type != CAPTURE_RECORD_FRAME ||
+        prepare_frame(&frame, &allocated, records[0]) != 0) {
+      printf("bad capture call %zu\n", i);
+      ret = -1;
+      break;
+    }
+    captured.clear();
+    for (const CaptureRecord &record : records) {
+      if (record.type == CAPTURE_RECORD_OBJECT || record.type == CAPTURE_RECORD_FACE) {
+        captured.resize(record.data.size() / sizeof(CaptureBox));
+        memcpy(captured.data(), record.data.data(), captured.size() * sizeof(CaptureBox));
+      }
+    }
+    if (realtime) {
+      double due_ms = (reader.call(i).timestamp_us - ts0) / 1000.0;
+      double now_ms = elapsed_ms(start);
+      if (due_ms > now_ms) usleep((useconds_t)((due_ms - now_ms) * 1000));
+    }
+
+    cvtdl_object_t obj = {};
+    cvtdl_face_t face = {};
+    cvtdl_tracker_t tracker = {};
+    auto t0 = std::chrono::steady_clock::now();
+    if (model->is_face) {
+      ret = CVI_TDL_FaceDetection(handle, &frame, model->index, &face);
+    } else {
+      ret = CVI_TDL_Detection(handle, &frame, model->index, &obj);
+    }
+    infer_time.add(elapsed_ms(t0));
+    if (ret == CVI_SUCCESS && track) {
+      t0 = std::chrono::steady_clock::now();
+      ret = model->is_face ? CVI_TDL_DeepSORT_Face(handle, &face, &tracker)
+                           : CVI_TDL_DeepSORT_Obj(handle, &obj, &tracker, false);
+      track_time.add(elapsed_ms(t0));
+    }
+
+    uint32_t size = model->is_face ? face.size : obj.size;
+    replayed.resize(size);
+    for (uint32_t k = 0; k < size; k++) {
+      replayed[k].bbox = model->is_face ? face.info[k].bbox : obj.info[k].bbox;
+      replayed[k].classes = model->is_face ? 0 : obj.info[k].classes;
+    }
+    num_results += size;
+    if (!same_boxes(captured, replayed)) mismatches++;
+    CVI_TDL_Free(&obj);
+    CVI_TDL_Free(&face);
+    CVI_TDL_Free(&tracker);
+    if (ret != CVI_SUCCESS) {
+      printf("replay failed at call %zu with %#x!\n", i, ret);
+      break;
+    }
+  }
+
+  if (i > 0) {
+    printf("calls %zu, results %.2f per call, mismatched calls %zu, wall %.1f ms\n", i,
+           (double)num_results / i, mismatches, elapsed_ms(start));
+    printf("postprocess  avg %8.3f ms  max %8.3f ms\n", infer_time.total_ms / i,
+           infer_time.max_ms);
+    if (track) {
+      printf("tracker      avg %8.3f ms  max %8.3f ms\n", track_time.total_ms / i,
+             track_time.max_ms);
+    }
+  }
+
+  if (allocated) CVI_SYS_IonFree(frame.stVFrame.u64PhyAddr[0], frame.stVFrame.pu8VirAddr[0]);
+  CVI_TDL_DestroyHandle(handle);
+  return ret == CVI_SUCCESS && mismatches == 0 ? 0 : -1;
+}
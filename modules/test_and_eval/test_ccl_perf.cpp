@@ -0,0 +1,151 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "ccl.hpp"
+#include "perf_utils.hpp"
+
+// host benchmark and check of the run based connected component labeller against a flood fill
+// usage: test_ccl_perf [height] [width] [density%] [loops]
+
+struct RefStats {
+  uint32_t area;
+  int x0, y0, x1, y1;
+  double sum_x, sum_y;
+};
+
+// breadth first flood fill, components are numbered in raster order of their first pixel
+static std::vector<RefStats> reference_ccl(const uint8_t *mask, int width, int height,
+                                           int connectivity, std::vector<uint32_t> &labels) {
+  std::vector<RefStats> stats;
+  std::vector<int> queue;
+  labels.assign((size_t)width * height, 0);
+  for (int i = 0; i < width * height; i++) {
+    if (mask[i] == 0 || labels[i] != 0) continue;
+    uint32_t label = stats.size() + 1;
+    RefStats st = {0, width, height, -1, -1, 0, 0};
+    queue.clear();
+    queue.push_back(i);
+    labels[i] = label;
+    for (size_t q = 0; q < queue.size(); q++) {
+      int x = queue[q] % width, y = queue[q] / width;
+      st.area++;
+      st.sum_x += x;
+      st.sum_y += y;
+      st.x0 = std::min(st.x0, x);
+      st.y0 = std::min(st.y0, y);
+      st.x1 = std::max(st.x1, x);
+      st.y1 = std::max(st.y1, y);
+      for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+          if ((dx == 0 && dy == 0) || (connectivity == 4 && dx != 0 && dy != 0)) continue;
+          int nx = x + dx, ny = y + dy;
+          if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+          int n = ny * width + nx;
+          if (mask[n] != 0 && labels[n] == 0) {
+            labels[n] = label;
+            queue.push_back(n);
+          }
+        }
+      }
+    }
+    stats.push_back(st);
+  }
+  return stats;
+}
+
+int main(int argc, char *argv[]) {
+  int height = argc > 1 ? atoi(argv[1]) : 720;
+  int width = argc > 2 ? atoi(argv[2]) : 1280;
+  int density = argc > 3 ? atoi(argv[3]) : 45;
+  int loops = argc > 4 ? atoi(argv[4]) : 10;
+  if (height <= 0 || width <= 0 || density < 0 || density > 100 || loops <= 0) {
+    printf("usage: %s [height] [width] [density%%] [loops]\n", argv[0]);
+    return -1;
+  }
+
+  // random noise gives far more blobs than the previous 200 label limit
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> val(0, 99);
+  std::vector<uint8_t> mask((size_t)width * height);
+  for (auto &m : mask) m = val(rng) < density ? 255 : 0;
+  printf("mask:%dx%d, density:%d%%\n", width, height, density);
+
+  int ret = 0;
+  std::vector<uint32_t> ref_labels, labels(mask.size());
+  for (int connectivity = 4; connectivity <= 8; connectivity += 4) {
+    cvitdl::CCLConfig config;
+    config.connectivity = connectivity;
+    cvitdl::ConnectedComponents ccl(config);
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<RefStats> ref = reference_ccl(mask.data(), width, height, connectivity, ref_labels);
+    double ref_ms = elapsed_ms(t0);
+
+    uint32_t num = 0;
+    t0 = std::chrono::steady_clock::now();
+    for (int l = 0; l < loops; l++) {
+      num = ccl.label(mask.data(), width, height, width);
+    }
+    double ms = elapsed_ms(t0) / loops;
+    printf("%d-connectivity: %u components, flood fill %.3f ms, run based %.3f ms\n",
+           connectivity, num, ref_ms, ms);
+
+    // both number components in raster order of their first pixel
+    ccl.labelMap(labels.data(), width);
+    bool ok = num == ref.size() && labels == ref_labels;
+    for (uint32_t i = 0; ok && i < num; i++) {
+      const cvitdl::CCLStats &st = ccl.stats()[i];
+      ok = st.area == ref[i].area && st.x0 == ref[i].x0 && st.y0 == ref[i].y0 &&
+           st.x1 == ref[i].x1 && st.y1 == ref[i].y1 &&
+           fabs(st.cx - ref[i].sum_x / ref[i].area) < 1e-2 &&
+           fabs(st.cy - ref[i].sum_y / ref[i].area) < 1e-2;
+    }
+    if (!ok) {
+      printf("%d-connectivity result mismatch\n", connectivity);
+      ret = -1;
+    }
+  }
+
+  // 2x2 blocks with at least 2 foreground pixels, as motion detection masks are usually labelled
+  cvitdl::CCLConfig config;
+  config.downsample = 2;
+  config.block_threshold = 2;
+  cvitdl::ConnectedComponents ccl(config);
+  auto t0 = std::chrono::steady_clock::now();
+  uint32_t num = 0;
+  for (int l = 0; l < loops; l++) {
+    num = ccl.label(mask.data(), width, height, width);
+  }
+  printf("2x2 blocks: %u components, run based %.3f ms\n", num, elapsed_ms(t0) / loops);
+
+  // 256x256 blocks count more pixels than 16 bits hold, a full block is still foreground
+  cvitdl::CCLConfig big_config;
+  big_config.downsample = 256;
+  big_config.block_threshold = 256 * 256;
+  cvitdl::ConnectedComponents big_ccl(big_config);
+  std::vector<uint8_t> full((size_t)width * height, 255);
+  uint32_t big_num = big_ccl.label(full.data(), width, height, width);
+  const uint32_t full_blocks = (uint32_t)(width / 256) * (uint32_t)(height / 256);
+  if (full_blocks > 0 && (big_num != 1 || big_ccl.stats()[0].area != full_blocks * 256 * 256)) {
+    printf("256x256 blocks result mismatch\n");
+    ret = -1;
+  }
+
+  // legacy motion detection entry
+  void *inst = create_connect_instance();
+  int num_boxes = 0;
+  t0 = std::chrono::steady_clock::now();
+  for (int l = 0; l < loops; l++) {
+    extract_connected_component(mask.data(), width, height, width, 64, inst, &num_boxes);
+  }
+  printf("motion detection boxes: %d, %.3f ms\n", num_boxes, elapsed_ms(t0) / loops);
+  destroy_connected_component(inst);
+
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
@@ -0,0 +1,171 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "ctc_decoder.hpp"
+#include "perf_utils.hpp"
+
+// host benchmark of the shared CTC decoder on synthetic plate scores
+// usage: test_ctc_decoder_perf [num_plates] [loops]
+
+#define STEPS 18
+#define CLASSES 80
+#define BLANK (CLASSES - 1)
+
+// class-major logits favouring a random label or blank at every step
+static void make_scores(std::mt19937 &rng, std::vector<float> &scores) {
+  std::normal_distribution<float> noise(0.f, 1.f);
+  std::uniform_int_distribution<int> label(0, CLASSES - 1);
+  scores.resize(CLASSES * STEPS);
+  for (auto &s : scores) s = noise(rng);
+  for (int t = 0; t < STEPS; t++) {
+    int c = (t % 2) ? BLANK : label(rng);
+    scores[c * STEPS + t] += 6.f;
+  }
+}
+
+// the per-plate decode the plate models used before: new[] codes, strided column argmax, the
+// code length and class count picked at runtime from the plate format
+static void reference_greedy(const float *y, int code_length, int chars_num,
+                             std::vector<int> &labels) {
+  int *code = new int[code_length];
+  for (int i = 0; i < code_length; i++) {
+    float max_value = y[i];
+    code[i] = 0;
+    for (int j = 1; j < chars_num; j++) {
+      if (y[j * code_length + i] > max_value) {
+        max_value = y[j * code_length + i];
+        code[i] = j;
+      }
+    }
+  }
+  labels.clear();
+  int previous = -1;
+  for (int i = 0; i < code_length; i++) {
+    if (code[i] != previous && code[i] != BLANK) labels.push_back(code[i]);
+    previous = code[i];
+  }
+  delete[] code;
+}
+
+int main(int argc, char *argv[]) {
+  int num_plates = argc > 1 ? atoi(argv[1]) : 64;
+  int loops = argc > 2 ? atoi(argv[2]) : 100;
+  if (num_plates <= 0 || loops <= 0) {
+    printf("usage: %s [num_plates] [loops]\n", argv[0]);
+    return -1;
+  }
+
+  std::mt19937 rng(1234);
+  std::vector<std::vector<float>> plates(num_plates);
+  for (auto &p : plates) make_scores(rng, p);
+
+  cvitdl::CTCDecoder decoder(BLANK);
+  cvitdl::CTCResult result;
+  std::vector<int> ref;
+  int ret = 0;
+  // the plate format, and with it the dimensions, is only known at runtime
+  volatile int format_steps = STEPS, format_classes = CLASSES;
+  const int steps = format_steps, classes = format_classes;
+
+  // best of a few runs, greedy without confidences does the work of the reference and must not
+  // be slower than it
+  double reference_us = 1e30, greedy_us = 1e30, conf_us = 1e30;
+  for (int run = 0; run < 3; run++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int l = 0; l < loops; l++) {
+      for (auto &p : plates) reference_greedy(p.data(), steps, classes, ref);
+    }
+    reference_us = std::min(reference_us, elapsed_ms(t0) * 1000 / loops / num_plates);
+    for (bool conf : {false, true}) {
+      decoder.setLogitConfidences(conf);
+      t0 = std::chrono::steady_clock::now();
+      for (int l = 0; l < loops; l++) {
+        for (auto &p : plates) {
+          decoder.greedy({p.data(), STEPS, CLASSES, 1, STEPS, true}, &result);
+        }
+      }
+      double us = elapsed_ms(t0) * 1000 / loops / num_plates;
+      (conf ? conf_us : greedy_us) = std::min(conf ? conf_us : greedy_us, us);
+    }
+  }
+  printf("reference greedy: %.3f us/plate\n", reference_us);
+  printf("greedy:           %.3f us/plate\n", greedy_us);
+  printf("greedy + conf:    %.3f us/plate\n", conf_us);
+  if (greedy_us > reference_us) {
+    printf("greedy slower than the reference\n");
+    ret = -1;
+  }
+
+  // any plate of 7 labels from a 4 letter prefix set and digits
+  cvitdl::CTCLabelConstraint layout;
+  std::vector<int> digits;
+  for (int c = 43; c <= 52; c++) digits.push_back(c);
+  layout.addSlot({0, 1, 2, 3});
+  layout.addSlot(digits, 4, 6);
+  for (int width : {4, 8, 16}) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int l = 0; l < loops; l++) {
+      for (auto &p : plates) {
+        decoder.beamSearch({p.data(), STEPS, CLASSES, 1, STEPS, true}, width, nullptr, &result);
+      }
+    }
+    printf("beam %2d:          %.3f us/plate\n", width,
+           elapsed_ms(t0) * 1000 / loops / num_plates);
+    t0 = std::chrono::steady_clock::now();
+    for (int l = 0; l < loops; l++) {
+      for (auto &p : plates) {
+        decoder.beamSearch({p.data(), STEPS, CLASSES, 1, STEPS, true}, width, &layout, &result);
+      }
+    }
+    printf("beam %2d + layout: %.3f us/plate\n", width,
+           elapsed_ms(t0) * 1000 / loops / num_plates);
+  }
+
+  // greedy matches the reference on both layouts, beam search keeps to the layout
+  std::vector<float> step_major(CLASSES * STEPS);
+  for (auto &p : plates) {
+    reference_greedy(p.data(), steps, classes, ref);
+    decoder.setLogitConfidences(false);
+    decoder.greedy({p.data(), STEPS, CLASSES, 1, STEPS, true}, &result);
+    if (result.labels != ref || !result.confidences.empty()) ret = -1;
+    decoder.setLogitConfidences(true);
+    decoder.greedy({p.data(), STEPS, CLASSES, 1, STEPS, true}, &result);
+    if (result.labels != ref || result.confidences.size() != ref.size()) ret = -1;
+    for (int t = 0; t < STEPS; t++) {
+      for (int c = 0; c < CLASSES; c++) step_major[t * CLASSES + c] = p[c * STEPS + t];
+    }
+    decoder.greedy({step_major.data(), STEPS, CLASSES, CLASSES, 1, true}, &result);
+    if (result.labels != ref) ret = -1;
+    // on peaked scores the best prefix is the best path
+    decoder.beamSearch({p.data(), STEPS, CLASSES, 1, STEPS, true}, 8, nullptr, &result);
+    if (result.labels != ref) ret = -1;
+  }
+
+  // the best path breaks the layout, the second best label at step 2 fixes it
+  std::vector<float> probs(CLASSES * STEPS, 0.f);
+  const int path[STEPS] = {1, BLANK, 60, BLANK, 43, 44, BLANK, 45, BLANK, 46, 46,
+                           BLANK, 47, BLANK, BLANK, BLANK, BLANK, BLANK};
+  for (int t = 0; t < STEPS; t++) probs[path[t] * STEPS + t] = 0.9f;
+  probs[BLANK * STEPS + 2] = 0.02f;
+  probs[50 * STEPS + 2] = 0.08f;
+  for (int t = 0; t < STEPS; t++) {
+    float rest = 0.1f / (CLASSES - 1);
+    for (int c = 0; c < CLASSES; c++) {
+      if (probs[c * STEPS + t] == 0.f) probs[c * STEPS + t] = t == 2 ? 0.f : rest;
+    }
+  }
+  decoder.greedy({probs.data(), STEPS, CLASSES, 1, STEPS, false}, &result);
+  const std::vector<int> greedy_labels = {1, 60, 43, 44, 45, 46, 47};
+  if (result.labels != greedy_labels) ret = -1;
+  bool found =
+      decoder.beamSearch({probs.data(), STEPS, CLASSES, 1, STEPS, false}, 8, &layout, &result);
+  const std::vector<int> layout_labels = {1, 50, 43, 44, 45, 46, 47};
+  if (!found || result.labels != layout_labels || result.confidences.size() != 7) ret = -1;
+
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
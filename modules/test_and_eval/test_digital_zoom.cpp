@@ -0,0 +1,167 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+#include "digital_tracking/zoom_predictor.hpp"
+
+// check of the predictive digital zoom filters: the spring against its closed form, the group
+// box filter on constant motion and the virtual camera on still, jittering and moving targets
+// usage: test_digital_zoom
+
+using cvitdl::service::Rect;
+using cvitdl::service::SpringAxis;
+using cvitdl::service::TrackAxis;
+using cvitdl::service::ZoomPredictor;
+
+#define WIDTH 1920.f
+#define HEIGHT 1080.f
+#define DT (1.f / 30)
+
+static int check_spring() {
+  // from rest the critically damped spring reaches the goal without overshoot
+  const float omega = 8.f;
+  SpringAxis s{100.f, 0.f};
+  float prev = s.pos;
+  for (int i = 0; i < 300; i++) {
+    s.step(400.f, omega, DT);
+    if (s.pos < prev - 1e-3f || s.pos > 400.f + 1e-3f) {
+      printf("spring overshoots at step %d: %f\n", i, s.pos);
+      return -1;
+    }
+    prev = s.pos;
+  }
+  if (fabsf(s.pos - 400.f) > 0.01f || fabsf(s.vel) > 0.01f) {
+    printf("spring does not settle: %f %f\n", s.pos, s.vel);
+    return -1;
+  }
+
+  // the step is exact, two half steps equal one step and the closed form at any time
+  SpringAxis one{-50.f, 30.f}, two = one;
+  one.step(20.f, omega, 0.1f);
+  two.step(20.f, omega, 0.05f);
+  two.step(20.f, omega, 0.05f);
+  const float t = 0.1f, x0 = -70.f, v0 = 30.f;
+  const float expect = 20.f + (x0 + (v0 + omega * x0) * t) * expf(-omega * t);
+  if (fabsf(one.pos - two.pos) > 1e-3f || fabsf(one.vel - two.vel) > 1e-2f ||
+      fabsf(one.pos - expect) > 1e-3f) {
+    printf("spring step is not exact: %f %f %f\n", one.pos, two.pos, expect);
+    return -1;
+  }
+
+  // a huge step lands on the goal instead of diverging
+  SpringAxis big{0.f, 1000.f};
+  big.step(10.f, omega, 100.f);
+  if (fabsf(big.pos - 10.f) > 1e-3f || fabsf(big.vel) > 1e-3f) {
+    printf("spring diverges on a long step: %f %f\n", big.pos, big.vel);
+    return -1;
+  }
+  return 0;
+}
+
+static int check_track() {
+  // constant motion is tracked with no lag once the velocity converged
+  TrackAxis a{0.f, 0.f};
+  const float vel = 120.f;
+  for (int i = 1; i <= 600; i++) a.update(vel * DT * i, DT);
+  if (fabsf(a.vel - vel) > 0.5f || fabsf(a.pos - vel * DT * 600) > 0.5f) {
+    printf("track filter lags: pos %f vel %f\n", a.pos, a.vel);
+    return -1;
+  }
+  return 0;
+}
+
+static Rect box_at(float cx, float cy, float w) {
+  const float h = w * HEIGHT / WIDTH;
+  return Rect(cx - w / 2, cx + w / 2, cy - h / 2, cy + h / 2);
+}
+
+static int check_predictor() {
+  // the defaults of CVI_TDL_Service_DigitalZoom_GetDefaultConfig
+  cvtdl_service_dt_config_t config = {};
+  config.predictive = true;
+  config.smooth_time = 0.5f;
+  config.predict_time = 0.2f;
+  config.dead_zone = 0.1f;
+  config.settle_zone = 0.02f;
+  config.frame_interval = DT;
+  ZoomPredictor zoom;
+  Rect prev(0, WIDTH - 1, 0, HEIGHT - 1);
+  Rect rect;
+
+  // a still target is reached from the full frame, with the aspect of the frame
+  for (int i = 0; i < 90; i++) {
+    rect = box_at(600.f, 400.f, 640.f);
+    zoom.predict(config, WIDTH, HEIGHT, DT, prev, &rect);
+    if (fabsf((rect.b - rect.t) / (rect.r - rect.l) - HEIGHT / WIDTH) > 1e-3f) {
+      printf("crop loses the frame aspect at %d\n", i);
+      return -1;
+    }
+    prev = rect;
+  }
+  if (fabsf((rect.l + rect.r) / 2 - 600.f) > 0.02f * 640.f ||
+      fabsf(rect.r - rect.l - 640.f) > 0.02f * 640.f || zoom.following()) {
+    printf("crop does not settle on a still target\n");
+    return -1;
+  }
+
+  // jitter below dead_zone leaves the settled camera where it is
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> jitter(-0.04f * 640.f, 0.04f * 640.f);
+  const Rect settled = rect;
+  for (int i = 0; i < 150; i++) {
+    rect = box_at(600.f + jitter(rng), 400.f + jitter(rng), 640.f + jitter(rng));
+    zoom.predict(config, WIDTH, HEIGHT, DT, prev, &rect);
+    if (zoom.following() || fabsf(rect.l - settled.l) > 1e-3f ||
+        fabsf(rect.t - settled.t) > 1e-3f) {
+      printf("camera follows jitter inside the dead zone at %d\n", i);
+      return -1;
+    }
+    prev = rect;
+  }
+
+  // a target moving at constant speed is followed with a lag well under the dead zone, the
+  // prediction compensates most of the spring lag
+  const float vel = 150.f;
+  float cx = 600.f;
+  for (int i = 0; i < 180; i++) {
+    cx += vel * DT;
+    rect = box_at(cx, 400.f, 640.f);
+    zoom.predict(config, WIDTH, HEIGHT, DT, prev, &rect);
+    prev = rect;
+  }
+  const float lag = cx - (rect.l + rect.r) / 2;
+  if (!zoom.following() || fabsf(lag) > 0.5f * config.dead_zone * 640.f) {
+    printf("camera lags a moving target by %f\n", lag);
+    return -1;
+  }
+
+  // after the target stops the camera settles on it and holds again
+  for (int i = 0; i < 120; i++) {
+    rect = box_at(cx, 400.f, 640.f);
+    zoom.predict(config, WIDTH, HEIGHT, DT, prev, &rect);
+    prev = rect;
+  }
+  if (zoom.following() || fabsf((rect.l + rect.r) / 2 - cx) > 0.02f * 640.f) {
+    printf("camera does not settle after the target stopped\n");
+    return -1;
+  }
+
+  // reset starts over from the given crop
+  zoom.reset();
+  Rect full(0, WIDTH - 1, 0, HEIGHT - 1);
+  rect = box_at(600.f, 400.f, 640.f);
+  zoom.predict(config, WIDTH, HEIGHT, DT, full, &rect);
+  if (rect.r - rect.l < 0.9f * WIDTH) {
+    printf("reset does not start from the previous crop\n");
+    return -1;
+  }
+  return 0;
+}
+
+int main() {
+  int ret = check_spring();
+  ret |= check_track();
+  ret |= check_predictor();
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
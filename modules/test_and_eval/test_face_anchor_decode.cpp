@@ -0,0 +1,410 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "core/cvi_tdl_types_mem.h"
+#include "core/cvi_tdl_types_mem_internal.h"
+#include "core_utils.hpp"
+#include "face_detection/retina_face/face_anchor_table.hpp"
+#include "object_utils.hpp"
+#include "rescale_utils.hpp"
+
+// check of the retinaface / scrfd anchor table decode against the per-box decode it replaced:
+// fixed output tensors of a small model go through both, with and without the vpss rescale, and
+// the face metas must hold the same boxes, scores and landmarks
+// usage: test_face_anchor_decode
+
+using namespace cvitdl;
+
+#define FACE_POINTS_SIZE 5
+#define NMS_THRESHOLD 0.4
+
+typedef struct {
+  const char *name;
+  bool scrfd;
+  PROCESS process;
+  bool hardhat;
+  bool has_landmark;
+  uint32_t batch;
+  int image_width;
+  int image_height;
+  float threshold;
+
+  std::vector<int> strides;
+  std::vector<int> num_anchor;
+  std::vector<int> feat_w;
+  std::vector<int> feat_h;
+  std::vector<std::vector<anchor_box>> anchors;      // retinaface, anchors_plane order
+  std::vector<std::vector<std::vector<float>>> grids;  // scrfd, mmdet grid anchors
+  // output tensors of every level, batch x channel x h x w
+  std::vector<std::vector<float>> score;
+  std::vector<std::vector<float>> bbox;
+  std::vector<std::vector<float>> landmark;
+  std::vector<size_t> score_step;
+  std::vector<size_t> bbox_step;
+  std::vector<size_t> landmark_step;
+} face_model_t;
+
+static uint32_t g_seed = 12345;
+
+static float uniform(float lo, float hi) {
+  g_seed = g_seed * 1664525u + 1013904223u;
+  return lo + (hi - lo) * ((g_seed >> 8) / 16777216.f);
+}
+
+static std::vector<anchor_cfg> anchor_config(const std::vector<int> &strides,
+                                             const std::vector<std::vector<int>> &scales) {
+  std::vector<anchor_cfg> cfg;
+  for (size_t i = 0; i < strides.size(); i++) {
+    anchor_cfg tmp;
+    tmp.SCALES = scales[i];
+    tmp.BASE_SIZE = 16;
+    tmp.RATIOS = {1.0};
+    tmp.ALLOWED_BORDER = 9999;
+    tmp.STRIDE = strides[i];
+    cfg.push_back(tmp);
+  }
+  return cfg;
+}
+
+static void init_model(face_model_t *m) {
+  std::vector<std::vector<int>> scales;
+  if (!m->scrfd && m->process == CAFFE) {
+    m->strides = {32, 16, 8};
+    scales = {{32, 16}, {8, 4}, {2, 1}};
+  } else {
+    m->strides = {8, 16, 32};
+    scales = {{1, 2}, {4, 8}, {16, 32}};
+  }
+  std::vector<anchor_cfg> cfg = anchor_config(m->strides, scales);
+  std::vector<std::vector<anchor_box>> anchors_fpn =
+      generate_anchors_fpn(false, cfg, m->scrfd ? PYTORCH : m->process);
+
+  for (size_t i = 0; i < cfg.size(); i++) {
+    int stride = m->strides[i];
+    int feat_w = ceil(m->image_width / float(stride));
+    int feat_h = ceil(m->image_height / float(stride));
+    int num_anchor = cfg[i].SCALES.size();
+    size_t count = feat_w * feat_h;
+    m->feat_w.push_back(feat_w);
+    m->feat_h.push_back(feat_h);
+    m->num_anchor.push_back(num_anchor);
+    if (m->scrfd) {
+      std::vector<std::vector<float>> base_anchors =
+          generate_mmdet_base_anchors(cfg[i].BASE_SIZE, 0, cfg[i].RATIOS, cfg[i].SCALES);
+      m->grids.push_back(generate_mmdet_grid_anchors(feat_w, feat_h, stride, base_anchors));
+    } else {
+      m->anchors.push_back(anchors_plane(feat_h, feat_w, stride, anchors_fpn[i]));
+    }
+
+    // score planes: face only for scrfd, background + face or background + no hardhat + hardhat
+    int score_planes = m->scrfd ? 1 : (m->hardhat ? 3 : 2);
+    m->score_step.push_back(score_planes * num_anchor * count);
+    m->bbox_step.push_back(4 * num_anchor * count);
+    m->landmark_step.push_back(m->has_landmark ? 10 * num_anchor * count : 0);
+
+    std::vector<float> score(m->batch * m->score_step[i]);
+    for (float &v : score) {
+      v = m->hardhat ? uniform(0, 0.6) : uniform(0, 1);
+    }
+    std::vector<float> bbox(m->batch * m->bbox_step[i]);
+    for (size_t k = 0; k < bbox.size(); k++) {
+      size_t channel = (k / count) % 4;
+      if (m->scrfd) {
+        bbox[k] = uniform(0.5, 4);  // distances to the grid center
+      } else {
+        bbox[k] = channel < 2 ? uniform(-0.6, 0.6) : uniform(-1.5, 1.5);
+      }
+    }
+    std::vector<float> landmark(m->batch * m->landmark_step[i]);
+    for (float &v : landmark) {
+      v = uniform(-2, 2);
+    }
+    m->score.push_back(score);
+    m->bbox.push_back(bbox);
+    m->landmark.push_back(landmark);
+  }
+}
+
+// the tables as RetinaFace / ScrFDFace::onModelOpened build them
+static std::vector<FaceAnchorLevel> make_levels(const face_model_t &m) {
+  std::vector<FaceAnchorLevel> levels(m.strides.size());
+  for (size_t i = 0; i < levels.size(); i++) {
+    FaceAnchorLevel &level = levels[i];
+    level.stride = m.strides[i];
+    level.count = m.feat_w[i] * m.feat_h[i];
+    level.num_anchor = m.num_anchor[i];
+    if (m.scrfd) {
+      SetScrFDFaceAnchors(m.grids[i], &level);
+      level.score = m.score[i].data();
+    } else {
+      SetRetinaFaceAnchors(m.anchors[i], &level);
+      level.score = m.score[i].data() + m.score_step[i] / (m.hardhat ? 3 : 2);
+    }
+    level.score_step = m.score_step[i];
+    level.bbox = m.bbox[i].data();
+    level.bbox_step = m.bbox_step[i];
+    if (m.has_landmark) {
+      level.landmark = m.landmark[i].data();
+      level.landmark_step = m.landmark_step[i];
+    }
+  }
+  return levels;
+}
+
+static void decode_tables(const face_model_t &m, bool rescale, int frame_width, int frame_height,
+                          cvtdl_face_t *meta) {
+  std::vector<FaceAnchorLevel> levels = make_levels(m);
+  std::vector<FaceCandidate> candidates, candidates_nms;
+  for (uint32_t b = 0; b < m.batch; b++) {
+    candidates.clear();
+    for (size_t i = 0; i < levels.size(); i++) {
+      if (m.scrfd) {
+        DecodeScrFDFaceLevel(levels[i], i, b, m.threshold, candidates);
+      } else {
+        DecodeRetinaFaceLevel(levels[i], i, b, m.process, m.hardhat, m.threshold, candidates);
+      }
+    }
+    FaceCandidatesToMeta(candidates, candidates_nms, levels, b, NMS_THRESHOLD, rescale,
+                         m.image_width, m.image_height, frame_width, frame_height, &meta[b]);
+  }
+}
+
+// the per-box decode of the retinaface / scrfd outputParser before the anchor tables
+
+static void bbox_pred(const anchor_box &anchor, float *regress, cvtdl_bbox_t &bbox,
+                      PROCESS process) {
+  float width = anchor.x2 - anchor.x1 + 1;
+  float height = anchor.y2 - anchor.y1 + 1;
+
+  if (process == CAFFE) {
+    float ctr_x = anchor.x1 + 0.5 * (width - 1.0);
+    float ctr_y = anchor.y1 + 0.5 * (height - 1.0);
+
+    float pred_ctr_x = regress[0] * width + ctr_x;
+    float pred_ctr_y = regress[1] * height + ctr_y;
+    float pred_w = FastExp(regress[2]) * width;
+    float pred_h = FastExp(regress[3]) * height;
+
+    bbox.x1 = pred_ctr_x - 0.5 * (pred_w - 1.0);
+    bbox.y1 = pred_ctr_y - 0.5 * (pred_h - 1.0);
+    bbox.x2 = pred_ctr_x + 0.5 * (pred_w - 1.0);
+    bbox.y2 = pred_ctr_y + 0.5 * (pred_h - 1.0);
+  } else {
+    float ctr_x = anchor.x1 + 0.5 * (width);
+    float ctr_y = anchor.y1 + 0.5 * (height);
+
+    float pred_ctr_x = regress[0] * 0.1 * width + ctr_x;
+    float pred_ctr_y = regress[1] * 0.1 * height + ctr_y;
+    float pred_w = FastExp(regress[2] * 0.2) * width;
+    float pred_h = FastExp(regress[3] * 0.2) * height;
+
+    bbox.x1 = pred_ctr_x - 0.5 * (pred_w);
+    bbox.y1 = pred_ctr_y - 0.5 * (pred_h);
+    bbox.x2 = pred_ctr_x + 0.5 * (pred_w);
+    bbox.y2 = pred_ctr_y + 0.5 * (pred_h);
+  }
+}
+
+static void landmark_pred(const anchor_box &anchor, cvtdl_pts_t &facePt) {
+  float width = anchor.x2 - anchor.x1 + 1;
+  float height = anchor.y2 - anchor.y1 + 1;
+  float ctr_x = anchor.x1 + 0.5 * (width - 1.0);
+  float ctr_y = anchor.y1 + 0.5 * (height - 1.0);
+
+  for (size_t j = 0; j < facePt.size; j++) {
+    facePt.x[j] = facePt.x[j] * width + ctr_x;
+    facePt.y[j] = facePt.y[j] * height + ctr_y;
+  }
+}
+
+static void decode_reference(const face_model_t &m, bool rescale, int frame_width,
+                             int frame_height, cvtdl_face_t *meta) {
+  for (uint32_t b = 0; b < m.batch; b++) {
+    std::vector<cvtdl_face_info_t> vec_bbox;
+    std::vector<cvtdl_face_info_t> vec_bbox_nms;
+    for (size_t i = 0; i < m.strides.size(); i++) {
+      int stride = m.strides[i];
+      const float *score_blob = m.score[i].data() + b * m.score_step[i];
+      const float *hardhat_score_blob = score_blob + m.score_step[i] / 3 * 2;
+      const float *nohardhat_score_blob = score_blob + m.score_step[i] / 3;
+      if (!m.scrfd && !m.hardhat) {
+        score_blob += m.score_step[i] / 2;
+      }
+      const float *bbox_blob = m.bbox[i].data() + b * m.bbox_step[i];
+      const float *landmark_blob = m.landmark[i].data() + b * m.landmark_step[i];
+      size_t count = m.feat_w[i] * m.feat_h[i];
+      for (int num = 0; num < m.num_anchor[i]; num++) {
+        for (size_t j = 0; j < count; j++) {
+          float conf;
+          float hardhat_score = m.scrfd ? 0 : -1;
+          if (m.hardhat) {
+            hardhat_score = hardhat_score_blob[j + count * num];
+            conf = hardhat_score + nohardhat_score_blob[j + count * num];
+            conf = std::min(float(conf), float(1));
+          } else {
+            conf = score_blob[j + count * num];
+          }
+          if (conf <= m.threshold) {
+            continue;
+          }
+          cvtdl_face_info_t box;
+          memset(&box, 0, sizeof(box));
+          box.pts.size = FACE_POINTS_SIZE;
+          box.pts.x = (float *)calloc(box.pts.size, sizeof(float));
+          box.pts.y = (float *)calloc(box.pts.size, sizeof(float));
+          box.bbox.score = conf;
+          box.hardhat_score = hardhat_score;
+
+          if (m.scrfd) {
+            const std::vector<float> &grid = m.grids[i][j + count * num];
+            float grid_cx = (grid[0] + grid[2]) / 2;
+            float grid_cy = (grid[1] + grid[3]) / 2;
+            box.bbox.x1 = grid_cx - bbox_blob[j + count * (0 + num * 4)] * stride;
+            box.bbox.y1 = grid_cy - bbox_blob[j + count * (1 + num * 4)] * stride;
+            box.bbox.x2 = grid_cx + bbox_blob[j + count * (2 + num * 4)] * stride;
+            box.bbox.y2 = grid_cy + bbox_blob[j + count * (3 + num * 4)] * stride;
+            for (size_t k = 0; k < box.pts.size; k++) {
+              box.pts.x[k] = landmark_blob[j + count * (num * 10 + k * 2)] * stride + grid_cx;
+              box.pts.y[k] = landmark_blob[j + count * (num * 10 + k * 2 + 1)] * stride + grid_cy;
+            }
+          } else {
+            float regress[4] = {
+                bbox_blob[j + count * (0 + num * 4)], bbox_blob[j + count * (1 + num * 4)],
+                bbox_blob[j + count * (2 + num * 4)], bbox_blob[j + count * (3 + num * 4)]};
+            const anchor_box &anchor = m.anchors[i][j + count * num];
+            bbox_pred(anchor, regress, box.bbox, m.process);
+            if (m.has_landmark) {
+              for (size_t k = 0; k < box.pts.size; k++) {
+                box.pts.x[k] = landmark_blob[j + count * (num * 10 + k * 2)];
+                box.pts.y[k] = landmark_blob[j + count * (num * 10 + k * 2 + 1)];
+              }
+              landmark_pred(anchor, box.pts);
+            }
+          }
+          vec_bbox.push_back(box);
+        }
+      }
+    }
+    NonMaximumSuppression(vec_bbox, vec_bbox_nms, NMS_THRESHOLD, 'u');
+
+    cvtdl_face_t *facemeta = &meta[b];
+    facemeta->width = m.image_width;
+    facemeta->height = m.image_height;
+    if (vec_bbox_nms.size() == 0) {
+      CVI_TDL_MemAlloc(0, facemeta);
+    } else {
+      CVI_TDL_MemAllocInit(vec_bbox_nms.size(), FACE_POINTS_SIZE, facemeta);
+      if (rescale) {
+        facemeta->width = frame_width;
+        facemeta->height = frame_height;
+      }
+      for (uint32_t i = 0; i < facemeta->size; ++i) {
+        clip_boxes(m.image_width, m.image_height, vec_bbox_nms[i].bbox);
+        cvtdl_face_info_t info = vec_bbox_nms[i];
+        if (rescale) {
+          info = info_rescale_c(m.image_width, m.image_height, frame_width, frame_height,
+                                vec_bbox_nms[i]);
+        }
+        facemeta->info[i].bbox = info.bbox;
+        facemeta->info[i].hardhat_score = info.hardhat_score;
+        for (int j = 0; j < FACE_POINTS_SIZE; ++j) {
+          facemeta->info[i].pts.x[j] = info.pts.x[j];
+          facemeta->info[i].pts.y[j] = info.pts.y[j];
+        }
+        if (rescale) {
+          CVI_TDL_FreeCpp(&info);
+        }
+      }
+    }
+    for (size_t i = 0; i < vec_bbox.size(); ++i) {
+      CVI_TDL_FreeCpp(&vec_bbox[i].pts);
+    }
+  }
+}
+
+static bool near(float a, float b) { return fabsf(a - b) <= 1e-3f + 1e-5f * fabsf(b); }
+
+static int compare(const face_model_t &m, const cvtdl_face_t *got, const cvtdl_face_t *expected,
+                   const char *mode) {
+  for (uint32_t b = 0; b < m.batch; b++) {
+    const cvtdl_face_t &g = got[b];
+    const cvtdl_face_t &e = expected[b];
+    if (g.size != e.size || g.width != e.width || g.height != e.height) {
+      printf("%s %s batch %u: %u faces %ux%u instead of %u faces %ux%u\n", m.name, mode, b, g.size,
+             g.width, g.height, e.size, e.width, e.height);
+      return -1;
+    }
+    for (uint32_t i = 0; i < g.size; i++) {
+      const cvtdl_face_info_t &gi = g.info[i];
+      const cvtdl_face_info_t &ei = e.info[i];
+      bool same = near(gi.bbox.x1, ei.bbox.x1) && near(gi.bbox.y1, ei.bbox.y1) &&
+                  near(gi.bbox.x2, ei.bbox.x2) && near(gi.bbox.y2, ei.bbox.y2) &&
+                  gi.bbox.score == ei.bbox.score && gi.hardhat_score == ei.hardhat_score;
+      for (int k = 0; m.has_landmark && k < FACE_POINTS_SIZE; k++) {
+        same = same && near(gi.pts.x[k], ei.pts.x[k]) && near(gi.pts.y[k], ei.pts.y[k]);
+      }
+      if (!same) {
+        printf("%s %s batch %u face %u: (%f %f %f %f %f) instead of (%f %f %f %f %f)\n", m.name,
+               mode, b, i, gi.bbox.x1, gi.bbox.y1, gi.bbox.x2, gi.bbox.y2, gi.bbox.score,
+               ei.bbox.x1, ei.bbox.y1, ei.bbox.x2, ei.bbox.y2, ei.bbox.score);
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+int main() {
+  face_model_t models[4];
+  models[0].name = "retinaface caffe";
+  models[0].scrfd = false;
+  models[0].process = CAFFE;
+  models[0].hardhat = false;
+  models[0].has_landmark = true;
+  models[1] = models[0];
+  models[1].name = "retinaface pytorch";
+  models[1].process = PYTORCH;
+  models[2] = models[0];
+  models[2].name = "retinaface hardhat";
+  models[2].hardhat = true;
+  models[2].has_landmark = false;
+  models[3] = models[1];
+  models[3].name = "scrfd";
+  models[3].scrfd = true;
+
+  // frames wider, taller and of the size of the model input
+  const int frames[][2] = {{0, 0}, {1280, 720}, {300, 400}, {64, 48}};
+  int ret = 0;
+  for (face_model_t &m : models) {
+    m.batch = 2;
+    m.image_width = 64;
+    m.image_height = 48;
+    m.threshold = 0.5;
+    init_model(&m);
+    for (const auto &frame : frames) {
+      bool rescale = frame[0] != 0;
+      std::vector<cvtdl_face_t> got(m.batch), expected(m.batch);
+      memset(got.data(), 0, sizeof(cvtdl_face_t) * m.batch);
+      memset(expected.data(), 0, sizeof(cvtdl_face_t) * m.batch);
+      decode_tables(m, rescale, frame[0], frame[1], got.data());
+      decode_reference(m, rescale, frame[0], frame[1], expected.data());
+
+      char mode[32];
+      snprintf(mode, sizeof(mode), rescale ? "to %dx%d" : "no rescale", frame[0], frame[1]);
+      printf("%s %s: %u + %u faces\n", m.name, mode, got[0].size, got[1].size);
+      if (got[0].size == 0 || compare(m, got.data(), expected.data(), mode) != 0) {
+        ret = -1;
+      }
+      for (uint32_t b = 0; b < m.batch; b++) {
+        CVI_TDL_FreeCpp(&got[b]);
+        CVI_TDL_FreeCpp(&expected[b]);
+      }
+    }
+  }
+
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
@@ -0,0 +1,136 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <deque>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include "fall_detection/fall_history.hpp"
+
+// check of the fall detection histories against the standard containers they replaced:
+// RingHistory against a deque popped at the front, PersonTable against an unordered_map
+// usage: test_fall_history [num_ops]
+
+template <int N>
+static int check_ring(std::mt19937 &rng, int num_ops) {
+  std::uniform_int_distribution<int> val(-1000, 1000);
+  RingHistory<int, N> ring(7);
+  RingHistory<std::pair<float, float>, N> pairs(std::make_pair(0.f, 0.f));
+  std::deque<int> ref(N, 7);
+  std::deque<std::pair<float, float>> ref_pairs(N, std::make_pair(0.f, 0.f));
+  for (int op = 0; op < num_ops; op++) {
+    if (val(rng) > 990) {
+      // refill, as a history that restarts
+      int v = val(rng);
+      ring.fill(v);
+      ref.assign(N, v);
+    } else {
+      int v = val(rng);
+      ring.push(v);
+      ref.pop_front();
+      ref.push_back(v);
+      std::pair<float, float> p = std::make_pair((float)v, (float)-v);
+      pairs.push(p);
+      ref_pairs.pop_front();
+      ref_pairs.push_back(p);
+    }
+    long sum = 0;
+    for (int i = 0; i < N; i++) {
+      if (ring[i] != ref[i] || pairs[i] != ref_pairs[i]) {
+        printf("RingHistory<%d> differs at %d after %d ops\n", N, i, op);
+        return -1;
+      }
+      sum += ref[i];
+    }
+    if (ring.front() != ref.front() || ring.back() != ref.back() || ring.sum() != sum) {
+      printf("RingHistory<%d> front/back/sum differ after %d ops\n", N, op);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+struct Person {
+  uint64_t uid;
+  int frames;
+};
+
+static int check_table(std::mt19937 &rng, int num_ops) {
+  PersonTable<Person, 16> table;
+  std::unordered_map<uint64_t, int> ref;
+  std::unordered_map<uint64_t, Person *> pointers;
+  // few distinct ids so the table is often full and probe chains wrap around
+  std::uniform_int_distribution<int> id(0, 40);
+  std::uniform_int_distribution<int> action(0, 9);
+  for (int op = 0; op < num_ops; op++) {
+    uint64_t uid = (uint64_t)id(rng) * 1000003;
+    int a = action(rng);
+    if (a < 5) {
+      Person *p = table.insert(uid, {uid, 0});
+      bool full = ref.count(uid) == 0 && ref.size() == (size_t)table.capacity();
+      if (full != (p == nullptr)) {
+        printf("PersonTable insert of %lu %s after %d ops\n", (unsigned long)uid,
+               full ? "did not report full" : "failed", op);
+        return -1;
+      }
+      if (p == nullptr) continue;
+      if (ref.count(uid) && pointers[uid] != p) {
+        printf("PersonTable state of %lu moved after %d ops\n", (unsigned long)uid, op);
+        return -1;
+      }
+      p->frames++;
+      ref[uid]++;
+      pointers[uid] = p;
+    } else if (a < 8) {
+      table.erase(uid);
+      ref.erase(uid);
+      pointers.erase(uid);
+    } else {
+      // drop every person not seen for a while, erasing while iterating the pool
+      for (int i = 0; i < table.capacity(); i++) {
+        if (table.used(i) && table.at(i).frames % 3 == 0) {
+          ref.erase(table.uid(i));
+          pointers.erase(table.uid(i));
+          table.erase(table.uid(i));
+        }
+      }
+    }
+
+    if (table.size() != (int)ref.size()) {
+      printf("PersonTable holds %d persons instead of %zu after %d ops\n", table.size(),
+             ref.size(), op);
+      return -1;
+    }
+    for (int k = 0; k <= 40; k++) {
+      uint64_t u = (uint64_t)k * 1000003;
+      Person *p = table.find(u);
+      auto it = ref.find(u);
+      if ((p == nullptr) != (it == ref.end()) ||
+          (p != nullptr && (p->uid != u || p->frames != it->second || pointers[u] != p ||
+                            table.uid(table.index(p)) != u))) {
+        printf("PersonTable lookup of %lu differs after %d ops\n", (unsigned long)u, op);
+        return -1;
+      }
+    }
+  }
+  table.clear();
+  if (table.size() != 0 || table.find(0) != nullptr) {
+    printf("PersonTable not empty after clear\n");
+    return -1;
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  int num_ops = argc > 1 ? atoi(argv[1]) : 100000;
+  if (num_ops <= 0) {
+    printf("usage: %s [num_ops]\n", argv[0]);
+    return -1;
+  }
+  std::mt19937 rng(1234);
+  int ret = check_ring<3>(rng, num_ops);
+  ret |= check_ring<4>(rng, num_ops);
+  ret |= check_ring<6>(rng, num_ops);
+  ret |= check_table(rng, num_ops);
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
@@ -0,0 +1,225 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include "../evaluation/feature_eval/feature_eval.hpp"
+
+// check of the evaluation core against the Market1501 and LFW loops it replaced, on a small fixed
+// feature set with tied distances: duplicated and scaled gallery features, equal pair scores and
+// pairs labelled neither 0 nor 1
+// usage: test_feature_eval
+
+using namespace cvitdl::evaluation;
+
+#define DIM 32
+#define NUM_IDS 12
+#define MAX_RANK 20
+
+static uint32_t g_seed = 7;
+
+static int rand_int(int lo, int hi) {
+  g_seed = g_seed * 1664525u + 1013904223u;
+  return lo + (int)((g_seed >> 8) % (uint32_t)(hi - lo + 1));
+}
+
+static void add_feature(FeatureSet *set, int32_t id, int32_t cam, const std::vector<int8_t> &f) {
+  set->ids.push_back(id);
+  set->cams.push_back(cam);
+  set->features.insert(set->features.end(), f.begin(), f.end());
+}
+
+static void make_sets(FeatureSet *query, FeatureSet *gallery) {
+  std::vector<std::vector<int8_t>> centers(NUM_IDS, std::vector<int8_t>(DIM));
+  for (auto &c : centers) {
+    for (int8_t &v : c) v = rand_int(-40, 40);
+  }
+  auto sample = [&](int id, int noise) {
+    std::vector<int8_t> f(DIM);
+    for (int k = 0; k < DIM; k++) f[k] = centers[id][k] + rand_int(-noise, noise);
+    return f;
+  };
+  query->dim = gallery->dim = DIM;
+  for (int i = 0; i < 40; i++) {
+    int id = rand_int(0, NUM_IDS - 1);
+    add_feature(query, id, rand_int(0, 3), sample(id, 30));
+  }
+  for (int i = 0; i < 150; i++) {
+    int id = rand_int(0, NUM_IDS + 2);  // some ids are never queried
+    std::vector<int8_t> f = sample(id % NUM_IDS, 30);
+    add_feature(gallery, id, rand_int(0, 3), f);
+    if (i % 6 == 0) {
+      // same direction under another id and under the same id: equal distances to every query
+      add_feature(gallery, (id + 1) % NUM_IDS, rand_int(0, 3), f);
+      for (int8_t &v : f) v = std::max(-127, std::min(127, v * 2));
+      add_feature(gallery, id, rand_int(0, 3), f);
+    }
+  }
+  // a query whose id has no image from another camera is skipped
+  add_feature(query, NUM_IDS + 5, 0, sample(0, 30));
+}
+
+// market1501Eval::evalCMC before the evaluation core
+static void reference_ranking(const FeatureSet &query, const FeatureSet &gallery,
+                              std::vector<float> *all_cmc, float *map) {
+  all_cmc->assign(MAX_RANK, 0);
+  float all_ap = 0;
+  int num_valid_q = 0;
+  for (uint32_t i = 0; i < query.ids.size(); i++) {
+    std::vector<std::pair<float, int>> dist_mat;
+    int sum_of_elems = 0;
+    for (uint32_t j = 0; j < gallery.ids.size(); j++) {
+      if (query.ids[i] == gallery.ids[j] && query.cams[i] != gallery.cams[j]) {
+        sum_of_elems = 1;
+        break;
+      }
+    }
+    if (sum_of_elems == 0) continue;
+    for (uint32_t j = 0; j < gallery.ids.size(); j++) {
+      if (query.ids[i] == gallery.ids[j] && query.cams[i] == gallery.cams[j]) continue;
+      dist_mat.push_back(std::make_pair(
+          CosineDistance(&query.features[i * DIM], &gallery.features[j * DIM], DIM), j));
+    }
+    std::sort(dist_mat.begin(), dist_mat.end());
+
+    std::vector<int> raw_cmc(dist_mat.size(), 0);
+    for (uint32_t j = 0; j < raw_cmc.size(); j++) {
+      if (query.ids[i] == gallery.ids[dist_mat[j].second]) raw_cmc[j] = 1;
+    }
+    num_valid_q++;
+    int cum_sum = 0;
+    for (uint32_t j = 0; j < MAX_RANK; j++) {
+      cum_sum += raw_cmc[j];
+      if (cum_sum >= 1) (*all_cmc)[j]++;
+    }
+    int num_rel = 0;
+    float ap = 0;
+    for (uint32_t j = 0; j < raw_cmc.size(); j++) {
+      num_rel += raw_cmc[j];
+      ap += ((float)num_rel / (j + 1)) * raw_cmc[j];
+    }
+    all_ap += ap / num_rel;
+  }
+  for (uint32_t i = 0; i < MAX_RANK; i++) (*all_cmc)[i] /= num_valid_q;
+  *map = all_ap / num_valid_q;
+}
+
+static int check_ranking(const FeatureSet &query, const FeatureSet &gallery) {
+  const uint32_t nq = query.ids.size(), ng = gallery.ids.size();
+  std::vector<float> dist((size_t)nq * ng);
+  CosineDistanceMatrix(query.features.data(), nq, gallery.features.data(), ng, DIM, dist.data(), 3);
+  for (uint32_t i = 0; i < nq; i++) {
+    for (uint32_t j = 0; j < ng; j++) {
+      float d = CosineDistance(&query.features[i * DIM], &gallery.features[j * DIM], DIM);
+      if (dist[(size_t)i * ng + j] != d) {
+        printf("distance %u %u: %.9g instead of %.9g\n", i, j, dist[(size_t)i * ng + j], d);
+        return -1;
+      }
+    }
+  }
+
+  std::vector<float> cmc;
+  float map;
+  reference_ranking(query, gallery, &cmc, &map);
+  for (int threads : {1, 3}) {
+    RankingResult result;
+    EvalRanking(query, gallery, MAX_RANK, &result, threads);
+    printf("ranking, %d threads: %u valid queries, rank 1 %f, rank 5 %f, mAP %f (%f)\n", threads,
+           result.num_valid_query, result.cmc[0], result.cmc[4], result.mAP, map);
+    if (result.cmc != cmc || fabsf(result.mAP - map) > 1e-5f) {
+      for (uint32_t r = 0; r < MAX_RANK; r++) {
+        printf("rank %u: %f instead of %f\n", r + 1, result.cmc[r], cmc[r]);
+      }
+      return -1;
+    }
+  }
+  return 0;
+}
+
+static int check_roc() {
+  std::vector<int> labels;
+  std::vector<float> scores;
+  for (int i = 0; i < 300; i++) {
+    int label = rand_int(0, 20) == 0 ? 2 : rand_int(0, 1);
+    labels.push_back(label);
+    // coarse scores, many pairs share a threshold
+    scores.push_back((rand_int(0, 40) + label * 15) / 64.f);
+  }
+  const uint32_t size = labels.size();
+  std::vector<RocPoint> curve;
+  RocResult result;
+  EvalROC(labels.data(), scores.data(), size, &curve, &result);
+
+  // lfwEval::evalAUC before the evaluation core, every score as threshold
+  int pos = 0, neg = 0;
+  for (uint32_t i = 0; i < size; i++) {
+    if (labels[i] == 1) pos++;
+    if (labels[i] == 0) neg++;
+  }
+  std::vector<RocPoint> expected;
+  for (uint32_t i = 0; i < size; i++) {
+    float thr = scores[i];
+    uint32_t tpn = 0, fpn = 0;
+    for (uint32_t j = 0; j < size; j++) {
+      if (scores[j] >= thr) {
+        if (labels[j] == 1) {
+          tpn++;
+        } else {
+          fpn++;
+        }
+      }
+    }
+    expected.push_back({thr, (float)tpn / pos, (float)fpn / neg});
+  }
+  std::sort(expected.begin(), expected.end(),
+            [](const RocPoint &a, const RocPoint &b) { return a.thr > b.thr; });
+  if (curve.size() != size) {
+    printf("roc curve: %zu points instead of %u\n", curve.size(), size);
+    return -1;
+  }
+  for (uint32_t i = 0; i < size; i++) {
+    if (curve[i].thr != expected[i].thr || curve[i].tpr != expected[i].tpr ||
+        curve[i].fpr != expected[i].fpr) {
+      printf("roc point %u: (%f %f %f) instead of (%f %f %f)\n", i, curve[i].thr, curve[i].tpr,
+             curve[i].fpr, expected[i].thr, expected[i].tpr, expected[i].fpr);
+      return -1;
+    }
+  }
+
+  // area over the distinct thresholds, best accuracy over them and the reject-all threshold
+  double auc = 0;
+  float prev_tpr = 0, prev_fpr = 0;
+  float best_accuracy = (float)(size - pos) / size;
+  float best_thr = nextafterf(expected[0].thr, INFINITY);
+  for (uint32_t i = 0; i < size; i++) {
+    if (i + 1 < size && expected[i + 1].thr == expected[i].thr) continue;
+    auc += (expected[i].fpr - prev_fpr) * (expected[i].tpr + prev_tpr) / 2;
+    prev_tpr = expected[i].tpr;
+    prev_fpr = expected[i].fpr;
+    uint32_t tp = 0, fp = 0;
+    for (uint32_t j = 0; j < size; j++) {
+      if (scores[j] >= expected[i].thr) (labels[j] == 1 ? tp : fp)++;
+    }
+    float accuracy = (float)(tp + (size - pos) - fp) / size;
+    if (accuracy > best_accuracy) {
+      best_accuracy = accuracy;
+      best_thr = expected[i].thr;
+    }
+  }
+  printf("roc: auc %f (%f), best accuracy %f (%f) at %f (%f)\n", result.auc, auc,
+         result.best_accuracy, best_accuracy, result.best_thr, best_thr);
+  if (fabs(result.auc - auc) > 1e-6 || result.best_accuracy != best_accuracy ||
+      result.best_thr != best_thr) {
+    return -1;
+  }
+  return 0;
+}
+
+int main() {
+  FeatureSet query, gallery;
+  make_sets(&query, &gallery);
+  int ret = check_ranking(query, gallery);
+  if (check_roc() != 0) ret = -1;
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
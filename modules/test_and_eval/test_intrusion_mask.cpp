@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "area_detect/intrusion_detect.hpp"
+#include "core/core/cvtdl_errno.h"
+#include "core/cvi_tdl_types_mem.h"
+#include "core/cvi_tdl_types_mem_internal.h"
+
+// check of the batch region mask of IntrusionDetect against the single box run(), one detector
+// per region, and against the SAT loop over the convex parts, for random boxes and for boxes
+// touching the polygon edges and vertices. Coordinates are integers so the projections are exact.
+// usage: test_intrusion_mask
+
+using cvitdl::service::IntrusionDetect;
+
+typedef struct {
+  int x1, y1, x2, y2;
+} box_t;
+
+static uint32_t g_seed = 2024;
+
+static int rand_int(int lo, int hi) {
+  g_seed = g_seed * 1664525u + 1013904223u;
+  return lo + (int)((g_seed >> 8) % (uint32_t)(hi - lo + 1));
+}
+
+static int set_region(IntrusionDetect *detect, const std::vector<int> &xy) {
+  std::vector<float> x, y;
+  for (size_t i = 0; i < xy.size(); i += 2) {
+    x.push_back(xy[i]);
+    y.push_back(xy[i + 1]);
+  }
+  cvtdl_pts_t pts;
+  memset(&pts, 0, sizeof(pts));
+  pts.x = x.data();
+  pts.y = y.data();
+  pts.size = x.size();
+  return detect->setRegion(pts);
+}
+
+static std::vector<std::vector<float>> get_parts(IntrusionDetect *detect) {
+  cvtdl_pts_t **region_info = NULL;
+  uint32_t size = 0;
+  detect->getRegion(&region_info, &size);
+  std::vector<std::vector<float>> parts;
+  for (uint32_t i = 0; i < size; i++) {
+    std::vector<float> part;
+    for (uint32_t k = 0; k < region_info[i]->size; k++) {
+      part.push_back(region_info[i]->x[k]);
+      part.push_back(region_info[i]->y[k]);
+    }
+    parts.push_back(part);
+    CVI_TDL_FreeCpp(region_info[i]);
+    free(region_info[i]);
+  }
+  free(region_info);
+  return parts;
+}
+
+static void project(const std::vector<float> &xy, float ax, float ay, float *pmin, float *pmax) {
+  *pmin = *pmax = ax * xy[0] + ay * xy[1];
+  for (size_t k = 2; k < xy.size(); k += 2) {
+    float p = ax * xy[k] + ay * xy[k + 1];
+    *pmin = std::min(*pmin, p);
+    *pmax = std::max(*pmax, p);
+  }
+}
+
+// the SAT loop of run() before the index: edge normals of the part and the base axes
+static bool sat_intersect(const std::vector<std::vector<float>> &parts, const box_t &b) {
+  float x0 = std::min(b.x1, b.x2), x1 = std::max(b.x1, b.x2);
+  float y0 = std::min(b.y1, b.y2), y1 = std::max(b.y1, b.y2);
+  const std::vector<float> box = {x0, y0, x1, y0, x1, y1, x0, y1};
+  for (const std::vector<float> &part : parts) {
+    std::vector<float> axes = {1, 0, 0, 1};
+    size_t n = part.size() / 2;
+    for (size_t i = 0; i < n; i++) {
+      size_t j = (i + 1) % n;
+      axes.push_back(-(part[j * 2 + 1] - part[i * 2 + 1]));
+      axes.push_back(part[j * 2] - part[i * 2]);
+    }
+    bool separating = false;
+    for (size_t a = 0; a < axes.size() && !separating; a += 2) {
+      float pmin, pmax, bmin, bmax;
+      project(part, axes[a], axes[a + 1], &pmin, &pmax);
+      project(box, axes[a], axes[a + 1], &bmin, &bmax);
+      separating = pmax < bmin || bmax < pmin;
+    }
+    if (!separating) return true;
+  }
+  return false;
+}
+
+static int gcd(int a, int b) { return b == 0 ? abs(a) : gcd(b, a % b); }
+
+// boxes of every size class around the lattice points of every part edge, so that boxes touch
+// the edges and vertices from both sides, plus degenerate point and line boxes
+static void add_edge_boxes(const std::vector<std::vector<float>> &parts, std::vector<box_t> *boxes) {
+  for (const std::vector<float> &part : parts) {
+    size_t n = part.size() / 2;
+    for (size_t i = 0; i < n; i++) {
+      size_t j = (i + 1) % n;
+      int px = part[i * 2], py = part[i * 2 + 1];
+      int dx = (int)part[j * 2] - px, dy = (int)part[j * 2 + 1] - py;
+      int g = std::max(gcd(dx, dy), 1);
+      for (int s = 0; s <= g; s += std::max(g / 4, 1)) {
+        int x = px + dx / g * s, y = py + dy / g * s;
+        boxes->push_back({x, y, x, y});
+        for (int size : {1, 7}) {
+          boxes->push_back({x, y, x + size, y + size});
+          boxes->push_back({x - size, y, x, y + size});
+          boxes->push_back({x, y - size, x + size, y});
+          boxes->push_back({x - size, y - size, x, y});
+          boxes->push_back({x, y - size, x, y + size});
+          boxes->push_back({x - size, y, x + size, y});
+          // one unit off the edge, on both sides
+          boxes->push_back({x + 1, y + 1, x + size + 1, y + size + 1});
+          boxes->push_back({x - size - 1, y - size - 1, x - 1, y - 1});
+        }
+      }
+    }
+  }
+}
+
+int main() {
+  // convex, concave (split in convex parts), touching and far apart regions
+  const std::vector<std::vector<int>> polygons = {
+      {10, 10, 60, 10, 60, 40, 10, 40},
+      {70, 10, 130, 40, 80, 70},
+      {10, 60, 40, 60, 40, 80, 70, 80, 70, 100, 10, 100},
+      {100, 60, 150, 60, 130, 80, 150, 100, 100, 100},
+      {60, 10, 90, 10, 90, 30, 60, 30},
+      {5, 120, 150, 121, 150, 124},
+      {160, 10, 190, 20, 195, 50, 170, 60, 155, 35},
+      {200, 150, 260, 150, 260, 200, 200, 200},
+  };
+
+  IntrusionDetect all;
+  std::vector<std::unique_ptr<IntrusionDetect>> single;
+  std::vector<std::vector<std::vector<float>>> parts;
+  std::vector<box_t> boxes;
+  for (const std::vector<int> &polygon : polygons) {
+    single.emplace_back(new IntrusionDetect());
+    if (set_region(&all, polygon) != CVI_TDL_SUCCESS ||
+        set_region(single.back().get(), polygon) != CVI_TDL_SUCCESS) {
+      printf("setRegion failed\n");
+      return -1;
+    }
+    parts.push_back(get_parts(single.back().get()));
+    add_edge_boxes(parts.back(), &boxes);
+  }
+  for (int i = 0; i < 3000; i++) {
+    int x = rand_int(-20, 280), y = rand_int(-20, 220);
+    box_t b = {x, y, x + rand_int(0, 40), y + rand_int(0, 40)};
+    if (i % 5 == 0) std::swap(b.x1, b.x2);  // corners given in any order
+    if (i % 7 == 0) std::swap(b.y1, b.y2);
+    boxes.push_back(b);
+  }
+
+  cvtdl_object_t obj;
+  memset(&obj, 0, sizeof(obj));
+  CVI_TDL_MemAllocInit(boxes.size(), &obj);
+  for (size_t i = 0; i < boxes.size(); i++) {
+    obj.info[i].bbox.x1 = boxes[i].x1;
+    obj.info[i].bbox.y1 = boxes[i].y1;
+    obj.info[i].bbox.x2 = boxes[i].x2;
+    obj.info[i].bbox.y2 = boxes[i].y2;
+  }
+  std::vector<uint64_t> masks(boxes.size(), ~0ull);
+  int ret = all.run(obj, masks.data());
+  if (ret != CVI_TDL_SUCCESS) {
+    printf("run with region masks failed: %d\n", ret);
+  }
+
+  uint32_t hits = 0;
+  for (size_t i = 0; i < boxes.size() && ret == 0; i++) {
+    const cvtdl_bbox_t &bbox = obj.info[i].bbox;
+    if ((masks[i] != 0) != all.run(bbox) || (masks[i] >> polygons.size()) != 0) {
+      printf("box %zu (%d %d %d %d): mask %llx, run %d\n", i, boxes[i].x1, boxes[i].y1,
+             boxes[i].x2, boxes[i].y2, (unsigned long long)masks[i], all.run(bbox));
+      ret = -1;
+    }
+    for (size_t k = 0; k < polygons.size() && ret == 0; k++) {
+      bool bit = (masks[i] >> k) & 1;
+      bool run = single[k]->run(bbox);
+      bool sat = sat_intersect(parts[k], boxes[i]);
+      if (bit != run || bit != sat) {
+        printf("box %zu (%d %d %d %d) region %zu: mask %d, run %d, sat %d\n", i, boxes[i].x1,
+               boxes[i].y1, boxes[i].x2, boxes[i].y2, k, bit, run, sat);
+        ret = -1;
+      }
+      hits += bit;
+    }
+  }
+  printf("%zu boxes, %u region hits\n", boxes.size(), hits);
+
+  // the masks hold 64 regions
+  IntrusionDetect many;
+  for (int i = 0; i <= 64 && ret == 0; i++) {
+    set_region(&many, {i * 4, 0, i * 4 + 2, 0, i * 4 + 2, 2});
+  }
+  if (ret == 0 && many.run(obj, masks.data()) != CVI_TDL_ERR_INVALID_ARGS) {
+    printf("65 regions are not rejected\n");
+    ret = -1;
+  }
+  CVI_TDL_FreeCpp(&obj);
+
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
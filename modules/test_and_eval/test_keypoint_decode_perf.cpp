@@ -0,0 +1,180 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "keypoint_utils.hpp"
+#include "perf_utils.hpp"
+
+// host benchmark of heatmap keypoint decoding on synthetic Gaussian heatmaps
+// usage: test_keypoint_decode_perf [num_people] [loops]
+
+#define NUM_JOINTS 17
+#define HEIGHT 64
+#define WIDTH 48
+#define SIGMA 2.f
+
+// the nested scalar loops the HRNet postprocess used before
+static void reference_peaks(const float *heatmaps, std::vector<float> &preds) {
+  preds.clear();
+  for (int j = 0; j < NUM_JOINTS; j++) {
+    float maxval = 0, maxrow = 0, maxcol = 0;
+    for (int h = 0; h < HEIGHT; h++) {
+      for (int w = 0; w < WIDTH; w++) {
+        float val = heatmaps[j * HEIGHT * WIDTH + h * WIDTH + w];
+        if (val > maxval) {
+          maxval = val;
+          maxrow = h;
+          maxcol = w;
+        }
+      }
+    }
+    preds.push_back(maxrow);
+    preds.push_back(maxcol);
+  }
+}
+
+// first index of the maximum, on lengths around the block sizes, with ties and negative values
+static int check_argmax(std::mt19937 &rng) {
+  std::uniform_int_distribution<int> level(-6, 6);
+  std::vector<float> v;
+  std::vector<int8_t> q;
+  for (int n = 1; n <= 300; n++) {
+    for (int rep = 0; rep < 8; rep++) {
+      v.resize(n);
+      q.resize(n);
+      for (int i = 0; i < n; i++) {
+        q[i] = (int8_t)(level(rng) * 20);
+        v[i] = q[i] * 0.5f;
+      }
+      int expect = 0;
+      for (int i = 1; i < n; i++) {
+        if (v[i] > v[expect]) expect = i;
+      }
+      float max_v;
+      int8_t max_q;
+      if (cvitdl::VectorArgmax(v.data(), n, &max_v) != expect || max_v != v[expect] ||
+          cvitdl::VectorArgmax(q.data(), n, &max_q) != expect || max_q != q[expect]) {
+        printf("argmax of %d values differs\n", n);
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  int num_people = argc > 1 ? atoi(argv[1]) : 10;
+  int loops = argc > 2 ? atoi(argv[2]) : 100;
+  if (num_people <= 0 || loops <= 0) {
+    printf("usage: %s [num_people] [loops]\n", argv[0]);
+    return -1;
+  }
+
+  // joints at sub-pixel positions away from the border
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> pos_x(4.f, WIDTH - 5.f), pos_y(4.f, HEIGHT - 5.f);
+  std::uniform_real_distribution<float> noise(0.f, 0.01f);
+  const int plane = HEIGHT * WIDTH;
+  std::vector<std::vector<float>> people(num_people);
+  std::vector<std::vector<float>> truth(num_people);
+  for (int p = 0; p < num_people; p++) {
+    people[p].resize(NUM_JOINTS * plane);
+    for (int j = 0; j < NUM_JOINTS; j++) {
+      float cx = pos_x(rng), cy = pos_y(rng);
+      truth[p].push_back(cx);
+      truth[p].push_back(cy);
+      for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+          float d2 = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+          people[p][j * plane + y * WIDTH + x] = expf(-d2 / (2 * SIGMA * SIGMA)) + noise(rng);
+        }
+      }
+    }
+  }
+
+  // best of a few runs, the argmax must not be slower than the reference loops
+  std::vector<float> preds;
+  double reference_us = 1e30, argmax_us = 1e30;
+  cvitdl::KeypointPeak peaks[NUM_JOINTS];
+  for (int run = 0; run < 3; run++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int l = 0; l < loops; l++) {
+      for (auto &p : people) reference_peaks(p.data(), preds);
+    }
+    reference_us = std::min(reference_us, elapsed_ms(t0) * 1000 / loops / num_people);
+    t0 = std::chrono::steady_clock::now();
+    for (int l = 0; l < loops; l++) {
+      for (auto &p : people) {
+        cvitdl::DecodeHeatmaps(p.data(), NUM_JOINTS, HEIGHT, WIDTH, CVTDL_KEYPOINT_REFINE_NONE, 11,
+                               peaks);
+      }
+    }
+    argmax_us = std::min(argmax_us, elapsed_ms(t0) * 1000 / loops / num_people);
+  }
+  printf("reference argmax: %.3f us/person, argmax: %.3f us/person\n", reference_us, argmax_us);
+
+  int ret = check_argmax(rng);
+  if (argmax_us > reference_us) {
+    printf("argmax slower than the reference\n");
+    ret = -1;
+  }
+  const cvtdl_keypoint_refine_e refines[3] = {
+      CVTDL_KEYPOINT_REFINE_NONE, CVTDL_KEYPOINT_REFINE_QUARTER, CVTDL_KEYPOINT_REFINE_DARK};
+  const char *names[3] = {"none", "quarter", "dark"};
+  double errors[3];
+  for (int r = 0; r < 3; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int l = 0; l < loops; l++) {
+      for (auto &p : people) {
+        cvitdl::DecodeHeatmaps(p.data(), NUM_JOINTS, HEIGHT, WIDTH, refines[r], 11, peaks);
+      }
+    }
+    double ms = elapsed_ms(t0);
+
+    double err = 0;
+    for (int p = 0; p < num_people; p++) {
+      cvitdl::DecodeHeatmaps(people[p].data(), NUM_JOINTS, HEIGHT, WIDTH, refines[r], 11, peaks);
+      if (r == 0) {
+        reference_peaks(people[p].data(), preds);
+      }
+      for (int j = 0; j < NUM_JOINTS; j++) {
+        if (r == 0 && (peaks[j].y != preds[2 * j] || peaks[j].x != preds[2 * j + 1])) ret = -1;
+        err += hypotf(peaks[j].x - truth[p][2 * j], peaks[j].y - truth[p][2 * j + 1]);
+      }
+    }
+    errors[r] = err / (num_people * NUM_JOINTS);
+    printf("%-7s: %.3f us/person, mean error %.3f px\n", names[r],
+           ms * 1000 / loops / num_people, errors[r]);
+  }
+
+  // SimCC with a split ratio of 2 on the same positions
+  std::vector<float> simcc_x(NUM_JOINTS * WIDTH * 2), simcc_y(NUM_JOINTS * HEIGHT * 2);
+  for (int j = 0; j < NUM_JOINTS; j++) {
+    for (int i = 0; i < WIDTH * 2; i++) {
+      float d = i - 2 * truth[0][2 * j];
+      simcc_x[j * WIDTH * 2 + i] = expf(-d * d / (2 * SIGMA * SIGMA));
+    }
+    for (int i = 0; i < HEIGHT * 2; i++) {
+      float d = i - 2 * truth[0][2 * j + 1];
+      simcc_y[j * HEIGHT * 2 + i] = expf(-d * d / (2 * SIGMA * SIGMA));
+    }
+  }
+  cvitdl::DecodeSimCC(simcc_x.data(), WIDTH * 2, simcc_y.data(), HEIGHT * 2, NUM_JOINTS, 2.f,
+                      CVTDL_KEYPOINT_REFINE_DARK, peaks);
+  double simcc_err = 0;
+  for (int j = 0; j < NUM_JOINTS; j++) {
+    simcc_err += hypotf(peaks[j].x - truth[0][2 * j], peaks[j].y - truth[0][2 * j + 1]);
+  }
+  simcc_err /= NUM_JOINTS;
+  printf("simcc  : mean error %.3f px\n", simcc_err);
+
+  // argmax matches the reference, each refinement is more accurate than the previous one
+  if (!(errors[2] < errors[1] && errors[1] < errors[0] && errors[2] < 0.1 && simcc_err < 0.1)) {
+    ret = -1;
+  }
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
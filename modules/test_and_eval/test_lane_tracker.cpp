@@ -0,0 +1,203 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "core/core/cvtdl_errno.h"
+#include "core/cvi_tdl_types_mem_internal.h"
+#include "lane_detection/lane_peaks.hpp"
+#include "lane_detection/lane_tracker.hpp"
+
+// check of the lane peaks against a brute-force max pool window, and of the lane tracker
+// association, departure rate, coasting and expiry on synthetic lanes
+// usage: test_lane_tracker [num_rounds]
+
+#define WIDTH 1280
+#define HEIGHT 720
+
+static int check_peaks(std::mt19937 &rng, int num_rounds) {
+  // few distinct values so plateaus and ties at the window borders are common
+  std::uniform_int_distribution<int> level(0, 6);
+  std::vector<int> window, peaks;
+  for (int round = 0; round < num_rounds; round++) {
+    for (int n = 0; n <= 80; n++) {
+      for (int radius = 0; radius <= 5; radius++) {
+        std::vector<float> logits(n);
+        for (float &v : logits) v = level(rng) * 0.5f - 1.f;
+        cvitdl::FindPoolPeaks(logits.data(), n, radius, &window, &peaks);
+        std::vector<int> expect;
+        for (int c = 0; c < n; c++) {
+          float m = logits[c];
+          for (int k = std::max(0, c - radius); k <= std::min(n - 1, c + radius); k++) {
+            m = std::max(m, logits[k]);
+          }
+          if (logits[c] == m) expect.push_back(c);
+        }
+        if (peaks != expect) {
+          printf("peaks of n %d radius %d differ: %zu instead of %zu\n", n, radius, peaks.size(),
+                 expect.size());
+          return -1;
+        }
+      }
+    }
+  }
+  return 0;
+}
+
+// lane u = c0 + c1 * (v - 1) in normalized coordinates, sampled at two rows
+struct Lane {
+  float c0;
+  float c1;
+};
+
+static void make_detections(const std::vector<Lane> &lanes, std::mt19937 &rng, float noise,
+                            cvtdl_lane_t *det) {
+  std::normal_distribution<float> jitter(0.f, noise);
+  CVI_TDL_MemAllocInit(lanes.size(), det);
+  det->width = WIDTH;
+  det->height = HEIGHT;
+  const float rows[2] = {0.6f, 0.95f};
+  for (size_t i = 0; i < lanes.size(); i++) {
+    cvtdl_lane_point_t &p = det->lane[i];
+    memset(&p, 0, sizeof(p));
+    for (int k = 0; k < 2; k++) {
+      p.x[k] = (lanes[i].c0 + lanes[i].c1 * (rows[k] - 1.f) + jitter(rng)) * WIDTH;
+      p.y[k] = rows[k] * HEIGHT;
+    }
+    p.score = 0.95f;
+  }
+}
+
+static float bottom_x(const cvtdl_lane_point_t &p) {
+  float slope = (p.x[1] - p.x[0]) / (p.y[1] - p.y[0]);
+  return p.x[1] + slope * (HEIGHT - p.y[1]);
+}
+
+static int check_tracker(std::mt19937 &rng) {
+  cvitdl::LaneTracker tracker;
+  cvtdl_lane_t det, tracks;
+  memset(&det, 0, sizeof(det));
+  memset(&tracks, 0, sizeof(tracks));
+  int ret = 0;
+
+  if (tracker.track(&det, NULL) != CVI_TDL_ERR_INVALID_ARGS) {
+    printf("NULL tracks accepted\n");
+    return -1;
+  }
+  make_detections({{0.3f, -0.4f}}, rng, 0.f, &det);
+  det.width = 0;
+  if (tracker.track(&det, &tracks) != CVI_TDL_ERR_INVALID_ARGS) {
+    printf("detections without frame size accepted\n");
+    return -1;
+  }
+
+  // two still lanes in shuffled order, confirmed on their second hit with stable ids
+  std::vector<Lane> lanes = {{0.3f, -0.4f}, {0.7f, 0.4f}};
+  uint64_t ids[2] = {0, 0};
+  for (int f = 0; f < 30 && ret == 0; f++) {
+    std::shuffle(lanes.begin(), lanes.end(), rng);
+    make_detections(lanes, rng, 0.002f, &det);
+    tracker.track(&det, &tracks);
+    if (tracks.size != (f == 0 ? 0u : 2u)) {
+      printf("frame %d: %u lanes instead of %d\n", f, tracks.size, f == 0 ? 0 : 2);
+      ret = -1;
+      break;
+    }
+    if (f == 0) continue;
+    for (int i = 0; i < 2; i++) {
+      const float truth = (i == 0 ? 0.3f : 0.7f) * WIDTH;
+      if (fabsf(bottom_x(tracks.lane[i]) - truth) > 0.01f * WIDTH) {
+        printf("frame %d: lane %d at %f instead of %f\n", f, i, bottom_x(tracks.lane[i]), truth);
+        ret = -1;
+      }
+      if (ids[i] == 0) ids[i] = tracks.lane[i].unique_id;
+      if (tracks.lane[i].unique_id != ids[i] || ids[i] == 0) {
+        printf("frame %d: lane %d changed id\n", f, i);
+        ret = -1;
+      }
+    }
+    if (ids[0] == ids[1]) {
+      printf("both lanes share id %lu\n", (unsigned long)ids[0]);
+      ret = -1;
+    }
+  }
+
+  // the left lane drifts towards the center without crossing it, the departure rate converges
+  // to its speed
+  const float rate = 0.001f;
+  for (int f = 0; f < 120 && ret == 0; f++) {
+    lanes = {{0.3f + rate * (f + 1), -0.4f}, {0.7f, 0.4f}};
+    make_detections(lanes, rng, 0.f, &det);
+    tracker.track(&det, &tracks);
+  }
+  if (ret == 0 && (tracks.size != 2 || tracks.lane[0].unique_id != ids[0] ||
+                   fabsf(tracks.lane[0].departure_rate - rate * WIDTH) > 0.1f * rate * WIDTH ||
+                   fabsf(tracks.lane[1].departure_rate) > 0.1f * rate * WIDTH)) {
+    printf("departure rates %f and %f instead of %f and 0\n", tracks.lane[0].departure_rate,
+           tracks.lane[1].departure_rate, rate * WIDTH);
+    ret = -1;
+  }
+
+  // frames without the lane model predict the lanes along their velocity
+  const float last = bottom_x(tracks.lane[0]);
+  for (int f = 1; f <= 30 && ret == 0; f++) {
+    tracker.track(NULL, &tracks);
+    if (tracks.size != 2 || tracks.lane[0].unique_id != ids[0] ||
+        fabsf(bottom_x(tracks.lane[0]) - (last + f * rate * WIDTH)) > 0.01f * WIDTH) {
+      printf("coasting frame %d: lane not predicted\n", f);
+      ret = -1;
+    }
+  }
+  // past the coasting limit the lanes are dropped
+  tracker.track(NULL, &tracks);
+  if (ret == 0 && tracks.size != 0) {
+    printf("%u lanes kept past the coasting limit\n", tracks.size);
+    ret = -1;
+  }
+
+  // detection frames without a match expire a lane after a few misses, a lane coming back later
+  // is a new one
+  tracker.reset();
+  lanes = {{0.3f, -0.4f}, {0.7f, 0.4f}};
+  for (int f = 0; f < 5; f++) {
+    make_detections(lanes, rng, 0.f, &det);
+    tracker.track(&det, &tracks);
+  }
+  uint64_t right_id = tracks.lane[1].unique_id;
+  for (int f = 1; f <= 4 && ret == 0; f++) {
+    make_detections({lanes[0]}, rng, 0.f, &det);
+    tracker.track(&det, &tracks);
+    uint32_t expect = f <= 3 ? 2 : 1;
+    if (tracks.size != expect) {
+      printf("miss %d: %u lanes instead of %u\n", f, tracks.size, expect);
+      ret = -1;
+    }
+  }
+  for (int f = 0; f < 2 && ret == 0; f++) {
+    make_detections(lanes, rng, 0.f, &det);
+    tracker.track(&det, &tracks);
+  }
+  if (ret == 0 && (tracks.size != 2 || tracks.lane[1].unique_id == right_id)) {
+    printf("an expired lane came back with its old id\n");
+    ret = -1;
+  }
+
+  free(det.lane);
+  free(tracks.lane);
+  return ret;
+}
+
+int main(int argc, char *argv[]) {
+  int num_rounds = argc > 1 ? atoi(argv[1]) : 20;
+  if (num_rounds <= 0) {
+    printf("usage: %s [num_rounds]\n", argv[0]);
+    return -1;
+  }
+  std::mt19937 rng(1234);
+  int ret = check_peaks(rng, num_rounds);
+  ret |= check_tracker(rng);
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
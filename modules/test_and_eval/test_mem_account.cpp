@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "mem_account.hpp"
+
+// check of the memory accounts: counters, the clamp of over-releases, forwarding to the parent,
+// parent transfer, concurrent updates and the shared weights moving between holders
+// usage: test_mem_account [num_ops]
+
+using cvitdl::MemAccount;
+using cvitdl::SharedCharge;
+
+static cvtdl_mem_counter_t counter(MemAccount &account, cvtdl_mem_type_e type) {
+  cvtdl_mem_usage_t usage;
+  account.query(&usage);
+  return usage.counter[type];
+}
+
+static bool expect_live(MemAccount &account, cvtdl_mem_type_e type, uint64_t live,
+                        const char *what) {
+  uint64_t got = counter(account, type).live_bytes;
+  if (got != live) {
+    printf("%s: %s holds %lu bytes instead of %lu\n", what, account.getName().c_str(),
+           (unsigned long)got, (unsigned long)live);
+    return false;
+  }
+  return true;
+}
+
+static int check_counters() {
+  MemAccount a("a");
+  a.alloc(CVI_TDL_MEM_HEAP, 100);
+  a.alloc(CVI_TDL_MEM_HEAP, 50);
+  a.release(CVI_TDL_MEM_HEAP, 120);
+  a.alloc(CVI_TDL_MEM_HEAP, 10);
+  a.alloc(CVI_TDL_MEM_ION, 0);
+  a.alloc((cvtdl_mem_type_e)CVI_TDL_MEM_TYPE_NUM, 10);
+  cvtdl_mem_counter_t c = counter(a, CVI_TDL_MEM_HEAP);
+  if (c.live_bytes != 40 || c.peak_bytes != 150 || c.total_bytes != 160 || c.alloc_count != 3 ||
+      c.free_count != 1 || counter(a, CVI_TDL_MEM_ION).alloc_count != 0) {
+    printf("counters: live %lu peak %lu total %lu allocs %lu frees %lu\n",
+           (unsigned long)c.live_bytes, (unsigned long)c.peak_bytes, (unsigned long)c.total_bytes,
+           (unsigned long)c.alloc_count, (unsigned long)c.free_count);
+    return -1;
+  }
+
+  // set charges or releases the difference
+  a.set(CVI_TDL_MEM_HEAP, 90);
+  if (!expect_live(a, CVI_TDL_MEM_HEAP, 90, "set up")) return -1;
+  a.set(CVI_TDL_MEM_HEAP, 5);
+  if (!expect_live(a, CVI_TDL_MEM_HEAP, 5, "set down")) return -1;
+
+  // releasing more than held stops at zero, the parent only loses what the child held
+  std::shared_ptr<MemAccount> parent = std::make_shared<MemAccount>("parent");
+  parent->alloc(CVI_TDL_MEM_VB, 1000);
+  MemAccount b("b");
+  b.setParent(parent);
+  b.alloc(CVI_TDL_MEM_VB, 30);
+  b.release(CVI_TDL_MEM_VB, 80);
+  if (!expect_live(b, CVI_TDL_MEM_VB, 0, "clamp") ||
+      !expect_live(*parent, CVI_TDL_MEM_VB, 1000, "clamp")) {
+    return -1;
+  }
+  return 0;
+}
+
+static int check_parents() {
+  std::shared_ptr<MemAccount> h1 = std::make_shared<MemAccount>("h1");
+  std::shared_ptr<MemAccount> h2 = std::make_shared<MemAccount>("h2");
+  MemAccount model("model");
+  model.alloc(CVI_TDL_MEM_ION, 64);
+
+  // the bytes held before the parent is set are moved to it, and away from the previous one
+  model.setParent(h1);
+  model.alloc(CVI_TDL_MEM_ION, 16);
+  if (!expect_live(*h1, CVI_TDL_MEM_ION, 80, "setParent")) return -1;
+  model.setParent(h2);
+  if (!expect_live(*h1, CVI_TDL_MEM_ION, 0, "moved away") ||
+      !expect_live(*h2, CVI_TDL_MEM_ION, 80, "moved to")) {
+    return -1;
+  }
+  model.setParent(h2);
+  model.release(CVI_TDL_MEM_ION, 80);
+  if (!expect_live(*h2, CVI_TDL_MEM_ION, 0, "released") ||
+      counter(*h2, CVI_TDL_MEM_ION).peak_bytes != 80) {
+    printf("parent peak %lu instead of 80\n",
+           (unsigned long)counter(*h2, CVI_TDL_MEM_ION).peak_bytes);
+    return -1;
+  }
+  model.setParent(nullptr);
+  model.alloc(CVI_TDL_MEM_ION, 8);
+  if (!expect_live(*h2, CVI_TDL_MEM_ION, 0, "detached")) return -1;
+  model.release(CVI_TDL_MEM_ION, 8);
+  return 0;
+}
+
+static int check_threads(int num_ops) {
+  std::shared_ptr<MemAccount> handle = std::make_shared<MemAccount>("handle");
+  const int num_threads = 4;
+  std::vector<std::unique_ptr<MemAccount>> models;
+  for (int i = 0; i < num_threads; i++) {
+    models.emplace_back(new MemAccount("model"));
+    models.back()->setParent(handle);
+  }
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([&models, i, num_ops] {
+      for (int k = 0; k < num_ops; k++) {
+        models[i]->alloc(CVI_TDL_MEM_HEAP, 1 + k % 7);
+        models[i]->release(CVI_TDL_MEM_HEAP, 1 + k % 7);
+      }
+      models[i]->alloc(CVI_TDL_MEM_HEAP, 3);
+    });
+  }
+  for (std::thread &t : threads) t.join();
+  cvtdl_mem_counter_t c = counter(*handle, CVI_TDL_MEM_HEAP);
+  if (c.live_bytes != 3 * num_threads || c.alloc_count != (uint64_t)(num_ops + 1) * num_threads ||
+      c.free_count != (uint64_t)num_ops * num_threads || c.peak_bytes > 7 * num_threads + 3) {
+    printf("threads: live %lu allocs %lu frees %lu peak %lu\n", (unsigned long)c.live_bytes,
+           (unsigned long)c.alloc_count, (unsigned long)c.free_count,
+           (unsigned long)c.peak_bytes);
+    return -1;
+  }
+  for (auto &m : models) m->release(CVI_TDL_MEM_HEAP, 3);
+  return 0;
+}
+
+static int check_shared_charge() {
+  // three instances of one model on two handles, the weights are counted once
+  std::shared_ptr<MemAccount> h1 = std::make_shared<MemAccount>("h1");
+  std::shared_ptr<MemAccount> h2 = std::make_shared<MemAccount>("h2");
+  MemAccount a("a"), b("b"), c("c");
+  a.setParent(h1);
+  b.setParent(h2);
+  c.setParent(h2);
+  SharedCharge weights;
+  weights.setBytes(CVI_TDL_MEM_ION, 1000);
+  weights.addHolder(&a);
+  weights.addHolder(&b);
+  weights.addHolder(&a);
+  weights.addHolder(&c);
+  if (!expect_live(*h1, CVI_TDL_MEM_ION, 1000, "first holder") ||
+      !expect_live(*h2, CVI_TDL_MEM_ION, 0, "later holders")) {
+    return -1;
+  }
+  // the loading instance closes, the weights move to the next holder and its handle
+  weights.removeHolder(&a);
+  if (!expect_live(*h1, CVI_TDL_MEM_ION, 0, "holder left") ||
+      !expect_live(b, CVI_TDL_MEM_ION, 1000, "next holder") ||
+      !expect_live(*h2, CVI_TDL_MEM_ION, 1000, "next holder")) {
+    return -1;
+  }
+  weights.removeHolder(&c);
+  weights.removeHolder(&a);
+  if (!expect_live(b, CVI_TDL_MEM_ION, 1000, "uncharged holder left")) return -1;
+  weights.removeHolder(&b);
+  if (!expect_live(*h2, CVI_TDL_MEM_ION, 0, "last holder left") ||
+      !expect_live(c, CVI_TDL_MEM_ION, 0, "last holder left")) {
+    return -1;
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  int num_ops = argc > 1 ? atoi(argv[1]) : 100000;
+  if (num_ops <= 0) {
+    printf("usage: %s [num_ops]\n", argv[0]);
+    return -1;
+  }
+  int ret = check_counters();
+  ret |= check_parents();
+  ret |= check_threads(num_ops);
+  ret |= check_shared_charge();
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
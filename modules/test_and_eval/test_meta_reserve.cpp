@@ -0,0 +1,281 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "core/cvi_tdl_types_mem.h"
+#include "core/cvi_tdl_types_mem_internal.h"
+#include "meta_arena.hpp"
+
+// check of the kept result metas (CVI_TDL_Reserve{Face,Object}Meta) and of the arena behind them:
+// reuse of info[] across smaller and larger results, arena and heap payloads in one meta, free
+// after reserve and copies of a kept meta. Run it under ASan / LSan to also catch a payload freed
+// twice, freed from the arena or leaked.
+// usage: test_meta_reserve
+
+using cvitdl::MetaArena;
+
+static int g_failed = 0;
+
+#define CHECK(cond)                                            \
+  do {                                                         \
+    if (!(cond)) {                                             \
+      printf("%s:%d: %s failed\n", __FILE__, __LINE__, #cond); \
+      g_failed++;                                              \
+    }                                                          \
+  } while (0)
+
+static void test_arena() {
+  MetaArena arena;
+  CHECK(arena.capacity() == 0);
+  std::vector<uint8_t *> ptrs;
+  size_t total = 0;
+  for (int i = 0; i < 300; i++) {
+    size_t bytes = 1 + (i * 37) % 200;
+    uint8_t *p = (uint8_t *)arena.alloc(bytes);
+    CHECK(p != NULL && ((uintptr_t)p & 15) == 0);
+    bool zero = true;
+    for (size_t k = 0; k < bytes; k++) zero = zero && p[k] == 0;
+    CHECK(zero);
+    CHECK(arena.owns(p) && arena.owns(p + bytes - 1));
+    memset(p, 0xab, bytes);
+    ptrs.push_back(p);
+    total += bytes;
+  }
+  size_t grown = arena.capacity();
+  CHECK(grown >= total);
+  int heap = 0;
+  CHECK(!arena.owns(&heap));
+
+  // the blocks are merged, the same allocations then fit without growing
+  arena.reset();
+  CHECK(arena.capacity() == grown);
+  uint8_t *first = (uint8_t *)arena.alloc(16);
+  for (int i = 1; i < 300; i++) {
+    uint8_t *p = (uint8_t *)arena.alloc(1 + (i * 37) % 200);
+    CHECK(p[0] == 0);
+  }
+  CHECK(arena.capacity() == grown);
+  arena.reset();
+  CHECK(arena.alloc(16) == first);
+  // one block: a payload as large as the whole frame fits as well
+  arena.reset();
+  CHECK(arena.alloc(grown) == first && arena.capacity() == grown);
+
+  // larger than a block
+  void *big = arena.alloc(3 * grown);
+  CHECK(big != NULL && arena.owns(big));
+}
+
+static void test_face_reuse() {
+  cvtdl_face_t face;
+  memset(&face, 0, sizeof(face));
+  CVI_TDL_ReserveFaceMeta(&face, 2);
+  CHECK(face.info != NULL && face.size == 0);
+
+  // within the capacity: info[] and the landmark storage stay in place
+  CVI_TDL_MemAllocInit(2, 5, &face);
+  cvtdl_face_info_t *info = face.info;
+  float *pts_x = face.info[0].pts.x;
+  face.info[1].pts.x[4] = 42;
+  CVI_TDL_MemAllocInit(1, 5, &face);
+  CHECK(face.size == 1 && face.info == info && face.info[0].pts.x == pts_x);
+  CHECK(face.info[0].pts.x[0] == -1 && face.info[0].pts.size == 5);
+  CVI_TDL_MemAllocInit(2, 5, &face);
+  CHECK(face.info == info && face.info[1].pts.x[4] == -1);
+
+  // larger: info[] grows and keeps being reused from then on
+  CVI_TDL_MemAllocInit(7, 5, &face);
+  CHECK(face.size == 7);
+  info = face.info;
+  for (uint32_t i = 0; i < face.size; i++) {
+    CHECK(face.info[i].pts.size == 5 && face.info[i].pts.y[4] == -1 &&
+          face.info[i].feature.ptr == NULL);
+  }
+  CVI_TDL_MemAllocInit(3, 5, &face);
+  CHECK(face.size == 3 && face.info == info);
+  CVI_TDL_MemAllocInit(0, 5, &face);
+  CHECK(face.size == 0);
+  CVI_TDL_MemAllocInit(6, 0, &face);
+  CHECK(face.size == 6 && face.info == info && face.info[5].pts.x == NULL);
+
+  CVI_TDL_FreeCpp(&face);
+  CHECK(face.info == NULL && face.size == 0);
+}
+
+static void test_mixed_payloads() {
+  cvtdl_face_t face;
+  memset(&face, 0, sizeof(face));
+  CVI_TDL_ReserveFaceMeta(&face, 4);
+  for (int frame = 0; frame < 3; frame++) {
+    CVI_TDL_MemAllocInit(3, 5, &face);
+    // heap feature as the attribute models allocate it, arena feature as osnet does
+    CVI_TDL_MemAlloc(sizeof(int8_t), 256, TYPE_INT8, &face.info[0].feature);
+    CVI_TDL_MemAlloc(sizeof(int8_t), 256, TYPE_INT8, &face.info[1].feature, &face);
+    memset(face.info[0].feature.ptr, 1, 256);
+    memset(face.info[1].feature.ptr, 2, 256);
+    // same size: kept, another size: the old buffer goes back where it came from
+    int8_t *arena_feature = face.info[1].feature.ptr;
+    CVI_TDL_MemAlloc(sizeof(int8_t), 256, TYPE_INT8, &face.info[1].feature, &face);
+    CHECK(face.info[1].feature.ptr == arena_feature);
+    CVI_TDL_MemAlloc(sizeof(int8_t), 128, TYPE_INT8, &face.info[1].feature, &face);
+    CVI_TDL_MemAlloc(sizeof(int8_t), 512, TYPE_INT8, &face.info[0].feature, &face);
+    CHECK(face.info[0].feature.size == 512 && face.info[1].feature.size == 128);
+    // a heap payload replacing landmarks of the arena
+    CVI_TDL_MetaFree(&face, face.info[2].pts.x);
+    face.info[2].pts.x = (float *)malloc(sizeof(float) * 5);
+  }
+  // the next result releases every heap payload and none of the arena
+  CVI_TDL_MemAllocInit(2, 5, &face);
+  CHECK(face.info[0].feature.ptr == NULL && face.info[1].feature.ptr == NULL);
+  CVI_TDL_MemAlloc(sizeof(int8_t), 64, TYPE_INT8, &face.info[1].feature);
+  CVI_TDL_FreeCpp(&face);
+
+  // the same with an object meta and its properity structs
+  cvtdl_object_t obj;
+  memset(&obj, 0, sizeof(obj));
+  CVI_TDL_ReserveObjectMeta(&obj, 2);
+  for (int frame = 0; frame < 3; frame++) {
+    CVI_TDL_MemAllocInit(2, &obj);
+    obj.info[0].vehicle_properity =
+        (cvtdl_vehicle_meta *)CVI_TDL_MetaArenaAlloc(&obj, sizeof(cvtdl_vehicle_meta));
+    obj.info[1].vehicle_properity = (cvtdl_vehicle_meta *)calloc(1, sizeof(cvtdl_vehicle_meta));
+    obj.info[1].text_properity =
+        (cvtdl_text_meta *)CVI_TDL_MetaArenaAlloc(&obj, sizeof(cvtdl_text_meta));
+    CHECK(obj.info[0].vehicle_properity->license_char_num == 0);
+  }
+  CVI_TDL_FreeCpp(&obj);
+}
+
+static void test_free_after_reserve() {
+  // reserved and never used
+  cvtdl_object_t obj;
+  memset(&obj, 0, sizeof(obj));
+  CVI_TDL_ReserveObjectMeta(&obj, 8);
+  CVI_TDL_FreeCpp(&obj);
+  CHECK(obj.info == NULL && obj.size == 0);
+
+  // after Free the meta is a plain heap meta again
+  CVI_TDL_ReserveObjectMeta(&obj, 8);
+  CVI_TDL_MemAllocInit(3, &obj);
+  obj.info[2].pedestrian_properity =
+      (cvtdl_pedestrian_meta *)CVI_TDL_MetaArenaAlloc(&obj, sizeof(cvtdl_pedestrian_meta));
+  CVI_TDL_FreeCpp(&obj);
+  CVI_TDL_MemAllocInit(3, &obj);
+  void *payload = CVI_TDL_MetaArenaAlloc(&obj, 64);
+  CVI_TDL_MetaFree(&obj, payload);
+  obj.info[0].text_properity =
+      (cvtdl_text_meta *)CVI_TDL_MetaArenaAlloc(&obj, sizeof(cvtdl_text_meta));
+  CVI_TDL_FreeCpp(&obj);
+  CHECK(obj.info == NULL && obj.size == 0);
+
+  // reserving again drops the previous content
+  cvtdl_face_t face;
+  memset(&face, 0, sizeof(face));
+  CVI_TDL_MemAllocInit(2, 5, &face);
+  CVI_TDL_ReserveFaceMeta(&face, 1);
+  CHECK(face.size == 0 && face.info != NULL);
+  CVI_TDL_ReserveFaceMeta(&face, 3);
+  CVI_TDL_MemAllocInit(3, 5, &face);
+  CVI_TDL_FreeCpp(&face);
+  CHECK(face.info == NULL);
+}
+
+static void fill_object(cvtdl_object_t *obj, int frame) {
+  obj->mask_width = 8;
+  obj->mask_height = 4;
+  for (uint32_t i = 0; i < obj->size; i++) {
+    cvtdl_object_info_t &info = obj->info[i];
+    info.bbox.x1 = frame * 10 + i;
+    info.classes = i;
+    CVI_TDL_MemAlloc(sizeof(int8_t), 16, TYPE_INT8, &info.feature, obj);
+    memset(info.feature.ptr, frame + i, 16);
+    info.vehicle_properity =
+        (cvtdl_vehicle_meta *)CVI_TDL_MetaArenaAlloc(obj, sizeof(cvtdl_vehicle_meta));
+    cvtdl_vehicle_meta *vehicle = info.vehicle_properity;
+    snprintf(vehicle->license_char, sizeof(vehicle->license_char), "F%dI%u", frame, i);
+    info.mask_properity = (cvtdl_mask_meta *)CVI_TDL_MetaArenaAlloc(obj, sizeof(cvtdl_mask_meta));
+    info.mask_properity->mask_format = CVTDL_MASK_FORMAT_BBOX;
+    info.mask_properity->mask_w = 3;
+    info.mask_properity->mask_h = 2;
+    info.mask_properity->mask = (uint8_t *)CVI_TDL_MetaArenaAlloc(obj, 6);
+    memset(info.mask_properity->mask, 200 + frame, 6);
+    info.mask_properity->mask_point_size = 2;
+    info.mask_properity->mask_point = (float *)CVI_TDL_MetaArenaAlloc(obj, sizeof(float) * 4);
+    info.mask_properity->mask_point[3] = frame;
+  }
+}
+
+static bool same_object(const cvtdl_object_t &a, const cvtdl_object_t &b) {
+  if (a.size != b.size || a.mask_width != b.mask_width) return false;
+  for (uint32_t i = 0; i < a.size; i++) {
+    const cvtdl_object_info_t &x = a.info[i], &y = b.info[i];
+    if (x.bbox.x1 != y.bbox.x1 || x.classes != y.classes || x.feature.size != y.feature.size ||
+        memcmp(x.feature.ptr, y.feature.ptr, x.feature.size) != 0 ||
+        strcmp(x.vehicle_properity->license_char, y.vehicle_properity->license_char) != 0 ||
+        memcmp(x.mask_properity->mask, y.mask_properity->mask, 6) != 0 ||
+        x.mask_properity->mask_point[3] != y.mask_properity->mask_point[3]) {
+      return false;
+    }
+    // a deep copy
+    if (x.feature.ptr == y.feature.ptr || x.vehicle_properity == y.vehicle_properity ||
+        x.mask_properity->mask == y.mask_properity->mask) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void test_copy_reserved() {
+  cvtdl_object_t src, copy, expected, kept_dst;
+  memset(&src, 0, sizeof(src));
+  memset(&copy, 0, sizeof(copy));
+  memset(&expected, 0, sizeof(expected));
+  memset(&kept_dst, 0, sizeof(kept_dst));
+  CVI_TDL_ReserveObjectMeta(&src, 2);
+  CVI_TDL_ReserveObjectMeta(&kept_dst, 2);
+
+  CVI_TDL_MemAllocInit(3, &src);
+  fill_object(&src, 1);
+  CVI_TDL_CopyObjectMeta(&src, &copy);
+  CVI_TDL_CopyObjectMeta(&src, &kept_dst);
+  CVI_TDL_CopyObjectMeta(&copy, &expected);
+  CHECK(same_object(src, copy) && same_object(src, kept_dst));
+
+  // the copies own their payloads, the next result of src leaves them untouched
+  CVI_TDL_MemAllocInit(2, &src);
+  fill_object(&src, 2);
+  CHECK(same_object(copy, expected) && same_object(kept_dst, expected));
+  CVI_TDL_CopyObjectMeta(&src, &copy);
+  CHECK(same_object(src, copy));
+  CVI_TDL_FreeCpp(&src);
+  CHECK(copy.info[1].mask_properity->mask[5] == 202);
+  CVI_TDL_FreeCpp(&copy);
+  CVI_TDL_FreeCpp(&expected);
+  CVI_TDL_FreeCpp(&kept_dst);
+
+  cvtdl_face_t face, face_copy;
+  memset(&face, 0, sizeof(face));
+  memset(&face_copy, 0, sizeof(face_copy));
+  CVI_TDL_ReserveFaceMeta(&face, 4);
+  CVI_TDL_MemAllocInit(2, 5, &face);
+  face.info[1].pts.x[3] = 7;
+  CVI_TDL_MemAlloc(sizeof(int8_t), 8, TYPE_INT8, &face.info[1].feature, &face);
+  face.info[1].feature.ptr[7] = 9;
+  CVI_TDL_CopyFaceMeta(&face, &face_copy);
+  CVI_TDL_MemAllocInit(2, 5, &face);
+  CHECK(face_copy.size == 2 && face_copy.info[1].pts.x[3] == 7 &&
+        face_copy.info[1].feature.ptr[7] == 9 && face.info[1].pts.x[3] == -1);
+  CVI_TDL_FreeCpp(&face);
+  CVI_TDL_FreeCpp(&face_copy);
+}
+
+int main() {
+  test_arena();
+  test_face_reuse();
+  test_mixed_payloads();
+  test_free_after_reserve();
+  test_copy_reserved();
+  printf("%s\n", g_failed == 0 ? "check passed" : "check failed");
+  return g_failed == 0 ? 0 : -1;
+}
@@ -0,0 +1,85 @@
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "core/cvi_tdl_core.h"
+
+// open time of a cvimodel: cold page cache, a second handle sharing the weights, and a reopen
+// usage: test_model_open_perf <yolov8 cvimodel> [num_handles]
+// The cold run drops the file from the page cache, run it as root to drop the other caches too.
+
+#define MAX_HANDLES 16
+
+static double now_ms() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000. + ts.tv_nsec / 1e6;
+}
+
+static void drop_page_cache(const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) return;
+  fdatasync(fd);
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+  close(fd);
+}
+
+static int open_model(cvitdl_handle_t handle, const char *path, const char *label) {
+  double t0 = now_ms();
+  int ret = CVI_TDL_OpenModel(handle, CVI_TDL_SUPPORTED_MODEL_YOLOV8_DETECTION, path);
+  double t1 = now_ms();
+  if (ret != CVI_TDL_SUCCESS) {
+    printf("open model %s failed with %#x\n", path, ret);
+    return ret;
+  }
+  cvtdl_model_load_info_t info;
+  CVI_TDL_GetModelLoadInfo(handle, CVI_TDL_SUPPORTED_MODEL_YOLOV8_DETECTION, &info);
+  printf("%-8s %8.2f ms (core %8.2f ms) shared %d instances %u file %" PRIu64
+         " B resident %" PRIu64 " B\n",
+         label, t1 - t0, info.open_ms, info.shared, info.instances, info.file_bytes,
+         info.resident_bytes);
+  return CVI_TDL_SUCCESS;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printf("usage: %s <yolov8 cvimodel> [num_handles]\n", argv[0]);
+    return -1;
+  }
+  const char *path = argv[1];
+  int num_handles = argc > 2 ? atoi(argv[2]) : 2;
+  if (num_handles < 1 || num_handles > MAX_HANDLES) {
+    printf("num_handles must be in [1, %d]\n", MAX_HANDLES);
+    return -1;
+  }
+
+  cvitdl_handle_t handles[MAX_HANDLES] = {NULL};
+  int ret = CVI_TDL_SUCCESS;
+  for (int i = 0; i < num_handles && ret == CVI_TDL_SUCCESS; i++) {
+    ret = CVI_TDL_CreateHandle(&handles[i]);
+  }
+  if (ret != CVI_TDL_SUCCESS) {
+    printf("create handle failed with %#x\n", ret);
+    goto destroy;
+  }
+
+  drop_page_cache(path);
+  if ((ret = open_model(handles[0], path, "cold")) != CVI_TDL_SUCCESS) goto destroy;
+  for (int i = 1; i < num_handles; i++) {
+    if ((ret = open_model(handles[i], path, "dedup")) != CVI_TDL_SUCCESS) goto destroy;
+  }
+
+  // the last instance releases the weights, the file stays in the page cache
+  for (int i = 0; i < num_handles; i++) {
+    CVI_TDL_CloseModel(handles[i], CVI_TDL_SUPPORTED_MODEL_YOLOV8_DETECTION);
+  }
+  ret = open_model(handles[0], path, "warm");
+
+destroy:
+  for (int i = 0; i < num_handles; i++) {
+    if (handles[i] != NULL) CVI_TDL_DestroyHandle(handles[i]);
+  }
+  return ret;
+}
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "motion_detection/motion_gate.hpp"
+#include "perf_utils.hpp"
+
+// host simulation of the motion gate on a mostly static camera
+// usage: test_motion_gate_perf [num_frames] [motion_percent]
+
+#define WIDTH 1920
+#define HEIGHT 1080
+
+int main(int argc, char *argv[]) {
+  int num_frames = argc > 1 ? atoi(argv[1]) : 10000;
+  int motion_percent = argc > 2 ? atoi(argv[2]) : 20;
+  if (num_frames <= 0 || motion_percent < 0 || motion_percent > 100) {
+    printf("usage: %s [num_frames] [motion_percent]\n", argv[0]);
+    return -1;
+  }
+
+  // motion events of 10 to 60 frames, a walker crossing part of the scene
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> duration(10, 60);
+  std::uniform_real_distribution<float> unit(0.f, 1.f);
+  std::vector<std::vector<cvtdl_bbox_t>> motion(num_frames);
+  int moving_frames = 0;
+  for (int f = 0; f < num_frames;) {
+    if (unit(rng) * 100 >= motion_percent) {
+      f += duration(rng);
+      continue;
+    }
+    int len = duration(rng);
+    float x = unit(rng) * (WIDTH - 200), y = unit(rng) * (HEIGHT - 300);
+    float vx = (unit(rng) - 0.5f) * 20;
+    for (int i = 0; i < len && f < num_frames; i++, f++) {
+      x = std::min(std::max(x + vx, 0.f), WIDTH - 100.f);
+      motion[f].push_back({x, y, x + 100, y + 250, 0});
+      // a few specks of sensor noise below the area threshold
+      motion[f].push_back({10, 10, 14, 14, 0});
+      moving_frames++;
+    }
+  }
+
+  MotionGate gate;
+  cvtdl_motion_gate_config_t config = MotionGate::defaultConfig();
+  gate.setConfig(config);
+  std::vector<cvtdl_object_info_t> infos(4);
+  cvtdl_object_t obj = {};
+  obj.info = infos.data();
+  obj.width = WIDTH;
+  obj.height = HEIGHT;
+
+  int ret = 0;
+  int counts[3] = {0, 0, 0};
+  double area = 0;
+  uint32_t since_full = 0;
+  cvtdl_motion_gate_t decision;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int f = 0; f < num_frames; f++) {
+    obj.size = motion[f].size();
+    for (uint32_t i = 0; i < obj.size; i++) obj.info[i].bbox = motion[f][i];
+    gate.decide(&obj, WIDTH, HEIGHT, &decision);
+    counts[decision.action]++;
+    const cvtdl_bbox_t &r = decision.roi;
+    area += (double)(r.x2 - r.x1) * (r.y2 - r.y1) / ((double)WIDTH * HEIGHT);
+
+    // the first frame is full, a full frame at least every keyframe_interval frames
+    if (f == 0 && decision.action != CVTDL_MOTION_GATE_FULL) ret = -1;
+    since_full = decision.action == CVTDL_MOTION_GATE_FULL ? 0 : since_full + 1;
+    if (since_full >= config.keyframe_interval) ret = -1;
+    // motion is never skipped and always inside the ROI
+    if (obj.size > 0 && decision.action == CVTDL_MOTION_GATE_SKIP) ret = -1;
+    if (decision.action == CVTDL_MOTION_GATE_ROI) {
+      const cvtdl_bbox_t &b = motion[f].empty() ? r : motion[f][0];
+      if (b.x1 < r.x1 || b.y1 < r.y1 || b.x2 > r.x2 || b.y2 > r.y2) ret = -1;
+      if (r.x1 < 0 || r.y1 < 0 || r.x2 > WIDTH || r.y2 > HEIGHT) ret = -1;
+      if (((int)r.x1 & 1) || ((int)r.y1 & 1)) ret = -1;
+    }
+  }
+  double ms = elapsed_ms(t0);
+
+  // boxes detected on a ROI crop map back to the frame
+  cvtdl_motion_gate_t roi_gate = {CVTDL_MOTION_GATE_ROI, {100, 200, 500, 400, 0}, WIDTH, HEIGHT, 1};
+  obj.size = 1;
+  obj.width = 800;
+  obj.height = 400;
+  obj.info[0].bbox = {400, 200, 800, 400, 0};
+  MotionGate::restore(&roi_gate, &obj);
+  const cvtdl_bbox_t &b = obj.info[0].bbox;
+  if (b.x1 != 300 || b.y1 != 300 || b.x2 != 500 || b.y2 != 400 || obj.width != WIDTH) ret = -1;
+
+  printf("frames %d, moving %.1f%%, decide %.3f us/frame\n", num_frames,
+         100.0 * moving_frames / num_frames, ms * 1000 / num_frames);
+  printf("full %d, roi %d, skip %d\n", counts[CVTDL_MOTION_GATE_FULL],
+         counts[CVTDL_MOTION_GATE_ROI], counts[CVTDL_MOTION_GATE_SKIP]);
+  printf("detector runs on %.1f%% of the frames, mean detected area %.1f%% of a frame\n",
+         100.0 * (counts[CVTDL_MOTION_GATE_FULL] + counts[CVTDL_MOTION_GATE_ROI]) / num_frames,
+         100.0 * area / num_frames);
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
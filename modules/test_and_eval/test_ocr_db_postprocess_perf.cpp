@@ -0,0 +1,150 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "db_postprocess.hpp"
+#include "perf_utils.hpp"
+#ifndef NO_OPENCV
+#include <opencv2/opencv.hpp>
+#endif
+
+// host benchmark of the native DB text detection postprocess on synthetic probability maps
+// usage: test_ocr_db_postprocess_perf [height] [width] [num_lines] [loops]
+
+struct TextLine {
+  float cx, cy, w, h, angle;
+};
+
+// rotated text lines at probability ~1 over low background noise, lines never touch
+static std::vector<TextLine> make_prob_map(int width, int height, int num_lines,
+                                           std::vector<float> &prob) {
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> noise(0.f, 0.2f);
+  std::uniform_real_distribution<float> text(0.96f, 1.f);
+  prob.resize((size_t)width * height);
+  for (auto &p : prob) p = noise(rng);
+
+  std::vector<TextLine> lines;
+  const int cols = std::max(1, (int)sqrtf(num_lines * 0.5f));
+  const int rows = (num_lines + cols - 1) / cols;
+  const float cell_w = (float)width / cols, cell_h = (float)height / rows;
+  std::uniform_real_distribution<float> angle(-0.25f, 0.25f);
+  for (int i = 0; i < num_lines; i++) {
+    TextLine line;
+    line.cx = (i % cols + 0.5f) * cell_w;
+    line.cy = (i / cols + 0.5f) * cell_h;
+    line.w = cell_w * 0.6f;
+    line.h = std::min(cell_h * 0.3f, line.w * 0.3f);
+    line.angle = angle(rng);
+    const float c = cosf(line.angle), s = sinf(line.angle);
+    const int r = (int)(0.5f * (line.w + line.h)) + 1;
+    for (int y = std::max(0, (int)line.cy - r); y < std::min(height, (int)line.cy + r); y++) {
+      for (int x = std::max(0, (int)line.cx - r); x < std::min(width, (int)line.cx + r); x++) {
+        float dx = x - line.cx, dy = y - line.cy;
+        if (fabsf(dx * c + dy * s) <= 0.5f * line.w && fabsf(-dx * s + dy * c) <= 0.5f * line.h) {
+          prob[(size_t)y * width + x] = text(rng);
+        }
+      }
+    }
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+#ifndef NO_OPENCV
+// the same steps on top of OpenCV: findContours, minAreaRect, mean score inside the contour
+static int opencv_postprocess(const float *prob, int width, int height,
+                              const cvitdl::DBPostprocessConfig &config) {
+  cv::Mat prob_map(height, width, CV_32FC1, (void *)prob);
+  cv::Mat binary = prob_map > config.thresh;
+  std::vector<std::vector<cv::Point>> contours;
+  cv::findContours(binary, contours, cv::RETR_LIST, cv::CHAIN_APPROX_SIMPLE);
+  int num_boxes = 0;
+  for (auto &contour : contours) {
+    if (cv::contourArea(contour) < config.min_area) continue;
+    cv::Rect rect = cv::boundingRect(contour);
+    cv::Mat mask = cv::Mat::zeros(rect.height, rect.width, CV_8UC1);
+    std::vector<std::vector<cv::Point>> shifted = {contour};
+    for (auto &pt : shifted[0]) pt -= rect.tl();
+    cv::fillPoly(mask, shifted, cv::Scalar(1));
+    if (cv::mean(prob_map(rect), mask)[0] < config.box_thresh) continue;
+    cv::RotatedRect box = cv::minAreaRect(contour);
+    float w = box.size.width, h = box.size.height;
+    if (std::min(w, h) < config.min_size) continue;
+    float d = w * h * config.unclip_ratio / (2 * (w + h));
+    if (std::min(w, h) + 2 * d < config.min_size + 2) continue;
+    num_boxes++;
+  }
+  return num_boxes;
+}
+#endif
+
+int main(int argc, char *argv[]) {
+  int height = argc > 1 ? atoi(argv[1]) : 640;
+  int width = argc > 2 ? atoi(argv[2]) : 640;
+  int num_lines = argc > 3 ? atoi(argv[3]) : 20;
+  int loops = argc > 4 ? atoi(argv[4]) : 20;
+  if (height < 32 || width < 32 || num_lines <= 0 || loops <= 0) {
+    printf("usage: %s [height>=32] [width>=32] [num_lines] [loops]\n", argv[0]);
+    return -1;
+  }
+
+  std::vector<float> prob;
+  std::vector<TextLine> lines = make_prob_map(width, height, num_lines, prob);
+  printf("prob map:%dx%d, text lines:%d\n", width, height, num_lines);
+
+  cvitdl::DBPostprocessConfig config;
+  config.thresh = 0.95f;
+  config.box_thresh = 0.6f;
+  config.min_size = 3;
+  cvitdl::DBPostprocess db(config);
+
+  auto t0 = std::chrono::steady_clock::now();
+  size_t num_boxes = 0;
+  for (int l = 0; l < loops; l++) {
+    num_boxes = db.run(prob.data(), width, height, width).size();
+  }
+  printf("native: %zu boxes, %.3f ms\n", num_boxes, elapsed_ms(t0) / loops);
+
+#ifndef NO_OPENCV
+  t0 = std::chrono::steady_clock::now();
+  int num_cv_boxes = 0;
+  for (int l = 0; l < loops; l++) {
+    num_cv_boxes = opencv_postprocess(prob.data(), width, height, config);
+  }
+  printf("opencv: %d boxes, %.3f ms\n", num_cv_boxes, elapsed_ms(t0) / loops);
+#endif
+
+  // every line is found once and its unclipped rect covers the line
+  int ret = num_boxes == lines.size() ? 0 : -1;
+#ifndef NO_OPENCV
+  if (num_cv_boxes != (int)num_boxes) {
+    printf("opencv finds %d boxes, native %zu\n", num_cv_boxes, num_boxes);
+    ret = -1;
+  }
+#endif
+  const std::vector<cvitdl::DBTextBox> &boxes = db.run(prob.data(), width, height, width);
+  for (const TextLine &line : lines) {
+    bool found = false;
+    for (const cvitdl::DBTextBox &box : boxes) {
+      float cx = 0, cy = 0;
+      for (int i = 0; i < 4; i++) {
+        cx += 0.25f * box.pts[i][0];
+        cy += 0.25f * box.pts[i][1];
+      }
+      float side0 = hypotf(box.pts[1][0] - box.pts[0][0], box.pts[1][1] - box.pts[0][1]);
+      float side1 = hypotf(box.pts[2][0] - box.pts[1][0], box.pts[2][1] - box.pts[1][1]);
+      if (fabsf(cx - line.cx) < 2 && fabsf(cy - line.cy) < 2 &&
+          std::max(side0, side1) >= line.w - 2 && std::min(side0, side1) >= line.h - 2) {
+        found = true;
+        break;
+      }
+    }
+    if (!found) ret = -1;
+  }
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
@@ -0,0 +1,188 @@
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "draw_rect/overlay.hpp"
+
+// check of the overlay span rasterizer and chroma fill against per-pixel drawing: every pixel of
+// every primitive written on its own, to luma and to the chroma sample it falls in
+// usage: test_overlay_render
+
+using cvitdl::service::Overlay;
+
+#define WIDTH 64
+#define HEIGHT 48
+#define STRIDE 80
+
+typedef struct {
+  bool disc;
+  cvtdl_bbox_t bbox;  // rect, or the disc center in x1, y1
+  uint32_t radius;
+  cvtdl_service_brush_t brush;
+} prim_t;
+
+static cvtdl_service_brush_t make_brush(float r, float g, float b, uint32_t size) {
+  cvtdl_service_brush_t brush;
+  brush.color.r = r;
+  brush.color.g = g;
+  brush.color.b = b;
+  brush.size = size;
+  return brush;
+}
+
+static uint8_t to_yuv(int channel, const cvtdl_service_brush_t &brush) {
+  float r = brush.color.r, g = brush.color.g, b = brush.color.b;
+  float v;
+  if (channel == 0) {
+    v = (0.257 * r) + (0.504 * g) + (0.098 * b) + 16;
+  } else if (channel == 1) {
+    v = -(.148 * r) - (.291 * g) + (.439 * b) + 128;
+  } else {
+    v = (0.439 * r) - (0.368 * g) - (0.071 * b) + 128;
+  }
+  return (v < 0) ? 0 : ((v > 255.) ? 255 : static_cast<uint8_t>(v));
+}
+
+static bool covers(const prim_t &p, int x, int y) {
+  if (p.disc) {
+    int dx = x - static_cast<int>(lroundf(p.bbox.x1));
+    int dy = y - static_cast<int>(lroundf(p.bbox.y1));
+    int r = p.radius;
+    return dx * dx + dy * dy <= r * r;
+  }
+  int x1 = static_cast<int>(p.bbox.x1), y1 = static_cast<int>(p.bbox.y1);
+  int x2 = static_cast<int>(p.bbox.x2), y2 = static_cast<int>(p.bbox.y2);
+  if (x < x1 || x > x2 || y < y1 || y > y2) return false;
+  // the DrawRect thickness: at least 2, rounded up to even, at most the box
+  int t = p.brush.size < 2 ? 2 : p.brush.size + (p.brush.size & 1);
+  t = std::min(t, std::min(x2 - x1 + 1, y2 - y1 + 1));
+  return x < x1 + t || x > x2 - t || y < y1 + t || y > y2 - t;
+}
+
+typedef struct {
+  std::vector<uint8_t> y, c1, c2;
+} planes_t;
+
+static void init_planes(planes_t *p) {
+  p->y.resize(STRIDE * HEIGHT);
+  p->c1.resize(STRIDE * HEIGHT / 2);
+  p->c2.resize(STRIDE * HEIGHT / 2);
+  for (size_t i = 0; i < p->y.size(); i++) p->y[i] = (i * 7) & 0xff;
+  for (size_t i = 0; i < p->c1.size(); i++) {
+    p->c1[i] = (i * 13) & 0xff;
+    p->c2[i] = (i * 29) & 0xff;
+  }
+}
+
+static void draw_reference(const std::vector<prim_t> &prims, PIXEL_FORMAT_E format, planes_t *p) {
+  for (int y = 0; y < HEIGHT; y++) {
+    for (const prim_t &prim : prims) {
+      uint8_t cy = to_yuv(0, prim.brush), cu = to_yuv(1, prim.brush), cv = to_yuv(2, prim.brush);
+      for (int x = 0; x < WIDTH; x++) {
+        if (!covers(prim, x, y)) continue;
+        p->y[y * STRIDE + x] = cy;
+        int c = (y >> 1) * (format == PIXEL_FORMAT_YUV_PLANAR_420 ? STRIDE / 2 : STRIDE);
+        if (format == PIXEL_FORMAT_NV21) {
+          p->c1[c + (x >> 1) * 2] = cv;
+          p->c1[c + (x >> 1) * 2 + 1] = cu;
+        } else if (format == PIXEL_FORMAT_NV12) {
+          p->c1[c + (x >> 1) * 2] = cu;
+          p->c1[c + (x >> 1) * 2 + 1] = cv;
+        } else {
+          p->c1[c + (x >> 1)] = cu;
+          p->c2[c + (x >> 1)] = cv;
+        }
+      }
+    }
+  }
+}
+
+static int render_overlay(Overlay *overlay, const std::vector<prim_t> &prims,
+                          PIXEL_FORMAT_E format, planes_t *p) {
+  overlay->clear();
+  for (const prim_t &prim : prims) {
+    if (prim.disc) {
+      float x = prim.bbox.x1, y = prim.bbox.y1;
+      cvtdl_pts_t pts = {&x, &y, 1, 0};
+      overlay->addPoints(pts, prim.radius, prim.brush);
+    } else {
+      overlay->addRect(prim.bbox, prim.brush);
+    }
+  }
+  VIDEO_FRAME_INFO_S frame;
+  memset(&frame, 0, sizeof(frame));
+  frame.stVFrame.enPixelFormat = format;
+  frame.stVFrame.u32Width = WIDTH;
+  frame.stVFrame.u32Height = HEIGHT;
+  frame.stVFrame.u32Stride[0] = STRIDE;
+  frame.stVFrame.u32Stride[1] = format == PIXEL_FORMAT_YUV_PLANAR_420 ? STRIDE / 2 : STRIDE;
+  frame.stVFrame.u32Stride[2] = STRIDE / 2;
+  frame.stVFrame.u32Length[0] = p->y.size();
+  frame.stVFrame.u32Length[1] = p->c1.size();
+  frame.stVFrame.u32Length[2] = format == PIXEL_FORMAT_YUV_PLANAR_420 ? p->c2.size() : 0;
+  frame.stVFrame.pu8VirAddr[0] = p->y.data();
+  frame.stVFrame.pu8VirAddr[1] = p->c1.data();
+  frame.stVFrame.pu8VirAddr[2] = p->c2.data();
+  return overlay->render(&frame);
+}
+
+static int compare(const char *name, const std::vector<uint8_t> &got,
+                   const std::vector<uint8_t> &expected, int stride) {
+  for (size_t i = 0; i < got.size(); i++) {
+    if (got[i] != expected[i]) {
+      printf("%s differs at x %d, y %d: %d instead of %d\n", name, (int)(i % stride),
+             (int)(i / stride), got[i], expected[i]);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int main() {
+  std::vector<prim_t> prims;
+  const cvtdl_service_brush_t red = make_brush(255, 0, 0, 1);
+  const cvtdl_service_brush_t green = make_brush(0, 255, 0, 3);
+  const cvtdl_service_brush_t blue = make_brush(0, 0, 255, 5);
+  const cvtdl_service_brush_t white = make_brush(255, 255, 255, 2);
+  // odd corners, overlaps, boxes thinner than the line and boxes leaving the frame
+  prims.push_back({false, {3, 5, 40, 30, 0}, 0, red});
+  prims.push_back({false, {10.7f, 9.2f, 51.9f, 41.5f, 0}, 0, green});
+  prims.push_back({false, {21, 1, 23, 46, 0}, 0, blue});
+  prims.push_back({false, {-6, -3, 9, 12, 0}, 0, white});
+  prims.push_back({false, {55, 40, 80, 60, 0}, 0, blue});
+  prims.push_back({false, {30, 20, 30, 20, 0}, 0, green});
+  prims.push_back({false, {33, 7, 36, 8, 0}, 0, white});
+  // discs on odd and even centers, partly outside
+  prims.push_back({true, {17, 18, 0, 0, 0}, 3, white});
+  prims.push_back({true, {44.4f, 25.6f, 0, 0, 0}, 4, red});
+  prims.push_back({true, {1, 46, 0, 0, 0}, 2, green});
+  prims.push_back({true, {63, 0, 0, 0, 0}, 1, blue});
+
+  Overlay overlay;
+  int ret = 0;
+  const PIXEL_FORMAT_E formats[] = {PIXEL_FORMAT_NV21, PIXEL_FORMAT_NV12,
+                                    PIXEL_FORMAT_YUV_PLANAR_420};
+  const char *names[] = {"NV21", "NV12", "YUV420P"};
+  for (int f = 0; f < 3; f++) {
+    planes_t got, expected;
+    init_planes(&got);
+    init_planes(&expected);
+    draw_reference(prims, formats[f], &expected);
+    if (render_overlay(&overlay, prims, formats[f], &got) != 0) {
+      printf("%s: render failed\n", names[f]);
+      ret = -1;
+      continue;
+    }
+    int chroma_stride = formats[f] == PIXEL_FORMAT_YUV_PLANAR_420 ? STRIDE / 2 : STRIDE;
+    printf("%s: %zu primitives\n", names[f], prims.size());
+    if (compare("luma", got.y, expected.y, STRIDE) != 0 ||
+        compare("chroma 1", got.c1, expected.c1, chroma_stride) != 0 ||
+        compare("chroma 2", got.c2, expected.c2, STRIDE / 2) != 0) {
+      ret = -1;
+    }
+  }
+
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
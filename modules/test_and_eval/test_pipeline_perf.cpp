@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include "core/cvi_tdl_core.h"
+#include "core/utils/vpss_helper.h"
+#include "cvi_stub_runtime.h"
+
+// host benchmark of whole pipelines against the stub runtime, built with -DUSE_STUB_RUNTIME=ON
+// usage: test_pipeline_perf <work_dir> [num_frames] [latency_us]
+// The model descriptors are written to work_dir, put <tensor>_<n>.bin files in
+// work_dir/<model>_replay to replay recorded outputs instead of the synthesized ones.
+
+#define WIDTH 1920
+#define HEIGHT 1080
+
+// int8 YOLOv8 head of a 640x640 model, sparse confident cells on a low background
+static std::string yolov8_desc(int latency_us) {
+  std::string s = "input images int8 1 3 640 640 qscale 1\n";
+  const int strides[3] = {8, 16, 32};
+  for (int stride : strides) {
+    std::string hw = std::to_string(640 / stride) + " " + std::to_string(640 / stride);
+    s += "output box_s" + std::to_string(stride) + " int8 1 64 " + hw + " qscale 0.1\n";
+    s += "output cls_s" + std::to_string(stride) + " int8 1 80 " + hw +
+         " qscale 0.05 range -128 -60 spikes 0.0002 100\n";
+  }
+  return s + "latency_us " + std::to_string(latency_us) + "\n";
+}
+
+static std::string retinaface_desc(int latency_us) {
+  std::string s = "input data int8 1 3 384 640 qscale 1\n";
+  const int strides[3] = {8, 16, 32};
+  for (int stride : strides) {
+    std::string key = "_stride" + std::to_string(stride) + "_dequant fp32 1 ";
+    std::string hw = " " + std::to_string(384 / stride) + " " + std::to_string(640 / stride);
+    s += "output face_rpn_bbox_pred" + key + "8" + hw + " range -0.2 0.2\n";
+    s += "output face_rpn_cls_prob_reshape" + key + "4" + hw +
+         " range 0 0.05 spikes 0.0005 0.99\n";
+    s += "output face_rpn_landmark_pred" + key + "20" + hw + " range -0.2 0.2\n";
+  }
+  return s + "latency_us " + std::to_string(latency_us) + "\n";
+}
+
+static std::string facerecognition_desc(int latency_us) {
+  return "input data int8 1 3 112 112 qscale 1\n"
+         "output pre_fc1 int8 1 512 1 1\n"
+         "latency_us " +
+         std::to_string(latency_us) + "\n";
+}
+
+static int write_desc(const std::string &dir, const std::string &model, const std::string &desc,
+                      std::string *path) {
+  *path = dir + "/" + model + ".desc";
+  FILE *fp = fopen(path->c_str(), "w");
+  if (fp == NULL) {
+    printf("cannot write %s\n", path->c_str());
+    return -1;
+  }
+  fprintf(fp, "%sreplay %s/%s_replay\n", desc.c_str(), dir.c_str(), model.c_str());
+  fclose(fp);
+  return 0;
+}
+
+// a bright block moving over a gradient, so VPSS does real work on every frame
+static void fill_frame(VIDEO_FRAME_INFO_S *frame, int f) {
+  VIDEO_FRAME_S *v = &frame->stVFrame;
+  for (int c = 0; c < 3; c++) {
+    for (uint32_t y = 0; y < v->u32Height; y++) {
+      uint8_t *row = v->pu8VirAddr[c] + y * v->u32Stride[c];
+      for (uint32_t x = 0; x < v->u32Width; x++) row[x] = (uint8_t)((x + y + c * 40) >> 3);
+    }
+  }
+  uint32_t x0 = (f * 16) % (v->u32Width - 200), y0 = v->u32Height / 3;
+  for (int c = 0; c < 3; c++) {
+    for (uint32_t y = y0; y < y0 + 300; y++) {
+      memset(v->pu8VirAddr[c] + y * v->u32Stride[c] + x0, 230, 200);
+    }
+  }
+}
+
+struct StageTime {
+  double total_ms = 0;
+  double emulated_ms = 0;
+  double results = 0;
+};
+
+class StageTimer {
+ public:
+  explicit StageTimer(StageTime *t) : t_(t) {
+    CVI_STUB_GetStats(&s0_);
+    t0_ = std::chrono::steady_clock::now();
+  }
+  ~StageTimer() {
+    double ms =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0_).count();
+    cvi_stub_stats_t s1;
+    CVI_STUB_GetStats(&s1);
+    t_->total_ms += ms;
+    t_->emulated_ms += ((s1.forward_us - s0_.forward_us) + (s1.vpss_us - s0_.vpss_us)) / 1000.0;
+  }
+
+ private:
+  StageTime *t_;
+  cvi_stub_stats_t s0_;
+  std::chrono::steady_clock::time_point t0_;
+};
+
+static void print_stage(const char *name, const StageTime &t, int num_frames) {
+  printf("%-22s total %8.3f ms  emulated %8.3f ms  host %8.3f ms  results %6.2f  per frame\n",
+         name, t.total_ms / num_frames, t.emulated_ms / num_frames,
+         (t.total_ms - t.emulated_ms) / num_frames, t.results / num_frames);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printf("usage: %s <work_dir> [num_frames] [latency_us]\n", argv[0]);
+    return -1;
+  }
+  std::string dir = argv[1];
+  int num_frames = argc > 2 ? atoi(argv[2]) : 300;
+  int latency_us = argc > 3 ? atoi(argv[3]) : 0;
+  if (num_frames <= 0 || latency_us < 0) {
+    printf("usage: %s <work_dir> [num_frames] [latency_us]\n", argv[0]);
+    return -1;
+  }
+
+  std::string yolov8_path, retinaface_path, fr_path;
+  if (write_desc(dir, "yolov8", yolov8_desc(latency_us), &yolov8_path) != 0 ||
+      write_desc(dir, "retinaface", retinaface_desc(latency_us), &retinaface_path) != 0 ||
+      write_desc(dir, "facerecognition", facerecognition_desc(latency_us), &fr_path) != 0) {
+    return -1;
+  }
+
+  cvitdl_handle_t handle = NULL;
+  int ret = CVI_TDL_CreateHandle(&handle);
+  if (ret != CVI_SUCCESS) {
+    printf("create handle failed with %#x!\n", ret);
+    return ret;
+  }
+  ret = CVI_TDL_OpenModel(handle, CVI_TDL_SUPPORTED_MODEL_YOLOV8_DETECTION, yolov8_path.c_str());
+  ret |= CVI_TDL_OpenModel(handle, CVI_TDL_SUPPORTED_MODEL_RETINAFACE, retinaface_path.c_str());
+  ret |= CVI_TDL_OpenModel(handle, CVI_TDL_SUPPORTED_MODEL_FACERECOGNITION, fr_path.c_str());
+  if (ret != CVI_SUCCESS) {
+    printf("open model failed with %#x!\n", ret);
+    CVI_TDL_DestroyHandle(handle);
+    return ret;
+  }
+  CVI_TDL_DeepSORT_Init(handle, false);
+  cvtdl_deepsort_config_t ds_conf;
+  CVI_TDL_DeepSORT_GetDefaultConfig(&ds_conf);
+  CVI_TDL_DeepSORT_SetConfig(handle, &ds_conf, -1, false);
+
+  VIDEO_FRAME_INFO_S frame;
+  if (CREATE_ION_HELPER(&frame, WIDTH, HEIGHT, PIXEL_FORMAT_RGB_888_PLANAR, "pipeline") !=
+      CVI_SUCCESS) {
+    printf("alloc frame failed!\n");
+    CVI_TDL_DestroyHandle(handle);
+    return -1;
+  }
+
+  StageTime det, trk, face, fr;
+  CVI_STUB_ResetStats();
+  for (int f = 0; f < num_frames && ret == CVI_SUCCESS; f++) {
+    fill_frame(&frame, f);
+    cvtdl_object_t obj = {};
+    cvtdl_tracker_t tracker = {};
+    cvtdl_face_t faces = {};
+    {
+      StageTimer t(&det);
+      ret |= CVI_TDL_Detection(handle, &frame, CVI_TDL_SUPPORTED_MODEL_YOLOV8_DETECTION, &obj);
+    }
+    det.results += obj.size;
+    {
+      StageTimer t(&trk);
+      ret |= CVI_TDL_DeepSORT_Obj(handle, &obj, &tracker, false);
+    }
+    trk.results += tracker.size;
+    {
+      StageTimer t(&face);
+      ret |= CVI_TDL_FaceDetection(handle, &frame, CVI_TDL_SUPPORTED_MODEL_RETINAFACE, &faces);
+    }
+    face.results += faces.size;
+    {
+      StageTimer t(&fr);
+      ret |= CVI_TDL_FaceRecognition(handle, &frame, &faces);
+    }
+    fr.results += faces.size;
+    CVI_TDL_Free(&obj);
+    CVI_TDL_Free(&tracker);
+    CVI_TDL_Free(&faces);
+  }
+  if (ret != CVI_SUCCESS) printf("pipeline failed with %#x!\n", ret);
+
+  cvi_stub_stats_t stats;
+  CVI_STUB_GetStats(&stats);
+  printf("frames %d, %dx%d, forwards %lu, vpss %lu, ion peak %lu KB\n", num_frames, WIDTH, HEIGHT,
+         (unsigned long)stats.forward_count, (unsigned long)stats.vpss_count,
+         (unsigned long)(stats.ion_peak_bytes >> 10));
+  print_stage("yolov8 detection", det, num_frames);
+  print_stage("deepsort", trk, num_frames);
+  print_stage("retinaface", face, num_frames);
+  print_stage("face recognition", fr, num_frames);
+
+  CVI_SYS_IonFree(frame.stVFrame.u64PhyAddr[0], frame.stVFrame.pu8VirAddr[0]);
+  CVI_TDL_DestroyHandle(handle);
+  return ret;
+}
@@ -0,0 +1,125 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits>
+#include <random>
+#include <vector>
+#include "requant_utils.hpp"
+
+// check of the stereo depth requantization (NEON or table path) against the scalar loop, with
+// saturating and NaN values, every tail length and unaligned buffers
+// usage: test_requant_utils [num_rounds]
+
+// the scalar loop of CVI_TDL_Depth_Stereo, with the saturation of RequantizeInt8
+static int8_t reference(float v) {
+  if (std::isnan(v)) return 0;
+  if (v <= -128.f) return -128;
+  if (v >= 127.f) return 127;
+  return (int8_t)v;
+}
+
+static int check_int8(std::mt19937 &rng, float scale) {
+  std::uniform_int_distribution<int> val(-128, 127);
+  // every length up to a few vectors, at every offset inside a vector
+  for (int n = 0; n <= 67; n++) {
+    for (int offset = 0; offset < 16; offset += 5) {
+      std::vector<int8_t> src(offset + n), dst(offset + n + 1, 0x55);
+      for (int8_t &v : src) v = (int8_t)val(rng);
+      cvitdl::RequantizeInt8(src.data() + offset, n, scale, dst.data() + offset);
+      for (int i = 0; i < n; i++) {
+        if (dst[offset + i] != reference(src[offset + i] * scale)) {
+          printf("int8 scale %g n %d: %d * scale gives %d\n", scale, n, src[offset + i],
+                 dst[offset + i]);
+          return -1;
+        }
+      }
+      if (dst[offset + n] != 0x55) {
+        printf("int8 scale %g n %d writes past the end\n", scale, n);
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+static int check_float(std::mt19937 &rng, float scale) {
+  const float special[] = {std::numeric_limits<float>::quiet_NaN(),
+                           std::numeric_limits<float>::infinity(),
+                           -std::numeric_limits<float>::infinity(),
+                           127.f,
+                           127.9f,
+                           128.f,
+                           -128.f,
+                           -128.9f,
+                           -129.f,
+                           0.99f,
+                           -0.99f,
+                           1e30f,
+                           -1e30f};
+  const int num_special = sizeof(special) / sizeof(special[0]);
+  std::uniform_real_distribution<float> val(-300.f, 300.f);
+  std::uniform_int_distribution<int> pick(0, 3 * num_special);
+  for (int n = 0; n <= 67; n++) {
+    for (int offset = 0; offset < 4; offset += 3) {
+      std::vector<float> src(offset + n);
+      std::vector<int8_t> dst(offset + n + 1, 0x55);
+      for (float &v : src) {
+        int k = pick(rng);
+        v = k < num_special ? special[k] / scale : val(rng);
+      }
+      cvitdl::RequantizeInt8(src.data() + offset, n, scale, dst.data() + offset);
+      for (int i = 0; i < n; i++) {
+        if (dst[offset + i] != reference(src[offset + i] * scale)) {
+          printf("float scale %g n %d: %g * scale gives %d\n", scale, n, src[offset + i],
+                 dst[offset + i]);
+          return -1;
+        }
+      }
+      if (dst[offset + n] != 0x55) {
+        printf("float scale %g n %d writes past the end\n", scale, n);
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+static int check_depth_lut() {
+  const float baseline = 0.12f, focal = 700.f, disparity_scale = 0.25f;
+  float lut[256];
+  cvitdl::BuildDepthLUT(baseline, focal, disparity_scale, lut);
+  std::vector<int8_t> src(256);
+  std::vector<float> depth(256);
+  for (int d = -128; d < 128; d++) src[d + 128] = (int8_t)d;
+  cvitdl::LookupDepth(src.data(), 256, lut, depth.data());
+  for (int d = -128; d < 128; d++) {
+    float expect = d > 0 ? baseline * focal / (d * disparity_scale) : 0.f;
+    if (fabsf(depth[d + 128] - expect) > 1e-5f * expect) {
+      printf("depth of disparity %d is %g instead of %g\n", d, depth[d + 128], expect);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  int num_rounds = argc > 1 ? atoi(argv[1]) : 20;
+  if (num_rounds <= 0) {
+    printf("usage: %s [num_rounds]\n", argv[0]);
+    return -1;
+  }
+  // in range, saturating both ways, negative, zero and NaN scales
+  const float scales[] = {0.37f, 1.f, 3.9f, 200.f, -0.8f, -5.f, 0.f,
+                          std::numeric_limits<float>::quiet_NaN()};
+  std::mt19937 rng(1234);
+  int ret = 0;
+  for (int r = 0; r < num_rounds && ret == 0; r++) {
+    for (float scale : scales) {
+      ret |= check_int8(rng, scale);
+      if (scale != 0.f && !std::isnan(scale)) ret |= check_float(rng, scale);
+    }
+  }
+  ret |= check_depth_lut();
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "core/cvi_tdl_utils.h"
+
+// stress test of the result channel: one producer publishes stamped results while readers hold
+// snapshots and check that no slot is refilled under them
+// usage: test_result_channel [num_publish] [num_readers]
+
+#define MAX_OBJECTS 4
+
+static std::atomic<bool> g_stop(false);
+static std::atomic<int> g_ready(0);
+static std::atomic<uint64_t> g_errors(0);
+
+static bool check_snapshot(const cvtdl_object_t *meta, uint64_t seq) {
+  if (meta->size < 1 || meta->size > MAX_OBJECTS || meta->info == NULL) return false;
+  for (uint32_t i = 0; i < meta->size; i++) {
+    if (meta->info[i].unique_id != seq || meta->info[i].bbox.x1 != (float)(seq & 0xffff)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void reader(cvitdl_result_channel_t channel, int id, uint64_t *acquired) {
+  uint64_t last_seq = 0;
+  uint32_t rng = 1234567u * (id + 1);
+  g_ready++;
+  while (!g_stop.load(std::memory_order_relaxed)) {
+    const cvtdl_object_t *meta = NULL;
+    uint64_t seq = 0;
+    if (CVI_TDL_ResultChannel_AcquireObject(channel, &meta, &seq) != CVI_TDL_SUCCESS) {
+      g_errors++;
+      return;
+    }
+    if (meta == NULL) {
+      std::this_thread::yield();
+      continue;
+    }
+    (*acquired)++;
+    if (seq < last_seq || !check_snapshot(meta, seq)) {
+      printf("reader %d: bad snapshot seq %lu (last %lu)\n", id, (unsigned long)seq,
+             (unsigned long)last_seq);
+      g_errors++;
+    }
+    last_seq = seq;
+    // hold the snapshot for a while, the producer keeps publishing meanwhile
+    rng = rng * 1103515245u + 12345u;
+    uint32_t hold = (rng >> 16) % 64;
+    for (uint32_t k = 0; k < hold; k++) std::this_thread::yield();
+    if (!check_snapshot(meta, seq)) {
+      printf("reader %d: snapshot seq %lu changed while held\n", id, (unsigned long)seq);
+      g_errors++;
+    }
+    if (CVI_TDL_ResultChannel_Release(channel, meta) != CVI_TDL_SUCCESS) {
+      g_errors++;
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int num_publish = argc > 1 ? atoi(argv[1]) : 200000;
+  int num_readers = argc > 2 ? atoi(argv[2]) : 4;
+  if (num_publish <= 0 || num_readers <= 0 || num_readers > 64) {
+    printf("usage: %s [num_publish] [num_readers]\n", argv[0]);
+    return -1;
+  }
+
+  cvitdl_result_channel_t channel = NULL;
+  if (CVI_TDL_ResultChannel_Create(&channel, false) != CVI_TDL_SUCCESS) {
+    printf("create channel failed\n");
+    return -1;
+  }
+  // a face meta is rejected on an object channel
+  cvtdl_face_t face = {};
+  if (CVI_TDL_ResultChannel_PublishFace(channel, &face) != CVI_TDL_ERR_INVALID_ARGS) {
+    printf("face meta accepted by an object channel\n");
+    g_errors++;
+  }
+
+  std::vector<uint64_t> acquired(num_readers, 0);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < num_readers; i++) {
+    readers.emplace_back(reader, channel, i, &acquired[i]);
+  }
+
+  while (g_ready.load() < num_readers) std::this_thread::yield();
+  cvtdl_object_t meta = {};
+  uint64_t published = 0, refused = 0;
+  while (published < (uint64_t)num_publish) {
+    // the recycled meta comes back with its info array, which is refilled in place
+    uint64_t seq = published + 1;
+    if (meta.info == NULL) {
+      meta.info = (cvtdl_object_info_t *)calloc(MAX_OBJECTS, sizeof(cvtdl_object_info_t));
+    }
+    meta.size = 1 + seq % MAX_OBJECTS;
+    for (uint32_t i = 0; i < meta.size; i++) {
+      meta.info[i].unique_id = seq;
+      meta.info[i].bbox.x1 = (float)(seq & 0xffff);
+    }
+    if (CVI_TDL_ResultChannel_PublishObject(channel, &meta) != CVI_TDL_SUCCESS) {
+      refused++;
+      std::this_thread::yield();
+      continue;
+    }
+    published++;
+    std::this_thread::yield();
+  }
+  g_stop = true;
+  for (std::thread &t : readers) t.join();
+
+  // the last result is still the current one
+  const cvtdl_object_t *last = NULL;
+  uint64_t last_seq = 0;
+  CVI_TDL_ResultChannel_AcquireObject(channel, &last, &last_seq);
+  if (last == NULL || last_seq != published || !check_snapshot(last, last_seq)) {
+    printf("last snapshot is not the last published result\n");
+    g_errors++;
+  }
+  CVI_TDL_ResultChannel_Release(channel, last);
+
+  CVI_TDL_Free(&meta);
+  CVI_TDL_ResultChannel_Destroy(channel);
+
+  uint64_t total = 0;
+  for (uint64_t n : acquired) total += n;
+  printf("%lu published, %lu refused, %lu snapshots read by %d readers, %lu errors\n",
+         (unsigned long)published, (unsigned long)refused, (unsigned long)total, num_readers,
+         (unsigned long)g_errors.load());
+  return g_errors.load() == 0 ? CVI_TDL_SUCCESS : CVI_TDL_FAILURE;
+}
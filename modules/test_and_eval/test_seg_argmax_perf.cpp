@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "seg_utils.hpp"
+#include "perf_utils.hpp"
+
+// host benchmark of the segmentation argmax kernel against the previous scalar loops
+// usage: test_seg_argmax_perf [channels] [height] [width] [loops]
+
+// previous Deeplabv3 implementation: argmax pass then separate class filter pass
+static void reference_argmax(const float *out, int channels, int height, int width,
+                             const cvtdl_class_filter_t *filter, uint8_t *labels) {
+  int size = height * width;
+  std::vector<float> max_prob(size, -1e30f);
+  memset(labels, 0, size);
+  for (int c = 0; c < channels; ++c) {
+    for (int i = 0; i < size; ++i) {
+      if (out[c * size + i] > max_prob[i]) {
+        labels[i] = (uint8_t)c;
+        max_prob[i] = out[c * size + i];
+      }
+    }
+  }
+  if (filter) {
+    for (int i = 0; i < size; ++i) {
+      bool keep = labels[i] == 0;
+      for (uint32_t j = 0; j < filter->num_preserved_classes && !keep; j++) {
+        keep = filter->preserved_class_ids[j] == labels[i];
+      }
+      if (!keep) labels[i] = 0;
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int channels = argc > 1 ? atoi(argv[1]) : 19;
+  int height = argc > 2 ? atoi(argv[2]) : 512;
+  int width = argc > 3 ? atoi(argv[3]) : 512;
+  int loops = argc > 4 ? atoi(argv[4]) : 10;
+  if (channels <= 0 || channels > 256 || height <= 0 || width <= 0 || loops <= 0) {
+    printf("usage: %s [channels<=256] [height] [width] [loops]\n", argv[0]);
+    return -1;
+  }
+  const int size = height * width;
+  const float qscale = 0.05f;
+
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> val(-127, 127);
+  std::vector<int8_t> scores_int8(channels * size);
+  std::vector<float> scores_float(channels * size);
+  for (size_t i = 0; i < scores_int8.size(); i++) {
+    scores_int8[i] = val(rng);
+    scores_float[i] = scores_int8[i] * qscale;
+  }
+
+  uint32_t preserved[] = {1, 2, 7, 11};
+  cvtdl_class_filter_t filter = {preserved, 4};
+  uint8_t lut[256];
+  cvitdl::BuildClassFilterLUT(&filter, lut);
+
+  std::vector<uint8_t> ref(size), labels(size);
+  std::vector<float> conf(size);
+  printf("scores:%dx%dx%d\n", channels, height, width);
+
+  auto t0 = std::chrono::steady_clock::now();
+  for (int l = 0; l < loops; l++) {
+    reference_argmax(scores_float.data(), channels, height, width, &filter, ref.data());
+  }
+  double ref_ms = elapsed_ms(t0) / loops;
+  printf("scalar argmax + filter (float): %.3f ms\n", ref_ms);
+
+  int ret = 0;
+  for (int with_conf = 0; with_conf < 2; with_conf++) {
+    float *p_conf = with_conf ? conf.data() : NULL;
+    t0 = std::chrono::steady_clock::now();
+    for (int l = 0; l < loops; l++) {
+      cvitdl::ChannelArgmax(scores_float.data(), channels, height, width, lut, labels.data(),
+                            width, p_conf);
+    }
+    double ms = elapsed_ms(t0) / loops;
+    bool same = memcmp(ref.data(), labels.data(), size) == 0;
+    printf("fused argmax (float%s): %.3f ms, speedup %.1fx, %s\n", with_conf ? ", conf" : "", ms,
+           ref_ms / ms, same ? "match" : "MISMATCH");
+    if (!same) ret = -1;
+
+    t0 = std::chrono::steady_clock::now();
+    for (int l = 0; l < loops; l++) {
+      cvitdl::ChannelArgmax(scores_int8.data(), channels, height, width, qscale, lut,
+                            labels.data(), width, p_conf);
+    }
+    ms = elapsed_ms(t0) / loops;
+    same = memcmp(ref.data(), labels.data(), size) == 0;
+    printf("fused argmax (int8%s): %.3f ms, speedup %.1fx, %s\n", with_conf ? ", conf" : "", ms,
+           ref_ms / ms, same ? "match" : "MISMATCH");
+    if (!same) ret = -1;
+  }
+  return ret;
+}
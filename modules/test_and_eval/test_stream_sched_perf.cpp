@@ -0,0 +1,235 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "core/cvi_tdl_core.h"
+#include "core/utils/vpss_helper.h"
+#include "cvi_stub_runtime.h"
+
+// host benchmark of one YOLOv8 model serving many streams, built with -DUSE_STUB_RUNTIME=ON
+// usage: test_stream_sched_perf <work_dir> [num_streams] [frames_per_stream] [latency_us]
+// Compares a loop over the streams on one handle with the stream scheduler, then overloads the
+// scheduler to show the deadline drops. Checks that every frame is reported once and that the
+// frames run of a stream keep the submit order.
+
+#define WIDTH 1920
+#define HEIGHT 1080
+
+static std::string yolov8_desc(int latency_us) {
+  std::string s = "input images int8 1 3 640 640 qscale 1\n";
+  const int strides[3] = {8, 16, 32};
+  for (int stride : strides) {
+    std::string hw = std::to_string(640 / stride) + " " + std::to_string(640 / stride);
+    s += "output box_s" + std::to_string(stride) + " int8 1 64 " + hw + " qscale 0.1\n";
+    s += "output cls_s" + std::to_string(stride) + " int8 1 80 " + hw +
+         " qscale 0.05 range -128 -60 spikes 0.0002 100\n";
+  }
+  return s + "latency_us " + std::to_string(latency_us) + "\n";
+}
+
+static void fill_frame(VIDEO_FRAME_INFO_S *frame, int seed) {
+  VIDEO_FRAME_S *v = &frame->stVFrame;
+  for (int c = 0; c < 3; c++) {
+    for (uint32_t y = 0; y < v->u32Height; y++) {
+      uint8_t *row = v->pu8VirAddr[c] + y * v->u32Stride[c];
+      for (uint32_t x = 0; x < v->u32Width; x++) row[x] = (uint8_t)((x + y + seed * 40) >> 3);
+    }
+  }
+}
+
+// every submit has a frame of its own, the frame pointer identifies the stream and the submit
+struct Results {
+  Results(const VIDEO_FRAME_INFO_S *base, int num_streams, int num_frames)
+      : base(base), num_frames(num_frames), reported(num_streams * num_frames),
+        last_run(num_streams) {
+    for (std::atomic<int> &n : reported) n = 0;
+    for (std::atomic<int> &f : last_run) f = -1;
+  }
+
+  // each frame reported once, the frames run of a stream in submit order
+  bool check() const {
+    for (const std::atomic<int> &n : reported) {
+      if (n != 1) return false;
+    }
+    return errors == 0;
+  }
+
+  const VIDEO_FRAME_INFO_S *base;
+  int num_frames;
+  std::vector<std::atomic<int>> reported;
+  std::vector<std::atomic<int>> last_run;
+  std::atomic<uint64_t> done{0};
+  std::atomic<uint64_t> dropped{0};
+  std::atomic<uint64_t> objects{0};
+  std::atomic<uint64_t> errors{0};
+};
+
+static void on_result(uint32_t stream_id, CVI_S32 status, VIDEO_FRAME_INFO_S *frame,
+                      cvtdl_object_t *obj, void *user_data) {
+  Results *r = static_cast<Results *>(user_data);
+  long index = frame - r->base;
+  if (index < 0 || index >= (long)r->reported.size() || index / r->num_frames != stream_id) {
+    r->errors++;
+    return;
+  }
+  int f = index % r->num_frames;
+  r->reported[index]++;
+  if (status == CVI_TDL_ERR_FRAME_DROPPED) {
+    r->dropped++;
+    return;
+  }
+  if (r->last_run[stream_id].exchange(f) >= f) r->errors++;
+  r->done++;
+  if (obj != NULL) r->objects += obj->size;
+}
+
+static double elapsed_ms(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static void print_latency(cvitdl_stream_sched_t sched, int num_streams) {
+  double avg = 0, max = 0;
+  uint64_t dropped = 0;
+  for (int s = 0; s < num_streams; s++) {
+    cvtdl_stream_stats_t stats;
+    CVI_TDL_StreamSched_GetStats(sched, s, &stats);
+    avg += stats.avg_latency_ms / num_streams;
+    if (stats.max_latency_ms > max) max = stats.max_latency_ms;
+    dropped += stats.dropped;
+  }
+  printf("    latency avg %7.2f ms, max %7.2f ms, dropped %lu\n", avg, max,
+         (unsigned long)dropped);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    printf("usage: %s <work_dir> [num_streams] [frames_per_stream] [latency_us]\n", argv[0]);
+    return -1;
+  }
+  std::string path = std::string(argv[1]) + "/yolov8_sched.desc";
+  int num_streams = argc > 2 ? atoi(argv[2]) : 8;
+  int num_frames = argc > 3 ? atoi(argv[3]) : 50;
+  int latency_us = argc > 4 ? atoi(argv[4]) : 5000;
+  if (num_streams <= 0 || num_streams > 64 || num_frames <= 0 || latency_us < 0) {
+    printf("usage: %s <work_dir> [num_streams] [frames_per_stream] [latency_us]\n", argv[0]);
+    return -1;
+  }
+  FILE *fp = fopen(path.c_str(), "w");
+  if (fp == NULL) {
+    printf("cannot write %s\n", path.c_str());
+    return -1;
+  }
+  fprintf(fp, "%s", yolov8_desc(latency_us).c_str());
+  fclose(fp);
+
+  std::vector<VIDEO_FRAME_INFO_S> frames(num_streams);
+  for (int s = 0; s < num_streams; s++) {
+    if (CREATE_ION_HELPER(&frames[s], WIDTH, HEIGHT, PIXEL_FORMAT_RGB_888_PLANAR, "stream") !=
+        CVI_SUCCESS) {
+      printf("alloc frame failed!\n");
+      return -1;
+    }
+    fill_frame(&frames[s], s);
+  }
+  const int total = num_streams * num_frames;
+  std::vector<VIDEO_FRAME_INFO_S> submits(total);
+  for (int i = 0; i < total; i++) submits[i] = frames[i / num_frames];
+  int ret = CVI_SUCCESS;
+  bool passed = true;
+
+  // every stream in turn on one handle, the TPU idles during the CPU stages
+  cvitdl_handle_t handle = NULL;
+  ret = CVI_TDL_CreateHandle(&handle);
+  ret |= CVI_TDL_OpenModel(handle, CVI_TDL_SUPPORTED_MODEL_YOLOV8_DETECTION, path.c_str());
+  if (ret != CVI_SUCCESS) {
+    printf("open model failed with %#x!\n", ret);
+    return ret;
+  }
+  cvtdl_object_t obj = {};
+  auto t0 = std::chrono::steady_clock::now();
+  for (int f = 0; f < num_frames && ret == CVI_SUCCESS; f++) {
+    for (int s = 0; s < num_streams && ret == CVI_SUCCESS; s++) {
+      ret = CVI_TDL_Detection(handle, &frames[s], CVI_TDL_SUPPORTED_MODEL_YOLOV8_DETECTION, &obj);
+    }
+  }
+  double ms = elapsed_ms(t0);
+  printf("%d streams x %d frames, %dx%d, forward %d us\n", num_streams, num_frames, WIDTH, HEIGHT,
+         latency_us);
+  printf("sequential      %8.1f fps\n", total * 1000. / ms);
+  CVI_TDL_Free(&obj);
+  CVI_TDL_DestroyHandle(handle);
+
+  // a round of every stream at a time, without deadline
+  const uint32_t workers[] = {1, 2, 3};
+  for (uint32_t num_workers : workers) {
+    cvtdl_stream_sched_config_t config;
+    CVI_TDL_StreamSched_GetDefaultConfig(&config);
+    config.num_workers = num_workers;
+    config.max_streams = num_streams;
+    config.deadline_ms = 0;
+    Results results(submits.data(), num_streams, num_frames);
+    cvitdl_stream_sched_t sched = NULL;
+    ret = CVI_TDL_StreamSched_Create(&sched, CVI_TDL_SUPPORTED_MODEL_YOLOV8_DETECTION,
+                                     path.c_str(), &config, on_result, &results);
+    if (ret != CVI_SUCCESS) {
+      printf("create scheduler failed with %#x!\n", ret);
+      return ret;
+    }
+    t0 = std::chrono::steady_clock::now();
+    for (int f = 0; f < num_frames; f++) {
+      for (int s = 0; s < num_streams; s++) {
+        CVI_TDL_StreamSched_Submit(sched, s, &submits[s * num_frames + f]);
+      }
+      CVI_TDL_StreamSched_Flush(sched);
+    }
+    ms = elapsed_ms(t0);
+    printf("%u worker(s)     %8.1f fps, %lu results\n", num_workers, results.done * 1000. / ms,
+           (unsigned long)results.done.load());
+    print_latency(sched, num_streams);
+    CVI_TDL_StreamSched_Destroy(sched);
+    if (!results.check()) {
+      printf("frames lost, reported twice or out of order\n");
+      passed = false;
+    }
+  }
+
+  // streams submitting faster than the model runs, late frames are dropped
+  cvtdl_stream_sched_config_t config;
+  CVI_TDL_StreamSched_GetDefaultConfig(&config);
+  config.max_streams = num_streams;
+  config.deadline_ms = 4 * latency_us / 1000 + 1;
+  Results results(submits.data(), num_streams, num_frames);
+  cvitdl_stream_sched_t sched = NULL;
+  ret = CVI_TDL_StreamSched_Create(&sched, CVI_TDL_SUPPORTED_MODEL_YOLOV8_DETECTION, path.c_str(),
+                                   &config, on_result, &results);
+  if (ret != CVI_SUCCESS) {
+    printf("create scheduler failed with %#x!\n", ret);
+    return ret;
+  }
+  t0 = std::chrono::steady_clock::now();
+  for (int f = 0; f < num_frames; f++) {
+    for (int s = 0; s < num_streams; s++) {
+      CVI_TDL_StreamSched_Submit(sched, s, &submits[s * num_frames + f]);
+    }
+  }
+  CVI_TDL_StreamSched_Flush(sched);
+  ms = elapsed_ms(t0);
+  printf("overload, deadline %u ms: %lu results, %lu dropped, %8.1f fps\n", config.deadline_ms,
+         (unsigned long)results.done.load(), (unsigned long)results.dropped.load(),
+         results.done * 1000. / ms);
+  print_latency(sched, num_streams);
+  CVI_TDL_StreamSched_Destroy(sched);
+  if (!results.check()) {
+    printf("frames lost, reported twice or out of order\n");
+    passed = false;
+  }
+
+  for (int s = 0; s < num_streams; s++) {
+    CVI_SYS_IonFree(frames[s].stVFrame.u64PhyAddr[0], frames[s].stVFrame.pu8VirAddr[0]);
+  }
+  printf("%s\n", passed ? "check passed" : "check failed");
+  return passed ? CVI_SUCCESS : CVI_FAILURE;
+}
@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include "trace.hpp"
+
+// stress test of the trace export: a writer records spans whose fields all derive from their
+// index while the timeline is exported, every exported span must be whole and in order
+// usage: test_trace [num_exports]
+
+#define BUFFER_SIZE 2048  // TRACE_BUFFER_SIZE of trace.cpp
+#define NUM_NAMES 16
+#define NUM_CATEGORIES 13
+
+using namespace cvitdl;
+
+static const char *g_names[NUM_NAMES] = {"n0", "n1", "n2",  "n3",  "n4",  "n5",  "n6",  "n7",
+                                         "n8", "n9", "n10", "n11", "n12", "n13", "n14", "n15"};
+static const char *g_categories[NUM_CATEGORIES] = {"c0", "c1", "c2", "c3",  "c4",  "c5", "c6",
+                                                   "c7", "c8", "c9", "c10", "c11", "c12"};
+
+static void recordSpan(uint64_t base, uint64_t k) {
+  uint64_t begin = base + k * 100;
+  trace::record(g_names[k % NUM_NAMES], g_categories[k % NUM_CATEGORIES], begin,
+                begin + 1 + k % 50);
+}
+
+// checks the spans of the file, in order within each thread, returns the number of spans or -1
+static long checkExport(const char *filepath, uint64_t base, uint64_t *last_k) {
+  FILE *fp = fopen(filepath, "r");
+  if (fp == NULL) return -1;
+  char line[256];
+  long num = 0;
+  bool first = true;
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    char name[16], category[16];
+    unsigned long long ts, dur;
+    if (strstr(line, "\"thread_name\"") != NULL) first = true;
+    const char *p = strstr(line, "{\"ph\":\"X\"");
+    if (p == NULL) continue;
+    if (sscanf(p, "{\"ph\":\"X\",\"name\":\"%15[^\"]\",\"cat\":\"%15[^\"]\",\"ts\":%llu,\"dur\":%llu",
+               name, category, &ts, &dur) != 4 ||
+        ts < base || (ts - base) % 100 != 0) {
+      printf("malformed span: %s", line);
+      fclose(fp);
+      return -1;
+    }
+    uint64_t k = (ts - base) / 100;
+    if (strcmp(name, g_names[k % NUM_NAMES]) != 0 ||
+        strcmp(category, g_categories[k % NUM_CATEGORIES]) != 0 || dur != 1 + k % 50 ||
+        (!first && k <= *last_k)) {
+      printf("torn or unordered span %lu: %s", (unsigned long)k, line);
+      fclose(fp);
+      return -1;
+    }
+    first = false;
+    *last_k = k;
+    num++;
+  }
+  fclose(fp);
+  return num;
+}
+
+int main(int argc, char *argv[]) {
+  int num_exports = argc > 1 ? atoi(argv[1]) : 200;
+  if (num_exports <= 0) {
+    printf("usage: %s [num_exports]\n", argv[0]);
+    return -1;
+  }
+  const char *filepath = "test_trace.json";
+  trace::enable(true);
+  const uint64_t base = trace::now_us() + 1000;
+  int ret = 0;
+
+  // only the latest spans of a wrapped buffer are kept
+  std::thread([base] {
+    for (uint64_t k = 0; k < 3 * BUFFER_SIZE + 5; k++) recordSpan(base, k);
+  }).join();
+  uint64_t last_k = 0;
+  long num = trace::exportJson(filepath) == 0 ? checkExport(filepath, base, &last_k) : -1;
+  if (num != BUFFER_SIZE || last_k != 3 * BUFFER_SIZE + 4) {
+    printf("wrapped buffer exported %ld spans up to %lu\n", num, (unsigned long)last_k);
+    ret = -1;
+  }
+
+  // exports race a writer that keeps overwriting its buffer
+  std::atomic<bool> stop(false);
+  std::thread writer([&stop, base] {
+    for (uint64_t k = 4 * BUFFER_SIZE; !stop.load(std::memory_order_relaxed); k++) {
+      recordSpan(base, k);
+    }
+  });
+  for (int i = 0; i < num_exports && ret == 0; i++) {
+    if (trace::exportJson(filepath) != 0 || checkExport(filepath, base, &last_k) < 0) {
+      ret = -1;
+    }
+  }
+  stop = true;
+  writer.join();
+  trace::enable(false);
+  remove(filepath);
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
@@ -0,0 +1,183 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <random>
+#include <vector>
+#include "core/cvi_tdl_core.h"
+#include "service/cvi_tdl_service.h"
+
+// check of the trajectory queries of the service handle against a brute-force store of every
+// registered position, with random tracks that appear, move and disappear
+// usage: test_trajectory [num_frames]
+
+#define MAX_IDS 32
+#define HISTORY_LEN 16
+#define DELETE_MS 500
+#define NUM_TRACKS 20
+#define FRAME_MS 33
+
+struct Sample {
+  uint64_t ts;
+  float x;
+  float y;
+};
+
+// every position of the ids, expired ids are erased
+struct Reference {
+  std::map<uint64_t, std::vector<Sample>> tracks;
+  uint64_t now = 0;
+
+  void add(uint64_t ts, uint64_t id, float x, float y) {
+    now = ts;
+    tracks[id].push_back({ts, x, y});
+    for (auto it = tracks.begin(); it != tracks.end();) {
+      it = now - it->second.back().ts > DELETE_MS ? tracks.erase(it) : std::next(it);
+    }
+  }
+
+  // latest max_num of the kept positions inside the window, oldest first
+  bool window(uint64_t id, uint64_t duration, uint32_t max_num, std::vector<Sample> *out) const {
+    auto it = tracks.find(id);
+    out->clear();
+    if (it == tracks.end()) return false;
+    const std::vector<Sample> &s = it->second;
+    uint64_t since = now > duration ? now - duration : 0;
+    size_t kept = s.size() < HISTORY_LEN ? s.size() : HISTORY_LEN;
+    for (size_t i = s.size() - kept; i < s.size(); i++) {
+      if (s[i].ts >= since) out->push_back(s[i]);
+    }
+    if (out->size() > max_num) out->erase(out->begin(), out->end() - max_num);
+    return true;
+  }
+};
+
+static bool near(float a, float b) { return fabsf(a - b) <= 1e-3f * (1 + fabsf(b)); }
+
+static int check_queries(cvitdl_service_handle_t service, const Reference &ref, uint64_t id,
+                         uint64_t duration, uint32_t max_num) {
+  float x[HISTORY_LEN + 4], y[HISTORY_LEN + 4];
+  uint64_t ts[HISTORY_LEN + 4];
+  uint32_t num = 0;
+  std::vector<Sample> expect;
+  bool known = ref.window(id, duration, max_num, &expect);
+  CVI_S32 ret = CVI_TDL_Service_Trajectory_GetPositions(service, id, duration, x, y, ts, max_num,
+                                                        &num);
+  if ((ret == CVI_TDL_SUCCESS) != known || num != expect.size()) {
+    printf("id %lu: %u positions instead of %zu\n", (unsigned long)id, num, expect.size());
+    return -1;
+  }
+  for (uint32_t i = 0; i < num; i++) {
+    if (ts[i] != expect[i].ts || x[i] != expect[i].x || y[i] != expect[i].y) {
+      printf("id %lu: position %u differs\n", (unsigned long)id, i);
+      return -1;
+    }
+  }
+
+  // velocity and heading use the whole window, not only max_num positions
+  ref.window(id, duration, HISTORY_LEN, &expect);
+  bool moving = expect.size() >= 2 && expect.back().ts > expect.front().ts;
+  float vx = 0, vy = 0, heading = 0;
+  CVI_S32 ret_v = CVI_TDL_Service_Trajectory_GetVelocity(service, id, duration, &vx, &vy);
+  CVI_S32 ret_h = CVI_TDL_Service_Trajectory_GetHeading(service, id, duration, &heading);
+  if ((ret_v == CVI_TDL_SUCCESS) != moving || (ret_h == CVI_TDL_SUCCESS) != moving) {
+    printf("id %lu: velocity %s\n", (unsigned long)id, moving ? "missing" : "without motion");
+    return -1;
+  }
+  if (moving) {
+    float dx = expect.back().x - expect.front().x;
+    float dy = expect.back().y - expect.front().y;
+    float dt = (float)(expect.back().ts - expect.front().ts);
+    if (!near(vx, dx * 1000.f / dt) || !near(vy, dy * 1000.f / dt) ||
+        !near(heading, atan2f(dy, dx))) {
+      printf("id %lu: velocity or heading differs\n", (unsigned long)id);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  int num_frames = argc > 1 ? atoi(argv[1]) : 2000;
+  if (num_frames <= 0) {
+    printf("usage: %s [num_frames]\n", argv[0]);
+    return -1;
+  }
+  cvitdl_handle_t handle = NULL;
+  cvitdl_service_handle_t service = NULL;
+  if (CVI_TDL_CreateHandle(&handle) != CVI_TDL_SUCCESS ||
+      CVI_TDL_Service_CreateHandle(&service, handle) != CVI_TDL_SUCCESS) {
+    printf("create handle failed\n");
+    return -1;
+  }
+
+  int ret = 0;
+  if (CVI_TDL_Service_Trajectory_Init(service, 0, HISTORY_LEN, DELETE_MS) !=
+          CVI_TDL_ERR_INVALID_ARGS ||
+      CVI_TDL_Service_Trajectory_Register(service, 0, NULL) != CVI_TDL_ERR_INVALID_ARGS) {
+    printf("invalid arguments accepted\n");
+    ret = -1;
+  }
+  CVI_TDL_Service_Trajectory_Init(service, MAX_IDS, HISTORY_LEN, DELETE_MS);
+
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> step(-5.f, 5.f);
+  std::uniform_int_distribution<int> percent(0, 99);
+  const uint64_t durations[] = {0, 100, 300, 1000};
+  std::vector<float> pos_x(NUM_TRACKS, 100.f), pos_y(NUM_TRACKS, 100.f);
+  std::vector<bool> visible(NUM_TRACKS, false);
+  std::vector<cvtdl_object_info_t> info(NUM_TRACKS);
+  Reference ref;
+  for (int f = 0; f < num_frames && ret == 0; f++) {
+    uint64_t ts = 1000 + (uint64_t)f * FRAME_MS;
+    cvtdl_object_t obj;
+    memset(&obj, 0, sizeof(obj));
+    obj.info = info.data();
+    for (int k = 0; k < NUM_TRACKS; k++) {
+      // tracks come and go, a track hidden for over DELETE_MS starts over
+      if (percent(rng) < (visible[k] ? 2 : 5)) visible[k] = !visible[k];
+      if (!visible[k]) continue;
+      pos_x[k] += step(rng);
+      pos_y[k] += step(rng);
+      cvtdl_object_info_t &o = info[obj.size++];
+      memset(&o, 0, sizeof(o));
+      o.unique_id = k + 1;
+      o.bbox = {pos_x[k] - 10, pos_y[k] - 20, pos_x[k] + 10, pos_y[k] + 20, 1.f};
+      ref.add(ts, o.unique_id, (o.bbox.x1 + o.bbox.x2) / 2, (o.bbox.y1 + o.bbox.y2) / 2);
+    }
+    CVI_TDL_Service_Trajectory_Register(service, ts, &obj);
+    for (uint64_t id = 1; id <= NUM_TRACKS && ret == 0; id++) {
+      uint64_t duration = durations[percent(rng) % 4];
+      uint32_t max_num = 1 + percent(rng) % (HISTORY_LEN + 2);
+      ret = check_queries(service, ref, id, duration, max_num);
+    }
+  }
+
+  // a full store makes room with the id registered least recently
+  CVI_TDL_Service_Trajectory_Init(service, 4, HISTORY_LEN, 100000);
+  cvtdl_object_info_t one;
+  memset(&one, 0, sizeof(one));
+  cvtdl_object_t obj;
+  memset(&obj, 0, sizeof(obj));
+  obj.info = &one;
+  obj.size = 1;
+  for (uint64_t id = 100; id < 105; id++) {
+    one.unique_id = id;
+    CVI_TDL_Service_Trajectory_Register(service, 10 * id, &obj);
+  }
+  float x, y;
+  uint32_t num = 0;
+  if (CVI_TDL_Service_Trajectory_GetPositions(service, 100, 100000, &x, &y, NULL, 1, &num) !=
+          CVI_TDL_FAILURE ||
+      CVI_TDL_Service_Trajectory_GetPositions(service, 104, 100000, &x, &y, NULL, 1, &num) !=
+          CVI_TDL_SUCCESS) {
+    printf("eviction of the oldest id failed\n");
+    ret = -1;
+  }
+
+  CVI_TDL_Service_DestroyHandle(service);
+  CVI_TDL_DestroyHandle(handle);
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
@@ -0,0 +1,158 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <random>
+#include <vector>
+#include "vehicle_adas/adas_track.h"
+
+// check of the vehicle ADAS track index against a map, including the back-shift of erase, and of
+// the time to collision filter on simulated approaching, still and skipped-frame tracks
+// usage: test_vehicle_adas [num_ops]
+
+#define NUM_SLOTS 8
+#define INDEX_SIZE 16
+#define FPS 30.f
+// bbox height in pixels times distance in meters of a car
+#define HEIGHT_X_DIS 1400.f
+
+static int check_index(std::mt19937 &rng, int num_ops) {
+  adas_info_t info;
+  memset(&info, 0, sizeof(info));
+  std::vector<adas_data_t> data(NUM_SLOTS);
+  int32_t index[INDEX_SIZE];
+  memset(index, 0xff, sizeof(index));
+  info.data = data.data();
+  info.size = NUM_SLOTS;
+  info.data_index = index;
+  info.data_index_mask = INDEX_SIZE - 1;
+
+  // the table is half full at most, with sequential ids like the tracker gives so every home slot
+  // is used and probe chains wrap and cross each other
+  std::map<uint64_t, int> ref;
+  std::uniform_int_distribution<int> id(1, 64);
+  std::uniform_int_distribution<int> slot(0, NUM_SLOTS - 1);
+  for (int op = 0; op < num_ops; op++) {
+    uint64_t uid = (uint64_t)id(rng);
+    int s = slot(rng);
+    if (data[s].info.unique_id != 0) {
+      ref.erase(data[s].info.unique_id);
+      adas_index_erase(&info, s);
+      data[s].info.unique_id = 0;
+    } else if (ref.count(uid) == 0) {
+      data[s].info.unique_id = uid;
+      adas_index_insert(&info, s);
+      ref[uid] = s;
+    }
+
+    int used = 0;
+    for (int k = 0; k < INDEX_SIZE; k++) used += index[k] >= 0;
+    if (used != (int)ref.size()) {
+      printf("index holds %d slots instead of %zu after %d ops\n", used, ref.size(), op);
+      return -1;
+    }
+    for (int k = 1; k <= 64; k++) {
+      uint64_t u = (uint64_t)k;
+      auto it = ref.find(u);
+      int expect = it == ref.end() ? -1 : it->second;
+      if (adas_index_find(&info, u) != expect) {
+        printf("id %lu found in slot %d instead of %d after %d ops\n", (unsigned long)u,
+               adas_index_find(&info, u), expect, op);
+        return -1;
+      }
+    }
+  }
+  return 0;
+}
+
+struct Run {
+  float speed;
+  float ttc;
+  float ttc_confidence;
+};
+
+// a car at dis0 meters with a constant speed, updated every step frames with noisy boxes and
+// distances
+static Run simulate(std::mt19937 &rng, float dis0, float speed, int step, int num_frames) {
+  std::normal_distribution<float> noise(0.f, 1.f);
+  adas_data_t data;
+  memset(&data, 0, sizeof(data));
+  float dis = dis0;
+  for (int f = 0; f < num_frames; f += step) {
+    dis = dis0 + speed * f / FPS;
+    float box_height = HEIGHT_X_DIS / dis + noise(rng);
+    float measured = dis + (0.05f * dis + 0.1f) * noise(rng);
+    if (f == 0) {
+      adas_kf_init(&data, measured, box_height);
+    } else {
+      adas_kf_update(&data, measured, box_height, step / FPS);
+    }
+    adas_update_ttc(&data);
+  }
+  return {data.speed, data.ttc, data.ttc_confidence};
+}
+
+static int check_ttc(std::mt19937 &rng) {
+  // no time to collision before the filter saw a few frames
+  adas_data_t data;
+  memset(&data, 0, sizeof(data));
+  adas_kf_init(&data, 10.f, HEIGHT_X_DIS / 10.f);
+  adas_kf_update(&data, 9.9f, HEIGHT_X_DIS / 9.9f, 1 / FPS);
+  adas_update_ttc(&data);
+  if (data.ttc != -1) {
+    printf("ttc %f after two frames\n", data.ttc);
+    return -1;
+  }
+
+  // closing in at 4 m/s every frame and every third frame, the ttc is the remaining distance over
+  // the speed
+  for (int step = 1; step <= 3; step += 2) {
+    for (int k = 0; k < 20; k++) {
+      Run r = simulate(rng, 25.f, -4.f, step, 90);
+      float dis = 25.f - 4.f * (90 - (90 - 1) % step - 1) / FPS;
+      if (fabsf(r.speed + 4.f) > 1.f || r.ttc < 0 || fabsf(r.ttc - dis / 4.f) > 0.25f * dis / 4.f ||
+          r.ttc_confidence < 0.5f) {
+        printf("step %d: speed %f ttc %f confidence %f instead of -4, %f\n", step, r.speed, r.ttc,
+               r.ttc_confidence, dis / 4.f);
+        return -1;
+      }
+    }
+  }
+
+  // the growing box alone reveals a car closing in while the monocular distance stays flat
+  memset(&data, 0, sizeof(data));
+  adas_kf_init(&data, 20.f, HEIGHT_X_DIS / 20.f);
+  for (int f = 1; f < 30; f++) {
+    adas_kf_update(&data, 20.f, HEIGHT_X_DIS / (20.f - 4.f * f / FPS), 1 / FPS);
+  }
+  if (data.speed > -0.2f) {
+    printf("bbox scale change ignored, speed %f\n", data.speed);
+    return -1;
+  }
+
+  // a still car and one moving away never give a time to collision once settled
+  for (int k = 0; k < 20; k++) {
+    Run still = simulate(rng, 15.f, 0.f, 1, 150);
+    Run away = simulate(rng, 10.f, 3.f, 1, 90);
+    if ((still.ttc >= 0 && still.ttc_confidence > 0.2f) || away.ttc >= 0 ||
+        fabsf(still.speed) > 1.f || fabsf(away.speed - 3.f) > 1.f) {
+      printf("false ttc: still %f %f, away %f %f\n", still.speed, still.ttc, away.speed, away.ttc);
+      return -1;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  int num_ops = argc > 1 ? atoi(argv[1]) : 100000;
+  if (num_ops <= 0) {
+    printf("usage: %s [num_ops]\n", argv[0]);
+    return -1;
+  }
+  std::mt19937 rng(1234);
+  int ret = check_index(rng, num_ops);
+  ret |= check_ttc(rng);
+  printf("%s\n", ret == 0 ? "check passed" : "check failed");
+  return ret;
+}
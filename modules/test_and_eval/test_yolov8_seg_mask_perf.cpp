@@ -0,0 +1,139 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "instance_segmentation/yolov8_seg/seg_mask_engine.hpp"
+#include "perf_utils.hpp"
+
+// host benchmark of yolov8 seg mask assembly with synthetic int8 tensors
+// usage: test_yolov8_seg_mask_perf [num_instances] [loops]
+
+static const int PROTO_C = 32;
+static const int PROTO_H = 160;
+static const int PROTO_W = 160;
+static const float QSCALE_PROTO = 0.031f;
+static const float QSCALE_COEFF = 0.047f;
+
+struct Box {
+  int x1, y1, x2, y2;
+};
+
+// previous implementation: dequantize, full map product and sigmoid for every instance
+static void reference_masks(const std::vector<int8_t> &proto, const std::vector<int8_t> &coeff,
+                            int num_map, const std::vector<Box> &boxes,
+                            std::vector<std::vector<uint8_t>> &masks) {
+  const int proto_hw = PROTO_H * PROTO_W;
+  std::vector<float> proto_f(proto.size());
+  for (size_t i = 0; i < proto.size(); i++) proto_f[i] = proto[i] * QSCALE_PROTO;
+  std::vector<float> logits(proto_hw);
+  for (size_t n = 0; n < boxes.size(); n++) {
+    std::fill(logits.begin(), logits.end(), 0.f);
+    for (int c = 0; c < PROTO_C; c++) {
+      float k = coeff[c * num_map + n] * QSCALE_COEFF;
+      const float *plane = proto_f.data() + c * proto_hw;
+      for (int j = 0; j < proto_hw; j++) logits[j] += k * plane[j];
+    }
+    masks[n].assign(proto_hw, 0);
+    const Box &b = boxes[n];
+    for (int y = b.y1; y < b.y2; y++) {
+      for (int x = b.x1; x < b.x2; x++) {
+        float v = 1.f / (1.f + expf(-logits[y * PROTO_W + x]));
+        masks[n][y * PROTO_W + x] = v >= 0.5f ? 255 : 0;
+      }
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  int num_inst = argc > 1 ? atoi(argv[1]) : 50;
+  int loops = argc > 2 ? atoi(argv[2]) : 20;
+  if (num_inst <= 0 || loops <= 0) {
+    printf("usage: %s [num_instances] [loops]\n", argv[0]);
+    return -1;
+  }
+
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> val(-127, 127);
+  std::vector<int8_t> proto(PROTO_C * PROTO_H * PROTO_W);
+  for (auto &v : proto) v = val(rng);
+  // coefficients are stored channel-major like the model mask branch, anchor i = instance i
+  int num_map = num_inst;
+  std::vector<int8_t> coeff(PROTO_C * num_map);
+  for (auto &v : coeff) v = val(rng);
+
+  std::vector<Box> boxes(num_inst);
+  std::uniform_int_distribution<int> pos(0, PROTO_W - 8);
+  std::uniform_int_distribution<int> len(8, 64);
+  for (auto &b : boxes) {
+    b.x1 = pos(rng);
+    b.y1 = pos(rng);
+    b.x2 = std::min(b.x1 + len(rng), PROTO_W);
+    b.y2 = std::min(b.y1 + len(rng), PROTO_H);
+  }
+
+  std::vector<std::vector<uint8_t>> ref(num_inst);
+  auto t0 = std::chrono::steady_clock::now();
+  for (int l = 0; l < loops; l++) reference_masks(proto, coeff, num_map, boxes, ref);
+  double ref_ms = elapsed_ms(t0) / loops;
+  printf("instances:%d proto:%dx%dx%d\n", num_inst, PROTO_C, PROTO_H, PROTO_W);
+  printf("full map float sigmoid: %.3f ms/frame\n", ref_ms);
+
+  cvitdl::SegMaskEngine engine;
+  engine.setProto(proto.data(), nullptr, PROTO_C, PROTO_H, PROTO_W);
+  std::vector<cvtdl_mask_meta> metas(num_inst);
+  memset(metas.data(), 0, sizeof(cvtdl_mask_meta) * num_inst);
+
+  const char *names[] = {"full", "bbox", "rle"};
+  cvtdl_mask_format_e formats[] = {CVTDL_MASK_FORMAT_FULL, CVTDL_MASK_FORMAT_BBOX,
+                                   CVTDL_MASK_FORMAT_RLE};
+  int ret = 0;
+  for (int f = 0; f < 3; f++) {
+    t0 = std::chrono::steady_clock::now();
+    for (int l = 0; l < loops; l++) {
+      for (int n = 0; n < num_inst; n++) {
+        const Box &b = boxes[n];
+        engine.decode(coeff.data() + n, nullptr, num_map, b.x1, b.y1, b.x2, b.y2, formats[f],
+                      &metas[n]);
+      }
+    }
+    double ms = elapsed_ms(t0) / loops;
+
+    // compare the box area against the reference, borderline logits may flip because the
+    // reference rounds in float
+    size_t mismatch = 0, total = 0;
+    for (int n = 0; n < num_inst; n++) {
+      const cvtdl_mask_meta &m = metas[n];
+      std::vector<uint8_t> crop(m.mask_w * m.mask_h, 0);
+      if (formats[f] == CVTDL_MASK_FORMAT_FULL) {
+        for (uint32_t y = 0; y < m.mask_h; y++)
+          memcpy(&crop[y * m.mask_w], m.mask + (m.mask_y + y) * PROTO_W + m.mask_x, m.mask_w);
+      } else if (formats[f] == CVTDL_MASK_FORMAT_BBOX) {
+        memcpy(crop.data(), m.mask, crop.size());
+      } else {
+        uint32_t p = 0;
+        for (uint32_t r = 0; r < m.mask_rle_size; r++) {
+          if (r % 2 == 1) memset(&crop[p], 255, m.mask_rle[r]);
+          p += m.mask_rle[r];
+        }
+      }
+      for (uint32_t y = 0; y < m.mask_h; y++) {
+        for (uint32_t x = 0; x < m.mask_w; x++) {
+          mismatch += crop[y * m.mask_w + x] != ref[n][(m.mask_y + y) * PROTO_W + m.mask_x + x];
+          total++;
+        }
+      }
+    }
+    printf("roi int8 logit %-4s: %.3f ms/frame, speedup %.1fx, mismatch %zu/%zu\n", names[f], ms,
+           ref_ms / ms, mismatch, total);
+    if (mismatch * 1000 > total) ret = -1;
+  }
+
+  for (auto &m : metas) {
+    free(m.mask);
+    free(m.mask_rle);
+  }
+  return ret;
+}
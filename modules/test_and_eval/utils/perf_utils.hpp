@@ -0,0 +1,7 @@
+#pragma once
+#include <chrono>
+
+// milliseconds since t0, for the host and board benchmarks
+inline double elapsed_ms(std::chrono::steady_clock::time_point t0) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
@@ -595,6 +595,8 @@ int main(int argc, char *argv[]) {
       continue;
     }
 
+    // a copy rather than a result channel: the VO thread rescales the metas in place, and
+    // last_faces/last_objects stay the tracking state of the capture app
     {
       MutexAutoLock(VOMutex, lock);
       CVI_TDL_Free(&g_face_meta_0);
@@ -20,9 +20,8 @@
 
 static volatile bool bExit = false;
 
-static cvtdl_face_t g_stFaceMeta = {0};
-
-MUTEXAUTOLOCK_INIT(ResultMutex);
+// Detection results are published by the TDL thread and read by the encoder thread.
+static cvitdl_result_channel_t g_stResultChannel = NULL;
 
 typedef struct {
   SAMPLE_TDL_MW_CONTEXT *pstMWContext;
@@ -34,7 +33,7 @@ void *run_venc(void *args) {
   SAMPLE_TDL_VENC_THREAD_ARG_S *pstArgs = (SAMPLE_TDL_VENC_THREAD_ARG_S *)args;
   VIDEO_FRAME_INFO_S stFrame;
   CVI_S32 s32Ret;
-  cvtdl_face_t stFaceMeta = {0};
+  const cvtdl_face_t *pstFaceMeta = NULL;
 
   while (bExit == false) {
     s32Ret = CVI_VPSS_GetChnFrame(0, 0, &stFrame, 2000);
@@ -43,32 +42,27 @@ void *run_venc(void *args) {
       break;
     }
 
-    {
-      MutexAutoLock(ResultMutex, lock);
-      memset(&stFaceMeta, 0, sizeof(cvtdl_face_t));
-      if (NULL != g_stFaceMeta.info) {
-        CVI_TDL_CopyFaceMeta(&g_stFaceMeta, &stFaceMeta);
-      }
-      CVI_TDL_Free(&g_stFaceMeta);
-    }
+    // Get the latest detection result, the snapshot is read-only until it is released.
+    CVI_TDL_ResultChannel_AcquireFace(g_stResultChannel, &pstFaceMeta, NULL);
 
-    s32Ret = CVI_TDL_Service_FaceDrawRect(pstArgs->stServiceHandle, &stFaceMeta, &stFrame, false,
-                                          CVI_TDL_Service_GetDefaultBrush());
-    if (s32Ret != CVI_TDL_SUCCESS) {
-      CVI_VPSS_ReleaseChnFrame(0, 0, &stFrame);
-      printf("Draw fame fail!, ret=%x\n", s32Ret);
-      goto error;
+    if (pstFaceMeta != NULL) {
+      s32Ret = CVI_TDL_Service_FaceDrawRect(pstArgs->stServiceHandle, pstFaceMeta, &stFrame, false,
+                                            CVI_TDL_Service_GetDefaultBrush());
+      if (s32Ret != CVI_TDL_SUCCESS) {
+        printf("Draw fame fail!, ret=%x\n", s32Ret);
+        goto error;
+      }
     }
 
     s32Ret = SAMPLE_TDL_Send_Frame_RTSP(&stFrame, pstArgs->pstMWContext);
     if (s32Ret != CVI_SUCCESS) {
-      CVI_VPSS_ReleaseChnFrame(0, 0, &stFrame);
       printf("Send Output Frame NG, ret=%x\n", s32Ret);
       goto error;
     }
 
   error:
-    CVI_TDL_Free(&stFaceMeta);
+    CVI_TDL_ResultChannel_Release(g_stResultChannel, pstFaceMeta);
+    pstFaceMeta = NULL;
     CVI_VPSS_ReleaseChnFrame(0, 0, &stFrame);
     if (s32Ret != CVI_SUCCESS) {
       bExit = true;
@@ -94,7 +88,6 @@ void *run_tdl_thread(void *pHandle) {
       goto get_frame_failed;
     }
 
-    memset(&stFaceMeta, 0, sizeof(cvtdl_face_t));
     s32Ret = CVI_TDL_FaceDetection(pstTDLHandle, &stFrame, CVI_TDL_SUPPORTED_MODEL_SCRFDFACE,
                                    &stFaceMeta);
     if (s32Ret != CVI_TDL_SUCCESS) {
@@ -103,23 +96,21 @@ void *run_tdl_thread(void *pHandle) {
     }
 
     printf("face count: %d\n", stFaceMeta.size);
-    {
-      MutexAutoLock(ResultMutex, lock);
-      memset(&g_stFaceMeta, 0, sizeof(cvtdl_face_t));
-      if (NULL != stFaceMeta.info) {
-        CVI_TDL_CopyFaceMeta(&stFaceMeta, &g_stFaceMeta);
-      }
+    // Publish results to the encoder thread. stFaceMeta receives a recycled meta, which the
+    // next inference reuses without reallocating.
+    if (CVI_TDL_ResultChannel_PublishFace(g_stResultChannel, &stFaceMeta) != CVI_TDL_SUCCESS) {
+      printf("publish result failed, drop this frame\n");
     }
 
   inf_error:
     CVI_VPSS_ReleaseChnFrame(0, 1, &stFrame);
   get_frame_failed:
-    CVI_TDL_Free(&stFaceMeta);
     if (s32Ret != CVI_SUCCESS) {
       bExit = true;
     }
   }
 
+  CVI_TDL_Free(&stFaceMeta);
   printf("Exit TDL thread\n");
   pthread_exit(NULL);
 }
@@ -262,12 +253,16 @@ int main(int argc, char *argv[]) {
       .stServiceHandle = stServiceHandle,
   };
 
+  GOTO_IF_FAILED(CVI_TDL_ResultChannel_Create(&g_stResultChannel, true), s32Ret, setup_tdl_fail);
+
   pthread_create(&stVencThread, NULL, run_venc, &args);
   pthread_create(&stTDLThread, NULL, run_tdl_thread, stTDLHandle);
 
   pthread_join(stVencThread, NULL);
   pthread_join(stTDLThread, NULL);
 
+  CVI_TDL_ResultChannel_Destroy(g_stResultChannel);
+
 setup_tdl_fail:
   CVI_TDL_Service_DestroyHandle(stServiceHandle);
 create_service_fail:
@@ -172,6 +172,8 @@ void *run_tdl_thread(void *args) {
 
   CVI_S32 s32Ret;
   uint32_t counter = 0;
+  // Region masks cover up to 64 polygons, fall back to one bbox at a time beyond that.
+  bool bRegionMask = true;
   while (bExit == false) {
     s32Ret = CVI_VPSS_GetChnFrame(0, VPSS_CHN1, &stFrame, 2000);
 
@@ -187,21 +189,28 @@ void *run_tdl_thread(void *args) {
     struct timeval t0, t1;
     gettimeofday(&t0, NULL);
     bool *aIntrusion = NULL;
+    uint64_t *aRegionMask = NULL;
     if (stObjMeta.size > 0) {
       aIntrusion = (bool *)malloc(stObjMeta.size * sizeof(bool));
-      uint32_t u32IntrusionCount = 0;
+      aRegionMask = (uint64_t *)malloc(stObjMeta.size * sizeof(uint64_t));
 
-      // Check which bbox has intersection with pre-defined regions.
+      // Check which bbox has intersection with pre-defined regions, all bboxes in one call.
+      if (bRegionMask && CVI_TDL_Service_Polygon_IntersectObjects(pstTDLArgs->stServiceHandle,
+                                                                  &stObjMeta, aRegionMask) !=
+                             CVI_SUCCESS) {
+        bRegionMask = false;
+      }
       for (uint32_t i = 0; i < stObjMeta.size; i++) {
+        if (bRegionMask) {
+          aIntrusion[i] = aRegionMask[i] != 0;
+          continue;
+        }
         bool bIntrusion;
         cvtdl_bbox_t stBbox = stObjMeta.info[i].bbox;
         GOTO_IF_FAILED(
             CVI_TDL_Service_Polygon_Intersect(pstTDLArgs->stServiceHandle, &stBbox, &bIntrusion),
             s32Ret, inter_error);
         aIntrusion[i] = bIntrusion;
-        if (bIntrusion) {
-          u32IntrusionCount++;
-        }
       }
     }
     gettimeofday(&t1, NULL);
@@ -221,6 +230,7 @@ void *run_tdl_thread(void *args) {
 
   inter_error:
     free(aIntrusion);
+    free(aRegionMask);
   inf_error:
     CVI_VPSS_ReleaseChnFrame(0, 1, &stFrame);
   get_frame_failed:
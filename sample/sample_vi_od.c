@@ -20,9 +20,8 @@
 
 static volatile bool bExit = false;
 
-static cvtdl_object_t g_stObjMeta = {0};
-
-MUTEXAUTOLOCK_INIT(ResultMutex);
+// Detection results are published by the TDL thread and read by the encoder thread.
+static cvitdl_result_channel_t g_stResultChannel = NULL;
 
 /**
  * @brief Arguments for video encoder thread
@@ -48,7 +47,7 @@ void *run_venc(void *args) {
   SAMPLE_TDL_VENC_THREAD_ARG_S *pstArgs = (SAMPLE_TDL_VENC_THREAD_ARG_S *)args;
   VIDEO_FRAME_INFO_S stFrame;
   CVI_S32 s32Ret;
-  cvtdl_object_t stObjMeta = {0};
+  const cvtdl_object_t *pstObjMeta = NULL;
 
   while (bExit == false) {
     s32Ret = CVI_VPSS_GetChnFrame(0, VPSS_CHN0, &stFrame, 2000);
@@ -57,29 +56,22 @@ void *run_venc(void *args) {
       break;
     }
 
-    {
-      // Get detection result from global
-      MutexAutoLock(ResultMutex, lock);
-      CVI_TDL_CopyObjectMeta(&g_stObjMeta, &stObjMeta);
-    }
-
-    for (uint32_t oid = 0; oid < stObjMeta.size; oid++) {
-      char name[256];
-      sprintf(name, "%s: %.2f", stObjMeta.info[oid].name, stObjMeta.info[oid].bbox.score);
-      memcpy(stObjMeta.info[oid].name, name, sizeof(stObjMeta.info[oid].name));
-    }
+    // Get the latest detection result, the snapshot is read-only until it is released.
+    CVI_TDL_ResultChannel_AcquireObject(g_stResultChannel, &pstObjMeta, NULL);
 
-    s32Ret = CVI_TDL_Service_ObjectDrawRect(pstArgs->stServiceHandle, &stObjMeta, &stFrame, true,
-                                            CVI_TDL_Service_GetDefaultBrush());
-    if (s32Ret != CVI_TDL_SUCCESS) {
-      CVI_VPSS_ReleaseChnFrame(0, 0, &stFrame);
-      printf("Draw fame fail!, ret=%x\n", s32Ret);
-      goto error;
+    if (pstObjMeta != NULL) {
+      s32Ret = CVI_TDL_Service_ObjectDrawRect(pstArgs->stServiceHandle, pstObjMeta, &stFrame, true,
+                                              CVI_TDL_Service_GetDefaultBrush());
+      if (s32Ret != CVI_TDL_SUCCESS) {
+        printf("Draw fame fail!, ret=%x\n", s32Ret);
+        goto error;
+      }
     }
 
     s32Ret = SAMPLE_TDL_Send_Frame_RTSP(&stFrame, pstArgs->pstMWContext);
   error:
-    CVI_TDL_Free(&stObjMeta);
+    CVI_TDL_ResultChannel_Release(g_stResultChannel, pstObjMeta);
+    pstObjMeta = NULL;
     CVI_VPSS_ReleaseChnFrame(0, 0, &stFrame);
     if (s32Ret != CVI_SUCCESS) {
       bExit = true;
@@ -121,21 +113,29 @@ void *run_tdl_thread(void *args) {
       printf("obj count: %d, take %.2f,width:%u ms\n", stObjMeta.size, (float)execution_time / 1000,
              stFrame.stVFrame.u32Width);
 
-    {
-      // Copy object detection results to global.
-      MutexAutoLock(ResultMutex, lock);
-      CVI_TDL_CopyObjectMeta(&stObjMeta, &g_stObjMeta);
+    for (uint32_t oid = 0; oid < stObjMeta.size; oid++) {
+      char name[256];
+      snprintf(name, sizeof(name), "%s: %.2f", stObjMeta.info[oid].name,
+               stObjMeta.info[oid].bbox.score);
+      memcpy(stObjMeta.info[oid].name, name, sizeof(stObjMeta.info[oid].name));
+      stObjMeta.info[oid].name[sizeof(stObjMeta.info[oid].name) - 1] = '\0';
+    }
+
+    // Publish results to the encoder thread. stObjMeta receives a recycled meta, which the
+    // next inference reuses without reallocating.
+    if (CVI_TDL_ResultChannel_PublishObject(g_stResultChannel, &stObjMeta) != CVI_TDL_SUCCESS) {
+      printf("publish result failed, drop this frame\n");
     }
 
   inf_error:
     CVI_VPSS_ReleaseChnFrame(0, 1, &stFrame);
   get_frame_failed:
-    CVI_TDL_Free(&stObjMeta);
     if (s32Ret != CVI_SUCCESS) {
       bExit = true;
     }
   }
 
+  CVI_TDL_Free(&stObjMeta);
   printf("Exit TDL thread\n");
   pthread_exit(NULL);
 }
@@ -368,6 +368,8 @@ int main(int argc, char *argv[]) {
       .stTDLHandle = stTDLHandle,
   };
 
+  GOTO_IF_FAILED(CVI_TDL_ResultChannel_Create(&g_stResultChannel, false), s32Ret, setup_tdl_fail);
+
   pthread_create(&stVencThread, NULL, run_venc, &venc_args);
   pthread_create(&stTDLThread, NULL, run_tdl_thread, &ai_args);
 
@@ -377,6 +379,8 @@ int main(int argc, char *argv[]) {
   // Thread for TDL inference
   pthread_join(stTDLThread, NULL);
 
+  CVI_TDL_ResultChannel_Destroy(g_stResultChannel);
+
 setup_tdl_fail:
   CVI_TDL_Service_DestroyHandle(stServiceHandle);
 create_service_fail:
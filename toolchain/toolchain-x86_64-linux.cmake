@@ -0,0 +1,15 @@
+# usage
+# cmake -DCMAKE_TOOLCHAIN_FILE=../toolchain/toolchain-x86_64-linux.cmake -DUSE_STUB_RUNTIME=ON ../
+# Host build against the CPU stub of the TPU runtime, see modules/stub_runtime.
+set( CMAKE_SYSTEM_NAME          Linux )
+set( CMAKE_SYSTEM_PROCESSOR     x86_64 )
+
+set(CMAKE_C_COMPILER gcc)
+set(CMAKE_CXX_COMPILER g++)
+
+set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -std=gnu11" )
+set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS} -fsigned-char -lstdc++ -lm -lpthread" )
+set( CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -fsigned-char -lm -lpthread" )
+
+set( CMAKE_C_FLAGS "${CMAKE_C_FLAGS}" CACHE STRING "" )
+set( CMAKE_ASM_FLAGS "${CMAKE_C_FLAGS}" CACHE STRING "" )